@@ -26,6 +26,7 @@
 #include "dbLayout.h"
 #include "dbReader.h"
 #include "dbWriter.h"
+#include "dbCommonReader.h"
 #include "tlCommandLineParser.h"
 #include "tlTimer.h"
 
@@ -37,6 +38,7 @@ int converter_main (int argc, char *argv[], const std::string &format)
   bd::GenericWriterOptions generic_writer_options;
   bd::GenericReaderOptions generic_reader_options;
   std::string infile, outfile;
+  bool streaming = false;
 
   tl::CommandLineOptions cmd;
   generic_writer_options.add_options (cmd, format);
@@ -51,6 +53,11 @@ int converter_main (int argc, char *argv[], const std::string &format)
                   "but does not allow cell merging. '+' combination has higher priority than ',' - i.e. 'a+b,c' is "
                   "understood as '(a+b),c'.")
       << tl::arg ("output", &outfile, tl::sprintf ("The output file (%s format)", format))
+      << tl::arg ("--streaming", &streaming, "Converts cell by cell with a low memory footprint",
+                  "In this mode, the shapes of the input are loaded cell by cell on demand and are released again "
+                  "after the cell has been written. Hence, only the shapes of one cell need to be kept in memory. "
+                  "This mode requires an uncompressed OASIS or LStream input file. For other inputs, the file "
+                  "is read entirely. For OASIS output, the name tables are written at the end of the file in this mode.")
     ;
 
   cmd.brief (tl::sprintf ("This program will convert the given file to a %s file", format));
@@ -64,15 +71,29 @@ int converter_main (int argc, char *argv[], const std::string &format)
   {
     db::LoadLayoutOptions load_options;
     generic_reader_options.configure (load_options);
+    if (streaming) {
+      load_options.get_options<db::CommonReaderOptions> ().lazy_loading = true;
+    }
     read_files (layout, infile, load_options);
   }
 
+  //  in streaming mode, the shapes are dropped after the cells have been written
+  if (streaming && layout.cell_content_loader ()) {
+    layout.cell_content_loader ()->set_transient (true);
+  }
+
   {
     db::SaveLayoutOptions save_options;
     generic_writer_options.configure (save_options, layout);
     save_options.set_format (format);
+    if (streaming && format == bd::GenericWriterOptions::oasis_format_name) {
+      //  avoids scanning all cells for the names in advance
+      save_options.set_option_by_name ("oasis_tables_at_end", true);
+    }
+
+    layout.release_source_file (outfile);
 
-    tl::OutputStream stream (outfile);
+    tl::OutputStream stream (outfile, tl::OutputStream::OM_Auto, false, 0, save_options.compression_threads ());
     db::Writer writer (save_options);
     writer.write (layout, stream);
   }
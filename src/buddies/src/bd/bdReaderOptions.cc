@@ -42,13 +42,16 @@ GenericReaderOptions::GenericReaderOptions ()
   m_common_enable_text_objects = load_options.get_option_by_name ("text_enabled").to_bool ();
   m_common_enable_properties = load_options.get_option_by_name ("properties_enabled").to_bool ();
   m_cell_conflict_resolution = (unsigned int) db::CellConflictResolution::RenameCell;
+  m_lazy_loading = load_options.get_option_by_name ("lazy_loading").to_bool ();
 
   m_gds2_box_mode = load_options.get_option_by_name ("gds2_box_mode").to_uint ();
   m_gds2_allow_big_records = load_options.get_option_by_name ("gds2_allow_big_records").to_bool ();
   m_gds2_allow_multi_xy_records = load_options.get_option_by_name ("gds2_allow_multi_xy_records").to_bool ();
+  m_gds2_threads = load_options.get_option_by_name ("gds2_threads").to_int ();
 
   m_oasis_read_all_properties = load_options.get_option_by_name ("oasis_read_all_properties").to_bool ();
   m_oasis_expect_strict_mode = (load_options.get_option_by_name ("oasis_expect_strict_mode").to_int () > 0);
+  m_oasis_threads = load_options.get_option_by_name ("oasis_threads").to_int ();
 
   m_create_other_layers = load_options.get_option_by_name ("cif_create_other_layers").to_bool ();
   m_cif_wire_mode = load_options.get_option_by_name ("cif_wire_mode").to_uint ();
@@ -212,6 +215,11 @@ GenericReaderOptions::add_options (tl::CommandLineOptions &cmd)
                     "Mode 0 is a safe solution for the 'same hierarchy, different layers' case. Mode 3 is a safe solution for "
                     "joining multiple files into one and combining the hierarchy tree of all files as distinct separate trees.\n"
                    )
+        << tl::arg (group +
+                    "#--" + m_long_prefix + "lazy-loading", &m_lazy_loading, "Loads cell shapes on demand",
+                    "With this option, the shapes of a cell are read from the file when they are needed for the first time. "
+                    "This option applies to OASIS and LStream files stored on the local file system only."
+                   )
       ;
   }
 
@@ -255,6 +263,12 @@ GenericReaderOptions::add_options (tl::CommandLineOptions &cmd)
                     "* 2: treat as boundaries\n"
                     "* 3: treat as errors"
                    )
+        << tl::arg (group +
+                    "--" + m_long_prefix + "gds2-threads=threads", &m_gds2_threads, "Specifies the number of threads to use for decoding cells",
+                    "With this option, the cell content is split into chunks which are decoded in the given number "
+                    "of background threads. This can speed up reading of large files. "
+                    "The default is 0 which means the file is read in the main thread."
+                   )
       ;
   }
 
@@ -267,6 +281,12 @@ GenericReaderOptions::add_options (tl::CommandLineOptions &cmd)
                     "(mode is 0). By default, both modes are allowed. This is a diagnostic feature and does not "
                     "have any other effect than checking the mode."
                    )
+        << tl::arg (group +
+                    "--" + m_long_prefix + "oasis-threads=threads", &m_oasis_threads, "Specifies the number of threads to use for decompressing CBLOCKs",
+                    "With this option, CBLOCKs (compressed blocks) are decompressed in the given number of background threads "
+                    "while the reader decodes the records. This can speed up reading of large, CBLOCK-compressed files. "
+                    "The default is 0 which means decompression happens in the reading thread."
+                   )
       ;
   }
 
@@ -728,13 +748,16 @@ GenericReaderOptions::configure (db::LoadLayoutOptions &load_options)
   load_options.set_option_by_name ("text_enabled", m_common_enable_text_objects);
   load_options.set_option_by_name ("properties_enabled", m_common_enable_properties);
   load_options.get_options<db::CommonReaderOptions> ().cell_conflict_resolution = db::CellConflictResolution (m_cell_conflict_resolution);
+  load_options.get_options<db::CommonReaderOptions> ().lazy_loading = m_lazy_loading;
 
   load_options.set_option_by_name ("gds2_box_mode", m_gds2_box_mode);
   load_options.set_option_by_name ("gds2_allow_big_records", m_gds2_allow_big_records);
   load_options.set_option_by_name ("gds2_allow_multi_xy_records", m_gds2_allow_multi_xy_records);
+  load_options.set_option_by_name ("gds2_threads", m_gds2_threads);
 
   load_options.set_option_by_name ("oasis_read_all_properties", m_oasis_read_all_properties);
   load_options.set_option_by_name ("oasis_expect_strict_mode", m_oasis_expect_strict_mode ? 1 : -1);
+  load_options.set_option_by_name ("oasis_threads", m_oasis_threads);
 
   load_options.set_option_by_name ("cif_layer_map", tl::Variant::make_variant (m_layer_map));
   load_options.set_option_by_name ("cif_create_other_layers", m_create_other_layers);
@@ -104,6 +104,7 @@ private:
   double m_dbu;
   bool m_keep_layer_names;
   unsigned int m_cell_conflict_resolution;
+  bool m_lazy_loading;
 
   //  common GDS2+OASIS
   bool m_common_enable_text_objects;
@@ -113,10 +114,12 @@ private:
   unsigned int m_gds2_box_mode;
   bool m_gds2_allow_big_records;
   bool m_gds2_allow_multi_xy_records;
+  int m_gds2_threads;
 
   //  OASIS
   bool m_oasis_read_all_properties;
   int m_oasis_expect_strict_mode;
+  int m_oasis_threads;
 
   //  CIF
   unsigned int m_cif_wire_mode;
@@ -25,6 +25,7 @@
 #include "dbSaveLayoutOptions.h"
 #include "tlCommandLineParser.h"
 #include "tlGlobPattern.h"
+#include "tlStream.h"
 
 namespace bd
 {
@@ -47,6 +48,7 @@ GenericWriterOptions::init_from_options (const db::SaveLayoutOptions &save_optio
   db::SaveLayoutOptions &save_options = const_cast<db::SaveLayoutOptions &> (save_options_nc);
 
   m_scale_factor = 1.0;
+  m_compression_threads = save_options.compression_threads ();
 
   m_dbu = save_options.get_option_by_name ("dbu").to_double ();
   m_libname = save_options.get_option_by_name ("libname").to_string ();
@@ -73,6 +75,7 @@ GenericWriterOptions::init_from_options (const db::SaveLayoutOptions &save_optio
   m_oasis_recompress = save_options.get_option_by_name ("oasis_recompress").to_bool ();
   m_oasis_permissive = save_options.get_option_by_name ("oasis_permissive").to_bool ();
   m_oasis_write_std_properties = save_options.get_option_by_name ("oasis_write_std_properties").to_int ();
+  m_oasis_threads = save_options.get_option_by_name ("oasis_threads").to_int ();
   //  No substitution by default (issue #1885), so skip this:
   //  m_oasis_subst_char = save_options.get_option_by_name ("oasis_substitution_char").to_string ();
 
@@ -88,6 +91,7 @@ GenericWriterOptions::init_from_options (const db::SaveLayoutOptions &save_optio
   m_lstream_compression_level = save_options.get_option_by_name ("lstream_compression_level").to_int ();
   m_lstream_recompress = save_options.get_option_by_name ("lstream_recompress").to_bool ();
   m_lstream_permissive = save_options.get_option_by_name ("lstream_permissive").to_bool ();
+  m_lstream_tile_size = save_options.get_option_by_name ("lstream_tile_size").to_double ();
 }
 
 const std::string GenericWriterOptions::gds2_format_name      = "GDS2";
@@ -152,6 +156,13 @@ GenericWriterOptions::add_options (tl::CommandLineOptions &cmd, const std::strin
                   "If given, empty cells won't be written. See --keep-instances for more options."
                  );
 
+  cmd << tl::arg (group +
+                  "#--gzip-threads=threads", &m_compression_threads, "Specifies the number of threads for gzip compression",
+                  "If the output file is gzip-compressed (i.e. has a '.gz' suffix), the compression is done in the "
+                  "given number of threads. The file produced is a standard gzip file, but not identical to the one "
+                  "written without threads. The default is 0 which means compression happens in the main thread."
+                 );
+
   if (format.empty () || format == gds2_format_name || format == gds2text_format_name) {
     cmd << tl::arg (group +
                     "#--keep-instances",      &m_keep_instances, "Keeps instances of dropped cells",
@@ -301,6 +312,12 @@ GenericWriterOptions::add_options (tl::CommandLineOptions &cmd, const std::strin
                     "The first character of the string specified with this option will be used in placed of illegal "
                     "characters in n-strings and a-strings."
                    )
+        << tl::arg (group +
+                    "#--write-threads=threads", &m_oasis_threads, "Specifies the number of threads to use for writing cells",
+                    "With this option, the cell bodies are prepared - including shape array formation and CBLOCK "
+                    "compression - in the given number of threads. The file produced is identical to the one written "
+                    "without threads. The default is 0 which means all cells are written in the main thread."
+                   )
       ;
 
   }
@@ -329,6 +346,12 @@ GenericWriterOptions::add_options (tl::CommandLineOptions &cmd, const std::strin
                     "In permissive mode, certain forbidden objects are reported as warnings, not as errors: "
                     "paths with odd width, polygons with less than three points etc."
                    )
+        << tl::arg (group +
+                    "#--lstr-tile-size=size", &m_lstream_tile_size, "Writes the shapes in tiles of the given size",
+                    "If this value (in micrometer units) is larger than zero, the shapes of a cell layer are split into tiles "
+                    "of the given size. This forms a spatial index which allows readers to read a region of interest only. "
+                    "The default is 0 which disables tiling."
+                   )
       ;
 
   }
@@ -448,6 +471,7 @@ GenericWriterOptions::configure (db::SaveLayoutOptions &save_options, const db::
   save_options.set_dont_write_empty_cells (m_dont_write_empty_cells);
   save_options.set_keep_instances (m_keep_instances);
   save_options.set_write_context_info (m_write_context_info);
+  save_options.set_compression_threads (m_compression_threads);
 
   if (! m_format.empty ()) {
 
@@ -484,6 +508,7 @@ GenericWriterOptions::configure (db::SaveLayoutOptions &save_options, const db::
   //  Note: "..._ext" is a version taking the real value (not just a boolean)
   save_options.set_option_by_name ("oasis_write_std_properties_ext", m_oasis_write_std_properties);
   save_options.set_option_by_name ("oasis_substitution_char", m_oasis_subst_char);
+  save_options.set_option_by_name ("oasis_threads", m_oasis_threads);
 
   save_options.set_option_by_name ("cif_dummy_calls", m_cif_dummy_calls);
   save_options.set_option_by_name ("cif_blank_separator", m_cif_blank_separator);
@@ -493,6 +518,7 @@ GenericWriterOptions::configure (db::SaveLayoutOptions &save_options, const db::
   save_options.set_option_by_name ("lstream_compression_level", m_lstream_compression_level);
   save_options.set_option_by_name ("lstream_recompress", m_lstream_recompress);
   save_options.set_option_by_name ("lstream_permissive", m_lstream_permissive);
+  save_options.set_option_by_name ("lstream_tile_size", m_lstream_tile_size);
 
   save_options.set_option_by_name ("mag_lambda", m_magic_lambda);
   save_options.set_option_by_name ("mag_tech", m_magic_tech);
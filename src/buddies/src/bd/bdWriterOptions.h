@@ -127,6 +127,7 @@ private:
   bool m_keep_instances;
   bool m_write_context_info;
   std::string m_cell_selection;
+  int m_compression_threads;
 
   unsigned int m_gds2_max_vertex_count;
   bool m_gds2_no_zero_length_paths;
@@ -147,6 +148,7 @@ private:
   bool m_oasis_permissive;
   int m_oasis_write_std_properties;
   std::string m_oasis_subst_char;
+  int m_oasis_threads;
 
   bool m_cif_dummy_calls;
   bool m_cif_blank_separator;
@@ -159,6 +161,7 @@ private:
   int m_lstream_compression_level;
   bool m_lstream_recompress;
   bool m_lstream_permissive;
+  double m_lstream_tile_size;
 
   void set_oasis_substitution_char (const std::string &text);
   void init_from_options (const db::SaveLayoutOptions &options);
@@ -72,6 +72,17 @@ void clip (ClipData &data)
   {
     db::LoadLayoutOptions load_options;
     data.reader_options.configure (load_options);
+
+    //  If the clip region is given by explicit boxes in the top cells' coordinates, readers
+    //  supporting a region of interest only need to deliver the shapes inside these boxes
+    if (data.clip_layer.is_null () && data.top.empty () && ! data.clip_boxes.empty ()) {
+      db::DBox region;
+      for (std::vector <db::DBox>::const_iterator b = data.clip_boxes.begin (); b != data.clip_boxes.end (); ++b) {
+        region += *b;
+      }
+      load_options.set_option_by_name ("lstream_region", tl::Variant::make_variant (region));
+    }
+
     bd::read_files (layout, data.file_in, load_options);
   }
 
@@ -156,7 +167,7 @@ void clip (ClipData &data)
   std::string of = save_options.set_format_from_filename (data.file_out).second;
   data.writer_options.configure (save_options, target_layout);
 
-  tl::OutputStream stream (of);
+  tl::OutputStream stream (of, tl::OutputStream::OM_Auto, false, 0, save_options.compression_threads ());
   db::Writer writer (save_options);
   writer.write (target_layout, stream);
 }
@@ -43,6 +43,7 @@ BD_PUBLIC int strmcmp (int argc, char *argv[])
   std::string top_a, top_b;
   bool silent = false;
   bool ignore_duplicates = false;
+  bool no_fingerprints = false;
   bool no_text_orientation = true;
   bool no_text_details = true;
   bool no_properties = false;
@@ -57,6 +58,7 @@ BD_PUBLIC int strmcmp (int argc, char *argv[])
   double tolerance = 0.0;
   int max_count = 0;
   bool print_properties = false;
+  int threads = 0;
 
   tl::CommandLineOptions cmd;
   generic_reader_options_a.add_options (cmd);
@@ -112,6 +114,11 @@ BD_PUBLIC int strmcmp (int argc, char *argv[])
                   "With this option, duplicate instances or shapes are ignored and duplication "
                   "does not count as a difference."
                  )
+      << tl::arg ("--no-fingerprints",         &no_fingerprints, "Compares all layers shape by shape",
+                  "By default, layers with identical content fingerprints (hash values computed from the shapes) "
+                  "are considered identical without comparing the shapes individually. With this option, "
+                  "all layers are compared shape by shape."
+                 )
       << tl::arg ("-l|--layer-details",        &dont_summarize_missing_layers, "Prints details about differences for missing layers",
                   "With this option, missing layers are treated as \"empty\" and details about differences to "
                   "other, non-empty layers are printed. Essentially the content of the non-empty counterpart "
@@ -132,6 +139,10 @@ BD_PUBLIC int strmcmp (int argc, char *argv[])
                   "If the value is >1, max-count-1 differences plus one warning about abbreviation is printed. "
                   "A value of 0 means \"no limitation\". To suppress all output, use --silent."
                  )
+      << tl::arg ("-n|--threads=threads",      &threads,   "Specifies the number of threads to use",
+                  "If this value is larger than 0, the cells are compared by the given number of worker threads. "
+                  "The differences are reported in the same order as without threads."
+                 )
     ;
 
   cmd.brief ("This program will compare two layout files on a per-object basis");
@@ -166,6 +177,9 @@ BD_PUBLIC int strmcmp (int argc, char *argv[])
   if (ignore_duplicates) {
     flags |= db::layout_diff::f_ignore_duplicates;
   }
+  if (no_fingerprints) {
+    flags |= db::layout_diff::f_no_fingerprints;
+  }
   if (no_text_orientation) {
     flags |= db::layout_diff::f_no_text_orientation;
   }
@@ -236,10 +250,10 @@ BD_PUBLIC int strmcmp (int argc, char *argv[])
       throw tl::Exception ("'" + top_b + "' is not a valid cell name in second layout");
     }
 
-    result = db::compare_layouts (layout_a, index_a.second, layout_b, index_b.second, flags, tolerance_dbu, max_count, print_properties);
+    result = db::compare_layouts (layout_a, index_a.second, layout_b, index_b.second, flags, tolerance_dbu, max_count, print_properties, threads);
 
   } else {
-    result = db::compare_layouts (layout_a, layout_b, flags, tolerance_dbu, max_count, print_properties);
+    result = db::compare_layouts (layout_a, layout_b, flags, tolerance_dbu, max_count, print_properties, threads);
   }
 
   if (! result && ! silent) {
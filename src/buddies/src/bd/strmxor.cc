@@ -592,7 +592,7 @@ BD_PUBLIC int strmxor (int argc, char *argv[])
     std::string of = save_options.set_format_from_filename (output).second;
     writer_options.configure (save_options, *output_layout);
 
-    tl::OutputStream stream (of);
+    tl::OutputStream stream (of, tl::OutputStream::OM_Auto, false, 0, save_options.compression_threads ());
     db::Writer writer (save_options);
     writer.write (*output_layout, stream);
 
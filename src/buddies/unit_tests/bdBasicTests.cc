@@ -23,6 +23,7 @@
 #include "bdWriterOptions.h"
 #include "bdReaderOptions.h"
 #include "tlCommandLineParser.h"
+#include "tlStream.h"
 #include "tlUnitTest.h"
 #include "dbLayout.h"
 #include "dbCell.h"
@@ -63,7 +64,9 @@ TEST(1)
                    "-ot=false",
                    "--recompress",
                    "--subst-char=XY",
-                   "--write-std-properties=2"
+                   "--write-std-properties=2",
+                   "--write-threads=4",
+                   "--gzip-threads=2"
                  };
 
   cmd.parse (sizeof (argv) / sizeof (argv[0]), const_cast<char **> (argv));
@@ -92,6 +95,7 @@ TEST(1)
   EXPECT_EQ (stream_opt.get_option_by_name ("oasis_recompress").to_bool (), false);
   EXPECT_EQ (stream_opt.get_option_by_name ("oasis_substitution_char").to_string (), "*");
   EXPECT_EQ (stream_opt.get_option_by_name ("oasis_write_std_properties_ext").to_int (), 1);
+  EXPECT_EQ (stream_opt.get_option_by_name ("oasis_threads").to_int (), 0);
 
   opt.configure (stream_opt, layout);
 
@@ -119,6 +123,8 @@ TEST(1)
   EXPECT_EQ (stream_opt.get_option_by_name ("oasis_recompress").to_bool (), true);
   EXPECT_EQ (stream_opt.get_option_by_name ("oasis_substitution_char").to_string (), "X");
   EXPECT_EQ (stream_opt.get_option_by_name ("oasis_write_std_properties_ext").to_int (), 2);
+  EXPECT_EQ (stream_opt.get_option_by_name ("oasis_threads").to_int (), 4);
+  EXPECT_EQ (stream_opt.compression_threads (), 2);
 }
 
 //  Testing writer options (default_text_size)
@@ -281,10 +287,12 @@ TEST(10)
                          "-ib=3",
                          "--no-big-records",
                          "--no-multi-xy-records",
+                         "--gds2-threads=3",
                          //  General
                          "-im=1/0 3,4/0-255 A:17/0",
                          "-is",
                          "--blend-mode=1",
+                         "--lazy-loading",
                          //  OASIS
                          "--expect-strict-mode=1"
                        };
@@ -309,11 +317,13 @@ TEST(10)
   EXPECT_EQ (stream_opt.get_option_by_name ("layer_map").to_user<db::LayerMap> ().to_string (), "layer_map()");
   EXPECT_EQ (stream_opt.get_option_by_name ("create_other_layers").to_bool (), true);
   EXPECT_EQ (stream_opt.get_option_by_name ("cell_conflict_resolution").to_string (), "AddToCell");
+  EXPECT_EQ (stream_opt.get_option_by_name ("lazy_loading").to_bool (), false);
   EXPECT_EQ (stream_opt.get_option_by_name ("properties_enabled").to_bool (), true);
   EXPECT_EQ (stream_opt.get_option_by_name ("text_enabled").to_bool (), true);
   EXPECT_EQ (stream_opt.get_option_by_name ("gds2_box_mode").to_uint (), (unsigned int) 1);
   EXPECT_EQ (stream_opt.get_option_by_name ("gds2_allow_big_records").to_bool (), true);
   EXPECT_EQ (stream_opt.get_option_by_name ("gds2_allow_multi_xy_records").to_bool (), true);
+  EXPECT_EQ (stream_opt.get_option_by_name ("gds2_threads").to_int (), 0);
   EXPECT_EQ (stream_opt.get_option_by_name ("oasis_expect_strict_mode").to_int (), -1);
 
   opt.configure (stream_opt);
@@ -335,11 +345,13 @@ TEST(10)
   EXPECT_EQ (stream_opt.get_option_by_name ("layer_map").to_user<db::LayerMap> ().to_string (), "layer_map('1/0';'3-4/0-255';'A : 17/0')");
   EXPECT_EQ (stream_opt.get_option_by_name ("create_other_layers").to_bool (), false);
   EXPECT_EQ (stream_opt.get_option_by_name ("cell_conflict_resolution").to_string (), "OverwriteCell");
+  EXPECT_EQ (stream_opt.get_option_by_name ("lazy_loading").to_bool (), true);
   EXPECT_EQ (stream_opt.get_option_by_name ("properties_enabled").to_bool (), false);
   EXPECT_EQ (stream_opt.get_option_by_name ("text_enabled").to_bool (), false);
   EXPECT_EQ (stream_opt.get_option_by_name ("gds2_box_mode").to_uint (), (unsigned int) 3);
   EXPECT_EQ (stream_opt.get_option_by_name ("gds2_allow_big_records").to_bool (), false);
   EXPECT_EQ (stream_opt.get_option_by_name ("gds2_allow_multi_xy_records").to_bool (), false);
+  EXPECT_EQ (stream_opt.get_option_by_name ("gds2_threads").to_int (), 3);
   EXPECT_EQ (stream_opt.get_option_by_name ("oasis_expect_strict_mode").to_int (), 1);
 }
 
@@ -41,6 +41,7 @@
 #include "dbHierProcessor.h"
 #include "dbCompoundOperation.h"
 #include "dbLayoutToNetlist.h"
+#include "tlThreadedWorkers.h"
 
 #include <sstream>
 
@@ -329,6 +330,7 @@ void AsIfFlatRegion::merge_polygons_to (db::Shapes &output, bool min_coherence,
 {
   db::EdgeProcessor ep (report_progress (), progress_desc ());
   ep.set_base_verbosity (base_verbosity ());
+  ep.set_threads (threads ());
 
   //  count edges and reserve memory
   size_t n = 0;
@@ -1303,6 +1305,7 @@ AsIfFlatRegion::run_check (db::edge_relation_type rel, bool different_polygons,
     proc.set_base_verbosity (base_verbosity ());
     proc.set_description (progress_desc ());
     proc.set_report_progress (report_progress ());
+    proc.set_threads (threads ());
 
     proc.run_flat (polygons, others, foreign, &op, results);
 
@@ -1314,6 +1317,7 @@ AsIfFlatRegion::run_check (db::edge_relation_type rel, bool different_polygons,
     proc.set_base_verbosity (base_verbosity ());
     proc.set_description (progress_desc ());
     proc.set_report_progress (report_progress ());
+    proc.set_threads (threads ());
 
     std::vector<db::generic_shape_iterator<db::PolygonWithProperties> > others_wp;
     for (auto o = others.begin (); o != others.end (); ++o) {
@@ -1327,6 +1331,79 @@ AsIfFlatRegion::run_check (db::edge_relation_type rel, bool different_polygons,
   return output.release ();
 }
 
+namespace
+{
+
+/**
+ *  @brief A chunk of polygons for the parallel single-polygon checks
+ */
+struct SinglePolygonCheckChunk
+{
+  std::vector<std::pair<db::Polygon, db::properties_id_type> > polygons;
+  db::Shapes output;
+  std::string error;
+};
+
+class SinglePolygonCheckTask
+  : public tl::Task
+{
+public:
+  SinglePolygonCheckTask (SinglePolygonCheckChunk *chunk, const EdgeRelationFilter *check, const RegionCheckOptions *options)
+    : mp_chunk (chunk), mp_check (check), mp_options (options)
+  { }
+
+  void perform ()
+  {
+    try {
+      for (auto p = mp_chunk->polygons.begin (); p != mp_chunk->polygons.end (); ++p) {
+        single_polygon_check (p->first, p->second, *mp_check, *mp_options, mp_chunk->output);
+      }
+    } catch (tl::Exception &ex) {
+      mp_chunk->error = ex.msg ();
+    } catch (std::exception &ex) {
+      mp_chunk->error = ex.what ();
+    } catch (...) {
+      mp_chunk->error = tl::to_string (tr ("Unspecific error"));
+    }
+  }
+
+  static void single_polygon_check (const db::Polygon &poly, db::properties_id_type prop_id, const EdgeRelationFilter &check, const RegionCheckOptions &options, db::Shapes &output)
+  {
+    edge2edge_check_negative_or_positive<db::Shapes> edge_check (check, output, options.negative, false /*=same polygons*/, false /*=same layers*/, options.shielded, true /*symmetric edge pairs*/, pc_remove (options.prop_constraint) ? 0 : prop_id);
+    poly2poly_check<db::Polygon> poly_check (edge_check);
+
+    do {
+      poly_check.single (poly, 0);
+    } while (edge_check.prepare_next_pass ());
+  }
+
+private:
+  SinglePolygonCheckChunk *mp_chunk;
+  const EdgeRelationFilter *mp_check;
+  const RegionCheckOptions *mp_options;
+};
+
+class SinglePolygonCheckWorker
+  : public tl::Worker
+{
+public:
+  SinglePolygonCheckWorker ()
+    : tl::Worker ()
+  { }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<SinglePolygonCheckTask *> (task)->perform ();
+  }
+};
+
+/**
+ *  @brief The number of polygons per chunk in the parallel single-polygon checks
+ */
+const size_t polygons_per_check_chunk = 256;
+
+}
+
 EdgePairsDelegate *
 AsIfFlatRegion::run_single_polygon_check (db::edge_relation_type rel, db::Coord d, const RegionCheckOptions &options) const
 {
@@ -1334,14 +1411,58 @@ AsIfFlatRegion::run_single_polygon_check (db::edge_relation_type rel, db::Coord
 
   EdgeRelationFilter check (rel, d, options);
 
-  for (RegionIterator p (begin_merged ()); ! p.at_end (); ++p) {
+  if (threads () > 0) {
 
-    edge2edge_check_negative_or_positive<db::Shapes> edge_check (check, result->raw_edge_pairs (), options.negative, false /*=same polygons*/, false /*=same layers*/, options.shielded, true /*symmetric edge pairs*/, pc_remove (options.prop_constraint) ? 0 : p.prop_id ());
-    poly2poly_check<db::Polygon> poly_check (edge_check);
+    //  multi-threaded mode: the polygons are checked individually, so we can distribute them over
+    //  chunks which are computed in parallel. The chunks are formed while iterating the polygons.
+    //  NOTE: the list keeps the chunks in place while the tasks are scheduled
 
-    do {
-      poly_check.single (*p, 0);
-    } while (edge_check.prepare_next_pass ());
+    std::list<SinglePolygonCheckChunk> chunks;
+    for (RegionIterator p (begin_merged ()); ! p.at_end (); ++p) {
+      if (chunks.empty () || chunks.back ().polygons.size () >= polygons_per_check_chunk) {
+        chunks.push_back (SinglePolygonCheckChunk ());
+        chunks.back ().polygons.reserve (polygons_per_check_chunk);
+      }
+      chunks.back ().polygons.push_back (std::make_pair (*p, p.prop_id ()));
+    }
+
+    if (chunks.size () >= 2) {
+
+      tl::Job<SinglePolygonCheckWorker> job (threads ());
+      for (auto c = chunks.begin (); c != chunks.end (); ++c) {
+        job.schedule (new SinglePolygonCheckTask (&*c, &check, &options));
+      }
+
+      try {
+        job.start ();
+        job.wait ();
+      } catch (...) {
+        job.terminate ();
+        throw;
+      }
+
+      for (auto c = chunks.begin (); c != chunks.end (); ++c) {
+        if (! c->error.empty ()) {
+          throw tl::Exception (c->error);
+        }
+        result->raw_edge_pairs ().insert (c->output);
+      }
+
+    } else {
+
+      for (auto c = chunks.begin (); c != chunks.end (); ++c) {
+        for (auto p = c->polygons.begin (); p != c->polygons.end (); ++p) {
+          SinglePolygonCheckTask::single_polygon_check (p->first, p->second, check, options, result->raw_edge_pairs ());
+        }
+      }
+
+    }
+
+  } else {
+
+    for (RegionIterator p (begin_merged ()); ! p.at_end (); ++p) {
+      SinglePolygonCheckTask::single_polygon_check (*p, p.prop_id (), check, options, result->raw_edge_pairs ());
+    }
 
   }
 
@@ -1689,6 +1810,7 @@ AsIfFlatRegion::and_or_not_with (bool is_and, const Region &other, PropertyConst
     //  Generic case
     db::EdgeProcessor ep (report_progress (), progress_desc ());
     ep.set_base_verbosity (base_verbosity ());
+    ep.set_threads (threads ());
 
     //  count edges and reserve memory
     size_t n = 0;
@@ -1766,6 +1888,7 @@ AsIfFlatRegion::andnot_with (const Region &other, PropertyConstraint property_co
     //  Generic case
     db::EdgeProcessor ep (report_progress (), progress_desc ());
     ep.set_base_verbosity (base_verbosity ());
+    ep.set_threads (threads ());
 
     //  count edges and reserve memory
     size_t n = 0;
@@ -1854,6 +1977,7 @@ AsIfFlatRegion::xor_with (const Region &other, PropertyConstraint prop_constrain
     //  Generic case
     db::EdgeProcessor ep (report_progress (), progress_desc ());
     ep.set_base_verbosity (base_verbosity ());
+    ep.set_threads (threads ());
 
     //  count edges and reserve memory
     size_t n = 0;
@@ -1910,6 +2034,7 @@ AsIfFlatRegion::or_with (const Region &other, PropertyConstraint /*prop_constrai
     //  Generic case
     db::EdgeProcessor ep (report_progress (), progress_desc ());
     ep.set_base_verbosity (base_verbosity ());
+    ep.set_threads (threads ());
 
     //  count edges and reserve memory
     size_t n = 0;
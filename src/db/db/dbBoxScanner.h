@@ -28,6 +28,8 @@
 
 #include "dbBoxConvert.h"
 #include "tlProgress.h"
+#include "tlThreadedWorkers.h"
+#include "tlAssert.h"
 
 #include <list>
 #include <vector>
@@ -35,6 +37,8 @@
 #include <set>
 #include <functional>
 #include <memory>
+#include <algorithm>
+#include <string>
 
 namespace db
 {
@@ -160,6 +164,240 @@ struct box_scanner_receiver
   virtual void finalize (bool) { }
 };
 
+/**
+ *  @brief The strip partitioning for the parallel box scanners
+ *
+ *  The plane is divided into vertical strips. An interaction between two objects is reported
+ *  by the strip which contains the larger one of the two left box coordinates. As the
+ *  enlarged boxes overlap at this x position, both objects are present in this strip.
+ *  Hence every interaction is reported exactly once.
+ */
+template <class C>
+class box_scanner_strips
+{
+public:
+  /**
+   *  @brief Creates the strip partitioning from the left coordinates of the boxes
+   *
+   *  The strips are formed such that every strip starts roughly the same number of boxes.
+   */
+  box_scanner_strips (std::vector<C> &lefts, size_t nstrips)
+  {
+    std::sort (lefts.begin (), lefts.end ());
+    for (size_t i = 1; i < nstrips && ! lefts.empty (); ++i) {
+      m_bounds.push_back (lefts [lefts.size () * i / nstrips]);
+    }
+  }
+
+  /**
+   *  @brief Gets the index of the strip containing the given x coordinate
+   */
+  size_t strip_of (C x) const
+  {
+    return std::upper_bound (m_bounds.begin (), m_bounds.end (), x) - m_bounds.begin ();
+  }
+
+  /**
+   *  @brief Gets the index of the last strip overlapping with the x range ending at the given coordinate (exclusive)
+   */
+  size_t last_strip_before (C x) const
+  {
+    return std::lower_bound (m_bounds.begin (), m_bounds.end (), x) - m_bounds.begin ();
+  }
+
+  /**
+   *  @brief Gets the first and last index of the strips a box is present in
+   *
+   *  These are the strips overlapping with the box enlarged by "enl" to the right.
+   *  All interactions of an object are reported in one of these strips.
+   */
+  template <class Box>
+  std::pair<size_t, size_t> strip_range (const Box &b, C enl) const
+  {
+    size_t from = strip_of (b.left ());
+    size_t to = std::max (from, last_strip_before (b.right () + enl));
+    return std::make_pair (from, to);
+  }
+
+  /**
+   *  @brief Delivers "finish" to all distinct receivers of the strips a box is present in
+   *
+   *  The receivers are the ones which may have seen interactions with the object.
+   *  A receiver given for multiple strips is called only once.
+   */
+  template <class Rec, class Box, class F>
+  void finish (const std::vector<Rec *> &recs, const Box &b, C enl, F f) const
+  {
+    std::pair<size_t, size_t> sr = strip_range (b, enl);
+    for (size_t s = sr.first; s <= sr.second && s < recs.size (); ++s) {
+      if (std::find (recs.begin () + sr.first, recs.begin () + s, recs [s]) == recs.begin () + s) {
+        f (recs [s]);
+      }
+    }
+  }
+
+private:
+  std::vector<C> m_bounds;
+};
+
+/**
+ *  @brief A receiver wrapper for the strips of the parallel box scanners
+ *
+ *  This receiver forwards only the interactions owned by the strip and drops the "finish" events.
+ *  These are delivered after all strips have been scanned.
+ */
+template <class Rec, class BoxConvertAdaptor1, class BoxConvertAdaptor2, class C>
+class box_scanner_strip_receiver
+{
+public:
+  box_scanner_strip_receiver (Rec *rec, const BoxConvertAdaptor1 &bc1, const BoxConvertAdaptor2 &bc2, const box_scanner_strips<C> *strips, size_t strip)
+    : mp_rec (rec), m_bc1 (bc1), m_bc2 (bc2), mp_strips (strips), m_strip (strip)
+  { }
+
+  template <class Obj, class Prop>
+  void finish (const Obj *, const Prop &) { }
+
+  template <class Obj, class Prop>
+  void finish1 (const Obj *, const Prop &) { }
+
+  template <class Obj, class Prop>
+  void finish2 (const Obj *, const Prop &) { }
+
+  template <class Obj1, class Prop1, class Obj2, class Prop2>
+  void add (const Obj1 *o1, const Prop1 &p1, const Obj2 *o2, const Prop2 &p2)
+  {
+    C l1 = m_bc1 (std::make_pair (o1, p1)).left ();
+    C l2 = m_bc2 (std::make_pair (o2, p2)).left ();
+    if (mp_strips->strip_of (std::max (l1, l2)) == m_strip) {
+      mp_rec->add (o1, p1, o2, p2);
+    }
+  }
+
+  bool stop () const
+  {
+    return mp_rec->stop ();
+  }
+
+  void initialize () { }
+  void finalize (bool) { }
+
+private:
+  Rec *mp_rec;
+  const BoxConvertAdaptor1 &m_bc1;
+  const BoxConvertAdaptor2 &m_bc2;
+  const box_scanner_strips<C> *mp_strips;
+  size_t m_strip;
+};
+
+/**
+ *  @brief A task for the parallel box scanners
+ *
+ *  "Strip" needs to provide a "run" method which must not throw exceptions.
+ */
+template <class Strip>
+class box_scanner_strip_task
+  : public tl::Task
+{
+public:
+  box_scanner_strip_task (Strip *strip)
+    : mp_strip (strip)
+  { }
+
+  void perform ()
+  {
+    mp_strip->run ();
+  }
+
+private:
+  Strip *mp_strip;
+};
+
+template <class Strip>
+class box_scanner_strip_worker
+  : public tl::Worker
+{
+public:
+  box_scanner_strip_worker ()
+    : tl::Worker ()
+  { }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<box_scanner_strip_task<Strip> *> (task)->perform ();
+  }
+};
+
+/**
+ *  @brief Runs the strips of a parallel box scanner
+ *
+ *  With "threads" being 0, the strips are executed sequentially.
+ *  Returns false, if one of the strips was stopped by the receiver.
+ */
+template <class Strip>
+bool run_box_scanner_strips (std::vector<Strip> &strips, unsigned int threads)
+{
+  if (threads > 0) {
+
+    tl::Job<box_scanner_strip_worker<Strip> > job (threads);
+    for (typename std::vector<Strip>::iterator s = strips.begin (); s != strips.end (); ++s) {
+      job.schedule (new box_scanner_strip_task<Strip> (&*s));
+    }
+
+    try {
+      job.start ();
+      job.wait ();
+    } catch (...) {
+      job.terminate ();
+      throw;
+    }
+
+  } else {
+    for (typename std::vector<Strip>::iterator s = strips.begin (); s != strips.end (); ++s) {
+      s->run ();
+    }
+  }
+
+  bool ret = true;
+  for (typename std::vector<Strip>::const_iterator s = strips.begin (); s != strips.end (); ++s) {
+    if (! s->error.empty ()) {
+      throw tl::Exception (s->error);
+    }
+    if (! s->result) {
+      ret = false;
+    }
+  }
+
+  return ret;
+}
+
+/**
+ *  @brief Calls "initialize" on every distinct receiver
+ */
+template <class Rec>
+void initialize_box_scanner_receivers (const std::vector<Rec *> &recs)
+{
+  std::set<Rec *> seen;
+  for (typename std::vector<Rec *>::const_iterator r = recs.begin (); r != recs.end (); ++r) {
+    if (seen.insert (*r).second) {
+      (*r)->initialize ();
+    }
+  }
+}
+
+/**
+ *  @brief Calls "finalize" on every distinct receiver
+ */
+template <class Rec>
+void finalize_box_scanner_receivers (const std::vector<Rec *> &recs, bool ret)
+{
+  std::set<Rec *> seen;
+  for (typename std::vector<Rec *>::const_iterator r = recs.begin (); r != recs.end (); ++r) {
+    if (seen.insert (*r).second) {
+      (*r)->finalize (ret);
+    }
+  }
+}
+
 /**
  *  @brief A box scanner framework
  *
@@ -281,6 +519,14 @@ public:
     m_pp.clear ();
   }
 
+  /**
+   *  @brief Gets the number of objects stored
+   */
+  size_t size () const
+  {
+    return m_pp.size ();
+  }
+
   /**
    *  @brief Inserts a new object into the scanner
    *
@@ -336,6 +582,48 @@ public:
     return ret;
   }
 
+  /**
+   *  @brief Gets the interactions between the stored objects using multiple threads
+   *
+   *  This method delivers the same interactions than "process", but splits the plane into
+   *  vertical strips which are scanned in parallel. One receiver needs to be given per strip and
+   *  the number of receivers determines the number of strips. The same receiver can be given
+   *  multiple times if it is thread-safe. Otherwise, the caller is responsible for joining
+   *  the results of the receivers after the scan.
+   *
+   *  Every interaction is reported exactly once, but the order of the interactions is not defined.
+   *  "finish" is called after all strips have been scanned. It is called once on every distinct
+   *  receiver of the strips the object is present in, so every receiver which has seen
+   *  interactions with the object receives "finish" for it too. A receiver may receive "finish"
+   *  for objects it has not seen interactions for - the same happens in "process".
+   *  Receivers which are given for multiple strips receive "finish" only once per object.
+   *  "initialize" and "finalize" are called once on every receiver.
+   *  If the number of objects is small, the objects are scanned as a single strip with the
+   *  first receiver.
+   *
+   *  "threads" is the number of worker threads. With 0 threads, the strips are scanned sequentially.
+   */
+  template <class Rec, class BoxConvert>
+  bool process_parallel (const std::vector<Rec *> &recs, unsigned int threads, typename BoxConvert::box_type::coord_type enl, const BoxConvert &bc = BoxConvert ())
+  {
+    initialize_box_scanner_receivers (recs);
+    bool ret = do_process_parallel (recs, threads, enl, box_convert_adaptor_take_first<BoxConvert> (bc));
+    finalize_box_scanner_receivers (recs, ret);
+    return ret;
+  }
+
+  /**
+   *  @brief Same as "process_parallel", but allows specfying a box convert adaptor
+   */
+  template <class Rec, class BoxConvertAdaptor = BoxConvertAdaptorTakeSecond>
+  bool process_parallel_with_adaptor (const std::vector<Rec *> &recs, unsigned int threads, typename BoxConvertAdaptor::box_type::coord_type enl, const BoxConvertAdaptor &bca = BoxConvertAdaptor ())
+  {
+    initialize_box_scanner_receivers (recs);
+    bool ret = do_process_parallel (recs, threads, enl, bca);
+    finalize_box_scanner_receivers (recs, ret);
+    return ret;
+  }
+
 private:
   container_type m_pp;
   double m_fill_factor;
@@ -343,6 +631,108 @@ private:
   bool m_report_progress;
   std::string m_progress_desc;
 
+  template <class Rec, class BoxConvertAdaptor>
+  struct parallel_strip
+  {
+    typedef typename BoxConvertAdaptor::box_type::coord_type coord_type;
+
+    parallel_strip ()
+      : rec (0), strips (0), index (0), enl (0), bc (0), result (true)
+    { }
+
+    void run ()
+    {
+      try {
+        box_scanner_strip_receiver<Rec, BoxConvertAdaptor, BoxConvertAdaptor, coord_type> strip_rec (rec, *bc, *bc, strips, index);
+        result = scanner.process_with_adaptor (strip_rec, enl, *bc);
+      } catch (tl::Exception &ex) {
+        error = ex.msg ();
+      } catch (std::exception &ex) {
+        error = ex.what ();
+      } catch (...) {
+        error = tl::to_string (tr ("Unspecific error"));
+      }
+    }
+
+    box_scanner<Obj, Prop> scanner;
+    Rec *rec;
+    const box_scanner_strips<coord_type> *strips;
+    size_t index;
+    coord_type enl;
+    const BoxConvertAdaptor *bc;
+    bool result;
+    std::string error;
+  };
+
+  template <class Rec, class BoxConvertAdaptor>
+  bool do_process_parallel (const std::vector<Rec *> &recs, unsigned int threads, typename BoxConvertAdaptor::box_type::coord_type enl, const BoxConvertAdaptor &bc)
+  {
+    typedef typename BoxConvertAdaptor::box_type box_type;
+    typedef typename box_type::coord_type coord_type;
+
+    tl_assert (! recs.empty ());
+
+    if (recs.size () == 1 || m_pp.size () <= m_scanner_thr) {
+      return do_process (*recs.front (), enl, bc);
+    }
+
+    //  sort out the entries with an empty bbox and form the strips from the left coordinates of the others
+
+    std::vector<coord_type> lefts;
+    lefts.reserve (m_pp.size ());
+
+    typename container_type::iterator wi = m_pp.begin ();
+    for (typename container_type::iterator ri = m_pp.begin (); ri != m_pp.end (); ++ri) {
+      box_type b = bc (*ri);
+      if (! b.empty ()) {
+        lefts.push_back (b.left ());
+        if (wi != ri) {
+          *wi = *ri;
+        }
+        ++wi;
+      } else {
+        recs.front ()->finish (ri->first, ri->second);
+      }
+    }
+
+    if (wi != m_pp.end ()) {
+      m_pp.erase (wi, m_pp.end ());
+    }
+
+    box_scanner_strips<coord_type> strips (lefts, recs.size ());
+    std::vector<coord_type> ().swap (lefts);
+
+    std::vector<parallel_strip<Rec, BoxConvertAdaptor> > ps (recs.size ());
+    for (size_t i = 0; i < ps.size (); ++i) {
+      ps [i].rec = recs [i];
+      ps [i].strips = &strips;
+      ps [i].index = i;
+      ps [i].enl = enl;
+      ps [i].bc = &bc;
+      ps [i].scanner.set_fill_factor (m_fill_factor);
+      ps [i].scanner.set_scanner_threshold (m_scanner_thr);
+    }
+
+    //  an object is present in all strips its enlarged box overlaps with
+    for (iterator_type i = m_pp.begin (); i != m_pp.end (); ++i) {
+      std::pair<size_t, size_t> sr = strips.strip_range (bc (*i), enl);
+      for (size_t s = sr.first; s <= sr.second && s < ps.size (); ++s) {
+        ps [s].scanner.insert (i->first, i->second);
+      }
+    }
+
+    bool ret = run_box_scanner_strips (ps, threads);
+
+    if (ret) {
+      //  every receiver which may have seen interactions with an object receives "finish" for it
+      for (iterator_type i = m_pp.begin (); i != m_pp.end (); ++i) {
+        strips.finish (recs, bc (*i), enl, [i] (Rec *rec) { rec->finish (i->first, i->second); });
+      }
+    }
+
+    return ret;
+  }
+
   template <class Rec, class BoxConvertAdaptor>
   bool do_process (Rec &rec, typename BoxConvertAdaptor::box_type::coord_type enl, const BoxConvertAdaptor &bc = BoxConvertAdaptor ())
   {
@@ -733,6 +1123,14 @@ public:
     m_pp2.clear ();
   }
 
+  /**
+   *  @brief Gets the number of objects stored (of both types)
+   */
+  size_t size () const
+  {
+    return m_pp1.size () + m_pp2.size ();
+  }
+
   /**
    *  @brief Inserts a new object of type Obj1 into the scanner
    *
@@ -801,6 +1199,48 @@ public:
     return ret;
   }
 
+  /**
+   *  @brief Gets the interactions between the stored objects using multiple threads
+   *
+   *  This method delivers the same interactions than "process", but splits the plane into
+   *  vertical strips which are scanned in parallel. One receiver needs to be given per strip and
+   *  the number of receivers determines the number of strips. The same receiver can be given
+   *  multiple times if it is thread-safe. Otherwise, the caller is responsible for joining
+   *  the results of the receivers after the scan.
+   *
+   *  Every interaction is reported exactly once, but the order of the interactions is not defined.
+   *  "finish1" and "finish2" are called after all strips have been scanned. They are called once
+   *  on every distinct receiver of the strips the object is present in, so every receiver which
+   *  has seen interactions with the object receives "finish1" or "finish2" for it too. A receiver
+   *  may receive these calls for objects it has not seen interactions for - the same happens in
+   *  "process". Receivers which are given for multiple strips are called only once per object.
+   *  "initialize" and "finalize" are called once on every receiver.
+   *  If the number of objects is small, the objects are scanned as a single strip with the
+   *  first receiver.
+   *
+   *  "threads" is the number of worker threads. With 0 threads, the strips are scanned sequentially.
+   */
+  template <class Rec, class BoxConvert1, class BoxConvert2>
+  bool process_parallel (const std::vector<Rec *> &recs, unsigned int threads, typename BoxConvert1::box_type::coord_type enl, const BoxConvert1 &bc1 = BoxConvert1 (), const BoxConvert2 &bc2 = BoxConvert2 ())
+  {
+    initialize_box_scanner_receivers (recs);
+    bool ret = do_process_parallel (recs, threads, enl, box_convert_adaptor_take_first1<BoxConvert1> (bc1), box_convert_adaptor_take_first2<BoxConvert2> (bc2));
+    finalize_box_scanner_receivers (recs, ret);
+    return ret;
+  }
+
+  /**
+   *  @brief Same as "process_parallel", but allows specfying a box convert adaptor
+   */
+  template <class Rec, class BoxConvertAdaptor1 = BoxConvertAdaptorTakeSecond1, class BoxConvertAdaptor2 = BoxConvertAdaptorTakeSecond2>
+  bool process_parallel_with_adaptor (const std::vector<Rec *> &recs, unsigned int threads, typename BoxConvertAdaptor1::box_type::coord_type enl, const BoxConvertAdaptor1 &bca1 = BoxConvertAdaptor1 (), const BoxConvertAdaptor2 &bca2 = BoxConvertAdaptor2 ())
+  {
+    initialize_box_scanner_receivers (recs);
+    bool ret = do_process_parallel (recs, threads, enl, bca1, bca2);
+    finalize_box_scanner_receivers (recs, ret);
+    return ret;
+  }
+
 private:
   container_type1 m_pp1;
   container_type2 m_pp2;
@@ -809,6 +1249,140 @@ private:
   bool m_report_progress;
   std::string m_progress_desc;
 
+  template <class Rec, class BoxConvertAdaptor1, class BoxConvertAdaptor2>
+  struct parallel_strip
+  {
+    typedef typename BoxConvertAdaptor1::box_type::coord_type coord_type;
+
+    parallel_strip ()
+      : rec (0), strips (0), index (0), enl (0), bc1 (0), bc2 (0), result (true)
+    { }
+
+    void run ()
+    {
+      try {
+        box_scanner_strip_receiver<Rec, BoxConvertAdaptor1, BoxConvertAdaptor2, coord_type> strip_rec (rec, *bc1, *bc2, strips, index);
+        result = scanner.process_with_adaptor (strip_rec, enl, *bc1, *bc2);
+      } catch (tl::Exception &ex) {
+        error = ex.msg ();
+      } catch (std::exception &ex) {
+        error = ex.what ();
+      } catch (...) {
+        error = tl::to_string (tr ("Unspecific error"));
+      }
+    }
+
+    box_scanner2<Obj1, Prop1, Obj2, Prop2> scanner;
+    Rec *rec;
+    const box_scanner_strips<coord_type> *strips;
+    size_t index;
+    coord_type enl;
+    const BoxConvertAdaptor1 *bc1;
+    const BoxConvertAdaptor2 *bc2;
+    bool result;
+    std::string error;
+  };
+
+  template <class Rec, class BoxConvertAdaptor1, class BoxConvertAdaptor2>
+  bool do_process_parallel (const std::vector<Rec *> &recs, unsigned int threads, typename BoxConvertAdaptor1::box_type::coord_type enl, const BoxConvertAdaptor1 &bc1, const BoxConvertAdaptor2 &bc2)
+  {
+    typedef typename BoxConvertAdaptor1::box_type box_type; //  must be same as BoxConvert2::box_type
+    typedef typename box_type::coord_type coord_type;
+
+    tl_assert (! recs.empty ());
+
+    if (recs.size () == 1 || m_pp1.size () + m_pp2.size () <= m_scanner_thr) {
+      return do_process (*recs.front (), enl, bc1, bc2);
+    }
+
+    //  sort out the entries with an empty bbox and form the strips from the left coordinates of the others
+
+    std::vector<coord_type> lefts;
+    lefts.reserve (m_pp1.size () + m_pp2.size ());
+
+    typename container_type1::iterator wi1 = m_pp1.begin ();
+    for (typename container_type1::iterator ri1 = m_pp1.begin (); ri1 != m_pp1.end (); ++ri1) {
+      box_type b = bc1 (*ri1);
+      if (! b.empty ()) {
+        lefts.push_back (b.left ());
+        if (wi1 != ri1) {
+          *wi1 = *ri1;
+        }
+        ++wi1;
+      } else {
+        recs.front ()->finish1 (ri1->first, ri1->second);
+      }
+    }
+
+    if (wi1 != m_pp1.end ()) {
+      m_pp1.erase (wi1, m_pp1.end ());
+    }
+
+    typename container_type2::iterator wi2 = m_pp2.begin ();
+    for (typename container_type2::iterator ri2 = m_pp2.begin (); ri2 != m_pp2.end (); ++ri2) {
+      box_type b = bc2 (*ri2);
+      if (! b.empty ()) {
+        lefts.push_back (b.left ());
+        if (wi2 != ri2) {
+          *wi2 = *ri2;
+        }
+        ++wi2;
+      } else {
+        recs.front ()->finish2 (ri2->first, ri2->second);
+      }
+    }
+
+    if (wi2 != m_pp2.end ()) {
+      m_pp2.erase (wi2, m_pp2.end ());
+    }
+
+    box_scanner_strips<coord_type> strips (lefts, recs.size ());
+    std::vector<coord_type> ().swap (lefts);
+
+    std::vector<parallel_strip<Rec, BoxConvertAdaptor1, BoxConvertAdaptor2> > ps (recs.size ());
+    for (size_t i = 0; i < ps.size (); ++i) {
+      ps [i].rec = recs [i];
+      ps [i].strips = &strips;
+      ps [i].index = i;
+      ps [i].enl = enl;
+      ps [i].bc1 = &bc1;
+      ps [i].bc2 = &bc2;
+      ps [i].scanner.set_fill_factor (m_fill_factor);
+      ps [i].scanner.set_scanner_threshold (m_scanner_thr);
+      ps [i].scanner.set_scanner_threshold1 (m_scanner_thr1);
+    }
+
+    //  an object is present in all strips its enlarged box overlaps with
+
+    for (iterator_type1 i = m_pp1.begin (); i != m_pp1.end (); ++i) {
+      std::pair<size_t, size_t> sr = strips.strip_range (bc1 (*i), enl);
+      for (size_t s = sr.first; s <= sr.second && s < ps.size (); ++s) {
+        ps [s].scanner.insert1 (i->first, i->second);
+      }
+    }
+
+    for (iterator_type2 i = m_pp2.begin (); i != m_pp2.end (); ++i) {
+      std::pair<size_t, size_t> sr = strips.strip_range (bc2 (*i), enl);
+      for (size_t s = sr.first; s <= sr.second && s < ps.size (); ++s) {
+        ps [s].scanner.insert2 (i->first, i->second);
+      }
+    }
+
+    bool ret = run_box_scanner_strips (ps, threads);
+
+    if (ret) {
+      //  every receiver which may have seen interactions with an object receives "finish" for it
+      for (iterator_type1 i = m_pp1.begin (); i != m_pp1.end (); ++i) {
+        strips.finish (recs, bc1 (*i), enl, [i] (Rec *rec) { rec->finish1 (i->first, i->second); });
+      }
+      for (iterator_type2 i = m_pp2.begin (); i != m_pp2.end (); ++i) {
+        strips.finish (recs, bc2 (*i), enl, [i] (Rec *rec) { rec->finish2 (i->first, i->second); });
+      }
+    }
+
+    return ret;
+  }
+
   template <class Rec, class BoxConvertAdaptor1, class BoxConvertAdaptor2>
   bool do_process (Rec &rec, typename BoxConvertAdaptor1::box_type::coord_type enl, const BoxConvertAdaptor1 &bc1 = BoxConvertAdaptor1 (), const BoxConvertAdaptor2 &bc2 = BoxConvertAdaptor2 ())
   {
@@ -29,6 +29,7 @@
 #include "dbLayoutUtils.h"
 #include "dbLayerMapping.h"
 #include "dbCellMapping.h"
+#include "tlHash.h"
 
 #include <limits>
 
@@ -93,7 +94,7 @@ Cell::box_type Cell::ms_empty_box = Cell::box_type ();
 Cell::Cell (cell_index_type ci, db::Layout &l) 
   : db::Object (l.manager ()), 
     m_cell_index (ci), mp_layout (&l), m_instances (this), m_prop_id (0), m_hier_levels (0),
-    m_bbox_needs_update (false), m_locked (false), m_ghost_cell (false),
+    m_bbox_needs_update (false), m_locked (false), m_ghost_cell (false), m_content_pending (false), m_content_loaded (false),
     mp_last (0), mp_next (0)
 {
   m_bbox_with_empty = box_type (box_type::point_type (), box_type::point_type ());
@@ -103,7 +104,7 @@ Cell::Cell (const Cell &d)
   : db::Object (d), 
     gsi::ObjectBase (),
     mp_layout (d.mp_layout), m_instances (this), m_prop_id (d.m_prop_id), m_hier_levels (d.m_hier_levels),
-    mp_last (0), mp_next (0)
+    m_content_pending (false), m_content_loaded (false), mp_last (0), mp_next (0)
 {
   m_cell_index = d.m_cell_index;
   operator= (d);
@@ -119,6 +120,8 @@ Cell::operator= (const Cell &d)
 
     invalidate_hier ();
 
+    d.load_content ();
+
     clear_shapes_no_invalidate ();
     for (shapes_map::const_iterator s = d.m_shapes_map.begin (); s != d.m_shapes_map.end (); ++s) {
       shapes (s->first) = s->second;
@@ -155,13 +158,25 @@ Cell::clone (db::Layout &layout) const
 unsigned int
 Cell::layers () const
 {
-  if (m_shapes_map.empty ()) {
-    return 0;
-  } else {
+  unsigned int n = 0;
+  if (! m_shapes_map.empty ()) {
     shapes_map::const_iterator s = m_shapes_map.end ();
     --s;
-    return s->first + 1;
+    n = s->first + 1;
   }
+
+  //  NOTE: we don't want to load the shapes here as this method is used inside the layout's update
+  if (is_content_pending ()) {
+    box_map pending_bboxes;
+    mp_layout->cell_content_loader ()->cell_bboxes (cell_index (), pending_bboxes);
+    if (! pending_bboxes.empty ()) {
+      box_map::const_iterator b = pending_bboxes.end ();
+      --b;
+      n = std::max (n, b->first + 1);
+    }
+  }
+
+  return n;
 }
 
 bool
@@ -171,6 +186,11 @@ Cell::empty () const
     return false;
   }
 
+  //  pending cells are only created if there are shapes to load
+  if (is_content_pending ()) {
+    return false;
+  }
+
   for (shapes_map::const_iterator s = m_shapes_map.begin (); s != m_shapes_map.end (); ++s) {
     if (! s->second.empty ()) {
       return false;
@@ -184,6 +204,7 @@ void
 Cell::clear (unsigned int index)
 {
   check_locked ();
+  load_content ();
 
   shapes_map::iterator s = m_shapes_map.find(index);
   if (s != m_shapes_map.end() && ! s->second.empty ()) {
@@ -197,6 +218,7 @@ void
 Cell::clear (unsigned int index, unsigned int types)
 {
   check_locked ();
+  load_content ();
 
   shapes_map::iterator s = m_shapes_map.find(index);
   if (s != m_shapes_map.end() && ! s->second.empty ()) {
@@ -209,6 +231,8 @@ Cell::clear (unsigned int index, unsigned int types)
 Cell::shapes_type &
 Cell::shapes (unsigned int index) 
 {
+  load_content ();
+
   shapes_map::iterator s = m_shapes_map.find(index);
   if (s == m_shapes_map.end()) {
     s = m_shapes_map.insert (std::make_pair(index, shapes_type (0, this, mp_layout ? mp_layout->is_editable () : true))).first;
@@ -220,6 +244,8 @@ Cell::shapes (unsigned int index)
 const Cell::shapes_type &
 Cell::shapes (unsigned int index) const
 {
+  load_content ();
+
   shapes_map::const_iterator s = m_shapes_map.find(index);
   if (s != m_shapes_map.end()) {
     return s->second;
@@ -250,6 +276,11 @@ Cell::clear_shapes ()
 {
   check_locked ();
 
+  //  pending shapes need to be present for undo
+  if (manager () && manager ()->transacting ()) {
+    load_content ();
+  }
+
   mp_layout->invalidate_bboxes (std::numeric_limits<unsigned int>::max ());  //  HINT: must come before the change is done!
   clear_shapes_no_invalidate ();
 }
@@ -408,6 +439,21 @@ Cell::update_bbox (unsigned int layers)
    
   }
 
+  //  as long as the shapes are not loaded, take the boxes from the loader
+  if (is_content_pending ()) {
+
+    box_map pending_bboxes;
+    mp_layout->cell_content_loader ()->cell_bboxes (cell_index (), pending_bboxes);
+
+    for (box_map::const_iterator pb = pending_bboxes.begin (); pb != pending_bboxes.end (); ++pb) {
+      if (! pb->second.empty ()) {
+        sbox_all += pb->second;
+        m_bboxes [pb->first] += pb->second;
+      }
+    }
+
+  }
+
   //  combine shapes in all-layer boxes
   m_bbox += sbox_all;
   m_bbox_with_empty += sbox_all;
@@ -542,6 +588,192 @@ Cell::bbox (unsigned int l) const
   }
 }
 
+namespace
+{
+
+/**
+ *  @brief A helper class computing the fingerprint of a single shape
+ *
+ *  The shape is hashed in its canonical form (e.g. a polygon reference like
+ *  a polygon), so the fingerprint does not depend on the storage type.
+ */
+class ShapeFingerprint
+{
+public:
+  ShapeFingerprint ()
+    : m_h (0)
+  { }
+
+  uint64_t value () const
+  {
+    return mix (m_h);
+  }
+
+  void add (uint64_t v)
+  {
+    m_h = mix (m_h + v) + 0x9e3779b97f4a7c15ull;
+  }
+
+  void add (const db::Point &p)
+  {
+    add (uint64_t (uint32_t (p.x ())) | (uint64_t (uint32_t (p.y ())) << 32));
+  }
+
+  void add (const db::Box &b)
+  {
+    add (b.p1 ());
+    add (b.p2 ());
+  }
+
+  void add (const db::Edge &e)
+  {
+    add (e.p1 ());
+    add (e.p2 ());
+  }
+
+  template <class Iter>
+  void add (Iter from, Iter to, size_t n)
+  {
+    add (uint64_t (n));
+    for (Iter i = from; i != to; ++i) {
+      add (*i);
+    }
+  }
+
+  void add (const db::Shape &s)
+  {
+    add (uint64_t (s.prop_id ()));
+
+    if (s.is_polygon () || s.is_simple_polygon ()) {
+
+      add (1);
+      s.polygon (m_polygon);
+      add (m_polygon.begin_hull (), m_polygon.end_hull (), m_polygon.hull ().size ());
+      for (unsigned int i = 0; i < m_polygon.holes (); ++i) {
+        add (m_polygon.begin_hole (i), m_polygon.end_hole (i), m_polygon.hole (i).size ());
+      }
+
+    } else if (s.is_path ()) {
+
+      add (2);
+      s.path (m_path);
+      add (uint64_t (m_path.width ()));
+      add (uint64_t (m_path.bgn_ext ()));
+      add (uint64_t (m_path.end_ext ()));
+      add (uint64_t (m_path.round ()));
+      add (m_path.begin (), m_path.end (), m_path.points ());
+
+    } else if (s.is_box ()) {
+
+      add (3);
+      add (s.box ());
+
+    } else if (s.is_text ()) {
+
+      add (4);
+      s.text (m_text);
+      add (uint64_t (tl::hfunc (std::string (m_text.string ()))));
+      add (uint64_t (m_text.trans ().rot ()));
+      add (db::Point () + m_text.trans ().disp ());
+      add (uint64_t (m_text.size ()));
+      add (uint64_t (m_text.font ()));
+      add (uint64_t (m_text.halign ()));
+      add (uint64_t (m_text.valign ()));
+
+    } else if (s.is_edge ()) {
+
+      add (5);
+      add (s.edge ());
+
+    } else if (s.is_edge_pair ()) {
+
+      add (6);
+      db::EdgePair ep = s.edge_pair ();
+      add (ep.first ());
+      add (ep.second ());
+      add (uint64_t (ep.is_symmetric ()));
+
+    } else if (s.is_point ()) {
+
+      add (7);
+      add (s.point ());
+
+    } else if (s.is_user_object ()) {
+
+      add (8);
+      const db::UserObjectBase *uo = s.user_object ().ptr ();
+      add (uint64_t (uo->class_id ()));
+      add (uo->box ());
+      add (uint64_t (tl::hfunc (uo->to_string ())));
+
+    }
+  }
+
+  void reset ()
+  {
+    m_h = 0;
+  }
+
+private:
+  uint64_t m_h;
+  db::Polygon m_polygon;
+  db::Path m_path;
+  db::Text m_text;
+
+  //  the finalizer of the "splitmix64" generator
+  static uint64_t mix (uint64_t z)
+  {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+};
+
+}
+
+size_t
+Cell::content_fingerprint (unsigned int l) const
+{
+  mp_layout->update ();
+
+  {
+    tl::MutexLocker locker (&mp_layout->lock ());
+    std::map<unsigned int, size_t>::const_iterator f = m_content_fingerprints.find (l);
+    if (f != m_content_fingerprints.end ()) {
+      return f->second;
+    }
+  }
+
+  const shapes_type &s = shapes (l);
+
+  //  The fingerprint is the sum of the shape fingerprints which makes it independent
+  //  of the shape order.
+  uint64_t fp = 0;
+  ShapeFingerprint sfp;
+  for (db::ShapeIterator sh = s.begin (db::ShapeIterator::All); ! sh.at_end (); ++sh) {
+    sfp.reset ();
+    sfp.add (*sh);
+    fp += sfp.value ();
+  }
+
+  //  shapes which are not up to date may still change without notification
+  if (! s.is_bbox_dirty ()) {
+    tl::MutexLocker locker (&mp_layout->lock ());
+    m_content_fingerprints [l] = size_t (fp);
+  }
+
+  return size_t (fp);
+}
+
+void
+Cell::invalidate_content_fingerprint (unsigned int l)
+{
+  if (! m_content_fingerprints.empty ()) {
+    tl::MutexLocker locker (&mp_layout->lock ());
+    m_content_fingerprints.erase (l);
+  }
+}
+
 const Cell::box_type &
 Cell::bbox_no_update (unsigned int l) const
 {
@@ -785,6 +1017,92 @@ Cell::clear_shapes_no_invalidate ()
     s->second.clear ();
   }
   m_bbox_needs_update = true;
+
+  //  pending shapes are not needed any longer
+  m_content_pending.store (false, std::memory_order_release);
+  m_content_loaded = false;
+
+  m_content_fingerprints.clear ();
+}
+
+void
+Cell::set_content_pending ()
+{
+  tl_assert (mp_layout != 0 && mp_layout->cell_content_loader () != 0);
+
+  m_content_pending.store (true, std::memory_order_release);
+  m_content_loaded = false;
+
+  //  the bounding boxes need to be taken from the loader
+  m_bbox_needs_update = true;
+  mp_layout->invalidate_bboxes (std::numeric_limits<unsigned int>::max ());
+}
+
+void
+Cell::do_load_content () const
+{
+  tl::MutexLocker locker (&mp_layout->cell_content_lock ());
+
+  //  another thread may have loaded the shapes meanwhile
+  if (! is_content_pending ()) {
+    return;
+  }
+
+  db::CellContentLoader::shapes_map loaded_shapes;
+  mp_layout->cell_content_loader ()->load_cell_content (*mp_layout, cell_index (), loaded_shapes);
+
+  //  NOTE: the shapes are installed silently - logically, they have been there already.
+  //  Hence there is no undo and no layout update involved. The bounding boxes delivered by the
+  //  loader stay in place until the cell is modified.
+  Cell *self = const_cast<Cell *> (this);
+  for (db::CellContentLoader::shapes_map::iterator s = loaded_shapes.begin (); s != loaded_shapes.end (); ++s) {
+
+    if (s->second.empty ()) {
+      continue;
+    }
+
+    //  sort the shapes, so they are ready for region queries
+    s->second.update ();
+
+    shapes_map::iterator t = self->m_shapes_map.find (s->first);
+    if (t == self->m_shapes_map.end ()) {
+      t = self->m_shapes_map.insert (std::make_pair (s->first, shapes_type (0, self, mp_layout->is_editable ()))).first;
+      t->second.manager (manager ());
+    }
+    t->second.take (s->second);
+
+  }
+
+  m_content_loaded = true;
+  m_content_pending.store (false, std::memory_order_release);
+}
+
+void
+Cell::release_content () const
+{
+  if (! mp_layout || ! mp_layout->cell_content_loader () || ! mp_layout->cell_content_loader ()->is_transient ()) {
+    return;
+  }
+
+  tl::MutexLocker locker (&mp_layout->cell_content_lock ());
+
+  if (is_content_pending () || ! m_content_loaded) {
+    return;
+  }
+
+  //  NOTE: like loading, releasing happens silently - the shapes are moved into a temporary
+  //  container which is not attached to the cell, so neither undo nor the layout are involved.
+  //  The bounding boxes stay valid as the content will be the same after reloading.
+  Cell *self = const_cast<Cell *> (this);
+  for (shapes_map::iterator s = self->m_shapes_map.begin (); s != self->m_shapes_map.end (); ++s) {
+    db::Shapes dropped (s->second.is_editable ());
+    dropped.take (s->second);
+  }
+
+  mp_layout->cell_content_loader ()->release_cell_content (cell_index ());
+
+  m_content_loaded = false;
+  m_content_pending.store (true, std::memory_order_release);
 }
 
 unsigned int 
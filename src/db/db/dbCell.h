@@ -42,6 +42,7 @@
 
 #include <map>
 #include <set>
+#include <atomic>
 
 namespace db
 {
@@ -334,6 +335,7 @@ public:
   template <class Trans>
   void transform (const Trans &t)
   {
+    load_content ();
     m_instances.transform (t);
     for (typename shapes_map::iterator s = m_shapes_map.begin (); s != m_shapes_map.end (); ++s) {
       if (! s->second.empty ()) {
@@ -359,6 +361,7 @@ public:
   template <class Trans>
   void transform_into (const Trans &t)
   {
+    load_content ();
     m_instances.transform_into (t);
     for (typename shapes_map::iterator s = m_shapes_map.begin (); s != m_shapes_map.end (); ++s) {
       if (! s->second.empty ()) {
@@ -565,6 +568,26 @@ public:
    */
   const box_type &bbox (unsigned int l) const;
 
+  /**
+   *  @brief Gets a fingerprint of the shapes on the given layer
+   *
+   *  The fingerprint is a hash value computed from the shapes and their properties IDs.
+   *  It does not depend on the order of the shapes or on the way they are stored (e.g.
+   *  as references or arrays). Different fingerprints indicate different shapes. Identical
+   *  fingerprints indicate identical shapes with a very high probability.
+   *
+   *  The fingerprint is cached. The cache is invalidated when the shapes on this layer
+   *  are changed.
+   */
+  size_t content_fingerprint (unsigned int l) const;
+
+  /**
+   *  @brief Invalidates the cached fingerprint for the given layer
+   *
+   *  This method is called by the shapes container when the shapes are changed.
+   */
+  void invalidate_content_fingerprint (unsigned int l);
+
   /**
    *  @brief Region query for the instances in "overlapping" mode
    *
@@ -957,6 +980,51 @@ public:
    */
   void set_ghost_cell (bool g);
 
+  /**
+   *  @brief Returns a value indicating whether the shapes of the cell are still to be loaded
+   *
+   *  Readers operating in lazy loading mode create the cells with their instances, but
+   *  without shapes. The shapes are delivered by the layout's cell content loader
+   *  (see Layout::set_cell_content_loader) when they are accessed for the first time.
+   *  Until then, the per-layer bounding boxes are taken from the loader.
+   */
+  bool is_content_pending () const
+  {
+    return m_content_pending.load (std::memory_order_acquire);
+  }
+
+  /**
+   *  @brief Marks the shapes of the cell as pending
+   *
+   *  This method is intended to be used by readers. The layout needs to have a cell
+   *  content loader which is able to deliver the shapes of this cell.
+   */
+  void set_content_pending ();
+
+  /**
+   *  @brief Loads the shapes of the cell if they are still pending
+   *
+   *  This method is called implicitly when the shapes are accessed.
+   *  It is safe to call this method from multiple threads.
+   */
+  void load_content () const
+  {
+    if (is_content_pending ()) {
+      do_load_content ();
+    }
+  }
+
+  /**
+   *  @brief Drops the shapes of the cell if they have been delivered by a transient cell content loader
+   *
+   *  If the layout's cell content loader is in transient mode (see CellContentLoader::set_transient),
+   *  this method discards the shapes delivered by the loader and marks the cell as pending again.
+   *  The shapes are loaded again when they are accessed next time. This way, the memory
+   *  footprint can be kept at the size of one cell when traversing a layout cell by cell.
+   *  In all other cases, this method does nothing.
+   */
+  void release_content () const;
+
   /**
    *  @brief Gets a value indicating whether the cell is locked
    *
@@ -1174,6 +1242,13 @@ private:
   bool m_locked : 1;
   bool m_ghost_cell : 1;
 
+  //  lazy loading (see is_content_pending)
+  mutable std::atomic<bool> m_content_pending;
+  mutable bool m_content_loaded;
+
+  //  cached content fingerprints (see content_fingerprint)
+  mutable std::map<unsigned int, size_t> m_content_fingerprints;
+
   static box_type ms_empty_box;
 
   //  linked list, used by Layout
@@ -1182,6 +1257,9 @@ private:
   //  clear the shapes without telling the layout
   void clear_shapes_no_invalidate ();
 
+  //  fetches the pending shapes from the layout's cell content loader
+  void do_load_content () const;
+
   //  helper function for computing the number of hierarchy levels
   //  must be called bottom-up
   unsigned int count_hier_levels () const;
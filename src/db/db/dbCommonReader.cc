@@ -36,7 +36,7 @@ namespace db
 static const size_t null_id = std::numeric_limits<size_t>::max ();
 
 CommonReaderBase::CommonReaderBase ()
-  : m_cc_resolution (AddToCell), m_create_layers (false)
+  : m_cc_resolution (AddToCell), m_create_layers (false), m_lazy_loading (false)
 {
   //  .. nothing yet ..
 }
@@ -648,6 +648,7 @@ CommonReader::init (const LoadLayoutOptions &options)
   set_conflict_resolution_mode (common_options.cell_conflict_resolution);
   set_create_layers (common_options.create_other_layers);
   set_layer_map (common_options.layer_map);
+  set_lazy_loading (common_options.lazy_loading);
 }
 
 // ---------------------------------------------------------------
@@ -707,7 +708,8 @@ public:
       tl::make_member (&db::CommonReaderOptions::create_other_layers, "create-other-layers") +
       tl::make_member (&db::CommonReaderOptions::layer_map, "layer-map") +
       tl::make_member (&db::CommonReaderOptions::enable_properties, "enable-properties") +
-      tl::make_member (&db::CommonReaderOptions::enable_text_objects, "enable-text-objects")
+      tl::make_member (&db::CommonReaderOptions::enable_text_objects, "enable-text-objects") +
+      tl::make_member (&db::CommonReaderOptions::lazy_loading, "lazy-loading")
     );
   }
 };
@@ -56,7 +56,8 @@ public:
     : create_other_layers (true),
       enable_text_objects (true),
       enable_properties (true),
-      cell_conflict_resolution (CellConflictResolution::AddToCell)
+      cell_conflict_resolution (CellConflictResolution::AddToCell),
+      lazy_loading (false)
   {
     //  .. nothing yet ..
   }
@@ -111,6 +112,16 @@ public:
    */
   CellConflictResolution cell_conflict_resolution;
 
+  /**
+   *  @brief A flag indicating whether to load the shapes of the cells on demand
+   *
+   *  If this flag is set to true, readers supporting this mode (OASIS and LStream)
+   *  will create the cells with their instances, but load the shapes only when
+   *  they are accessed for the first time. Readers which do not support this mode
+   *  will ignore this flag.
+   */
+  bool lazy_loading;
+
   /**
    *  @brief Implementation of FormatSpecificReaderOptions
    */
@@ -233,6 +244,22 @@ public:
     m_layer_map = lm;
   }
 
+  /**
+   *  @brief Sets a value indicating whether lazy loading is requested
+   */
+  void set_lazy_loading (bool f)
+  {
+    m_lazy_loading = f;
+  }
+
+  /**
+   *  @brief Gets a value indicating whether lazy loading is requested
+   */
+  bool lazy_loading () const
+  {
+    return m_lazy_loading;
+  }
+
 protected:
   friend class CommonReaderLayerMapping;
 
@@ -278,6 +305,14 @@ protected:
    */
   std::pair <bool, unsigned int> open_dl (db::Layout &layout, const LDPair &dl);
 
+  /**
+   *  @brief Gets the layers entered so far by layer/datatype
+   */
+  std::map<db::LDPair, std::pair <bool, unsigned int> > &layer_cache ()
+  {
+    return m_layer_cache;
+  }
+
 private:
   std::map<size_t, std::pair<std::string, db::cell_index_type> > m_id_map;
   std::map<std::string, std::pair<size_t, db::cell_index_type> > m_name_map;
@@ -285,6 +320,7 @@ private:
   std::map<size_t, std::string> m_name_for_id;
   CellConflictResolution m_cc_resolution;
   bool m_create_layers;
+  bool m_lazy_loading;
   db::LayerMap m_layer_map;
   db::LayerMap m_layer_map_out;
   tl::interval_map <db::ld_type, tl::interval_map <db::ld_type, std::string> > m_layer_names;
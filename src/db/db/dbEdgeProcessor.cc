@@ -27,11 +27,15 @@
 #include "dbLayout.h"
 #include "tlTimer.h"
 #include "tlProgress.h"
+#include "tlThreadedWorkers.h"
 #include "gsi.h"
 
 #include <vector>
 #include <deque>
+#include <map>
 #include <memory>
+#include <algorithm>
+#include <limits>
 
 #if 0
 #define DEBUG_MERGEOP
@@ -1020,8 +1024,10 @@ BooleanOp2::compare_ns () const
 // -------------------------------------------------------------------------------
 //  EdgeProcessor implementation
 
+size_t EdgeProcessor::ms_min_edges_per_band = 20000;
+
 EdgeProcessor::EdgeProcessor (bool report_progress, const std::string &progress_desc)
-  : m_report_progress (report_progress), m_progress_desc (progress_desc), m_base_verbosity (30)
+  : m_report_progress (report_progress), m_progress_desc (progress_desc), m_base_verbosity (30), m_threads (0), m_prepared (false), m_fast_scan (true), m_manhattan_mode (true)
 {
   mp_work_edges = new std::vector <WorkEdge> ();
   mp_cpvector = new std::vector <CutPoints> ();
@@ -1058,6 +1064,30 @@ EdgeProcessor::set_base_verbosity (int bv)
   m_base_verbosity = bv;
 }
 
+void
+EdgeProcessor::set_threads (int n)
+{
+  m_threads = n;
+}
+
+void
+EdgeProcessor::set_fast_scan (bool f)
+{
+  m_fast_scan = f;
+}
+
+void
+EdgeProcessor::set_manhattan_mode (bool f)
+{
+  m_manhattan_mode = f;
+}
+
+void
+EdgeProcessor::set_min_edges_per_band_global (size_t n)
+{
+  ms_min_edges_per_band = n;
+}
+
 void 
 EdgeProcessor::reserve (size_t n)
 {
@@ -1075,6 +1105,7 @@ EdgeProcessor::insert (const db::Edge &e, property_type p)
 {
   if (e.p1 () != e.p2 ()) {
     mp_work_edges->push_back (WorkEdge (e, p));
+    m_prepared = false;
   }
 }
 
@@ -1083,6 +1114,7 @@ EdgeProcessor::clear ()
 {
   mp_work_edges->clear ();
   mp_cpvector->clear ();
+  m_prepared = false;
 }
 
 static void
@@ -1249,6 +1281,183 @@ get_intersections_per_band_90 (std::vector <CutPoints> &cutpoints, std::vector <
   }
 }
 
+/**
+ *  @brief A compare function for edge indexes
+ *
+ *  Sorts by lower x, then lower y or by lower y, then lower x.
+ */
+struct EdgeIndexCompare
+{
+  EdgeIndexCompare (const std::vector <WorkEdge> &edges, bool x_first)
+    : mp_edges (&edges), m_x_first (x_first)
+  { }
+
+  bool operator() (size_t a, size_t b) const
+  {
+    const WorkEdge &ea = (*mp_edges) [a];
+    const WorkEdge &eb = (*mp_edges) [b];
+    db::Coord xa = edge_xmin (ea), xb = edge_xmin (eb);
+    db::Coord ya = edge_ymin (ea), yb = edge_ymin (eb);
+    if (m_x_first) {
+      return xa < xb || (xa == xb && ya < yb);
+    } else {
+      return ya < yb || (ya == yb && xa < xb);
+    }
+  }
+
+private:
+  const std::vector <WorkEdge> *mp_edges;
+  bool m_x_first;
+};
+
+/**
+ *  @brief Computes the cut points for a set of Manhattan edges in a single sweep
+ *
+ *  This is the specialization of the band-wise intersection search for the case where all edges
+ *  are horizontal or vertical. It produces the same cut points than the band-wise
+ *  "get_intersections_per_band_90" scheme, but entirely with integer arithmetics: vertical/horizontal
+ *  crossings are found with a sweep over y, keeping the active vertical edges sorted by x, so the
+ *  effort is proportional to the number of edges plus the number of crossings. Coincident edges
+ *  are found by grouping the edges by their x or y coordinate.
+ */
+static void
+get_intersections_manhattan (std::vector <CutPoints> &cutpoints, std::vector <WorkEdge> &edges, bool with_h)
+{
+  std::vector<size_t> vert, horz;
+  vert.reserve (edges.size ());
+  horz.reserve (edges.size ());
+
+  for (size_t i = 0; i < edges.size (); ++i) {
+    if (edges [i].dx () == 0) {
+      vert.push_back (i);
+    } else {
+      horz.push_back (i);
+    }
+  }
+
+  //  vertical/horizontal crossings: sweep upwards, maintaining the vertical edges which may be hit
+  //  by a horizontal one at the current y in a map sorted by x. Edges ending below the current y
+  //  are removed when they are encountered.
+
+  std::sort (vert.begin (), vert.end (), EdgeIndexCompare (edges, false));
+  std::sort (horz.begin (), horz.end (), EdgeIndexCompare (edges, false));
+
+  std::multimap<db::Coord, size_t> active;
+
+  std::vector<size_t>::const_iterator v = vert.begin ();
+  for (std::vector<size_t>::const_iterator h = horz.begin (); h != horz.end (); ++h) {
+
+    WorkEdge &eh = edges [*h];
+    db::Coord y = eh.p1 ().y ();
+
+    while (v != vert.end () && edge_ymin (edges [*v]) <= y) {
+      active.insert (std::make_pair (edges [*v].p1 ().x (), *v));
+      ++v;
+    }
+
+    std::multimap<db::Coord, size_t>::iterator a = active.lower_bound (edge_xmin (eh));
+    while (a != active.end () && a->first <= edge_xmax (eh)) {
+
+      WorkEdge &ev = edges [a->second];
+      if (edge_ymax (ev) < y) {
+        active.erase (a++);
+        continue;
+      }
+
+      if (ev.p1 () != eh.p1 () && ev.p2 () != eh.p1 () && ev.p1 () != eh.p2 () && ev.p2 () != eh.p2 ()) {
+        db::Point cp (a->first, y);
+        ev.make_cutpoints (cutpoints)->add (cp, &cutpoints, true);
+        if (with_h) {
+          eh.make_cutpoints (cutpoints)->add (cp, &cutpoints, true);
+        }
+      }
+
+      ++a;
+
+    }
+
+  }
+
+  //  coincident vertical edges: produce the ends of the edges involved as cut points
+
+  std::sort (vert.begin (), vert.end (), EdgeIndexCompare (edges, true));
+
+  std::vector<size_t> overlapping;
+  for (std::vector<size_t>::const_iterator i = vert.begin (); i != vert.end (); ++i) {
+
+    WorkEdge &e = edges [*i];
+    db::Coord ymin = edge_ymin (e), ymax = edge_ymax (e);
+
+    if (! overlapping.empty () && edges [overlapping.front ()].p1 ().x () != e.p1 ().x ()) {
+      overlapping.clear ();
+    }
+
+    std::vector<size_t>::iterator w = overlapping.begin ();
+    for (std::vector<size_t>::iterator o = overlapping.begin (); o != overlapping.end (); ++o) {
+
+      WorkEdge &eo = edges [*o];
+      if (edge_ymax (eo) <= ymin) {
+        continue;
+      }
+
+      if (eo.p1 ().y () > ymin && eo.p1 ().y () < ymax) {
+        e.make_cutpoints (cutpoints)->add (eo.p1 (), &cutpoints, true);
+      }
+      if (eo.p2 ().y () > ymin && eo.p2 ().y () < ymax) {
+        e.make_cutpoints (cutpoints)->add (eo.p2 (), &cutpoints, true);
+      }
+      if (e.p1 ().y () > edge_ymin (eo) && e.p1 ().y () < edge_ymax (eo)) {
+        eo.make_cutpoints (cutpoints)->add (e.p1 (), &cutpoints, true);
+      }
+      if (e.p2 ().y () > edge_ymin (eo) && e.p2 ().y () < edge_ymax (eo)) {
+        eo.make_cutpoints (cutpoints)->add (e.p2 (), &cutpoints, true);
+      }
+
+      *w++ = *o;
+
+    }
+
+    overlapping.erase (w, overlapping.end ());
+    overlapping.push_back (*i);
+
+  }
+
+  //  coincident horizontal edges: these are only of interest if horizontal edges are selected
+
+  if (with_h) {
+
+    overlapping.clear ();
+    for (std::vector<size_t>::const_iterator i = horz.begin (); i != horz.end (); ++i) {
+
+      WorkEdge &e = edges [*i];
+
+      if (! overlapping.empty () && edges [overlapping.front ()].p1 ().y () != e.p1 ().y ()) {
+        overlapping.clear ();
+      }
+
+      std::vector<size_t>::iterator w = overlapping.begin ();
+      for (std::vector<size_t>::iterator o = overlapping.begin (); o != overlapping.end (); ++o) {
+
+        WorkEdge &eo = edges [*o];
+        if (edge_xmax (eo) <= edge_xmin (e)) {
+          continue;
+        }
+
+        add_hparallel_cutpoints (eo, e, db::Box::world (), cutpoints);
+        add_hparallel_cutpoints (e, eo, db::Box::world (), cutpoints);
+
+        *w++ = *o;
+
+      }
+
+      overlapping.erase (w, overlapping.end ());
+      overlapping.push_back (*i);
+
+    }
+
+  }
+}
+
 /**
  *  @brief Computes the x value of an edge at the given y value
  *
@@ -1338,14 +1547,208 @@ public:
   double m_y1, m_y2;
 };
 
+/**
+ *  @brief The x bounds of the edges of a band in structure-of-arrays layout
+ *
+ *  The intersection scan needs the left and right bounds of the edges in the band's
+ *  y interval many times: for sorting, for forming the cells and for dropping edges
+ *  from the cells. This object computes these bounds once per band. The coordinates
+ *  are first extracted into separate arrays, so the evaluation loop is free of
+ *  indirections and can be vectorized by the compiler.
+ *
+ *  In addition, a wider bound (one unit in each direction) is provided which is used
+ *  to skip edge pairs that cannot interact.
+ */
+class BandXRanges
+{
+public:
+  BandXRanges ()
+  { }
+
+  /**
+   *  @brief Computes the bounds for the edges [from, to) in the interval [y1, y2]
+   */
+  void compute (std::vector<WorkEdge>::const_iterator from, std::vector<WorkEdge>::const_iterator to, double y1, double y2)
+  {
+    size_t n = std::distance (from, to);
+    if (n == 0) {
+      return;
+    }
+
+    m_xl.resize (n);
+    m_yl.resize (n);
+    m_xh.resize (n);
+    m_yh.resize (n);
+
+    //  extract the coordinates with the edges normalized to dy >= 0
+    size_t i = 0;
+    for (std::vector<WorkEdge>::const_iterator e = from; e != to; ++e, ++i) {
+      bool swap = e->p1 ().y () > e->p2 ().y ();
+      const db::Point &pl = swap ? e->p2 () : e->p1 ();
+      const db::Point &ph = swap ? e->p1 () : e->p2 ();
+      m_xl [i] = pl.x ();
+      m_yl [i] = pl.y ();
+      m_xh [i] = ph.x ();
+      m_yh [i] = ph.y ();
+    }
+
+    m_xmin.resize (n);
+    m_xmax.resize (n);
+    m_fxmin.resize (n);
+    m_fxmax.resize (n);
+
+    compute_bounds (n, y1, y2, &m_xmin.front (), &m_xmax.front ());
+    compute_bounds (n, y1 - 1.0, y2 + 1.0, &m_fxmin.front (), &m_fxmax.front ());
+
+    for (i = 0; i < n; ++i) {
+      m_fxmin [i] -= 1.0;
+      m_fxmax [i] += 1.0;
+    }
+  }
+
+  /**
+   *  @brief Sorts the edges by their left bound (and the edges themselves for equal bounds)
+   *
+   *  This is the same order as established by edge_xmin_at_yinterval_double_compare.
+   *  The bounds are permuted along with the edges.
+   */
+  void sort (std::vector<WorkEdge>::iterator from, std::vector<WorkEdge>::iterator to)
+  {
+    size_t n = std::distance (from, to);
+
+    m_perm.resize (n);
+    for (size_t i = 0; i < n; ++i) {
+      m_perm [i] = i;
+    }
+
+    std::sort (m_perm.begin (), m_perm.end (), PermCompare (from, m_xmin));
+
+    m_edges.assign (from, to);
+    m_tmp.resize (n);
+
+    for (size_t i = 0; i < n; ++i) {
+      from [i] = m_edges [m_perm [i]];
+    }
+
+    permute (m_xmin);
+    permute (m_xmax);
+    permute (m_fxmin);
+    permute (m_fxmax);
+  }
+
+  /**
+   *  @brief Swaps the bounds of edges i and j
+   */
+  void swap (size_t i, size_t j)
+  {
+    std::swap (m_xmin [i], m_xmin [j]);
+    std::swap (m_xmax [i], m_xmax [j]);
+    std::swap (m_fxmin [i], m_fxmin [j]);
+    std::swap (m_fxmax [i], m_fxmax [j]);
+  }
+
+  /**
+   *  @brief Gets the left bound of edge i
+   */
+  db::Coord xmin (size_t i) const
+  {
+    return db::Coord (m_xmin [i]);
+  }
+
+  /**
+   *  @brief Gets the right bound of edge i
+   */
+  db::Coord xmax (size_t i) const
+  {
+    return db::Coord (m_xmax [i]);
+  }
+
+  /**
+   *  @brief Returns false, if edges i and j cannot interact
+   */
+  bool may_interact (size_t i, size_t j) const
+  {
+    return m_fxmin [i] <= m_fxmax [j] && m_fxmin [j] <= m_fxmax [i];
+  }
+
+private:
+  std::vector<double> m_xl, m_yl, m_xh, m_yh;
+  std::vector<double> m_xmin, m_xmax, m_fxmin, m_fxmax;
+  std::vector<size_t> m_perm;
+  std::vector<double> m_tmp;
+  std::vector<WorkEdge> m_edges;
+
+  struct PermCompare
+  {
+    PermCompare (std::vector<WorkEdge>::const_iterator edges, const std::vector<double> &xmin)
+      : mp_edges (edges), mp_xmin (&xmin)
+    { }
+
+    bool operator() (size_t a, size_t b) const
+    {
+      double xa = (*mp_xmin) [a], xb = (*mp_xmin) [b];
+      if (xa != xb) {
+        return xa < xb;
+      } else {
+        return mp_edges [a] < mp_edges [b];
+      }
+    }
+
+    std::vector<WorkEdge>::const_iterator mp_edges;
+    const std::vector<double> *mp_xmin;
+  };
+
+  void permute (std::vector<double> &v)
+  {
+    for (size_t i = 0; i < m_perm.size (); ++i) {
+      m_tmp [i] = v [m_perm [i]];
+    }
+    v.swap (m_tmp);
+  }
+
+  /**
+   *  @brief Computes the left and right bounds for the interval [y1, y2]
+   *
+   *  NOTE: this loop must deliver exactly the same values as edge_xmin_at_yinterval_double
+   *  and edge_xmax_at_yinterval_double. Hence the arithmetics follows edge_xaty_double.
+   */
+  void compute_bounds (size_t n, double y1, double y2, double *xmin, double *xmax) const
+  {
+    const double *xl = &m_xl.front (), *yl = &m_yl.front (), *xh = &m_xh.front (), *yh = &m_yh.front ();
+
+    for (size_t i = 0; i < n; ++i) {
+
+      double dx = xh [i] - xl [i];
+      double dy = yh [i] - yl [i];
+
+      //  for edges rising to the right, the left bound is at the bottom of the interval
+      double ya = dx > 0.0 ? y1 : y2;
+      double yb = dx > 0.0 ? y2 : y1;
+
+      double xa = ya <= yl [i] ? xl [i] : (ya >= yh [i] ? xh [i] : xl [i] + dx * (ya - yl [i]) / dy);
+      double xb = yb <= yl [i] ? xl [i] : (yb >= yh [i] ? xh [i] : xl [i] + dx * (yb - yl [i]) / dy);
+
+      bool horizontal = (dy == 0.0);
+      xmin [i] = horizontal ? std::min (xl [i], xh [i]) : floor (xa);
+      xmax [i] = horizontal ? std::max (xl [i], xh [i]) : ceil (xb);
+
+    }
+  }
+};
+
 static void 
-get_intersections_per_band_any (std::vector <CutPoints> &cutpoints, std::vector <WorkEdge>::iterator current, std::vector <WorkEdge>::iterator future, db::Coord y, db::Coord yy, bool with_h)
+get_intersections_per_band_any (std::vector <CutPoints> &cutpoints, std::vector <WorkEdge>::iterator current, std::vector <WorkEdge>::iterator future, db::Coord y, db::Coord yy, bool with_h, BandXRanges *ranges)
 {
   double dy = y - 0.5;
   double dyy = yy + 0.5;
   std::vector <std::pair<const WorkEdge *, WorkEdge *> > p1_weak;   // holds weak interactions of edge endpoints with other edges
 
-  std::sort (current, future, edge_xmin_at_yinterval_double_compare<db::Coord> (dy, dyy));
+  if (ranges) {
+    ranges->compute (current, future, dy, dyy);
+    ranges->sort (current, future);
+  } else {
+    std::sort (current, future, edge_xmin_at_yinterval_double_compare<db::Coord> (dy, dyy));
+  }
 
 #ifdef DEBUG_EDGE_PROCESSOR
   printf ("y=%d..%d\n", y, yy);
@@ -1355,7 +1758,7 @@ get_intersections_per_band_any (std::vector <CutPoints> &cutpoints, std::vector
   } 
   printf ("\n");
 #endif
-  db::Coord x = edge_xmin_at_yinterval_double (*current, dy, dyy);
+  db::Coord x = ranges ? ranges->xmin (0) : edge_xmin_at_yinterval_double (*current, dy, dyy);
 
   std::vector <WorkEdge>::iterator f = current;
   for (std::vector <WorkEdge>::iterator c = current; c != future; ) {
@@ -1367,12 +1770,12 @@ get_intersections_per_band_any (std::vector <CutPoints> &cutpoints, std::vector
     //  (this is an empirical performance improvement factor)
     do {
 
-      while (f != future && edge_xmin_at_yinterval_double (*f, dy, dyy) <= xx) {
+      while (f != future && (ranges ? ranges->xmin (f - current) : edge_xmin_at_yinterval_double (*f, dy, dyy)) <= xx) {
         ++f;
       }
 
       if (f != future) {
-        xx = edge_xmin_at_yinterval_double (*f, dy, dyy);
+        xx = ranges ? ranges->xmin (f - current) : edge_xmin_at_yinterval_double (*f, dy, dyy);
       } else {
         xx = std::numeric_limits <db::Coord>::max ();
       }
@@ -1409,6 +1812,11 @@ get_intersections_per_band_any (std::vector <CutPoints> &cutpoints, std::vector
             continue;
           }
 
+          //  skip pairs which are too far apart to interact
+          if (ranges && ! ranges->may_interact (c1 - current, c2 - current)) {
+            continue;
+          }
+
           if (c2->dy () == 0) {
 
             if ((with_h || c1->dy () != 0) && c1 < c2) {
@@ -1569,9 +1977,12 @@ get_intersections_per_band_any (std::vector <CutPoints> &cutpoints, std::vector
 
     x = xx;
     for (std::vector <WorkEdge>::iterator cc = c; cc != f; ++cc) {
-      if (edge_xmax (*cc) < x || edge_xmax_at_yinterval_double (*cc, dy, dyy) < x) {
+      if (ranges ? ranges->xmax (cc - current) < x : (edge_xmax (*cc) < x || edge_xmax_at_yinterval_double (*cc, dy, dyy) < x)) {
         if (c != cc) {
           std::swap (*cc, *c);
+          if (ranges) {
+            ranges->swap (cc - current, c - current);
+          }
         }
         ++c;
       }
@@ -1583,6 +1994,10 @@ get_intersections_per_band_any (std::vector <CutPoints> &cutpoints, std::vector
 void 
 EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
 {
+  if (m_threads > 0 && process_in_bands (es, op)) {
+    return;
+  }
+
   std::vector<std::pair<db::EdgeSink *, db::EdgeEvaluatorBase *> > procs;
   procs.push_back (std::make_pair (&es, &op));
   process (procs);
@@ -2158,6 +2573,324 @@ private:
 
 }
 
+// -------------------------------------------------------------------------------
+//  Band-parallel processing
+
+namespace
+{
+
+/**
+ *  @brief The data of one horizontal band in band-parallel mode
+ */
+struct EdgeProcessorBand
+{
+  EdgeProcessorBand ()
+    : resolve_holes (false), min_coherence (false), open_contours (false), compress (true), base_verbosity (30)
+  { }
+
+  std::vector<std::pair<db::Edge, EdgeProcessor::property_type> > edges;
+  std::vector<db::Polygon> polygons;
+  std::unique_ptr<EdgeEvaluatorBase> op;
+  bool resolve_holes, min_coherence, open_contours, compress;
+  int base_verbosity;
+  std::string error;
+};
+
+/**
+ *  @brief Sets up a polygon generator with the configuration of the original one
+ */
+static void
+configure_polygon_generator (db::PolygonGenerator &pg, bool open_contours, bool compress)
+{
+  pg.open_contours (open_contours);
+  pg.enable_compression (compress);
+}
+
+class EdgeProcessorBandTask
+  : public tl::Task
+{
+public:
+  EdgeProcessorBandTask (EdgeProcessorBand *band)
+    : mp_band (band)
+  { }
+
+  void perform ()
+  {
+    try {
+
+      db::EdgeProcessor ep;
+      ep.set_base_verbosity (mp_band->base_verbosity);
+      ep.reserve (mp_band->edges.size ());
+      for (std::vector<std::pair<db::Edge, EdgeProcessor::property_type> >::const_iterator e = mp_band->edges.begin (); e != mp_band->edges.end (); ++e) {
+        ep.insert (e->first, e->second);
+      }
+
+      //  release memory early
+      std::vector<std::pair<db::Edge, EdgeProcessor::property_type> > ().swap (mp_band->edges);
+
+      db::PolygonContainer pc (mp_band->polygons);
+      db::PolygonGenerator pg (pc, mp_band->resolve_holes, mp_band->min_coherence);
+      configure_polygon_generator (pg, mp_band->open_contours, mp_band->compress);
+      ep.process (pg, *mp_band->op);
+
+    } catch (tl::Exception &ex) {
+      mp_band->error = ex.msg ();
+    } catch (std::exception &ex) {
+      mp_band->error = ex.what ();
+    } catch (...) {
+      mp_band->error = tl::to_string (tr ("Unspecific error"));
+    }
+  }
+
+private:
+  EdgeProcessorBand *mp_band;
+};
+
+class EdgeProcessorBandWorker
+  : public tl::Worker
+{
+public:
+  EdgeProcessorBandWorker ()
+    : tl::Worker ()
+  { }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<EdgeProcessorBandTask *> (task)->perform ();
+  }
+};
+
+/**
+ *  @brief A polygon sink forwarding the polygons only
+ *
+ *  The seam merge step uses this receiver to deliver polygons into the original
+ *  sink which has been started already.
+ */
+class ForwardingPolygonSink
+  : public db::PolygonSink
+{
+public:
+  ForwardingPolygonSink (db::PolygonSink *target)
+    : mp_target (target)
+  { }
+
+  virtual void put (const db::Polygon &polygon)
+  {
+    mp_target->put (polygon);
+  }
+
+private:
+  db::PolygonSink *mp_target;
+};
+
+/**
+ *  @brief Determines the band boundaries ("seams")
+ *
+ *  The seams are placed at quantiles of the edge distribution in y direction.
+ *  A seam must not cut a diagonal edge, so clipping the edges at the seams
+ *  only splits vertical edges and does not introduce rounding effects.
+ */
+static std::vector<db::Coord>
+band_seams (const std::vector<WorkEdge> &edges, size_t nbands)
+{
+  std::vector<db::Coord> seams;
+
+  std::vector<db::Coord> ys;
+  ys.reserve (edges.size ());
+
+  std::vector<std::pair<db::Coord, db::Coord> > blocked;
+
+  db::Coord ymax = std::numeric_limits<db::Coord>::min ();
+
+  for (std::vector<WorkEdge>::const_iterator e = edges.begin (); e != edges.end (); ++e) {
+    if (e->dy () != 0) {
+      ys.push_back (edge_ymin (*e));
+      ymax = std::max (ymax, edge_ymax (*e));
+      if (e->dx () != 0) {
+        blocked.push_back (std::make_pair (edge_ymin (*e), edge_ymax (*e)));
+      }
+    }
+  }
+
+  if (ys.empty ()) {
+    return seams;
+  }
+
+  //  join the y ranges of the diagonal edges into disjoint open intervals
+  std::sort (blocked.begin (), blocked.end ());
+  size_t nb = 0;
+  for (std::vector<std::pair<db::Coord, db::Coord> >::const_iterator b = blocked.begin (); b != blocked.end (); ++b) {
+    if (nb > 0 && b->first < blocked [nb - 1].second) {
+      blocked [nb - 1].second = std::max (blocked [nb - 1].second, b->second);
+    } else {
+      blocked [nb++] = *b;
+    }
+  }
+  blocked.erase (blocked.begin () + nb, blocked.end ());
+
+  std::sort (ys.begin (), ys.end ());
+  db::Coord ymin = ys.front ();
+
+  for (size_t i = 1; i < nbands; ++i) {
+
+    db::Coord y = ys [(ys.size () * i) / nbands];
+
+    //  move the seam out of diagonal edges: the blocked intervals are sorted by their upper bound too
+    std::vector<std::pair<db::Coord, db::Coord> >::const_iterator b = std::upper_bound (blocked.begin (), blocked.end (), std::make_pair (y, std::numeric_limits<db::Coord>::max ()));
+    if (b != blocked.begin () && (b - 1)->second > y) {
+      --b;
+    }
+    if (b != blocked.end () && b->first < y && b->second > y) {
+      y = (y - b->first <= b->second - y) ? b->first : b->second;
+    }
+
+    if (y > ymin && y < ymax && (seams.empty () || y > seams.back ())) {
+      seams.push_back (y);
+    }
+
+  }
+
+  return seams;
+}
+
+}
+
+bool
+EdgeProcessor::process_in_bands (db::EdgeSink &es, EdgeEvaluatorBase &op)
+{
+  size_t nbands = std::min (size_t (m_threads) * 4, mp_work_edges->size () / std::max (ms_min_edges_per_band, size_t (1)));
+  if (nbands < 2 || op.selects_edges ()) {
+    return false;
+  }
+
+  db::PolygonGenerator *pg = dynamic_cast<db::PolygonGenerator *> (&es);
+  if (! pg || ! pg->polygon_sink ()) {
+    return false;
+  }
+
+  std::unique_ptr<EdgeEvaluatorBase> op_proto (op.clone ());
+  if (! op_proto.get ()) {
+    return false;
+  }
+
+  std::vector<db::Coord> seams = band_seams (*mp_work_edges, nbands);
+  if (seams.empty ()) {
+    return false;
+  }
+
+  tl::SelfTimer timer (tl::verbosity () >= m_base_verbosity, "EdgeProcessor: process (bands)");
+
+  std::vector<EdgeProcessorBand> bands;
+  bands.resize (seams.size () + 1);
+
+  for (std::vector<EdgeProcessorBand>::iterator b = bands.begin (); b != bands.end (); ++b) {
+    b->op.reset (op_proto->clone ());
+    b->resolve_holes = pg->resolve_holes ();
+    b->min_coherence = pg->min_coherence ();
+    b->open_contours = pg->open_contours ();
+    b->compress = pg->compression_enabled ();
+    b->base_verbosity = m_base_verbosity + 10;
+  }
+
+  //  distribute the edges over the bands - edges crossing a seam are vertical and
+  //  are clipped at the seams
+
+  for (std::vector<WorkEdge>::const_iterator e = mp_work_edges->begin (); e != mp_work_edges->end (); ++e) {
+
+    if (e->dy () == 0) {
+
+      //  horizontal edges are required to form the cut points - edges on a seam go into both bands
+      size_t k = std::upper_bound (seams.begin (), seams.end (), e->y1 ()) - seams.begin ();
+      bands [k].edges.push_back (std::make_pair (db::Edge (*e), e->prop));
+      if (k > 0 && seams [k - 1] == e->y1 ()) {
+        bands [k - 1].edges.push_back (std::make_pair (db::Edge (*e), e->prop));
+      }
+
+      continue;
+
+    }
+
+    db::Coord ylo = edge_ymin (*e), yhi = edge_ymax (*e);
+    size_t kb = std::upper_bound (seams.begin (), seams.end (), ylo) - seams.begin ();
+    size_t ke = std::lower_bound (seams.begin (), seams.end (), yhi) - seams.begin ();
+
+    if (kb == ke) {
+      bands [kb].edges.push_back (std::make_pair (db::Edge (*e), e->prop));
+      continue;
+    }
+
+    tl_assert (e->dx () == 0);
+
+    for (size_t k = kb; k <= ke; ++k) {
+      db::Coord y1 = (k == kb ? ylo : seams [k - 1]);
+      db::Coord y2 = (k == ke ? yhi : seams [k]);
+      db::Edge ec = e->dy () > 0 ? db::Edge (e->x1 (), y1, e->x1 (), y2) : db::Edge (e->x1 (), y2, e->x1 (), y1);
+      bands [k].edges.push_back (std::make_pair (ec, e->prop));
+    }
+
+  }
+
+  {
+    tl::SelfTimer timer_bands (tl::verbosity () >= m_base_verbosity + 10, "EdgeProcessor: bands");
+
+    tl::Job<EdgeProcessorBandWorker> job (m_threads);
+    for (std::vector<EdgeProcessorBand>::iterator b = bands.begin (); b != bands.end (); ++b) {
+      job.schedule (new EdgeProcessorBandTask (&*b));
+    }
+
+    try {
+      job.start ();
+      job.wait ();
+    } catch (...) {
+      job.terminate ();
+      throw;
+    }
+  }
+
+  for (std::vector<EdgeProcessorBand>::const_iterator b = bands.begin (); b != bands.end (); ++b) {
+    if (! b->error.empty ()) {
+      throw tl::Exception (b->error);
+    }
+  }
+
+  tl::SelfTimer timer_stitch (tl::verbosity () >= m_base_verbosity + 10, "EdgeProcessor: stitching");
+
+  //  deliver the polygons not touching a seam directly and merge the others
+
+  db::PolygonSink *sink = pg->polygon_sink ();
+  sink->start ();
+
+  db::EdgeProcessor seam_ep;
+  seam_ep.set_base_verbosity (m_base_verbosity + 10);
+
+  for (size_t k = 0; k < bands.size (); ++k) {
+
+    const std::vector<db::Polygon> &polygons = bands [k].polygons;
+    for (std::vector<db::Polygon>::const_iterator p = polygons.begin (); p != polygons.end (); ++p) {
+      db::Box box = p->box ();
+      if ((k > 0 && box.bottom () == seams [k - 1]) || (k < seams.size () && box.top () == seams [k])) {
+        seam_ep.insert (*p);
+      } else {
+        sink->put (*p);
+      }
+    }
+
+  }
+
+  bands.clear ();
+
+  //  NOTE: the band results are disjoint, hence a plain merge is sufficient to join them
+  ForwardingPolygonSink fwd (sink);
+  db::PolygonGenerator seam_pg (fwd, pg->resolve_holes (), pg->min_coherence ());
+  configure_polygon_generator (seam_pg, pg->open_contours (), pg->compression_enabled ());
+  db::MergeOp merge_op (0);
+  seam_ep.process (seam_pg, merge_op);
+
+  sink->flush ();
+
+  return true;
+}
+
 void
 EdgeProcessor::redo (const std::vector<std::pair<db::EdgeSink *, db::EdgeEvaluatorBase *> > &gen)
 {
@@ -2175,6 +2908,11 @@ EdgeProcessor::redo_or_process (const std::vector<std::pair<db::EdgeSink *, db::
 {
   tl::SelfTimer timer (tl::verbosity () >= m_base_verbosity, "EdgeProcessor: process");
 
+  //  the band-parallel mode leaves the edges untouched, so "redo" needs to start from scratch then
+  if (! m_prepared) {
+    redo = false;
+  }
+
   EdgeProcessorStates gs (gen);
 
   bool prefer_touch = gs.prefer_touch ();
@@ -2196,10 +2934,14 @@ EdgeProcessor::redo_or_process (const std::vector<std::pair<db::EdgeSink *, db::
   //  count the properties
 
   property_type n_props = 0;
+  bool manhattan = m_manhattan_mode;
   for (std::vector <WorkEdge>::iterator e = mp_work_edges->begin (); e != mp_work_edges->end (); ++e) {
     if (e->prop > n_props) {
       n_props = e->prop;
     }
+    if (e->dx () != 0 && e->dy () != 0) {
+      manhattan = false;
+    }
   }
   ++n_props;
 
@@ -2237,69 +2979,81 @@ EdgeProcessor::redo_or_process (const std::vector<std::pair<db::EdgeSink *, db::
   } else {
 
     //  step 2: find intersections
-    std::sort (mp_work_edges->begin (), mp_work_edges->end (), edge_ymin_compare<db::Coord> ());
 
-    y = edge_ymin ((*mp_work_edges) [0]);
-    future = mp_work_edges->begin ();
+    if (manhattan) {
 
-    for (std::vector <WorkEdge>::iterator current = mp_work_edges->begin (); current != mp_work_edges->end (); ) {
+      //  all edges are horizontal or vertical: use the integer-only sweep
+      get_intersections_manhattan (*mp_cpvector, *mp_work_edges, selects_edges);
 
-      if (m_report_progress) {
-        double p = double (std::distance (mp_work_edges->begin (), current)) / double (mp_work_edges->size ());
-        progress->set (size_t (double (todo_next - todo) * p) + todo);
-      }
+    } else {
 
-      size_t n = 0;
-      db::Coord yy = y;
+      std::sort (mp_work_edges->begin (), mp_work_edges->end (), edge_ymin_compare<db::Coord> ());
 
-      //  Use as many scanlines as to fetch approx. 50% new edges into the scanline (this
-      //  is an empirically determined factor)
-      do {
+      BandXRanges x_ranges;
 
-        while (future != mp_work_edges->end () && edge_ymin (*future) <= yy) {
-          ++future;
-        }
+      y = edge_ymin ((*mp_work_edges) [0]);
+      future = mp_work_edges->begin ();
 
-        if (future != mp_work_edges->end ()) {
-          yy = edge_ymin (*future);
-        } else {
-          yy = std::numeric_limits <db::Coord>::max ();
-        }
+      for (std::vector <WorkEdge>::iterator current = mp_work_edges->begin (); current != mp_work_edges->end (); ) {
 
-        if (n == 0) {
-          n = std::distance (current, future);
+        if (m_report_progress) {
+          double p = double (std::distance (mp_work_edges->begin (), current)) / double (mp_work_edges->size ());
+          progress->set (size_t (double (todo_next - todo) * p) + todo);
         }
 
-      } while (future != mp_work_edges->end () && std::distance (current, future) < long (n * fill_factor));
+        size_t n = 0;
+        db::Coord yy = y;
+
+        //  Use as many scanlines as to fetch approx. 50% new edges into the scanline (this
+        //  is an empirically determined factor)
+        do {
 
-      bool is90 = true;
+          while (future != mp_work_edges->end () && edge_ymin (*future) <= yy) {
+            ++future;
+          }
 
-      if (current != future) {
+          if (future != mp_work_edges->end ()) {
+            yy = edge_ymin (*future);
+          } else {
+            yy = std::numeric_limits <db::Coord>::max ();
+          }
 
-        for (std::vector <WorkEdge>::iterator c = current; c != future && is90; ++c) {
-          if (c->dx () != 0 && c->dy () != 0) {
-            is90 = false;
+          if (n == 0) {
+            n = std::distance (current, future);
           }
-        }
 
-        if (is90) {
-          get_intersections_per_band_90 (*mp_cpvector, current, future, y, yy, selects_edges);
-        } else {
-          get_intersections_per_band_any (*mp_cpvector, current, future, y, yy, selects_edges);
-        }
+        } while (future != mp_work_edges->end () && std::distance (current, future) < long (n * fill_factor));
 
-      }
+        bool is90 = true;
 
-      y = yy;
-      for (std::vector <WorkEdge>::iterator c = current; c != future; ++c) {
-        //  Hint: we have to keep the edges ending a y (the new lower band limit) in the all angle case because these edges
-        //  may receive cutpoints because the enter the -0.5DBU region below the band
-        if ((!is90 && edge_ymax (*c) < y) || (is90 && edge_ymax (*c) <= y)) {
-          if (current != c) {
-            std::swap (*current, *c);
+        if (current != future) {
+
+          for (std::vector <WorkEdge>::iterator c = current; c != future && is90; ++c) {
+            if (c->dx () != 0 && c->dy () != 0) {
+              is90 = false;
+            }
+          }
+
+          if (is90) {
+            get_intersections_per_band_90 (*mp_cpvector, current, future, y, yy, selects_edges);
+          } else {
+            get_intersections_per_band_any (*mp_cpvector, current, future, y, yy, selects_edges, m_fast_scan ? &x_ranges : 0);
           }
-          ++current;
+
         }
+
+        y = yy;
+        for (std::vector <WorkEdge>::iterator c = current; c != future; ++c) {
+          //  Hint: we have to keep the edges ending a y (the new lower band limit) in the all angle case because these edges
+          //  may receive cutpoints because the enter the -0.5DBU region below the band
+          if ((!is90 && edge_ymax (*c) < y) || (is90 && edge_ymax (*c) <= y)) {
+            if (current != c) {
+              std::swap (*current, *c);
+            }
+            ++current;
+          }
+        }
+
       }
 
     }
@@ -2410,6 +3164,8 @@ EdgeProcessor::redo_or_process (const std::vector<std::pair<db::EdgeSink *, db::
     }
 #endif
 
+    m_prepared = true;
+
   }
 
 
@@ -271,6 +271,15 @@ public:
   virtual bool is_reset () const { return false; }
   virtual bool prefer_touch () const { return false; }
   virtual bool selects_edges () const { return false; }
+
+  /**
+   *  @brief Creates a fresh copy of this evaluator
+   *
+   *  The band-parallel mode of the edge processor needs one evaluator per band.
+   *  Evaluators which can be copied implement this method. The default
+   *  implementation returns 0 which disables the band-parallel mode.
+   */
+  virtual EdgeEvaluatorBase *clone () const { return 0; }
 };
 
 /**
@@ -494,6 +503,8 @@ public:
   SimpleMerge (int mode = -1)
     : GenericMerge<ParametrizedInsideFunc> (ParametrizedInsideFunc (mode))
   { }
+
+  virtual EdgeEvaluatorBase *clone () const { return new SimpleMerge (*this); }
 };
 
 /**
@@ -525,6 +536,7 @@ public:
   virtual int edge (bool north, bool enter, property_type p);
   virtual int compare_ns () const;
   virtual bool is_reset () const { return m_zeroes == m_wcv_n.size () + m_wcv_s.size (); }
+  virtual EdgeEvaluatorBase *clone () const { return new BooleanOp (*this); }
 
 protected:
   template <class InsideFunc> bool result (int wca, int wcb, const InsideFunc &inside_a, const InsideFunc &inside_b) const;
@@ -607,6 +619,7 @@ public:
 
   virtual int edge (bool north, bool enter, property_type p);
   virtual int compare_ns () const;
+  virtual EdgeEvaluatorBase *clone () const { return new BooleanOp2 (*this); }
 
 private:
   int m_wc_mode_a, m_wc_mode_b;
@@ -637,6 +650,7 @@ public:
   virtual int edge (bool north, bool enter, property_type p);
   virtual int compare_ns () const;
   virtual bool is_reset () const { return m_zeroes == m_wcv_n.size () + m_wcv_s.size (); }
+  virtual EdgeEvaluatorBase *clone () const { return new MergeOp (*this); }
 
 private:
   int m_wc_n, m_wc_s;
@@ -690,6 +704,71 @@ public:
    */
   void set_base_verbosity (int bv);
 
+  /**
+   *  @brief Sets the number of threads to use
+   *
+   *  With a thread count of 1 or more, "process" with a single polygon-generating
+   *  output will split large inputs into horizontal bands and process these in
+   *  parallel. Polygons spanning a band boundary are merged in a final serial step.
+   *  The result is the same as in the serial mode, but the order of the polygons
+   *  may differ. The default is 0 (serial processing).
+   *
+   *  Band-parallel mode applies only for evaluators supporting "clone" and
+   *  PolygonGenerator receivers with a PolygonSink.
+   */
+  void set_threads (int n);
+
+  /**
+   *  @brief Gets the number of threads to use
+   */
+  int threads () const
+  {
+    return m_threads;
+  }
+
+  /**
+   *  @brief Enables or disables the fast intersection scan
+   *
+   *  The fast scan computes the edge bounds per scanline band once in a
+   *  structure-of-arrays layout and uses them to skip edge pairs which cannot
+   *  interact. The results are identical to the plain scan which is mainly
+   *  provided for reference and benchmarking. The fast scan is enabled by default.
+   */
+  void set_fast_scan (bool f);
+
+  /**
+   *  @brief Gets a value indicating whether the fast intersection scan is enabled
+   */
+  bool fast_scan () const
+  {
+    return m_fast_scan;
+  }
+
+  /**
+   *  @brief Enables or disables the Manhattan mode
+   *
+   *  If the Manhattan mode is enabled and all input edges are horizontal or
+   *  vertical, the intersection search is performed by a dedicated, integer-only
+   *  sweep instead of the band-wise generic scheme. The results are identical.
+   *  The Manhattan mode is enabled by default.
+   */
+  void set_manhattan_mode (bool f);
+
+  /**
+   *  @brief Gets a value indicating whether the Manhattan mode is enabled
+   */
+  bool manhattan_mode () const
+  {
+    return m_manhattan_mode;
+  }
+
+  /**
+   *  @brief Sets the minimum number of edges per band for the band-parallel mode
+   *
+   *  This method switches the global value and is intended for regression test purposes only!
+   */
+  static void set_min_edges_per_band_global (size_t n);
+
   /**
    *  @brief Reserve space for at least n edges
    */
@@ -1130,6 +1209,11 @@ private:
   bool m_report_progress;
   std::string m_progress_desc;
   int m_base_verbosity;
+  int m_threads;
+  bool m_prepared;
+  bool m_fast_scan;
+  bool m_manhattan_mode;
+  static size_t ms_min_edges_per_band;
 
   static size_t count_edges (const db::Polygon &q) 
   {
@@ -1150,6 +1234,7 @@ private:
   }
 
   void redo_or_process (const std::vector<std::pair<db::EdgeSink *, db::EdgeEvaluatorBase *> > &gen, bool redo);
+  bool process_in_bands (db::EdgeSink &es, EdgeEvaluatorBase &op);
 };
 
 /**
@@ -32,6 +32,7 @@
 #include "tlProgress.h"
 #include "tlLog.h"
 #include "tlTimer.h"
+#include "tlThreadedWorkers.h"
 
 #include <vector>
 #include <map>
@@ -1834,6 +1835,182 @@ private:
   const hier_clusters<T> *mp_tree;
 };
 
+// ------------------------------------------------------------------------------
+//  Multi-threading support for hier_clusters
+
+/**
+ *  @brief A task computing the local clusters of one cell
+ */
+template <class T>
+class hier_clusters_local_task
+  : public tl::Task
+{
+public:
+  hier_clusters_local_task (hier_clusters<T> *hc, const db::Layout *layout, db::cell_index_type ci, const db::Connectivity *conn, const tl::equivalence_clusters<size_t> *attr_equivalence, bool separate_attributes)
+    : mp_hc (hc), mp_layout (layout), m_ci (ci), mp_conn (conn), mp_attr_equivalence (attr_equivalence), m_separate_attributes (separate_attributes)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform ()
+  {
+    mp_hc->build_local_cluster (*mp_layout, mp_layout->cell (m_ci), *mp_conn, mp_attr_equivalence, m_separate_attributes);
+  }
+
+private:
+  hier_clusters<T> *mp_hc;
+  const db::Layout *mp_layout;
+  db::cell_index_type m_ci;
+  const db::Connectivity *mp_conn;
+  const tl::equivalence_clusters<size_t> *mp_attr_equivalence;
+  bool m_separate_attributes;
+};
+
+/**
+ *  @brief The worker for hier_clusters_local_task
+ */
+template <class T>
+class hier_clusters_local_worker
+  : public tl::Worker
+{
+public:
+  hier_clusters_local_worker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<hier_clusters_local_task<T> *> (task)->perform ();
+  }
+};
+
+/**
+ *  @brief A task computing the hierarchical connections of one cell
+ */
+template <class T>
+class hier_clusters_connections_task
+  : public tl::Task
+{
+public:
+  typedef typename hier_clusters<T>::instance_interaction_cache_type instance_interaction_cache_type;
+
+  hier_clusters_connections_task (hier_clusters<T> *hc, cell_clusters_box_converter<T> *cbc, const db::Layout *layout, db::cell_index_type ci, const db::Connectivity *conn, const std::set<db::cell_index_type> *breakout_cells, bool separate_attributes)
+    : mp_hc (hc), mp_cbc (cbc), mp_layout (layout), m_ci (ci), mp_conn (conn), mp_breakout_cells (breakout_cells), m_separate_attributes (separate_attributes)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform (instance_interaction_cache_type &instance_interaction_cache)
+  {
+    mp_hc->build_hier_connections (*mp_cbc, *mp_layout, mp_layout->cell (m_ci), *mp_conn, mp_breakout_cells, instance_interaction_cache, m_separate_attributes);
+  }
+
+private:
+  hier_clusters<T> *mp_hc;
+  cell_clusters_box_converter<T> *mp_cbc;
+  const db::Layout *mp_layout;
+  db::cell_index_type m_ci;
+  const db::Connectivity *mp_conn;
+  const std::set<db::cell_index_type> *mp_breakout_cells;
+  bool m_separate_attributes;
+};
+
+/**
+ *  @brief The worker for hier_clusters_connections_task
+ *
+ *  Each worker holds its own instance interaction cache.
+ */
+template <class T>
+class hier_clusters_connections_worker
+  : public tl::Worker
+{
+public:
+  hier_clusters_connections_worker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<hier_clusters_connections_task<T> *> (task)->perform (m_cache);
+  }
+
+private:
+  typename hier_clusters_connections_task<T>::instance_interaction_cache_type m_cache;
+};
+
+namespace
+{
+
+template <class W>
+void
+run_job (tl::Job<W> &job)
+{
+  try {
+    job.start ();
+    job.wait ();
+  } catch (...) {
+    job.terminate ();
+    throw;
+  }
+
+  if (job.has_error ()) {
+    throw tl::Exception (tl::to_string (tr ("Errors occurred during processing. First error message says:\n")) + job.error_messages ().front ());
+  }
+}
+
+/**
+ *  @brief Looks up the net label joining spec for a cell
+ *
+ *  For the top cell the "top_cell_index" entry is looked for. If there is no such entry or the cell is not
+ *  the top cell, the entry is looked up by cell index.
+ */
+template <class T>
+const tl::equivalence_clusters<size_t> *
+attr_equivalence_for_cell (const std::map<db::cell_index_type, tl::equivalence_clusters<size_t> > *attr_equivalence, db::cell_index_type ci, db::cell_index_type top_ci)
+{
+  if (! attr_equivalence) {
+    return 0;
+  }
+
+  std::map<db::cell_index_type, tl::equivalence_clusters<size_t> >::const_iterator ae;
+  if (ci == top_ci) {
+    ae = attr_equivalence->find (hier_clusters<T>::top_cell_index);
+    if (ae != attr_equivalence->end ()) {
+      return &ae->second;
+    }
+  }
+
+  ae = attr_equivalence->find (ci);
+  if (ae != attr_equivalence->end ()) {
+    return &ae->second;
+  } else {
+    return 0;
+  }
+}
+
+template <class T>
+bool
+have_common_elements (const std::set<T> &a, const std::set<T> &b)
+{
+  typename std::set<T>::const_iterator ia = a.begin (), ib = b.begin ();
+  while (ia != a.end () && ib != b.end ()) {
+    if (*ia < *ib) {
+      ++ia;
+    } else if (*ib < *ia) {
+      ++ib;
+    } else {
+      return true;
+    }
+  }
+  return false;
+}
+
+}
+
 // ------------------------------------------------------------------------------
 //  hier_clusters implementation
 
@@ -1842,7 +2019,7 @@ const db::cell_index_type hier_clusters<T>::top_cell_index = std::numeric_limits
 
 template <class T>
 hier_clusters<T>::hier_clusters ()
-  : m_base_verbosity (20)
+  : m_base_verbosity (20), m_threads (0)
 {
   //  .. nothing yet ..
 }
@@ -1853,6 +2030,12 @@ void hier_clusters<T>::set_base_verbosity (int bv)
   m_base_verbosity = bv;
 }
 
+template <class T>
+void hier_clusters<T>::set_threads (unsigned int n)
+{
+  m_threads = n;
+}
+
 template <class T>
 void hier_clusters<T>::clear ()
 {
@@ -2857,30 +3040,30 @@ hier_clusters<T>::do_build (cell_clusters_box_converter<T> &cbc, const db::Layou
     tl::SelfTimer timer (tl::verbosity () > m_base_verbosity + 10, tl::to_string (tr ("Computing local shape clusters")));
     tl::RelativeProgress progress (tl::to_string (tr ("Computing local clusters")), called.size (), 1);
 
-    for (std::set<db::cell_index_type>::const_iterator c = called.begin (); c != called.end (); ++c) {
-
-      //  look for the net label joining spec - for the top cell the "top_cell_index" entry is looked for.
-      //  If there is no such entry or the cell is not the top cell, look for the entry by cell index.
-      std::map<db::cell_index_type, tl::equivalence_clusters<size_t> >::const_iterator ae;
-      const tl::equivalence_clusters<size_t> *ec = 0;
-      if (attr_equivalence) {
-        if (*c == cell.cell_index ()) {
-          ae = attr_equivalence->find (top_cell_index);
-          if (ae != attr_equivalence->end ()) {
-            ec = &ae->second;
-          }
-        }
-        if (! ec) {
-          ae = attr_equivalence->find (*c);
-          if (ae != attr_equivalence->end ()) {
-            ec = &ae->second;
-          }
-        }
+    if (m_threads > 0 && called.size () > 1) {
+
+      //  avoids lazy updates of the layout while the threads read it
+      layout.update ();
+
+      //  NOTE: the cluster map must not be modified while the tasks are running, so we create the entries before
+      for (std::set<db::cell_index_type>::const_iterator c = called.begin (); c != called.end (); ++c) {
+        clusters_per_cell (*c);
+      }
+
+      tl::Job<hier_clusters_local_worker<T> > job (m_threads);
+      for (std::set<db::cell_index_type>::const_iterator c = called.begin (); c != called.end (); ++c) {
+        job.schedule (new hier_clusters_local_task<T> (this, &layout, *c, &conn, attr_equivalence_for_cell<T> (attr_equivalence, *c, cell.cell_index ()), separate_attributes));
       }
 
-      build_local_cluster (layout, layout.cell (*c), conn, ec, separate_attributes);
+      run_job (job);
+      progress.set (called.size ());
 
-      ++progress;
+    } else {
+
+      for (std::set<db::cell_index_type>::const_iterator c = called.begin (); c != called.end (); ++c) {
+        build_local_cluster (layout, layout.cell (*c), conn, attr_equivalence_for_cell<T> (attr_equivalence, *c, cell.cell_index ()), separate_attributes);
+        ++progress;
+      }
 
     }
   }
@@ -2909,7 +3092,11 @@ hier_clusters<T>::do_build (cell_clusters_box_converter<T> &cbc, const db::Layou
           todo.push_back (*c);
         } else {
           tl_assert (! todo.empty ());
-          build_hier_connections_for_cells (cbc, layout, todo, conn, breakout_cells, progress, instance_interaction_cache, separate_attributes);
+          if (m_threads > 0) {
+            build_hier_connections_in_parallel (cbc, layout, todo, conn, breakout_cells, progress, instance_interaction_cache, separate_attributes);
+          } else {
+            build_hier_connections_for_cells (cbc, layout, todo, conn, breakout_cells, progress, instance_interaction_cache, separate_attributes);
+          }
           done.insert (todo.begin (), todo.end ());
           todo.clear ();
           todo.push_back (*c);
@@ -2919,7 +3106,11 @@ hier_clusters<T>::do_build (cell_clusters_box_converter<T> &cbc, const db::Layou
 
     }
 
-    build_hier_connections_for_cells (cbc, layout, todo, conn, breakout_cells, progress, instance_interaction_cache, separate_attributes);
+    if (m_threads > 0) {
+      build_hier_connections_in_parallel (cbc, layout, todo, conn, breakout_cells, progress, instance_interaction_cache, separate_attributes);
+    } else {
+      build_hier_connections_for_cells (cbc, layout, todo, conn, breakout_cells, progress, instance_interaction_cache, separate_attributes);
+    }
   }
 
   if (tl::verbosity () >= m_base_verbosity + 20) {
@@ -2951,6 +3142,85 @@ hier_clusters<T>::build_hier_connections_for_cells (cell_clusters_box_converter<
   }
 }
 
+template <class T>
+void
+hier_clusters<T>::build_hier_connections_in_parallel (cell_clusters_box_converter<T> &cbc, const db::Layout &layout, const std::vector<db::cell_index_type> &cells, const db::Connectivity &conn, const std::set<db::cell_index_type> *breakout_cells, tl::RelativeProgress &progress, instance_interaction_cache_type &instance_interaction_cache, bool separate_attributes)
+{
+  //  Building the hierarchical connections of a cell modifies the clusters of the cell and - by propagating
+  //  clusters up to the cell - of the cells below and of the other parents of these. Cells can be processed in
+  //  parallel if these footprints do not overlap. Cells conflicting with the current batch or with cells deferred
+  //  already are deferred as well, so conflicting cells are always processed in their original order. This way,
+  //  the result is identical to the sequential one.
+
+  std::vector<db::cell_index_type> todo (cells);
+
+  while (! todo.empty ()) {
+
+    std::vector<db::cell_index_type> batch, deferred;
+    std::set<db::cell_index_type> batch_footprint, batch_below, deferred_footprint;
+
+    for (std::vector<db::cell_index_type>::const_iterator c = todo.begin (); c != todo.end (); ++c) {
+
+      const db::Cell &cell = layout.cell (*c);
+
+      std::set<db::cell_index_type> below;
+      cell.collect_called_cells (below);
+
+      std::set<db::cell_index_type> footprint (below);
+      footprint.insert (*c);
+      for (std::set<db::cell_index_type>::const_iterator b = below.begin (); b != below.end (); ++b) {
+        const db::Cell &child = layout.cell (*b);
+        for (db::Cell::parent_cell_iterator pc = child.begin_parent_cells (); pc != child.end_parent_cells (); ++pc) {
+          footprint.insert (*pc);
+        }
+      }
+
+      if (have_common_elements (footprint, batch_footprint) || have_common_elements (footprint, deferred_footprint)) {
+        deferred.push_back (*c);
+        deferred_footprint.insert (footprint.begin (), footprint.end ());
+      } else {
+        batch.push_back (*c);
+        batch_footprint.insert (footprint.begin (), footprint.end ());
+        batch_below.insert (below.begin (), below.end ());
+      }
+
+    }
+
+    if (batch.size () < 2) {
+
+      build_hier_connections_for_cells (cbc, layout, batch, conn, breakout_cells, progress, instance_interaction_cache, separate_attributes);
+
+    } else {
+
+      //  NOTE: the cluster map and the box converter's cache must not be modified while the tasks are
+      //  running. Hence we create the entries and compute the (lazy) cell boxes before.
+      layout.update ();
+
+      for (std::set<db::cell_index_type>::const_iterator c = batch_footprint.begin (); c != batch_footprint.end (); ++c) {
+        clusters_per_cell (*c);
+      }
+      for (std::set<db::cell_index_type>::const_iterator c = batch_below.begin (); c != batch_below.end (); ++c) {
+        cbc (*c);
+      }
+
+      tl::Job<hier_clusters_connections_worker<T> > job (m_threads);
+      for (std::vector<db::cell_index_type>::const_iterator c = batch.begin (); c != batch.end (); ++c) {
+        job.schedule (new hier_clusters_connections_task<T> (this, &cbc, &layout, *c, &conn, breakout_cells, separate_attributes));
+      }
+
+      run_job (job);
+
+      for (size_t i = 0; i < batch.size (); ++i) {
+        ++progress;
+      }
+
+    }
+
+    todo.swap (deferred);
+
+  }
+}
+
 namespace {
 
 class GlobalNetClusterMaker
@@ -637,6 +637,17 @@ public:
    */
   local_cluster<T> *insert ();
 
+  /**
+   *  @brief Indicates that clusters have been modified after sorting has taken place
+   *
+   *  This method must be called when shapes have been added to the clusters
+   *  later, so the bounding boxes and the search tree are updated.
+   */
+  void invalidate ()
+  {
+    m_needs_update = true;
+  }
+
   /**
    *  @brief Allocates a new ID for dummy clusters
    *
@@ -1385,6 +1396,24 @@ public:
    */
   void set_base_verbosity (int bv);
 
+  /**
+   *  @brief Sets the number of threads to use for building the clusters
+   *
+   *  With a thread count of 0 (the default), the clusters are built in the calling thread.
+   *  Otherwise, the local clusters of the cells are built in parallel and the hierarchical
+   *  connections are built in parallel for independent cells of the same hierarchy level.
+   *  The cluster IDs do not depend on the number of threads.
+   */
+  void set_threads (unsigned int n);
+
+  /**
+   *  @brief Gets the number of threads to use for building the clusters
+   */
+  unsigned int threads () const
+  {
+    return m_threads;
+  }
+
   /**
    *  @brief A constant indicating the top cell for the equivalence cluster key
    */
@@ -1436,13 +1465,19 @@ public:
   void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self, void *parent) const;
 
 private:
+  template <typename> friend class hier_clusters_local_task;
+  template <typename> friend class hier_clusters_connections_task;
+
   void build_local_cluster (const db::Layout &layout, const db::Cell &cell, const db::Connectivity &conn, const tl::equivalence_clusters<size_t> *attr_equivalence, bool separate_attributes);
   void build_hier_connections (cell_clusters_box_converter<T> &cbc, const db::Layout &layout, const db::Cell &cell, const db::Connectivity &conn, const std::set<cell_index_type> *breakout_cells, instance_interaction_cache_type &instance_interaction_cache, bool separate_attributes);
   void build_hier_connections_for_cells (cell_clusters_box_converter<T> &cbc, const db::Layout &layout, const std::vector<db::cell_index_type> &cells, const db::Connectivity &conn, const std::set<cell_index_type> *breakout_cells, tl::RelativeProgress &progress, instance_interaction_cache_type &instance_interaction_cache, bool separate_attributes);
   void do_build (cell_clusters_box_converter<T> &cbc, const db::Layout &layout, const db::Cell &cell, const db::Connectivity &conn, const std::map<cell_index_type, tl::equivalence_clusters<size_t> > *attr_equivalence, const std::set<cell_index_type> *breakout_cells, bool separate_attributes);
 
+  void build_hier_connections_in_parallel (cell_clusters_box_converter<T> &cbc, const db::Layout &layout, const std::vector<db::cell_index_type> &cells, const db::Connectivity &conn, const std::set<cell_index_type> *breakout_cells, tl::RelativeProgress &progress, instance_interaction_cache_type &instance_interaction_cache, bool separate_attributes);
+
   std::map<db::cell_index_type, connected_clusters<T> > m_per_cell_clusters;
   int m_base_verbosity;
+  unsigned int m_threads;
 };
 
 /**
@@ -35,6 +35,12 @@
 #include "tlLog.h"
 #include "tlTimer.h"
 #include "tlInternational.h"
+#include "tlThreadedWorkers.h"
+#include "tlProgress.h"
+
+#include <cmath>
+#include <atomic>
+#include <memory>
 
 // ---------------------------------------------------------------------------------------------
 //  Cronology debugging support (TODO: experimental)
@@ -709,8 +715,8 @@ local_processor_context_computation_task<TS, TI, TR>::perform ()
 //  LocalProcessorResultComputationTask implementation
 
 template <class TS, class TI, class TR>
-local_processor_result_computation_task<TS, TI, TR>::local_processor_result_computation_task (const local_processor<TS, TI, TR> *proc, local_processor_contexts<TS, TI, TR> &contexts, db::Cell *cell, local_processor_cell_contexts<TS, TI, TR> *cell_contexts, const local_operation<TS, TI, TR> *op, const std::vector<unsigned int> &output_layers)
-  : mp_proc (proc), mp_contexts (&contexts), mp_cell (cell), mp_cell_contexts (cell_contexts), mp_op (op), m_output_layers (output_layers)
+local_processor_result_computation_task<TS, TI, TR>::local_processor_result_computation_task (const local_processor<TS, TI, TR> *proc, local_processor_contexts<TS, TI, TR> &contexts, db::Cell *cell, local_processor_cell_contexts<TS, TI, TR> *cell_contexts, const local_operation<TS, TI, TR> *op, const std::vector<unsigned int> &output_layers, tl::JobBase *tile_job)
+  : mp_proc (proc), mp_contexts (&contexts), mp_cell (cell), mp_cell_contexts (cell_contexts), mp_op (op), m_output_layers (output_layers), mp_tile_job (tile_job)
 {
   //  .. nothing yet ..
 }
@@ -719,7 +725,7 @@ template <class TS, class TI, class TR>
 void
 local_processor_result_computation_task<TS, TI, TR>::perform ()
 {
-  mp_cell_contexts->compute_results (*mp_contexts, mp_cell, mp_op, m_output_layers, mp_proc);
+  mp_cell_contexts->compute_results (*mp_contexts, mp_cell, mp_op, m_output_layers, mp_proc, mp_tile_job);
 
   {
     tl::MutexLocker locker (& mp_contexts->lock ());
@@ -751,7 +757,7 @@ local_processor_result_computation_task<TS, TI, TR>::perform ()
 //  LocalProcessorBase implementation
 
 LocalProcessorBase::LocalProcessorBase ()
-  : m_report_progress (true), m_nthreads (0), m_max_vertex_count (0), m_area_ratio (0.0), m_top_down (false), m_boolean_core (false),
+  : m_report_progress (true), m_nthreads (0), m_max_vertex_count (0), m_area_ratio (0.0), m_split_cell_threshold (10000), m_top_down (false), m_boolean_core (false),
     m_base_verbosity (30), mp_vars (0), mp_current_cell (0)
 {
   //  .. nothing yet ..
@@ -1160,6 +1166,14 @@ void local_processor<TS, TI, TR>::compute_contexts (local_processor_contexts<TS,
 
 }
 
+template <class TS, class TI, class TR>
+bool
+local_processor<TS, TI, TR>::is_split_cell (const db::local_processor_contexts<TS, TI, TR> &contexts, const db::Cell *subject_cell, const local_operation<TS, TI, TR> *op) const
+{
+  return threads () > 0 && split_cell_threshold () > 0 && op->requests_single_subjects ()
+           && subject_cell->shapes (contexts.subject_layer ()).size () >= split_cell_threshold ();
+}
+
 template <class TS, class TI, class TR>
 void
 local_processor<TS, TI, TR>::compute_results (local_processor_contexts<TS, TI, TR> &contexts, const local_operation<TS, TI, TR> *op, const std::vector<unsigned int> &output_layers) const
@@ -1222,7 +1236,10 @@ local_processor<TS, TI, TR>::compute_results (local_processor_contexts<TS, TI, T
 
           if (later.find (*bu) == later.end ()) {
 
-            rc_job->schedule (new local_processor_result_computation_task<TS, TI, TR> (this, contexts, cpc->first, &cpc->second, op, output_layers));
+            //  for large cells, the subjects are split spatially into tiles and the tiles are
+            //  computed by tasks of the same job
+            tl::JobBase *tile_job = is_split_cell (contexts, cpc->first, op) ? rc_job.get () : 0;
+            rc_job->schedule (new local_processor_result_computation_task<TS, TI, TR> (this, contexts, cpc->first, &cpc->second, op, output_layers, tile_job));
             any = true;
 
           } else {
@@ -1405,11 +1422,287 @@ struct scan_shape2shape_different_layers
   }
 };
 
+/**
+ *  @brief A tile for the parallel flat or split cell mode: the subjects and the results
+ */
+template <class TR>
+struct flat_tile
+{
+  std::vector<unsigned int> subjects;
+  std::vector<std::unordered_set<TR> > results;
+  std::string error;
+};
+
+/**
+ *  @brief The tiles of a parallel flat or split cell computation
+ *
+ *  The tiles are taken one by one by the tile tasks and - in split cell mode - by the task
+ *  computing the cell. The tile tasks share the tile set, so a task which is executed after
+ *  all tiles have been taken does not refer to a tile set which is gone already.
+ */
+template <class TS, class TI, class TR>
+class flat_tile_set
+{
+public:
+  flat_tile_set (const local_processor<TS, TI, TR> *proc, const local_operation<TS, TI, TR> *op, db::Layout *layout, db::Cell *subject_cell, const shape_interactions<TS, TI> *interactions)
+    : mp_proc (proc), mp_op (op), mp_layout (layout), mp_subject_cell (subject_cell), mp_interactions (interactions), m_next (0), m_done (0), m_finished (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  std::vector<flat_tile<TR> > &tiles ()
+  {
+    return m_tiles;
+  }
+
+  /**
+   *  @brief Gets the number of subjects computed so far
+   */
+  size_t done () const
+  {
+    return m_done;
+  }
+
+  /**
+   *  @brief Takes the next tile and computes it
+   *  Returns false if there are no more tiles to take.
+   */
+  bool compute_next ()
+  {
+    size_t n = m_next++;
+    if (n >= m_tiles.size ()) {
+      return false;
+    }
+
+    flat_tile<TR> &tile = m_tiles [n];
+
+    try {
+
+      for (auto s = tile.subjects.begin (); s != tile.subjects.end (); ++s) {
+        mp_op->compute_local_single_subject (mp_layout, mp_subject_cell, *mp_interactions, *s, tile.results, mp_proc);
+        ++m_done;
+      }
+
+    } catch (tl::Exception &ex) {
+      tile.error = ex.msg ();
+    } catch (std::exception &ex) {
+      tile.error = ex.what ();
+    } catch (...) {
+      tile.error = tl::to_string (tr ("Unspecific error"));
+    }
+
+    tl::MutexLocker locker (&m_lock);
+    if (++m_finished == m_tiles.size ()) {
+      m_finished_condition.wakeAll ();
+    }
+
+    return true;
+  }
+
+  /**
+   *  @brief Waits until all tiles are computed
+   */
+  void wait ()
+  {
+    tl::MutexLocker locker (&m_lock);
+    while (m_finished < m_tiles.size ()) {
+      m_finished_condition.wait (&m_lock);
+    }
+  }
+
+private:
+  const local_processor<TS, TI, TR> *mp_proc;
+  const local_operation<TS, TI, TR> *mp_op;
+  db::Layout *mp_layout;
+  db::Cell *mp_subject_cell;
+  const shape_interactions<TS, TI> *mp_interactions;
+  std::vector<flat_tile<TR> > m_tiles;
+  std::atomic<size_t> m_next, m_done;
+  size_t m_finished;
+  tl::Mutex m_lock;
+  tl::WaitCondition m_finished_condition;
+};
+
+/**
+ *  @brief A task computing the results for the subjects of one tile
+ */
+template <class TS, class TI, class TR>
+class flat_tile_computation_task
+  : public local_processor_result_computation_task_base
+{
+public:
+  flat_tile_computation_task (const std::shared_ptr<flat_tile_set<TS, TI, TR> > &tiles)
+    : mp_tiles (tiles)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform ()
+  {
+    mp_tiles->compute_next ();
+  }
+
+private:
+  std::shared_ptr<flat_tile_set<TS, TI, TR> > mp_tiles;
+};
+
+template <class TS, class TI, class TR>
+class flat_tile_computation_worker
+  : public tl::Worker
+{
+public:
+  flat_tile_computation_worker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<flat_tile_computation_task<TS, TI, TR> *> (task)->perform ();
+  }
+};
+
+/**
+ *  @brief The minimum number of subjects per tile in the parallel flat or split cell mode
+ */
+const size_t min_subjects_per_flat_tile = 16;
+
+/**
+ *  @brief Computes the results of a single-subject operation using multiple threads
+ *
+ *  This method is used in flat mode and for large cells in hierarchical mode. In the latter
+ *  case, "layout" and "subject_cell" are the layout and the cell the results are computed for.
+ *
+ *  The subjects are distributed over a grid of tiles by the centers of their bounding boxes
+ *  and each tile is computed in a separate task. As the interactions already include all intruders
+ *  within the interaction distance of each subject, every subject is computed with its full
+ *  context (the "halo"). Results reported by subjects from different tiles are joined in the
+ *  result sets, so the results are identical to the single-threaded computation.
+ *
+ *  If "tile_job" is given, the tiles are computed by tasks of this job which is the result
+ *  computation job the caller is running in. The caller takes tiles itself while waiting for the
+ *  tiles, so no thread is blocked. Without a job, a job is created for computing the tiles.
+ *
+ *  Returns false, if the parallel mode is not applicable. In this case, no result is computed.
+ */
+template <class TS, class TI, class TR>
+bool
+compute_local_in_tiles (const local_processor<TS, TI, TR> *proc, const local_operation<TS, TI, TR> *op, db::Layout *layout, db::Cell *subject_cell, const shape_interactions<TS, TI> &interactions, std::vector<std::unordered_set<TR> > &result, tl::JobBase *tile_job = 0)
+{
+  if (proc->threads () == 0 || ! op->requests_single_subjects ()) {
+    return false;
+  }
+
+  size_t ntiles = std::min (size_t (proc->threads ()) * 4, interactions.size () / min_subjects_per_flat_tile);
+  if (ntiles < 2) {
+    return false;
+  }
+
+  db::Box bbox;
+  for (auto i = interactions.begin (); i != interactions.end (); ++i) {
+    bbox += db::box_convert<TS> () (interactions.subject_shape (i->first));
+  }
+
+  if (bbox.empty ()) {
+    return false;
+  }
+
+  //  form a grid with roughly square tiles
+  double aspect = std::max (double (bbox.width ()), 1.0) / std::max (double (bbox.height ()), 1.0);
+  size_t nx = std::min (ntiles, std::max (size_t (1), size_t (floor (sqrt (double (ntiles) * aspect) + 0.5))));
+  size_t ny = std::max (size_t (1), ntiles / nx);
+
+  double tw = double (bbox.width ()) / double (nx);
+  double th = double (bbox.height ()) / double (ny);
+
+  std::shared_ptr<flat_tile_set<TS, TI, TR> > tile_set (new flat_tile_set<TS, TI, TR> (proc, op, layout, subject_cell, &interactions));
+
+  std::vector<flat_tile<TR> > &tiles = tile_set->tiles ();
+  tiles.resize (nx * ny);
+
+  for (auto i = interactions.begin (); i != interactions.end (); ++i) {
+
+    db::Point c = db::box_convert<TS> () (interactions.subject_shape (i->first)).center ();
+    size_t ix = tw > 0.0 ? std::min (nx - 1, size_t (std::max (0.0, (double (c.x ()) - double (bbox.left ())) / tw))) : 0;
+    size_t iy = th > 0.0 ? std::min (ny - 1, size_t (std::max (0.0, (double (c.y ()) - double (bbox.bottom ())) / th))) : 0;
+
+    tiles [iy * nx + ix].subjects.push_back (i->first);
+
+  }
+
+  //  drop the empty tiles
+  typename std::vector<flat_tile<TR> >::iterator tt = tiles.begin ();
+  for (auto t = tiles.begin (); t != tiles.end (); ++t) {
+    if (! t->subjects.empty ()) {
+      if (tt != t) {
+        tt->subjects.swap (t->subjects);
+      }
+      tt->results.resize (result.size ());
+      ++tt;
+    }
+  }
+  tiles.erase (tt, tiles.end ());
+
+  if (tile_job) {
+
+    //  the tiles are taken by the other workers first, so the cell is finished soon
+    for (size_t i = 1; i < tiles.size (); ++i) {
+      flat_tile_computation_task<TS, TI, TR> *task = new flat_tile_computation_task<TS, TI, TR> (tile_set);
+      task->set_priority (1);
+      tile_job->schedule (task);
+    }
+
+    //  take tiles too instead of waiting idle
+    while (tile_set->compute_next ()) {
+      //  .. nothing else ..
+    }
+
+    tile_set->wait ();
+
+  } else {
+
+    tl::Job<flat_tile_computation_worker<TS, TI, TR> > job (proc->threads ());
+
+    for (size_t i = 0; i < tiles.size (); ++i) {
+      job.schedule (new flat_tile_computation_task<TS, TI, TR> (tile_set));
+    }
+
+    //  NOTE: the progress also provides the cancel feature
+    tl::RelativeProgress progress (proc->description (op), proc->report_progress () ? interactions.size () : 0, 1);
+
+    try {
+      job.start ();
+      while (! job.wait (10)) {
+        progress.set (tile_set->done ());
+      }
+    } catch (...) {
+      job.terminate ();
+      throw;
+    }
+
+  }
+
+  for (auto t = tiles.begin (); t != tiles.end (); ++t) {
+
+    if (! t->error.empty ()) {
+      throw tl::Exception (t->error);
+    }
+
+    for (size_t r = 0; r < t->results.size (); ++r) {
+      result [r].insert (t->results [r].begin (), t->results [r].end ());
+    }
+
+  }
+
+  return true;
+}
+
 }
 
 template <class TS, class TI, class TR>
 void
-local_processor<TS, TI, TR>::compute_local_cell (const db::local_processor_contexts<TS, TI, TR> &contexts, db::Cell *subject_cell, const db::Cell *intruder_cell, const local_operation<TS, TI, TR> *op, const typename local_processor_cell_contexts<TS, TI, TR>::context_key_type &intruders, std::vector<std::unordered_set<TR> > &result) const
+local_processor<TS, TI, TR>::compute_local_cell (const db::local_processor_contexts<TS, TI, TR> &contexts, db::Cell *subject_cell, const db::Cell *intruder_cell, const local_operation<TS, TI, TR> *op, const typename local_processor_cell_contexts<TS, TI, TR>::context_key_type &intruders, std::vector<std::unordered_set<TR> > &result, tl::JobBase *tile_job) const
 {
   auto override_distance = op->override_distance ();
   db::Coord dist_global = dist_for_cell (subject_cell->cell_index (), op->dist ());
@@ -1532,7 +1825,10 @@ local_processor<TS, TI, TR>::compute_local_cell (const db::local_processor_conte
 
     }
 
-    op->compute_local (mp_subject_layout, subject_cell, interactions, result, this);
+    //  large cells are split into tiles which are computed in parallel
+    if (! tile_job || ! compute_local_in_tiles (this, op, mp_subject_layout, subject_cell, interactions, result, tile_job)) {
+      op->compute_local (mp_subject_layout, subject_cell, interactions, result, this);
+    }
 
   }
 }
@@ -1583,6 +1879,65 @@ local_processor<TS, TI, TR>::run_flat (const db::Shapes *subject_shapes, const s
 namespace
 {
 
+/**
+ *  @brief Collects the interactions of one strip of a parallel box scanner
+ */
+template <class TS, class TI>
+struct interaction_collector_shape2shape
+  : db::box_scanner_receiver2<TS, unsigned int, TI, unsigned int>
+{
+  typedef std::pair<std::pair<unsigned int, unsigned int>, std::pair<const TS *, const TI *> > interaction_type;
+
+  void add (const TS *ref1, unsigned int id1, const TI *ref2, unsigned int id2)
+  {
+    interactions.push_back (interaction_type (std::make_pair (id1, id2), std::make_pair (ref1, ref2)));
+  }
+
+  std::vector<interaction_type> interactions;
+};
+
+/**
+ *  @brief The minimum number of shapes for scanning interactions in parallel strips
+ */
+const size_t parallel_scan_threshold = 100000;
+
+/**
+ *  @brief Scans the shape-to-shape interactions, using multiple threads for large inputs
+ *
+ *  In the parallel case, the interactions are collected per strip and delivered to the
+ *  receiver afterwards in the order of the shape IDs, so the receiver does not need to be
+ *  thread-safe.
+ */
+template <class TS, class TI, class Rec>
+static void
+scan_shape2shape_interactions (db::box_scanner2<TS, unsigned int, TI, unsigned int> &scanner, Rec &rec, db::Coord dist, unsigned int threads)
+{
+  if (threads == 0 || scanner.size () < parallel_scan_threshold) {
+    scanner.process (rec, dist, db::box_convert<TS> (), db::box_convert<TI> ());
+    return;
+  }
+
+  std::vector<interaction_collector_shape2shape<TS, TI> > collectors (threads * 2);
+  std::vector<interaction_collector_shape2shape<TS, TI> *> collector_ptrs;
+  for (typename std::vector<interaction_collector_shape2shape<TS, TI> >::iterator c = collectors.begin (); c != collectors.end (); ++c) {
+    collector_ptrs.push_back (c.operator-> ());
+  }
+
+  scanner.process_parallel (collector_ptrs, threads, dist, db::box_convert<TS> (), db::box_convert<TI> ());
+
+  std::vector<typename interaction_collector_shape2shape<TS, TI>::interaction_type> interactions;
+  for (typename std::vector<interaction_collector_shape2shape<TS, TI> >::iterator c = collectors.begin (); c != collectors.end (); ++c) {
+    interactions.insert (interactions.end (), c->interactions.begin (), c->interactions.end ());
+    std::vector<typename interaction_collector_shape2shape<TS, TI>::interaction_type> ().swap (c->interactions);
+  }
+
+  std::sort (interactions.begin (), interactions.end ());
+
+  for (typename std::vector<typename interaction_collector_shape2shape<TS, TI>::interaction_type>::const_iterator i = interactions.begin (); i != interactions.end (); ++i) {
+    rec.add (i->second.first, i->first.first, i->second.second, i->first.second);
+  }
+}
+
 template <class TS, class TI>
 struct interaction_registration_shape1_scanner_combo
 {
@@ -1740,7 +2095,7 @@ local_processor<TS, TI, TR>::run_flat (const generic_shape_iterator<TS> &subject
               rec.same (s->first, iid);
             }
 
-            scanner.process (rec, dist, db::box_convert<TS> (), db::box_convert<TI> ());
+            scan_shape2shape_interactions (scanner, rec, dist, threads ());
 
           } else {
 
@@ -1749,7 +2104,7 @@ local_processor<TS, TI, TR>::run_flat (const generic_shape_iterator<TS> &subject
               scanner.insert2 (ii.operator-> (), interactions.next_id ());
             }
 
-            scanner.process (rec, dist, db::box_convert<TS> (), db::box_convert<TI> ());
+            scan_shape2shape_interactions (scanner, rec, dist, threads ());
 
           }
 
@@ -1815,7 +2170,7 @@ local_processor<TS, TI, TR>::run_flat (const generic_shape_iterator<TS> &subject
               rec.same (id, iid);
             }
 
-            scanner.process (rec, dist, db::box_convert<TS> (), db::box_convert<TI> ());
+            scan_shape2shape_interactions (scanner, rec, dist, threads ());
 
           } else {
 
@@ -1830,7 +2185,7 @@ local_processor<TS, TI, TR>::run_flat (const generic_shape_iterator<TS> &subject
               scanner.insert2 (ii.operator-> (), interactions.next_id ());
             }
 
-            scanner.process (rec, dist, db::box_convert<TS> (), db::box_convert<TI> ());
+            scan_shape2shape_interactions (scanner, rec, dist, threads ());
 
           }
 
@@ -1855,7 +2210,11 @@ local_processor<TS, TI, TR>::run_flat (const generic_shape_iterator<TS> &subject
 
     std::vector<std::unordered_set<TR> > result;
     result.resize (result_shapes.size ());
-    op->compute_local (mp_subject_layout, 0, interactions, result, this);
+
+    //  in flat mode without a layout, the subjects can be computed in parallel
+    if (mp_subject_layout || ! compute_local_in_tiles (this, op, (db::Layout *) 0, (db::Cell *) 0, interactions, result)) {
+      op->compute_local (mp_subject_layout, 0, interactions, result, this);
+    }
 
     for (std::vector<db::Shapes *>::const_iterator r = result_shapes.begin (); r != result_shapes.end (); ++r) {
       if (*r) {
@@ -227,7 +227,7 @@ public:
 
   db::local_processor_cell_context<TS, TI, TR> *find_context (const context_key_type &intruders);
   db::local_processor_cell_context<TS, TI, TR> *create (const context_key_type &intruders);
-  void compute_results (const local_processor_contexts<TS, TI, TR> &contexts, db::Cell *cell, const local_operation<TS, TI, TR> *op, const std::vector<unsigned int> &output_layer, const local_processor<TS, TI, TR> *proc);
+  void compute_results (const local_processor_contexts<TS, TI, TR> &contexts, db::Cell *cell, const local_operation<TS, TI, TR> *op, const std::vector<unsigned int> &output_layer, const local_processor<TS, TI, TR> *proc, tl::JobBase *tile_job = 0);
 
   size_t size () const
   {
@@ -392,12 +392,25 @@ public:
   }
 };
 
+/**
+ *  @brief The base class for the tasks of the result computation job
+ *
+ *  Besides the tasks computing the results of a cell, this job executes the tasks
+ *  computing the tiles of large cells.
+ */
+class DB_PUBLIC local_processor_result_computation_task_base
+  : public tl::Task
+{
+public:
+  virtual void perform () = 0;
+};
+
 template <class TS, class TI, class TR>
 class DB_PUBLIC local_processor_result_computation_task
-  : public tl::Task
+  : public local_processor_result_computation_task_base
 {
 public:
-  local_processor_result_computation_task (const local_processor<TS, TI, TR> *proc, local_processor_contexts<TS, TI, TR> &contexts, db::Cell *cell, local_processor_cell_contexts<TS, TI, TR> *cell_contexts, const local_operation<TS, TI, TR> *op, const std::vector<unsigned int> &output_layers);
+  local_processor_result_computation_task (const local_processor<TS, TI, TR> *proc, local_processor_contexts<TS, TI, TR> &contexts, db::Cell *cell, local_processor_cell_contexts<TS, TI, TR> *cell_contexts, const local_operation<TS, TI, TR> *op, const std::vector<unsigned int> &output_layers, tl::JobBase *tile_job = 0);
   void perform ();
 
 private:
@@ -407,6 +420,7 @@ private:
   local_processor_cell_contexts<TS, TI, TR> *mp_cell_contexts;
   const local_operation<TS, TI, TR> *mp_op;
   std::vector<unsigned int> m_output_layers;
+  tl::JobBase *mp_tile_job;
 };
 
 template <class TS, class TI, class TR>
@@ -422,7 +436,7 @@ public:
 
   void perform_task (tl::Task *task)
   {
-    static_cast<local_processor_result_computation_task<TS, TI, TR> *> (task)->perform ();
+    static_cast<local_processor_result_computation_task_base *> (task)->perform ();
   }
 };
 
@@ -506,6 +520,24 @@ public:
     return m_boolean_core;
   }
 
+  /**
+   *  @brief Sets the number of subject shapes above which a cell is split spatially
+   *
+   *  In multi-threaded mode, the results for cells with at least this number of subject
+   *  shapes are computed by distributing the subjects over tiles which are processed
+   *  in parallel. This only applies to operations computing the subjects one by one.
+   *  A value of 0 disables this feature.
+   */
+  void set_split_cell_threshold (size_t n)
+  {
+    m_split_cell_threshold = n;
+  }
+
+  size_t split_cell_threshold () const
+  {
+    return m_split_cell_threshold;
+  }
+
   void set_vars_owned (db::VariantsCollectorBase *vars)
   {
     mp_vars_owned.reset (vars);
@@ -536,6 +568,7 @@ private:
   unsigned int m_nthreads;
   size_t m_max_vertex_count;
   double m_area_ratio;
+  size_t m_split_cell_threshold;
   bool m_top_down;
   bool m_boolean_core;
   int m_base_verbosity;
@@ -581,7 +614,8 @@ private:
   size_t get_progress () const;
   void compute_contexts (db::local_processor_contexts<TS, TI, TR> &contexts, db::local_processor_cell_context<TS, TI, TR> *parent_context, db::Cell *subject_parent, db::Cell *subject_cell, const db::ICplxTrans &subject_cell_inst, const db::Cell *intruder_cell, const typename local_processor_cell_contexts<TS, TI, TR>::context_key_type &intruders, db::Coord dist, const std::map<unsigned int, Coord> &override_distance) const;
   void issue_compute_contexts (db::local_processor_contexts<TS, TI, TR> &contexts, db::local_processor_cell_context<TS, TI, TR> *parent_context, db::Cell *subject_parent, db::Cell *subject_cell, const db::ICplxTrans &subject_cell_inst, const db::Cell *intruder_cell, typename local_processor_cell_contexts<TS, TI, TR>::context_key_type &intruders, db::Coord dist, const std::map<unsigned int, Coord> &override_distance) const;
-  void compute_local_cell (const db::local_processor_contexts<TS, TI, TR> &contexts, db::Cell *subject_cell, const db::Cell *intruder_cell, const local_operation<TS, TI, TR> *op, const typename local_processor_cell_contexts<TS, TI, TR>::context_key_type &intruders, std::vector<std::unordered_set<TR> > &result) const;
+  void compute_local_cell (const db::local_processor_contexts<TS, TI, TR> &contexts, db::Cell *subject_cell, const db::Cell *intruder_cell, const local_operation<TS, TI, TR> *op, const typename local_processor_cell_contexts<TS, TI, TR>::context_key_type &intruders, std::vector<std::unordered_set<TR> > &result, tl::JobBase *tile_job) const;
+  bool is_split_cell (const db::local_processor_contexts<TS, TI, TR> &contexts, const db::Cell *subject_cell, const local_operation<TS, TI, TR> *op) const;
 
   bool subject_cell_is_breakout (db::cell_index_type ci) const
   {
@@ -385,7 +385,7 @@ struct context_sorter
 
 template <class TS, class TI, class TR>
 void
-local_processor_cell_contexts<TS, TI, TR>::compute_results (const local_processor_contexts<TS, TI, TR> &contexts, db::Cell *cell, const local_operation<TS, TI, TR> *op, const std::vector<unsigned int> &output_layers, const local_processor<TS, TI, TR> *proc)
+local_processor_cell_contexts<TS, TI, TR>::compute_results (const local_processor_contexts<TS, TI, TR> &contexts, db::Cell *cell, const local_operation<TS, TI, TR> *op, const std::vector<unsigned int> &output_layers, const local_processor<TS, TI, TR> *proc, tl::JobBase *tile_job)
 {
   CRONOLOGY_COMPUTE_BRACKET(event_compute_results)
 
@@ -426,7 +426,7 @@ local_processor_cell_contexts<TS, TI, TR>::compute_results (const local_processo
       }
 
       CRONOLOGY_COMPUTE_BRACKET(event_compute_local_cell)
-      proc->compute_local_cell (contexts, cell, mp_intruder_cell, op, *c->first, common);
+      proc->compute_local_cell (contexts, cell, mp_intruder_cell, op, *c->first, common, tile_job);
       first = false;
 
     } else {
@@ -443,7 +443,7 @@ local_processor_cell_contexts<TS, TI, TR>::compute_results (const local_processo
 
       {
         CRONOLOGY_COMPUTE_BRACKET(event_compute_local_cell)
-        proc->compute_local_cell (contexts, cell, mp_intruder_cell, op, *c->first, res);
+        proc->compute_local_cell (contexts, cell, mp_intruder_cell, op, *c->first, res, tile_job);
       }
 
       bool common_empty = true;
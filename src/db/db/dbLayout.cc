@@ -47,6 +47,7 @@
 #include "tlInternational.h"
 #include "tlProgress.h"
 #include "tlAssert.h"
+#include "tlFileUtils.h"
 
 
 namespace db
@@ -573,6 +574,63 @@ Layout::clear ()
   m_lib_proxy_map.clear ();
   m_cold_proxy_map.clear ();
   m_meta_info.clear ();
+
+  mp_cell_content_loader.reset (0);
+}
+
+void
+Layout::set_cell_content_loader (CellContentLoader *loader)
+{
+  if (loader == mp_cell_content_loader.get ()) {
+    return;
+  }
+
+  if (mp_cell_content_loader.get ()) {
+    load_pending_cells ();
+  }
+
+  mp_cell_content_loader.reset (loader);
+}
+
+void
+Layout::load_pending_cells () const
+{
+  if (! mp_cell_content_loader.get ()) {
+    return;
+  }
+
+  for (const_iterator c = begin (); c != end (); ++c) {
+    c->load_content ();
+  }
+}
+
+void
+Layout::release_source_file (const std::string &path)
+{
+  if (! mp_cell_content_loader.get () || mp_cell_content_loader->source_path ().empty () || ! tl::is_same_file (mp_cell_content_loader->source_path (), path)) {
+    return;
+  }
+
+  //  in transient mode, the loaded shapes may live in repositories owned by the loader - drop them and
+  //  load them again in non-transient mode before the loader is deleted
+  if (mp_cell_content_loader->is_transient ()) {
+    for (const_iterator c = begin (); c != end (); ++c) {
+      c->release_content ();
+    }
+    mp_cell_content_loader->set_transient (false);
+  }
+
+  set_cell_content_loader (0);
+}
+
+db::Shapes &
+CellContentLoader::shapes_for_layer (const db::Layout &layout, shapes_map &shapes, unsigned int layer)
+{
+  shapes_map::iterator s = shapes.find (layer);
+  if (s == shapes.end ()) {
+    s = shapes.insert (std::make_pair (layer, db::Shapes (layout.is_editable ()))).first;
+  }
+  return s->second;
 }
 
 Layout &
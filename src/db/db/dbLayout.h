@@ -50,6 +50,7 @@
 #include <string>
 #include <list>
 #include <vector>
+#include <memory>
 
 
 namespace db
@@ -438,6 +439,110 @@ struct DB_PUBLIC LayoutOrCellContextInfo
   bool has_meta_info () const;
 };
 
+/**
+ *  @brief An interface for delivering the shapes of cells on demand
+ *
+ *  Readers operating in lazy loading mode install an object of this kind in the
+ *  layout (see Layout::set_cell_content_loader) and mark the cells whose shapes are
+ *  not loaded yet (see Cell::set_content_pending). The shapes are requested from
+ *  the loader when they are accessed for the first time.
+ *
+ *  The layout serializes the calls of the loader.
+ */
+class DB_PUBLIC CellContentLoader
+{
+public:
+  typedef std::map<unsigned int, db::Shapes> shapes_map;
+  typedef std::map<unsigned int, db::Box> box_map;
+
+  /**
+   *  @brief Constructor
+   */
+  CellContentLoader () : m_transient (false) { }
+
+  /**
+   *  @brief Destructor
+   */
+  virtual ~CellContentLoader () { }
+
+  /**
+   *  @brief Sets a value indicating whether the loaded cell content is transient
+   *
+   *  In transient mode, the shapes of a cell may be dropped after use (see Cell::release_content)
+   *  and are loaded again if they are needed later. This mode is intended for streaming
+   *  applications such as format converters which only need the shapes of one cell at a time.
+   *  The layout must not be modified in transient mode.
+   */
+  void set_transient (bool f)
+  {
+    m_transient = f;
+  }
+
+  /**
+   *  @brief Gets a value indicating whether the loaded cell content is transient
+   */
+  bool is_transient () const
+  {
+    return m_transient;
+  }
+
+  /**
+   *  @brief Sets the path of the file the loader reads from
+   *
+   *  The loader usually keeps this file open. Before the layout is written to
+   *  the same file, the pending cells need to be loaded and the loader needs to
+   *  be removed (see Layout::release_source_file).
+   */
+  void set_source_path (const std::string &path)
+  {
+    m_source_path = path;
+  }
+
+  /**
+   *  @brief Gets the path of the file the loader reads from
+   */
+  const std::string &source_path () const
+  {
+    return m_source_path;
+  }
+
+  /**
+   *  @brief Delivers the shapes of the given cell
+   *
+   *  The implementation is supposed to fill the shapes per layer into "shapes".
+   *  These containers must not be attached to a cell and must be created with
+   *  the layout's editable mode. "shapes_for_layer" provides such containers.
+   *  This method is called once per pending cell.
+   */
+  virtual void load_cell_content (db::Layout &layout, db::cell_index_type ci, shapes_map &shapes) = 0;
+
+  /**
+   *  @brief Delivers the per-layer bounding boxes of the shapes of a pending cell
+   *
+   *  These boxes are used as long as the shapes are not loaded. They need to enclose
+   *  the shapes, but don't need to be exact. This method must not load the shapes.
+   */
+  virtual void cell_bboxes (db::cell_index_type ci, box_map &bboxes) const = 0;
+
+  /**
+   *  @brief Notifies the loader that the shapes of the given cell have been dropped
+   *
+   *  This method is called in transient mode after the shapes delivered by load_cell_content
+   *  have been released (see Cell::release_content). Loaders can use this method to free
+   *  resources held for this cell. The cell may be requested again later.
+   */
+  virtual void release_cell_content (db::cell_index_type /*ci*/) { }
+
+  /**
+   *  @brief Gets the shapes container for the given layer from the "shapes" argument of load_cell_content
+   */
+  static db::Shapes &shapes_for_layer (const db::Layout &layout, shapes_map &shapes, unsigned int layer);
+
+private:
+  bool m_transient;
+  std::string m_source_path;
+};
+
 /**
  *  @brief The layout object
  *
@@ -543,6 +648,50 @@ public:
    */
   void clear ();
 
+  /**
+   *  @brief Installs a cell content loader
+   *
+   *  The layout takes ownership over the loader object. Cells still waiting
+   *  for a previous loader are loaded before that loader is replaced.
+   *  Passing 0 removes the loader. See CellContentLoader for details.
+   */
+  void set_cell_content_loader (CellContentLoader *loader);
+
+  /**
+   *  @brief Gets the cell content loader or 0 if there is none
+   */
+  CellContentLoader *cell_content_loader () const
+  {
+    return mp_cell_content_loader.get ();
+  }
+
+  /**
+   *  @brief Gets the lock that serializes the cell content loader
+   *  Used internally
+   */
+  tl::Mutex &cell_content_lock () const
+  {
+    return m_cell_content_lock;
+  }
+
+  /**
+   *  @brief Loads the shapes of all cells whose shapes are still pending
+   *
+   *  This method can be used to fully load a layout which has been read in lazy
+   *  loading mode, e.g. before handing it over to multiple threads.
+   */
+  void load_pending_cells () const;
+
+  /**
+   *  @brief Releases the file the cell content loader reads from if it is the given one
+   *
+   *  If the cell content loader reads from the file given by "path", the pending cells
+   *  are loaded and the loader is removed. This method needs to be called before
+   *  the layout is written to a file, as the loader keeps the source file open
+   *  which prevents overwriting it on some systems.
+   */
+  void release_source_file (const std::string &path);
+
   /**
    *  @brief Gets the technology name the layout is associated with
    */
@@ -2202,6 +2351,9 @@ private:
   std::string m_tech_name;
   mutable tl::Mutex m_lock;
 
+  std::unique_ptr<CellContentLoader> mp_cell_content_loader;
+  mutable tl::Mutex m_cell_content_lock;
+
   /**
    *  @brief Sort the cells topologically
    *
@@ -28,6 +28,10 @@
 #include "dbLayoutUtils.h"
 #include "tlLog.h"
 #include "tlExceptions.h"
+#include "tlThreadedWorkers.h"
+
+#include <list>
+#include <memory>
 
 namespace db
 {
@@ -689,11 +693,563 @@ collect_paths (const db::Layout &, const db::Cell *c, unsigned int layer, unsign
   }
 }
 
+/**
+ *  @brief The shape differences for one layer of one cell
+ */
+struct LayerDifferences
+{
+  LayerDifferences ()
+    : layer_a (0), layer_b (0), is_valid_a (false), is_valid_b (false)
+  { }
+
+  unsigned int layer_a, layer_b;
+  bool is_valid_a, is_valid_b;
+  std::vector <std::pair <db::Polygon, db::properties_id_type> > polygons_a, polygons_b;
+  std::vector <std::pair <db::Path, db::properties_id_type> > paths_a, paths_b;
+  std::vector <std::pair <db::Text, db::properties_id_type> > texts_a, texts_b;
+  std::vector <std::pair <db::Box, db::properties_id_type> > boxes_a, boxes_b;
+  std::vector <std::pair <db::Edge, db::properties_id_type> > edges_a, edges_b;
+  std::vector <std::pair <db::EdgePair, db::properties_id_type> > edge_pairs_a, edge_pairs_b;
+};
+
+/**
+ *  @brief The instance and shape differences for one pair of common cells
+ *
+ *  The differences are computed by "compute_cell_differences" and reported to the
+ *  receiver by "deliver_cell_differences".
+ */
+struct CellDifferences
+{
+  CellDifferences (unsigned int _cci)
+    : cci (_cci), finished (false)
+  { }
+
+  unsigned int cci;
+  bool finished;
+  std::string error;
+  std::vector <db::CellInstArrayWithProperties> insts_a, insts_b;
+  std::vector <db::CellInstArrayWithProperties> anotb, bnota;
+  std::vector <LayerDifferences> layers;
+};
+
+/**
+ *  @brief The cell-independent data of a layout compare
+ */
+struct LayoutDiffContext
+{
+  LayoutDiffContext (const db::Layout &_a, const db::Layout &_b, unsigned int _flags, db::Coord _tolerance)
+    : a (_a), b (_b), flags (_flags), tolerance (_tolerance)
+  { }
+
+  const db::Layout &a;
+  const db::Layout &b;
+  unsigned int flags;
+  db::Coord tolerance;
+  std::map<db::LayerProperties, unsigned int, db::LPLogicalLessFunc> layers_a, layers_b;
+  std::vector<db::LayerProperties> common_layers;
+  std::vector <std::string> common_cells;
+  std::map <db::cell_index_type, db::cell_index_type> common_cell_indices_a, common_cell_indices_b;
+  std::vector <db::cell_index_type> common_cells_a, common_cells_b;
+};
+
+/**
+ *  @brief Computes the instance and shape differences of one pair of common cells
+ *
+ *  This function does not modify the layouts and can run in a worker thread.
+ */
+static void
+compute_cell_differences (const LayoutDiffContext &ctx, CellDifferences &cd)
+{
+  const db::Layout &a = ctx.a;
+  const db::Layout &b = ctx.b;
+  unsigned int flags = ctx.flags;
+  db::Coord tolerance = ctx.tolerance;
+  bool no_duplicates = (flags & layout_diff::f_ignore_duplicates);
+  bool use_fingerprints = ! (flags & layout_diff::f_no_fingerprints);
+
+  const db::Cell *cell_a = &a.cell (ctx.common_cells_a [cd.cci]);
+  const db::Cell *cell_b = &b.cell (ctx.common_cells_b [cd.cci]);
+
+  collect_insts (a, cell_a, flags, ctx.common_cell_indices_a, cd.insts_a, no_duplicates);
+  collect_insts (b, cell_b, flags, ctx.common_cell_indices_b, cd.insts_b, no_duplicates);
+
+  std::set_difference (cd.insts_a.begin (), cd.insts_a.end (), cd.insts_b.begin (), cd.insts_b.end (), std::back_inserter (cd.anotb));
+
+  rewrite_instances_to (cd.anotb, flags, ctx.common_cells_a);
+  collect_insts_of_unmapped_cells (a, cell_a, flags, ctx.common_cell_indices_a, cd.anotb, no_duplicates);
+
+  std::set_difference (cd.insts_b.begin (), cd.insts_b.end (), cd.insts_a.begin (), cd.insts_a.end (), std::back_inserter (cd.bnota));
+
+  rewrite_instances_to (cd.bnota, flags, ctx.common_cells_b);
+  collect_insts_of_unmapped_cells (b, cell_b, flags, ctx.common_cell_indices_b, cd.bnota, no_duplicates);
+
+  //  the full instance lists are reported in verbose mode only
+  if (! (flags & layout_diff::f_verbose)) {
+    std::vector <db::CellInstArrayWithProperties> ().swap (cd.insts_a);
+    std::vector <db::CellInstArrayWithProperties> ().swap (cd.insts_b);
+  }
+
+  cd.layers.resize (ctx.common_layers.size ());
+
+  for (size_t i = 0; i < ctx.common_layers.size (); ++i) {
+
+    LayerDifferences &ld = cd.layers [i];
+
+    std::map<db::LayerProperties, unsigned int, db::LPLogicalLessFunc>::const_iterator la = ctx.layers_a.find (ctx.common_layers [i]);
+    if (la != ctx.layers_a.end ()) {
+      ld.layer_a = la->second;
+      ld.is_valid_a = true;
+    }
+
+    std::map<db::LayerProperties, unsigned int, db::LPLogicalLessFunc>::const_iterator lb = ctx.layers_b.find (ctx.common_layers [i]);
+    if (lb != ctx.layers_b.end ()) {
+      ld.layer_b = lb->second;
+      ld.is_valid_b = true;
+    }
+
+    //  identical fingerprints indicate identical shapes, so we can skip the detailed compare
+    if (use_fingerprints && ld.is_valid_a && ld.is_valid_b && cell_a->content_fingerprint (ld.layer_a) == cell_b->content_fingerprint (ld.layer_b)) {
+      continue;
+    }
+
+    //  compare polygons
+
+    if (ld.is_valid_a) {
+      collect_polygons (a, cell_a, ld.layer_a, flags, ld.polygons_a);
+    }
+    if (ld.is_valid_b) {
+      collect_polygons (b, cell_b, ld.layer_b, flags, ld.polygons_b);
+    }
+
+    reduce (ld.polygons_a, ld.polygons_b, make_polygon_compare_func (tolerance), tolerance > 0, no_duplicates);
+
+    //  compare paths
+
+    if (! (flags & db::layout_diff::f_paths_as_polygons)) {
+
+      if (ld.is_valid_a) {
+        collect_paths (a, cell_a, ld.layer_a, flags, ld.paths_a);
+      }
+      if (ld.is_valid_b) {
+        collect_paths (b, cell_b, ld.layer_b, flags, ld.paths_b);
+      }
+
+      reduce (ld.paths_a, ld.paths_b, make_path_compare_func (tolerance), tolerance > 0, no_duplicates);
+
+    }
+
+    //  compare texts
+
+    if (ld.is_valid_a) {
+      collect_texts (a, cell_a, ld.layer_a, flags, ld.texts_a);
+    }
+    if (ld.is_valid_b) {
+      collect_texts (b, cell_b, ld.layer_b, flags, ld.texts_b);
+    }
+
+    reduce (ld.texts_a, ld.texts_b, make_text_compare_func (tolerance), tolerance > 0, no_duplicates);
+
+    //  compare boxes (unless this is done by the polygon compare code)
+
+    if (! (flags & db::layout_diff::f_boxes_as_polygons)) {
+
+      if (ld.is_valid_a) {
+        collect_boxes (a, cell_a, ld.layer_a, flags, ld.boxes_a);
+      }
+      if (ld.is_valid_b) {
+        collect_boxes (b, cell_b, ld.layer_b, flags, ld.boxes_b);
+      }
+
+      reduce (ld.boxes_a, ld.boxes_b, make_box_compare_func (tolerance), tolerance > 0, no_duplicates);
+
+    }
+
+    //  compare edges
+
+    if (ld.is_valid_a) {
+      collect_edges (a, cell_a, ld.layer_a, flags, ld.edges_a);
+    }
+    if (ld.is_valid_b) {
+      collect_edges (b, cell_b, ld.layer_b, flags, ld.edges_b);
+    }
+
+    reduce (ld.edges_a, ld.edges_b, make_edge_compare_func (tolerance), tolerance > 0, no_duplicates);
+
+    //  compare edge pairs
+
+    if (ld.is_valid_a) {
+      collect_edge_pairs (a, cell_a, ld.layer_a, flags, ld.edge_pairs_a);
+    }
+    if (ld.is_valid_b) {
+      collect_edge_pairs (b, cell_b, ld.layer_b, flags, ld.edge_pairs_b);
+    }
+
+    reduce (ld.edge_pairs_a, ld.edge_pairs_b, make_edge_pair_compare_func (tolerance), tolerance > 0, no_duplicates);
+
+  }
+}
+
+/**
+ *  @brief Reports the differences of one pair of common cells to the receiver
+ *
+ *  "differs" is set to true if differences are found. Returns false if the compare
+ *  can stop because differences have been found in silent mode.
+ */
 static bool
-do_compare_layouts (const db::Layout &a, const db::Cell *top_a, const db::Layout &b, const db::Cell *top_b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r)
+deliver_cell_differences (const LayoutDiffContext &ctx, const CellDifferences &cd, bool &differs, DifferenceReceiver &r)
+{
+  const db::Layout &a = ctx.a;
+  const db::Layout &b = ctx.b;
+  unsigned int flags = ctx.flags;
+  bool verbose = (flags & layout_diff::f_verbose);
+  unsigned int cci = cd.cci;
+
+  const db::Cell *cell_a = &a.cell (ctx.common_cells_a [cci]);
+  const db::Cell *cell_b = &b.cell (ctx.common_cells_b [cci]);
+
+  if (tl::verbosity () >= 30) {
+    tl::info << "Layout diff - compare cell " << a.cell_name (cell_a->cell_index ()) << " and " << b.cell_name (cell_b->cell_index ());
+  }
+
+  r.begin_cell (ctx.common_cells [cci], ctx.common_cells_a [cci], ctx.common_cells_b [cci]);
+
+  if ((flags & layout_diff::f_with_meta) != 0) {
+    std::map<std::string, std::pair<tl::Variant, tl::Variant> > mi;
+    auto ib = a.begin_meta (ctx.common_cells_a [cci]);
+    auto ie = a.end_meta (ctx.common_cells_a [cci]);
+    for (auto i = ib; i != ie; ++i) {
+      if (i->second.persisted) {
+        mi [a.meta_info_name (i->first)].first = i->second.value;
+      }
+    }
+    ib = b.begin_meta (ctx.common_cells_b [cci]);
+    ie = b.end_meta (ctx.common_cells_b [cci]);
+    for (auto i = ib; i != ie; ++i) {
+      if (i->second.persisted) {
+        mi [b.meta_info_name (i->first)].second = i->second.value;
+      }
+    }
+    for (auto i = mi.begin (); i != mi.end (); ++i) {
+      if (i->second.first != i->second.second) {
+        differs = true;
+        if (flags & layout_diff::f_silent) {
+          return false;
+        }
+        r.cell_meta_info_differs (i->first, i->second.first, i->second.second);
+      }
+    }
+  }
+
+  if (!verbose && cell_a->bbox () != cell_b->bbox ()) {
+    differs = true;
+    if (flags & layout_diff::f_silent) {
+      return false;
+    }
+    r.bbox_differs (cell_a->bbox (), cell_b->bbox ());
+  }
+
+  if (! cd.anotb.empty () || ! cd.bnota.empty ()) {
+
+    differs = true;
+
+    if (flags & layout_diff::f_silent) {
+      return false;
+    }
+
+    r.begin_inst_differences ();
+
+    if (verbose) {
+
+      r.instances_in_a (cd.insts_a, ctx.common_cells);
+      r.instances_in_b (cd.insts_b, ctx.common_cells);
+
+      r.instances_in_a_only (cd.anotb, a);
+      r.instances_in_b_only (cd.bnota, b);
+
+    }
+
+    r.end_inst_differences ();
+
+  }
+
+
+  //  compare layer by layer
+
+  for (size_t i = 0; i < ctx.common_layers.size (); ++i) {
+
+    const db::LayerProperties &cl = ctx.common_layers [i];
+    const LayerDifferences &ld = cd.layers [i];
+
+    if (tl::verbosity () >= 40) {
+      tl::info << "Layout diff - compare layer " << cl.to_string ();
+    }
+
+    r.begin_layer (cl, ld.layer_a, ld.is_valid_a, ld.layer_b, ld.is_valid_b);
+
+    if (!verbose && ld.is_valid_a && ld.is_valid_b && cell_a->bbox (ld.layer_a) != cell_b->bbox (ld.layer_b)) {
+      differs = true;
+      if (flags & layout_diff::f_silent) {
+        return false;
+      }
+      r.per_layer_bbox_differs (cell_a->bbox (ld.layer_a), cell_b->bbox (ld.layer_b));
+    }
+
+    if (!ld.polygons_a.empty () || !ld.polygons_b.empty ()) {
+      differs = true;
+      if (flags & layout_diff::f_silent) {
+        return false;
+      }
+      r.begin_polygon_differences ();
+      if (verbose) {
+        r.detailed_diff (ld.polygons_a, ld.polygons_b);
+      }
+      r.end_polygon_differences ();
+    }
+
+    if (!ld.paths_a.empty () || !ld.paths_b.empty ()) {
+      differs = true;
+      if (flags & layout_diff::f_silent) {
+        return false;
+      }
+      r.begin_path_differences ();
+      if (verbose) {
+        r.detailed_diff (ld.paths_a, ld.paths_b);
+      }
+      r.end_path_differences ();
+    }
+
+    if (!ld.texts_a.empty () || !ld.texts_b.empty ()) {
+      differs = true;
+      if (flags & layout_diff::f_silent) {
+        return false;
+      }
+      r.begin_text_differences ();
+      if (verbose) {
+        r.detailed_diff (ld.texts_a, ld.texts_b);
+      }
+      r.end_text_differences ();
+    }
+
+    if (!ld.boxes_a.empty () || !ld.boxes_b.empty ()) {
+      differs = true;
+      if (flags & layout_diff::f_silent) {
+        return false;
+      }
+      r.begin_box_differences ();
+      if (verbose) {
+        r.detailed_diff (ld.boxes_a, ld.boxes_b);
+      }
+      r.end_box_differences ();
+    }
+
+    if (!ld.edges_a.empty () || !ld.edges_b.empty ()) {
+      differs = true;
+      if (flags & layout_diff::f_silent) {
+        return false;
+      }
+      r.begin_edge_differences ();
+      if (verbose) {
+        r.detailed_diff (ld.edges_a, ld.edges_b);
+      }
+      r.end_edge_differences ();
+    }
+
+    if (!ld.edge_pairs_a.empty () || !ld.edge_pairs_b.empty ()) {
+      differs = true;
+      if (flags & layout_diff::f_silent) {
+        return false;
+      }
+      r.begin_edge_pair_differences ();
+      if (verbose) {
+        r.detailed_diff (ld.edge_pairs_a, ld.edge_pairs_b);
+      }
+      r.end_edge_pair_differences ();
+    }
+
+    r.end_layer ();
+
+  }
+
+  r.end_cell ();
+
+  return true;
+}
+
+class LayoutDiffJob;
+
+/**
+ *  @brief The task computing the differences for one pair of common cells
+ */
+class LayoutDiffTask
+  : public tl::Task
+{
+public:
+  LayoutDiffTask (CellDifferences *cd)
+    : mp_cd (cd)
+  { }
+
+  CellDifferences *cell_differences () const
+  {
+    return mp_cd;
+  }
+
+private:
+  CellDifferences *mp_cd;
+};
+
+/**
+ *  @brief The worker computing the cell differences
+ */
+class LayoutDiffWorker
+  : public tl::Worker
+{
+public:
+  LayoutDiffWorker (LayoutDiffJob *job)
+    : tl::Worker (), mp_job (job)
+  { }
+
+  virtual void perform_task (tl::Task *task);
+
+private:
+  LayoutDiffJob *mp_job;
+};
+
+/**
+ *  @brief A job that computes cell differences in the background
+ *
+ *  The results are delivered in the order they have been submitted.
+ */
+class LayoutDiffJob
+  : public tl::JobBase
+{
+public:
+  LayoutDiffJob (int nworkers, const LayoutDiffContext &ctx)
+    : tl::JobBase (nworkers), m_ctx (ctx)
+  {
+    m_max_pending = std::max (size_t (2), size_t (nworkers) * 4);
+  }
+
+  ~LayoutDiffJob ()
+  {
+    //  stop the workers before the results are deleted
+    terminate ();
+
+    for (auto c = m_pending.begin (); c != m_pending.end (); ++c) {
+      delete *c;
+    }
+    m_pending.clear ();
+  }
+
+  /**
+   *  @brief Gets the compare context
+   */
+  const LayoutDiffContext &context () const
+  {
+    return m_ctx;
+  }
+
+  /**
+   *  @brief Schedules the computation of the given cell differences
+   *
+   *  The job takes ownership over the object.
+   */
+  void submit (CellDifferences *cd)
+  {
+    m_pending.push_back (cd);
+
+    schedule (new LayoutDiffTask (cd));
+    if (! is_running ()) {
+      start ();
+    }
+  }
+
+  /**
+   *  @brief Returns true, if the maximum number of pending results is reached
+   */
+  bool is_full () const
+  {
+    return m_pending.size () >= m_max_pending;
+  }
+
+  /**
+   *  @brief Returns true, if there are pending results
+   */
+  bool has_pending () const
+  {
+    return ! m_pending.empty ();
+  }
+
+  /**
+   *  @brief Waits for the oldest result and takes it
+   *
+   *  The caller takes ownership over the object.
+   */
+  CellDifferences *take_next ()
+  {
+    tl_assert (! m_pending.empty ());
+
+    CellDifferences *cd = m_pending.front ();
+    m_pending.pop_front ();
+
+    m_lock.lock ();
+    while (! cd->finished) {
+      m_finished_condition.wait (&m_lock);
+    }
+    m_lock.unlock ();
+
+    return cd;
+  }
+
+  /**
+   *  @brief Called by the workers to indicate that a result is available
+   */
+  void finish (CellDifferences *cd)
+  {
+    m_lock.lock ();
+    cd->finished = true;
+    m_finished_condition.wakeAll ();
+    m_lock.unlock ();
+  }
+
+protected:
+  virtual tl::Worker *create_worker ()
+  {
+    return new LayoutDiffWorker (this);
+  }
+
+private:
+  const LayoutDiffContext &m_ctx;
+  std::list<CellDifferences *> m_pending;
+  size_t m_max_pending;
+  tl::Mutex m_lock;
+  tl::WaitCondition m_finished_condition;
+};
+
+void
+LayoutDiffWorker::perform_task (tl::Task *task)
+{
+  CellDifferences *cd = static_cast<LayoutDiffTask *> (task)->cell_differences ();
+
+  try {
+    compute_cell_differences (mp_job->context (), *cd);
+  } catch (tl::Exception &ex) {
+    cd->error = ex.msg ();
+  } catch (std::exception &ex) {
+    cd->error = ex.what ();
+  } catch (...) {
+    cd->error = tl::to_string (tr ("Unspecific error"));
+  }
+
+  mp_job->finish (cd);
+}
+
+static bool
+do_compare_layouts (const db::Layout &a, const db::Cell *top_a, const db::Layout &b, const db::Cell *top_b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r, int threads)
 {
   bool differs = false;
 
+  LayoutDiffContext ctx (a, b, flags, tolerance);
+
   if (fabs (a.dbu () - b.dbu ()) > 1e-9) {
     differs = true;
     if (flags & layout_diff::f_silent) {
@@ -725,18 +1281,15 @@ do_compare_layouts (const db::Layout &a, const db::Cell *top_a, const db::Layout
     }
   }
 
-  bool verbose = (flags & layout_diff::f_verbose);
-  bool no_duplicates = (flags & layout_diff::f_ignore_duplicates);
-
   //  compare layers
 
-  std::map<db::LayerProperties, unsigned int, db::LPLogicalLessFunc> layers_a;
-  std::map<db::LayerProperties, unsigned int, db::LPLogicalLessFunc> layers_b;
+  std::map<db::LayerProperties, unsigned int, db::LPLogicalLessFunc> &layers_a = ctx.layers_a;
+  std::map<db::LayerProperties, unsigned int, db::LPLogicalLessFunc> &layers_b = ctx.layers_b;
 
   collect_layers (a, layers_a, flags);
   collect_layers (b, layers_b, flags);
 
-  std::vector<db::LayerProperties> common_layers;
+  std::vector<db::LayerProperties> &common_layers = ctx.common_layers;
   std::vector<db::LayerProperties> layers_in_a_only;
   std::vector<db::LayerProperties> layers_in_b_only;
 
@@ -789,11 +1342,11 @@ do_compare_layouts (const db::Layout &a, const db::Cell *top_a, const db::Layout
   collect_cells (a, top_a, cells_a);
   collect_cells (b, top_b, cells_b);
 
-  std::vector <std::string> common_cells;
-  std::map <db::cell_index_type, db::cell_index_type> common_cell_indices_a;
-  std::vector <db::cell_index_type> common_cells_a;
-  std::map <db::cell_index_type, db::cell_index_type> common_cell_indices_b;
-  std::vector <db::cell_index_type> common_cells_b;
+  std::vector <std::string> &common_cells = ctx.common_cells;
+  std::map <db::cell_index_type, db::cell_index_type> &common_cell_indices_a = ctx.common_cell_indices_a;
+  std::vector <db::cell_index_type> &common_cells_a = ctx.common_cells_a;
+  std::map <db::cell_index_type, db::cell_index_type> &common_cell_indices_b = ctx.common_cell_indices_b;
+  std::vector <db::cell_index_type> &common_cells_b = ctx.common_cells_b;
 
   if (top_a && top_b && (flags & layout_diff::f_smart_cell_mapping)) {
 
@@ -915,305 +1468,54 @@ do_compare_layouts (const db::Layout &a, const db::Cell *top_a, const db::Layout
     tl::info << "Layout diff - cell by cell compare";
   }
 
-  std::vector <db::CellInstArrayWithProperties> insts_a;
-  std::vector <db::CellInstArrayWithProperties> insts_b;
-  std::vector <std::pair <db::Polygon, db::properties_id_type> > polygons_a;
-  std::vector <std::pair <db::Polygon, db::properties_id_type> > polygons_b;
-  std::vector <std::pair <db::Path, db::properties_id_type> > paths_a;
-  std::vector <std::pair <db::Path, db::properties_id_type> > paths_b;
-  std::vector <std::pair <db::Text, db::properties_id_type> > texts_a;
-  std::vector <std::pair <db::Text, db::properties_id_type> > texts_b;
-  std::vector <std::pair <db::Box, db::properties_id_type> > boxes_a;
-  std::vector <std::pair <db::Box, db::properties_id_type> > boxes_b;
-  std::vector <std::pair <db::Edge, db::properties_id_type> > edges_a;
-  std::vector <std::pair <db::Edge, db::properties_id_type> > edges_b;
-  std::vector <std::pair <db::EdgePair, db::properties_id_type> > edge_pairs_a;
-  std::vector <std::pair <db::EdgePair, db::properties_id_type> > edge_pairs_b;
+  unsigned int ncells = (unsigned int) common_cells.size ();
 
-  for (unsigned int cci = 0; cci < common_cells.size (); ++cci) {
+  if (threads > 0 && ncells > 1) {
 
-    const db::Cell *cell_a = &a.cell (common_cells_a [cci]);
-    const db::Cell *cell_b = &b.cell (common_cells_b [cci]);
+    //  the workers must not trigger bounding box updates
+    a.update ();
+    b.update ();
 
-    if (tl::verbosity () >= 30) {
-      tl::info << "Layout diff - compare cell " << a.cell_name (cell_a->cell_index ()) << " and " << b.cell_name (cell_b->cell_index ());
-    }
+    //  In threaded mode the differences are computed by the workers while the
+    //  receiver is fed in cell order from this thread.
+    LayoutDiffJob job (threads, ctx);
 
-    r.begin_cell (common_cells [cci], common_cells_a [cci], common_cells_b [cci]); 
+    unsigned int next_cci = 0;
+    while (next_cci < ncells || job.has_pending ()) {
 
-    if ((flags & layout_diff::f_with_meta) != 0) {
-      std::map<std::string, std::pair<tl::Variant, tl::Variant> > mi;
-      auto ib = a.begin_meta (common_cells_a [cci]);
-      auto ie = a.end_meta (common_cells_a [cci]);
-      for (auto i = ib; i != ie; ++i) {
-        if (i->second.persisted) {
-          mi [a.meta_info_name (i->first)].first = i->second.value;
-        }
-      }
-      ib = b.begin_meta (common_cells_b [cci]);
-      ie = b.end_meta (common_cells_b [cci]);
-      for (auto i = ib; i != ie; ++i) {
-        if (i->second.persisted) {
-          mi [b.meta_info_name (i->first)].second = i->second.value;
-        }
-      }
-      for (auto i = mi.begin (); i != mi.end (); ++i) {
-        if (i->second.first != i->second.second) {
-          differs = true;
-          if (flags & layout_diff::f_silent) {
-            return false;
-          }
-          r.cell_meta_info_differs (i->first, i->second.first, i->second.second);
-        }
+      while (next_cci < ncells && ! job.is_full ()) {
+        job.submit (new CellDifferences (next_cci));
+        ++next_cci;
       }
-    }
 
-    if (!verbose && cell_a->bbox () != cell_b->bbox ()) {
-      differs = true;
-      if (flags & layout_diff::f_silent) {
-        return false;
+      std::unique_ptr<CellDifferences> cd (job.take_next ());
+      if (! cd->error.empty ()) {
+        throw tl::Exception (cd->error);
       }
-      r.bbox_differs (cell_a->bbox (), cell_b->bbox ());
-    }
-
-    collect_insts (a, cell_a, flags, common_cell_indices_a, insts_a, no_duplicates);
-    collect_insts (b, cell_b, flags, common_cell_indices_b, insts_b, no_duplicates);
 
-    std::vector <db::CellInstArrayWithProperties> anotb;
-    std::set_difference (insts_a.begin (), insts_a.end (), insts_b.begin (), insts_b.end (), std::back_inserter (anotb));
-
-    rewrite_instances_to (anotb, flags, common_cells_a);
-    collect_insts_of_unmapped_cells (a, cell_a, flags, common_cell_indices_a, anotb, no_duplicates);
-
-    std::vector <db::CellInstArrayWithProperties> bnota;
-    std::set_difference (insts_b.begin (), insts_b.end (), insts_a.begin (), insts_a.end (), std::back_inserter (bnota));
-
-    rewrite_instances_to (bnota, flags, common_cells_b);
-    collect_insts_of_unmapped_cells (b, cell_b, flags, common_cell_indices_b, bnota, no_duplicates);
-
-    if (! anotb.empty () || ! bnota.empty ()) {
-
-      differs = true;
-
-      if (flags & layout_diff::f_silent) {
+      if (! deliver_cell_differences (ctx, *cd, differs, r)) {
         return false;
       }
 
-      r.begin_inst_differences ();
-
-      if (verbose) {
-
-        r.instances_in_a (insts_a, common_cells);
-        r.instances_in_b (insts_b, common_cells);
-
-        r.instances_in_a_only (anotb, a);
-        r.instances_in_b_only (bnota, b);
-
-      }
-
-      r.end_inst_differences ();
+      ++progress;
 
     }
 
+  } else {
 
-    //  compare layer by layer
-    
-    for (std::vector<db::LayerProperties>::const_iterator cl = common_layers.begin (); cl != common_layers.end (); ++cl) {
-
-      if (tl::verbosity () >= 40) {
-        tl::info << "Layout diff - compare layer " << cl->to_string ();
-      }
-
-      bool is_valid_a = false, is_valid_b = false;
-      unsigned int layer_a = 0, layer_b = 0;
-
-      if (layers_a.find (*cl) != layers_a.end ()) { 
-        layer_a = layers_a.find (*cl)->second;
-        is_valid_a = true;
-      }
-      
-      if (layers_b.find (*cl) != layers_b.end ()) {
-        layer_b = layers_b.find (*cl)->second;
-        is_valid_b = true;
-      }
-
-      r.begin_layer (*cl, layer_a, is_valid_a, layer_b, is_valid_b);
-
-      if (!verbose && is_valid_a && is_valid_b && cell_a->bbox (layer_a) != cell_b->bbox (layer_b)) {
-        differs = true;
-        if (flags & layout_diff::f_silent) {
-          return false;
-        }
-        r.per_layer_bbox_differs (cell_a->bbox (layer_a), cell_b->bbox (layer_b));
-      }
-
-      //  compare polygons
-
-      polygons_a.clear();
-      polygons_b.clear();
-      if (is_valid_a) {
-        collect_polygons (a, cell_a, layer_a, flags, polygons_a);
-      } 
-      if (is_valid_b) {
-        collect_polygons (b, cell_b, layer_b, flags, polygons_b);
-      }
-
-      reduce (polygons_a, polygons_b, make_polygon_compare_func (tolerance), tolerance > 0, no_duplicates);
-
-      if (!polygons_a.empty () || !polygons_b.empty ()) {
-        differs = true;
-        if (flags & layout_diff::f_silent) {
-          return false;
-        }
-        r.begin_polygon_differences ();
-        if (verbose) {
-          r.detailed_diff (polygons_a, polygons_b);
-        }
-        r.end_polygon_differences ();
-      }
-
-
-      //  compare paths
-
-      if (! (flags & db::layout_diff::f_paths_as_polygons)) {
-
-        paths_a.clear();
-        paths_b.clear();
-        if (is_valid_a) {
-          collect_paths (a, cell_a, layer_a, flags, paths_a);
-        }
-        if (is_valid_b) {
-          collect_paths (b, cell_b, layer_b, flags, paths_b);
-        }
-
-        reduce (paths_a, paths_b, make_path_compare_func (tolerance), tolerance > 0, no_duplicates);
-
-        if (!paths_a.empty () || !paths_b.empty ()) {
-          differs = true;
-          if (flags & layout_diff::f_silent) {
-            return false;
-          }
-          r.begin_path_differences ();
-          if (verbose) {
-            r.detailed_diff (paths_a, paths_b);
-          }
-          r.end_path_differences ();
-        }
-
-      }
-
-      //  compare texts
-
-      texts_a.clear();
-      texts_b.clear();
-      if (is_valid_a) {
-        collect_texts (a, cell_a, layer_a, flags, texts_a);
-      }
-      if (is_valid_b) {
-        collect_texts (b, cell_b, layer_b, flags, texts_b);
-      }
-
-      reduce (texts_a, texts_b, make_text_compare_func (tolerance), tolerance > 0, no_duplicates);
-
-      if (!texts_a.empty () || !texts_b.empty ()) {
-        differs = true;
-        if (flags & layout_diff::f_silent) {
-          return false;
-        }
-        r.begin_text_differences ();
-        if (verbose) {
-          r.detailed_diff (texts_a, texts_b);
-        }
-        r.end_text_differences ();
-      }
-
-      //  compare boxes (unless this is done by the polygon compare code)
-      
-      if (! (flags & db::layout_diff::f_boxes_as_polygons)) {
-
-        boxes_a.clear();
-        boxes_b.clear();
-        if (is_valid_a) {
-          collect_boxes (a, cell_a, layer_a, flags, boxes_a);
-        }
-        if (is_valid_b) {
-          collect_boxes (b, cell_b, layer_b, flags, boxes_b);
-        }
-
-        reduce (boxes_a, boxes_b, make_box_compare_func (tolerance), tolerance > 0, no_duplicates);
-
-        if (!boxes_a.empty () || !boxes_b.empty ()) {
-          differs = true;
-          if (flags & layout_diff::f_silent) {
-            return false;
-          }
-          r.begin_box_differences ();
-          if (verbose) {
-            r.detailed_diff (boxes_a, boxes_b);
-          }
-          r.end_box_differences ();
-        }
-
-      }
-
-      //  compare edges
-
-      edges_a.clear();
-      edges_b.clear();
-      if (is_valid_a) {
-        collect_edges (a, cell_a, layer_a, flags, edges_a);
-      }
-      if (is_valid_b) {
-        collect_edges (b, cell_b, layer_b, flags, edges_b);
-      }
-
-      reduce (edges_a, edges_b, make_edge_compare_func (tolerance), tolerance > 0, no_duplicates);
-
-      if (!edges_a.empty () || !edges_b.empty ()) {
-        differs = true;
-        if (flags & layout_diff::f_silent) {
-          return false;
-        }
-        r.begin_edge_differences ();
-        if (verbose) {
-          r.detailed_diff (edges_a, edges_b);
-        }
-        r.end_edge_differences ();
-      }
-
-      //  compare edge pairs
-
-      edge_pairs_a.clear();
-      edge_pairs_b.clear();
-      if (is_valid_a) {
-        collect_edge_pairs (a, cell_a, layer_a, flags, edge_pairs_a);
-      }
-      if (is_valid_b) {
-        collect_edge_pairs (b, cell_b, layer_b, flags, edge_pairs_b);
-      }
+    for (unsigned int cci = 0; cci < ncells; ++cci) {
 
-      reduce (edge_pairs_a, edge_pairs_b, make_edge_pair_compare_func (tolerance), tolerance > 0, no_duplicates);
+      CellDifferences cd (cci);
+      compute_cell_differences (ctx, cd);
 
-      if (!edge_pairs_a.empty () || !edge_pairs_b.empty ()) {
-        differs = true;
-        if (flags & layout_diff::f_silent) {
-          return false;
-        }
-        r.begin_edge_pair_differences ();
-        if (verbose) {
-          r.detailed_diff (edge_pairs_a, edge_pairs_b);
-        }
-        r.end_edge_pair_differences ();
+      if (! deliver_cell_differences (ctx, cd, differs, r)) {
+        return false;
       }
 
-      r.end_layer ();
+      ++progress;
 
     }
 
-    r.end_cell ();
-
-    ++progress;
-
   }
 
   return ! differs;
@@ -1221,15 +1523,15 @@ do_compare_layouts (const db::Layout &a, const db::Cell *top_a, const db::Layout
 }
 
 bool
-compare_layouts (const db::Layout &a, const db::Layout &b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r)
+compare_layouts (const db::Layout &a, const db::Layout &b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r, int threads)
 {
-  return do_compare_layouts (a, 0, b, 0, flags, tolerance, r);
+  return do_compare_layouts (a, 0, b, 0, flags, tolerance, r, threads);
 }
 
 bool
-compare_layouts (const db::Layout &a, db::cell_index_type top_a, const db::Layout &b, db::cell_index_type top_b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r)
+compare_layouts (const db::Layout &a, db::cell_index_type top_a, const db::Layout &b, db::cell_index_type top_b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r, int threads)
 {
-  return do_compare_layouts (a, &a.cell (top_a), b, &b.cell (top_b), flags, tolerance, r);
+  return do_compare_layouts (a, &a.cell (top_a), b, &b.cell (top_b), flags, tolerance, r, threads);
 }
 
 // -------------------------------------------------------------------------------
@@ -1760,21 +2062,21 @@ PrintingDifferenceReceiver::end_cell ()
 //  Implementation of a printing diff 
 
 bool
-compare_layouts (const db::Layout &a, const db::Layout &b, unsigned int flags, db::Coord tolerance, size_t max_count, bool print_properties)
+compare_layouts (const db::Layout &a, const db::Layout &b, unsigned int flags, db::Coord tolerance, size_t max_count, bool print_properties, int threads)
 {
   PrintingDifferenceReceiver r;
   r.set_max_count (max_count);
   r.set_print_properties (print_properties);
-  return compare_layouts (a, b, flags, tolerance, r);
+  return compare_layouts (a, b, flags, tolerance, r, threads);
 }
 
 bool
-compare_layouts (const db::Layout &a, db::cell_index_type top_a, const db::Layout &b, db::cell_index_type top_b, unsigned int flags, db::Coord tolerance, size_t max_count, bool print_properties)
+compare_layouts (const db::Layout &a, db::cell_index_type top_a, const db::Layout &b, db::cell_index_type top_b, unsigned int flags, db::Coord tolerance, size_t max_count, bool print_properties, int threads)
 {
   PrintingDifferenceReceiver r;
   r.set_max_count (max_count);
   r.set_print_properties (print_properties);
-  return compare_layouts (a, top_a, b, top_b, flags, tolerance, r);
+  return compare_layouts (a, top_a, b, top_b, flags, tolerance, r, threads);
 }
 
 }
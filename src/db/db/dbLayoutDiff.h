@@ -86,6 +86,9 @@ const unsigned int f_no_text_details = 0x800;
 //  Ignore duplicate instances or shapes
 const unsigned int f_ignore_duplicates = 0x1000;
 
+//  Don't skip layers with identical content fingerprints (see Cell::content_fingerprint)
+const unsigned int f_no_fingerprints = 0x2000;
+
 }
 
 /**
@@ -151,13 +154,14 @@ public:
  *  @param tolerance A coordinate tolerance to apply (0: exact match, 1: one DBU tolerance is allowed ...)
  *  @param max_count The maximum number of lines printed to the logger - the compare result will reflect all differences however
  *  @param print_properties If true, property differences are printed as well
+ *  @param threads The number of worker threads to use (0: compare in the calling thread)
  *
  *  If "max_count" is 0, no limitation is imposed. If it is 1, only a warning saying that the log has been abbreviated is printed.
  *  If "max_count" is >1, max_count-1 differences plus one warning about abbreviation is printed.
  *
  *  @return True, if the layouts are identical
  */
-bool DB_PUBLIC compare_layouts (const db::Layout &a, const db::Layout &b, unsigned int flags, db::Coord tolerance, size_t max_count = 0, bool print_properties = true);
+bool DB_PUBLIC compare_layouts (const db::Layout &a, const db::Layout &b, unsigned int flags, db::Coord tolerance, size_t max_count = 0, bool print_properties = true, int threads = 0);
 
 /**
  *  @brief Compare two layout objects
@@ -173,10 +177,11 @@ bool DB_PUBLIC compare_layouts (const db::Layout &a, const db::Layout &b, unsign
  *  @param tolerance A coordinate tolerance to apply (0: exact match, 1: one DBU tolerance is allowed ...)
  *  @param max_count The maximum number of lines printed to the logger - the compare result will reflect all differences however
  *  @param print_properties If true, property differences are printed as well
+ *  @param threads The number of worker threads to use (0: compare in the calling thread)
  *
  *  @return True, if the layouts are identical
  */
-bool DB_PUBLIC compare_layouts (const db::Layout &a, db::cell_index_type top_a, const db::Layout &b, db::cell_index_type top_b, unsigned int flags, db::Coord tolerance, size_t max_count = 0, bool print_properties = true);
+bool DB_PUBLIC compare_layouts (const db::Layout &a, db::cell_index_type top_a, const db::Layout &b, db::cell_index_type top_b, unsigned int flags, db::Coord tolerance, size_t max_count = 0, bool print_properties = true, int threads = 0);
 
 /**
  *  @brief Compare two layout objects with a custom receiver for the differences
@@ -190,10 +195,16 @@ bool DB_PUBLIC compare_layouts (const db::Layout &a, db::cell_index_type top_a,
  *  @param b The second input layout
  *  @param flags Flags to use for the comparison
  *  @param tolerance A coordinate tolerance to apply (0: exact match, 1: one DBU tolerance is allowed ...)
+ *  @param r The receiver for the differences
+ *  @param threads The number of worker threads to use (0: compare in the calling thread)
+ *
+ *  If "threads" is larger than 0, the instances and shapes of the cells are compared by
+ *  worker threads. The receiver is still called from the calling thread only and
+ *  the differences are delivered in the same order as in single-threaded mode.
  *
  *  @return True, if the layouts are identical
  */
-bool DB_PUBLIC compare_layouts (const db::Layout &a, const db::Layout &b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r);
+bool DB_PUBLIC compare_layouts (const db::Layout &a, const db::Layout &b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r, int threads = 0);
 
 /**
  *  @brief Compare two layouts using the specified top cells
@@ -201,7 +212,7 @@ bool DB_PUBLIC compare_layouts (const db::Layout &a, const db::Layout &b, unsign
  *  This function basically works like the previous one but allows one to specify top cells which
  *  are compared hierarchically.
  */
-bool DB_PUBLIC compare_layouts (const db::Layout &a, db::cell_index_type top_a, const db::Layout &b, db::cell_index_type top_b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r);
+bool DB_PUBLIC compare_layouts (const db::Layout &a, db::cell_index_type top_a, const db::Layout &b, db::cell_index_type top_b, unsigned int flags, db::Coord tolerance, DifferenceReceiver &r, int threads = 0);
 
 }
 
@@ -94,6 +94,7 @@ LayoutToNetlist::LayoutToNetlist ()
 LayoutToNetlist::~LayoutToNetlist ()
 {
   //  NOTE: do this in this order because of unregistration of the layers
+  mp_geometry_loader.reset (0);
   m_named_dls.clear ();
   m_dlrefs.clear ();
   mp_internal_dss.reset (0);
@@ -281,6 +282,7 @@ void LayoutToNetlist::reset_extracted ()
 {
   if (m_netlist_extracted) {
 
+    mp_geometry_loader.reset (0);
     m_net_clusters.clear ();
     mp_netlist.reset (0);
 
@@ -1422,6 +1424,8 @@ LayoutToNetlist::collect_shapes_of_pin (const local_cluster<db::NetShape> &c, co
     return;
   }
 
+  ensure_net_geometry (*other_net);
+
   auto cc_other = m_net_clusters.clusters_per_cell (other_net->circuit ()->cell_index ());
   auto c_other = cc_other.cluster_by_id (other_net->cluster_id ());
 
@@ -1462,6 +1466,8 @@ LayoutToNetlist::shapes_of_pin (const db::NetSubcircuitPinRef &pin, const db::IC
     return result;
   }
 
+  ensure_net_geometry (*net);
+
   auto cc = m_net_clusters.clusters_per_cell (net->circuit ()->cell_index ());
   auto c = cc.cluster_by_id (net->cluster_id ());
 
@@ -1484,14 +1490,20 @@ LayoutToNetlist::shapes_of_terminal (const db::NetTerminalRef &terminal, const d
     return result;
   }
 
+  const db::DeviceAbstract *da = terminal.device ()->device_abstract ();
+  size_t terminal_cluster_id = da->cluster_id_for_terminal (terminal.terminal_id ());
+
+  ensure_net_geometry (*net);
+  ensure_net_geometry (da->cell_index (), terminal_cluster_id);
+
   auto cc = m_net_clusters.clusters_per_cell (net->circuit ()->cell_index ());
   auto c = cc.cluster_by_id (net->cluster_id ());
 
   double dbu = internal_layout ()->dbu ();
   db::ICplxTrans d_trans = db::CplxTrans (dbu).inverted () * terminal.device ()->trans () * db::CplxTrans (dbu);
 
-  auto cc_other = m_net_clusters.clusters_per_cell (terminal.device ()->device_abstract ()->cell_index ());
-  auto c_other = cc_other.cluster_by_id (terminal.device ()->device_abstract ()->cluster_id_for_terminal (terminal.terminal_id ()));
+  auto cc_other = m_net_clusters.clusters_per_cell (da->cell_index ());
+  auto c_other = cc_other.cluster_by_id (terminal_cluster_id);
 
   std::map<unsigned int, std::vector<const db::NetShape *> > interacting;
   int soft = 0;
@@ -1522,6 +1534,8 @@ void LayoutToNetlist::shapes_of_net (const db::Net &net, unsigned int lid, bool
   const db::Circuit *circuit = net.circuit ();
   tl_assert (circuit != 0);
 
+  ensure_net_geometry (net);
+
   std::map<unsigned int, db::Shapes *> lmap;
   lmap [lid] = &to;
 
@@ -1534,6 +1548,8 @@ Coll *LayoutToNetlist::shapes_of_net_with_layer_index (const db::Net &net, unsig
   const db::Circuit *circuit = net.circuit ();
   tl_assert (circuit != 0);
 
+  ensure_net_geometry (net);
+
   std::unique_ptr<Coll> res (new Coll ());
   std::map<unsigned int, Coll *> lmap;
   lmap [lid] = res.get ();
@@ -1628,6 +1644,9 @@ db::Net *LayoutToNetlist::probe_net (const db::Region &of_region, const db::Poin
   }
   tl_assert (mp_netlist.get ());
 
+  //  probing needs the cluster shapes of all nets
+  ensure_geometry ();
+
   db::CplxTrans dbu_trans (internal_layout ()->dbu ());
   db::VCplxTrans dbu_trans_inv = dbu_trans.inverted ();
 
@@ -1792,6 +1811,8 @@ public:
 void
 LayoutToNetlist::compute_area_and_perimeter_of_net_shapes (db::cell_index_type ci, size_t cid, unsigned int layer_id, db::Polygon::area_type &area, db::Polygon::perimeter_type &perimeter) const
 {
+  ensure_net_geometry (ci, cid);
+
   db::EdgeProcessor ep;
 
   //  count vertices and reserve space
@@ -1818,6 +1839,8 @@ LayoutToNetlist::compute_area_and_perimeter_of_net_shapes (db::cell_index_type c
 db::Point
 LayoutToNetlist::get_shapes_of_net (db::cell_index_type ci, size_t cid, const std::vector<unsigned int> &layer_ids, bool merge, size_t max_polygons, db::Shapes &shapes, db::properties_id_type prop_id) const
 {
+  ensure_net_geometry (ci, cid);
+
   const db::Layout *layout = &dss ().const_layout (m_layout_index);
 
   //  count vertices and polygons and determine label reference point
@@ -1975,6 +1998,9 @@ db::Region LayoutToNetlist::antenna_check (const db::Region &gate, double gate_a
     throw tl::Exception (tl::to_string (tr ("The netlist has not been extracted yet")));
   }
 
+  //  the check needs the shapes of all nets
+  ensure_geometry ();
+
   db::Layout &ly = dss ().layout (m_layout_index);
   double dbu = ly.dbu ();
 
@@ -2137,6 +2163,9 @@ LayoutToNetlist::measure_net (const db::Region &primary, const std::map<std::str
     dbu = ly.dbu ();
   }
 
+  //  the measurement needs the shapes of all nets
+  ensure_geometry ();
+
   db::MeasureNetEval eval (this, dbu);
 
   for (auto v = variables.begin (); v != variables.end (); ++v) {
@@ -2201,22 +2230,26 @@ LayoutToNetlist::measure_net (const db::Region &primary, const std::map<std::str
 
 void LayoutToNetlist::save (const std::string &path, bool short_format)
 {
+  //  NOTE: the file we write may be the one we load the shapes from
+  ensure_geometry ();
+
   tl::OutputStream stream (path);
-  db::LayoutToNetlistStandardWriter writer (stream, short_format);
+  db::LayoutToNetlistStandardWriter writer (stream, short_format, db::l2n_binary_format::is_binary_path (path));
   set_filename (path);
   writer.write (this);
 }
 
-void LayoutToNetlist::load (const std::string &path)
+void LayoutToNetlist::load (const std::string &path, bool lazy)
 {
   tl::InputStream stream (path);
   db::LayoutToNetlistStandardReader reader (stream);
+  reader.set_lazy_geometry (lazy);
   set_filename (path);
   set_name (stream.filename ());
   reader.read (this);
 }
 
-db::LayoutToNetlist *LayoutToNetlist::create_from_file (const std::string &path)
+db::LayoutToNetlist *LayoutToNetlist::create_from_file (const std::string &path, bool lazy)
 {
   std::unique_ptr<db::LayoutToNetlist> db;
 
@@ -2224,22 +2257,84 @@ db::LayoutToNetlist *LayoutToNetlist::create_from_file (const std::string &path)
   std::string first_line;
   {
     tl::InputStream stream (path);
-    tl::TextInputStream text_stream (stream);
-    first_line = text_stream.get_line ();
+    if (db::BinaryTokenReader::detect (stream)) {
+      //  the first token of the binary format is the magic string of the text format
+      db::BinaryTokenReader token_reader (stream);
+      if (token_reader.next () && ! token_reader.is_int ()) {
+        first_line = token_reader.string_value ();
+      }
+    } else {
+      tl::TextInputStream text_stream (stream);
+      first_line = text_stream.get_line ();
+    }
   }
 
   if (first_line.find (db::lvs_std_format::keys<false>::lvs_magic_string) == 0) {
     db::LayoutVsSchematic *lvs_db = new db::LayoutVsSchematic ();
     db.reset (lvs_db);
-    lvs_db->load (path);
+    lvs_db->load (path, lazy);
   } else {
     db.reset (new db::LayoutToNetlist ());
-    db->load (path);
+    db->load (path, lazy);
   }
 
   return db.release ();
 }
 
+void LayoutToNetlist::set_net_geometry_loader (db::NetGeometryLoader *loader)
+{
+  mp_geometry_loader.reset (loader);
+}
+
+void LayoutToNetlist::ensure_net_geometry (const db::Net &net) const
+{
+  if (mp_geometry_loader.get () && net.circuit ()) {
+    ensure_net_geometry (net.circuit ()->cell_index (), net.cluster_id ());
+  }
+}
+
+void LayoutToNetlist::ensure_net_geometry (db::cell_index_type ci, size_t cluster_id) const
+{
+  if (! mp_geometry_loader.get ()) {
+    return;
+  }
+
+  db::LayoutToNetlist *non_const_this = const_cast<db::LayoutToNetlist *> (this);
+
+  //  load the cluster and all clusters connected to it in the child cells
+  std::set<std::pair<db::cell_index_type, size_t> > seen;
+  std::vector<std::pair<db::cell_index_type, size_t> > todo;
+  todo.push_back (std::make_pair (ci, cluster_id));
+
+  while (! todo.empty ()) {
+
+    std::pair<db::cell_index_type, size_t> c = todo.back ();
+    todo.pop_back ();
+
+    if (! seen.insert (c).second) {
+      continue;
+    }
+
+    mp_geometry_loader->load (non_const_this, c.first, c.second);
+
+    const db::connected_clusters<db::NetShape> &cc = m_net_clusters.clusters_per_cell (c.first);
+    const db::connected_clusters<db::NetShape>::connections_type &conn = cc.connections_for_cluster (c.second);
+    for (auto i = conn.begin (); i != conn.end (); ++i) {
+      todo.push_back (std::make_pair (i->inst_cell_index (), i->id ()));
+    }
+
+  }
+}
+
+void LayoutToNetlist::ensure_geometry () const
+{
+  if (mp_geometry_loader.get ()) {
+    //  NOTE: release the loader before loading, so recursive calls will not load again
+    std::unique_ptr<db::NetGeometryLoader> loader (mp_geometry_loader.release ());
+    loader->load_all (const_cast<db::LayoutToNetlist *> (this));
+  }
+}
+
 void LayoutToNetlist::set_generator (const std::string &g)
 {
   m_generator = g;
@@ -2373,6 +2468,7 @@ void
 NetBuilder::build_net (db::Cell &target_cell, const db::Net &net, const std::map<unsigned int, unsigned int> &lmap, NetPropertyMode net_prop_mode, const tl::Variant &netname_prop) const
 {
   prepare_build_nets ();
+  mp_source->ensure_net_geometry (net);
 
   double mag = mp_source->internal_layout ()->dbu () / mp_target->dbu ();
 
@@ -2390,6 +2486,7 @@ void
 NetBuilder::build_nets (const std::vector<const Net *> *nets, const std::map<unsigned int, unsigned int> &lmap, NetPropertyMode prop_mode, const tl::Variant &netname_prop) const
 {
   prepare_build_nets ();
+  mp_source->ensure_geometry ();
 
   std::set<const db::Net *> net_set;
   if (nets) {
@@ -36,6 +36,30 @@ namespace db
 {
 
 class NetlistBuilder;
+class LayoutToNetlist;
+
+/**
+ *  @brief An interface for loading net geometry on demand
+ *
+ *  Readers install an object implementing this interface when the
+ *  net shapes have not been read yet. See LayoutToNetlist::ensure_net_geometry.
+ */
+class DB_PUBLIC NetGeometryLoader
+{
+public:
+  NetGeometryLoader () { }
+  virtual ~NetGeometryLoader () { }
+
+  /**
+   *  @brief Loads the shapes of the given cluster, if they have not been loaded yet
+   */
+  virtual void load (db::LayoutToNetlist *l2n, db::cell_index_type ci, size_t cluster_id) = 0;
+
+  /**
+   *  @brief Loads all shapes not loaded yet
+   */
+  virtual void load_all (db::LayoutToNetlist *l2n) = 0;
+};
 
 /**
  *  @brief A generic framework for extracting netlists from layouts
@@ -1163,19 +1187,58 @@ public:
   /**
    *  @brief Loads the database from the given path
    *
+   *  If "lazy" is true, the net shapes are loaded on demand if the file format
+   *  supports this (binary format, not compressed). Net shapes are made available
+   *  by "ensure_net_geometry" or "ensure_geometry".
+   *
    *  This is a convenience method. The low-level functionality is the LayoutToNetlistReader.
    */
-  void load (const std::string &path);
+  void load (const std::string &path, bool lazy = false);
 
   /**
    *  @brief Creates a LayoutToNetlist object from a file
    *
    *  This method analyses the file and will create a LayoutToNetlist object
    *  or one of a derived class (specifically LayoutVsSchematic).
+   *  See "load" for the "lazy" parameter.
    *
    *  The returned object is new'd one and must be deleted by the caller.
    */
-  static db::LayoutToNetlist *create_from_file (const std::string &path);
+  static db::LayoutToNetlist *create_from_file (const std::string &path, bool lazy = false);
+
+  /**
+   *  @brief Installs a loader for net shapes not loaded yet
+   *
+   *  The LayoutToNetlist object takes ownership over the loader.
+   */
+  void set_net_geometry_loader (db::NetGeometryLoader *loader);
+
+  /**
+   *  @brief Gets a value indicating whether there are net shapes not loaded yet
+   */
+  bool has_pending_geometry () const
+  {
+    return mp_geometry_loader.get () != 0;
+  }
+
+  /**
+   *  @brief Makes sure the shapes of the given net cluster and its subclusters are loaded
+   *
+   *  Call this method before accessing the net clusters directly, i.e. through
+   *  recursive_cluster_shape_iterator. Methods like "shapes_of_net" call this
+   *  method internally.
+   */
+  void ensure_net_geometry (db::cell_index_type ci, size_t cluster_id) const;
+
+  /**
+   *  @brief Makes sure the shapes of the given net and its subnets are loaded
+   */
+  void ensure_net_geometry (const db::Net &net) const;
+
+  /**
+   *  @brief Makes sure all net shapes are loaded
+   */
+  void ensure_geometry () const;
 
   /**
    *  @brief Generate memory statistics
@@ -1243,6 +1306,7 @@ private:
   std::list<std::pair<tl::GlobPattern, tl::GlobPattern> > m_joined_net_names_per_cell;
   std::list<std::set<std::string> > m_joined_nets;
   std::list<std::pair<tl::GlobPattern, std::set<std::string> > > m_joined_nets_per_cell;
+  mutable std::unique_ptr<db::NetGeometryLoader> mp_geometry_loader;
 
   void init ();
   void ensure_netlist ();
@@ -21,6 +21,7 @@
 */
 
 #include "dbLayoutToNetlistFormatDefs.h"
+#include "tlString.h"
 
 namespace db
 {
@@ -104,4 +105,25 @@ namespace l2n_std_format
   DB_PUBLIC std::string ShortKeys::cat_key ("X");
 }
 
+namespace l2n_binary_format
+{
+  DB_PUBLIC const char *magic_string = "\x89KLayout-l2n-binary\r\n";
+
+  bool is_binary_path (const std::string &path)
+  {
+    std::string p = path;
+    if (p.size () > 3 && p.compare (p.size () - 3, 3, ".gz") == 0) {
+      p.erase (p.size () - 3);
+    }
+
+    std::string ext;
+    size_t dot = p.rfind ('.');
+    if (dot != std::string::npos) {
+      ext = tl::to_lower_case (std::string (p, dot));
+    }
+
+    return ext == ".l2nb" || ext == ".lvsb";
+  }
+}
+
 }
@@ -216,8 +216,68 @@ namespace db
  *    <token> ( [any]* ) |
  *    <float> |
  *    <quoted-string>
+ *
+ *  Binary variant:
+ *
+ *  For large databases, the same token stream can be written in a binary
+ *  form. It is selected by the ".l2nb" (L2N) or ".lvsb" (LVSDB) file suffix
+ *  (optionally followed by ".gz" for a deflated file). Readers detect the
+ *  binary form from its header, so the suffix is not required for reading.
+ *
+ *  The binary file starts with the magic bytes (see l2n_binary_format::magic_string),
+ *  followed by the format version as a variable-length unsigned integer.
+ *  The rest of the file is a sequence of tokens, each starting with a
+ *  variable-length unsigned integer (7 bits per byte, LSB first, bit 7 set
+ *  for continuation bytes). The lower two bits of this value give the kind
+ *  of token, the upper bits give the argument:
+ *
+ *    0: an integer value, zig-zag encoded in the argument
+ *    1: a reference to a string of the string table by index
+ *    2: a new string of the length given by the argument, followed by the
+ *       bytes. The string is appended to the string table.
+ *    3: a literal string of the length given by the argument, followed by
+ *       the bytes. The string is not entered into the string table.
+ *
+ *  The tokens are the ones of the text format. Keys and the opening bracket
+ *  are combined into one token (e.g. "N("). Comments and line breaks are not
+ *  stored. Point lists are written relative to the previous point as in the
+ *  text format, hence the small integer deltas need a few bytes only.
  */
 
+namespace l2n_binary_format
+{
+  /**
+   *  @brief The magic bytes at the beginning of a binary L2N or LVSDB file
+   */
+  extern DB_PUBLIC const char *magic_string;
+
+  /**
+   *  @brief The length of the magic bytes
+   */
+  const size_t magic_string_length = 21;
+
+  /**
+   *  @brief The binary format version written
+   */
+  const unsigned int version = 1;
+
+  /**
+   *  @brief Token kinds (lower two bits of the token header)
+   */
+  enum token_kind
+  {
+    IntToken = 0,
+    StringRefToken = 1,
+    NewStringToken = 2,
+    LiteralStringToken = 3
+  };
+
+  /**
+   *  @brief Returns true, if the given path indicates the binary format
+   */
+  DB_PUBLIC bool is_binary_path (const std::string &path);
+}
+
 namespace l2n_std_format
 {
   struct DB_PUBLIC ShortKeys
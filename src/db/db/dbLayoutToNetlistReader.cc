@@ -23,6 +23,11 @@
 #include "dbLayoutToNetlistReader.h"
 #include "dbLayoutToNetlistFormatDefs.h"
 
+#include <cstring>
+#include <cctype>
+#include <limits>
+#include <algorithm>
+
 namespace db
 {
 
@@ -33,6 +38,11 @@ namespace l2n_std_reader {
     m_has_brace = reader->test ("(");
   }
 
+  Brace::Brace (db::LayoutToNetlistStandardReader *reader, bool opened) : mp_reader (reader), m_checked (false), m_has_brace (opened)
+  {
+    //  .. nothing yet ..
+  }
+
   Brace::operator bool ()
   {
     if (! m_has_brace) {
@@ -56,42 +66,318 @@ namespace l2n_std_reader {
 
 }
 
+// -------------------------------------------------------------------------------------------
+//  BinaryTokenReader implementation
+
+BinaryTokenReader::BinaryTokenReader (tl::InputStream &stream)
+  : mp_stream (&stream), mp_string (""), m_int (0), m_is_int (false), m_tokens (0), m_token_pos (0), m_replay (false)
+{
+  uint64_t version = 0;
+  if (! read_uint (version)) {
+    throw tl::Exception (tl::to_string (tr ("Unexpected end of file in binary L2N/LVSDB header")));
+  }
+  if (version > l2n_binary_format::version) {
+    throw tl::Exception (tl::sprintf (tl::to_string (tr ("Binary L2N/LVSDB format version %d is too new for this build")), int (version)));
+  }
+}
+
+bool
+BinaryTokenReader::detect (tl::InputStream &stream)
+{
+  const char *h = stream.get (l2n_binary_format::magic_string_length);
+  if (! h) {
+    return false;
+  } else if (memcmp (h, l2n_binary_format::magic_string, l2n_binary_format::magic_string_length) == 0) {
+    return true;
+  } else {
+    stream.unget (l2n_binary_format::magic_string_length);
+    return false;
+  }
+}
+
+bool
+BinaryTokenReader::read_uint (uint64_t &v)
+{
+  v = 0;
+  unsigned int shift = 0;
+
+  while (true) {
+
+    const char *cp = mp_stream->get (1);
+    if (! cp) {
+      if (shift > 0) {
+        throw tl::Exception (tl::to_string (tr ("Unexpected end of file in binary L2N/LVSDB data")));
+      }
+      return false;
+    }
+
+    unsigned char c = (unsigned char) *cp;
+    if (shift > 63) {
+      throw tl::Exception (tl::to_string (tr ("Integer value overflow in binary L2N/LVSDB data")));
+    }
+    v |= uint64_t (c & 0x7f) << shift;
+    if ((c & 0x80) == 0) {
+      return true;
+    }
+    shift += 7;
+
+  }
+}
+
+const char *
+BinaryTokenReader::read_bytes (size_t n)
+{
+  if (n == 0) {
+    return "";
+  }
+
+  const char *cp = mp_stream->get (n);
+  if (! cp) {
+    throw tl::Exception (tl::to_string (tr ("Unexpected end of file in binary L2N/LVSDB data")));
+  }
+  return cp;
+}
+
+void
+BinaryTokenReader::seek (size_t pos)
+{
+  mp_stream->seek (pos);
+  m_token_pos = pos;
+}
+
+bool
+BinaryTokenReader::next ()
+{
+  m_token_pos = mp_stream->pos ();
+
+  uint64_t h = 0;
+  if (! read_uint (h)) {
+    return false;
+  }
+
+  ++m_tokens;
+
+  unsigned int kind = (unsigned int) (h & 3);
+  h >>= 2;
+
+  if (kind == (unsigned int) l2n_binary_format::IntToken) {
+
+    m_is_int = true;
+    m_int = (h & 1) != 0 ? -int64_t (h >> 1) - 1 : int64_t (h >> 1);
+
+  } else if (kind == (unsigned int) l2n_binary_format::StringRefToken) {
+
+    if (h >= uint64_t (m_string_table.size ())) {
+      throw tl::Exception (tl::to_string (tr ("Invalid string reference in binary L2N/LVSDB data")));
+    }
+
+    m_is_int = false;
+    mp_string = m_string_table [h].c_str ();
+
+  } else if (kind == (unsigned int) l2n_binary_format::NewStringToken) {
+
+    const char *cp = read_bytes (h);
+
+    m_is_int = false;
+
+    if (m_replay) {
+      //  the string table is complete already
+      m_literal.assign (cp, h);
+      mp_string = m_literal.c_str ();
+    } else {
+      m_string_table.push_back (std::string (cp, h));
+      mp_string = m_string_table.back ().c_str ();
+    }
+
+  } else {
+
+    const char *cp = read_bytes (h);
+    m_literal.assign (cp, h);
+
+    m_is_int = false;
+    mp_string = m_literal.c_str ();
+
+  }
+
+  return true;
+}
+
+// -------------------------------------------------------------------------------------------
+//  LayoutToNetlistStandardReader implementation
+
 typedef l2n_std_format::keys<true> skeys;
 typedef l2n_std_format::keys<false> lkeys;
 
 LayoutToNetlistStandardReader::LayoutToNetlistStandardReader (tl::InputStream &stream)
-  : m_stream (stream), m_path (stream.absolute_file_path ()), m_dbu (0.0),
+  : m_stream (stream), m_int_pending (false), m_lazy_geometry (false), m_path (stream.absolute_file_path ()), m_dbu (0.0),
     m_progress (tl::to_string (tr ("Reading L2N database")), 1000)
 {
-  m_progress.set_format (tl::to_string (tr ("%.0fk lines")));
+  if (BinaryTokenReader::detect (stream)) {
+    mp_binary.reset (new BinaryTokenReader (stream));
+    m_progress.set_format (tl::to_string (tr ("%.0fk tokens")));
+  } else {
+    m_progress.set_format (tl::to_string (tr ("%.0fk lines")));
+  }
+
   m_progress.set_format_unit (1000.0);
   m_progress.set_unit (100000.0);
 
   skip ();
 }
 
+LayoutToNetlistStandardReader::~LayoutToNetlistStandardReader ()
+{
+  //  .. nothing yet ..
+}
+
+std::string
+LayoutToNetlistStandardReader::location ()
+{
+  if (mp_binary) {
+    return tl::sprintf (tl::to_string (tr ("token: %lu")), (unsigned long) mp_binary->token_count ());
+  } else {
+    return tl::sprintf (tl::to_string (tr ("line: %d")), int (m_stream.line_number ()));
+  }
+}
+
+void
+LayoutToNetlistStandardReader::fetch_token ()
+{
+  //  NOTE: in the binary format, a token takes the role of a line. Comments are
+  //  stored as tokens starting with "#" and a blank or "#%" (the magic string).
+  //  Other tokens starting with "#" are variant values.
+  while (mp_binary && ! m_int_pending && m_ex.at_end ()) {
+
+    if (! mp_binary->next ()) {
+      m_ex = tl::Extractor ();
+      return;
+    }
+
+    if ((mp_binary->token_count () % 1000) == 0) {
+      m_progress.set (mp_binary->token_count ());
+    }
+
+    if (mp_binary->is_int ()) {
+      m_int_pending = true;
+    } else {
+      const char *cp = mp_binary->string_value ();
+      if (cp [0] != '#' || (cp [1] != '%' && ! isspace (cp [1]) && cp [1] != 0)) {
+        m_ex = tl::Extractor (cp);
+      }
+    }
+
+  }
+}
+
+int64_t
+LayoutToNetlistStandardReader::take_int ()
+{
+  m_int_pending = false;
+  return mp_binary->int_value ();
+}
+
+bool
+LayoutToNetlistStandardReader::can_defer_geometry (db::LayoutToNetlist *l2n) const
+{
+  return m_lazy_geometry && l2n && mp_binary && mp_binary->is_random_access () && ! m_path.empty ();
+}
+
+l2n_std_reader::TokenPosition
+LayoutToNetlistStandardReader::token_position ()
+{
+  if (m_int_pending) {
+    return l2n_std_reader::TokenPosition (mp_binary->token_pos (), 0, true);
+  } else if (! m_ex.at_end ()) {
+    return l2n_std_reader::TokenPosition (mp_binary->token_pos (), m_ex.get () - mp_binary->string_value (), true);
+  } else {
+    return l2n_std_reader::TokenPosition (mp_binary->stream_pos (), 0, false);
+  }
+}
+
+void
+LayoutToNetlistStandardReader::set_token_position (const l2n_std_reader::TokenPosition &pos)
+{
+  mp_binary->seek (pos.pos);
+
+  m_int_pending = false;
+  m_ex = tl::Extractor ();
+
+  if (pos.in_token) {
+    if (! mp_binary->next ()) {
+      throw tl::Exception (tl::to_string (tr ("Unexpected end of file in binary L2N/LVSDB data")));
+    }
+    if (mp_binary->is_int ()) {
+      m_int_pending = true;
+    } else {
+      m_ex = tl::Extractor (mp_binary->string_value () + pos.offset);
+    }
+  }
+}
+
+bool
+LayoutToNetlistStandardReader::test_int_token (const std::string &token)
+{
+  //  NOTE: numeric keys (e.g. the short LVS status keys) are stored as integer tokens
+  const char *cp = token.c_str ();
+  if ((*cp == '-' || isdigit (*cp)) && tl::to_string (mp_binary->int_value ()) == token) {
+    take_int ();
+    return true;
+  } else {
+    return false;
+  }
+}
+
 bool
 LayoutToNetlistStandardReader::test (const std::string &token)
 {
   skip ();
+  if (m_int_pending) {
+    return test_int_token (token);
+  }
   return ! at_end () && m_ex.test (token.c_str ());
 }
 
 void
 LayoutToNetlistStandardReader::expect (const std::string &token)
 {
+  fetch_token ();
+  if (m_int_pending) {
+    if (! test_int_token (token)) {
+      throw tl::Exception (tl::sprintf (tl::to_string (tr ("Expected '%s', got an integer value")), token));
+    }
+    return;
+  }
   m_ex.expect (token.c_str ());
 }
 
 void
 LayoutToNetlistStandardReader::read_word_or_quoted (std::string &s)
 {
-  m_ex.read_word_or_quoted (s);
+  fetch_token ();
+  if (m_int_pending) {
+    s = tl::to_string (take_int ());
+  } else {
+    m_ex.read_word_or_quoted (s);
+  }
+}
+
+template <class T>
+static T int_from_binary (int64_t v)
+{
+  if (v < int64_t (std::numeric_limits<T>::min ()) || v > int64_t (std::numeric_limits<T>::max ())) {
+    throw tl::Exception (tl::to_string (tr ("Integer value out of range")));
+  }
+  return T (v);
 }
 
 int
 LayoutToNetlistStandardReader::read_int ()
 {
+  fetch_token ();
+  if (m_int_pending) {
+    return int_from_binary<int> (take_int ());
+  }
+
   int i = 0;
   m_ex.read (i);
   return i;
@@ -100,6 +386,12 @@ LayoutToNetlistStandardReader::read_int ()
 bool
 LayoutToNetlistStandardReader::try_read_int (int &i)
 {
+  fetch_token ();
+  if (m_int_pending) {
+    i = int_from_binary<int> (take_int ());
+    return true;
+  }
+
   i = 0;
   return m_ex.try_read (i);
 }
@@ -107,6 +399,11 @@ LayoutToNetlistStandardReader::try_read_int (int &i)
 db::Coord
 LayoutToNetlistStandardReader::read_coord ()
 {
+  fetch_token ();
+  if (m_int_pending) {
+    return int_from_binary<db::Coord> (take_int ());
+  }
+
   db::Coord i = 0;
   m_ex.read (i);
   return i;
@@ -115,21 +412,46 @@ LayoutToNetlistStandardReader::read_coord ()
 double
 LayoutToNetlistStandardReader::read_double ()
 {
+  fetch_token ();
+  if (m_int_pending) {
+    return double (take_int ());
+  }
+
   double d = 0;
   m_ex.read (d);
   return d;
 }
 
+void
+LayoutToNetlistStandardReader::read_variant (tl::Variant &v)
+{
+  fetch_token ();
+  if (m_int_pending) {
+    v = tl::Variant (take_int ());
+  } else {
+    m_ex.read (v);
+  }
+}
+
 bool
 LayoutToNetlistStandardReader::at_end ()
 {
   skip ();
-  return (m_ex.at_end () && m_stream.at_end ());
+  if (mp_binary) {
+    return ! m_int_pending && m_ex.at_end ();
+  } else {
+    return (m_ex.at_end () && m_stream.at_end ());
+  }
 }
 
 void
 LayoutToNetlistStandardReader::skip ()
 {
+  if (mp_binary) {
+    fetch_token ();
+    return;
+  }
+
   while (m_ex.at_end () || *m_ex.skip () == '#') {
     if (m_stream.at_end ()) {
       m_ex = tl::Extractor ();
@@ -146,7 +468,14 @@ void LayoutToNetlistStandardReader::skip_element ()
   std::string s;
   double f;
 
-  if (m_ex.try_read_word (s)) {
+  fetch_token ();
+
+  if (m_int_pending) {
+
+    //  skip integer value
+    take_int ();
+
+  } else if (m_ex.try_read_word (s)) {
 
     //  skip bracket elements after token key
     Brace br (this);
@@ -309,7 +638,7 @@ void LayoutToNetlistStandardReader::do_read (db::LayoutToNetlist *l2n)
   try {
     read_netlist (0, l2n);
   } catch (tl::Exception &ex) {
-    throw tl::Exception (tl::sprintf (tl::to_string (tr ("%s in line: %d of %s")), ex.msg (), m_stream.line_number (), m_path));
+    throw tl::Exception (tl::sprintf (tl::to_string (tr ("%s in %s of %s")), ex.msg (), location (), m_path));
   }
 }
 
@@ -348,6 +677,10 @@ void LayoutToNetlistStandardReader::read_netlist (db::Netlist *netlist, db::Layo
 
   db::LayoutLocker layout_locker (l2n ? l2n->internal_layout () : 0);
 
+  if (can_defer_geometry (l2n)) {
+    mp_geometry_loader.reset (new l2n_std_reader::LazyNetGeometryLoader (m_path));
+  }
+
   while (nested ? *nested : ! at_end ()) {
 
     if (test (skeys::version_key) || test (lkeys::version_key)) {
@@ -662,7 +995,16 @@ void LayoutToNetlistStandardReader::read_netlist (db::Netlist *netlist, db::Layo
   }
 
   if (l2n) {
+
     l2n->set_netlist_extracted ();
+
+    if (mp_geometry_loader.get () && ! mp_geometry_loader->empty ()) {
+      //  NOTE: the LVS reader continues reading, so we need a copy of the string table
+      mp_geometry_loader->set_string_table (mp_binary->string_table ());
+      l2n->set_net_geometry_loader (mp_geometry_loader.release ());
+    }
+    mp_geometry_loader.reset (0);
+
   }
 
   if (version > 1) {
@@ -698,8 +1040,8 @@ LayoutToNetlistStandardReader::read_property (db::NetlistObject *obj)
   Brace br (this);
 
   tl::Variant k, v;
-  m_ex.read (k);
-  m_ex.read (v);
+  read_variant (k);
+  read_variant (v);
 
   if (obj) {
     obj->set_property (k, v);
@@ -845,8 +1187,25 @@ LayoutToNetlistStandardReader::read_net (db::Netlist * /*netlist*/, db::LayoutTo
     db::local_cluster<db::NetShape> &lc = *cc.insert ();
     net->set_cluster_id (lc.id ());
 
-    db::Cell &cell = l2n->internal_layout ()->cell (circuit->cell_index ());
-    read_geometries (net, br, l2n, lc, cell);
+    if (mp_geometry_loader.get ()) {
+
+      //  lazy mode: remember where the shapes are and read the properties only
+      mp_geometry_loader->add (circuit->cell_index (), lc.id (), token_position ());
+
+      while (br) {
+        if (test (skeys::property_key) || test (lkeys::property_key)) {
+          read_property (net);
+        } else if (at_end ()) {
+          throw tl::Exception (tl::to_string (tr ("Unexpected end of file (polygon, text or rect expected)")));
+        } else {
+          skip_element ();
+        }
+      }
+
+    } else {
+      db::Cell &cell = l2n->internal_layout ()->cell (circuit->cell_index ());
+      read_geometries (net, br, l2n, lc, cell);
+    }
 
   }
 
@@ -1322,4 +1681,171 @@ LayoutToNetlistStandardReader::read_abstract_terminal (db::LayoutToNetlist *l2n,
   br.done ();
 }
 
+// -------------------------------------------------------------------------------------------
+//  LazyNetGeometryLoader implementation
+
+namespace l2n_std_reader
+{
+
+/**
+ *  @brief A stream delegate delivering the loader's private copy of the file as a memory block
+ *
+ *  The memory block makes the stream random-access.
+ */
+class FileCopyStream
+  : public tl::InputMemoryStream
+{
+public:
+  FileCopyStream (const std::string &data, const std::string &path)
+    : tl::InputMemoryStream (data.c_str (), data.size ()), mp_data (data.c_str ()), m_size (data.size ()), m_path (path)
+  { }
+
+  virtual const char *memory_block (size_t &size) const
+  {
+    size = m_size;
+    return mp_data;
+  }
+
+  virtual std::string source () const
+  {
+    return m_path;
+  }
+
+private:
+  const char *mp_data;
+  size_t m_size;
+  std::string m_path;
+};
+
+LazyNetGeometryLoader::LazyNetGeometryLoader (const std::string &path)
+  : m_path (path)
+{
+  //  NOTE: we read the shapes from a private copy of the file: files are saved in place,
+  //  so the file may change or get truncated while we still need the data. A memory
+  //  mapping of the file would also keep it from being written on some systems.
+  {
+    tl::InputStream is (m_path);
+    m_data = is.read_all ();
+  }
+
+  mp_stream.reset (new tl::InputStream (new FileCopyStream (m_data, m_path)));
+}
+
+LazyNetGeometryLoader::~LazyNetGeometryLoader ()
+{
+  //  .. nothing yet ..
+}
+
+void
+LazyNetGeometryLoader::add (db::cell_index_type ci, size_t cluster_id, const TokenPosition &pos)
+{
+  m_positions.insert (std::make_pair (std::make_pair (ci, cluster_id), pos));
+}
+
+void
+LazyNetGeometryLoader::set_string_table (const std::vector<std::string> &string_table)
+{
+  m_string_table = string_table;
+}
+
+void
+LazyNetGeometryLoader::load (db::LayoutToNetlist *l2n, db::cell_index_type ci, size_t cluster_id)
+{
+  if (m_positions.find (std::make_pair (ci, cluster_id)) != m_positions.end ()) {
+    replay (l2n, std::vector<std::pair<db::cell_index_type, size_t> > (1, std::make_pair (ci, cluster_id)));
+  }
+}
+
+void
+LazyNetGeometryLoader::load_all (db::LayoutToNetlist *l2n)
+{
+  if (m_positions.empty ()) {
+    return;
+  }
+
+  tl::SelfTimer timer (tl::verbosity () >= 21, tl::to_string (tr ("Loading net shapes: ")) + m_path);
+
+  //  read in file order
+  std::vector<std::pair<size_t, std::pair<db::cell_index_type, size_t> > > sorted;
+  sorted.reserve (m_positions.size ());
+  for (auto p = m_positions.begin (); p != m_positions.end (); ++p) {
+    sorted.push_back (std::make_pair (p->second.pos, p->first));
+  }
+  std::sort (sorted.begin (), sorted.end ());
+
+  std::vector<std::pair<db::cell_index_type, size_t> > clusters;
+  clusters.reserve (sorted.size ());
+  for (auto s = sorted.begin (); s != sorted.end (); ++s) {
+    clusters.push_back (s->second);
+  }
+
+  replay (l2n, clusters);
+}
+
+void
+LazyNetGeometryLoader::replay (db::LayoutToNetlist *l2n, const std::vector<std::pair<db::cell_index_type, size_t> > &clusters)
+{
+  mp_stream->seek (0);
+
+  db::LayoutToNetlistStandardReader reader (*mp_stream);
+  if (! reader.mp_binary.get () || ! reader.mp_binary->is_random_access ()) {
+    throw tl::Exception (tl::to_string (tr ("File has changed while loading net shapes: ")) + m_path);
+  }
+
+  //  lend the string table to the reader
+  reader.mp_binary->swap_string_table (m_string_table);
+  reader.mp_binary->set_replay (true);
+
+  try {
+
+    db::LayoutLocker layout_locker (l2n->internal_layout ());
+
+    for (auto c = clusters.begin (); c != clusters.end (); ++c) {
+      auto p = m_positions.find (*c);
+      if (p != m_positions.end ()) {
+        TokenPosition pos = p->second;
+        m_positions.erase (p);
+        load_at (reader, l2n, c->first, c->second, pos);
+      }
+    }
+
+  } catch (...) {
+    reader.mp_binary->swap_string_table (m_string_table);
+    throw;
+  }
+
+  reader.mp_binary->swap_string_table (m_string_table);
+
+  //  release the file copy once everything is loaded
+  if (m_positions.empty ()) {
+    mp_stream.reset (0);
+    std::string ().swap (m_data);
+  }
+}
+
+void
+LazyNetGeometryLoader::load_at (db::LayoutToNetlistStandardReader &reader, db::LayoutToNetlist *l2n, db::cell_index_type ci, size_t cluster_id, const TokenPosition &pos)
+{
+  db::connected_clusters<db::NetShape> &cc = l2n->net_clusters ().clusters_per_cell (ci);
+  db::local_cluster<db::NetShape> &lc = const_cast<db::local_cluster<db::NetShape> &> (cc.cluster_by_id (cluster_id));
+  db::Cell &cell = l2n->internal_layout ()->cell (ci);
+
+  try {
+
+    reader.set_token_position (pos);
+
+    //  the opening bracket of the net has been read already
+    LayoutToNetlistStandardReader::Brace br (&reader, true);
+    reader.read_geometries (0, br, l2n, lc, cell);
+
+  } catch (tl::Exception &ex) {
+    throw tl::Exception (tl::sprintf (tl::to_string (tr ("%s in %s of %s")), ex.msg (), reader.location (), m_path));
+  }
+
+  //  the cluster's shapes have changed
+  cc.invalidate ();
+}
+
+}
+
 }
@@ -30,6 +30,8 @@
 #include "tlStream.h"
 #include "tlProgress.h"
 
+#include <memory>
+
 namespace db {
 
 class LayoutToNetlistStandardReader;
@@ -41,6 +43,11 @@ namespace l2n_std_reader {
   public:
     Brace (db::LayoutToNetlistStandardReader *reader);
 
+    /**
+     *  @brief Creates a brace object for which the opening bracket has already been read
+     */
+    Brace (db::LayoutToNetlistStandardReader *reader, bool opened);
+
     operator bool ();
     void done ();
 
@@ -55,8 +62,150 @@ namespace l2n_std_reader {
     bool m_has_brace;
   };
 
+  /**
+   *  @brief Describes a position inside a binary token stream
+   *
+   *  "pos" is the file position of a token. If "in_token" is true, reading
+   *  continues with the token at "pos", skipping "offset" characters of it.
+   *  Otherwise, reading continues with the next token at "pos".
+   */
+  struct TokenPosition
+  {
+    TokenPosition ()
+      : pos (0), offset (0), in_token (false)
+    { }
+
+    TokenPosition (size_t _pos, size_t _offset, bool _in_token)
+      : pos (_pos), offset (_offset), in_token (_in_token)
+    { }
+
+    size_t pos, offset;
+    bool in_token;
+  };
+
+  class LazyNetGeometryLoader;
+
 }
 
+/**
+ *  @brief A helper class reading the binary token stream
+ *
+ *  This class delivers the tokens of a binary L2N/LVSDB file
+ *  (see dbLayoutToNetlistFormatDefs.h). Use "detect" to check for the
+ *  binary format and to consume the magic bytes before creating the reader.
+ */
+class DB_PUBLIC BinaryTokenReader
+{
+public:
+  BinaryTokenReader (tl::InputStream &stream);
+
+  /**
+   *  @brief Checks whether the stream is a binary one
+   *  If it is, the magic bytes are consumed and true is returned.
+   *  Otherwise, the stream is left unchanged.
+   */
+  static bool detect (tl::InputStream &stream);
+
+  /**
+   *  @brief Reads the next token
+   *  Returns false if the end of the stream is reached.
+   */
+  bool next ();
+
+  bool is_int () const
+  {
+    return m_is_int;
+  }
+
+  int64_t int_value () const
+  {
+    return m_int;
+  }
+
+  const char *string_value () const
+  {
+    return mp_string;
+  }
+
+  size_t token_count () const
+  {
+    return m_tokens;
+  }
+
+  /**
+   *  @brief Gets the file position of the current token
+   */
+  size_t token_pos () const
+  {
+    return m_token_pos;
+  }
+
+  /**
+   *  @brief Gets the file position of the next token
+   */
+  size_t stream_pos () const
+  {
+    return mp_stream->pos ();
+  }
+
+  /**
+   *  @brief Gets a value indicating whether the reader can be positioned with "seek"
+   */
+  bool is_random_access () const
+  {
+    return mp_stream->is_random_access ();
+  }
+
+  /**
+   *  @brief Positions the reader at the given file position
+   *  The position must be the start of a token.
+   */
+  void seek (size_t pos);
+
+  /**
+   *  @brief Gets the string table collected so far
+   */
+  const std::vector<std::string> &string_table () const
+  {
+    return m_string_table;
+  }
+
+  /**
+   *  @brief Swaps the string table with the given one
+   */
+  void swap_string_table (std::vector<std::string> &string_table)
+  {
+    m_string_table.swap (string_table);
+  }
+
+  /**
+   *  @brief Puts the reader into replay mode
+   *
+   *  In replay mode, the reader reads portions of a file again which it
+   *  has read before. The string table needs to be the one of the first read
+   *  (see "swap_string_table"). New strings are not added to the string table
+   *  in this mode.
+   */
+  void set_replay (bool replay)
+  {
+    m_replay = replay;
+  }
+
+private:
+  tl::InputStream *mp_stream;
+  std::vector<std::string> m_string_table;
+  std::string m_literal;
+  const char *mp_string;
+  int64_t m_int;
+  bool m_is_int;
+  size_t m_tokens;
+  size_t m_token_pos;
+  bool m_replay;
+
+  bool read_uint (uint64_t &v);
+  const char *read_bytes (size_t n);
+};
+
 class LayoutToNetlist;
 class Circuit;
 class Cell;
@@ -99,11 +248,35 @@ public:
   };
 
   LayoutToNetlistStandardReader (tl::InputStream &stream);
+  ~LayoutToNetlistStandardReader ();
 
   void do_read (db::LayoutToNetlist *l2n);
 
+  /**
+   *  @brief Enables lazy loading of net shapes
+   *
+   *  In lazy mode, the shapes of the nets are not read immediately. Instead,
+   *  a loader is installed in the LayoutToNetlist object which reads the shapes
+   *  on demand (see LayoutToNetlist::ensure_net_geometry).
+   *  Lazy mode requires a binary file which can be positioned cheaply (i.e.
+   *  not compressed). Otherwise, all shapes are read immediately.
+   */
+  void set_lazy_geometry (bool lazy)
+  {
+    m_lazy_geometry = lazy;
+  }
+
+  /**
+   *  @brief Gets a value indicating whether lazy loading of net shapes is enabled
+   */
+  bool lazy_geometry () const
+  {
+    return m_lazy_geometry;
+  }
+
 protected:
   friend class l2n_std_reader::Brace;
+  friend class l2n_std_reader::LazyNetGeometryLoader;
   typedef l2n_std_reader::Brace Brace;
 
   void read_netlist (Netlist *netlist, db::LayoutToNetlist *l2n, Brace *nested = 0, std::map<const db::Circuit *, ObjectMap> *map_per_circuit = 0);
@@ -138,12 +311,18 @@ protected:
   bool try_read_int (int &i);
   db::Coord read_coord ();
   double read_double ();
+  void read_variant (tl::Variant &v);
   bool at_end ();
   void skip ();
   void skip_element ();
+  std::string location ();
 
 private:
   tl::TextInputStream m_stream;
+  std::unique_ptr<BinaryTokenReader> mp_binary;
+  bool m_int_pending;
+  bool m_lazy_geometry;
+  std::unique_ptr<l2n_std_reader::LazyNetGeometryLoader> mp_geometry_loader;
   std::string m_path;
   std::string m_line;
   double m_dbu;
@@ -161,6 +340,12 @@ private:
   db::Polygon read_polygon ();
   db::Box read_rect ();
   void read_geometries (db::NetlistObject *obj, Brace &br, db::LayoutToNetlist *l2n, db::local_cluster<NetShape> &lc, db::Cell &cell);
+  void fetch_token ();
+  int64_t take_int ();
+  bool test_int_token (const std::string &token);
+  bool can_defer_geometry (db::LayoutToNetlist *l2n) const;
+  l2n_std_reader::TokenPosition token_position ();
+  void set_token_position (const l2n_std_reader::TokenPosition &pos);
   db::Point read_point ();
   void read_message_entry (db::LogEntryData &data);
   bool read_message_cell (std::string &cell_name);
@@ -169,6 +354,46 @@ private:
   bool read_message_cat (std::string &category_name, std::string &category_description);
 };
 
+namespace l2n_std_reader {
+
+  /**
+   *  @brief The loader for the net shapes in lazy mode
+   *
+   *  This loader keeps a private copy of the file and reads the net shapes
+   *  from the positions recorded in the first pass. The copy is the compact
+   *  file data - the net shapes are only built when they are needed.
+   */
+  class DB_PUBLIC LazyNetGeometryLoader
+    : public db::NetGeometryLoader
+  {
+  public:
+    LazyNetGeometryLoader (const std::string &path);
+    ~LazyNetGeometryLoader ();
+
+    void add (db::cell_index_type ci, size_t cluster_id, const TokenPosition &pos);
+    void set_string_table (const std::vector<std::string> &string_table);
+
+    bool empty () const
+    {
+      return m_positions.empty ();
+    }
+
+    virtual void load (db::LayoutToNetlist *l2n, db::cell_index_type ci, size_t cluster_id);
+    virtual void load_all (db::LayoutToNetlist *l2n);
+
+  private:
+    std::string m_path;
+    std::map<std::pair<db::cell_index_type, size_t>, TokenPosition> m_positions;
+    std::vector<std::string> m_string_table;
+    std::string m_data;
+    std::unique_ptr<tl::InputStream> mp_stream;
+
+    void load_at (db::LayoutToNetlistStandardReader &reader, db::LayoutToNetlist *l2n, db::cell_index_type ci, size_t cluster_id, const TokenPosition &pos);
+    void replay (db::LayoutToNetlist *l2n, const std::vector<std::pair<db::cell_index_type, size_t> > &clusters);
+  };
+
+}
+
 }
 
 #endif
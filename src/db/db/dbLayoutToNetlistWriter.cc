@@ -50,23 +50,111 @@ void LayoutToNetlistWriterBase::write (const db::LayoutToNetlist *l2n)
   do_write (l2n);
 }
 
+// -------------------------------------------------------------------------------------------
+//  BinaryTokenWriter implementation
+
+BinaryTokenWriter::BinaryTokenWriter (tl::OutputStream &s)
+  : mp_stream (&s)
+{
+  mp_stream->put (l2n_binary_format::magic_string, l2n_binary_format::magic_string_length);
+  write_uint (l2n_binary_format::version);
+}
+
+void BinaryTokenWriter::write_uint (uint64_t v)
+{
+  char buffer [10];
+  size_t n = 0;
+
+  while (v >= 0x80) {
+    buffer [n++] = char ((v & 0x7f) | 0x80);
+    v >>= 7;
+  }
+  buffer [n++] = char (v);
+
+  mp_stream->put (buffer, n);
+}
+
+void BinaryTokenWriter::write_bytes (uint64_t header, const std::string &s)
+{
+  write_uint (header);
+  mp_stream->put (s.c_str (), s.size ());
+}
+
+static bool is_canonical_int (const std::string &s, int64_t &v)
+{
+  const char *cp = s.c_str ();
+  bool neg = (*cp == '-');
+  if (neg) {
+    ++cp;
+  }
+
+  //  NOTE: leading zeroes and "-0" are not canonical and are kept as strings.
+  //  18 digits are safe with respect to the 2 bit shift of the token header.
+  size_t ndigits = s.size () - (neg ? 1 : 0);
+  if (ndigits < 1 || ndigits > 18 || (*cp == '0' && (ndigits > 1 || neg))) {
+    return false;
+  }
+
+  v = 0;
+  for ( ; *cp; ++cp) {
+    if (*cp < '0' || *cp > '9') {
+      return false;
+    }
+    v = v * 10 + int64_t (*cp - '0');
+  }
+
+  if (neg) {
+    v = -v;
+  }
+  return true;
+}
+
+void BinaryTokenWriter::write (const std::string &token)
+{
+  //  strings longer than this are not entered into the string table
+  const size_t max_table_string_length = 32;
+
+  int64_t v = 0;
+  if (is_canonical_int (token, v)) {
+
+    uint64_t zz = v < 0 ? ((uint64_t (-(v + 1)) << 1) | 1) : (uint64_t (v) << 1);
+    write_uint ((zz << 2) | uint64_t (l2n_binary_format::IntToken));
+
+  } else if (token.size () > max_table_string_length) {
+
+    write_bytes ((uint64_t (token.size ()) << 2) | uint64_t (l2n_binary_format::LiteralStringToken), token);
+
+  } else {
+
+    auto st = m_string_table.find (token);
+    if (st != m_string_table.end ()) {
+      write_uint ((st->second << 2) | uint64_t (l2n_binary_format::StringRefToken));
+    } else {
+      uint64_t id = uint64_t (m_string_table.size ());
+      m_string_table.insert (std::make_pair (token, id));
+      write_bytes ((uint64_t (token.size ()) << 2) | uint64_t (l2n_binary_format::NewStringToken), token);
+    }
+
+  }
+}
+
 // -------------------------------------------------------------------------------------------
 //  TokenizedOutput implementation
 
-TokenizedOutput::TokenizedOutput (tl::OutputStream &s)
-  : mp_stream (&s), mp_parent (0), m_first (true), m_inline (false), m_newline (false), m_indent (-1)
+TokenizedOutput::TokenizedOutput (tl::OutputStream &s, BinaryTokenWriter *binary)
+  : mp_stream (&s), mp_binary (binary), mp_parent (0), m_first (true), m_inline (false), m_newline (false), m_indent (-1)
 {
   //  .. nothing yet ..
 }
 
 TokenizedOutput::TokenizedOutput (tl::OutputStream &s, const std::string &token)
-  : mp_stream (&s), mp_parent (0), m_first (true), m_inline (false), m_newline (false), m_indent (0)
+  : mp_stream (&s), mp_binary (0), mp_parent (0), m_first (true), m_inline (false), m_newline (false), m_indent (0)
 {
   stream () << token << "(";
 }
 
 TokenizedOutput::TokenizedOutput (tl::OutputStream &s, int indent, const std::string &token)
-  : mp_stream (&s), mp_parent (0), m_first (true), m_inline (false), m_newline (false)
+  : mp_stream (&s), mp_binary (0), mp_parent (0), m_first (true), m_inline (false), m_newline (false)
 {
   m_indent = indent;
   for (int i = 0; i < m_indent; ++i) {
@@ -76,15 +164,26 @@ TokenizedOutput::TokenizedOutput (tl::OutputStream &s, int indent, const std::st
 }
 
 TokenizedOutput::TokenizedOutput (TokenizedOutput &output, const std::string &token, bool inl)
-  : mp_stream (&output.stream ()), mp_parent (&output), m_first (true), m_inline (inl), m_newline (false)
+  : mp_stream (&output.stream ()), mp_binary (output.mp_binary), mp_parent (&output), m_first (true), m_inline (inl), m_newline (false)
 {
   m_indent = output.indent () + 1;
-  output.emit_sep ();
-  stream () << token << "(";
+  if (mp_binary) {
+    mp_binary->write (token + "(");
+  } else {
+    output.emit_sep ();
+    stream () << token << "(";
+  }
 }
 
 TokenizedOutput::~TokenizedOutput ()
 {
+  if (mp_binary) {
+    if (m_indent >= 0) {
+      mp_binary->write (")");
+    }
+    return;
+  }
+
   if (m_newline) {
     for (int i = 0; i < m_indent; ++i) {
       stream () << indent1;
@@ -117,7 +216,12 @@ void TokenizedOutput::emit_sep ()
 
 TokenizedOutput &TokenizedOutput::operator<< (const std::string &s)
 {
-  if (s == endl) {
+  if (mp_binary) {
+    //  line breaks are not stored in the binary format
+    if (! s.empty () && s != endl) {
+      mp_binary->write (s);
+    }
+  } else if (s == endl) {
     m_newline = true;
     stream () << s;
   } else if (! s.empty ()) {
@@ -177,6 +281,16 @@ std_writer_impl<Keys>::std_writer_impl (tl::OutputStream &stream, double dbu, co
   m_progress.set_unit (1024 * 1024);
 }
 
+template <class Keys>
+void std_writer_impl<Keys>::set_binary (bool binary)
+{
+  if (binary) {
+    mp_binary_writer.reset (new BinaryTokenWriter (*mp_stream));
+  } else {
+    mp_binary_writer.reset (0);
+  }
+}
+
 template <class Keys>
 std::string std_writer_impl<Keys>::message_to_s (const std::string &msg)
 {
@@ -247,7 +361,7 @@ void std_writer_impl<Keys>::write (const db::LayoutToNetlist *l2n)
     mp_l2n = l2n;
 
     {
-      TokenizedOutput stream (*mp_stream);
+      TokenizedOutput stream (*mp_stream, mp_binary_writer.get ());
       write (false, stream, 0);
     }
 
@@ -928,8 +1042,8 @@ template class std_writer_impl<l2n_std_format::keys<true> >;
 // -------------------------------------------------------------------------------------------
 //  LayoutToNetlistStandardWriter implementation
 
-LayoutToNetlistStandardWriter::LayoutToNetlistStandardWriter (tl::OutputStream &stream, bool short_version)
-  : mp_stream (&stream), m_short_version (short_version)
+LayoutToNetlistStandardWriter::LayoutToNetlistStandardWriter (tl::OutputStream &stream, bool short_version, bool binary)
+  : mp_stream (&stream), m_short_version (short_version), m_binary (binary)
 {
   //  .. nothing yet ..
 }
@@ -943,10 +1057,14 @@ void LayoutToNetlistStandardWriter::do_write (const db::LayoutToNetlist *l2n)
     throw tl::Exception (tl::to_string (tr ("Can't write annotated netlist before the layout has been loaded")));
   }
 
+  //  make sure all net shapes are present
+  l2n->ensure_geometry ();
+
   double dbu = l2n->internal_layout ()->dbu ();
 
-  if (m_short_version) {
+  if (m_short_version || m_binary) {
     l2n_std_format::std_writer_impl<l2n_std_format::keys<true> > writer (*mp_stream, dbu);
+    writer.set_binary (m_binary);
     writer.write (l2n);
   } else {
     l2n_std_format::std_writer_impl<l2n_std_format::keys<false> > writer (*mp_stream, dbu);
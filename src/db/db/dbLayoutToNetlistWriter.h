@@ -32,6 +32,9 @@
 #include "tlStream.h"
 #include "tlProgress.h"
 
+#include <unordered_map>
+#include <memory>
+
 namespace db
 {
 
@@ -46,6 +49,33 @@ class LayoutToNetlist;
 class NetShape;
 class LogEntryData;
 
+/**
+ *  @brief A helper class producing the binary token stream
+ *
+ *  This class writes the tokens of the L2N/LVSDB format in the binary
+ *  representation (see dbLayoutToNetlistFormatDefs.h). The header is
+ *  written on construction.
+ */
+class DB_PUBLIC BinaryTokenWriter
+{
+public:
+  BinaryTokenWriter (tl::OutputStream &stream);
+
+  /**
+   *  @brief Writes a token
+   *  Integer values are stored as such, short strings are entered into the
+   *  string table and longer strings are written literally.
+   */
+  void write (const std::string &token);
+
+private:
+  tl::OutputStream *mp_stream;
+  std::unordered_map<std::string, uint64_t> m_string_table;
+
+  void write_uint (uint64_t v);
+  void write_bytes (uint64_t header, const std::string &s);
+};
+
 /**
  *  @brief A helper class to produce token/list lines
  *  Such lines are like:
@@ -55,7 +85,7 @@ class LogEntryData;
 class TokenizedOutput
 {
 public:
-  TokenizedOutput (tl::OutputStream &stream);
+  TokenizedOutput (tl::OutputStream &stream, BinaryTokenWriter *binary = 0);
   TokenizedOutput (tl::OutputStream &stream, const std::string &token);
   TokenizedOutput (tl::OutputStream &stream, int indent, const std::string &token);
   TokenizedOutput (TokenizedOutput &output, const std::string &token, bool inl = false);
@@ -67,6 +97,7 @@ public:
 
 private:
   tl::OutputStream *mp_stream;
+  BinaryTokenWriter *mp_binary;
   TokenizedOutput *mp_parent;
   bool m_first, m_inline, m_newline;
   int m_indent;
@@ -85,6 +116,7 @@ class std_writer_impl
 public:
   std_writer_impl (tl::OutputStream &stream, double dbu, const std::string &progress_description = std::string ());
 
+  void set_binary (bool binary);
   void write (const db::LayoutToNetlist *l2n);
   void write (TokenizedOutput &stream, bool nested, const db::Netlist *netlist, const db::LayoutToNetlist *l2n, std::map<const db::Circuit *, std::map<const db::Net *, unsigned int> > *net2id_per_circuit);
 
@@ -94,12 +126,18 @@ protected:
     return *mp_stream;
   }
 
+  BinaryTokenWriter *binary_writer ()
+  {
+    return mp_binary_writer.get ();
+  }
+
   std::string severity_to_s (const db::Severity severity);
   std::string message_to_s (const std::string &msg);
   void write_log_entry (TokenizedOutput &stream, const LogEntryData &log_entry);
 
 private:
   tl::OutputStream *mp_stream;
+  std::unique_ptr<BinaryTokenWriter> mp_binary_writer;
   db::Point m_ref;
   double m_dbu;
   const db::Netlist *mp_netlist;
@@ -150,7 +188,12 @@ class DB_PUBLIC LayoutToNetlistStandardWriter
   : public LayoutToNetlistWriterBase
 {
 public:
-  LayoutToNetlistStandardWriter (tl::OutputStream &stream, bool short_version);
+  /**
+   *  @brief Constructor
+   *  If "binary" is true, the binary variant of the format is written.
+   *  The binary variant always uses the short keys.
+   */
+  LayoutToNetlistStandardWriter (tl::OutputStream &stream, bool short_version, bool binary = false);
 
 protected:
   void do_write (const db::LayoutToNetlist *l2n);
@@ -158,6 +201,7 @@ protected:
 private:
   tl::OutputStream *mp_stream;
   bool m_short_version;
+  bool m_binary;
 };
 
 }
@@ -25,6 +25,7 @@
 #include "dbLayoutVsSchematic.h"
 #include "dbLayoutVsSchematicWriter.h"
 #include "dbLayoutVsSchematicReader.h"
+#include "dbLayoutToNetlistFormatDefs.h"
 #include "dbNetlistCompareUtils.h"
 
 namespace db
@@ -137,16 +138,20 @@ LayoutVsSchematic::flag_missing_ports (const db::Circuit *circuit)
 
 void LayoutVsSchematic::save (const std::string &path, bool short_format)
 {
+  //  NOTE: the file we write may be the one we load the shapes from
+  ensure_geometry ();
+
   tl::OutputStream stream (path);
-  db::LayoutVsSchematicStandardWriter writer (stream, short_format);
+  db::LayoutVsSchematicStandardWriter writer (stream, short_format, db::l2n_binary_format::is_binary_path (path));
   set_filename (path);
   writer.write (this);
 }
 
-void LayoutVsSchematic::load (const std::string &path)
+void LayoutVsSchematic::load (const std::string &path, bool lazy)
 {
   tl::InputStream stream (path);
   db::LayoutVsSchematicStandardReader reader (stream);
+  reader.set_lazy_geometry (lazy);
   set_filename (path);
   set_name (stream.filename ());
   reader.read (this);
@@ -173,9 +173,11 @@ public:
   /**
    *  @brief Loads the database from the given path
    *
+   *  See LayoutToNetlist::load for the "lazy" parameter.
+   *
    *  This is a convenience method. The low-level functionality is the LayoutVsSchematicReader.
    */
-  void load (const std::string &path);
+  void load (const std::string &path, bool lazy = false);
 
 private:
   //  no copying
@@ -43,7 +43,7 @@ void LayoutVsSchematicStandardReader::do_read_lvs (db::LayoutVsSchematic *lvs)
   try {
     read_netlist (lvs);
   } catch (tl::Exception &ex) {
-    throw tl::Exception (tl::sprintf (tl::to_string (tr ("%s in line: %d of %s")), ex.msg (), stream ().line_number (), path ()));
+    throw tl::Exception (tl::sprintf (tl::to_string (tr ("%s in %s of %s")), ex.msg (), location (), path ()));
   }
 }
 
@@ -75,6 +75,9 @@ public:
 
   virtual void do_read_lvs (db::LayoutVsSchematic *lvs);
 
+  using LayoutToNetlistStandardReader::set_lazy_geometry;
+  using LayoutToNetlistStandardReader::lazy_geometry;
+
 private:
   void read_netlist (db::LayoutVsSchematic *lvs);
 
@@ -87,7 +87,7 @@ std_writer_impl<Keys>::std_writer_impl (tl::OutputStream &stream, double dbu, co
 template <class Keys>
 void std_writer_impl<Keys>::write (const db::LayoutVsSchematic *lvs)
 {
-  TokenizedOutput out (ostream ());
+  TokenizedOutput out (ostream (), this->binary_writer ());
   out << Keys::lvs_magic_string << endl;
 
   const int version = 0;
@@ -269,8 +269,8 @@ void std_writer_impl<Keys>::write (TokenizedOutput &stream, const db::NetlistCro
 // -------------------------------------------------------------------------------------------
 //  LayoutVsSchematicStandardWriter implementation
 
-LayoutVsSchematicStandardWriter::LayoutVsSchematicStandardWriter (tl::OutputStream &stream, bool short_version)
-  : mp_stream (&stream), m_short_version (short_version)
+LayoutVsSchematicStandardWriter::LayoutVsSchematicStandardWriter (tl::OutputStream &stream, bool short_version, bool binary)
+  : mp_stream (&stream), m_short_version (short_version), m_binary (binary)
 {
   //  .. nothing yet ..
 }
@@ -284,10 +284,14 @@ void LayoutVsSchematicStandardWriter::do_write_lvs (const db::LayoutVsSchematic
     throw tl::Exception (tl::to_string (tr ("Can't write LVS DB before the layout has been loaded")));
   }
 
+  //  make sure all net shapes are present
+  lvs->ensure_geometry ();
+
   double dbu = lvs->internal_layout ()->dbu ();
 
-  if (m_short_version) {
+  if (m_short_version || m_binary) {
     lvs_std_format::std_writer_impl<lvs_std_format::keys<true> > writer (*mp_stream, dbu);
+    writer.set_binary (m_binary);
     writer.write (lvs);
   } else {
     lvs_std_format::std_writer_impl<lvs_std_format::keys<false> > writer (*mp_stream, dbu);
@@ -60,7 +60,12 @@ class DB_PUBLIC LayoutVsSchematicStandardWriter
   : public LayoutVsSchematicWriterBase
 {
 public:
-  LayoutVsSchematicStandardWriter (tl::OutputStream &stream, bool short_version);
+  /**
+   *  @brief Constructor
+   *  If "binary" is true, the binary variant of the format is written.
+   *  The binary variant always uses the short keys.
+   */
+  LayoutVsSchematicStandardWriter (tl::OutputStream &stream, bool short_version, bool binary = false);
 
 protected:
   void do_write_lvs (const db::LayoutVsSchematic *lvs);
@@ -68,6 +73,7 @@ protected:
 private:
   tl::OutputStream *mp_stream;
   bool m_short_version;
+  bool m_binary;
 };
 
 }
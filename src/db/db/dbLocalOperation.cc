@@ -44,25 +44,8 @@ void local_operation<TS, TI, TR>::compute_local (db::Layout *layout, db::Cell *s
     }
 
     for (typename shape_interactions<TS, TI>::iterator i = interactions.begin (); i != interactions.end (); ++i) {
-      const TS &subject_shape = interactions.subject_shape (i->first);
 
-      shape_interactions<TS, TI> single_interactions;
-
-      if (on_empty_intruder_hint () == OnEmptyIntruderHint::Drop) {
-        single_interactions.add_subject_shape (i->first, subject_shape);
-      } else {
-        //  this includes the subject-without-intruder "interaction"
-        single_interactions.add_subject (i->first, subject_shape);
-      }
-
-      const std::vector<unsigned int> &intruders = interactions.intruders_for (i->first);
-      for (typename std::vector<unsigned int>::const_iterator ii = intruders.begin (); ii != intruders.end (); ++ii) {
-        const std::pair<unsigned int, TI> &is = interactions.intruder_shape (*ii);
-        single_interactions.add_intruder_shape (*ii, is.first, is.second);
-        single_interactions.add_interaction (i->first, *ii);
-      }
-
-      do_compute_local (layout, subject_cell, single_interactions, results, proc);
+      compute_local_single_subject (layout, subject_cell, interactions, i->first, results, proc);
 
       if (progress.get ()) {
         ++*progress;
@@ -73,6 +56,29 @@ void local_operation<TS, TI, TR>::compute_local (db::Layout *layout, db::Cell *s
   }
 }
 
+template <class TS, class TI, class TR>
+void local_operation<TS, TI, TR>::compute_local_single_subject (db::Layout *layout, db::Cell *subject_cell, const shape_interactions<TS, TI> &interactions, unsigned int subject_id, std::vector<std::unordered_set<TR> > &results, const db::LocalProcessorBase *proc) const
+{
+  const TS &subject_shape = interactions.subject_shape (subject_id);
+
+  shape_interactions<TS, TI> single_interactions;
+
+  if (on_empty_intruder_hint () == OnEmptyIntruderHint::Drop) {
+    single_interactions.add_subject_shape (subject_id, subject_shape);
+  } else {
+    //  this includes the subject-without-intruder "interaction"
+    single_interactions.add_subject (subject_id, subject_shape);
+  }
+
+  const std::vector<unsigned int> &intruders = interactions.intruders_for (subject_id);
+  for (typename std::vector<unsigned int>::const_iterator ii = intruders.begin (); ii != intruders.end (); ++ii) {
+    const std::pair<unsigned int, TI> &is = interactions.intruder_shape (*ii);
+    single_interactions.add_intruder_shape (*ii, is.first, is.second);
+    single_interactions.add_interaction (subject_id, *ii);
+  }
+
+  do_compute_local (layout, subject_cell, single_interactions, results, proc);
+}
 
 //  explicit instantiations
 template class DB_PUBLIC local_operation<db::Polygon, db::Polygon, db::Polygon>;
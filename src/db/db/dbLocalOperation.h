@@ -97,6 +97,14 @@ public:
    */
   void compute_local (db::Layout *layout, db::Cell *subject_cell, const shape_interactions<TS, TI> &interactions, std::vector<std::unordered_set<TR> > &results, const db::LocalProcessorBase *proc) const;
 
+  /**
+   *  @brief Computes the results for a single subject from a given set of interacting shapes
+   *
+   *  This method extracts the subject with the given ID and its intruders from the interactions
+   *  and computes the results for this subject alone. This is the single subject mode used by "compute_local".
+   */
+  void compute_local_single_subject (db::Layout *layout, db::Cell *subject_cell, const shape_interactions<TS, TI> &interactions, unsigned int subject_id, std::vector<std::unordered_set<TR> > &results, const db::LocalProcessorBase *proc) const;
+
   /**
    *  @brief Indicates the desired behaviour when a shape does not have an intruder
    */
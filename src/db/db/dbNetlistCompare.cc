@@ -31,6 +31,7 @@
 #include "tlLog.h"
 #include "tlEnv.h"
 #include "tlInternational.h"
+#include "tlThreadedWorkers.h"
 
 #include <cstring>
 
@@ -63,6 +64,8 @@ NetlistComparer::NetlistComparer (NetlistCompareLogger *logger)
   m_dont_consider_net_names = false;
   m_case_sensitive = false;
 
+  m_threads = 0;
+
   m_with_log = true;
 }
 
@@ -370,6 +373,10 @@ NetlistComparer::compare_impl (const db::Netlist *a, const db::Netlist *b) const
 
   tl::RelativeProgress progress (tl::to_string (tr ("Comparing netlists")), a->circuit_count (), 1);
 
+  //  collect the circuit pairs to compare in bottom-up order
+
+  std::vector<std::pair<const db::Circuit *, const db::Circuit *> > circuits;
+
   for (db::Netlist::const_bottom_up_circuit_iterator c = a->begin_bottom_up (); c != a->end_bottom_up (); ++c) {
 
     const db::Circuit *ca = c.operator-> ();
@@ -388,61 +395,499 @@ NetlistComparer::compare_impl (const db::Netlist *a, const db::Netlist *b) const
 
     //  NOTE: there can only be one schematic circuit
     tl_assert (i->second.second.size () == size_t (1));
-    const db::Circuit *cb = i->second.second.front ();
+    circuits.push_back (std::make_pair (ca, i->second.second.front ()));
+
+  }
 
-    if (all_subcircuits_verified (ca, verified_circuits_a) && all_subcircuits_verified (cb, verified_circuits_b)) {
+  if (m_threads > 0 && circuits.size () > 1) {
+
+    compare_circuits_in_parallel (circuits, device_categorizer, circuit_categorizer, circuit_pin_mapper, verified_circuits_a, verified_circuits_b, c12_pin_mapping, c22_pin_mapping, progress, good);
+
+  } else {
+
+    for (std::vector<std::pair<const db::Circuit *, const db::Circuit *> >::const_iterator c = circuits.begin (); c != circuits.end (); ++c) {
+
+      const db::Circuit *ca = c->first;
+      const db::Circuit *cb = c->second;
+
+      if (all_subcircuits_verified (ca, verified_circuits_a) && all_subcircuits_verified (cb, verified_circuits_b)) {
+
+        if (db::NetlistCompareGlobalOptions::options ()->debug_netcompare) {
+          tl::info << "----------------------------------------------------------------------";
+          tl::info << "treating circuit: " << ca->name () << " vs. " << cb->name ();
+        }
+        if (mp_logger) {
+          mp_logger->begin_circuit (ca, cb);
+        }
+
+        bool pin_mismatch = false;
+        bool g = compare_circuits (ca, cb, device_categorizer, circuit_categorizer, circuit_pin_mapper, get_net_identity (ca, cb), pin_mismatch, c12_pin_mapping, c22_pin_mapping, mp_logger);
+        if (! g) {
+          good = false;
+        }
+
+        if (! pin_mismatch) {
+          verified_circuits_a.insert (ca);
+          verified_circuits_b.insert (cb);
+        }
+
+        derive_pin_equivalence (ca, cb, &circuit_pin_mapper);
+
+        if (mp_logger) {
+          mp_logger->end_circuit (ca, cb, g);
+        }
+
+      } else {
+
+        if (mp_logger) {
+
+          std::string msg = generate_subcircuits_not_verified_warning (ca, verified_circuits_a, cb, verified_circuits_b);
+
+          if (m_with_log) {
+            mp_logger->log_entry (db::Error, msg);
+          }
+
+          mp_logger->circuit_skipped (ca, cb, msg);
+          good = false;
+
+        }
 
-      if (db::NetlistCompareGlobalOptions::options ()->debug_netcompare) {
-        tl::info << "----------------------------------------------------------------------";
-        tl::info << "treating circuit: " << ca->name () << " vs. " << cb->name ();
       }
-      if (mp_logger) {
-        mp_logger->begin_circuit (ca, cb);
+
+      ++progress;
+
+    }
+
+  }
+
+  if (mp_logger) {
+    mp_logger->end_netlist (a, b);
+  }
+
+  return good;
+}
+
+namespace
+{
+
+/**
+ *  @brief A logger which records the events for replaying them later
+ *
+ *  This logger is used to collect the events from a circuit compared in a worker thread.
+ *  The events are replayed in the order of the single-threaded algorithm later.
+ */
+class NetlistCompareLoggerBuffer
+  : public db::NetlistCompareLogger
+{
+public:
+  NetlistCompareLoggerBuffer ()
+    : db::NetlistCompareLogger ()
+  {
+    //  .. nothing yet ..
+  }
+
+  virtual void log_entry (db::Severity level, const std::string &msg)
+  {
+    m_events.push_back (Event (LogEntry, 0, 0, msg, level));
+  }
+
+  virtual void match_nets (const db::Net *a, const db::Net *b)
+  {
+    m_events.push_back (Event (MatchNets, a, b));
+  }
+
+  virtual void match_ambiguous_nets (const db::Net *a, const db::Net *b, const std::string &msg)
+  {
+    m_events.push_back (Event (MatchAmbiguousNets, a, b, msg));
+  }
+
+  virtual void net_mismatch (const db::Net *a, const db::Net *b, const std::string &msg)
+  {
+    m_events.push_back (Event (NetMismatch, a, b, msg));
+  }
+
+  virtual void match_devices (const db::Device *a, const db::Device *b)
+  {
+    m_events.push_back (Event (MatchDevices, a, b));
+  }
+
+  virtual void match_devices_with_different_parameters (const db::Device *a, const db::Device *b)
+  {
+    m_events.push_back (Event (MatchDevicesWithDifferentParameters, a, b));
+  }
+
+  virtual void match_devices_with_different_device_classes (const db::Device *a, const db::Device *b)
+  {
+    m_events.push_back (Event (MatchDevicesWithDifferentDeviceClasses, a, b));
+  }
+
+  virtual void device_mismatch (const db::Device *a, const db::Device *b, const std::string &msg)
+  {
+    m_events.push_back (Event (DeviceMismatch, a, b, msg));
+  }
+
+  virtual void match_pins (const db::Pin *a, const db::Pin *b)
+  {
+    m_events.push_back (Event (MatchPins, a, b));
+  }
+
+  virtual void pin_mismatch (const db::Pin *a, const db::Pin *b, const std::string &msg)
+  {
+    m_events.push_back (Event (PinMismatch, a, b, msg));
+  }
+
+  virtual void match_subcircuits (const db::SubCircuit *a, const db::SubCircuit *b)
+  {
+    m_events.push_back (Event (MatchSubCircuits, a, b));
+  }
+
+  virtual void subcircuit_mismatch (const db::SubCircuit *a, const db::SubCircuit *b, const std::string &msg)
+  {
+    m_events.push_back (Event (SubCircuitMismatch, a, b, msg));
+  }
+
+  /**
+   *  @brief Clears the recorded events
+   */
+  void clear ()
+  {
+    std::vector<Event> ().swap (m_events);
+  }
+
+  /**
+   *  @brief Sends the recorded events to the given logger
+   */
+  void replay (db::NetlistCompareLogger *logger) const
+  {
+    for (std::vector<Event>::const_iterator e = m_events.begin (); e != m_events.end (); ++e) {
+
+      switch (e->type) {
+      case LogEntry:
+        logger->log_entry (e->level, e->msg);
+        break;
+      case MatchNets:
+        logger->match_nets ((const db::Net *) e->a, (const db::Net *) e->b);
+        break;
+      case MatchAmbiguousNets:
+        logger->match_ambiguous_nets ((const db::Net *) e->a, (const db::Net *) e->b, e->msg);
+        break;
+      case NetMismatch:
+        logger->net_mismatch ((const db::Net *) e->a, (const db::Net *) e->b, e->msg);
+        break;
+      case MatchDevices:
+        logger->match_devices ((const db::Device *) e->a, (const db::Device *) e->b);
+        break;
+      case MatchDevicesWithDifferentParameters:
+        logger->match_devices_with_different_parameters ((const db::Device *) e->a, (const db::Device *) e->b);
+        break;
+      case MatchDevicesWithDifferentDeviceClasses:
+        logger->match_devices_with_different_device_classes ((const db::Device *) e->a, (const db::Device *) e->b);
+        break;
+      case DeviceMismatch:
+        logger->device_mismatch ((const db::Device *) e->a, (const db::Device *) e->b, e->msg);
+        break;
+      case MatchPins:
+        logger->match_pins ((const db::Pin *) e->a, (const db::Pin *) e->b);
+        break;
+      case PinMismatch:
+        logger->pin_mismatch ((const db::Pin *) e->a, (const db::Pin *) e->b, e->msg);
+        break;
+      case MatchSubCircuits:
+        logger->match_subcircuits ((const db::SubCircuit *) e->a, (const db::SubCircuit *) e->b);
+        break;
+      case SubCircuitMismatch:
+        logger->subcircuit_mismatch ((const db::SubCircuit *) e->a, (const db::SubCircuit *) e->b, e->msg);
+        break;
       }
 
-      bool pin_mismatch = false;
-      bool g = compare_circuits (ca, cb, device_categorizer, circuit_categorizer, circuit_pin_mapper, get_net_identity (ca, cb), pin_mismatch, c12_pin_mapping, c22_pin_mapping);
-      if (! g) {
-        good = false;
+    }
+  }
+
+private:
+  enum EventType
+  {
+    LogEntry,
+    MatchNets,
+    MatchAmbiguousNets,
+    NetMismatch,
+    MatchDevices,
+    MatchDevicesWithDifferentParameters,
+    MatchDevicesWithDifferentDeviceClasses,
+    DeviceMismatch,
+    MatchPins,
+    PinMismatch,
+    MatchSubCircuits,
+    SubCircuitMismatch
+  };
+
+  struct Event
+  {
+    Event (EventType _type, const void *_a, const void *_b, const std::string &_msg = std::string (), db::Severity _level = db::NoSeverity)
+      : type (_type), a (_a), b (_b), msg (_msg), level (_level)
+    { }
+
+    EventType type;
+    const void *a, *b;
+    std::string msg;
+    db::Severity level;
+  };
+
+  std::vector<Event> m_events;
+};
+
+/**
+ *  @brief The state of one circuit pair in the multi-threaded compare
+ */
+struct CircuitCompareState
+{
+  CircuitCompareState ()
+    : wave (0), compared (false), done (false), good (false), pin_mismatch (false)
+  { }
+
+  unsigned int wave;
+  bool compared, done, good, pin_mismatch;
+  std::string skip_msg;
+  NetlistCompareLoggerBuffer events;
+};
+
+}
+
+/**
+ *  @brief A task comparing one circuit pair
+ */
+class NetlistCompareCircuitTask
+  : public tl::Task
+{
+public:
+  NetlistCompareCircuitTask (const NetlistComparer *comparer, const db::Circuit *ca, const db::Circuit *cb, CircuitCompareState *state, bool with_logger,
+                             db::DeviceCategorizer *device_categorizer, db::CircuitCategorizer *circuit_categorizer, db::CircuitPinCategorizer *circuit_pin_mapper,
+                             std::map<const db::Circuit *, CircuitMapper> *c12_pin_mapping, std::map<const db::Circuit *, CircuitMapper> *c22_pin_mapping)
+    : mp_comparer (comparer), mp_ca (ca), mp_cb (cb), mp_state (state), m_with_logger (with_logger),
+      mp_device_categorizer (device_categorizer), mp_circuit_categorizer (circuit_categorizer), mp_circuit_pin_mapper (circuit_pin_mapper),
+      mp_c12_pin_mapping (c12_pin_mapping), mp_c22_pin_mapping (c22_pin_mapping)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform ()
+  {
+    mp_state->good = mp_comparer->compare_circuits (mp_ca, mp_cb, *mp_device_categorizer, *mp_circuit_categorizer, *mp_circuit_pin_mapper, mp_comparer->get_net_identity (mp_ca, mp_cb),
+                                                    mp_state->pin_mismatch, *mp_c12_pin_mapping, *mp_c22_pin_mapping, m_with_logger ? &mp_state->events : 0);
+  }
+
+private:
+  const NetlistComparer *mp_comparer;
+  const db::Circuit *mp_ca, *mp_cb;
+  CircuitCompareState *mp_state;
+  bool m_with_logger;
+  db::DeviceCategorizer *mp_device_categorizer;
+  db::CircuitCategorizer *mp_circuit_categorizer;
+  db::CircuitPinCategorizer *mp_circuit_pin_mapper;
+  std::map<const db::Circuit *, CircuitMapper> *mp_c12_pin_mapping, *mp_c22_pin_mapping;
+};
+
+namespace
+{
+
+class NetlistCompareCircuitWorker
+  : public tl::Worker
+{
+public:
+  NetlistCompareCircuitWorker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<NetlistCompareCircuitTask *> (task)->perform ();
+  }
+};
+
+}
+
+void
+NetlistComparer::compare_circuits_in_parallel (const std::vector<std::pair<const db::Circuit *, const db::Circuit *> > &circuits,
+                                               db::DeviceCategorizer &device_categorizer,
+                                               db::CircuitCategorizer &circuit_categorizer,
+                                               db::CircuitPinCategorizer &circuit_pin_mapper,
+                                               std::set<const db::Circuit *> &verified_circuits_a,
+                                               std::set<const db::Circuit *> &verified_circuits_b,
+                                               std::map<const db::Circuit *, CircuitMapper> &c12_pin_mapping,
+                                               std::map<const db::Circuit *, CircuitMapper> &c22_pin_mapping,
+                                               tl::RelativeProgress &progress,
+                                               bool &good) const
+{
+  //  A circuit pair depends on the pairs of its subcircuits and on pairs sharing a circuit with it. Dependent pairs are
+  //  put into later "waves" in the order of the single-threaded algorithm. The pairs within one wave are independent
+  //  and can be compared in parallel. The shared data is modified outside the worker threads only.
+
+  std::vector<CircuitCompareState> states (circuits.size ());
+
+  unsigned int waves = 0;
+
+  std::map<const db::Circuit *, std::vector<size_t> > pairs_by_circuit, pairs_by_child;
+
+  for (size_t i = 0; i < circuits.size (); ++i) {
+
+    const db::Circuit *cc[] = { circuits [i].first, circuits [i].second };
+
+    std::set<const db::Circuit *> related (cc, cc + 2);
+    for (unsigned int n = 0; n < 2; ++n) {
+      for (db::Circuit::const_subcircuit_iterator sc = cc [n]->begin_subcircuits (); sc != cc [n]->end_subcircuits (); ++sc) {
+        if (sc->circuit_ref ()) {
+          related.insert (sc->circuit_ref ());
+        }
+      }
+    }
+
+    unsigned int wave = 0;
+
+    for (std::set<const db::Circuit *>::const_iterator r = related.begin (); r != related.end (); ++r) {
+      std::map<const db::Circuit *, std::vector<size_t> >::const_iterator p = pairs_by_circuit.find (*r);
+      if (p != pairs_by_circuit.end ()) {
+        for (std::vector<size_t>::const_iterator j = p->second.begin (); j != p->second.end (); ++j) {
+          wave = std::max (wave, states [*j].wave + 1);
+        }
       }
+    }
 
-      if (! pin_mismatch) {
-        verified_circuits_a.insert (ca);
-        verified_circuits_b.insert (cb);
+    for (unsigned int n = 0; n < 2; ++n) {
+      std::map<const db::Circuit *, std::vector<size_t> >::const_iterator p = pairs_by_child.find (cc [n]);
+      if (p != pairs_by_child.end ()) {
+        for (std::vector<size_t>::const_iterator j = p->second.begin (); j != p->second.end (); ++j) {
+          wave = std::max (wave, states [*j].wave + 1);
+        }
       }
+    }
 
-      derive_pin_equivalence (ca, cb, &circuit_pin_mapper);
+    states [i].wave = wave;
+    waves = std::max (waves, wave + 1);
 
-      if (mp_logger) {
-        mp_logger->end_circuit (ca, cb, g);
+    pairs_by_circuit [cc [0]].push_back (i);
+    pairs_by_circuit [cc [1]].push_back (i);
+    for (std::set<const db::Circuit *>::const_iterator r = related.begin (); r != related.end (); ++r) {
+      pairs_by_child [*r].push_back (i);
+    }
+
+  }
+
+  //  initializes the global options outside the worker threads
+  db::NetlistCompareGlobalOptions::options ();
+
+  size_t next_to_report = 0;
+
+  for (unsigned int w = 0; w < waves; ++w) {
+
+    tl::Job<NetlistCompareCircuitWorker> job (m_threads);
+
+    for (size_t i = 0; i < circuits.size (); ++i) {
+
+      if (states [i].wave != w) {
+        continue;
       }
 
-    } else {
+      const db::Circuit *ca = circuits [i].first;
+      const db::Circuit *cb = circuits [i].second;
 
-      if (mp_logger) {
+      if (all_subcircuits_verified (ca, verified_circuits_a) && all_subcircuits_verified (cb, verified_circuits_b)) {
+
+        if (db::NetlistCompareGlobalOptions::options ()->debug_netcompare) {
+          tl::info << "----------------------------------------------------------------------";
+          tl::info << "treating circuit: " << ca->name () << " vs. " << cb->name ();
+        }
+
+        //  NOTE: the maps must not be modified while the tasks are running, so we create the entries before
+        c12_pin_mapping [ca];
+        c22_pin_mapping [cb];
+        circuit_pin_mapper.prepare_circuit (ca);
+        circuit_pin_mapper.prepare_circuit (cb);
+
+        states [i].compared = true;
+        job.schedule (new NetlistCompareCircuitTask (this, ca, cb, &states [i], mp_logger != 0, &device_categorizer, &circuit_categorizer, &circuit_pin_mapper, &c12_pin_mapping, &c22_pin_mapping));
+
+      } else if (mp_logger) {
+        states [i].skip_msg = generate_subcircuits_not_verified_warning (ca, verified_circuits_a, cb, verified_circuits_b);
+      }
+
+    }
+
+    try {
+      job.start ();
+      job.wait ();
+    } catch (...) {
+      job.terminate ();
+      throw;
+    }
+
+    if (job.has_error ()) {
+      throw tl::Exception (tl::to_string (tr ("Errors occurred during processing. First error message says:\n")) + job.error_messages ().front ());
+    }
+
+    for (size_t i = 0; i < circuits.size (); ++i) {
+
+      CircuitCompareState &state = states [i];
+      if (state.wave != w) {
+        continue;
+      }
+
+      if (state.compared) {
+
+        if (! state.pin_mismatch) {
+          verified_circuits_a.insert (circuits [i].first);
+          verified_circuits_b.insert (circuits [i].second);
+        }
+
+        derive_pin_equivalence (circuits [i].first, circuits [i].second, &circuit_pin_mapper);
+
+      }
+
+      state.done = true;
+
+    }
+
+    //  report the circuits finished so far in the original order
+
+    for ( ; next_to_report < circuits.size () && states [next_to_report].done; ++next_to_report) {
+
+      CircuitCompareState &state = states [next_to_report];
+      const db::Circuit *ca = circuits [next_to_report].first;
+      const db::Circuit *cb = circuits [next_to_report].second;
+
+      if (state.compared) {
 
-        std::string msg = generate_subcircuits_not_verified_warning (ca, verified_circuits_a, cb, verified_circuits_b);
+        if (! state.good) {
+          good = false;
+        }
+
+        if (mp_logger) {
+          mp_logger->begin_circuit (ca, cb);
+          state.events.replay (mp_logger);
+          mp_logger->end_circuit (ca, cb, state.good);
+        }
+
+      } else if (mp_logger) {
 
         if (m_with_log) {
-          mp_logger->log_entry (db::Error, msg);
+          mp_logger->log_entry (db::Error, state.skip_msg);
         }
 
-        mp_logger->circuit_skipped (ca, cb, msg);
+        mp_logger->circuit_skipped (ca, cb, state.skip_msg);
         good = false;
 
       }
 
-    }
+      //  release memory
+      state.events.clear ();
 
-    ++progress;
+      ++progress;
 
-  }
+    }
 
-  if (mp_logger) {
-    mp_logger->end_netlist (a, b);
   }
 
-  return good;
+  tl_assert (next_to_report == circuits.size ());
 }
 
 static
@@ -856,7 +1301,7 @@ private:
   {
     std::map<const db::SubCircuit *, size_t> count;
     for (db::NetGraphNode::edge_iterator e = n.begin (); e != n.end (); ++e) {
-      for (std::vector<Transition>::const_iterator t = e->first.begin (); t != e->first.end (); ++t) {
+      for (TransitionRange::const_iterator t = e->first.begin (); t != e->first.end (); ++t) {
         if (t->is_for_subcircuit ()) {
           count [t->subcircuit ()] += 1;
         }
@@ -870,7 +1315,7 @@ private:
   {
     std::map<const db::Device *, size_t> count;
     for (db::NetGraphNode::edge_iterator e = n.begin (); e != n.end (); ++e) {
-      for (std::vector<Transition>::const_iterator t = e->first.begin (); t != e->first.end (); ++t) {
+      for (TransitionRange::const_iterator t = e->first.begin (); t != e->first.end (); ++t) {
         if (! t->is_for_subcircuit ()) {
           count [t->device ()] += 1;
         }
@@ -891,7 +1336,8 @@ NetlistComparer::compare_circuits (const db::Circuit *c1, const db::Circuit *c2,
                                    const std::vector<std::pair<std::pair<const Net *, const Net *>, bool> > &net_identity,
                                    bool &pin_mismatch,
                                    std::map<const db::Circuit *, CircuitMapper> &c12_circuit_and_pin_mapping,
-                                   std::map<const db::Circuit *, CircuitMapper> &c22_circuit_and_pin_mapping) const
+                                   std::map<const db::Circuit *, CircuitMapper> &c22_circuit_and_pin_mapping,
+                                   db::NetlistCompareLogger *logger) const
 {
   tl::SelfTimer timer (tl::verbosity () >= 21, tl::to_string (tr ("Comparing circuits ")) + c1->name () + "/" + c2->name ());
 
@@ -935,32 +1381,32 @@ NetlistComparer::compare_circuits (const db::Circuit *c1, const db::Circuit *c2,
       g2.identify (ni2, ni1, exact_match);
 
       //  in must_match mode, check if the nets are identical
-      if (mp_logger) {
+      if (logger) {
         if (p->second && ! exact_match) {
           if (m_with_log) {
             if (! p->first.first) {
-              mp_logger->log_entry (db::Error,
+              logger->log_entry (db::Error,
                                     tl::sprintf (tl::to_string (tr ("Right-side net %s is paired explicitly with a left-side one, but no net is present there")), expanded_name (p->first.second)));
             } else if (! p->first.second) {
-              mp_logger->log_entry (db::Error,
+              logger->log_entry (db::Error,
                                     tl::sprintf (tl::to_string (tr ("Left-side net %s is paired explicitly with a right-side one, but no net is present there")), expanded_name (p->first.first)));
             } else {
-              mp_logger->log_entry (db::Error,
+              logger->log_entry (db::Error,
                                     tl::sprintf (tl::to_string (tr ("Nets %s are paired explicitly, but are not identical topologically")), nets2string (p->first)));
             }
           }
-          mp_logger->net_mismatch (p->first.first, p->first.second);
+          logger->net_mismatch (p->first.first, p->first.second);
         } else {
-          mp_logger->match_nets (p->first.first, p->first.second);
+          logger->match_nets (p->first.first, p->first.second);
         }
       }
 
     } else if (p->second && g1.has_node_index_for_net (p->first.first)) {
 
-      if (mp_logger) {
-        mp_logger->net_mismatch (p->first.first, p->first.second);
+      if (logger) {
+        logger->net_mismatch (p->first.first, p->first.second);
         if (m_with_log && p->first.second) {
-          mp_logger->log_entry (db::Error,
+          logger->log_entry (db::Error,
                                 tl::sprintf (tl::to_string (tr ("Nets %s are paired explicitly, but are not identical topologically")), nets2string (p->first)));
         }
       }
@@ -970,10 +1416,10 @@ NetlistComparer::compare_circuits (const db::Circuit *c1, const db::Circuit *c2,
 
     } else if (p->second && g2.has_node_index_for_net (p->first.second)) {
 
-      if (mp_logger) {
-        mp_logger->net_mismatch (p->first.first, p->first.second);
+      if (logger) {
+        logger->net_mismatch (p->first.first, p->first.second);
         if (m_with_log && p->first.first) {
-          mp_logger->log_entry (db::Error,
+          logger->log_entry (db::Error,
                                 tl::sprintf (tl::to_string (tr ("Nets %s are paired explicitly, but are not identical topologically")), nets2string (p->first)));
         }
       }
@@ -1039,7 +1485,7 @@ NetlistComparer::compare_circuits (const db::Circuit *c1, const db::Circuit *c2,
     compare.circuit_pin_mapper = &circuit_pin_mapper;
     compare.subcircuit_equivalence = &subcircuit_equivalence;
     compare.device_equivalence = &device_equivalence;
-    compare.logger = mp_logger;
+    compare.logger = logger;
     compare.with_log = m_with_log;
     compare.progress = &progress;
 
@@ -1143,7 +1589,7 @@ NetlistComparer::compare_circuits (const db::Circuit *c1, const db::Circuit *c2,
 
     }
 
-    if (pass + 1 == num_passes && ! good && mp_logger && m_with_log) {
+    if (pass + 1 == num_passes && ! good && logger && m_with_log) {
       compare.analyze_failed_matches ();
     }
 
@@ -1156,11 +1602,11 @@ NetlistComparer::compare_circuits (const db::Circuit *c1, const db::Circuit *c2,
       if (db::NetlistCompareGlobalOptions::options ()->debug_netcompare || tl::verbosity () >= 40) {
         tl::info << "Unresolved net from left: " << i->net ()->expanded_name () << " " << (good ? "(accepted)" : "(not accepted)");
       }
-      if (mp_logger) {
+      if (logger) {
         if (good) {
-          mp_logger->match_nets (i->net (), 0);
+          logger->match_nets (i->net (), 0);
         } else {
-          mp_logger->net_mismatch (i->net (), 0);
+          logger->net_mismatch (i->net (), 0);
         }
       }
       if (good) {
@@ -1175,11 +1621,11 @@ NetlistComparer::compare_circuits (const db::Circuit *c1, const db::Circuit *c2,
       if (db::NetlistCompareGlobalOptions::options ()->debug_netcompare) {
         tl::info << "Unresolved net from right: " << i->net ()->expanded_name () << " " << (good ? "(accepted)" : "(not accepted)");
       }
-      if (mp_logger) {
+      if (logger) {
         if (good) {
-          mp_logger->match_nets (0, i->net ());
+          logger->match_nets (0, i->net ());
         } else {
-          mp_logger->net_mismatch (0, i->net ());
+          logger->net_mismatch (0, i->net ());
         }
       }
       if (good) {
@@ -1189,9 +1635,9 @@ NetlistComparer::compare_circuits (const db::Circuit *c1, const db::Circuit *c2,
     }
   }
 
-  do_pin_assignment (c1, g1, c2, g2, c12_circuit_and_pin_mapping, c22_circuit_and_pin_mapping, pin_mismatch, good);
-  do_device_assignment (c1, g1, c2, g2, device_filter, device_categorizer, device_equivalence, good);
-  do_subcircuit_assignment (c1, g1, c2, g2, circuit_categorizer, circuit_pin_mapper, c12_circuit_and_pin_mapping, c22_circuit_and_pin_mapping, subcircuit_equivalence, good);
+  do_pin_assignment (c1, g1, c2, g2, c12_circuit_and_pin_mapping, c22_circuit_and_pin_mapping, pin_mismatch, good, logger);
+  do_device_assignment (c1, g1, c2, g2, device_filter, device_categorizer, device_equivalence, good, logger);
+  do_subcircuit_assignment (c1, g1, c2, g2, circuit_categorizer, circuit_pin_mapper, c12_circuit_and_pin_mapping, c22_circuit_and_pin_mapping, subcircuit_equivalence, good, logger);
 
   return good;
 }
@@ -1224,7 +1670,7 @@ analyze_pin_mismatch (const db::Pin *pin1, const db::Circuit *c1, const db::Pin
 }
 
 bool
-NetlistComparer::handle_pin_mismatch (const db::NetGraph &g1, const db::Circuit *c1, const db::Pin *pin1, const db::NetGraph &g2, const db::Circuit *c2, const db::Pin *pin2) const
+NetlistComparer::handle_pin_mismatch (const db::NetGraph &g1, const db::Circuit *c1, const db::Pin *pin1, const db::NetGraph &g2, const db::Circuit *c2, const db::Pin *pin2, db::NetlistCompareLogger *logger) const
 {
   const db::Circuit *c = pin1 ? c1 : c2;
   const db::Pin *pin = pin1 ? pin1 : pin2;
@@ -1236,8 +1682,8 @@ NetlistComparer::handle_pin_mismatch (const db::NetGraph &g1, const db::Circuit
   if (net) {
     const db::NetGraphNode &n = graph->node (graph->node_index_for_net (net));
     if (n.has_other () && n.other_net_index () == 0) {
-      if (mp_logger) {
-        mp_logger->match_pins (pin1, pin2);
+      if (logger) {
+        logger->match_pins (pin1, pin2);
       }
       return true;
     }
@@ -1262,24 +1708,24 @@ NetlistComparer::handle_pin_mismatch (const db::NetGraph &g1, const db::Circuit
   }
 
   if (is_not_connected) {
-    if (mp_logger) {
-      mp_logger->match_pins (pin1, pin2);
+    if (logger) {
+      logger->match_pins (pin1, pin2);
     }
     return true;
   } else {
 
-    if (mp_logger) {
+    if (logger) {
       if (m_with_log) {
-        analyze_pin_mismatch (pin1, c1, pin2, c2, mp_logger);
+        analyze_pin_mismatch (pin1, c1, pin2, c2, logger);
       }
-      mp_logger->pin_mismatch (pin1, pin2);
+      logger->pin_mismatch (pin1, pin2);
     }
     return false;
   }
 }
 
 void
-NetlistComparer::do_pin_assignment (const db::Circuit *c1, const db::NetGraph &g1, const db::Circuit *c2, const db::NetGraph &g2, std::map<const db::Circuit *, CircuitMapper> &c12_circuit_and_pin_mapping, std::map<const db::Circuit *, CircuitMapper> &c22_circuit_and_pin_mapping, bool &pin_mismatch, bool &good) const
+NetlistComparer::do_pin_assignment (const db::Circuit *c1, const db::NetGraph &g1, const db::Circuit *c2, const db::NetGraph &g2, std::map<const db::Circuit *, CircuitMapper> &c12_circuit_and_pin_mapping, std::map<const db::Circuit *, CircuitMapper> &c22_circuit_and_pin_mapping, bool &pin_mismatch, bool &good, db::NetlistCompareLogger *logger) const
 {
   //  Report pin assignment
   //  This step also does the pin identity mapping.
@@ -1345,8 +1791,8 @@ NetlistComparer::do_pin_assignment (const db::Circuit *c1, const db::NetGraph &g
 
         //  assign an abstract pin - this is a dummy assignment which is mitigated
         //  by declaring the pins equivalent in derive_pin_equivalence
-        if (mp_logger) {
-          mp_logger->match_pins (p.operator-> (), fp->second);
+        if (logger) {
+          logger->match_pins (p.operator-> (), fp->second);
         }
         c12_pin_mapping.map_pin (p->id (), fp->second->id ());
         c22_pin_mapping.map_pin (fp->second->id (), fp->second->id ());
@@ -1355,8 +1801,8 @@ NetlistComparer::do_pin_assignment (const db::Circuit *c1, const db::NetGraph &g
 
         //  assign an abstract pin - this is a dummy assignment which is mitigated
         //  by declaring the pins equivalent in derive_pin_equivalence
-        if (mp_logger) {
-          mp_logger->match_pins (p.operator-> (), *next_abstract);
+        if (logger) {
+          logger->match_pins (p.operator-> (), *next_abstract);
         }
         c12_pin_mapping.map_pin (p->id (), (*next_abstract)->id ());
         c22_pin_mapping.map_pin ((*next_abstract)->id (), (*next_abstract)->id ());
@@ -1366,7 +1812,7 @@ NetlistComparer::do_pin_assignment (const db::Circuit *c1, const db::NetGraph &g
       } else {
 
         //  otherwise this is an error for subcircuits or worth a report for top-level circuits
-        if (! handle_pin_mismatch (g1, c1, p.operator-> (), g2, c2, 0)) {
+        if (! handle_pin_mismatch (g1, c1, p.operator-> (), g2, c2, 0, logger)) {
           good = false;
           pin_mismatch = true;
         }
@@ -1390,8 +1836,8 @@ NetlistComparer::do_pin_assignment (const db::Circuit *c1, const db::NetGraph &g
 
       if (np != net2pin2.end () && np->first == n.other_net_index ()) {
 
-        if (mp_logger) {
-          mp_logger->match_pins (pi->pin (), np->second);
+        if (logger) {
+          logger->match_pins (pi->pin (), np->second);
         }
         c12_pin_mapping.map_pin (pi->pin ()->id (), np->second->id ());
         //  dummy mapping: we show this pin is used.
@@ -1413,14 +1859,14 @@ NetlistComparer::do_pin_assignment (const db::Circuit *c1, const db::NetGraph &g
   }
 
   for (std::multimap<size_t, const db::Pin *>::iterator np = net2pin1.begin (); np != net2pin1.end (); ++np) {
-    if (! handle_pin_mismatch (g1, c1, np->second, g2, c2, 0)) {
+    if (! handle_pin_mismatch (g1, c1, np->second, g2, c2, 0, logger)) {
       good = false;
       pin_mismatch = true;
     }
   }
 
   for (std::multimap<size_t, const db::Pin *>::iterator np = net2pin2.begin (); np != net2pin2.end (); ++np) {
-    if (! handle_pin_mismatch (g1, c1, 0, g2, c2, np->second)) {
+    if (! handle_pin_mismatch (g1, c1, 0, g2, c2, np->second, logger)) {
       good = false;
       pin_mismatch = true;
     }
@@ -1428,7 +1874,7 @@ NetlistComparer::do_pin_assignment (const db::Circuit *c1, const db::NetGraph &g
 
   //  abstract pins must match.
   while (next_abstract != abstract_pins2.end ()) {
-    if (! handle_pin_mismatch (g1, c1, 0, g2, c2, *next_abstract)) {
+    if (! handle_pin_mismatch (g1, c1, 0, g2, c2, *next_abstract, logger)) {
       good = false;
       pin_mismatch = true;
     }
@@ -1437,7 +1883,7 @@ NetlistComparer::do_pin_assignment (const db::Circuit *c1, const db::NetGraph &g
 }
 
 void
-NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph &g1, const db::Circuit *c2, const db::NetGraph &g2, const db::DeviceFilter &device_filter, db::DeviceCategorizer &device_categorizer, DeviceEquivalenceTracker &device_eq, bool &good) const
+NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph &g1, const db::Circuit *c2, const db::NetGraph &g2, const db::DeviceFilter &device_filter, db::DeviceCategorizer &device_categorizer, DeviceEquivalenceTracker &device_eq, bool &good, db::NetlistCompareLogger *logger) const
 {
   //  Report device assignment
 
@@ -1468,7 +1914,7 @@ NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph
     std::vector<std::pair<size_t, size_t> > k = compute_device_key_for_this (*d, g1, device_categorizer.is_strict_device_category (device_cat), mapped);
 
     if (! mapped) {
-      if (mp_logger) {
+      if (logger) {
         unmatched_a.push_back (std::make_pair (k, std::make_pair (d.operator-> (), device_cat)));
       }
       good = false;
@@ -1510,8 +1956,8 @@ NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph
       if (! mapped1 || ! mapped2 || k != k_this) {
 
         //  topological mismatch
-        if (mp_logger) {
-          mp_logger->device_mismatch (d_this, d.operator-> ());
+        if (logger) {
+          logger->device_mismatch (d_this, d.operator-> ());
         }
         good = false;
 
@@ -1531,7 +1977,7 @@ NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph
 
       if (! mapped || dm == device_map.end () || dm->first != k) {
 
-        if (mp_logger) {
+        if (logger) {
           unmatched_b.push_back (std::make_pair (k, std::make_pair (d.operator-> (), device_cat)));
         }
         good = false;
@@ -1577,19 +2023,19 @@ NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph
 
       if (! dc.equals (std::make_pair (c1_device, c1_device_cat), std::make_pair (d.operator-> (), device_cat))) {
         if (c1_device_cat != device_cat) {
-          if (mp_logger) {
-            mp_logger->match_devices_with_different_device_classes (c1_device, d.operator-> ());
+          if (logger) {
+            logger->match_devices_with_different_device_classes (c1_device, d.operator-> ());
           }
           good = false;
         } else {
-          if (mp_logger) {
-            mp_logger->match_devices_with_different_parameters (c1_device, d.operator-> ());
+          if (logger) {
+            logger->match_devices_with_different_parameters (c1_device, d.operator-> ());
           }
           good = false;
         }
       } else {
-        if (mp_logger) {
-          mp_logger->match_devices (c1_device, d.operator-> ());
+        if (logger) {
+          logger->match_devices (c1_device, d.operator-> ());
         }
       }
 
@@ -1598,7 +2044,7 @@ NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph
   }
 
   for (std::multimap<std::vector<std::pair<size_t, size_t> >, std::pair<const db::Device *, size_t> >::const_iterator dm = device_map.begin (); dm != device_map.end (); ++dm) {
-    if (mp_logger) {
+    if (logger) {
       unmatched_a.push_back (*dm);
     }
     good = false;
@@ -1607,17 +2053,17 @@ NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph
   //  try to do some better mapping of unmatched devices - they will still be reported as mismatching, but their pairing gives some hint
   //  what to fix.
 
-  if (mp_logger) {
+  if (logger) {
 
     size_t max_analysis_set = 1000;
     if (unmatched_a.size () + unmatched_b.size () > max_analysis_set) {
 
       //  don't try too much analysis - this may be a waste of time
       for (unmatched_list::const_iterator i = unmatched_a.begin (); i != unmatched_a.end (); ++i) {
-        mp_logger->device_mismatch (i->second.first, 0);
+        logger->device_mismatch (i->second.first, 0);
       }
       for (unmatched_list::const_iterator i = unmatched_b.begin (); i != unmatched_b.end (); ++i) {
-        mp_logger->device_mismatch (0, i->second.first);
+        logger->device_mismatch (0, i->second.first);
       }
 
     } else {
@@ -1630,12 +2076,12 @@ NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph
       for (unmatched_list::iterator i = unmatched_a.begin (), j = unmatched_b.begin (); i != unmatched_a.end () || j != unmatched_b.end (); ) {
 
         while (j != unmatched_b.end () && (i == unmatched_a.end () || !cmp.equals (*j, *i))) {
-          mp_logger->device_mismatch (0, j->second.first);
+          logger->device_mismatch (0, j->second.first);
           ++j;
         }
 
         while (i != unmatched_a.end () && (j == unmatched_b.end () || !cmp.equals (*i, *j))) {
-          mp_logger->device_mismatch (i->second.first, 0);
+          logger->device_mismatch (i->second.first, 0);
           ++i;
         }
 
@@ -1657,15 +2103,15 @@ NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph
         align (ii, i, jj, j, DeviceConnectionDistance ());
 
         for ( ; ii != i && jj != j; ++ii, ++jj) {
-          mp_logger->device_mismatch (ii->second.first, jj->second.first);
+          logger->device_mismatch (ii->second.first, jj->second.first);
         }
 
         for ( ; jj != j; ++jj) {
-          mp_logger->device_mismatch (0, jj->second.first);
+          logger->device_mismatch (0, jj->second.first);
         }
 
         for ( ; ii != i; ++ii) {
-          mp_logger->device_mismatch (ii->second.first, 0);
+          logger->device_mismatch (ii->second.first, 0);
         }
 
       }
@@ -1676,7 +2122,7 @@ NetlistComparer::do_device_assignment (const db::Circuit *c1, const db::NetGraph
 }
 
 void
-NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetGraph &g1, const db::Circuit *c2, const db::NetGraph &g2, CircuitCategorizer &circuit_categorizer, const CircuitPinCategorizer &circuit_pin_mapper, std::map<const Circuit *, CircuitMapper> &c12_circuit_and_pin_mapping, std::map<const Circuit *, CircuitMapper> &c22_circuit_and_pin_mapping, SubCircuitEquivalenceTracker &subcircuit_eq, bool &good) const
+NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetGraph &g1, const db::Circuit *c2, const db::NetGraph &g2, CircuitCategorizer &circuit_categorizer, const CircuitPinCategorizer &circuit_pin_mapper, std::map<const Circuit *, CircuitMapper> &c12_circuit_and_pin_mapping, std::map<const Circuit *, CircuitMapper> &c22_circuit_and_pin_mapping, SubCircuitEquivalenceTracker &subcircuit_eq, bool &good, db::NetlistCompareLogger *logger) const
 {
   //  Report subcircuit assignment
 
@@ -1698,8 +2144,8 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
     std::vector<std::pair<size_t, size_t> > k = compute_subcircuit_key_for_this (*sc, g1, &c12_circuit_and_pin_mapping, &circuit_pin_mapper, mapped, valid);
 
     if (! mapped) {
-      if (mp_logger) {
-        mp_logger->subcircuit_mismatch (sc.operator-> (), 0);
+      if (logger) {
+        logger->subcircuit_mismatch (sc.operator-> (), 0);
       }
       good = false;
     } else if (valid) {
@@ -1707,8 +2153,8 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
       subcircuit_map.insert (std::make_pair (k, std::make_pair (sc.operator-> (), sc_cat)));
     } else {
       //  emit a mismatch event but do not consider that an error - this may happen if the circuit has been dropped intentionally (e.g. via cells)
-      if (mp_logger) {
-        mp_logger->subcircuit_mismatch (sc.operator-> (), 0);
+      if (logger) {
+        logger->subcircuit_mismatch (sc.operator-> (), 0);
       }
     }
 
@@ -1740,13 +2186,13 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
       std::vector<std::pair<size_t, size_t> > k = compute_subcircuit_key_for_other (*sc, g2, &c22_circuit_and_pin_mapping, &circuit_pin_mapper, mapped2, valid2);
 
       if (! valid1 || ! valid2 || ! mapped1 || ! mapped2 || k_this != k || sc_cat != sc_cat_this) {
-        if (mp_logger) {
-          mp_logger->subcircuit_mismatch (sc_this, sc.operator-> ());
+        if (logger) {
+          logger->subcircuit_mismatch (sc_this, sc.operator-> ());
         }
         good = false;
       } else {
-        if (mp_logger) {
-          mp_logger->match_subcircuits (sc_this, sc.operator-> ());
+        if (logger) {
+          logger->match_subcircuits (sc_this, sc.operator-> ());
         }
       }
 
@@ -1759,7 +2205,7 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
 
       if (! mapped || scm == subcircuit_map.end () || scm->first != k) {
 
-        if (mp_logger) {
+        if (logger) {
           unmatched_b.push_back (std::make_pair (k, sc.operator-> ()));
         }
         good = false;
@@ -1786,8 +2232,8 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
           if (nscm == 1) {
 
             //  unique match, but doesn't fit: report this one as paired, but mismatching:
-            if (mp_logger) {
-              mp_logger->subcircuit_mismatch (scm_start->second.first, sc.operator-> ());
+            if (logger) {
+              logger->subcircuit_mismatch (scm_start->second.first, sc.operator-> ());
             }
 
             //  no longer look for this one
@@ -1796,8 +2242,8 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
           } else {
 
             //  no unique match
-            if (mp_logger) {
-              mp_logger->subcircuit_mismatch (0, sc.operator-> ());
+            if (logger) {
+              logger->subcircuit_mismatch (0, sc.operator-> ());
             }
 
           }
@@ -1806,8 +2252,8 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
 
         } else {
 
-          if (mp_logger) {
-            mp_logger->match_subcircuits (scm->second.first, sc.operator-> ());
+          if (logger) {
+            logger->match_subcircuits (scm->second.first, sc.operator-> ());
           }
 
           //  no longer look for this one
@@ -1822,7 +2268,7 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
   }
 
   for (std::multimap<std::vector<std::pair<size_t, size_t> >, std::pair<const db::SubCircuit *, size_t> >::const_iterator scm = subcircuit_map.begin (); scm != subcircuit_map.end (); ++scm) {
-    if (mp_logger) {
+    if (logger) {
       unmatched_a.push_back (std::make_pair (scm->first, scm->second.first));
     }
     good = false;
@@ -1831,17 +2277,17 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
   //  try to do some pairing between the mismatching subcircuits - even though we will still report them as
   //  mismatches it will give some better hint about what needs to be fixed
 
-  if (mp_logger) {
+  if (logger) {
 
     size_t max_analysis_set = 1000;
     if (unmatched_a.size () + unmatched_b.size () > max_analysis_set) {
 
       //  don't try too much analysis - this may be a waste of time
       for (unmatched_list::const_iterator i = unmatched_a.begin (); i != unmatched_a.end (); ++i) {
-        mp_logger->subcircuit_mismatch (i->second, 0);
+        logger->subcircuit_mismatch (i->second, 0);
       }
       for (unmatched_list::const_iterator i = unmatched_b.begin (); i != unmatched_b.end (); ++i) {
-        mp_logger->subcircuit_mismatch (0, i->second);
+        logger->subcircuit_mismatch (0, i->second);
       }
 
     } else {
@@ -1852,12 +2298,12 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
       for (unmatched_list::iterator i = unmatched_a.begin (), j = unmatched_b.begin (); i != unmatched_a.end () || j != unmatched_b.end (); ) {
 
         while (j != unmatched_b.end () && (i == unmatched_a.end () || j->first.size () < i->first.size ())) {
-          mp_logger->subcircuit_mismatch (0, j->second);
+          logger->subcircuit_mismatch (0, j->second);
           ++j;
         }
 
         while (i != unmatched_a.end () && (j == unmatched_b.end () || i->first.size () < j->first.size ())) {
-          mp_logger->subcircuit_mismatch (i->second, 0);
+          logger->subcircuit_mismatch (i->second, 0);
           ++i;
         }
 
@@ -1882,15 +2328,15 @@ NetlistComparer::do_subcircuit_assignment (const db::Circuit *c1, const db::NetG
           align (ii, i, jj, j, KeyDistance ());
 
           for ( ; ii != i && jj != j; ++ii, ++jj) {
-            mp_logger->subcircuit_mismatch (ii->second, jj->second);
+            logger->subcircuit_mismatch (ii->second, jj->second);
           }
 
           for ( ; jj != j; ++jj) {
-            mp_logger->subcircuit_mismatch (0, jj->second);
+            logger->subcircuit_mismatch (0, jj->second);
           }
 
           for ( ; ii != i; ++ii) {
-            mp_logger->subcircuit_mismatch (ii->second, 0);
+            logger->subcircuit_mismatch (ii->second, 0);
           }
 
         }
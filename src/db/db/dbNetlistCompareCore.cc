@@ -127,7 +127,7 @@ public:
 
     size_t ni = e.second.first;
     std::set<std::pair<CatAndIds, const Device *> > &dev = for_node_nc (ni);
-    for (std::vector<Transition>::const_iterator j = e.first.begin (); j != e.first.end (); ++j) {
+    for (TransitionRange::const_iterator j = e.first.begin (); j != e.first.end (); ++j) {
       if (! j->is_for_subcircuit ()) {
         dev.insert (std::make_pair (j->make_key (), j->device ()));
       }
@@ -154,7 +154,7 @@ public:
 
     size_t ni = e.second.first;
     std::set<std::pair<CatAndIds, const SubCircuit *> > &sc = for_node_nc (ni);
-    for (std::vector<Transition>::const_iterator j = e.first.begin (); j != e.first.end (); ++j) {
+    for (TransitionRange::const_iterator j = e.first.begin (); j != e.first.end (); ++j) {
       if (j->is_for_subcircuit ()) {
         sc.insert (std::make_pair (j->make_key (), j->subcircuit ()));
       }
@@ -164,29 +164,101 @@ public:
 
 // --------------------------------------------------------------------------------------------------------------------
 
+/**
+ *  @brief A pool for the undo lists of the tentative node mappings
+ *
+ *  The backtracking algorithm creates and discards tentative mappings at a high rate. The arena
+ *  keeps the storage of discarded mappings, so it can be reused without allocating it again.
+ */
+class TentativeNodeMappingArena
+{
+public:
+  struct Storage
+  {
+    std::vector<std::pair<NetGraph *, size_t> > to_undo, to_undo_to_unknown;
+    std::vector<std::pair<DeviceEquivalenceTracker *, std::pair<const db::Device *, const db::Device *> > > to_undo_devices;
+    std::vector<std::pair<SubCircuitEquivalenceTracker *, std::pair<const db::SubCircuit *, const db::SubCircuit *> > > to_undo_subcircuits;
+
+    void clear ()
+    {
+      to_undo.clear ();
+      to_undo_to_unknown.clear ();
+      to_undo_devices.clear ();
+      to_undo_subcircuits.clear ();
+    }
+  };
+
+  TentativeNodeMappingArena ()
+  { }
+
+  ~TentativeNodeMappingArena ()
+  {
+    for (std::vector<Storage *>::const_iterator s = m_free.begin (); s != m_free.end (); ++s) {
+      delete *s;
+    }
+    m_free.clear ();
+  }
+
+  Storage *acquire ()
+  {
+    if (m_free.empty ()) {
+      return new Storage ();
+    } else {
+      Storage *s = m_free.back ();
+      m_free.pop_back ();
+      return s;
+    }
+  }
+
+  void release (Storage *s)
+  {
+    s->clear ();
+    m_free.push_back (s);
+  }
+
+private:
+  std::vector<Storage *> m_free;
+
+  //  no copying
+  TentativeNodeMappingArena (const TentativeNodeMappingArena &);
+  TentativeNodeMappingArena &operator= (const TentativeNodeMappingArena &);
+};
+
 /**
  *  @brief An audit object which allows reverting tentative node assignments
+ *
+ *  If an arena is given, the storage is taken from and returned to the arena.
  */
 class TentativeNodeMapping
 {
 public:
-  TentativeNodeMapping ()
+  typedef TentativeNodeMappingArena::Storage storage_type;
+
+  TentativeNodeMapping (TentativeNodeMappingArena *arena = 0)
+    : mp_arena (arena), mp_storage (arena ? arena->acquire () : new storage_type ())
   { }
 
   ~TentativeNodeMapping ()
   {
-    for (std::vector<std::pair<NetGraph *, size_t> >::const_iterator i = m_to_undo.begin (); i != m_to_undo.end (); ++i) {
+    for (std::vector<std::pair<NetGraph *, size_t> >::const_iterator i = mp_storage->to_undo.begin (); i != mp_storage->to_undo.end (); ++i) {
       i->first->unidentify (i->second);
     }
-    for (std::vector<std::pair<NetGraph *, size_t> >::const_iterator i = m_to_undo_to_unknown.begin (); i != m_to_undo_to_unknown.end (); ++i) {
+    for (std::vector<std::pair<NetGraph *, size_t> >::const_iterator i = mp_storage->to_undo_to_unknown.begin (); i != mp_storage->to_undo_to_unknown.end (); ++i) {
       i->first->identify (i->second, unknown_id);
     }
-    for (std::vector<std::pair<DeviceEquivalenceTracker *, std::pair<const db::Device *, const db::Device *> > >::const_iterator i = m_to_undo_devices.begin (); i != m_to_undo_devices.end (); ++i) {
+    for (std::vector<std::pair<DeviceEquivalenceTracker *, std::pair<const db::Device *, const db::Device *> > >::const_iterator i = mp_storage->to_undo_devices.begin (); i != mp_storage->to_undo_devices.end (); ++i) {
       i->first->unmap (i->second.first, i->second.second);
     }
-    for (std::vector<std::pair<SubCircuitEquivalenceTracker *, std::pair<const db::SubCircuit *, const db::SubCircuit *> > >::const_iterator i = m_to_undo_subcircuits.begin (); i != m_to_undo_subcircuits.end (); ++i) {
+    for (std::vector<std::pair<SubCircuitEquivalenceTracker *, std::pair<const db::SubCircuit *, const db::SubCircuit *> > >::const_iterator i = mp_storage->to_undo_subcircuits.begin (); i != mp_storage->to_undo_subcircuits.end (); ++i) {
       i->first->unmap (i->second.first, i->second.second);
     }
+
+    if (mp_arena) {
+      mp_arena->release (mp_storage);
+    } else {
+      delete mp_storage;
+    }
+    mp_storage = 0;
   }
 
   static void map_pair (TentativeNodeMapping *nm, NetGraph *g1, size_t n1, NetGraph *g2, size_t n2,
@@ -271,51 +343,49 @@ public:
 
   void clear ()
   {
-    m_to_undo.clear ();
-    m_to_undo_to_unknown.clear ();
-    m_to_undo_devices.clear ();
-    m_to_undo_subcircuits.clear ();
+    mp_storage->clear ();
   }
 
   void swap (TentativeNodeMapping &other)
   {
-    m_to_undo.swap (other.m_to_undo);
-    m_to_undo_to_unknown.swap (other.m_to_undo_to_unknown);
-    m_to_undo_devices.swap (other.m_to_undo_devices);
-    m_to_undo_subcircuits.swap (other.m_to_undo_subcircuits);
+    std::swap (mp_arena, other.mp_arena);
+    std::swap (mp_storage, other.mp_storage);
   }
 
   std::vector<std::pair<NetGraph *, size_t> > nodes_tracked ()
   {
-    std::vector<std::pair<NetGraph *, size_t> > res = m_to_undo;
-    res.insert (res.end (), m_to_undo_to_unknown.begin (), m_to_undo_to_unknown.end ());
+    std::vector<std::pair<NetGraph *, size_t> > res = mp_storage->to_undo;
+    res.insert (res.end (), mp_storage->to_undo_to_unknown.begin (), mp_storage->to_undo_to_unknown.end ());
     return res;
   }
 
 private:
-  std::vector<std::pair<NetGraph *, size_t> > m_to_undo, m_to_undo_to_unknown;
-  std::vector<std::pair<DeviceEquivalenceTracker *, std::pair<const db::Device *, const db::Device *> > > m_to_undo_devices;
-  std::vector<std::pair<SubCircuitEquivalenceTracker *, std::pair<const db::SubCircuit *, const db::SubCircuit *> > > m_to_undo_subcircuits;
+  TentativeNodeMappingArena *mp_arena;
+  storage_type *mp_storage;
 
   void keep (NetGraph *g1, size_t n1)
   {
-    m_to_undo.push_back (std::make_pair (g1, n1));
+    mp_storage->to_undo.push_back (std::make_pair (g1, n1));
   }
 
   void keep_for_unknown (NetGraph *g1, size_t n1)
   {
-    m_to_undo_to_unknown.push_back (std::make_pair (g1, n1));
+    mp_storage->to_undo_to_unknown.push_back (std::make_pair (g1, n1));
   }
 
   void keep (DeviceEquivalenceTracker *dt, const db::Device *a, const db::Device *b)
   {
-    m_to_undo_devices.push_back (std::make_pair (dt, std::make_pair (a, b)));
+    mp_storage->to_undo_devices.push_back (std::make_pair (dt, std::make_pair (a, b)));
   }
 
   void keep (SubCircuitEquivalenceTracker *dt, const db::SubCircuit *a, const db::SubCircuit *b)
   {
-    m_to_undo_subcircuits.push_back (std::make_pair (dt, std::make_pair (a, b)));
+    mp_storage->to_undo_subcircuits.push_back (std::make_pair (dt, std::make_pair (a, b)));
   }
+
+  //  no copying
+  TentativeNodeMapping (const TentativeNodeMapping &);
+  TentativeNodeMapping &operator= (const TentativeNodeMapping &);
 };
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -325,14 +395,14 @@ private:
  */
 static bool edges_are_compatible (const NetGraphNode::edge_type &e, const NetGraphNode::edge_type &e_other, const DeviceEquivalenceTracker &device_eq, const SubCircuitEquivalenceTracker &sc_eq)
 {
-  std::vector<Transition>::const_iterator t1 = e.first.begin (), tt1 = e.first.end ();
-  std::vector<Transition>::const_iterator t2 = e_other.first.begin (), tt2 = e_other.first.end ();
+  TransitionRange::const_iterator t1 = e.first.begin (), tt1 = e.first.end ();
+  TransitionRange::const_iterator t2 = e_other.first.begin (), tt2 = e_other.first.end ();
 
   std::vector<void *> p1, p2;
 
   while (t1 != tt1 && t2 != tt2) {
 
-    std::vector<Transition>::const_iterator t10 = t1, t20 = t2;
+    TransitionRange::const_iterator t10 = t1, t20 = t2;
 
     p1.clear ();
     while (t1 != tt1 && *t1 == *t10) {
@@ -409,7 +479,13 @@ NetlistCompareCore::NetlistCompareCore (NetGraph *graph, NetGraph *other_graph)
     device_equivalence (0),
     progress (0),
     mp_graph (graph),
-    mp_other_graph (other_graph)
+    mp_other_graph (other_graph),
+    mp_tentative_arena (new TentativeNodeMappingArena ())
+{
+  //  .. nothing yet ..
+}
+
+NetlistCompareCore::~NetlistCompareCore ()
 {
   //  .. nothing yet ..
 }
@@ -482,7 +558,7 @@ NetlistCompareCore::derive_node_identities_for_edges (NetGraphNode::edge_iterato
         first = false;
       }
       tl::info << nl_compare_debug_indent (depth) << "    " << (nn->net () ? nn->net ()->expanded_name ().c_str() : "(null)") << " via: " << tl::noendl;
-      for (std::vector<Transition>::const_iterator t = i->edge->first.begin (); t != i->edge->first.end(); ++t) {
+      for (TransitionRange::const_iterator t = i->edge->first.begin (); t != i->edge->first.end(); ++t) {
         tl::info << (t != i->edge->first.begin () ? "; " : "") << t->to_string() << tl::noendl;
       }
       tl::info << "";
@@ -497,7 +573,7 @@ NetlistCompareCore::derive_node_identities_for_edges (NetGraphNode::edge_iterato
         first = false;
       }
       tl::info << nl_compare_debug_indent(depth) << "    " << (nn->net() ? nn->net()->expanded_name().c_str() : "(null)") << " via: " << tl::noendl;
-      for (std::vector<Transition>::const_iterator t = i->edge->first.begin (); t != i->edge->first.end(); ++t) {
+      for (TransitionRange::const_iterator t = i->edge->first.begin (); t != i->edge->first.end(); ++t) {
         tl::info << (t != i->edge->first.begin () ? "; " : "") << t->to_string() << tl::noendl;
       }
       tl::info << "";
@@ -549,7 +625,7 @@ NetlistCompareCore::derive_node_identities_for_edges (NetGraphNode::edge_iterato
 static bool has_subcircuits (db::NetGraphNode::edge_iterator e, db::NetGraphNode::edge_iterator ee)
 {
   while (e != ee) {
-    for (std::vector<Transition>::const_iterator t = e->first.begin (); t != e->first.end (); ++t) {
+    for (TransitionRange::const_iterator t = e->first.begin (); t != e->first.end (); ++t) {
       if (t->is_for_subcircuit ()) {
         return true;
       }
@@ -837,7 +913,7 @@ NetlistCompareCore::derive_node_identities_from_ambiguity_group (const NodeRange
   {
 
     //  marks the nodes from the ambiguity group as unknown so we don't revisit them (causing deep recursion)
-    TentativeNodeMapping tn_temp;
+    TentativeNodeMapping tn_temp (mp_tentative_arena.get ());
 
     //  collect and mark the ambiguity combinations to consider
     std::vector<std::vector<NodeEdgePair>::const_iterator> iters1, iters2;
@@ -931,7 +1007,7 @@ NetlistCompareCore::derive_node_identities_from_ambiguity_group (const NodeRange
           size_t ni = mp_graph->node_index_for_net (i1->node->net ());
           size_t other_ni = mp_other_graph->node_index_for_net (i2->node->net ());
 
-          TentativeNodeMapping tn;
+          TentativeNodeMapping tn (mp_tentative_arena.get ());
           TentativeNodeMapping::map_pair_from_unknown (&tn, mp_graph, ni, mp_other_graph, other_ni, dm, dm_other, *device_equivalence, scm, scm_other, *subcircuit_equivalence, depth);
 
           size_t bt_count = derive_node_identities (ni, depth + 1, complexity * n_branch, &tn);
@@ -998,7 +1074,7 @@ NetlistCompareCore::derive_node_identities_from_ambiguity_group (const NodeRange
             tl::info << indent_s << "finalizing decision (rerun tracking): " << i1->node->net ()->expanded_name () << " vs. " << i2->node->net ()->expanded_name ();
           }
 
-          tn_for_pairs.push_back (TentativeNodeMapping ());
+          tn_for_pairs.emplace_back (mp_tentative_arena.get ());
           size_t bt_count = derive_node_identities (ni, depth + 1, complexity * n_branch, &tn_for_pairs.back ());
           tl_assert (bt_count != failed_match);
 
@@ -31,6 +31,7 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <memory>
 
 namespace db
 {
@@ -39,6 +40,7 @@ namespace db
 //  NetlistCompareCore definition
 
 class TentativeNodeMapping;
+class TentativeNodeMappingArena;
 struct NodeRange;
 class DeviceMapperForTargetNode;
 class SubCircuitMapperForTargetNode;
@@ -52,6 +54,7 @@ public:
   typedef std::vector<NetGraphNode>::const_iterator node_iterator;
 
   NetlistCompareCore (NetGraph *graph, NetGraph *other_graph);
+  ~NetlistCompareCore ();
 
   /**
    *  @brief Implementation of the backtracking algorithm
@@ -105,6 +108,7 @@ public:
 private:
   NetGraph *mp_graph;
   NetGraph *mp_other_graph;
+  std::unique_ptr<TentativeNodeMappingArena> mp_tentative_arena;
 
   size_t derive_node_identities (size_t net_index, size_t depth, size_t n_branch, TentativeNodeMapping *tentative) const;
   size_t derive_node_identities_from_node_set (std::vector<NodeEdgePair> &nodes, std::vector<NodeEdgePair> &other_nodes, size_t depth, size_t n_branch, TentativeNodeMapping *tentative) const;
@@ -30,6 +30,7 @@
 
 #include "tlAssert.h"
 #include "tlLog.h"
+#include "tlHash.h"
 
 namespace db
 {
@@ -167,6 +168,18 @@ Transition::operator== (const Transition &other) const
   }
 }
 
+size_t
+Transition::hash () const
+{
+  //  NOTE: device parameters are compared with tolerances, hence they do not contribute to the hash value
+  size_t h = tl::hcombine (size_t (m_ptr != 0), m_cat);
+  h = tl::hcombine (h, m_id1);
+  if (! is_for_subcircuit ()) {
+    h = tl::hcombine (h, m_id2);
+  }
+  return h;
+}
+
 std::string
 Transition::to_string () const
 {
@@ -188,13 +201,14 @@ Transition::to_string () const
 //  NetGraphNode implementation
 
 NetGraphNode::NetGraphNode (const db::Net *net, DeviceCategorizer &device_categorizer, CircuitCategorizer &circuit_categorizer, const DeviceFilter &device_filter, const std::map<const db::Circuit *, CircuitMapper> *circuit_map, const CircuitPinCategorizer *pin_map, size_t *unique_pin_id)
-  : mp_net (net), m_other_net_index (invalid_id)
+  : mp_net (net), m_other_net_index (invalid_id), m_signature (0)
 {
   if (! net) {
     return;
   }
 
-  std::map<const void *, size_t> n2entry;
+  std::unordered_map<const void *, size_t> n2entry;
+  std::vector<edge_builder_type> edges;
 
   for (db::Net::const_subcircuit_pin_iterator i = net->begin_subcircuit_pins (); i != net->end_subcircuit_pins (); ++i) {
 
@@ -248,13 +262,13 @@ NetGraphNode::NetGraphNode (const db::Net *net, DeviceCategorizer &device_catego
 
     Transition ed (sc, circuit_cat, pin_id, original_pin_id);
 
-    std::map<const void *, size_t>::const_iterator in = n2entry.find ((const void *) sc);
+    std::unordered_map<const void *, size_t>::const_iterator in = n2entry.find ((const void *) sc);
     if (in == n2entry.end ()) {
-      in = n2entry.insert (std::make_pair ((const void *) sc, m_edges.size ())).first;
-      m_edges.push_back (edge_type (std::vector<Transition> (), std::make_pair (size_t (0), (const db::Net *) 0)));
+      in = n2entry.insert (std::make_pair ((const void *) sc, edges.size ())).first;
+      edges.push_back (edge_builder_type (std::vector<Transition> (), std::make_pair (size_t (0), (const db::Net *) 0)));
     }
 
-    m_edges [in->second].first.push_back (ed);
+    edges [in->second].first.push_back (ed);
 
   }
 
@@ -289,25 +303,28 @@ NetGraphNode::NetGraphNode (const db::Net *net, DeviceCategorizer &device_catego
           continue;
         }
 
-        std::map<const void *, size_t>::const_iterator in = n2entry.find ((const void *) net2);
+        std::unordered_map<const void *, size_t>::const_iterator in = n2entry.find ((const void *) net2);
         if (in == n2entry.end ()) {
-          in = n2entry.insert (std::make_pair ((const void *) net2, m_edges.size ())).first;
-          m_edges.push_back (edge_type (std::vector<Transition> (), std::make_pair (size_t (0), net2)));
+          in = n2entry.insert (std::make_pair ((const void *) net2, edges.size ())).first;
+          edges.push_back (edge_builder_type (std::vector<Transition> (), std::make_pair (size_t (0), net2)));
         }
 
-        m_edges [in->second].first.push_back (ed2);
+        edges [in->second].first.push_back (ed2);
 
       }
 
     }
 
   }
+
+  set_edges (edges);
 }
 
 NetGraphNode::NetGraphNode (const db::SubCircuit *sc, CircuitCategorizer &circuit_categorizer, const std::map<const db::Circuit *, CircuitMapper> *circuit_map, const CircuitPinCategorizer *pin_map, size_t *unique_pin_id)
-  : mp_net (0), m_other_net_index (invalid_id)
+  : mp_net (0), m_other_net_index (invalid_id), m_signature (0)
 {
-  std::map<const db::Net *, size_t> n2entry;
+  std::unordered_map<const db::Net *, size_t> n2entry;
+  std::vector<edge_builder_type> edges;
 
   size_t circuit_cat = circuit_categorizer.cat_for_subcircuit (sc);
   tl_assert (circuit_cat != 0);
@@ -358,41 +375,47 @@ NetGraphNode::NetGraphNode (const db::SubCircuit *sc, CircuitCategorizer &circui
 
     Transition ed (sc, circuit_cat, pin_id, original_pin_id);
 
-    std::map<const db::Net *, size_t>::const_iterator in = n2entry.find (net_at_pin);
+    std::unordered_map<const db::Net *, size_t>::const_iterator in = n2entry.find (net_at_pin);
     if (in == n2entry.end ()) {
-      in = n2entry.insert (std::make_pair ((const db::Net *) net_at_pin, m_edges.size ())).first;
-      m_edges.push_back (edge_type (std::vector<Transition> (), std::make_pair (size_t (0), net_at_pin)));
+      in = n2entry.insert (std::make_pair ((const db::Net *) net_at_pin, edges.size ())).first;
+      edges.push_back (edge_builder_type (std::vector<Transition> (), std::make_pair (size_t (0), net_at_pin)));
     }
 
-    m_edges [in->second].first.push_back (ed);
+    edges [in->second].first.push_back (ed);
 
   }
+
+  set_edges (edges);
 }
 
 void
 NetGraphNode::expand_subcircuit_nodes (NetGraph *graph)
 {
-  std::map<const db::Net *, size_t> n2entry;
+  std::unordered_map<const db::Net *, size_t> n2entry;
 
-  std::list<edge_type> sc_edges;
+  std::vector<edge_builder_type> edges;
+  get_edges (edges);
+
+  std::list<edge_builder_type> sc_edges;
 
   size_t ii = 0;
-  for (size_t i = 0; i < m_edges.size (); ++i) {
+  for (size_t i = 0; i < edges.size (); ++i) {
     if (ii != i) {
-      swap_edges (m_edges [ii], m_edges [i]);
+      edges [ii].first.swap (edges [i].first);
+      std::swap (edges [ii].second, edges [i].second);
     }
-    if (m_edges [ii].second.second == 0) {
+    if (edges [ii].second.second == 0) {
       //  subcircuit pin
-      sc_edges.push_back (m_edges [ii]);
+      sc_edges.push_back (edges [ii]);
     } else {
-      n2entry.insert (std::make_pair (m_edges [ii].second.second, ii));
+      n2entry.insert (std::make_pair (edges [ii].second.second, ii));
       ++ii;
     }
   }
 
-  m_edges.erase (m_edges.begin () + ii, m_edges.end ());
+  edges.erase (edges.begin () + ii, edges.end ());
 
-  for (std::list<edge_type>::const_iterator e = sc_edges.begin (); e != sc_edges.end (); ++e) {
+  for (std::list<edge_builder_type>::const_iterator e = sc_edges.begin (); e != sc_edges.end (); ++e) {
 
     const db::SubCircuit *sc = 0;
     for (std::vector<Transition>::const_iterator t = e->first.begin (); t != e->first.end (); ++t) {
@@ -412,24 +435,20 @@ NetGraphNode::expand_subcircuit_nodes (NetGraph *graph)
         continue;
       }
 
-      std::map<const db::Net *, size_t>::const_iterator in = n2entry.find (net_at_pin);
+      std::unordered_map<const db::Net *, size_t>::const_iterator in = n2entry.find (net_at_pin);
       if (in == n2entry.end ()) {
-        in = n2entry.insert (std::make_pair ((const db::Net *) net_at_pin, m_edges.size ())).first;
-        m_edges.push_back (edge_type (std::vector<Transition> (), de->second));
+        in = n2entry.insert (std::make_pair ((const db::Net *) net_at_pin, edges.size ())).first;
+        edges.push_back (edge_builder_type (std::vector<Transition> (), de->second));
       }
 
-      m_edges [in->second].first.insert (m_edges [in->second].first.end (), de->first.begin (), de->first.end ());
+      edges [in->second].first.insert (edges [in->second].first.end (), de->first.begin (), de->first.end ());
 
     }
 
   }
 
-  //  "deep sorting" of the edge descriptor
-  for (std::vector<edge_type>::iterator i = m_edges.begin (); i != m_edges.end (); ++i) {
-    std::sort (i->first.begin (), i->first.end ());
-  }
-
-  std::sort (m_edges.begin (), m_edges.end ());
+  set_edges (edges);
+  finish_edges ();
 }
 
 std::string
@@ -449,7 +468,7 @@ NetGraphNode::to_string () const
 
   for (std::vector<edge_type>::const_iterator e = m_edges.begin (); e != m_edges.end (); ++e) {
     res += "  (\n";
-    for (std::vector<Transition>::const_iterator i = e->first.begin (); i != e->first.end (); ++i) {
+    for (TransitionRange::const_iterator i = e->first.begin (); i != e->first.end (); ++i) {
       res += std::string ("    ") + i->to_string () + "\n";
     }
     res += "  )->";
@@ -464,20 +483,105 @@ NetGraphNode::to_string () const
 }
 
 void
-NetGraphNode::apply_net_index (const std::map<const db::Net *, size_t> &ni)
+NetGraphNode::apply_net_index (const std::unordered_map<const db::Net *, size_t> &ni)
 {
   for (std::vector<edge_type>::iterator i = m_edges.begin (); i != m_edges.end (); ++i) {
-    std::map<const db::Net *, size_t>::const_iterator j = ni.find (i->second.second);
+    std::unordered_map<const db::Net *, size_t>::const_iterator j = ni.find (i->second.second);
     tl_assert (j != ni.end ());
     i->second.first = j->second;
   }
 
-  //  "deep sorting" of the edge descriptor
+  finish_edges ();
+}
+
+void
+NetGraphNode::get_edges (std::vector<edge_builder_type> &edges) const
+{
+  edges.clear ();
+  edges.reserve (m_edges.size ());
+  for (std::vector<edge_type>::const_iterator i = m_edges.begin (); i != m_edges.end (); ++i) {
+    edges.push_back (edge_builder_type (std::vector<Transition> (i->first.begin (), i->first.end ()), i->second));
+  }
+}
+
+void
+NetGraphNode::set_edges (std::vector<edge_builder_type> &edges)
+{
+  size_t n = 0;
+  for (std::vector<edge_builder_type>::const_iterator i = edges.begin (); i != edges.end (); ++i) {
+    n += i->first.size ();
+  }
+
+  m_transitions.clear ();
+  m_transitions.reserve (n);
+  m_edges.clear ();
+  m_edges.reserve (edges.size ());
+
+  for (std::vector<edge_builder_type>::const_iterator i = edges.begin (); i != edges.end (); ++i) {
+    m_transitions.insert (m_transitions.end (), i->first.begin (), i->first.end ());
+  }
+
+  const Transition *t = m_transitions.empty () ? 0 : &m_transitions.front ();
+  for (std::vector<edge_builder_type>::const_iterator i = edges.begin (); i != edges.end (); ++i) {
+    m_edges.push_back (edge_type (TransitionRange (t, t + i->first.size ()), i->second));
+    t += i->first.size ();
+  }
+
+  edges.clear ();
+}
+
+void
+NetGraphNode::rebase_edges (const std::vector<Transition> &from)
+{
+  if (from.empty ()) {
+    return;
+  }
+
   for (std::vector<edge_type>::iterator i = m_edges.begin (); i != m_edges.end (); ++i) {
-    std::sort (i->first.begin (), i->first.end ());
+    i->first.rebase (&from.front (), &m_transitions.front ());
+  }
+}
+
+void
+NetGraphNode::finish_edges ()
+{
+  //  "deep sorting" of the edge descriptor
+  if (! m_transitions.empty ()) {
+    Transition *t0 = &m_transitions.front ();
+    for (std::vector<edge_type>::iterator i = m_edges.begin (); i != m_edges.end (); ++i) {
+      std::sort (t0 + (i->first.begin () - t0), t0 + (i->first.end () - t0));
+    }
   }
 
   std::sort (m_edges.begin (), m_edges.end ());
+
+  //  restore the order of the transition array after sorting the edges, so the
+  //  edges are traversed sequentially
+  std::vector<Transition> transitions;
+  transitions.reserve (m_transitions.size ());
+  for (std::vector<edge_type>::const_iterator i = m_edges.begin (); i != m_edges.end (); ++i) {
+    transitions.insert (transitions.end (), i->first.begin (), i->first.end ());
+  }
+
+  const Transition *t = transitions.empty () ? 0 : &transitions.front ();
+  for (std::vector<edge_type>::iterator i = m_edges.begin (); i != m_edges.end (); ++i) {
+    size_t n = i->first.size ();
+    i->first = TransitionRange (t, t + n);
+    t += n;
+  }
+
+  m_transitions.swap (transitions);
+
+  //  computes the signature from the transitions - the target nets do not contribute as
+  //  they are not considered by "equal"
+  m_signature = 0;
+  for (std::vector<edge_type>::const_iterator i = m_edges.begin (); i != m_edges.end (); ++i) {
+    size_t h = i->first.size ();
+    for (TransitionRange::const_iterator t = i->first.begin (); t != i->first.end (); ++t) {
+      h = tl::hcombine (h, t->hash ());
+    }
+    m_signature = tl::hcombine (m_signature, h);
+  }
 }
 
 bool
@@ -501,7 +605,7 @@ NetGraphNode::less (const NetGraphNode &node, bool with_name) const
 bool
 NetGraphNode::equal (const NetGraphNode &node, bool with_name) const
 {
-  if (m_edges.size () != node.m_edges.size ()) {
+  if (m_signature != node.m_signature || m_edges.size () != node.m_edges.size ()) {
     return false;
   }
   for (size_t i = 0; i < m_edges.size (); ++i) {
@@ -571,15 +675,18 @@ NetGraph::build (const db::Circuit *c, DeviceCategorizer &device_categorizer, Ci
   for (db::Circuit::const_net_iterator n = c->begin_nets (); n != c->end_nets (); ++n) {
     ++nets;
   }
-  m_nodes.reserve (nets);
+  m_nodes.reserve (nets + 1);
 
   for (db::Circuit::const_net_iterator n = c->begin_nets (); n != c->end_nets (); ++n) {
     NetGraphNode node (n.operator-> (), device_categorizer, circuit_categorizer, device_filter, circuit_and_pin_mapping, circuit_pin_mapper, unique_pin_id);
     if (! node.empty () || n->pin_count () > 0) {
-      m_nodes.push_back (node);
+      //  NOTE: swapping avoids copying the edges
+      m_nodes.push_back (NetGraphNode ());
+      m_nodes.back ().swap (node);
     }
   }
 
+  m_net_index.reserve (m_nodes.size ());
   for (std::vector<NetGraphNode>::const_iterator i = m_nodes.begin (); i != m_nodes.end (); ++i) {
     m_net_index.insert (std::make_pair (i->net (), i - m_nodes.begin ()));
   }
@@ -629,10 +736,10 @@ NetGraph::joined (const NetGraphNode &a, const NetGraphNode &b) const
 {
   NetGraphNode nj = a;
 
-  nj.edges ().clear ();
-  nj.edges ().reserve ((a.end () - a.begin ()) + (b.end () - b.begin ()));
+  std::vector<NetGraphNode::edge_builder_type> edges;
+  edges.reserve ((a.end () - a.begin ()) + (b.end () - b.begin ()));
 
-  std::map<const db::Net *, NetGraphNode::edge_type> joined;
+  std::map<const db::Net *, NetGraphNode::edge_builder_type> joined;
 
   for (int m = 0; m < 2; ++m) {
 
@@ -648,12 +755,12 @@ NetGraph::joined (const NetGraphNode &a, const NetGraphNode &b) const
         if (j != joined.end ()) {
           j->second.first.insert (j->second.first.end (), i->first.begin (), i->first.end ());
         } else {
-          j = joined.insert (std::make_pair (net, *i)).first;
+          j = joined.insert (std::make_pair (net, NetGraphNode::edge_builder_type (std::vector<Transition> (i->first.begin (), i->first.end ()), i->second))).first;
           j->second.second.second = net;
         }
 
       } else {
-        nj.edges ().push_back (*i);
+        edges.push_back (NetGraphNode::edge_builder_type (std::vector<Transition> (i->first.begin (), i->first.end ()), i->second));
       }
 
     }
@@ -661,9 +768,10 @@ NetGraph::joined (const NetGraphNode &a, const NetGraphNode &b) const
   }
 
   for (auto i = joined.begin (); i != joined.end (); ++i) {
-    nj.edges ().push_back (i->second);
+    edges.push_back (i->second);
   }
 
+  nj.set_edges (edges);
   nj.apply_net_index (m_net_index);
   return nj;
 }
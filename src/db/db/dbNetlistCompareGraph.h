@@ -31,6 +31,7 @@
 #include <vector>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
 
 namespace db
 {
@@ -90,6 +91,12 @@ public:
   bool operator< (const Transition &other) const;
   bool operator== (const Transition &other) const;
 
+  /**
+   *  @brief Gets a hash value for the transition
+   *  Transitions which are equal in terms of "==" have the same hash value.
+   */
+  size_t hash () const;
+
   std::string to_string () const;
 
   inline bool is_for_subcircuit () const
@@ -128,6 +135,78 @@ private:
   size_t m_id1, m_id2;
 };
 
+/**
+ *  @brief A range of transitions
+ *
+ *  The transitions of a net graph node are stored in a single, contiguous array.
+ *  An edge refers to a section of this array through a transition range.
+ *  The range compares like the vector of transitions it represents.
+ */
+class TransitionRange
+{
+public:
+  typedef const Transition *const_iterator;
+
+  TransitionRange ()
+    : mp_begin (0), mp_end (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  TransitionRange (const Transition *b, const Transition *e)
+    : mp_begin (b), mp_end (e)
+  {
+    //  .. nothing yet ..
+  }
+
+  const_iterator begin () const
+  {
+    return mp_begin;
+  }
+
+  const_iterator end () const
+  {
+    return mp_end;
+  }
+
+  size_t size () const
+  {
+    return mp_end - mp_begin;
+  }
+
+  bool empty () const
+  {
+    return mp_begin == mp_end;
+  }
+
+  bool operator== (const TransitionRange &other) const
+  {
+    return size () == other.size () && std::equal (begin (), end (), other.begin ());
+  }
+
+  bool operator!= (const TransitionRange &other) const
+  {
+    return ! operator== (other);
+  }
+
+  bool operator< (const TransitionRange &other) const
+  {
+    return std::lexicographical_compare (begin (), end (), other.begin (), other.end ());
+  }
+
+  /**
+   *  @brief Moves the range from one transition array to another one
+   */
+  void rebase (const Transition *from, const Transition *to)
+  {
+    mp_end = to + (mp_end - from);
+    mp_begin = to + (mp_begin - from);
+  }
+
+private:
+  const Transition *mp_begin, *mp_end;
+};
+
 /**
  *  @brief A node within the net graph
  *
@@ -139,21 +218,21 @@ private:
  *  of the edge.
  *
  *  Transitions are sorted within the edge.
+ *
+ *  The edges are stored in compressed sparse row form: all transitions of the
+ *  node live in one array, in the order of the edges, and each edge refers to its
+ *  section of this array. Edges are set up in the expanded form ("edge_builder_type")
+ *  and compacted by "set_edges".
  */
 class DB_PUBLIC NetGraphNode
 {
 public:
-  typedef std::pair<std::vector<Transition>, std::pair<size_t, const db::Net *> > edge_type;
-
-  static void swap_edges (edge_type &e1, edge_type &e2)
-  {
-    e1.first.swap (e2.first);
-    std::swap (e1.second, e2.second);
-  }
+  typedef std::pair<TransitionRange, std::pair<size_t, const db::Net *> > edge_type;
+  typedef std::pair<std::vector<Transition>, std::pair<size_t, const db::Net *> > edge_builder_type;
 
   struct EdgeToEdgeOnlyCompare
   {
-    bool operator() (const edge_type &a, const std::vector<Transition> &b) const
+    bool operator() (const edge_type &a, const TransitionRange &b) const
     {
       return a.first < b;
     }
@@ -162,11 +241,31 @@ public:
   typedef std::vector<edge_type>::const_iterator edge_iterator;
 
   NetGraphNode ()
-    : mp_net (0), m_other_net_index (invalid_id)
+    : mp_net (0), m_other_net_index (invalid_id), m_signature (0)
   {
     //  .. nothing yet ..
   }
 
+  NetGraphNode (const NetGraphNode &other)
+    : mp_net (other.mp_net), m_other_net_index (other.m_other_net_index), m_signature (other.m_signature),
+      m_edges (other.m_edges), m_transitions (other.m_transitions)
+  {
+    rebase_edges (other.m_transitions);
+  }
+
+  NetGraphNode &operator= (const NetGraphNode &other)
+  {
+    if (this != &other) {
+      mp_net = other.mp_net;
+      m_other_net_index = other.m_other_net_index;
+      m_signature = other.m_signature;
+      m_edges = other.m_edges;
+      m_transitions = other.m_transitions;
+      rebase_edges (other.m_transitions);
+    }
+    return *this;
+  }
+
   /**
    *  @brief Builds a node for a net
    */
@@ -230,7 +329,17 @@ public:
     return m_edges.empty ();
   }
 
-  void apply_net_index (const std::map<const db::Net *, size_t> &ni);
+  void apply_net_index (const std::unordered_map<const db::Net *, size_t> &ni);
+
+  /**
+   *  @brief Gets the signature of the node
+   *  The signature is a hash value computed from the edges. Nodes which are equal have the same signature.
+   *  The signature is updated when the edges are finalized (e.g. by "apply_net_index").
+   */
+  size_t signature () const
+  {
+    return m_signature;
+  }
 
   bool less (const NetGraphNode &node, bool with_name) const;
   bool equal (const NetGraphNode &node, bool with_name) const;
@@ -249,7 +358,10 @@ public:
   {
     std::swap (m_other_net_index, other.m_other_net_index);
     std::swap (mp_net, other.mp_net);
+    std::swap (m_signature, other.m_signature);
+    //  NOTE: swapping the vectors keeps the transition arrays, so the edges stay valid
     m_edges.swap (other.m_edges);
+    m_transitions.swap (other.m_transitions);
   }
 
   edge_iterator begin () const
@@ -262,7 +374,7 @@ public:
     return m_edges.end ();
   }
 
-  edge_iterator find_edge (const std::vector<Transition> &edge) const
+  edge_iterator find_edge (const TransitionRange &edge) const
   {
     edge_iterator res = std::lower_bound (begin (), end (), edge, EdgeToEdgeOnlyCompare ());
     if (res == end () || res->first != edge) {
@@ -272,15 +384,31 @@ public:
     }
   }
 
-  std::vector<edge_type> &edges ()
-  {
-    return m_edges;
-  }
+  /**
+   *  @brief Gets the edges in the expanded form
+   */
+  void get_edges (std::vector<edge_builder_type> &edges) const;
+
+  /**
+   *  @brief Replaces the edges by the given ones
+   *  The edges are compacted into the node's transition array. The given vector is
+   *  cleared. "apply_net_index" needs to be called afterwards to finalize the edges.
+   */
+  void set_edges (std::vector<edge_builder_type> &edges);
 
 private:
   const db::Net *mp_net;
   size_t m_other_net_index;
+  size_t m_signature;
   std::vector<edge_type> m_edges;
+  std::vector<Transition> m_transitions;
+
+  void rebase_edges (const std::vector<Transition> &from);
+
+  /**
+   *  @brief Sorts the edges and computes the signature
+   */
+  void finish_edges ();
 
   /**
    *  @brief Compares edges as "less"
@@ -368,7 +496,7 @@ public:
    */
   size_t node_index_for_net (const db::Net *net) const
   {
-    std::map<const db::Net *, size_t>::const_iterator j = m_net_index.find (net);
+    std::unordered_map<const db::Net *, size_t>::const_iterator j = m_net_index.find (net);
     tl_assert (j != m_net_index.end ());
     return j->second;
   }
@@ -475,7 +603,7 @@ public:
 private:
   std::vector<NetGraphNode> m_nodes;
   std::map<const db::SubCircuit *, NetGraphNode> m_virtual_nodes;
-  std::map<const db::Net *, size_t> m_net_index;
+  std::unordered_map<const db::Net *, size_t> m_net_index;
   const db::Circuit *mp_circuit;
 };
 
@@ -242,6 +242,12 @@ CircuitPinCategorizer::map_pins (const db::Circuit *circuit, const std::vector<s
   }
 }
 
+void
+CircuitPinCategorizer::prepare_circuit (const db::Circuit *circuit)
+{
+  m_pin_map [circuit];
+}
+
 size_t
 CircuitPinCategorizer::is_mapped (const db::Circuit *circuit, size_t pin_id) const
 {
@@ -168,6 +168,14 @@ public:
   void map_pins (const db::Circuit *circuit, size_t pin1_id, size_t pin2_id);
   void map_pins (const db::Circuit *circuit, const std::vector<size_t> &pin_ids);
 
+  /**
+   *  @brief Creates the (empty) pin map for the given circuit
+   *
+   *  Having the pin map present does not change the categorizer's behavior. But once it is there,
+   *  "map_pins" can be called for this circuit while other threads read the pin maps of other circuits.
+   */
+  void prepare_circuit (const db::Circuit *circuit);
+
   size_t is_mapped (const db::Circuit *circuit, size_t pin_id) const;
   size_t normalize_pin_id (const db::Circuit *circuit, size_t pin_id) const;
 
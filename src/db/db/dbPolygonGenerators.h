@@ -137,6 +137,11 @@ public:
    */
   void resolve_holes (bool f) { m_resolve_holes = f; }
 
+  /**
+   *  @brief Gets a value indicating whether holes are resolved
+   */
+  bool resolve_holes () const { return m_resolve_holes; }
+
   /**
    *  @brief Enables open contours for hole resolution
    *
@@ -149,6 +154,11 @@ public:
    */
   void open_contours (bool f) { m_open_contours = f; }
 
+  /**
+   *  @brief Gets a value indicating whether open contours are used for hole resolution
+   */
+  bool open_contours () const { return m_open_contours; }
+
   /**
    *  @brief Sets the way how touching corners are resolved dynamically
    *
@@ -156,6 +166,11 @@ public:
    */
   void min_coherence (bool f) { m_min_coherence = f; }
 
+  /**
+   *  @brief Gets a value indicating whether touching corners are resolved
+   */
+  bool min_coherence () const { return m_min_coherence; }
+
   /**
    *  @brief Disables or enable compression for polygon contours
    *
@@ -163,6 +178,16 @@ public:
    */
   void enable_compression (bool enable) { m_compress = enable; }
 
+  /**
+   *  @brief Gets a value indicating whether compression is enabled
+   */
+  bool compression_enabled () const { return m_compress; }
+
+  /**
+   *  @brief Gets the polygon sink or 0 if the generator delivers simple polygons
+   */
+  PolygonSink *polygon_sink () const { return mp_psink; }
+
   /**
    *  @brief Disables or enable compression for polygon contours
    *
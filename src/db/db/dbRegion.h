@@ -315,6 +315,26 @@ public:
     return mp_delegate->base_verbosity ();
   }
 
+  /**
+   *  @brief Sets the number of threads to use for flat boolean and merge operations
+   *
+   *  With a value of 1 or more, large flat boolean and merge operations are split
+   *  into horizontal bands which are processed in parallel. The default value is 0
+   *  (no threads).
+   */
+  void set_threads (int n)
+  {
+    mp_delegate->set_threads (n);
+  }
+
+  /**
+   *  @brief Gets the number of threads to use for flat boolean and merge operations
+   */
+  int threads () const
+  {
+    return mp_delegate->threads ();
+  }
+
   /**
    *  @brief Enable progress reporting
    *
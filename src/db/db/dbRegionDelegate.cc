@@ -31,6 +31,7 @@ namespace db
 RegionDelegate::RegionDelegate ()
 {
   m_base_verbosity = 30;
+  m_threads = 0;
   m_report_progress = false;
   m_merged_semantics = true;
   m_join_properties_on_merge = false;
@@ -49,6 +50,7 @@ RegionDelegate::operator= (const RegionDelegate &other)
 {
   if (this != &other) {
     m_base_verbosity = other.m_base_verbosity;
+    m_threads = other.m_threads;
     m_report_progress = other.m_report_progress;
     m_merged_semantics = other.m_merged_semantics;
     m_join_properties_on_merge = other.m_join_properties_on_merge;
@@ -79,6 +81,11 @@ void RegionDelegate::set_base_verbosity (int vb)
   m_base_verbosity = vb;
 }
 
+void RegionDelegate::set_threads (int n)
+{
+  m_threads = n;
+}
+
 void RegionDelegate::set_min_coherence (bool f)
 {
   if (f != m_merge_min_coherence) {
@@ -154,6 +154,12 @@ public:
     return m_base_verbosity;
   }
 
+  void set_threads (int n);
+  int threads () const
+  {
+    return m_threads;
+  }
+
   void enable_progress (const std::string &progress_desc);
   void disable_progress ();
 
@@ -318,6 +324,7 @@ private:
   bool m_report_progress;
   std::string m_progress_desc;
   int m_base_verbosity;
+  int m_threads;
 };
 
 }
@@ -241,6 +241,28 @@ public:
     m_keep_instances = ki;
   }
 
+  /**
+   *  @brief The number of compression threads (getter)
+   *
+   *  If this number is larger than zero, files written with gzip compression
+   *  (i.e. "*.gz" files) are compressed in this many threads. The default is 0
+   *  (single-threaded compression).
+   */
+  int compression_threads () const
+  {
+    return m_compression_threads;
+  }
+
+  /**
+   *  @brief The number of compression threads (setter)
+   *
+   *  See compression_threads for a description of that property.
+   */
+  void set_compression_threads (int n)
+  {
+    m_compression_threads = n > 0 ? n : 0;
+  }
+
   /**
    *  @brief The "write context information" property (getter)
    *
@@ -458,6 +480,7 @@ private:
   bool m_keep_instances;
   bool m_write_context_info;
   bool m_dont_write_empty_cells;
+  int m_compression_threads;
   std::map <std::string, FormatSpecificWriterOptions *> m_options;
 
   void release ();
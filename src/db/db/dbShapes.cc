@@ -307,6 +307,7 @@ Shapes::invalidate_state ()
       unsigned int index = cp->index_of_shapes (this);
       if (index != std::numeric_limits<unsigned int>::max ()) {
         cp->layout ()->invalidate_bboxes (index);
+        cp->invalidate_content_fingerprint (index);
       }
       //  property ID change is implied
       layout ()->invalidate_prop_ids ();
@@ -332,6 +333,15 @@ Shapes::swap (Shapes &d)
   m_layers.swap (d.m_layers);
 }
 
+void
+Shapes::take (Shapes &d)
+{
+  tl_assert (m_layers.empty ());
+  tl_assert (is_editable () == d.is_editable ());
+  m_layers.swap (d.m_layers);
+  set_dirty (d.is_dirty ());
+}
+
 static
 Shapes::shape_type safe_insert_text (Shapes &shapes, const Shapes::shape_type &shape, tl::func_delegate_base <db::properties_id_type> &pm)
 {
@@ -811,6 +811,17 @@ public:
    */
   void swap (Shapes &d);
 
+  /**
+   *  @brief Takes over the contents of another shapes collection
+   *
+   *  This collection must be empty and "d" must have the same editable mode.
+   *  Contrary to "swap", this method does not register an undo operation and
+   *  does not invalidate the layout's state. It is intended for installing shapes
+   *  which have been prepared elsewhere (e.g. by a db::CellContentLoader).
+   *  "d" is empty after this operation.
+   */
+  void take (Shapes &d);
+
   /**
    *  @brief Insert a shape of the given type
    *
@@ -452,12 +452,14 @@ private:
   size_t m_script_index;
 };
 
+class TilingProcessorOutputFunction;
+
 class TilingProcessorWorker
   : public tl::Worker
 {
 public:
   TilingProcessorWorker (TilingProcessorJob *job)
-    : tl::Worker (), mp_job (job)
+    : tl::Worker (), mp_job (job), mp_output_function (0)
   {
     //  .. nothing yet ..
   }
@@ -472,8 +474,12 @@ public:
 
 private:
   TilingProcessorJob *mp_job;
+  std::unique_ptr<tl::Eval> mp_eval;
+  std::map<size_t, tl::Expression> m_scripts;
+  TilingProcessorOutputFunction *mp_output_function;
 
   void do_perform (const TilingProcessorTask *task);
+  void init_eval ();
   void make_input_var (const TilingProcessor::InputSpec &is, const db::RecursiveShapeIterator *iter, tl::Eval &eval, double sf);
 };
 
@@ -500,12 +506,19 @@ class TilingProcessorOutputFunction
   : public tl::EvalFunction
 {
 public:
-  TilingProcessorOutputFunction (TilingProcessor *proc, size_t ix, size_t iy, const db::Box &tile_box)
-    : mp_proc (proc), m_ix (ix), m_iy (iy), m_tile_box (tile_box)
+  TilingProcessorOutputFunction (TilingProcessor *proc)
+    : mp_proc (proc), m_ix (0), m_iy (0)
   {
     //  .. nothing yet ..
   }
 
+  void set_tile (size_t ix, size_t iy, const db::Box &tile_box)
+  {
+    m_ix = ix;
+    m_iy = iy;
+    m_tile_box = tile_box;
+  }
+
   void execute (const tl::ExpressionParserContext & /*context*/, tl::Variant & /*out*/, const std::vector<tl::Variant> &args, const std::map<std::string, tl::Variant> * /*kwargs*/) const
   {
     mp_proc->put (m_ix, m_iy, m_tile_box, args);
@@ -550,10 +563,28 @@ TilingProcessorWorker::make_input_var (const TilingProcessor::InputSpec &is, con
   }
 }
 
+void
+TilingProcessorWorker::init_eval ()
+{
+  //  The evaluation context is kept for all tiles the worker computes. The scripts
+  //  are parsed once per worker and the tile-specific values are supplied as variables.
+  //  As every worker has its own context, tiles are evaluated without sharing state.
+  mp_eval.reset (new tl::Eval (&mp_job->processor ()->top_eval ()));
+
+  mp_output_function = new TilingProcessorOutputFunction (mp_job->processor ());
+  mp_eval->define_function ("_output", mp_output_function);
+  mp_eval->define_function ("_rec", new TilingProcessorReceiverFunction (mp_job->processor ()));
+  mp_eval->define_function ("_count", new TilingProcessorCountFunction (mp_job->processor ()));
+}
+
 void
 TilingProcessorWorker::do_perform (const TilingProcessorTask *tile_task)
 {
-  tl::Eval eval (&mp_job->processor ()->top_eval ());
+  if (! mp_eval.get ()) {
+    init_eval ();
+  }
+
+  tl::Eval &eval = *mp_eval;
 
   db::Box clip_box_dbu = db::Box::world ();
 
@@ -609,9 +640,7 @@ TilingProcessorWorker::do_perform (const TilingProcessorTask *tile_task)
 
   }
 
-  eval.define_function ("_output", new TilingProcessorOutputFunction (mp_job->processor (), tile_task->ix (), tile_task->iy (), clip_box_dbu));
-  eval.define_function ("_rec", new TilingProcessorReceiverFunction (mp_job->processor ()));
-  eval.define_function ("_count", new TilingProcessorCountFunction (mp_job->processor ()));
+  mp_output_function->set_tile (tile_task->ix (), tile_task->iy (), clip_box_dbu);
 
   if (tl::verbosity () >= (mp_job->has_tiles () ? 20 : 10)) {
     tl::info << "TilingProcessor: script #" << (tile_task->script_index () + 1) << ", tile " << tile_task->tile_desc ();
@@ -619,9 +648,27 @@ TilingProcessorWorker::do_perform (const TilingProcessorTask *tile_task)
 
   tl::SelfTimer timer (tl::verbosity () >= (mp_job->has_tiles () ? 21 : 11), "Elapsed time");
 
-  tl::Expression ex;
-  eval.parse (ex, tile_task->script ());
-  ex.execute ();
+  std::map<size_t, tl::Expression>::iterator ex = m_scripts.find (tile_task->script_index ());
+  if (ex == m_scripts.end ()) {
+    ex = m_scripts.insert (std::make_pair (tile_task->script_index (), tl::Expression ())).first;
+    try {
+      eval.parse (ex->second, tile_task->script ());
+      ex->second.optimize ();
+    } catch (...) {
+      m_scripts.erase (ex);
+      throw;
+    }
+  }
+
+  try {
+    ex->second.execute ();
+  } catch (...) {
+    eval.reset_vars ();
+    throw;
+  }
+
+  //  releases the tile's data
+  eval.reset_vars ();
 
   mp_job->next_progress ();
 }
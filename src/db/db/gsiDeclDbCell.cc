@@ -1375,6 +1375,8 @@ write_simple (const db::Cell *cell, const std::string &filename)
   options.add_cell (cell->cell_index ());
   std::string fn = options.set_format_from_filename (filename).second;
 
+  layout->release_source_file (fn);
+
   db::Writer writer (options);
   tl::OutputStream stream (fn);
   writer.write (*layout, stream);
@@ -1392,8 +1394,10 @@ write_options (const db::Cell *cell, const std::string &filename, const db::Save
   options.clear_cells ();
   options.add_cell (cell->cell_index ());
 
+  layout->release_source_file (filename);
+
   db::Writer writer (options);
-  tl::OutputStream stream (filename);
+  tl::OutputStream stream (filename, tl::OutputStream::OM_Auto, false, 0, options.compression_threads ());
   writer.write (*layout, stream);
 }
 
@@ -3060,6 +3064,16 @@ Class<db::Cell> decl_Cell ("db", "Cell",
     "This method has been introduced in version 0.25. "
     "'dbbox' is the preferred synonym since version 0.28.\n"
   ) +
+  gsi::method ("content_fingerprint", &db::Cell::content_fingerprint, gsi::arg ("layer_index"),
+    "@brief Gets a fingerprint of the shapes on the given layer\n"
+    "\n"
+    "The fingerprint is a hash value computed from the shapes and their properties. It does not depend on "
+    "the order of the shapes or the way they are stored. Different fingerprints indicate different shapes, "
+    "identical fingerprints indicate identical shapes with a very high probability. The fingerprint is cached "
+    "until the shapes are modified.\n"
+    "\n"
+    "This method has been added in version 0.30.10."
+  ) +
   gsi::iterator_ext ("each_overlapping_inst", &begin_overlapping_inst, gsi::arg ("b"),
     "@brief Gets the instances overlapping the given rectangle\n"
     "\n"
@@ -85,6 +85,16 @@ static void set_properties_enabled (db::LoadLayoutOptions *options, bool l)
   options->get_options<db::CommonReaderOptions> ().enable_properties = l;
 }
 
+static bool get_lazy_loading (const db::LoadLayoutOptions *options)
+{
+  return options->get_options<db::CommonReaderOptions> ().lazy_loading;
+}
+
+static void set_lazy_loading (db::LoadLayoutOptions *options, bool l)
+{
+  options->get_options<db::CommonReaderOptions> ().lazy_loading = l;
+}
+
 static db::CellConflictResolution get_cell_conflict_resolution (const db::LoadLayoutOptions *options)
 {
   return options->get_options<db::CommonReaderOptions> ().cell_conflict_resolution;
@@ -183,6 +193,24 @@ gsi::ClassExt<db::LoadLayoutOptions> common_reader_options (
     "See \\cell_conflict_resolution for details about this option.\n"
     "\n"
     "This option has been introduced in version 0.27."
+  ) +
+  gsi::method_ext ("lazy_loading?", &get_lazy_loading,
+    "@brief Gets a value indicating whether cell shapes are loaded on demand\n"
+    "See \\lazy_loading= for details about this option.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
+  gsi::method_ext ("lazy_loading=", &set_lazy_loading, gsi::arg ("enabled"),
+    "@brief Specifies whether cell shapes are loaded on demand\n"
+    "If this option is enabled, the reader only loads the cell hierarchy and the instances. "
+    "The shapes of a cell are loaded when they are accessed for the first time. "
+    "This reduces the time to first display for large files, but keeps the file open as long as there are cells "
+    "which have not been loaded yet.\n"
+    "\n"
+    "This option only applies to OASIS and LStream files read from the local file system. "
+    "Other formats and sources ignore this option.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
   ),
   ""
 );
@@ -779,6 +779,8 @@ write_simple (db::Layout *layout, const std::string &filename)
     throw tl::Exception (tl::to_string (tr ("Cannot determine format from filename")));
   }
 
+  layout->release_source_file (ff.second);
+
   db::Writer writer (options);
   tl::OutputStream stream (ff.second);
   writer.write (*layout, stream);
@@ -787,8 +789,10 @@ write_simple (db::Layout *layout, const std::string &filename)
 static void 
 write_options1 (db::Layout *layout, const std::string &filename, const db::SaveLayoutOptions &options)
 {
+  layout->release_source_file (filename);
+
   db::Writer writer (options);
-  tl::OutputStream stream (filename);
+  tl::OutputStream stream (filename, tl::OutputStream::OM_Auto, false, 0, options.compression_threads ());
   writer.write (*layout, stream);
 }
 
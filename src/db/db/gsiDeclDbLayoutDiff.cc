@@ -37,7 +37,8 @@ class LayoutDiff
 public:
   LayoutDiff ()
     : mp_layout_a (0), mp_cell_a (0), m_layer_index_a (0),
-      mp_layout_b (0), mp_cell_b (0), m_layer_index_b (0)
+      mp_layout_b (0), mp_cell_b (0), m_layer_index_b (0),
+      m_threads (0)
   {
     // .. nothing yet ..
   }
@@ -53,7 +54,7 @@ public:
     mp_layout_a = a;
     mp_layout_b = b;
     try {
-      res = db::compare_layouts(*a, *b, flags, tolerance, *this);
+      res = db::compare_layouts(*a, *b, flags, tolerance, *this, m_threads);
       mp_layout_a = mp_layout_b = 0;
     } catch (...) {
       mp_layout_a = mp_layout_b = 0;
@@ -76,7 +77,7 @@ public:
     tl_assert (mp_layout_b != 0);
 
     try {
-      res = db::compare_layouts(*mp_layout_a, a->cell_index (), *mp_layout_b, b->cell_index (), flags, tolerance, *this);
+      res = db::compare_layouts(*mp_layout_a, a->cell_index (), *mp_layout_b, b->cell_index (), flags, tolerance, *this, m_threads);
       mp_layout_a = mp_layout_b = 0;
     } catch (...) {
       mp_layout_a = mp_layout_b = 0;
@@ -352,6 +353,16 @@ public:
     return mp_layout_b->get_properties (m_layer_index_b);
   }
 
+  void set_threads (int threads)
+  {
+    m_threads = threads;
+  }
+
+  int threads () const
+  {
+    return m_threads;
+  }
+
   tl::event<double /*dbu_a*/, double /*dbu_a*/> dbu_differs_event;
   tl::event<const std::string & /*name*/, const tl::Variant & /*value_a*/, const tl::Variant & /*value_b*/> layout_meta_info_differs_event;
   tl::event<const db::LayerProperties & /*a*/> layer_in_a_only_event;
@@ -403,6 +414,7 @@ private:
   const db::Layout *mp_layout_b;
   const db::Cell *mp_cell_b;
   int m_layer_index_b;
+  int m_threads;
 };
 
 static unsigned int f_silent () {
@@ -413,6 +425,10 @@ static unsigned int f_ignore_duplicates () {
   return db::layout_diff::f_ignore_duplicates;
 }
 
+static unsigned int f_no_fingerprints () {
+  return db::layout_diff::f_no_fingerprints;
+}
+
 static unsigned int f_no_text_orientation () {
   return db::layout_diff::f_no_text_orientation;
 }
@@ -475,6 +491,13 @@ gsi::Class<LayoutDiff> decl_LayoutDiff ("db", "LayoutDiff",
     "\n"
     "This option has been introduced in version 0.28.9."
   ) +
+  gsi::constant ("NoFingerprints", &f_no_fingerprints,
+    "@brief Compares all layers in detail\n"
+    "By default, layers are skipped if the shapes have identical content fingerprints (see \\Cell#content_fingerprint). "
+    "With this option present, all layers are compared shape by shape.\n"
+    "\n"
+    "This option has been introduced in version 0.30.10."
+  ) +
   gsi::constant ("NoTextOrientation", &f_no_text_orientation,
     "@brief Ignore text orientation\n"
     "This constant can be used for the flags parameter of \\compare_layouts and \\compare_cells. It can be "
@@ -614,6 +637,20 @@ gsi::Class<LayoutDiff> decl_LayoutDiff ("db", "LayoutDiff",
     "This attribute is the current cell and is set after \\on_begin_layer "
     "and reset after \\on_end_layer."
   ) +
+  gsi::method ("threads=", &LayoutDiff::set_threads, gsi::arg ("n"),
+    "@brief Sets the number of worker threads to use for the compare\n"
+    "If this value is larger than 0, the instances and shapes of the cells are compared by "
+    "the given number of worker threads. The events are still issued from the calling thread and in "
+    "the same order as without threads.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
+  gsi::method ("threads", &LayoutDiff::threads,
+    "@brief Gets the number of worker threads to use for the compare\n"
+    "See \\threads= for details.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
   gsi::event ("on_dbu_differs", &LayoutDiff::dbu_differs_event, gsi::arg ("dbu_a"), gsi::arg ("dbu_b"),
     "@brief This signal indicates a difference in the database units of the layouts\n"
   ) +
@@ -1127,10 +1127,21 @@ Class<db::LayoutToNetlist> decl_dbLayoutToNetlist ("db", "LayoutToNetlist",
   gsi::method ("write|write_l2n", &db::LayoutToNetlist::save, gsi::arg ("path"), gsi::arg ("short_format", false),
     "@brief Writes the extracted netlist to a file.\n"
     "This method employs the native format of KLayout.\n"
+    "\n"
+    "If the file name ends with '.l2nb' (or '.l2nb.gz'), a compact binary variant of the format is written. "
+    "This variant is faster to read and always uses the short keys. The binary format has been introduced in version 0.30.10."
   ) +
-  gsi::method ("read|read_l2n", &db::LayoutToNetlist::load, gsi::arg ("path"),
+  gsi::method ("read|read_l2n", &db::LayoutToNetlist::load, gsi::arg ("path"), gsi::arg ("lazy", false),
     "@brief Reads the extracted netlist from the file.\n"
     "This method employs the native format of KLayout.\n"
+    "The binary variant of the format is detected automatically.\n"
+    "\n"
+    "If 'lazy' is true, the net shapes are not read immediately. Instead they are read when they are needed - for example "
+    "when \\shapes_of_net is called. This saves time and memory if only a few nets are inspected. "
+    "Lazy loading requires the binary variant of the format without compression. For other files, "
+    "this option is ignored.\n"
+    "\n"
+    "The 'lazy' argument has been added in version 0.30.10.\n"
   ) +
   gsi::method ("clear_log_entries", &db::LayoutToNetlist::clear_log_entries,
     "@brief Clears the log entries.\n"
@@ -133,10 +133,15 @@ Class<db::LayoutVsSchematic> decl_dbLayoutVsSchematic (decl_dbLayoutToNetlist, "
   gsi::method ("write", &db::LayoutVsSchematic::save, gsi::arg ("path"), gsi::arg ("short_format", false),
     "@brief Writes the LVS object to a file.\n"
     "This method employs the native format of KLayout.\n"
+    "\n"
+    "If the file name ends with '.lvsb' (or '.lvsb.gz'), a compact binary variant of the format is written. "
+    "This variant is faster to read and always uses the short keys. The binary format has been introduced in version 0.30.10."
   ) +
-  gsi::method ("read", &db::LayoutVsSchematic::load, gsi::arg ("path"),
+  gsi::method ("read", &db::LayoutVsSchematic::load, gsi::arg ("path"), gsi::arg ("lazy", false),
     "@brief Reads the LVS object from the file.\n"
     "This method employs the native format of KLayout.\n"
+    "The binary variant of the format is detected automatically.\n"
+    "See \\LayoutToNetlist#read for a description of the 'lazy' argument. This argument has been added in version 0.30.10.\n"
   ),
   "@brief A generic framework for doing LVS (layout vs. schematic)\n"
   "\n"
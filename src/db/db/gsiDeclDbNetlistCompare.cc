@@ -507,6 +507,20 @@ Class<db::NetlistComparer> decl_dbNetlistComparer ("db", "NetlistComparer",
     "\n"
     "This attribute have been introduced in version 0.28.\n"
   ) +
+  gsi::method ("threads=", &db::NetlistComparer::set_threads, gsi::arg ("n"),
+    "@brief Sets the number of threads to use for the comparison.\n"
+    "With a value of 0 (the default), the circuits are compared one after another. With a value larger than 0, "
+    "circuits which do not depend on each other are compared in parallel using the given number of threads. "
+    "The results and the order of the log events are the same as in the single-threaded case.\n"
+    "\n"
+    "This attribute has been introduced in version 0.30.10.\n"
+  ) +
+  gsi::method ("threads", &db::NetlistComparer::threads,
+    "@brief Gets the number of threads to use for the comparison.\n"
+    "See \\threads= for details about this attribute.\n"
+    "\n"
+    "This attribute has been introduced in version 0.30.10.\n"
+  ) +
   gsi::method ("same_nets", (void (db::NetlistComparer::*) (const db::Net *, const db::Net *, bool)) &db::NetlistComparer::same_nets, gsi::arg ("net_a"), gsi::arg ("net_b"), gsi::arg ("must_match", false),
     "@brief Marks two nets as identical.\n"
     "This makes a net net_a in netlist a identical to the corresponding\n"
@@ -4346,6 +4346,23 @@ Class<db::Region> decl_Region (decl_dbShapeCollection, "db", "Region",
     "\n"
     "This method has been introduced in version 0.26.\n"
   ) +
+  method ("threads=", &db::Region::set_threads, gsi::arg ("n"),
+    "@brief Sets the number of threads to use for flat boolean and merge operations\n"
+    "With a value of 1 or more, large flat booleans, merge and sizing operations split the "
+    "input into horizontal bands which are processed in parallel. The result is the same as "
+    "in single-threaded mode, but the order of the polygons may differ. "
+    "In binary operations, the thread count of the first argument is considered. "
+    "The default value is 0 (no threads). Deep regions use the thread count of the "
+    "deep shape store (see \\DeepShapeStore#threads=).\n"
+    "\n"
+    "This attribute has been added in version 0.30.10.\n"
+  ) +
+  method ("threads", &db::Region::threads,
+    "@brief Gets the number of threads to use for flat boolean and merge operations\n"
+    "See \\threads= for details.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10.\n"
+  ) +
   gsi::method_ext ("fill", &fill_region, gsi::arg ("in_cell"),
                                          gsi::arg ("fill_cell_index"),
                                          gsi::arg ("fc_box"),
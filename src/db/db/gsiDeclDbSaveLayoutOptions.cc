@@ -190,6 +190,21 @@ Class<db::SaveLayoutOptions> decl_SaveLayoutOptions ("db", "SaveLayoutOptions",
     "\n"
     "This method was introduced in version 0.23.\n"
   ) +
+  gsi::method ("compression_threads=", &db::SaveLayoutOptions::set_compression_threads, gsi::arg ("n"),
+    "@brief Sets the number of threads used for gzip compression\n"
+    "\n"
+    "If this value is larger than zero and the output is written with gzip compression (e.g. to a \"*.gz\" file), "
+    "the compression is performed in the given number of threads. The result is a standard gzip file. The default value is 0 (single-threaded compression).\n"
+    "\n"
+    "This method was introduced in version 0.30.10.\n"
+  ) +
+  gsi::method ("compression_threads", &db::SaveLayoutOptions::compression_threads,
+    "@brief Gets the number of threads used for gzip compression\n"
+    "\n"
+    "See \\compression_threads= for details about this property.\n"
+    "\n"
+    "This method was introduced in version 0.30.10.\n"
+  ) +
   gsi::method ("dbu=", &db::SaveLayoutOptions::set_dbu, gsi::arg ("dbu"),
     "@brief Sets the database unit to be used in the stream file\n"
     "\n"
@@ -1182,3 +1182,262 @@ TEST(two_2k)
   run_test2_two(_this, 1000, 3, 0.0, 1000);
   run_test2_two(_this, 1000, 3, 0.0, 1000, true, false /*sub-threshold*/);
 }
+
+struct BoxScannerTestRecorderParallel
+{
+  BoxScannerTestRecorderParallel () : ninit (0), nfinal (0) { }
+
+  void finish (const db::Box *, size_t p) { finished.push_back (p); }
+  void finish1 (const db::Box *, size_t p) { finished.push_back (p); }
+  void finish2 (const db::SimplePolygon *, int p) { finished.push_back (size_t (p) + 1000000); }
+
+  bool stop () const { return false; }
+  void initialize () { ++ninit; }
+  void finalize (bool) { ++nfinal; }
+
+  void add (const db::Box * /*b1*/, size_t p1, const db::Box * /*b2*/, size_t p2)
+  {
+    interactions.push_back (std::make_pair (std::min (p1, p2), std::max (p1, p2)));
+  }
+
+  void add (const db::Box * /*b1*/, size_t p1, const db::SimplePolygon * /*b2*/, int p2)
+  {
+    interactions.push_back (std::make_pair (p1, size_t (p2)));
+  }
+
+  std::vector<std::pair<size_t, size_t> > interactions;
+  std::vector<size_t> finished;
+  int ninit, nfinal;
+};
+
+struct BoxScannerTestRecorderParallelLocked
+  : public BoxScannerTestRecorderParallel
+{
+  void add (const db::Box *b1, size_t p1, const db::Box *b2, size_t p2)
+  {
+    tl::MutexLocker locker (&lock);
+    BoxScannerTestRecorderParallel::add (b1, p1, b2, p2);
+  }
+
+  tl::Mutex lock;
+};
+
+static void
+collect_parallel_results (tl::TestBase *_this, const std::vector<BoxScannerTestRecorderParallel> &recs, std::vector<std::pair<size_t, size_t> > &interactions, std::vector<size_t> &finished, bool two = false)
+{
+  for (std::vector<BoxScannerTestRecorderParallel>::const_iterator r = recs.begin (); r != recs.end (); ++r) {
+
+    interactions.insert (interactions.end (), r->interactions.begin (), r->interactions.end ());
+    finished.insert (finished.end (), r->finished.begin (), r->finished.end ());
+
+    //  every receiver needs to see "finish" once for all objects it has seen interactions with
+    std::vector<size_t> rf (r->finished);
+    std::sort (rf.begin (), rf.end ());
+    EXPECT_EQ (std::unique (rf.begin (), rf.end ()) == rf.end (), true);
+    for (std::vector<std::pair<size_t, size_t> >::const_iterator i = r->interactions.begin (); i != r->interactions.end (); ++i) {
+      EXPECT_EQ (std::binary_search (rf.begin (), rf.end (), i->first), true);
+      //  NOTE: the second objects of the two-layer scanner are finished with an offset
+      EXPECT_EQ (std::binary_search (rf.begin (), rf.end (), two ? i->second + 1000000 : i->second), true);
+    }
+
+  }
+
+  std::sort (interactions.begin (), interactions.end ());
+  std::sort (finished.begin (), finished.end ());
+  //  objects present in multiple strips receive "finish" from multiple receivers
+  finished.erase (std::unique (finished.begin (), finished.end ()), finished.end ());
+}
+
+static void
+run_test_parallel (tl::TestBase *_this, size_t n, db::Coord spread, size_t nstrips, unsigned int threads, bool touch)
+{
+  std::vector<db::Box> bb;
+  for (size_t i = 0; i < n; ++i) {
+    db::Coord x = rand () % spread;
+    db::Coord y = rand () % spread;
+    bb.push_back (db::Box (x, y, x + 10 + rand () % 200, y + 10 + rand () % 200));
+  }
+  bb.push_back (db::Box ());  //  an empty one
+
+  //  NOTE: the scanners drop empty boxes, so we need two of them
+  db::box_scanner<db::Box, size_t> bs, bs_serial;
+  for (std::vector<db::Box>::const_iterator b = bb.begin (); b != bb.end (); ++b) {
+    bs.insert (&*b, b - bb.begin ());
+    bs_serial.insert (&*b, b - bb.begin ());
+  }
+
+  BoxScannerTestRecorderParallel tr_serial;
+  bs_serial.process (tr_serial, touch ? 1 : 0, db::box_convert<db::Box> ());
+
+  std::vector<BoxScannerTestRecorderParallel> recs (nstrips);
+  std::vector<BoxScannerTestRecorderParallel *> rec_ptrs;
+  for (std::vector<BoxScannerTestRecorderParallel>::iterator r = recs.begin (); r != recs.end (); ++r) {
+    rec_ptrs.push_back (&*r);
+  }
+
+  EXPECT_EQ (bs.process_parallel (rec_ptrs, threads, touch ? 1 : 0, db::box_convert<db::Box> ()), true);
+
+  for (std::vector<BoxScannerTestRecorderParallel>::const_iterator r = recs.begin (); r != recs.end (); ++r) {
+    EXPECT_EQ (r->ninit, 1);
+    EXPECT_EQ (r->nfinal, 1);
+  }
+
+  std::vector<std::pair<size_t, size_t> > interactions;
+  std::vector<size_t> finished;
+  collect_parallel_results (_this, recs, interactions, finished);
+
+  std::sort (tr_serial.interactions.begin (), tr_serial.interactions.end ());
+  std::sort (tr_serial.finished.begin (), tr_serial.finished.end ());
+
+  EXPECT_EQ (tr_serial.interactions.empty (), false);
+  //  NOTE: vectors, so this also checks that every interaction is reported once
+  EXPECT_EQ (interactions == tr_serial.interactions, true);
+  EXPECT_EQ (finished == tr_serial.finished, true);
+}
+
+TEST(parallel_1)
+{
+  run_test_parallel (_this, 5000, 20000, 4, 2, true);
+  run_test_parallel (_this, 5000, 20000, 4, 2, false);
+}
+
+TEST(parallel_1a)
+{
+  //  sequential strips
+  run_test_parallel (_this, 5000, 20000, 7, 0, true);
+  //  many strips
+  run_test_parallel (_this, 2000, 5000, 64, 4, true);
+  //  too few objects for strips
+  run_test_parallel (_this, 20, 500, 4, 2, true);
+}
+
+TEST(parallel_1b)
+{
+  //  a thread-safe receiver shared by all strips
+  std::vector<db::Box> bb;
+  for (size_t i = 0; i < 5000; ++i) {
+    db::Coord x = rand () % 20000;
+    db::Coord y = rand () % 20000;
+    bb.push_back (db::Box (x, y, x + 150, y + 150));
+  }
+
+  db::box_scanner<db::Box, size_t> bs;
+  for (std::vector<db::Box>::const_iterator b = bb.begin (); b != bb.end (); ++b) {
+    bs.insert (&*b, b - bb.begin ());
+  }
+
+  BoxScannerTestRecorderParallel tr_serial;
+  bs.process (tr_serial, 1, db::box_convert<db::Box> ());
+
+  BoxScannerTestRecorderParallelLocked tr;
+  std::vector<BoxScannerTestRecorderParallelLocked *> rec_ptrs (4, &tr);
+  bs.process_parallel (rec_ptrs, 4, 1, db::box_convert<db::Box> ());
+
+  EXPECT_EQ (tr.ninit, 1);
+  EXPECT_EQ (tr.nfinal, 1);
+
+  std::sort (tr.interactions.begin (), tr.interactions.end ());
+  std::sort (tr_serial.interactions.begin (), tr_serial.interactions.end ());
+  EXPECT_EQ (tr.interactions == tr_serial.interactions, true);
+  EXPECT_EQ (tr.finished.size (), bb.size ());
+}
+
+static void
+run_test_parallel_two (tl::TestBase *_this, size_t n1, size_t n2, db::Coord spread, size_t nstrips, unsigned int threads, bool touch)
+{
+  std::vector<db::Box> bb;
+  for (size_t i = 0; i < n1; ++i) {
+    db::Coord x = rand () % spread;
+    db::Coord y = rand () % spread;
+    bb.push_back (db::Box (x, y, x + 100, y + 100));
+  }
+
+  std::vector<db::SimplePolygon> bb2;
+  for (size_t i = 0; i < n2; ++i) {
+    db::Coord x = rand () % spread;
+    db::Coord y = rand () % spread;
+    bb2.push_back (db::SimplePolygon (db::Box (x, y, x + 10 + rand () % 300, y + 100)));
+  }
+
+  db::box_scanner2<db::Box, size_t, db::SimplePolygon, int> bs;
+  for (std::vector<db::Box>::const_iterator b = bb.begin (); b != bb.end (); ++b) {
+    bs.insert1 (&*b, b - bb.begin ());
+  }
+  for (std::vector<db::SimplePolygon>::const_iterator b2 = bb2.begin (); b2 != bb2.end (); ++b2) {
+    bs.insert2 (&*b2, int (b2 - bb2.begin ()));
+  }
+
+  db::box_convert<db::Box> bc1;
+  db::box_convert<db::SimplePolygon> bc2;
+
+  BoxScannerTestRecorderParallel tr_serial;
+  bs.process (tr_serial, touch ? 1 : 0, bc1, bc2);
+
+  std::vector<BoxScannerTestRecorderParallel> recs (nstrips);
+  std::vector<BoxScannerTestRecorderParallel *> rec_ptrs;
+  for (std::vector<BoxScannerTestRecorderParallel>::iterator r = recs.begin (); r != recs.end (); ++r) {
+    rec_ptrs.push_back (&*r);
+  }
+
+  EXPECT_EQ (bs.process_parallel (rec_ptrs, threads, touch ? 1 : 0, bc1, bc2), true);
+
+  std::vector<std::pair<size_t, size_t> > interactions;
+  std::vector<size_t> finished;
+  collect_parallel_results (_this, recs, interactions, finished, true);
+
+  std::sort (tr_serial.interactions.begin (), tr_serial.interactions.end ());
+  std::sort (tr_serial.finished.begin (), tr_serial.finished.end ());
+
+  EXPECT_EQ (tr_serial.interactions.empty (), false);
+  EXPECT_EQ (interactions == tr_serial.interactions, true);
+  EXPECT_EQ (finished == tr_serial.finished, true);
+}
+
+TEST(parallel_two_1)
+{
+  run_test_parallel_two (_this, 3000, 2000, 20000, 4, 2, true);
+  run_test_parallel_two (_this, 3000, 2000, 20000, 4, 2, false);
+  run_test_parallel_two (_this, 100, 5000, 20000, 16, 0, true);
+  run_test_parallel_two (_this, 5000, 100, 20000, 3, 3, true);
+}
+
+//  benchmark: single sweep vs. parallel strips
+TEST(parallel_benchmark)
+{
+  test_is_long_runner ();
+
+  std::vector<db::Box> bb;
+  for (size_t i = 0; i < 2000000; ++i) {
+    db::Coord x = rand () % 2000000;
+    db::Coord y = rand () % 2000000;
+    bb.push_back (db::Box (x, y, x + 10 + rand () % 1000, y + 10 + rand () % 1000));
+  }
+
+  db::box_scanner<db::Box, size_t> bs;
+  for (std::vector<db::Box>::const_iterator b = bb.begin (); b != bb.end (); ++b) {
+    bs.insert (&*b, b - bb.begin ());
+  }
+
+  BoxScannerTestRecorderParallel tr_serial;
+  {
+    tl::SelfTimer timer ("box-scanner (single sweep)");
+    bs.process (tr_serial, 1, db::box_convert<db::Box> ());
+  }
+
+  std::vector<BoxScannerTestRecorderParallel> recs (16);
+  std::vector<BoxScannerTestRecorderParallel *> rec_ptrs;
+  for (std::vector<BoxScannerTestRecorderParallel>::iterator r = recs.begin (); r != recs.end (); ++r) {
+    rec_ptrs.push_back (&*r);
+  }
+
+  {
+    tl::SelfTimer timer ("box-scanner (parallel, 4 threads)");
+    bs.process_parallel (rec_ptrs, 4, 1, db::box_convert<db::Box> ());
+  }
+
+  size_t n = 0;
+  for (std::vector<BoxScannerTestRecorderParallel>::const_iterator r = recs.begin (); r != recs.end (); ++r) {
+    n += r->interactions.size ();
+  }
+  EXPECT_EQ (n, tr_serial.interactions.size ());
+}
@@ -1145,3 +1145,61 @@ TEST(11_HasShapesTouchingWithHier)
   EXPECT_EQ (a.has_shapes_touching (l1, db::Box (300, 100, 310, 110)), true);
   EXPECT_EQ (a.has_shapes_touching (l1, db::Box (300, 400, 310, 410)), false);
 }
+
+TEST(12_ContentFingerprint)
+{
+  db::Layout ly (true);
+  unsigned int l1 = ly.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = ly.insert_layer (db::LayerProperties (2, 0));
+
+  db::Cell &a = ly.cell (ly.add_cell ("A"));
+  db::Cell &b = ly.cell (ly.add_cell ("B"));
+
+  EXPECT_EQ (a.content_fingerprint (l1) == b.content_fingerprint (l1), true);
+
+  db::Polygon poly (db::Box (0, 0, 100, 200));
+
+  //  different order and storage types
+  a.shapes (l1).insert (db::Box (0, 0, 100, 100));
+  a.shapes (l1).insert (poly);
+  a.shapes (l1).insert (db::Text ("T", db::Trans (db::Vector (10, 20))));
+  a.shapes (l2).insert (db::Edge (0, 0, 100, 100));
+
+  b.shapes (l1).insert (db::Text ("T", db::Trans (db::Vector (10, 20))));
+  b.shapes (l1).insert (db::PolygonRef (poly, ly.shape_repository ()));
+  b.shapes (l1).insert (db::Box (0, 0, 100, 100));
+
+  EXPECT_EQ (a.content_fingerprint (l1) == b.content_fingerprint (l1), true);
+  EXPECT_EQ (a.content_fingerprint (l2) == b.content_fingerprint (l2), false);
+
+  //  the cached fingerprint is invalidated on change
+  db::Shape t = *b.shapes (l1).begin (db::ShapeIterator::Texts);
+  b.shapes (l1).replace (t, db::Text ("U", db::Trans (db::Vector (10, 20))));
+  EXPECT_EQ (a.content_fingerprint (l1) == b.content_fingerprint (l1), false);
+
+  b.shapes (l1).replace (*b.shapes (l1).begin (db::ShapeIterator::Texts), db::Text ("T", db::Trans (db::Vector (10, 20))));
+  EXPECT_EQ (a.content_fingerprint (l1) == b.content_fingerprint (l1), true);
+
+  //  text details and properties are part of the fingerprint
+  b.shapes (l1).replace (*b.shapes (l1).begin (db::ShapeIterator::Texts), db::Text ("T", db::Trans (db::Vector (10, 20)), 5));
+  EXPECT_EQ (a.content_fingerprint (l1) == b.content_fingerprint (l1), false);
+
+  b.shapes (l1).replace (*b.shapes (l1).begin (db::ShapeIterator::Texts), db::Text ("T", db::Trans (db::Vector (10, 20))));
+  EXPECT_EQ (a.content_fingerprint (l1) == b.content_fingerprint (l1), true);
+
+  db::PropertiesSet props;
+  props.insert (tl::Variant ("id"), 17);
+  b.shapes (l1).replace_prop_id (*b.shapes (l1).begin (db::ShapeIterator::Boxes), db::properties_id (props));
+  EXPECT_EQ (a.content_fingerprint (l1) == b.content_fingerprint (l1), false);
+
+  //  duplicates count
+  a.shapes (l2).insert (db::Edge (0, 0, 100, 100));
+  b.shapes (l2).insert (db::Edge (0, 0, 100, 100));
+  EXPECT_EQ (a.content_fingerprint (l2) == b.content_fingerprint (l2), false);
+  b.shapes (l2).insert (db::Edge (0, 0, 100, 100));
+  EXPECT_EQ (a.content_fingerprint (l2) == b.content_fingerprint (l2), true);
+
+  b.clear (l2);
+  EXPECT_EQ (a.content_fingerprint (l2) == b.content_fingerprint (l2), false);
+  EXPECT_EQ (b.content_fingerprint (l2) == b.content_fingerprint (ly.insert_layer ()), true);
+}
@@ -2818,3 +2818,245 @@ TEST(136)
 
   db::compare_layouts (_this, lr, au_fn);
 }
+
+static std::vector<db::Polygon> band_test_merge (const std::vector<db::Polygon> &in, int threads, bool min_coherence, int mode)
+{
+  db::EdgeProcessor ep;
+  ep.set_threads (threads);
+
+  db::EdgeProcessor::property_type n = 0;
+  for (std::vector<db::Polygon>::const_iterator p = in.begin (); p != in.end (); ++p, ++n) {
+    //  mode < 0: merge, 0: AND, 1: XOR of even and odd polygons
+    ep.insert (*p, mode < 0 ? n : (n % 2));
+  }
+
+  std::vector<db::Polygon> out;
+  db::PolygonContainer pc (out);
+  db::PolygonGenerator pg (pc, false /*don't resolve holes*/, min_coherence);
+
+  if (mode < 0) {
+    db::MergeOp op (0);
+    ep.process (pg, op);
+  } else {
+    db::BooleanOp op (mode == 0 ? db::BooleanOp::And : db::BooleanOp::Xor);
+    ep.process (pg, op);
+  }
+
+  std::sort (out.begin (), out.end ());
+  return out;
+}
+
+//  band-parallel mode
+TEST(137)
+{
+  srand (17);
+
+  std::vector<db::Polygon> in;
+
+  for (int i = 0; i < 400; ++i) {
+    db::Coord x = rand () % 10000, y = rand () % 10000;
+    in.push_back (db::Polygon (db::Box (x, y, x + 10 + rand () % 800, y + 10 + rand () % 800)));
+  }
+
+  //  some all-angle polygons which must not be cut at band boundaries
+  for (int i = 0; i < 50; ++i) {
+    db::Coord x = rand () % 10000, y = rand () % 10000;
+    db::Point pts[] = { db::Point (x, y), db::Point (x + 100 + rand () % 500, y + rand () % 500), db::Point (x + rand () % 300, y + 100 + rand () % 700) };
+    db::Polygon p;
+    p.assign_hull (pts, pts + sizeof (pts) / sizeof (pts[0]));
+    in.push_back (p);
+  }
+
+  db::EdgeProcessor::set_min_edges_per_band_global (50);
+
+  try {
+
+    for (int mode = -1; mode <= 1; ++mode) {
+      for (int mc = 0; mc < 2; ++mc) {
+        std::vector<db::Polygon> serial = band_test_merge (in, 0, mc != 0, mode);
+        std::vector<db::Polygon> bands = band_test_merge (in, 4, mc != 0, mode);
+        EXPECT_EQ (serial.empty (), false);
+        EXPECT_EQ (bands.size (), serial.size ());
+        EXPECT_EQ (bands == serial, true);
+      }
+    }
+
+    //  redo after band-parallel processing
+    db::EdgeProcessor ep;
+    ep.set_threads (4);
+    ep.insert_sequence (in.begin (), in.end ());
+
+    std::vector<db::Polygon> out, out2;
+    db::PolygonContainer pc (out), pc2 (out2);
+    db::PolygonGenerator pg (pc, false, true), pg2 (pc2, false, true);
+    db::SimpleMerge op (1);
+    ep.process (pg, op);
+    ep.redo (pg2, op);
+
+    std::sort (out.begin (), out.end ());
+    std::sort (out2.begin (), out2.end ());
+    EXPECT_EQ (out == out2, true);
+    EXPECT_EQ (out == band_test_merge (in, 0, true, -1), true);
+
+  } catch (...) {
+    db::EdgeProcessor::set_min_edges_per_band_global (20000);
+    throw;
+  }
+
+  db::EdgeProcessor::set_min_edges_per_band_global (20000);
+}
+
+static void random_polygons (std::vector<db::Polygon> &out, size_t n, db::Coord extent, bool manhattan)
+{
+  for (size_t i = 0; i < n; ++i) {
+    db::Coord x = rand () % extent, y = rand () % extent;
+    if (manhattan) {
+      out.push_back (db::Polygon (db::Box (x, y, x + 10 + rand () % 500, y + 10 + rand () % 500)));
+    } else {
+      db::Point pts[] = { db::Point (x, y), db::Point (x + 10 + rand () % 500, y + rand () % 500), db::Point (x + rand () % 300, y + 10 + rand () % 500) };
+      db::Polygon p;
+      p.assign_hull (pts, pts + sizeof (pts) / sizeof (pts[0]));
+      out.push_back (p);
+    }
+  }
+}
+
+static void run_fast_scan_test (tl::TestBase *_this, size_t n, db::Coord extent, bool manhattan)
+{
+  srand (42);
+
+  std::vector<db::Polygon> a, b;
+  random_polygons (a, n, extent, manhattan);
+  random_polygons (b, n, extent, manhattan);
+
+  std::vector<db::Polygon> out_merge [2], out_and [2], out_size [2];
+
+  for (int fast = 0; fast < 2; ++fast) {
+
+    db::EdgeProcessor ep;
+    ep.set_fast_scan (fast != 0);
+
+    std::string mode = std::string (fast ? "fast scan" : "plain scan") + (manhattan ? ", manhattan" : ", any angle");
+
+    {
+      tl::SelfTimer timer (tl::verbosity () >= 10, "merge (" + mode + ")");
+      ep.merge (a, out_merge [fast], 0, false, true);
+    }
+
+    {
+      tl::SelfTimer timer (tl::verbosity () >= 10, "boolean AND (" + mode + ")");
+      ep.boolean (a, b, out_and [fast], db::BooleanOp::And, false, true);
+    }
+
+    {
+      tl::SelfTimer timer (tl::verbosity () >= 10, "size (" + mode + ")");
+      ep.size (a, 20, out_size [fast], 2, false, true);
+    }
+
+    std::sort (out_merge [fast].begin (), out_merge [fast].end ());
+    std::sort (out_and [fast].begin (), out_and [fast].end ());
+    std::sort (out_size [fast].begin (), out_size [fast].end ());
+
+  }
+
+  EXPECT_EQ (out_merge [0].empty (), false);
+  EXPECT_EQ (out_merge [0] == out_merge [1], true);
+  EXPECT_EQ (out_and [0].empty (), false);
+  EXPECT_EQ (out_and [0] == out_and [1], true);
+  EXPECT_EQ (out_size [0].empty (), false);
+  EXPECT_EQ (out_size [0] == out_size [1], true);
+}
+
+//  fast scan vs. plain scan
+TEST(138)
+{
+  run_fast_scan_test (_this, 2000, 20000, false);
+  run_fast_scan_test (_this, 2000, 20000, true);
+}
+
+//  fast scan vs. plain scan (benchmark)
+TEST(138_benchmark)
+{
+  test_is_long_runner ();
+  run_fast_scan_test (_this, 200000, 400000, false);
+  run_fast_scan_test (_this, 200000, 400000, true);
+}
+
+//  Manhattan mode vs. generic scan
+TEST(139)
+{
+  srand (17);
+
+  std::vector<db::Polygon> a, b;
+  random_polygons (a, 2000, 20000, true);
+  random_polygons (b, 2000, 20000, true);
+
+  //  add some coincident edges and touching boxes
+  for (size_t i = 0; i < 200; ++i) {
+    db::Box bx = a [i].box ();
+    b.push_back (db::Polygon (db::Box (bx.left (), bx.bottom () + 5, bx.right (), bx.top () + 50)));
+    b.push_back (db::Polygon (db::Box (bx.right (), bx.bottom (), bx.right () + 100, bx.top ())));
+  }
+
+  std::vector<db::Polygon> out_merge [2], out_merge_mc [2], out_xor [2], out_size [2];
+  std::vector<db::Edge> out_edges [2];
+
+  for (int m = 0; m < 2; ++m) {
+
+    db::EdgeProcessor ep;
+    ep.set_manhattan_mode (m != 0);
+    EXPECT_EQ (ep.manhattan_mode (), m != 0);
+
+    std::string mode = m ? "manhattan mode" : "generic";
+
+    {
+      tl::SelfTimer timer (tl::verbosity () >= 10, "merge (" + mode + ")");
+      ep.merge (a, out_merge [m], 0, false, true);
+    }
+
+    ep.merge (b, out_merge_mc [m], 1, true, false);
+
+    {
+      tl::SelfTimer timer (tl::verbosity () >= 10, "boolean XOR (" + mode + ")");
+      ep.boolean (a, b, out_xor [m], db::BooleanOp::Xor, false, true);
+    }
+
+    {
+      tl::SelfTimer timer (tl::verbosity () >= 10, "size (" + mode + ")");
+      ep.size (a, -3, out_size [m], 2, false, true);
+    }
+
+    //  edge selection (includes horizontal edges)
+    ep.clear ();
+    for (std::vector<db::Polygon>::const_iterator p = a.begin (); p != a.end (); ++p) {
+      ep.insert (*p, 0);
+    }
+    for (std::vector<db::Polygon>::const_iterator p = b.begin (); p != b.end (); ++p) {
+      for (db::Polygon::polygon_edge_iterator e = p->begin_edge (); ! e.at_end (); ++e) {
+        ep.insert (*e, 1);
+      }
+    }
+
+    db::EdgeContainer ec (out_edges [m]);
+    db::EdgePolygonOp op (db::EdgePolygonOp::Inside, true);
+    ep.process (ec, op);
+
+    std::sort (out_merge [m].begin (), out_merge [m].end ());
+    std::sort (out_merge_mc [m].begin (), out_merge_mc [m].end ());
+    std::sort (out_xor [m].begin (), out_xor [m].end ());
+    std::sort (out_size [m].begin (), out_size [m].end ());
+    std::sort (out_edges [m].begin (), out_edges [m].end ());
+
+  }
+
+  EXPECT_EQ (out_merge [0].empty (), false);
+  EXPECT_EQ (out_merge [0] == out_merge [1], true);
+  EXPECT_EQ (out_merge_mc [0].empty (), false);
+  EXPECT_EQ (out_merge_mc [0] == out_merge_mc [1], true);
+  EXPECT_EQ (out_xor [0].empty (), false);
+  EXPECT_EQ (out_xor [0] == out_xor [1], true);
+  EXPECT_EQ (out_size [0].empty (), false);
+  EXPECT_EQ (out_size [0] == out_size [1], true);
+  EXPECT_EQ (out_edges [0].empty (), false);
+  EXPECT_EQ (out_edges [0] == out_edges [1], true);
+}
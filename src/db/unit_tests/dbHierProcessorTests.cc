@@ -135,6 +135,26 @@ private:
   db::Coord m_dist;
 };
 
+/**
+ *  @brief A bool operation which computes the subjects one by one
+ *  This enables the split cell mode of the hierarchical processor.
+ */
+class SingleSubjectBoolAndOrNotLocalOperation
+  : public db::BoolAndOrNotLocalOperation
+{
+public:
+  SingleSubjectBoolAndOrNotLocalOperation (bool is_and)
+    : db::BoolAndOrNotLocalOperation (is_and)
+  {
+    //  .. nothing yet ..
+  }
+
+  virtual bool requests_single_subjects () const
+  {
+    return true;
+  }
+};
+
 /**
  *  @brief Turns a layer into polygons and polygon references
  *  The hierarchical processor needs polygon references and can't work on polygons directly.
@@ -1372,3 +1392,66 @@ TEST(XORTool)
 
   db::compare_layouts (_this, ly_out, fn_au, db::WriteOAS);
 }
+
+static std::string run_split_cell_test (const char *file, bool is_and, unsigned int nthreads, size_t split_cell_threshold)
+{
+  db::Layout layout_org;
+
+  unsigned int l1 = 0, l2 = 0, lout = 0;
+
+  {
+    tl::InputStream stream (testdata (file));
+    db::Reader reader (stream);
+    reader.read (layout_org);
+  }
+
+  l1 = layout_org.get_layer (db::LayerProperties (1, 0));
+  l2 = layout_org.get_layer (db::LayerProperties (2, 0));
+  lout = layout_org.insert_layer (db::LayerProperties (100, 0));
+
+  normalize_layer (layout_org, l1);
+  normalize_layer (layout_org, l2);
+
+  SingleSubjectBoolAndOrNotLocalOperation op (is_and);
+
+  db::local_processor<db::PolygonRef, db::PolygonRef, db::PolygonRef> proc (&layout_org, &layout_org.cell (*layout_org.begin_top_down ()));
+  proc.set_threads (nthreads);
+  proc.set_split_cell_threshold (split_cell_threshold);
+  proc.run (&op, l1, l2, lout);
+
+  std::vector<std::string> shapes;
+  for (db::Layout::const_iterator c = layout_org.begin (); c != layout_org.end (); ++c) {
+    for (db::Shapes::shape_iterator s = c->shapes (lout).begin (db::ShapeIterator::All); ! s.at_end (); ++s) {
+      db::Polygon poly;
+      s->polygon (poly);
+      shapes.push_back (std::string (layout_org.cell_name (c->cell_index ())) + ":" + poly.to_string ());
+    }
+  }
+
+  std::sort (shapes.begin (), shapes.end ());
+  return tl::join (shapes, "\n");
+}
+
+//  split cell mode: the results need to be identical to the non-split mode
+TEST(SplitCells1)
+{
+  std::string au_and = run_split_cell_test ("hlp2.oas", true, 0, 0);
+  std::string au_not = run_split_cell_test ("hlp2.oas", false, 0, 0);
+
+  EXPECT_EQ (au_and.empty (), false);
+  EXPECT_EQ (au_not.empty (), false);
+
+  EXPECT_EQ (run_split_cell_test ("hlp2.oas", true, 4, 0), au_and);
+  EXPECT_EQ (run_split_cell_test ("hlp2.oas", false, 4, 0), au_not);
+  EXPECT_EQ (run_split_cell_test ("hlp2.oas", true, 4, 1), au_and);
+  EXPECT_EQ (run_split_cell_test ("hlp2.oas", false, 4, 1), au_not);
+}
+
+TEST(SplitCells2)
+{
+  std::string au_and = run_split_cell_test ("hlp6.oas", true, 0, 0);
+  std::string au_not = run_split_cell_test ("hlp6.oas", false, 0, 0);
+
+  EXPECT_EQ (run_split_cell_test ("hlp6.oas", true, 4, 1), au_and);
+  EXPECT_EQ (run_split_cell_test ("hlp6.oas", false, 4, 1), au_not);
+}
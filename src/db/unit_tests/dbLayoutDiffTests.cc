@@ -1736,3 +1736,111 @@ TEST(9)
     "layout_diff: cell meta info differs for cell B - b3: q vs. nil\n"
   );
 }
+
+//  threaded compare delivers the same differences in the same order
+TEST(10)
+{
+  db::Layout a;
+  db::Layout b;
+
+  unsigned int la1 = a.insert_layer (db::LayerProperties (1, 0));
+  unsigned int la2 = a.insert_layer (db::LayerProperties (2, 0));
+  unsigned int lb1 = b.insert_layer (db::LayerProperties (1, 0));
+  unsigned int lb2 = b.insert_layer (db::LayerProperties (2, 0));
+
+  db::cell_index_type ta = a.add_cell ("TOP");
+  db::cell_index_type tb = b.add_cell ("TOP");
+
+  for (int i = 0; i < 40; ++i) {
+
+    std::string cn = "C" + tl::to_string (i);
+    db::Cell &ca = a.cell (a.add_cell (cn.c_str ()));
+    db::Cell &cb = b.cell (b.add_cell (cn.c_str ()));
+
+    for (int j = 0; j < 20; ++j) {
+      ca.shapes (la1).insert (db::Box (j * 100, 0, j * 100 + 50, 50 + i));
+      cb.shapes (lb1).insert (db::Box (j * 100, 0, j * 100 + 50, 50 + i + ((i + j) % 13 == 0 ? 1 : 0)));
+      ca.shapes (la2).insert (db::Polygon (db::Box (0, j * 100, 50 + i, j * 100 + 50)));
+      if (i % 7 != 3) {
+        cb.shapes (lb2).insert (db::Polygon (db::Box (0, j * 100, 50 + i, j * 100 + 50)));
+      }
+      ca.shapes (la2).insert (db::Text ("T" + tl::to_string (j), db::Trans (db::Vector (j, i))));
+      cb.shapes (lb2).insert (db::Text ("T" + tl::to_string (i % 5 == 1 ? j + 1 : j), db::Trans (db::Vector (j, i))));
+    }
+
+    a.cell (ta).insert (db::CellInstArray (db::CellInst (ca.cell_index ()), db::Trans (db::Vector (0, i * 1000))));
+    b.cell (tb).insert (db::CellInstArray (db::CellInst (cb.cell_index ()), db::Trans (db::Vector (i % 11 == 4 ? 10 : 0, i * 1000))));
+
+  }
+
+  TestDifferenceReceiver r;
+
+  bool eq = db::compare_layouts (a, b, db::layout_diff::f_verbose, 0, r);
+  EXPECT_EQ (eq, false);
+  std::string serial = r.text ();
+
+  for (int threads = 1; threads <= 4; ++threads) {
+    r.clear ();
+    eq = db::compare_layouts (a, b, db::layout_diff::f_verbose, 0, r, threads);
+    EXPECT_EQ (eq, false);
+    EXPECT_EQ (r.text () == serial, true);
+  }
+
+  r.clear ();
+  eq = db::compare_layouts (a, b, 0, 0, r);
+  serial = r.text ();
+
+  r.clear ();
+  eq = db::compare_layouts (a, b, 0, 0, r, 3);
+  EXPECT_EQ (eq, false);
+  EXPECT_EQ (r.text () == serial, true);
+
+  r.clear ();
+  eq = db::compare_layouts (a, b, db::layout_diff::f_silent, 0, r, 3);
+  EXPECT_EQ (eq, false);
+  EXPECT_EQ (r.text (), "");
+
+  r.clear ();
+  eq = db::compare_layouts (a, a, db::layout_diff::f_verbose, 0, r, 3);
+  EXPECT_EQ (eq, true);
+}
+
+//  layers with identical fingerprints are skipped
+TEST(11)
+{
+  db::Layout a;
+  db::Layout b;
+
+  unsigned int la1 = a.insert_layer (db::LayerProperties (1, 0));
+  unsigned int la2 = a.insert_layer (db::LayerProperties (2, 0));
+  unsigned int lb1 = b.insert_layer (db::LayerProperties (1, 0));
+  unsigned int lb2 = b.insert_layer (db::LayerProperties (2, 0));
+
+  db::Cell &ca = a.cell (a.add_cell ("A"));
+  db::Cell &cb = b.cell (b.add_cell ("A"));
+
+  for (int i = 0; i < 10; ++i) {
+    ca.shapes (la1).insert (db::Box (i * 100, 0, i * 100 + 50, 50));
+    cb.shapes (lb1).insert (db::Box ((9 - i) * 100, 0, (9 - i) * 100 + 50, 50));
+    ca.shapes (la2).insert (db::Polygon (db::Box (0, i * 100, 50, i * 100 + 50)));
+    cb.shapes (lb2).insert (db::Polygon (db::Box (0, i * 100, 50 + (i == 5 ? 1 : 0), i * 100 + 50)));
+  }
+
+  EXPECT_EQ (ca.content_fingerprint (la1) == cb.content_fingerprint (lb1), true);
+  EXPECT_EQ (ca.content_fingerprint (la2) == cb.content_fingerprint (lb2), false);
+
+  TestDifferenceReceiver r;
+  bool eq = db::compare_layouts (a, b, db::layout_diff::f_verbose, 0, r);
+  EXPECT_EQ (eq, false);
+  std::string with_fp = r.text ();
+
+  r.clear ();
+  eq = db::compare_layouts (a, b, db::layout_diff::f_verbose | db::layout_diff::f_no_fingerprints, 0, r);
+  EXPECT_EQ (eq, false);
+  EXPECT_EQ (r.text (), with_fp);
+
+  //  tolerances and normalization are not affected
+  r.clear ();
+  eq = db::compare_layouts (a, b, db::layout_diff::f_verbose, 1, r);
+  EXPECT_EQ (eq, true);
+}
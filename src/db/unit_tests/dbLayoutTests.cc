@@ -30,6 +30,7 @@
 #include "dbInstElement.h"
 #include "dbWriter.h"
 #include "tlString.h"
+#include "tlStream.h"
 #include "tlUnitTest.h"
 
 std::string set2string (const std::set<db::cell_index_type> &set)
@@ -1171,3 +1172,129 @@ TEST(101_CleanupBehavior)
   EXPECT_EQ (cells2string (layout2, false), "*TOP,*A");
   EXPECT_EQ (cells2string (layout2), "*TOP");
 }
+
+namespace
+{
+
+class TestCellContentLoader
+  : public db::CellContentLoader
+{
+public:
+  TestCellContentLoader (unsigned int layer)
+    : m_layer (layer), m_loaded (0)
+  { }
+
+  virtual void load_cell_content (db::Layout &layout, db::cell_index_type /*ci*/, shapes_map &shapes)
+  {
+    ++m_loaded;
+    db::Shapes &s = shapes_for_layer (layout, shapes, m_layer);
+    s.insert (db::Box (0, 0, 100, 200));
+    s.insert (db::Box (-10, 50, 10, 60));
+  }
+
+  virtual void cell_bboxes (db::cell_index_type /*ci*/, box_map &bboxes) const
+  {
+    bboxes [m_layer] = db::Box (-10, 0, 100, 200);
+  }
+
+  int loaded () const
+  {
+    return m_loaded;
+  }
+
+private:
+  unsigned int m_layer;
+  int m_loaded;
+};
+
+}
+
+TEST(102_CellContentLoader)
+{
+  db::Manager m (true);
+  db::Layout layout (&m);
+
+  unsigned int l1 = layout.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout.insert_layer (db::LayerProperties (2, 0));
+
+  db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+  db::Cell &a = layout.cell (layout.add_cell ("A"));
+  db::Cell &b = layout.cell (layout.add_cell ("B"));
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (1000, 0))));
+  top.insert (db::CellInstArray (db::CellInst (b.cell_index ()), db::Trans (db::Vector (0, 1000))));
+  b.shapes (l2).insert (db::Box (0, 0, 10, 10));
+
+  TestCellContentLoader *loader = new TestCellContentLoader (l1);
+  layout.set_cell_content_loader (loader);
+  a.set_content_pending ();
+  b.set_content_pending ();
+
+  //  bounding boxes are taken from the loader without loading the shapes
+  layout.update ();
+  EXPECT_EQ (a.is_content_pending (), true);
+  EXPECT_EQ (a.bbox ().to_string (), "(-10,0;100,200)");
+  EXPECT_EQ (a.bbox (l1).to_string (), "(-10,0;100,200)");
+  EXPECT_EQ (b.bbox ().to_string (), "(-10,0;100,200)");
+  EXPECT_EQ (b.bbox (l2).to_string (), "(0,0;10,10)");
+  EXPECT_EQ (top.bbox ().to_string (), "(-10,0;1100,1200)");
+  EXPECT_EQ (a.layers (), l1 + 1);
+  EXPECT_EQ (a.empty (), false);
+  EXPECT_EQ (loader->loaded (), 0);
+
+  //  accessing the shapes loads them
+  EXPECT_EQ (a.shapes (l1).size (), size_t (2));
+  EXPECT_EQ (a.is_content_pending (), false);
+  EXPECT_EQ (loader->loaded (), 1);
+  EXPECT_EQ (a.shapes (l1).bbox ().to_string (), "(-10,0;100,200)");
+
+  //  loading the shapes is not an undoable operation
+  EXPECT_EQ (m.available_undo ().first, false);
+
+  //  shapes are loaded only once
+  EXPECT_EQ (a.shapes (l1).size (), size_t (2));
+  EXPECT_EQ (loader->loaded (), 1);
+
+  //  clearing the cell does not need the pending shapes
+  b.clear_shapes ();
+  EXPECT_EQ (b.is_content_pending (), false);
+  EXPECT_EQ (loader->loaded (), 1);
+  layout.update ();
+  EXPECT_EQ (b.bbox ().to_string (), "()");
+
+  layout.load_pending_cells ();
+  EXPECT_EQ (loader->loaded (), 1);
+}
+
+TEST(103_ReleaseSourceFile)
+{
+  std::string source = tmp_file ("source.txt");
+  std::string other = tmp_file ("other.txt");
+  {
+    tl::OutputStream os (source);
+    os << "x";
+  }
+  {
+    tl::OutputStream os (other);
+    os << "y";
+  }
+
+  db::Layout layout;
+  unsigned int l1 = layout.insert_layer (db::LayerProperties (1, 0));
+  db::Cell &a = layout.cell (layout.add_cell ("A"));
+
+  TestCellContentLoader *loader = new TestCellContentLoader (l1);
+  loader->set_source_path (source);
+  layout.set_cell_content_loader (loader);
+  a.set_content_pending ();
+
+  //  writing to another file keeps the loader
+  layout.release_source_file (other);
+  EXPECT_EQ (layout.cell_content_loader () == loader, true);
+  EXPECT_EQ (a.is_content_pending (), true);
+
+  //  writing to the source file loads the pending cells and drops the loader
+  layout.release_source_file (source);
+  EXPECT_EQ (layout.cell_content_loader () == 0, true);
+  EXPECT_EQ (a.is_content_pending (), false);
+  EXPECT_EQ (a.shapes (l1).size (), size_t (2));
+}
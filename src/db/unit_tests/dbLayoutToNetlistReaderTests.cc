@@ -563,3 +563,113 @@ TEST(7_CustomDevice)
 
   compare_text_files (path, au_path);
 }
+
+TEST(8_BinaryFormat)
+{
+  db::LayoutToNetlist l2n;
+
+  std::string in_path = tl::combine_path (tl::combine_path (tl::testdata (), "algo"), "l2n_reader_in_p.txt");
+  tl::InputStream is_in (in_path);
+
+  db::LayoutToNetlistStandardReader reader (is_in);
+  reader.read (&l2n);
+
+  //  write binary, read back and verify against the input
+
+  std::string bin_path = tmp_file ("tmp.l2nb");
+  {
+    tl::OutputStream stream (bin_path);
+    db::LayoutToNetlistStandardWriter writer (stream, true, true);
+    writer.write (&l2n);
+  }
+
+  db::LayoutToNetlist l2n_bin;
+  {
+    tl::InputStream is_bin (bin_path);
+    db::LayoutToNetlistStandardReader reader_bin (is_bin);
+    reader_bin.read (&l2n_bin);
+  }
+
+  std::string path = tmp_file ("tmp.txt");
+  {
+    tl::OutputStream stream (path);
+    db::LayoutToNetlistStandardWriter writer (stream, true);
+    writer.write (&l2n_bin);
+  }
+
+  compare_text_files (path, in_path);
+
+  //  same with deflated binary file, selected by suffix
+
+  std::string gz_path = tmp_file ("tmp.l2nb.gz");
+  l2n.save (gz_path, false);
+
+  db::LayoutToNetlist l2n_gz;
+  l2n_gz.load (gz_path);
+
+  std::string path2 = tmp_file ("tmp2.txt");
+  l2n_gz.save (path2, true);
+
+  compare_text_files (path2, in_path);
+}
+
+static std::string net_shapes_to_string (const db::LayoutToNetlist &l2n, const db::Net &net)
+{
+  std::string res;
+
+  for (db::LayoutToNetlist::layer_iterator l = l2n.begin_layers (); l != l2n.end_layers (); ++l) {
+    db::Shapes shapes;
+    l2n.shapes_of_net (net, l->first, true, shapes);
+    res += l->second + ":";
+    for (db::Shapes::shape_iterator s = shapes.begin (db::ShapeIterator::All); ! s.at_end (); ++s) {
+      res += " " + s->to_string ();
+    }
+    res += "\n";
+  }
+
+  return res;
+}
+
+TEST(9_LazyGeometry)
+{
+  db::LayoutToNetlist l2n;
+
+  std::string in_path = tl::combine_path (tl::combine_path (tl::testdata (), "algo"), "l2n_reader_in_p.txt");
+  l2n.load (in_path);
+
+  std::string bin_path = tmp_file ("tmp.l2nb");
+  l2n.save (bin_path, false);
+
+  db::LayoutToNetlist l2n_lazy;
+  l2n_lazy.load (bin_path, true);
+
+  EXPECT_EQ (l2n_lazy.has_pending_geometry (), true);
+
+  //  shapes are loaded per net on demand
+  db::Netlist::circuit_iterator c = l2n.netlist ()->begin_circuits ();
+  db::Netlist::circuit_iterator c_lazy = l2n_lazy.netlist ()->begin_circuits ();
+  for ( ; c != l2n.netlist ()->end_circuits () && c_lazy != l2n_lazy.netlist ()->end_circuits (); ++c, ++c_lazy) {
+    db::Circuit::net_iterator n = c->begin_nets ();
+    db::Circuit::net_iterator n_lazy = c_lazy->begin_nets ();
+    for ( ; n != c->end_nets () && n_lazy != c_lazy->end_nets (); ++n, ++n_lazy) {
+      EXPECT_EQ (net_shapes_to_string (l2n_lazy, *n_lazy), net_shapes_to_string (l2n, *n));
+    }
+  }
+
+  //  writing loads the remaining shapes
+  std::string path = tmp_file ("tmp.txt");
+  l2n_lazy.save (path, true);
+
+  EXPECT_EQ (l2n_lazy.has_pending_geometry (), false);
+
+  compare_text_files (path, in_path);
+
+  //  compressed files are read in full
+  std::string gz_path = tmp_file ("tmp.l2nb.gz");
+  l2n.save (gz_path, false);
+
+  db::LayoutToNetlist l2n_gz;
+  l2n_gz.load (gz_path, true);
+
+  EXPECT_EQ (l2n_gz.has_pending_geometry (), false);
+}
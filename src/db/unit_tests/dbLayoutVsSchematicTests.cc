@@ -245,6 +245,19 @@ TEST(1_BasicFlow)
   std::string au_path2 = tl::combine_path (tl::combine_path (tl::testdata (), "algo"), "lvs_test1b_au.lvsdb");
 
   compare_lvsdbs (_this, path2, au_path2);
+
+  //  binary format round trip
+
+  std::string path_bin = tmp_file ("tmp_lvstest1.lvsb");
+  lvs.save (path_bin, false);
+
+  db::LayoutVsSchematic lvs3;
+
+  std::string path3 = tmp_file ("tmp_lvstest1c.lvsdb");
+  lvs3.load (path_bin);
+  lvs3.save (path3, false);
+
+  compare_lvsdbs (_this, path3, au_path2);
 }
 
 
@@ -441,6 +454,19 @@ TEST(2_FlowWithErrors)
   std::string au_path2 = tl::combine_path (tl::combine_path (tl::testdata (), "algo"), "lvs_test2b_au.lvsdb");
 
   compare_lvsdbs (_this, path2, au_path2);
+
+  //  binary format round trip (includes "match" and "mismatch" status keys)
+
+  std::string path_bin = tmp_file ("tmp_lvstest2.lvsb");
+  lvs.save (path_bin, false);
+
+  db::LayoutVsSchematic lvs3;
+
+  std::string path3 = tmp_file ("tmp_lvstest2c.lvsdb");
+  lvs3.load (path_bin);
+  lvs3.save (path3, false);
+
+  compare_lvsdbs (_this, path3, au_path2);
 }
 
 TEST(3_ReaderFuture)
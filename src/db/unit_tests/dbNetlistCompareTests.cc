@@ -26,6 +26,7 @@
 #include "dbNetlistCrossReference.h"
 #include "dbNetlistSpiceReader.h"
 #include "dbNetlistCompareUtils.h"
+#include "tlTimer.h"
 
 class NetlistCompareTestLogger
   : public db::NetlistCompareLogger
@@ -5126,3 +5127,112 @@ TEST(32_InverterChain)
   );
 }
 
+
+TEST(33_MultiThreaded)
+{
+  const char *nls1 =
+    "circuit INV ($0=IN,$1=OUT,$2=VDD,$3=VSS);\n"
+    "  device PMOS $1 (S=VDD,G=IN,D=OUT) (L=0.25,W=0.95,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n"
+    "  device NMOS $2 (S=VSS,G=IN,D=OUT) (L=0.25,W=0.95,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n"
+    "end;\n"
+    "circuit INVX2 ($0=IN,$1=OUT,$2=VDD,$3=VSS);\n"
+    "  device PMOS $1 (S=VDD,G=IN,D=OUT) (L=0.25,W=1.9,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n"
+    "  device NMOS $2 (S=VSS,G=IN,D=OUT) (L=0.25,W=1.9,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n"
+    "end;\n"
+    "circuit BUF ($0=IN,$1=OUT,$2=VDD,$3=VSS);\n"
+    "  subcircuit INV $1 ($0=IN,$1=INT,$2=VDD,$3=VSS);\n"
+    "  subcircuit INV $2 ($0=INT,$1=OUT,$2=VDD,$3=VSS);\n"
+    "end;\n"
+    "circuit BUFX2 ($0=IN,$1=OUT,$2=VDD,$3=VSS);\n"
+    "  subcircuit INVX2 $1 ($0=IN,$1=INT,$2=VDD,$3=VSS);\n"
+    "  subcircuit INVX2 $2 ($0=INT,$1=OUT,$2=VDD,$3=VSS);\n"
+    "end;\n"
+    "circuit TOP ($0=IN,$1=OUT,$2=VDD,$3=VSS);\n"
+    "  subcircuit BUF $1 ($0=IN,$1=INT,$2=VDD,$3=VSS);\n"
+    "  subcircuit BUFX2 $2 ($0=INT,$1=OUT,$2=VDD,$3=VSS);\n"
+    "end;\n";
+
+  const char *nls2 =
+    "circuit INV ($0=VDD,$1=IN,$2=VSS,$3=OUT);\n"
+    "  device NMOS $1 (S=OUT,G=IN,D=VSS) (L=0.25,W=0.95,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n"
+    "  device PMOS $2 (S=VDD,G=IN,D=OUT) (L=0.25,W=0.95,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n"
+    "end;\n"
+    "circuit INVX2 ($0=VDD,$1=IN,$2=VSS,$3=OUT);\n"
+    "  device NMOS $1 (S=OUT,G=IN,D=VSS) (L=0.25,W=1.9,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n"
+    //  wrong wiring:
+    "  device PMOS $2 (S=IN,G=IN,D=OUT) (L=0.25,W=1.9,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n"
+    "end;\n"
+    "circuit BUF ($0=IN,$1=OUT,$2=VDD,$3=VSS);\n"
+    "  subcircuit INV $1 ($0=VDD,$1=IN,$2=VSS,$3=INT);\n"
+    "  subcircuit INV $2 ($0=VDD,$1=INT,$2=VSS,$3=OUT);\n"
+    "end;\n"
+    "circuit BUFX2 ($0=IN,$1=OUT,$2=VDD,$3=VSS);\n"
+    "  subcircuit INVX2 $1 ($0=VDD,$1=IN,$2=VSS,$3=INT);\n"
+    "  subcircuit INVX2 $2 ($0=VDD,$1=INT,$2=VSS,$3=OUT);\n"
+    "end;\n"
+    "circuit TOP ($0=IN,$1=OUT,$2=VDD,$3=VSS);\n"
+    "  subcircuit BUF $1 ($0=IN,$1=INT,$2=VDD,$3=VSS);\n"
+    "  subcircuit BUFX2 $2 ($0=INT,$1=OUT,$2=VDD,$3=VSS);\n"
+    "end;\n";
+
+  db::Netlist nl1, nl2;
+  prep_nl (nl1, nls1);
+  prep_nl (nl2, nls2);
+
+  NetlistCompareTestLogger logger;
+  db::NetlistComparer comp (&logger);
+  comp.set_dont_consider_net_names (true);
+
+  bool good = comp.compare (&nl1, &nl2);
+  std::string txt = logger.text ();
+
+  EXPECT_EQ (good, false);
+
+  //  the multi-threaded compare delivers the same results in the same order
+  NetlistCompareTestLogger logger_mt;
+  db::NetlistComparer comp_mt (&logger_mt);
+  comp_mt.set_dont_consider_net_names (true);
+  comp_mt.set_threads (4);
+
+  bool good_mt = comp_mt.compare (&nl1, &nl2);
+
+  EXPECT_EQ (good_mt, good);
+  EXPECT_EQ (logger_mt.text (), txt);
+}
+
+static std::string make_flat_inverter_chain (size_t n, bool reverse)
+{
+  std::string s = "circuit TOP ($0=N0,$1=N" + tl::to_string (n) + ",$2=VDD,$3=VSS);\n";
+
+  for (size_t j = 0; j < n; ++j) {
+    size_t i = reverse ? n - 1 - j : j;
+    std::string in = "N" + tl::to_string (i), out = "N" + tl::to_string (i + 1);
+    s += "  device PMOS $" + tl::to_string (i * 2 + 1) + " (S=VDD,G=" + in + ",D=" + out + ") (L=0.25,W=0.95,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n";
+    s += "  device NMOS $" + tl::to_string (i * 2 + 2) + " (S=VSS,G=" + in + ",D=" + out + ") (L=0.25,W=0.95,AS=0.49875,AD=0.26125,PS=2.95,PD=1.5);\n";
+  }
+
+  s += "end;\n";
+  return s;
+}
+
+//  A benchmark for large flat netlists
+TEST(34_LargeFlatNetlist)
+{
+  const size_t n = 20000;
+
+  db::Netlist nl1, nl2;
+  prep_nl (nl1, make_flat_inverter_chain (n, false).c_str ());
+  prep_nl (nl2, make_flat_inverter_chain (n, true).c_str ());
+
+  NetlistCompareTestLogger logger;
+  db::NetlistComparer comp (&logger);
+  comp.set_dont_consider_net_names (true);
+
+  bool good = false;
+  {
+    tl::SelfTimer timer ("compare large flat netlist");
+    good = comp.compare (&nl1, &nl2);
+  }
+
+  EXPECT_EQ (good, true);
+}
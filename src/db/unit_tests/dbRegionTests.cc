@@ -29,6 +29,7 @@
 #include "dbRegionProcessors.h"
 #include "dbEdgesUtils.h"
 #include "dbBoxScanner.h"
+#include "dbEdgeProcessor.h"
 #include "dbReader.h"
 #include "dbTestSupport.h"
 
@@ -2906,6 +2907,113 @@ TEST(64_add_with_properties)
   EXPECT_EQ ((ro1 + rf2).to_string (), "(10,20;10,60;40,60;40,20){net=>17};(-10,20;-10,60;20,60;20,20){net=>17}");
 }
 
+TEST(65_threads)
+{
+  db::Region r, rr;
+  for (int i = 0; i < 100; ++i) {
+    for (int j = 0; j < 100; ++j) {
+      r.insert (db::Box (i * 100, j * 100, i * 100 + 150, j * 100 + 50));
+      rr.insert (db::Box (i * 100 + 20, j * 100 + 20, i * 100 + 40, j * 100 + 90));
+    }
+  }
+
+  db::Region merged_serial = r.merged ();
+  db::Region and_serial = r & rr;
+  db::Region xor_serial = r ^ rr;
+
+  db::EdgeProcessor::set_min_edges_per_band_global (1000);
+
+  r.set_threads (2);
+  EXPECT_EQ (r.threads (), 2);
+
+  db::Region merged_bands = r.merged ();
+  db::Region and_bands = r & rr;
+  db::Region xor_bands = r ^ rr;
+
+  db::EdgeProcessor::set_min_edges_per_band_global (20000);
+
+  EXPECT_EQ (merged_bands.count (), merged_serial.count ());
+  EXPECT_EQ ((merged_bands ^ merged_serial).empty (), true);
+  EXPECT_EQ (and_bands.count (), and_serial.count ());
+  EXPECT_EQ ((and_bands ^ and_serial).empty (), true);
+  EXPECT_EQ (xor_bands.count (), xor_serial.count ());
+  EXPECT_EQ ((xor_bands ^ xor_serial).empty (), true);
+
+  //  the thread count is kept when the delegate changes
+  r.merge ();
+  EXPECT_EQ (r.threads (), 2);
+}
+
+static std::string sorted_edge_pairs (const db::EdgePairs &eps)
+{
+  std::vector<std::string> s;
+  for (db::EdgePairs::const_iterator ep = eps.begin (); ! ep.at_end (); ++ep) {
+    s.push_back (ep->to_string ());
+  }
+  std::sort (s.begin (), s.end ());
+  return tl::join (s, ";");
+}
+
+TEST(66_threaded_checks)
+{
+  db::Region r, rr;
+  for (int i = 0; i < 50; ++i) {
+    for (int j = 0; j < 50; ++j) {
+      db::Coord w = 20 + (i * 7 + j * 3) % 40;
+      r.insert (db::Box (i * 100, j * 100, i * 100 + w, j * 100 + 60));
+      r.insert (db::Box (i * 100, j * 100, i * 100 + 80, j * 100 + 15 + (i + j) % 20));
+      r.insert (db::Box (i * 100 + 60, j * 100, i * 100 + 80, j * 100 + 60));
+      rr.insert (db::Box (i * 100 - 10, j * 100 - 5, i * 100 + 30 + (i * j) % 50, j * 100 + 70));
+    }
+  }
+
+  db::Region rt = r;
+  rt.set_threads (4);
+  EXPECT_EQ (rt.threads (), 4);
+
+  db::RegionCheckOptions options;
+
+  std::string width_serial = sorted_edge_pairs (r.width_check (25, options));
+  std::string notch_serial = sorted_edge_pairs (r.notch_check (30, options));
+  std::string space_serial = sorted_edge_pairs (r.space_check (30, options));
+  std::string isolated_serial = sorted_edge_pairs (r.isolated_check (30, options));
+  std::string separation_serial = sorted_edge_pairs (r.separation_check (rr, 20, options));
+  std::string enclosing_serial = sorted_edge_pairs (rr.enclosing_check (r, 20, options));
+
+  EXPECT_EQ (width_serial.empty (), false);
+  EXPECT_EQ (notch_serial.empty (), false);
+  EXPECT_EQ (space_serial.empty (), false);
+  EXPECT_EQ (isolated_serial.empty (), false);
+  EXPECT_EQ (separation_serial.empty (), false);
+
+  EXPECT_EQ (sorted_edge_pairs (rt.width_check (25, options)) == width_serial, true);
+  EXPECT_EQ (sorted_edge_pairs (rt.notch_check (30, options)) == notch_serial, true);
+  EXPECT_EQ (sorted_edge_pairs (rt.space_check (30, options)) == space_serial, true);
+  EXPECT_EQ (sorted_edge_pairs (rt.isolated_check (30, options)) == isolated_serial, true);
+  EXPECT_EQ (sorted_edge_pairs (rt.separation_check (rr, 20, options)) == separation_serial, true);
+
+  db::Region rrt = rr;
+  rrt.set_threads (4);
+  EXPECT_EQ (sorted_edge_pairs (rrt.enclosing_check (r, 20, options)) == enclosing_serial, true);
+
+  //  with properties
+  db::PropertiesSet ps;
+  ps.insert (tl::Variant (1), tl::Variant ("A"));
+  db::properties_id_type pid = db::properties_id (ps);
+
+  db::Region rp, rpt;
+  for (db::Region::const_iterator p = r.begin (); ! p.at_end (); ++p) {
+    rp.insert (db::PolygonWithProperties (*p, pid));
+  }
+  rpt = rp;
+  rpt.set_threads (4);
+
+  db::RegionCheckOptions options_pc;
+  options_pc.prop_constraint = db::NoPropertyConstraint;
+  EXPECT_EQ (sorted_edge_pairs (rpt.space_check (30, options_pc)) == sorted_edge_pairs (rp.space_check (30, options_pc)), true);
+  EXPECT_EQ (sorted_edge_pairs (rpt.width_check (25, options_pc)) == sorted_edge_pairs (rp.width_check (25, options_pc)), true);
+}
+
 TEST(100_Processors)
 {
   db::Region r;
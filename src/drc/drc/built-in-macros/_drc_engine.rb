@@ -212,6 +212,13 @@ module DRC
 
       @in_context = nil
 
+      @deferred = nil
+      @deferred_outputs = nil
+
+      @op_cache = nil
+      @op_cache_limit = 0
+      @op_cache_size = 0
+
     end
 
     # avoids lengthy error messages
@@ -1259,6 +1266,122 @@ module DRC
       self.threads(n)
     end
     
+    # %DRC%
+    # @name concurrent
+    # @brief Executes the layer operations of a block concurrently
+    # @synopsis concurrent { block }
+    #
+    # Within the block, layer operations are not executed immediately. Instead they
+    # are recorded together with their inputs. At the end of the block, the recorded
+    # operations are arranged by their dependencies: operations which do not depend on
+    # each other's results form one level and are executed concurrently, using the 
+    # number of CPU cores specified with \threads. Levels are executed one after
+    # another. This helps when a deck consists of many small, independent rules, 
+    # which otherwise leave most cores idle.
+    #
+    # Output statements (\Layer#output) inside the block are executed after the 
+    # operations, in the order they appear in the script. Hence, the report databases
+    # and layouts produced are the same as without the block.
+    #
+    # Operations which modify a layer in-place, which are not available on the 
+    # tiling processor, which involve deep (hierarchical) layers or which take 
+    # script-implemented objects (such as custom polygon operators) as arguments are 
+    # executed immediately, after the pending operations have been executed. 
+    # The same applies to operations which require the content of a layer, such as 
+    # \Layer#count.
+    # Deep mode does not benefit from this feature therefore.
+    #
+    # The operations are executed through the tiling processor, in tiling mode (see \tiles) 
+    # per tile and otherwise in one piece. The same restrictions as for tiling mode 
+    # apply, i.e. layers are passed to the operations as raw shape collections.
+    #
+    # Concurrent execution requires \threads to be set to more than one core:
+    #
+    # @code
+    # threads(8)
+    # concurrent do
+    #   m1.width(0.1.um).output("M1.W")
+    #   m1.space(0.12.um).output("M1.S")
+    #   m2.width(0.1.um).output("M2.W")
+    #   m2.space(0.12.um).output("M2.S")
+    # end
+    # @/code
+    #
+    # This feature has been introduced in version 0.30.10.
+    
+    def concurrent(&block)
+
+      # nested blocks are part of the outer one
+      if @deferred
+        return block.call
+      end
+
+      @deferred = []
+      @deferred_outputs = []
+
+      begin
+        res = block.call
+        _flush_deferred
+      ensure
+        @deferred = nil
+        @deferred_outputs = nil
+      end
+
+      res
+
+    end
+    
+    # %DRC%
+    # @name operation_cache
+    # @brief Enables or disables the cache for repeated layer operations
+    # @synopsis operation_cache(max_shapes)
+    # @synopsis operation_cache(false)
+    # @synopsis operation_cache
+    #
+    # DRC and LVS decks often compute the same derived layer in multiple places, 
+    # for example "metal1.sized(0.1)" or "poly & active". In deep mode, the operation
+    # cache remembers the results of layer operations together with their inputs and 
+    # parameters. When the same operation is requested again on the same input layers 
+    # with the same parameters, the previous result is taken instead of computing it again.
+    #
+    # The cache is bounded by the total number of shapes held by the cached layers in
+    # their hierarchical representation, which is roughly proportional to the memory
+    # used. When the limit is exceeded, the least recently used results are dropped.
+    # 
+    # "operation_cache(false)" disables the cache and releases the cached results. 
+    # Without an argument, this function returns the current limit (0 if the cache is disabled).
+    # The cache is disabled by default.
+    #
+    # The cache applies to deep mode only. Results taken from the cache are copies 
+    # of the cached result. Operations modifying a layer in-place (e.g. \Layer#raw or 
+    # \Layer#insert) will detach the layer from the cached result before modifying it.
+    #
+    # @code
+    # deep
+    # operation_cache(10000000)
+    #
+    # gate = poly & active
+    # ...
+    # # taken from the cache:
+    # gate = poly & active
+    # @/code
+    #
+    # This feature has been introduced in version 0.30.10.
+    
+    def operation_cache(limit = nil)
+      if limit != nil
+        _clear_op_cache
+        if limit
+          @op_cache_limit = limit.to_i
+          @op_cache = @op_cache_limit > 0 ? {} : nil
+        else
+          @op_cache_limit = 0
+          @op_cache = nil
+        end
+      end
+      @op_cache_limit
+    end
+
     # %DRC%
     # @name deep_reject_odd_polygons
     # @brief Gets or sets a value indicating whether the reject odd polygons in deep mode
@@ -2705,12 +2828,27 @@ CODE
     end
     
     def _cmd(obj, method, *args)
+      _flush_deferred
       run_timed("\"#{@in_context || method}\" in: #{src_line}", obj) do
         obj.send(method, *args)
       end
     end
     
     def _tcmd(obj, border, result_cls, method, *args)
+
+      if _deferrable?(obj, method, args)
+        res = result_cls.new
+        @deferred.push([ obj, border, [ res ], method, args, src_line ])
+        return res
+      end
+
+      _flush_deferred
+
+      key = _op_cache_key(obj, method, args)
+      if key
+        res = _op_cache_fetch(key)
+        res && (return res)
+      end
     
       if @tx && @ty
       
@@ -2752,6 +2890,8 @@ CODE
         end
 
       end
+
+      key && _op_cache_store(key, res, [ obj ] + args)
       
       res
       
@@ -2759,6 +2899,20 @@ CODE
 
     # used for two-element array output methods (e.g. andnot)
     def _tcmd_a2(obj, border, result_cls1, result_cls2, method, *args)
+
+      if _deferrable?(obj, method, args)
+        res = [ result_cls1.new, result_cls2.new ]
+        @deferred.push([ obj, border, res, method, args, src_line ])
+        return res
+      end
+
+      _flush_deferred
+
+      key = _op_cache_key(obj, method, args)
+      if key
+        res = _op_cache_fetch(key)
+        res && (return res)
+      end
     
       if @tx && @ty
       
@@ -2803,6 +2957,8 @@ CODE
         end
 
       end
+
+      key && _op_cache_store(key, res, [ obj ] + args)
       
       res
       
@@ -2810,6 +2966,8 @@ CODE
 
     # used for area and perimeter only    
     def _tdcmd(obj, border, method)
+
+      _flush_deferred
     
       if @tx && @ty
       
@@ -2848,15 +3006,258 @@ CODE
     end
     
     def _rcmd(obj, method, *args)
+      _flush_deferred
       run_timed("\"#{@in_context || method}\" in: #{src_line}", obj) do
         RBA::Region::new(obj.send(method, *args))
       end
     end
     
     def _vcmd(obj, method, *args)
+
+      # outputs are delayed until the pending operations have been executed
+      if @deferred && method == :_output
+        @deferred_outputs.push([ obj, method, args, "\"#{@in_context || method}\" in: #{src_line}" ])
+        return nil
+      end
+
+      _flush_deferred
+
       run_timed("\"#{@in_context || method}\" in: #{src_line}", obj) do
         obj.send(method, *args)
       end
+
+    end
+
+    # Computes the operation cache key for an operation or nil if the operation
+    # cannot be cached
+    def _op_cache_key(obj, method, args)
+
+      @op_cache || (return nil)
+      (@tx && @ty) && (return nil)
+      (_is_shape_collection?(obj) && obj.is_deep?) || (return nil)
+      DEFERRED_IN_PLACE_METHODS.include?(method) && (return nil)
+
+      catch(:no_op_cache_key) do
+        [ method ] + ([ obj ] + args).collect { |a| _op_cache_arg_key(a) }
+      end
+
+    end
+
+    # Throws :no_op_cache_key if the argument cannot be part of a cache key
+    def _op_cache_arg_key(a)
+      if _is_shape_collection?(a)
+        a.is_deep? || throw(:no_op_cache_key)
+        # the key needs to include the state flags which influence the result 
+        k = [ :data, a.object_id ]
+        if a.is_a?(RBA::Region)
+          k += [ a.merged_semantics?, a.strict_handling?, a.min_coherence? ]
+        elsif a.is_a?(RBA::Edges)
+          k += [ a.merged_semantics? ]
+        end
+        k
+      elsif a.nil? || a == true || a == false || a.is_a?(Numeric) || a.is_a?(String) || a.is_a?(Symbol)
+        a
+      elsif a.is_a?(Array)
+        a.collect { |e| _op_cache_arg_key(e) }
+      elsif a.class.name.to_s.start_with?("RBA::")
+        # enums and value objects
+        [ a.class.name, a.to_s ]
+      else
+        throw(:no_op_cache_key)
+      end
+    end
+
+    def _op_cache_fetch(key)
+
+      entry = @op_cache.delete(key)
+      entry || (return nil)
+
+      # move to the end of the LRU list
+      @op_cache[key] = entry
+      info("Taken from operation cache: #{src_line}", 1)
+
+      # hand out copies, so layers never share their data objects with each other
+      res = entry[0]
+      res.is_a?(Array) ? res.collect { |r| r.dup } : res.dup
+
+    end
+
+    def _op_cache_store(key, res, operands)
+
+      size = 0
+      (res.is_a?(Array) ? res : [ res ]).each do |r|
+        _is_shape_collection?(r) || return
+        size += r.hier_count
+      end
+
+      size > @op_cache_limit && return
+
+      # the operands are kept with the result, so their object ids stay valid
+      @op_cache[key] = [ res, size, operands ]
+      @op_cache_size += size
+
+      # drop the least recently used entries
+      while @op_cache_size > @op_cache_limit && ! @op_cache.empty?
+        _op_cache_drop(@op_cache.first[0])
+      end
+
+    end
+
+    def _op_cache_drop(key)
+      entry = @op_cache.delete(key)
+      entry && (@op_cache_size -= entry[1])
+    end
+
+    def _clear_op_cache
+      @op_cache && @op_cache.clear
+      @op_cache_size = 0
+    end
+
+    def _op_cache_uses?(entry, data)
+      res, size, operands = entry
+      (res.is_a?(Array) ? res : [ res ]).any? { |r| r.equal?(data) } || operands.any? { |o| o.equal?(data) }
+    end
+
+    # Returns a copy of the data object if it is used by the operation cache as 
+    # result or operand, so it can be modified
+    # NOTE: as the cache hands out copies, the data object is shared with the
+    # cache only, but not with other layers.
+    def _op_cache_detach(data)
+      @op_cache || (return data)
+      @op_cache.values.any? { |e| _op_cache_uses?(e, data) } ? data.dup : data
+    end
+
+    # Drops the cache entries using the given data object, so it can be destroyed
+    def _op_cache_forget(data)
+      @op_cache || return
+      @op_cache.keys.each do |key|
+        _op_cache_uses?(@op_cache[key], data) && _op_cache_drop(key)
+      end
+    end
+
+    # in-place methods cannot be deferred
+    DEFERRED_IN_PLACE_METHODS = [ :merge, :snap, :size, :process, :filter ]
+
+    def _is_shape_collection?(a)
+      a.is_a?(RBA::Edges) || a.is_a?(RBA::Region) || a.is_a?(RBA::EdgePairs) || a.is_a?(RBA::Texts)
+    end
+
+    def _deferrable?(obj, method, args)
+
+      @deferred || (return false)
+      DEFERRED_IN_PLACE_METHODS.include?(method) && (return false)
+
+      ([ obj ] + args).each do |a|
+        if _is_shape_collection?(a)
+          # deep layers keep their hierarchy only if executed directly
+          a.is_deep? && (return false)
+        elsif a.nil? || a == true || a == false || a.is_a?(Numeric) || a.is_a?(String)
+          # plain values are fine
+        elsif ! a.class.name.to_s.start_with?("RBA::")
+          # objects implemented in script code (e.g. custom operators) must not be 
+          # called from worker threads
+          return false
+        end
+      end
+
+      true
+
+    end
+
+    # Executes the operations recorded inside a "concurrent" block
+    def _flush_deferred
+
+      if ! @deferred || (@deferred.empty? && @deferred_outputs.empty?)
+        return
+      end
+
+      nodes = @deferred
+      outputs = @deferred_outputs
+      @deferred = []
+      @deferred_outputs = []
+
+      # assign a level to each node: one more than the maximum level of the 
+      # nodes producing its inputs
+      producers = {}
+      levels = []
+      nodes.each do |n|
+        obj, border, res, method, args = n
+        level = 0
+        ([ obj ] + args).each do |a|
+          pl = producers[a.object_id]
+          pl && level = [ level, pl + 1 ].max
+        end
+        res.each { |r| producers[r.object_id] = level }
+        (levels[level] ||= []).push(n)
+      end
+
+      levels.each_with_index do |ln, li|
+        _execute_deferred_level(ln, li)
+      end
+
+      # outputs are executed in the original order
+      outputs.each do |obj, method, args, desc|
+        run_timed(desc, obj) do
+          obj.send(method, *args)
+        end
+      end
+
+    end
+
+    # Executes the pending concurrent operations when the data of a layer is
+    # accessed directly by the script (i.e. not from inside a DRC function)
+    def _flush_deferred_on_access
+      @in_context || _flush_deferred
+    end
+
+    def _execute_deferred_level(nodes, level)
+
+      tp = RBA::TilingProcessor::new
+      tp.dbu = self.dbu
+      tp.scale_to_dbu = false
+      tp.threads = (@tt || 1)
+
+      if @tx && @ty
+        border = nodes.collect { |n| n[1] }.max
+        tp.tile_size(@tx, @ty)
+        bx = [ @bx || 0.0, border * self.dbu ].max
+        by = [ @by || 0.0, border * self.dbu ].max
+        tp.tile_border(bx, by)
+      end
+
+      nodes.each_with_index do |n, ni|
+
+        obj, border, res, method, args, line = n
+
+        tp.input("self#{ni}", obj)
+        av = args.each_with_index.collect do |a,i|
+          if _is_shape_collection?(a)
+            tp.input("a#{ni}_#{i}", a)
+          else
+            tp.var("a#{ni}_#{i}", a)
+          end
+          "a#{ni}_#{i}"
+        end.join(", ")
+
+        res.each_with_index do |r,i|
+          tp.output("res#{ni}_#{i}", r)
+        end
+
+        if res.size == 1
+          tp.queue("_output(res#{ni}_0, self#{ni}.#{method}(#{av}))")
+        else
+          tp.queue("var rr#{ni} = self#{ni}.#{method}(#{av}); " + res.size.times.collect { |i| "_output(res#{ni}_#{i}, rr#{ni}[#{i}])" }.join("; "))
+        end
+
+        info("Scheduled \"#{method}\" from: #{line}", 1)
+
+      end
+
+      run_timed("Concurrent operations (level #{level + 1}, #{nodes.size} operation(s))", nil) do
+        tp.execute("Concurrent operations")
+        nil
+      end
+
     end
 
     def _bx
@@ -3094,6 +3495,7 @@ CODE
         @output_l2ndb_file = nil
 
         # clean up temp data
+        _clear_op_cache
         @dss && @dss._destroy
         @dss = nil
         @netter && @netter._finish
@@ -42,6 +42,9 @@ module DRC
 
       @engine._context("insert") do
 
+        @engine._flush_deferred
+        self.data = @engine._op_cache_detach(self.data)
+
         args.each do |a|
           if a.is_a?(RBA::DBox) 
             requires_edges_or_region
@@ -102,6 +105,7 @@ module DRC
       @engine._context("strict") do
 
         requires_region
+        self.data = @engine._op_cache_detach(self.data)
         self.data.strict_handling = true
         self
 
@@ -123,6 +127,7 @@ module DRC
       @engine._context("non_strict") do
 
         requires_region
+        self.data = @engine._op_cache_detach(self.data)
         self.data.strict_handling = false
         self
 
@@ -168,6 +173,7 @@ module DRC
       @engine._context("clean") do
 
         requires_edges_or_region
+        self.data = @engine._op_cache_detach(self.data)
         self.data.merged_semantics = true
         self
 
@@ -205,6 +211,7 @@ module DRC
       @engine._context("raw") do
 
         requires_edges_or_region
+        self.data = @engine._op_cache_detach(self.data)
         self.data.merged_semantics = false
         self
 
@@ -282,7 +289,12 @@ module DRC
 
       @engine._context("forget") do
 
+        # pending concurrent operations may still use the data
+        @engine._flush_deferred
+
         if @data
+          # the cache must not keep the destroyed object
+          @engine._op_cache_forget(@data)
           @data._destroy
           @data = nil
         end
@@ -305,6 +317,7 @@ module DRC
     # See \hier_count for a hierarchical (each cell counts once) count.
 
     def count
+      @engine._flush_deferred
       self.data.count
     end
     
@@ -322,6 +335,7 @@ module DRC
     # the same value than \count.
 
     def hier_count
+      @engine._flush_deferred
       self.data.hier_count
     end
     
@@ -341,6 +355,7 @@ module DRC
     # and performing the deep copy may be expensive in terms of CPU time.
     
     def dup
+      @engine._flush_deferred
       DRCLayer::new(@engine, self.data.dup)
     end
 
@@ -1600,6 +1615,8 @@ CODE
 
       @engine._wrapper_context("select") do
 
+        @engine._flush_deferred
+
         new_data = self.data.class.new
         t = RBA::CplxTrans::new(@engine.dbu)
         @engine.run_timed("\"select\" in: #{@engine.src_line}", self.data) do
@@ -1628,6 +1645,8 @@ CODE
 
       @engine._wrapper_context("each") do
 
+        @engine._flush_deferred
+
         t = RBA::CplxTrans::new(@engine.dbu)
         @engine.run_timed("\"each\" in: #{@engine.src_line}", self.data) do
           self.data.send(self.data.is_a?(RBA::EdgePairs) ? :each : :each_merged) do |object| 
@@ -1699,6 +1718,8 @@ CODE
 
         @engine._wrapper_context("#{f}") do
 
+          @engine._flush_deferred
+
           if :#{f} == :collect
             new_data = self.data.class.new
           elsif :#{f} == :collect_to_region
@@ -1818,6 +1839,7 @@ CODE
             self.data = @engine._tcmd(self.data, 0, self.data.class, :snapped, gx, gy)
             self
           elsif :#{f} == :snap
+            self.data = @engine._op_cache_detach(self.data)
             @engine._tcmd(self.data, 0, self.data.class, :#{f}, gx, gy)
             self
           else
@@ -3612,6 +3634,7 @@ CODE
     # micrometer units. 
     
     def bbox
+      @engine._flush_deferred
       RBA::DBox::from_ibox(self.data.bbox) * @engine.dbu.to_f
     end
     
@@ -3765,6 +3788,7 @@ CODE
     def is_merged?
       @engine._context("is_merged?") do
         requires_edges_or_region
+        @engine._flush_deferred
         self.data.is_merged?
       end
     end
@@ -3775,6 +3799,7 @@ CODE
     # @synopsis layer.is_empty?
     
     def is_empty?
+      @engine._flush_deferred
       self.data.is_empty?
     end
     
@@ -4560,6 +4585,8 @@ CODE
       tile_size || raise("At least the tile_size option needs to be present")
       tile_step ||= tile_size
 
+      @engine._flush_deferred
+
       tp = RBA::TilingProcessor::new
       tp.dbu = @engine.dbu
       tp.scale_to_dbu = false
@@ -4927,6 +4954,7 @@ TP_SCRIPT
             self.data = @engine._tcmd(self.data, dist, RBA::Region, f_sized, *aa)
             self
           elsif :#{f} == :size 
+            self.data = @engine._op_cache_detach(self.data)
             @engine._tcmd(self.data, dist, RBA::Region, f_size, *aa)
             self
           else 
@@ -5131,6 +5159,7 @@ CODE
           # in tiled mode, no modifying versions are available
           self.data = @engine._tcmd(self.data, 0, self.data.class, :merged, *aa)
         else
+          self.data = @engine._op_cache_detach(self.data)
           @engine._tcmd(self.data, 0, self.data.class, :merge, *aa)
         end
         self
@@ -5179,6 +5208,7 @@ CODE
           # in tiled mode, no modifying versions are available
           self.data = @engine._tcmd(self.data, 0, self.data.class, :merged, *aa)
         else
+          self.data = @engine._op_cache_detach(self.data)
           @engine._tcmd(self.data, 0, self.data.class, :merge, *aa)
         end
         self
@@ -5310,6 +5340,7 @@ CODE
     def evaluate(expression, variables = {}, keep_properties = false)
       @engine._context("evaluate") do
         pr = _make_proc(expression, variables, keep_properties)
+        self.data = @engine._op_cache_detach(self.data)
         @engine._tcmd(self.data, 0, self.data.class, :process, pr)
         self
       end
@@ -5454,6 +5485,7 @@ CODE
     def select_if(expression, variables = {})
       @engine._context("select_if") do
         f = _make_filter(expression, variables)
+        self.data = @engine._op_cache_detach(self.data)
         @engine._tcmd(self.data, 0, self.data.class, :filter, f)
         self
       end
@@ -5545,6 +5577,7 @@ CODE
 
     def select_props(*args)
       @engine._context("select_props") do
+        @engine._flush_deferred
         keys = args.flatten 
         if keys.empty?
           DRC::DRCLayer::new(@engine, self.data.dup.enable_properties)
@@ -5556,6 +5589,7 @@ CODE
 
     def remove_props
       @engine._context("remove_props") do
+        @engine._flush_deferred
         DRC::DRCLayer::new(@engine, self.data.dup.remove_properties)
       end
     end
@@ -5563,6 +5597,7 @@ CODE
     def map_props(arg)
       @engine._context("map_props") do
         arg.is_a?(Hash) || raise("Argument of 'map_props' needs to be a mapping hash")
+        @engine._flush_deferred
         DRC::DRCLayer::new(@engine, self.data.dup.map_properties(arg))
       end
     end
@@ -5962,6 +5997,8 @@ CODE
       origin = origin ? dbu_trans * origin : nil
       fc_index = fill_cell.cell_index
 
+      @engine._flush_deferred
+
       if @engine._tx && @engine._ty
 
         tp = RBA::TilingProcessor::new
@@ -6062,6 +6099,8 @@ END
     # of the layer's data. 
     
     def data
+      # direct access from the script needs the results of pending concurrent operations
+      @engine._flush_deferred_on_access
       @engine._context("data") do
         @data || raise("Trying to access an invalid layer (did you use 'forget' on it?)")
         @data
@@ -371,6 +371,16 @@ module DRC
 
         id = l.data.data_id 
 
+        if @layers && @layers[id] && @layers[id][1] != name
+          # layers taken from the operation cache may share their data - 
+          # give this layer a copy of its own
+          data = @engine._op_cache_detach(l.data)
+          if ! data.equal?(l.data)
+            l.data = data
+            id = l.data.data_id
+          end
+        end
+
         if @layers && @layers[id]
           # already registered
           if @layers[id][1] != name
@@ -998,6 +1008,8 @@ module DRC
 
     def _register_layer(data, context, name = nil, lp = nil)
 
+      @engine._flush_deferred
+
       id = data.data_id 
       ensure_data
 
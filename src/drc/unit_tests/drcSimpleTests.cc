@@ -2143,3 +2143,15 @@ TEST(151d_edges_from_region_with_properties)
 {
   run_test (_this, "151", true);
 }
+
+//  NOTE: deep mode operations are not executed concurrently, hence there is no deep mode variant
+TEST(152_concurrent)
+{
+  run_test (_this, "152", false);
+}
+
+//  NOTE: the operation cache applies to deep mode only
+TEST(153d_operation_cache)
+{
+  run_test (_this, "153", true);
+}
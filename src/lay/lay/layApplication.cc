@@ -1249,7 +1249,7 @@ ApplicationBase::run ()
         }
 
         if (mw->current_view () != 0) {
-          int l2ndb_index = mw->current_view ()->add_l2ndb (db::LayoutToNetlist::create_from_file (f->second.first));
+          int l2ndb_index = mw->current_view ()->add_l2ndb (db::LayoutToNetlist::create_from_file (f->second.first, true));
           mw->current_view ()->open_l2ndb_browser (l2ndb_index, mw->current_view ()->active_cellview_index ());
         }
 
@@ -1322,7 +1322,7 @@ ApplicationBase::run ()
           batch_mode_view.reset (create_view (batch_mode_manager));
         }
 
-        batch_mode_view->add_l2ndb (db::LayoutToNetlist::create_from_file (f->second.first));
+        batch_mode_view->add_l2ndb (db::LayoutToNetlist::create_from_file (f->second.first, true));
 
       }
     }
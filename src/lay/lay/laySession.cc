@@ -252,7 +252,7 @@ Session::restore (lay::MainWindow &mw)
     for (unsigned int j = 0; j < vd.l2ndb_filenames.size (); ++j) {
 
       try {
-        db::LayoutToNetlist *l2ndb = db::LayoutToNetlist::create_from_file (make_absolute (vd.l2ndb_filenames [j]));
+        db::LayoutToNetlist *l2ndb = db::LayoutToNetlist::create_from_file (make_absolute (vd.l2ndb_filenames [j]), true);
         view->add_l2ndb (l2ndb);
       } catch (tl::Exception &ex) {
         tl::error << ex.msg ();
@@ -316,9 +316,12 @@ LayoutHandle::save_as (const std::string &fn, tl::OutputStream::OutputStreamMode
   try {
 
     {
+      //  A lazy loader reading from the target file needs to release it before the file is overwritten
+      mp_layout->release_source_file (fn);
+
       //  The write needs to be finished before the file watcher gets the new modification time
       db::Writer writer (options);
-      tl::OutputStream stream (fn, om, false, keep_backups);
+      tl::OutputStream stream (fn, om, false, keep_backups, options.compression_threads ());
       try {
         writer.write (*mp_layout, stream);
       } catch (...) {
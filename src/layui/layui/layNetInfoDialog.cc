@@ -88,6 +88,8 @@ size_t count_shapes (db::LayoutToNetlist *l2ndb, db::Net *net, unsigned int laye
   db::cell_index_type cell_index = net->circuit ()->cell_index ();
   size_t cluster_id = net->cluster_id ();
 
+  l2ndb->ensure_net_geometry (cell_index, cluster_id);
+
   size_t n = 0;
   for (db::recursive_cluster_shape_iterator<db::NetShape> shapes (l2ndb->net_clusters (), layer, cell_index, cluster_id); ! shapes.at_end (); ++shapes) {
     ++n;
@@ -255,6 +257,8 @@ void NetInfoDialog::update_info_text ()
       db::cell_index_type cell_index = net->circuit ()->cell_index ();
       size_t cluster_id = net->cluster_id ();
 
+      mp_l2ndb->ensure_net_geometry (cell_index, cluster_id);
+
       double dbu_unidir = ly->dbu ();
       db::CplxTrans dbu (ly->dbu ());
       db::VCplxTrans dbuinv = dbu.inverted ();
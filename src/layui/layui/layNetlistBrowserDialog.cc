@@ -446,7 +446,7 @@ BEGIN_PROTECTED
     if (lvsdb && ! mp_ui->browser_page->is_netlist_mode ()) {
 
       //  prepare and open the file dialog
-      lay::FileDialog save_dialog (this, tl::to_string (QObject::tr ("Save LVS Database")), "KLayout LVS DB files (*.lvsdb)");
+      lay::FileDialog save_dialog (this, tl::to_string (QObject::tr ("Save LVS Database")), "KLayout LVS DB files (*.lvsdb);;KLayout binary LVS DB files (*.lvsb)");
       std::string fn (lvsdb->filename ());
       if (save_dialog.get_save (fn)) {
 
@@ -460,7 +460,7 @@ BEGIN_PROTECTED
     } else if (l2ndb) {
 
       //  prepare and open the file dialog
-      lay::FileDialog save_dialog (this, tl::to_string (QObject::tr ("Save Netlist Database")), "KLayout L2N DB files (*.l2n)");
+      lay::FileDialog save_dialog (this, tl::to_string (QObject::tr ("Save Netlist Database")), "KLayout L2N DB files (*.l2n);;KLayout binary L2N DB files (*.l2nb)");
       std::string fn (l2ndb->filename ());
       if (save_dialog.get_save (fn)) {
 
@@ -495,7 +495,7 @@ BEGIN_PROTECTED
       try {
 
         m_l2ndb_name = l2ndb->name ();
-        db::LayoutToNetlist *new_l2ndb = db::LayoutToNetlist::create_from_file (l2ndb->filename ());
+        db::LayoutToNetlist *new_l2ndb = db::LayoutToNetlist::create_from_file (l2ndb->filename (), true);
 
         view ()->replace_l2ndb (m_l2n_index, new_l2ndb);
         mp_ui->browser_page->set_db (new_l2ndb);
@@ -526,7 +526,7 @@ BEGIN_PROTECTED
     fmts += ";;" + rdr->file_format ();
   }
 #else
-  fmts += ";;L2N DB files (*.l2n);;LVS DB files (*.lvsdb)";
+  fmts += ";;L2N DB files (*.l2n *.l2nb);;LVS DB files (*.lvsdb *.lvsb)";
   //  TODO: add plain spice
 #endif
 
@@ -537,7 +537,7 @@ BEGIN_PROTECTED
     tl::log << tl::to_string (QObject::tr ("Loading file: ")) << m_open_filename;
     tl::SelfTimer timer (tl::verbosity () >= 11, tl::to_string (QObject::tr ("Loading")));
 
-    int l2n_index = view ()->add_l2ndb (db::LayoutToNetlist::create_from_file (m_open_filename));
+    int l2n_index = view ()->add_l2ndb (db::LayoutToNetlist::create_from_file (m_open_filename, true));
     mp_ui->l2ndb_cb->setCurrentIndex (l2n_index);
     //  it looks like the setCurrentIndex does not issue this signal:
     l2ndb_index_changed (l2n_index);
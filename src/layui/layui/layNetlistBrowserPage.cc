@@ -1391,6 +1391,8 @@ bbox_for_net (const db::LayoutToNetlist *db, const db::Circuit *circuit, const d
   db::cell_index_type cell_index = circuit->cell_index ();
   size_t cluster_id = net->cluster_id ();
 
+  db->ensure_net_geometry (cell_index, cluster_id);
+
   const db::Connectivity &conn = db->connectivity ();
   for (db::Connectivity::all_layer_iterator layer = conn.begin_layers (); layer != conn.end_layers (); ++layer) {
 
@@ -1638,6 +1640,8 @@ NetlistBrowserPage::produce_highlights_for_net (const db::Net *net, size_t &n_ma
   db::cell_index_type cell_index = net->circuit ()->cell_index ();
   size_t cluster_id = net->cluster_id ();
 
+  mp_database->ensure_net_geometry (cell_index, cluster_id);
+
   tl::Color net_color = m_colorizer.color_of_net (net);
   tl::Color fallback_color = make_valid_color (m_colorizer.marker_color ());
 
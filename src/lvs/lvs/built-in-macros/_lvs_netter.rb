@@ -486,6 +486,7 @@ CODE
     def _comparer
 
       comparer = RBA::NetlistComparer::new
+      comparer.threads = @engine.threads || 0
 
       # execute the configuration commands
       @comparer_config.each do |cc|
@@ -91,7 +91,8 @@ class GDS2FormatDeclaration
     return new db::ReaderOptionsXMLElement<db::GDS2ReaderOptions> ("gds2",
       tl::make_member (&db::GDS2ReaderOptions::box_mode, "box-mode") +
       tl::make_member (&db::GDS2ReaderOptions::allow_big_records, "allow-big-records") +
-      tl::make_member (&db::GDS2ReaderOptions::allow_multi_xy_records, "allow-multi-xy-records")
+      tl::make_member (&db::GDS2ReaderOptions::allow_multi_xy_records, "allow-multi-xy-records") +
+      tl::make_member (&db::GDS2ReaderOptions::threads, "threads")
     );
   }
 };
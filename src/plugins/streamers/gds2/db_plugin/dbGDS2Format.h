@@ -45,7 +45,9 @@ public:
   GDS2ReaderOptions ()
     : box_mode (1),
       allow_big_records (true),
-      allow_multi_xy_records (true)
+      allow_multi_xy_records (true),
+      threads (0),
+      threads_min_size (8 * 1024 * 1024)
   {
     //  .. nothing yet ..
   }
@@ -75,6 +77,28 @@ public:
    */
   bool allow_multi_xy_records;
 
+  /**
+   *  @brief The number of threads to use for decoding cell content
+   *
+   *  If this value is larger than zero, the reader splits the cell content into
+   *  chunks at element boundaries and decodes these chunks in the given number of
+   *  background threads. Layers and cells are still created by the reading thread
+   *  in the order they are encountered, so the result is identical to the
+   *  single-threaded mode. A value of 0 (the default) disables threaded reading.
+   */
+  int threads;
+
+  /**
+   *  @brief The amount of data read single-threaded before the threads are used
+   *
+   *  The decoded shapes are merged into the layout by the reading thread, which
+   *  translates them into the layout's shape repository again. For small files,
+   *  this overhead outweighs the benefit of decoding in parallel. Hence the
+   *  cells starting within the first "threads_min_size" bytes of the file are
+   *  read single-threaded.
+   */
+  size_t threads_min_size;
+
   /** 
    *  @brief Implementation of FormatSpecificReaderOptions
    */
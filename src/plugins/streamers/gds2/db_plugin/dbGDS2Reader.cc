@@ -29,10 +29,344 @@
 #include "tlException.h"
 #include "tlString.h"
 #include "tlClassRegistry.h"
+#include "tlThreadedWorkers.h"
+
+#include <list>
+#include <set>
+#include <algorithm>
 
 namespace db
 {
 
+// ---------------------------------------------------------------
+//  GDS2ReaderChunkJob definition and implementation
+
+/**
+ *  @brief A warning or error issued while decoding a chunk
+ *
+ *  The position and record number refer to the original file.
+ */
+struct GDS2ReaderChunkMessage
+{
+  GDS2ReaderChunkMessage ()
+    : level (0), pos (0), recnum (0)
+  { }
+
+  GDS2ReaderChunkMessage (const std::string &_msg, int _level, size_t _pos, size_t _recnum, const std::string &_cellname)
+    : msg (_msg), level (_level), pos (_pos), recnum (_recnum), cellname (_cellname)
+  { }
+
+  std::string msg;
+  int level;
+  size_t pos, recnum;
+  std::string cellname;
+};
+
+/**
+ *  @brief A piece of cell content inside a chunk
+ *
+ *  A chunk may hold the content of several small cells and a big cell's content
+ *  may be spread over several chunks. Each segment is terminated by an ENDSTR record.
+ */
+struct GDS2ReaderChunkSegment
+{
+  GDS2ReaderChunkSegment (db::cell_index_type _cell_index, const std::string &_cellname, size_t _offset, size_t _local_recnum, size_t _pos, size_t _recnum)
+    : cell_index (_cell_index), cellname (_cellname), offset (_offset), local_recnum (_local_recnum), pos (_pos), recnum (_recnum), last (false), temp_cell_index (0)
+  { }
+
+  db::cell_index_type cell_index;
+  std::string cellname;
+  size_t offset, local_recnum;
+  size_t pos, recnum;
+  bool last;
+
+  db::cell_index_type temp_cell_index;
+  tl::vector<db::CellInstArray> instances;
+  tl::vector<db::CellInstArrayWithProperties> instances_with_props;
+  db::PropertiesSet cell_properties;
+};
+
+/**
+ *  @brief A chunk of records decoded by one worker
+ *
+ *  The layers and cells referenced inside the chunk are resolved by the reading
+ *  thread. The worker decodes the shapes into a temporary layout.
+ */
+struct GDS2ReaderChunk
+{
+  GDS2ReaderChunk ()
+    : records (0), layout (false), failed (false), finished (false)
+  { }
+
+  std::vector<char> data;
+  size_t records;
+  std::vector<GDS2ReaderChunkSegment> segments;
+  std::map<LDPair, std::pair<bool, unsigned int> > layers;
+  std::map<std::string, db::cell_index_type> cells;
+
+  db::Layout layout;
+  std::vector<GDS2ReaderChunkMessage> warnings;
+  GDS2ReaderChunkMessage error;
+  bool failed;
+  bool finished;
+};
+
+/**
+ *  @brief The reader decoding a chunk
+ *
+ *  This reader takes the layers and instantiated cells from the chunk and
+ *  collects the warnings and errors. Positions are translated back to the file.
+ */
+class GDS2ChunkReader
+  : public GDS2Reader
+{
+public:
+  GDS2ChunkReader (tl::InputStream &stream, GDS2ReaderChunk *chunk)
+    : GDS2Reader (stream), mp_chunk (chunk), mp_segment (0)
+  { }
+
+  void read (const db::LoadLayoutOptions &options)
+  {
+    init (options);
+    set_record_warnings (false);
+
+    for (auto s = mp_chunk->segments.begin (); s != mp_chunk->segments.end (); ++s) {
+      mp_segment = s.operator-> ();
+      s->temp_cell_index = mp_chunk->layout.add_anonymous_cell ();
+      read_elements (mp_chunk->layout, &mp_chunk->layout.cell (s->temp_cell_index), s->instances, s->instances_with_props, s->cell_properties);
+    }
+  }
+
+protected:
+  virtual std::pair <bool, unsigned int> open_layer (db::Layout & /*layout*/, const LDPair &ld)
+  {
+    auto l = mp_chunk->layers.find (ld);
+    if (l != mp_chunk->layers.end ()) {
+      return l->second;
+    } else {
+      return std::make_pair (false, (unsigned int) 0);
+    }
+  }
+
+  virtual db::cell_index_type instance_cell (db::Layout & /*layout*/, const std::string &cn)
+  {
+    auto c = mp_chunk->cells.find (cn);
+    tl_assert (c != mp_chunk->cells.end ());
+    return c->second;
+  }
+
+private:
+  GDS2ReaderChunk *mp_chunk;
+  const GDS2ReaderChunkSegment *mp_segment;
+
+  virtual void error (const std::string &msg)
+  {
+    mp_chunk->error = make_message (msg, 0);
+    mp_chunk->failed = true;
+    throw tl::Exception (msg);
+  }
+
+  virtual void warn (const std::string &msg, int wl = 1)
+  {
+    if (warn_level () >= wl) {
+      mp_chunk->warnings.push_back (make_message (msg, wl));
+    }
+  }
+
+  GDS2ReaderChunkMessage make_message (const std::string &msg, int wl) const
+  {
+    if (! mp_segment) {
+      return GDS2ReaderChunkMessage (msg, wl, 0, 0, std::string ());
+    } else {
+      return GDS2ReaderChunkMessage (msg, wl,
+                                     mp_segment->pos + (stream ().pos () - mp_segment->offset),
+                                     mp_segment->recnum + (record_number () - mp_segment->local_recnum),
+                                     mp_segment->cellname);
+    }
+  }
+};
+
+/**
+ *  @brief The task for decoding one chunk
+ */
+class GDS2ReaderChunkTask
+  : public tl::Task
+{
+public:
+  GDS2ReaderChunkTask (GDS2ReaderChunk *chunk)
+    : mp_chunk (chunk)
+  { }
+
+  GDS2ReaderChunk *chunk () const
+  {
+    return mp_chunk;
+  }
+
+private:
+  GDS2ReaderChunk *mp_chunk;
+};
+
+/**
+ *  @brief The worker decoding chunks
+ */
+class GDS2ReaderChunkWorker
+  : public tl::Worker
+{
+public:
+  GDS2ReaderChunkWorker (GDS2ReaderChunkJob *job)
+    : tl::Worker (), mp_job (job)
+  { }
+
+  virtual void perform_task (tl::Task *task);
+
+private:
+  GDS2ReaderChunkJob *mp_job;
+};
+
+/**
+ *  @brief A job that decodes chunks of cell content in the background
+ *
+ *  The chunks are delivered in the order they have been submitted.
+ */
+class GDS2ReaderChunkJob
+  : public tl::JobBase
+{
+public:
+  GDS2ReaderChunkJob (int nworkers, const db::LoadLayoutOptions &options)
+    : tl::JobBase (nworkers), m_options (options)
+  {
+    //  the chunk readers work single-threaded
+    m_options.get_options<db::GDS2ReaderOptions> ().threads = 0;
+    m_max_pending = std::max (size_t (2), size_t (nworkers) * 4);
+  }
+
+  ~GDS2ReaderChunkJob ()
+  {
+    //  stop the workers before the chunks are deleted
+    terminate ();
+
+    for (auto c = m_pending.begin (); c != m_pending.end (); ++c) {
+      delete *c;
+    }
+    m_pending.clear ();
+  }
+
+  /**
+   *  @brief Gets the options for the chunk readers
+   */
+  const db::LoadLayoutOptions &options () const
+  {
+    return m_options;
+  }
+
+  /**
+   *  @brief Schedules the given chunk for decoding
+   *
+   *  The job takes ownership over the chunk.
+   */
+  void submit (GDS2ReaderChunk *chunk)
+  {
+    m_pending.push_back (chunk);
+
+    schedule (new GDS2ReaderChunkTask (chunk));
+    if (! is_running ()) {
+      start ();
+    }
+  }
+
+  /**
+   *  @brief Returns true, if the maximum number of pending chunks is exceeded
+   */
+  bool is_full () const
+  {
+    return m_pending.size () > m_max_pending;
+  }
+
+  /**
+   *  @brief Returns true, if there are pending chunks
+   */
+  bool has_pending () const
+  {
+    return ! m_pending.empty ();
+  }
+
+  /**
+   *  @brief Waits for the oldest chunk and takes it
+   *
+   *  The caller takes ownership over the chunk.
+   */
+  GDS2ReaderChunk *take_next ()
+  {
+    tl_assert (! m_pending.empty ());
+
+    GDS2ReaderChunk *chunk = m_pending.front ();
+    m_pending.pop_front ();
+
+    m_lock.lock ();
+    while (! chunk->finished) {
+      m_finished_condition.wait (&m_lock);
+    }
+    m_lock.unlock ();
+
+    return chunk;
+  }
+
+  /**
+   *  @brief Called by the workers to indicate that a chunk is finished
+   */
+  void finish (GDS2ReaderChunk *chunk)
+  {
+    m_lock.lock ();
+    chunk->finished = true;
+    m_finished_condition.wakeAll ();
+    m_lock.unlock ();
+  }
+
+protected:
+  virtual tl::Worker *create_worker ()
+  {
+    return new GDS2ReaderChunkWorker (this);
+  }
+
+private:
+  db::LoadLayoutOptions m_options;
+  std::list<GDS2ReaderChunk *> m_pending;
+  size_t m_max_pending;
+  tl::Mutex m_lock;
+  tl::WaitCondition m_finished_condition;
+};
+
+void
+GDS2ReaderChunkWorker::perform_task (tl::Task *task)
+{
+  GDS2ReaderChunk *chunk = static_cast<GDS2ReaderChunkTask *> (task)->chunk ();
+
+  std::string error;
+
+  try {
+    tl::InputMemoryStream memory_stream (chunk->data.empty () ? 0 : &chunk->data.front (), chunk->data.size ());
+    tl::InputStream stream (memory_stream);
+    GDS2ChunkReader reader (stream, chunk);
+    reader.read (mp_job->options ());
+  } catch (tl::Exception &ex) {
+    error = ex.msg ();
+  } catch (std::exception &ex) {
+    error = ex.what ();
+  } catch (...) {
+    error = tl::to_string (tr ("Unspecific error"));
+  }
+
+  if (! error.empty () && ! chunk->failed) {
+    //  errors not issued by the reader are reported at the beginning of the chunk
+    const GDS2ReaderChunkSegment &s = chunk->segments.front ();
+    chunk->error = GDS2ReaderChunkMessage (error, 0, s.pos, s.recnum, s.cellname);
+    chunk->failed = true;
+  }
+
+  mp_job->finish (chunk);
+}
+
+
 // ---------------------------------------------------------------
 //  GDS2Reader
 
@@ -44,7 +378,10 @@ GDS2Reader::GDS2Reader (tl::InputStream &s)
     mp_rec_buf (0),
     m_stored_rec (0),
     m_allow_big_records (true),
-    m_progress (tl::to_string (tr ("Reading GDS2 file")), 10000)
+    m_threads_min_size (0),
+    m_record_warnings (true),
+    m_progress (tl::to_string (tr ("Reading GDS2 file")), 10000),
+    mp_chunk (0)
 {
   m_progress.set_format (tl::to_string (tr ("%.0f MB")));
   m_progress.set_unit (1024 * 1024);
@@ -52,7 +389,8 @@ GDS2Reader::GDS2Reader (tl::InputStream &s)
 
 GDS2Reader::~GDS2Reader ()
 {
-  //  .. nothing yet ..
+  delete mp_chunk;
+  mp_chunk = 0;
 }
 
 void
@@ -60,11 +398,236 @@ GDS2Reader::init (const db::LoadLayoutOptions &options)
 {
   GDS2ReaderBase::init (options);
 
-  m_allow_big_records = options.get_options<db::GDS2ReaderOptions> ().allow_big_records;
+  const db::GDS2ReaderOptions &gds2_options = options.get_options<db::GDS2ReaderOptions> ();
+  m_allow_big_records = gds2_options.allow_big_records;
+  m_threads_min_size = gds2_options.threads_min_size;
 
   m_recnum = 0;
   --m_recnum;
   m_reclen = 0;
+
+  delete mp_chunk;
+  mp_chunk = 0;
+  m_chunk_cell_properties.clear ();
+
+  if (gds2_options.threads > 0) {
+    mp_chunk_job.reset (new GDS2ReaderChunkJob (gds2_options.threads, options));
+  } else {
+    mp_chunk_job.reset (0);
+  }
+}
+
+void
+GDS2Reader::do_read (db::Layout &layout)
+{
+  try {
+
+    GDS2ReaderBase::do_read (layout);
+
+    if (mp_chunk_job.get ()) {
+
+      if (mp_chunk) {
+        mp_chunk_job->submit (mp_chunk);
+        mp_chunk = 0;
+      }
+
+      while (mp_chunk_job->has_pending ()) {
+        std::unique_ptr<GDS2ReaderChunk> chunk (mp_chunk_job->take_next ());
+        merge_chunk (layout, chunk.get ());
+      }
+
+    }
+
+  } catch (...) {
+    delete mp_chunk;
+    mp_chunk = 0;
+    mp_chunk_job.reset (0);
+    throw;
+  }
+
+  mp_chunk_job.reset (0);
+}
+
+void
+GDS2Reader::read_cell_content (db::Layout &layout, db::Cell *cell)
+{
+  //  NOTE: the cells at the beginning of the file are read single-threaded. As the
+  //  position grows, all cells read single-threaded precede the chunks.
+  if (! mp_chunk_job.get () || ! cell || m_stream.pos () < m_threads_min_size) {
+    GDS2ReaderBase::read_cell_content (layout, cell);
+    return;
+  }
+
+  //  In threaded mode, the records are collected into chunks which are decoded by
+  //  the workers. A chunk is closed at the next element when it exceeds this size.
+  //  Layers and instantiated cells are resolved here, so they are created in the
+  //  same order as in single-threaded mode.
+  const size_t chunk_size = 1024 * 1024;
+
+  db::cell_index_type cell_index = cell->cell_index ();
+  new_chunk_segment (cell_index, m_stream.pos (), m_recnum + 1);
+
+  short element = 0;
+  LDPair ld;
+
+  while (true) {
+
+    size_t pos = m_stream.pos ();
+    short rec_id = get_record ();
+
+    progress_checkpoint ();
+
+    if (rec_id == sBOUNDARY || rec_id == sPATH || rec_id == sSREF || rec_id == sAREF || rec_id == sTEXT || rec_id == sBOX || rec_id == sNODE) {
+
+      if (mp_chunk->data.size () >= chunk_size) {
+        append_record (sENDSTR, 0, 0);
+        submit_chunk (layout);
+        new_chunk_segment (cell_index, pos, m_recnum);
+      }
+
+      element = rec_id;
+
+    } else if (rec_id == sENDEL) {
+
+      element = 0;
+
+    } else if (rec_id == sLAYER) {
+
+      if (m_reclen >= 2) {
+        ld.layer = get_ushort ();
+      }
+
+    } else if (rec_id == sDATATYPE || rec_id == sTEXTTYPE || rec_id == sBOXTYPE) {
+
+      bool opens_layer = false;
+      if (rec_id == sDATATYPE) {
+        opens_layer = (element == sBOUNDARY || element == sPATH);
+      } else if (rec_id == sTEXTTYPE) {
+        opens_layer = (element == sTEXT && read_texts ());
+      } else {
+        opens_layer = (element == sBOX && (box_mode () == 1 || box_mode () == 2));
+      }
+
+      if (opens_layer && m_reclen >= 2) {
+        ld.datatype = get_ushort ();
+        if (mp_chunk->layers.find (ld) == mp_chunk->layers.end ()) {
+          mp_chunk->layers.insert (std::make_pair (ld, open_dl (layout, ld)));
+        }
+      }
+
+    } else if (rec_id == sSNAME) {
+
+      if (element == sSREF || element == sAREF) {
+        std::string cn = get_string ();
+        if (mp_chunk->cells.find (cn) == mp_chunk->cells.end ()) {
+          mp_chunk->cells.insert (std::make_pair (cn, cell_for_instance (layout, cn)));
+        }
+      }
+
+    }
+
+    append_record (rec_id, mp_rec_buf, m_reclen);
+
+    if (rec_id == sENDSTR) {
+      break;
+    }
+
+  }
+
+  mp_chunk->segments.back ().last = true;
+
+  if (mp_chunk->data.size () >= chunk_size) {
+    submit_chunk (layout);
+  }
+}
+
+void
+GDS2Reader::append_record (short rec_id, const unsigned char *data, size_t n)
+{
+  size_t l = n + 4;
+
+  std::vector<char> &d = mp_chunk->data;
+  d.push_back (char (l >> 8));
+  d.push_back (char (l));
+  d.push_back (char (rec_id >> 8));
+  d.push_back (char (rec_id));
+  if (n > 0) {
+    d.insert (d.end (), (const char *) data, (const char *) data + n);
+  }
+
+  ++mp_chunk->records;
+}
+
+void
+GDS2Reader::new_chunk_segment (db::cell_index_type cell_index, size_t pos, size_t recnum)
+{
+  if (! mp_chunk) {
+    mp_chunk = new GDS2ReaderChunk ();
+  }
+
+  mp_chunk->segments.push_back (GDS2ReaderChunkSegment (cell_index, cellname (), mp_chunk->data.size (), mp_chunk->records, pos, recnum));
+}
+
+void
+GDS2Reader::submit_chunk (db::Layout &layout)
+{
+  mp_chunk_job->submit (mp_chunk);
+  mp_chunk = 0;
+
+  //  limits the memory used for the chunks in flight
+  while (mp_chunk_job->is_full ()) {
+    std::unique_ptr<GDS2ReaderChunk> chunk (mp_chunk_job->take_next ());
+    merge_chunk (layout, chunk.get ());
+  }
+}
+
+void
+GDS2Reader::merge_chunk (db::Layout &layout, GDS2ReaderChunk *chunk)
+{
+  for (auto w = chunk->warnings.begin (); w != chunk->warnings.end (); ++w) {
+    issue_warning (w->msg, w->level, w->pos, w->recnum, w->cellname);
+  }
+
+  if (chunk->failed) {
+    throw GDS2ReaderException (chunk->error.msg, chunk->error.pos, chunk->error.recnum, chunk->error.cellname, m_stream.source ());
+  }
+
+  std::set<unsigned int> layers;
+  for (auto l = chunk->layers.begin (); l != chunk->layers.end (); ++l) {
+    if (l->second.first) {
+      layers.insert (l->second.second);
+    }
+  }
+
+  for (auto s = chunk->segments.begin (); s != chunk->segments.end (); ++s) {
+
+    db::Cell &cell = layout.cell (s->cell_index);
+    const db::Cell &temp_cell = chunk->layout.cell (s->temp_cell_index);
+
+    for (auto l = layers.begin (); l != layers.end (); ++l) {
+      const db::Shapes &shapes = temp_cell.shapes (*l);
+      if (! shapes.empty ()) {
+        cell.shapes (*l).insert (shapes);
+      }
+    }
+
+    if (! s->instances.empty ()) {
+      cell.insert (s->instances.begin (), s->instances.end ());
+    }
+    if (! s->instances_with_props.empty ()) {
+      cell.insert (s->instances_with_props.begin (), s->instances_with_props.end ());
+    }
+
+    //  the cell properties are set when the last piece of the cell has arrived
+    m_chunk_cell_properties.merge (s->cell_properties);
+    if (s->last) {
+      if (! m_chunk_cell_properties.empty ()) {
+        cell.prop_id (db::properties_id (m_chunk_cell_properties));
+      }
+      m_chunk_cell_properties.clear ();
+    }
+
+  }
 }
 
 void 
@@ -103,12 +666,14 @@ GDS2Reader::get_record ()
   }
   if (m_reclen >= 0x8000) {
     if (m_allow_big_records) {
-      warn (tl::to_string (tr ("Record length larger than 0x8000 encountered: interpreting as unsigned")));
+      if (m_record_warnings) {
+        warn (tl::to_string (tr ("Record length larger than 0x8000 encountered: interpreting as unsigned")));
+      }
     } else {
       error (tl::to_string (tr ("Record length larger than 0x8000 encountered (reader is configured not to allow such records)")));
     }
   }
-  if (m_reclen % 2 == 1) {
+  if (m_reclen % 2 == 1 && m_record_warnings) {
     warn (tl::to_string (tr ("Odd record length")));
   }
 
@@ -287,6 +852,12 @@ GDS2Reader::error (const std::string &msg)
 
 void 
 GDS2Reader::warn (const std::string &msg, int wl)
+{
+  issue_warning (msg, wl, m_stream.pos (), m_recnum, cellname ());
+}
+
+void
+GDS2Reader::issue_warning (const std::string &msg, int wl, size_t pos, size_t recnum, const std::string &cn)
 {
   if (warn_level () < wl) {
     return;
@@ -299,9 +870,9 @@ GDS2Reader::warn (const std::string &msg, int wl)
   int ws = compress_warning (msg);
   if (ws < 0) {
     tl::warn << msg
-             << tl::to_string (tr (" (position=")) << m_stream.pos ()
-             << tl::to_string (tr (", record number=")) << m_recnum
-             << tl::to_string (tr (", cell=")) << cellname ().c_str ()
+             << tl::to_string (tr (" (position=")) << pos
+             << tl::to_string (tr (", record number=")) << recnum
+             << tl::to_string (tr (", cell=")) << cn.c_str ()
              << ")";
   } else if (ws == 0) {
     tl::warn << tl::to_string (tr ("... further warnings of this kind are not shown"));
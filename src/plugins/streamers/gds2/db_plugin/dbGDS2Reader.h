@@ -38,9 +38,14 @@
 #include "tlString.h"
 #include "tlStream.h"
 
+#include <memory>
+
 namespace db
 {
 
+class GDS2ReaderChunkJob;
+struct GDS2ReaderChunk;
+
 /**
  *  @brief Generic base class of GDS2 reader exceptions
  */
@@ -79,6 +84,40 @@ public:
 
 protected:
   virtual void init (const LoadLayoutOptions &options);
+  virtual void do_read (db::Layout &layout);
+  virtual void read_cell_content (db::Layout &layout, db::Cell *cell);
+
+  /**
+   *  @brief Gets the number of the current record
+   */
+  size_t record_number () const
+  {
+    return m_recnum;
+  }
+
+  /**
+   *  @brief Gets the stream the reader is working on
+   */
+  const tl::InputStream &stream () const
+  {
+    return m_stream;
+  }
+
+  /**
+   *  @brief Enables or disables warnings about record lengths
+   *
+   *  These warnings are disabled for the chunk readers in threaded mode as
+   *  the reading thread already issued them.
+   */
+  void set_record_warnings (bool f)
+  {
+    m_record_warnings = f;
+  }
+
+  /**
+   *  @brief Issues a warning with explicit position information
+   */
+  void issue_warning (const std::string &msg, int wl, size_t pos, size_t recnum, const std::string &cellname);
 
 private:
   tl::InputStream &m_stream;
@@ -89,7 +128,12 @@ private:
   tl::string m_string_buf;
   short m_stored_rec;
   bool m_allow_big_records;
+  size_t m_threads_min_size;
+  bool m_record_warnings;
   tl::AbsoluteProgress m_progress;
+  std::unique_ptr<GDS2ReaderChunkJob> mp_chunk_job;
+  GDS2ReaderChunk *mp_chunk;
+  db::PropertiesSet m_chunk_cell_properties;
 
   virtual void error (const std::string &txt);
   virtual void warn (const std::string &txt, int wl = 1);
@@ -108,6 +152,10 @@ private:
   virtual void progress_checkpoint ();
 
   void record_underflow_error ();
+  void append_record (short rec_id, const unsigned char *data, size_t n);
+  void new_chunk_segment (db::cell_index_type cell_index, size_t pos, size_t recnum);
+  void submit_chunk (db::Layout &layout);
+  void merge_chunk (db::Layout &layout, GDS2ReaderChunk *chunk);
 };
 
 }
@@ -250,11 +250,6 @@ GDS2ReaderBase::do_read (db::Layout &layout)
     layout.prop_id (db::properties_id (layout_properties));
   }
 
-  //  this container has been found to grow quite a lot.
-  //  using a list instead of a vector should make this more efficient.
-  tl::vector<db::CellInstArray> instances;
-  tl::vector<db::CellInstArrayWithProperties> instances_with_props;
-
   //  prepare a string vector for the context information
   m_context_info.clear ();
 
@@ -265,10 +260,6 @@ GDS2ReaderBase::do_read (db::Layout &layout)
 
     progress_checkpoint ();
 
-    //  erase current instance list 
-    instances.erase (instances.begin (), instances.end ());
-    instances_with_props.erase (instances_with_props.begin (), instances_with_props.end ());
-
     if (get_record () != sSTRNAME) {
       error (tl::to_string (tr ("STRNAME record expected")));
     }
@@ -310,99 +301,121 @@ GDS2ReaderBase::do_read (db::Layout &layout)
         cell = &layout.cell (cell_index);
       }
 
-      long attr = 0;
-      db::PropertiesSet cell_properties;
+      read_cell_content (layout, cell);
 
-      //  read cell content
-      while ((rec_id = get_record ()) != sENDSTR) { 
+    }
 
-        progress_checkpoint ();
+    m_cellname = "";
+    first_cell = false;
 
-        if (cell == 0) {
+  }
 
-          //  ignore everything in proxy cells: these are created from the libraries or PCells.
+  //  deserialize global context information
+  auto ctx = m_context_info.find (std::string ());
+  if (ctx != m_context_info.end ()) {
+    LayoutOrCellContextInfo ci = LayoutOrCellContextInfo::deserialize (ctx->second.begin (), ctx->second.end ());
+    layout.fill_meta_info_from_context (ci);
+  }
 
-        } else if (rec_id == sPROPATTR) {
+  //  check, if the last record is a ENDLIB
+  if (rec_id != sENDLIB) {
+    error (tl::to_string (tr ("ENDLIB record expected")));
+  }
+}
 
-          attr = long (get_ushort ());
+void
+GDS2ReaderBase::read_cell_content (db::Layout &layout, db::Cell *cell)
+{
+  //  erase current instance list 
+  m_instances.erase (m_instances.begin (), m_instances.end ());
+  m_instances_with_props.erase (m_instances_with_props.begin (), m_instances_with_props.end ());
 
-        } else if (rec_id == sPROPVALUE) {
+  db::PropertiesSet cell_properties;
 
-          const char *value = get_string ();
-          if (m_read_properties) {
-            cell_properties.insert (tl::Variant (attr), tl::Variant (value));
-          }
+  read_elements (layout, cell, m_instances, m_instances_with_props, cell_properties);
 
-        } else if (rec_id == sBOUNDARY) {
+  if (cell) {
 
-          read_boundary (layout, *cell, false);
+    //  insert all instances collected
+    if (! m_instances.empty ()) {
+      cell->insert (m_instances.begin (), m_instances.end ());
+    }
+    if (! m_instances_with_props.empty ()) {
+      cell->insert (m_instances_with_props.begin (), m_instances_with_props.end ());
+    }
 
-        } else if (rec_id == sPATH) {
+    //  set the cell properties
+    if (! cell_properties.empty ()) {
+      cell->prop_id (db::properties_id (cell_properties));
+    }
 
-          read_path (layout, *cell);
+  }
+}
 
-        } else if (rec_id == sSREF || rec_id == sAREF) {
+void
+GDS2ReaderBase::read_elements (db::Layout &layout, db::Cell *cell, tl::vector<db::CellInstArray> &instances, tl::vector<db::CellInstArrayWithProperties> &instances_with_props, db::PropertiesSet &cell_properties)
+{
+  short rec_id = 0;
+  long attr = 0;
 
-          bool array = (rec_id == sAREF);
-          read_ref (layout, *cell, array, instances, instances_with_props);
+  //  read cell content
+  while ((rec_id = get_record ()) != sENDSTR) { 
 
-        } else if (rec_id == sTEXT) {
+    progress_checkpoint ();
 
-          read_text (layout, *cell);
+    if (cell == 0) {
 
-        } else if (rec_id == sBOX) {
+      //  ignore everything in proxy cells: these are created from the libraries or PCells.
 
-          if (m_box_mode == 1) {
-            read_box (layout, *cell);
-          } else if (m_box_mode == 2) {
-            read_boundary (layout, *cell, true);
-          } else if (m_box_mode == 3) {
-            error (tl::to_string (tr ("BOX record encountered (reader is configured to produce an error in this case)")));
-          } else {
-            while (get_record () != sENDEL) { }
-          }
+    } else if (rec_id == sPROPATTR) {
 
-        } else if (rec_id == sNODE) {
+      attr = long (get_ushort ());
 
-          //  NODE records are ignored.
-          while (get_record () != sENDEL) { }
+    } else if (rec_id == sPROPVALUE) {
 
-        } else {
-          error (tl::to_string (tr ("Invalid record or data type")));
-        }
-      
+      const char *value = get_string ();
+      if (m_read_properties) {
+        cell_properties.insert (tl::Variant (attr), tl::Variant (value));
       }
 
-      //  insert all instances collected
-      if (! instances.empty ()) {
-        cell->insert (instances.begin (), instances.end ());
-      }
-      if (! instances_with_props.empty ()) {
-        cell->insert (instances_with_props.begin (), instances_with_props.end ());
-      }
+    } else if (rec_id == sBOUNDARY) {
 
-      //  set the cell properties
-      if (! cell_properties.empty ()) {
-        cell->prop_id (db::properties_id (cell_properties));
-      }
+      read_boundary (layout, *cell, false);
 
-    }
+    } else if (rec_id == sPATH) {
 
-    m_cellname = "";
-    first_cell = false;
+      read_path (layout, *cell);
 
-  }
+    } else if (rec_id == sSREF || rec_id == sAREF) {
 
-  //  deserialize global context information
-  auto ctx = m_context_info.find (std::string ());
-  if (ctx != m_context_info.end ()) {
-    LayoutOrCellContextInfo ci = LayoutOrCellContextInfo::deserialize (ctx->second.begin (), ctx->second.end ());
-    layout.fill_meta_info_from_context (ci);
-  }
+      bool array = (rec_id == sAREF);
+      read_ref (layout, *cell, array, instances, instances_with_props);
 
-  //  check, if the last record is a ENDLIB
-  if (rec_id != sENDLIB) {
-    error (tl::to_string (tr ("ENDLIB record expected")));
+    } else if (rec_id == sTEXT) {
+
+      read_text (layout, *cell);
+
+    } else if (rec_id == sBOX) {
+
+      if (m_box_mode == 1) {
+        read_box (layout, *cell);
+      } else if (m_box_mode == 2) {
+        read_boundary (layout, *cell, true);
+      } else if (m_box_mode == 3) {
+        error (tl::to_string (tr ("BOX record encountered (reader is configured to produce an error in this case)")));
+      } else {
+        while (get_record () != sENDEL) { }
+      }
+
+    } else if (rec_id == sNODE) {
+
+      //  NODE records are ignored.
+      while (get_record () != sENDEL) { }
+
+    } else {
+      error (tl::to_string (tr ("Invalid record or data type")));
+    }
+  
   }
 }
 
@@ -568,7 +581,7 @@ GDS2ReaderBase::read_boundary (db::Layout &layout, db::Cell &cell, bool from_box
   unsigned int xy_length = 0;
   GDS2XY *xy_data = get_xy_data (xy_length);
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, ld);
+  std::pair<bool, unsigned int> ll = open_layer (layout, ld);
   if (ll.first) {
 
     //  create a box object if possible
@@ -749,7 +762,7 @@ GDS2ReaderBase::read_path (db::Layout &layout, db::Cell &cell)
   unsigned int xy_length = 0;
   GDS2XY *xy_data = get_xy_data (xy_length);
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, ld);
+  std::pair<bool, unsigned int> ll = open_layer (layout, ld);
   if (ll.first) {
 
     //  this will copy the path:
@@ -840,7 +853,7 @@ GDS2ReaderBase::read_text (db::Layout &layout, db::Cell &cell)
   std::pair<bool, unsigned int> ll (false, 0);
 
   if (m_read_texts) {
-    ll = open_dl (layout, ld);
+    ll = open_layer (layout, ld);
   }
 
   rec_id = get_record ();
@@ -962,7 +975,7 @@ GDS2ReaderBase::read_box (db::Layout &layout, db::Cell &cell)
   }
   ld.datatype = get_ushort ();
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, ld);
+  std::pair<bool, unsigned int> ll = open_layer (layout, ld);
 
   if (get_record () != sXY) {
     error (tl::to_string (tr ("XY record expected")));
@@ -1005,7 +1018,7 @@ GDS2ReaderBase::read_ref (db::Layout &layout, db::Cell & /*cell*/, bool array, t
     error (tl::to_string (tr ("SNAME record expected")));
   }
 
-  db::cell_index_type ci = cell_for_instance (layout, get_string ());
+  db::cell_index_type ci = instance_cell (layout, get_string ());
 
   bool mirror = false;
   int angle = 0;
@@ -77,6 +77,70 @@ protected:
   virtual void do_read (db::Layout &layout);
   virtual void init (const LoadLayoutOptions &options);
 
+  /**
+   *  @brief Reads the content of a cell up to the ENDSTR record
+   *
+   *  If "cell" is 0, the content is skipped.
+   */
+  virtual void read_cell_content (db::Layout &layout, db::Cell *cell);
+
+  /**
+   *  @brief Reads the elements of a cell up to the ENDSTR record
+   *
+   *  Shapes are inserted into the cell. Instances and cell properties are collected in the
+   *  given containers. If "cell" is 0, the elements are skipped.
+   */
+  void read_elements (db::Layout &layout, db::Cell *cell, tl::vector<db::CellInstArray> &instances, tl::vector<db::CellInstArrayWithProperties> &instances_with_props, db::PropertiesSet &cell_properties);
+
+  /**
+   *  @brief Provides the layer for the given layer/datatype pair
+   *
+   *  The default implementation employs the layer mapping of the common reader.
+   */
+  virtual std::pair <bool, unsigned int> open_layer (db::Layout &layout, const LDPair &ld)
+  {
+    return open_dl (layout, ld);
+  }
+
+  /**
+   *  @brief Provides the cell index for an instance of the cell with the given name
+   *
+   *  The default implementation employs the cell mapping of the common reader.
+   */
+  virtual db::cell_index_type instance_cell (db::Layout &layout, const std::string &cn)
+  {
+    return cell_for_instance (layout, cn);
+  }
+
+  /**
+   *  @brief Gets a value indicating whether text objects are read
+   */
+  bool read_texts () const
+  {
+    return m_read_texts;
+  }
+
+  /**
+   *  @brief Gets the BOX record mode (see GDS2ReaderOptions)
+   */
+  unsigned int box_mode () const
+  {
+    return m_box_mode;
+  }
+
+  virtual void error (const std::string &txt) = 0;
+  virtual void warn (const std::string &txt, int warn_level = 1) = 0;
+
+  virtual const char *get_string () = 0;
+  virtual void get_string (std::string &s) const = 0;
+  virtual int get_int () = 0;
+  virtual short get_short () = 0;
+  virtual unsigned short get_ushort () = 0;
+  virtual double get_double () = 0;
+  virtual short get_record () = 0;
+  virtual void unget_record (short rec_id) = 0;
+  virtual void progress_checkpoint () = 0;
+
 private:
   friend class GDS2ReaderLayerMapping;
 
@@ -89,6 +153,8 @@ private:
   unsigned int m_box_mode;
   std::map <tl::string, std::vector<std::string> > m_context_info;
   std::vector <db::Point> m_all_points;
+  tl::vector<db::CellInstArray> m_instances;
+  tl::vector<db::CellInstArrayWithProperties> m_instances_with_props;
 
   void read_context_info_cell ();
   void read_boundary (db::Layout &layout, db::Cell &cell, bool from_box_record);
@@ -103,21 +169,9 @@ private:
   virtual void common_reader_error (const std::string &msg) { error (msg); }
   virtual void common_reader_warn (const std::string &msg, int warn_level = 1) { warn (msg, warn_level); }
 
-  virtual void error (const std::string &txt) = 0;
-  virtual void warn (const std::string &txt, int warn_level = 1) = 0;
-
   virtual std::string path () const = 0;
-  virtual const char *get_string () = 0;
-  virtual void get_string (std::string &s) const = 0;
-  virtual int get_int () = 0;
-  virtual short get_short () = 0;
-  virtual unsigned short get_ushort () = 0;
-  virtual double get_double () = 0;
-  virtual short get_record () = 0;
-  virtual void unget_record (short rec_id) = 0;
   virtual void get_time (unsigned int *mod_time, unsigned int *access_time) = 0;
   virtual GDS2XY *get_xy_data (unsigned int &xy_length) = 0;
-  virtual void progress_checkpoint () = 0;
 };
 
 }
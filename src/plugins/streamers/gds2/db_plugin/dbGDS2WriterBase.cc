@@ -591,6 +591,9 @@ GDS2WriterBase::write (db::Layout &layout, tl::OutputStream &stream, const db::S
         throw tl::Exception (ex.msg () + tl::sprintf (tl::to_string (tr (", writing cell '%s'")), layout.cell_name (*cell)));
       }
 
+      //  drop the shapes again if they have been loaded on demand in transient mode
+      cref.release_content ();
+
     }
 
   }
@@ -302,6 +302,16 @@ static bool get_gds2_allow_big_records (const db::LoadLayoutOptions *options)
   return options->get_options<db::GDS2ReaderOptions> ().allow_big_records;
 }
 
+static void set_gds2_threads (db::LoadLayoutOptions *options, int n)
+{
+  options->get_options<db::GDS2ReaderOptions> ().threads = n;
+}
+
+static int get_gds2_threads (const db::LoadLayoutOptions *options)
+{
+  return options->get_options<db::GDS2ReaderOptions> ().threads;
+}
+
 //  extend lay::LoadLayoutOptions with the GDS2 options 
 static
 gsi::ClassExt<db::LoadLayoutOptions> gds2_reader_options (
@@ -340,6 +350,20 @@ gsi::ClassExt<db::LoadLayoutOptions> gds2_reader_options (
     "@brief Gets a value specifying whether to allow big records with a length of 32768 to 65535 bytes.\n"
     "See \\gds2_allow_big_records= method for a description of this property."
     "\nThis property has been added in version 0.18.\n"
+  ) +
+  gsi::method_ext ("gds2_threads=", &set_gds2_threads, gsi::arg ("n"),
+    "@brief Specifies the number of threads to use for decoding the cell content\n"
+    "If this value is larger than zero, the GDS2 reader will split the cell content into chunks and decode "
+    "these chunks in the given number of background threads. With a value of 0 (the default), the "
+    "file is read in the main thread. The resulting layout does not depend on this setting.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
+  gsi::method_ext ("gds2_threads", &get_gds2_threads,
+    "@brief Gets the number of threads to use for decoding the cell content\n"
+    "See \\gds2_threads= for details about this property.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
   ),
   ""
 );
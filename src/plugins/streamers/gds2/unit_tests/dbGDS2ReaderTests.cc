@@ -22,6 +22,7 @@
 
 #include "dbGDS2Reader.h"
 #include "dbLayoutDiff.h"
+#include "dbWriter.h"
 #include "dbTestSupport.h"
 #include "tlUnitTest.h"
 #include "tlStream.h"
@@ -724,3 +725,217 @@ TEST(6_issue1835)
   db::compare_layouts (_this, layout, fn_au, db::WriteGDS2, 1);
 }
 
+
+static void read_gds2 (db::Layout &layout, tl::InputStream &stream, int threads)
+{
+  db::LoadLayoutOptions options;
+  options.get_options<db::GDS2ReaderOptions> ().threads = threads;
+  //  the test files are small, so the threads are used right from the beginning
+  options.get_options<db::GDS2ReaderOptions> ().threads_min_size = 0;
+
+  db::Reader reader (stream);
+  reader.read (layout, options);
+}
+
+static void compare_threaded (tl::TestBase *_this, const db::Layout &layout_st, const db::Layout &layout_mt)
+{
+  //  layers and cells need to be created in the same order
+  EXPECT_EQ (layout_mt.layers (), layout_st.layers ());
+  for (unsigned int l = 0; l < layout_st.layers () && l < layout_mt.layers (); ++l) {
+    EXPECT_EQ (layout_mt.get_properties (l).to_string (), layout_st.get_properties (l).to_string ());
+  }
+
+  EXPECT_EQ (layout_mt.cells (), layout_st.cells ());
+  for (db::cell_index_type c = 0; c < layout_st.cells () && c < layout_mt.cells (); ++c) {
+    EXPECT_EQ (std::string (layout_mt.cell_name (c)), std::string (layout_st.cell_name (c)));
+    EXPECT_EQ (layout_mt.cell (c).prop_id (), layout_st.cell (c).prop_id ());
+  }
+
+  EXPECT_EQ (db::compare_layouts (layout_st, layout_mt, db::layout_diff::f_verbose, 0, 100), true);
+}
+
+static void run_threaded_test (tl::TestBase *_this, const std::string &file)
+{
+  db::Layout layout_st, layout_mt;
+
+  {
+    tl::InputStream stream (tl::testdata () + "/gds/" + file);
+    read_gds2 (layout_st, stream, 0);
+  }
+
+  {
+    tl::InputStream stream (tl::testdata () + "/gds/" + file);
+    read_gds2 (layout_mt, stream, 3);
+  }
+
+  compare_threaded (_this, layout_st, layout_mt);
+}
+
+static void make_threaded_test_layout (db::Layout &layout)
+{
+  db::cell_index_type top_index = layout.add_cell ("TOP");
+  db::cell_index_type a_index = layout.add_cell ("A");
+  db::cell_index_type b_index = layout.add_cell ("B");
+
+  unsigned int l1 = layout.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout.insert_layer (db::LayerProperties (2, 5));
+  unsigned int l3 = layout.insert_layer (db::LayerProperties (3, 0));
+
+  db::PropertiesSet ps;
+  ps.insert (tl::Variant (1), tl::Variant ("value"));
+  db::properties_id_type pid = db::properties_id (ps);
+
+  layout.cell (a_index).shapes (l1).insert (db::Box (0, 0, 100, 200));
+  layout.cell (b_index).shapes (l3).insert (db::Text ("B", db::Trans ()));
+
+  db::Cell &top = layout.cell (top_index);
+  top.prop_id (pid);
+
+  //  enough elements to produce several chunks
+  for (int i = 0; i < 40000; ++i) {
+    db::Box box (i * 10, 0, i * 10 + 5, (i % 17) * 10 + 10);
+    if (i % 3 == 0) {
+      top.shapes (l1).insert (db::BoxWithProperties (box, pid));
+    } else {
+      top.shapes (i % 2 == 0 ? l1 : l2).insert (box);
+    }
+    if (i % 1000 == 0) {
+      top.shapes (l3).insert (db::Text ("T" + tl::to_string (i), db::Trans (db::Vector (i * 10, 0))));
+      top.insert (db::CellInstArray (db::CellInst (a_index), db::Trans (db::Vector (i * 10, 500))));
+      top.insert (db::CellInstArray (db::CellInst (b_index), db::Trans (db::Vector (i * 10, 1000)), db::Vector (100, 0), db::Vector (0, 100), 3, 2));
+    }
+  }
+}
+
+static void write_gds2 (const db::Layout &layout, std::vector<char> &data)
+{
+  tl::OutputMemoryStream buffer;
+
+  {
+    tl::OutputStream stream (buffer);
+
+    db::SaveLayoutOptions options;
+    options.set_format ("GDS2");
+    options.set_option_by_name ("gds2_write_cell_properties", true);
+
+    db::Writer writer (options);
+    writer.write (const_cast<db::Layout &> (layout), stream);
+  }
+
+  data.assign (buffer.data (), buffer.data () + buffer.size ());
+}
+
+static std::string read_gds2_with_error (db::Layout &layout, const std::vector<char> &data, int threads)
+{
+  try {
+    tl::InputMemoryStream im (&data.front (), data.size ());
+    tl::InputStream stream (im);
+    read_gds2 (layout, stream, threads);
+    return std::string ();
+  } catch (tl::Exception &ex) {
+    return ex.msg ();
+  }
+}
+
+//  Threaded reading delivers the same results than single-threaded reading
+TEST(7_Threaded)
+{
+  run_threaded_test (_this, "alm.gds");
+  run_threaded_test (_this, "arefs.gds");
+  run_threaded_test (_this, "basic_instances.gds");
+  run_threaded_test (_this, "issue_893.gds");
+  run_threaded_test (_this, "pcell_test.gds");
+  run_threaded_test (_this, "t10.gds");
+  run_threaded_test (_this, "t166_au.gds.gz");
+}
+
+TEST(8_ThreadedChunks)
+{
+  db::Layout layout;
+  make_threaded_test_layout (layout);
+
+  std::vector<char> data;
+  write_gds2 (layout, data);
+
+  db::Layout layout_st, layout_mt;
+  EXPECT_EQ (read_gds2_with_error (layout_st, data, 0), "");
+  EXPECT_EQ (read_gds2_with_error (layout_mt, data, 4), "");
+
+  compare_threaded (_this, layout_st, layout_mt);
+  EXPECT_EQ (db::compare_layouts (layout, layout_mt, db::layout_diff::f_verbose, 0, 100), true);
+}
+
+//  Errors are reported at the same position in threaded mode
+TEST(9_ThreadedErrors)
+{
+  db::Layout layout;
+  make_threaded_test_layout (layout);
+
+  std::vector<char> data;
+  write_gds2 (layout, data);
+
+  //  turn the DATATYPE record of the 30000th BOUNDARY into a LAYER record
+  size_t pos = 0;
+  size_t boundaries = 0;
+  short last_rec_id = 0;
+  while (pos + 4 <= data.size ()) {
+    size_t l = (size_t ((unsigned char) data [pos]) << 8) + size_t ((unsigned char) data [pos + 1]);
+    short rec_id = short ((((unsigned char) data [pos + 2]) << 8) + ((unsigned char) data [pos + 3]));
+    if (rec_id == 0x0800) {
+      ++boundaries;
+    } else if (rec_id == 0x0e02 && last_rec_id == 0x0d02 && boundaries == 30000) {
+      data [pos + 2] = 0x0d;
+      break;
+    }
+    last_rec_id = rec_id;
+    pos += l;
+  }
+
+  EXPECT_EQ (boundaries, size_t (30000));
+
+  db::Layout layout_st, layout_mt;
+  std::string error_st = read_gds2_with_error (layout_st, data, 0);
+  std::string error_mt = read_gds2_with_error (layout_mt, data, 4);
+
+  EXPECT_EQ (error_st.find ("DATATYPE record expected") != std::string::npos, true);
+  EXPECT_EQ (error_mt, error_st);
+}
+
+//  The cells at the beginning of the file are read single-threaded
+TEST(10_ThreadedMinSize)
+{
+  db::Layout layout;
+  make_threaded_test_layout (layout);
+
+  std::vector<char> data;
+  write_gds2 (layout, data);
+
+  //  the threads are used for the last cell only
+  size_t pos = 0;
+  size_t last_bgnstr = 0;
+  while (pos + 4 <= data.size ()) {
+    size_t l = (size_t ((unsigned char) data [pos]) << 8) + size_t ((unsigned char) data [pos + 1]);
+    short rec_id = short ((((unsigned char) data [pos + 2]) << 8) + ((unsigned char) data [pos + 3]));
+    if (rec_id == 0x0502) {
+      last_bgnstr = pos;
+    }
+    pos += l;
+  }
+
+  EXPECT_EQ (last_bgnstr > 0, true);
+
+  db::LoadLayoutOptions options;
+  options.get_options<db::GDS2ReaderOptions> ().threads = 4;
+  options.get_options<db::GDS2ReaderOptions> ().threads_min_size = last_bgnstr;
+
+  db::Layout layout_mt;
+
+  {
+    tl::InputMemoryStream im (&data.front (), data.size ());
+    tl::InputStream stream (im);
+    db::Reader reader (stream);
+    reader.read (layout_mt, options);
+  }
+
+  EXPECT_EQ (db::compare_layouts (layout, layout_mt, db::layout_diff::f_verbose, 0, 100), true);
+}
@@ -41,6 +41,16 @@ static const std::string &get_lstream_bbox_meta_info_key (const db::LoadLayoutOp
   return options->get_options<lstr::ReaderOptions> ().bbox_meta_info_key;
 }
 
+static void set_lstream_region (db::LoadLayoutOptions *options, const db::DBox &region)
+{
+  options->get_options<lstr::ReaderOptions> ().region = region;
+}
+
+static db::DBox get_lstream_region (const db::LoadLayoutOptions *options)
+{
+  return options->get_options<lstr::ReaderOptions> ().region;
+}
+
 //  extend lay::LoadLayoutOptions with the OASIS options
 static
 gsi::ClassExt<db::LoadLayoutOptions> lstream_reader_options (
@@ -49,6 +59,22 @@ gsi::ClassExt<db::LoadLayoutOptions> lstream_reader_options (
   ) +
   gsi::method_ext ("lstream_bbox_meta_info_key", &get_lstream_bbox_meta_info_key,
     "@brief If not an empty string, this attribute specifies the key under which the cell bounding box information is stored"
+  ) +
+  gsi::method_ext ("lstream_region=", &set_lstream_region, gsi::arg ("region"),
+    "@brief Specifies a region of interest for reading LStream files\n"
+    "If this box is not empty, only the shapes inside this region are read. The region is given in micrometer "
+    "units and in the coordinates of the top cells. The shapes are read in chunks, so shapes outside the region may "
+    "be read as well. The chunks are formed by the writer if a tile size is specified (see \\SaveLayoutOptions#lstream_tile_size=). "
+    "Cell hierarchy and instances are always read completely. This option requires an uncompressed file. For compressed "
+    "files, the whole file is read.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
+  gsi::method_ext ("lstream_region", &get_lstream_region,
+    "@brief Gets the region of interest for reading LStream files\n"
+    "See \\lstream_region= for details about this property.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
   ),
   ""
 );
@@ -86,6 +112,16 @@ static bool get_lstream_permissive (const db::SaveLayoutOptions *options)
   return options->get_options<lstr::WriterOptions> ().permissive;
 }
 
+static void set_lstream_tile_size (db::SaveLayoutOptions *options, double ts)
+{
+  options->get_options<lstr::WriterOptions> ().tile_size = ts;
+}
+
+static double get_lstream_tile_size (const db::SaveLayoutOptions *options)
+{
+  return options->get_options<lstr::WriterOptions> ().tile_size;
+}
+
 //  extend lay::SaveLayoutOptions with the OASIS options
 static
 gsi::ClassExt<db::SaveLayoutOptions> lstream_writer_options (
@@ -118,6 +154,21 @@ gsi::ClassExt<db::SaveLayoutOptions> lstream_writer_options (
   gsi::method_ext ("lstream_compression_level", &get_lstream_compression,
     "@brief Get the LStream compression level\n"
     "See \\oasis_compression_level= method for a description of the LStream compression level."
+  ) +
+  gsi::method_ext ("lstream_tile_size=", &set_lstream_tile_size, gsi::arg ("size"),
+    "@brief Sets the tile size for the spatial index in micrometer units\n"
+    "If this value is larger than zero, the shapes of a cell layer are split into tiles of the given size "
+    "and each tile is written as a separate chunk. Readers can use these chunks to read a region of interest "
+    "only (see \\LoadLayoutOptions#lstream_region=). Files written this way can be read by all LStream readers. "
+    "A value of 0 (the default) disables tiling.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
+  gsi::method_ext ("lstream_tile_size", &get_lstream_tile_size,
+    "@brief Gets the tile size for the spatial index in micrometer units\n"
+    "See \\lstream_tile_size= for details about this property.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
   ),
   ""
 );
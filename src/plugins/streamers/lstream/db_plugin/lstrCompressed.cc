@@ -26,6 +26,8 @@
 #include "dbShapes.h"
 #include "dbHash.h"
 
+#include <memory>
+
 namespace lstr
 {
 
@@ -82,320 +84,379 @@ Compressed::write_shape (const db::Shape &shape, RegularArray &regular, std::vec
   }
 }
 
+/**
+ *  @brief A set of compressors for the different shape types
+ */
+struct Compressed::ShapeCompressors
+{
+  ShapeCompressors (unsigned int level)
+    : path (level), simple_polygon (level), polygon (level), edge (level), edge_pair (level), box (level), text (level), point (level),
+      path_with_properties (level), simple_polygon_with_properties (level), polygon_with_properties (level), edge_with_properties (level),
+      edge_pair_with_properties (level), box_with_properties (level), text_with_properties (level), point_with_properties (level)
+  { }
+
+  void flush (Compressed *target)
+  {
+    path.flush (target);
+    simple_polygon.flush (target);
+    polygon.flush (target);
+    edge.flush (target);
+    edge_pair.flush (target);
+    box.flush (target);
+    point.flush (target);
+    text.flush (target);
+
+    path_with_properties.flush (target);
+    simple_polygon_with_properties.flush (target);
+    polygon_with_properties.flush (target);
+    edge_with_properties.flush (target);
+    edge_pair_with_properties.flush (target);
+    box_with_properties.flush (target);
+    point_with_properties.flush (target);
+    text_with_properties.flush (target);
+  }
+
+  Compressor<db::Path> path;
+  Compressor<db::SimplePolygon> simple_polygon;
+  Compressor<db::Polygon> polygon;
+  Compressor<db::Edge> edge;
+  Compressor<db::EdgePair> edge_pair;
+  Compressor<db::Box> box;
+  Compressor<db::Text> text;
+  Compressor<db::Point> point;
+
+  Compressor<db::PathWithProperties> path_with_properties;
+  Compressor<db::SimplePolygonWithProperties> simple_polygon_with_properties;
+  Compressor<db::PolygonWithProperties> polygon_with_properties;
+  Compressor<db::EdgeWithProperties> edge_with_properties;
+  Compressor<db::EdgePairWithProperties> edge_pair_with_properties;
+  Compressor<db::BoxWithProperties> box_with_properties;
+  Compressor<db::TextWithProperties> text_with_properties;
+  Compressor<db::PointWithProperties> point_with_properties;
+};
+
 void 
 Compressed::compress_shapes (const db::Shapes &shapes, unsigned int level, bool recompress)
 {
-  RegularArray no_array;
-  std::vector<db::Vector> no_irregular_array;
-
-  Compressor<db::Path> path_compressor (level);
-  Compressor<db::SimplePolygon> simple_polygon_compressor (level);
-  Compressor<db::Polygon> polygon_compressor (level);
-  Compressor<db::Edge> edge_compressor (level);
-  Compressor<db::EdgePair> edge_pair_compressor (level);
-  Compressor<db::Box> box_compressor (level);
-  Compressor<db::Text> text_compressor (level);
-  Compressor<db::Point> point_compressor (level);
-
-  Compressor<db::PathWithProperties> path_with_properties_compressor (level);
-  Compressor<db::SimplePolygonWithProperties> simple_polygon_with_properties_compressor (level);
-  Compressor<db::PolygonWithProperties> polygon_with_properties_compressor (level);
-  Compressor<db::EdgeWithProperties> edge_with_properties_compressor (level);
-  Compressor<db::EdgePairWithProperties> edge_pair_with_properties_compressor (level);
-  Compressor<db::BoxWithProperties> box_with_properties_compressor (level);
-  Compressor<db::TextWithProperties> text_with_properties_compressor (level);
-  Compressor<db::PointWithProperties> point_with_properties_compressor (level);
+  ShapeCompressors compressors (level);
 
   for (db::ShapeIterator shape = shapes.begin (db::ShapeIterator::All); ! shape.at_end (); ) {
+    compress_shape (shape, level, recompress, compressors);
+  }
 
-    if (level <= 0 || (! recompress && shape.in_array ())) {
+  compressors.flush (this);
+}
 
-      RegularArray array;
-      std::vector<db::Vector> irregular_array;
+/**
+ *  @brief Gets the index of the tile containing the given coordinate
+ */
+static db::Coord
+tile_index (db::Coord c, db::Coord tile_size)
+{
+  return c >= 0 ? c / tile_size : -((-(c + 1)) / tile_size) - 1;
+}
 
-      bool transfer_array = (shape.in_array () && level > 0);
-      if (transfer_array) {
-        create_repetition (shape.array (), array, irregular_array);
-      }
+void 
+Compressed::compress_shapes_tiled (const db::Shapes &shapes, unsigned int level, bool recompress, db::Coord tile_size, std::map<std::pair<db::Coord, db::Coord>, Compressed> &tiles)
+{
+  tl_assert (tile_size > 0);
 
-      if (shape->is_simple_polygon ()) {
-        write_shape<db::SimplePolygon> (*shape, array, irregular_array);
-      } else if (shape->is_polygon ()) {
-        write_shape<db::Polygon> (*shape, array, irregular_array);
-      } else if (shape->is_path ()) {
-        write_shape<db::Path> (*shape, array, irregular_array);
-      } else if (shape->is_text ()) {
-        write_shape<db::Text> (*shape, array, irregular_array);
-      } else if (shape->is_edge ()) {
-        write_shape<db::Edge> (*shape, array, irregular_array);
-      } else if (shape->is_edge_pair ()) {
-        write_shape<db::EdgePair> (*shape, array, irregular_array);
-      } else if (shape->is_box ()) {
-        write_shape<db::Box> (*shape, array, irregular_array);
-      } else if (shape->is_point ()) {
-        write_shape<db::Point> (*shape, array, irregular_array);
-      } else if (shape->is_user_object ()) {
-        // ignore
-      } else {
-        tl_assert (false); // unknown shape type
-      }
+  std::map<std::pair<db::Coord, db::Coord>, std::unique_ptr<ShapeCompressors> > compressors;
 
-      if (transfer_array) {
-        shape.finish_array ();
-      }
+  for (db::ShapeIterator shape = shapes.begin (db::ShapeIterator::All); ! shape.at_end (); ) {
 
-    } else {
+    //  arrays which are kept as such are assigned as a whole
+    bool keep_array = (shape.in_array () && level > 0 && ! recompress);
+    db::Point center = (keep_array ? shape.array ().bbox () : shape->bbox ()).center ();
+    std::pair<db::Coord, db::Coord> tile (tile_index (center.x (), tile_size), tile_index (center.y (), tile_size));
 
-      switch (shape->type ()) {
-      case db::Shape::Polygon:
+    auto c = compressors.find (tile);
+    if (c == compressors.end ()) {
+      c = compressors.insert (std::make_pair (tile, std::unique_ptr<ShapeCompressors> (new ShapeCompressors (level)))).first;
+    }
 
-        if (shape->has_prop_id ()) {
-          auto polygon = *shape->basic_ptr (db::PolygonWithProperties::tag ());
-          polygon_with_properties_compressor.add (polygon);
-        } else {
-          auto polygon = *shape->basic_ptr (db::Polygon::tag ());
-          polygon_compressor.add (polygon);
-        }
+    tiles [tile].compress_shape (shape, level, recompress, *c->second);
 
-        break;
+  }
 
-      case db::Shape::PolygonRef:
+  for (auto c = compressors.begin (); c != compressors.end (); ++c) {
+    c->second->flush (&tiles [c->first]);
+  }
+}
 
-        if (shape->has_prop_id ()) {
-          auto polygon_ref = *shape->basic_ptr (db::object_with_properties<db::PolygonRef>::tag ());
-          db::PolygonWithProperties polygon (polygon_ref.obj (), polygon_ref.properties_id ());
-          polygon_with_properties_compressor.add (polygon, polygon_ref.trans ().disp ());
-        } else {
-          auto polygon_ref = *shape->basic_ptr (db::PolygonRef::tag ());
-          polygon_compressor.add (polygon_ref.obj (), polygon_ref.trans ().disp ());
-        }
+void
+Compressed::compress_shape (db::ShapeIterator &shape, unsigned int level, bool recompress, ShapeCompressors &compressors)
+{
+  if (level <= 0 || (! recompress && shape.in_array ())) {
 
-        break;
+    RegularArray array;
+    std::vector<db::Vector> irregular_array;
 
-      case db::Shape::PolygonPtrArrayMember:
+    bool transfer_array = (shape.in_array () && level > 0);
+    if (transfer_array) {
+      create_repetition (shape.array (), array, irregular_array);
+    }
 
-        if (shape->has_prop_id ()) {
-          auto polygon_ref = *shape->basic_ptr (db::object_with_properties<db::Shape::polygon_ptr_array_type>::tag ());
-          db::PolygonWithProperties polygon (polygon_ref.object ().obj (), polygon_ref.properties_id ());
-          polygon_with_properties_compressor.add (polygon, shape->array_trans ().disp ());
-        } else {
-          auto polygon_ref = *shape->basic_ptr (db::Shape::polygon_ptr_array_type::tag ());
-          polygon_compressor.add (polygon_ref.object ().obj (), shape->array_trans ().disp ());
-        }
+    if (shape->is_simple_polygon ()) {
+      write_shape<db::SimplePolygon> (*shape, array, irregular_array);
+    } else if (shape->is_polygon ()) {
+      write_shape<db::Polygon> (*shape, array, irregular_array);
+    } else if (shape->is_path ()) {
+      write_shape<db::Path> (*shape, array, irregular_array);
+    } else if (shape->is_text ()) {
+      write_shape<db::Text> (*shape, array, irregular_array);
+    } else if (shape->is_edge ()) {
+      write_shape<db::Edge> (*shape, array, irregular_array);
+    } else if (shape->is_edge_pair ()) {
+      write_shape<db::EdgePair> (*shape, array, irregular_array);
+    } else if (shape->is_box ()) {
+      write_shape<db::Box> (*shape, array, irregular_array);
+    } else if (shape->is_point ()) {
+      write_shape<db::Point> (*shape, array, irregular_array);
+    } else if (shape->is_user_object ()) {
+      // ignore
+    } else {
+      tl_assert (false); // unknown shape type
+    }
 
-        break;
+    if (transfer_array) {
+      shape.finish_array ();
+    } else {
+      ++shape;
+    }
 
-      case db::Shape::SimplePolygon:
+  } else {
 
-        if (shape->has_prop_id ()) {
-          auto simple_polygon = *shape->basic_ptr (db::SimplePolygonWithProperties::tag ());
-          simple_polygon_with_properties_compressor.add (simple_polygon);
-        } else {
-          auto simple_polygon = *shape->basic_ptr (db::SimplePolygon::tag ());
-          simple_polygon_compressor.add (simple_polygon);
-        }
+    switch (shape->type ()) {
+    case db::Shape::Polygon:
 
-        break;
+      if (shape->has_prop_id ()) {
+        auto polygon = *shape->basic_ptr (db::PolygonWithProperties::tag ());
+        compressors.polygon_with_properties.add (polygon);
+      } else {
+        auto polygon = *shape->basic_ptr (db::Polygon::tag ());
+        compressors.polygon.add (polygon);
+      }
 
-      case db::Shape::SimplePolygonRef:
+      break;
 
-        if (shape->has_prop_id ()) {
-          auto polygon_ref = *shape->basic_ptr (db::object_with_properties<db::SimplePolygonRef>::tag ());
-          db::SimplePolygonWithProperties polygon (polygon_ref.obj (), polygon_ref.properties_id ());
-          simple_polygon_with_properties_compressor.add (polygon, polygon_ref.trans ().disp ());
-        } else {
-          auto polygon_ref = *shape->basic_ptr (db::SimplePolygonRef::tag ());
-          simple_polygon_compressor.add (polygon_ref.obj (), polygon_ref.trans ().disp ());
-        }
+    case db::Shape::PolygonRef:
 
-        break;
+      if (shape->has_prop_id ()) {
+        auto polygon_ref = *shape->basic_ptr (db::object_with_properties<db::PolygonRef>::tag ());
+        db::PolygonWithProperties polygon (polygon_ref.obj (), polygon_ref.properties_id ());
+        compressors.polygon_with_properties.add (polygon, polygon_ref.trans ().disp ());
+      } else {
+        auto polygon_ref = *shape->basic_ptr (db::PolygonRef::tag ());
+        compressors.polygon.add (polygon_ref.obj (), polygon_ref.trans ().disp ());
+      }
 
-      case db::Shape::SimplePolygonPtrArrayMember:
-           
-        if (shape->has_prop_id ()) {
-          auto simple_polygon_ref = *shape->basic_ptr (db::object_with_properties<db::Shape::simple_polygon_ptr_array_type>::tag ());
-          db::SimplePolygonWithProperties simple_polygon (simple_polygon_ref.object ().obj (), simple_polygon_ref.properties_id ());
-          simple_polygon_with_properties_compressor.add (simple_polygon, shape->array_trans ().disp ());
-        } else {
-          auto simple_polygon_ref = *shape->basic_ptr (db::Shape::simple_polygon_ptr_array_type::tag ());
-          simple_polygon_compressor.add (simple_polygon_ref.object ().obj (), shape->array_trans ().disp ());
-        }
+      break;
 
-        break;
+    case db::Shape::PolygonPtrArrayMember:
 
-      case db::Shape::Edge:
+      if (shape->has_prop_id ()) {
+        auto polygon_ref = *shape->basic_ptr (db::object_with_properties<db::Shape::polygon_ptr_array_type>::tag ());
+        db::PolygonWithProperties polygon (polygon_ref.object ().obj (), polygon_ref.properties_id ());
+        compressors.polygon_with_properties.add (polygon, shape->array_trans ().disp ());
+      } else {
+        auto polygon_ref = *shape->basic_ptr (db::Shape::polygon_ptr_array_type::tag ());
+        compressors.polygon.add (polygon_ref.object ().obj (), shape->array_trans ().disp ());
+      }
 
-        if (shape->has_prop_id ()) {
-          auto edge = *shape->basic_ptr (db::EdgeWithProperties::tag ());
-          edge_with_properties_compressor.add (edge);
-        } else {
-          auto edge = *shape->basic_ptr (db::Edge::tag ());
-          edge_compressor.add (edge);
-        }
+      break;
 
-        break;
+    case db::Shape::SimplePolygon:
 
-      case db::Shape::EdgePair:
+      if (shape->has_prop_id ()) {
+        auto simple_polygon = *shape->basic_ptr (db::SimplePolygonWithProperties::tag ());
+        compressors.simple_polygon_with_properties.add (simple_polygon);
+      } else {
+        auto simple_polygon = *shape->basic_ptr (db::SimplePolygon::tag ());
+        compressors.simple_polygon.add (simple_polygon);
+      }
 
-        if (shape->has_prop_id ()) {
-          auto edge_pair = *shape->basic_ptr (db::EdgePairWithProperties::tag ());
-          edge_pair_with_properties_compressor.add (edge_pair);
-        } else {
-          auto edge_pair = *shape->basic_ptr (db::EdgePair::tag ());
-          edge_pair_compressor.add (edge_pair);
-        }
+      break;
 
-        break;
+    case db::Shape::SimplePolygonRef:
 
-      case db::Shape::Path:
+      if (shape->has_prop_id ()) {
+        auto polygon_ref = *shape->basic_ptr (db::object_with_properties<db::SimplePolygonRef>::tag ());
+        db::SimplePolygonWithProperties polygon (polygon_ref.obj (), polygon_ref.properties_id ());
+        compressors.simple_polygon_with_properties.add (polygon, polygon_ref.trans ().disp ());
+      } else {
+        auto polygon_ref = *shape->basic_ptr (db::SimplePolygonRef::tag ());
+        compressors.simple_polygon.add (polygon_ref.obj (), polygon_ref.trans ().disp ());
+      }
 
-        if (shape->has_prop_id ()) {
-          auto path = *shape->basic_ptr (db::PathWithProperties::tag ());
-          path_with_properties_compressor.add (path);
-        } else {
-          auto path = *shape->basic_ptr (db::Path::tag ());
-          path_compressor.add (path);
-        }
+      break;
 
-        break;
+    case db::Shape::SimplePolygonPtrArrayMember:
+         
+      if (shape->has_prop_id ()) {
+        auto simple_polygon_ref = *shape->basic_ptr (db::object_with_properties<db::Shape::simple_polygon_ptr_array_type>::tag ());
+        db::SimplePolygonWithProperties simple_polygon (simple_polygon_ref.object ().obj (), simple_polygon_ref.properties_id ());
+        compressors.simple_polygon_with_properties.add (simple_polygon, shape->array_trans ().disp ());
+      } else {
+        auto simple_polygon_ref = *shape->basic_ptr (db::Shape::simple_polygon_ptr_array_type::tag ());
+        compressors.simple_polygon.add (simple_polygon_ref.object ().obj (), shape->array_trans ().disp ());
+      }
 
-      case db::Shape::PathRef:
+      break;
 
-        if (shape->has_prop_id ()) {
-          auto path_ref = *shape->basic_ptr (db::object_with_properties<db::PathRef>::tag ());
-          db::PathWithProperties path (path_ref.obj (), path_ref.properties_id ());
-          path_with_properties_compressor.add (path, path_ref.trans ().disp ());
-        } else {
-          const db::PathRef &path_ref = *shape->basic_ptr (db::PathRef::tag ());
-          path_compressor.add (path_ref.obj (), path_ref.trans ().disp ());
-        }
+    case db::Shape::Edge:
 
-        break;
+      if (shape->has_prop_id ()) {
+        auto edge = *shape->basic_ptr (db::EdgeWithProperties::tag ());
+        compressors.edge_with_properties.add (edge);
+      } else {
+        auto edge = *shape->basic_ptr (db::Edge::tag ());
+        compressors.edge.add (edge);
+      }
 
-      case db::Shape::PathPtrArrayMember:
+      break;
 
-        if (shape->has_prop_id ()) {
-          auto path_ref = *shape->basic_ptr (db::object_with_properties<db::Shape::path_ptr_array_type>::tag ());
-          db::PathWithProperties path (path_ref.object ().obj (), path_ref.properties_id ());
-          path_with_properties_compressor.add (path, shape->array_trans ().disp ());
-        } else {
-          const db::Shape::path_ptr_array_type &path_ref = *shape->basic_ptr (db::Shape::path_ptr_array_type::tag ());
-          path_compressor.add (path_ref.object ().obj (), shape->array_trans ().disp ());
-        }
+    case db::Shape::EdgePair:
 
-        break;
+      if (shape->has_prop_id ()) {
+        auto edge_pair = *shape->basic_ptr (db::EdgePairWithProperties::tag ());
+        compressors.edge_pair_with_properties.add (edge_pair);
+      } else {
+        auto edge_pair = *shape->basic_ptr (db::EdgePair::tag ());
+        compressors.edge_pair.add (edge_pair);
+      }
 
-      case db::Shape::Box:
+      break;
 
-        if (shape->has_prop_id ()) {
-          auto box = *shape->basic_ptr (db::BoxWithProperties::tag ());
-          box_with_properties_compressor.add (box);
-        } else {
-          auto box = *shape->basic_ptr (db::Box::tag ());
-          box_compressor.add (box);
-        }
+    case db::Shape::Path:
 
-        break;
+      if (shape->has_prop_id ()) {
+        auto path = *shape->basic_ptr (db::PathWithProperties::tag ());
+        compressors.path_with_properties.add (path);
+      } else {
+        auto path = *shape->basic_ptr (db::Path::tag ());
+        compressors.path.add (path);
+      }
 
-      case db::Shape::Point:
+      break;
 
-        if (shape->has_prop_id ()) {
-          auto point = *shape->basic_ptr (db::PointWithProperties::tag ());
-          point_with_properties_compressor.add (point);
-        } else {
-          auto point = *shape->basic_ptr (db::Point::tag ());
-          point_compressor.add (point);
-        }
+    case db::Shape::PathRef:
 
-        break;
+      if (shape->has_prop_id ()) {
+        auto path_ref = *shape->basic_ptr (db::object_with_properties<db::PathRef>::tag ());
+        db::PathWithProperties path (path_ref.obj (), path_ref.properties_id ());
+        compressors.path_with_properties.add (path, path_ref.trans ().disp ());
+      } else {
+        const db::PathRef &path_ref = *shape->basic_ptr (db::PathRef::tag ());
+        compressors.path.add (path_ref.obj (), path_ref.trans ().disp ());
+      }
 
-      case db::Shape::BoxArray:
-      case db::Shape::BoxArrayMember:
-      case db::Shape::ShortBox:
-      case db::Shape::ShortBoxArrayMember:
+      break;
 
-        if (shape->has_prop_id ()) {
-          db::BoxWithProperties box;
-          shape->instantiate (box);
-          box.properties_id (shape->prop_id ());
-          box_with_properties_compressor.add (box);
-        } else {
-          db::Box box;
-          shape->instantiate (box);
-          box_compressor.add (box);
-        }
+    case db::Shape::PathPtrArrayMember:
 
-        break;
+      if (shape->has_prop_id ()) {
+        auto path_ref = *shape->basic_ptr (db::object_with_properties<db::Shape::path_ptr_array_type>::tag ());
+        db::PathWithProperties path (path_ref.object ().obj (), path_ref.properties_id ());
+        compressors.path_with_properties.add (path, shape->array_trans ().disp ());
+      } else {
+        const db::Shape::path_ptr_array_type &path_ref = *shape->basic_ptr (db::Shape::path_ptr_array_type::tag ());
+        compressors.path.add (path_ref.object ().obj (), shape->array_trans ().disp ());
+      }
 
-      case db::Shape::Text:
+      break;
 
-        if (shape->has_prop_id ()) {
-          auto text = *shape->basic_ptr (db::TextWithProperties::tag ());
-          text_with_properties_compressor.add (text);
-        } else {
-          auto text = *shape->basic_ptr (db::Text::tag ());
-          text_compressor.add (text);
-        }
+    case db::Shape::Box:
 
-        break;
+      if (shape->has_prop_id ()) {
+        auto box = *shape->basic_ptr (db::BoxWithProperties::tag ());
+        compressors.box_with_properties.add (box);
+      } else {
+        auto box = *shape->basic_ptr (db::Box::tag ());
+        compressors.box.add (box);
+      }
 
-      case db::Shape::TextRef:
+      break;
 
-        if (shape->has_prop_id ()) {
-          auto text_ref = *shape->basic_ptr (db::object_with_properties<db::TextRef>::tag ());
-          db::TextWithProperties text (text_ref.obj (), text_ref.properties_id ());
-          text_with_properties_compressor.add (text, text_ref.trans ().disp ());
-        } else {
-          auto text_ref = *shape->basic_ptr (db::TextRef::tag ());
-          text_compressor.add (text_ref.obj (), text_ref.trans ().disp ());
-        }
+    case db::Shape::Point:
 
-        break;
+      if (shape->has_prop_id ()) {
+        auto point = *shape->basic_ptr (db::PointWithProperties::tag ());
+        compressors.point_with_properties.add (point);
+      } else {
+        auto point = *shape->basic_ptr (db::Point::tag ());
+        compressors.point.add (point);
+      }
 
-      case db::Shape::TextPtrArrayMember:
+      break;
 
-        if (shape->has_prop_id ()) {
-          auto text_ref = *shape->basic_ptr (db::object_with_properties<db::Shape::text_ptr_array_type>::tag ());
-          db::TextWithProperties text (text_ref.object ().obj (), text_ref.properties_id ());
-          text_with_properties_compressor.add (text, shape->array_trans ().disp ());
-        } else {
-          auto text_ref = *shape->basic_ptr (db::Shape::text_ptr_array_type::tag ());
-          text_compressor.add (text_ref.object ().obj (), shape->array_trans ().disp ());
-        }
+    case db::Shape::BoxArray:
+    case db::Shape::BoxArrayMember:
+    case db::Shape::ShortBox:
+    case db::Shape::ShortBoxArrayMember:
+
+      if (shape->has_prop_id ()) {
+        db::BoxWithProperties box;
+        shape->instantiate (box);
+        box.properties_id (shape->prop_id ());
+        compressors.box_with_properties.add (box);
+      } else {
+        db::Box box;
+        shape->instantiate (box);
+        compressors.box.add (box);
+      }
 
-        break;
+      break;
 
-      case db::Shape::UserObject:
-        //  ignore.
-        break;
+    case db::Shape::Text:
 
-      default:
-        tl_assert (false);
+      if (shape->has_prop_id ()) {
+        auto text = *shape->basic_ptr (db::TextWithProperties::tag ());
+        compressors.text_with_properties.add (text);
+      } else {
+        auto text = *shape->basic_ptr (db::Text::tag ());
+        compressors.text.add (text);
       }
 
-      ++shape;
+      break;
 
+    case db::Shape::TextRef:
+
+      if (shape->has_prop_id ()) {
+        auto text_ref = *shape->basic_ptr (db::object_with_properties<db::TextRef>::tag ());
+        db::TextWithProperties text (text_ref.obj (), text_ref.properties_id ());
+        compressors.text_with_properties.add (text, text_ref.trans ().disp ());
+      } else {
+        auto text_ref = *shape->basic_ptr (db::TextRef::tag ());
+        compressors.text.add (text_ref.obj (), text_ref.trans ().disp ());
+      }
+
+      break;
+
+    case db::Shape::TextPtrArrayMember:
+
+      if (shape->has_prop_id ()) {
+        auto text_ref = *shape->basic_ptr (db::object_with_properties<db::Shape::text_ptr_array_type>::tag ());
+        db::TextWithProperties text (text_ref.object ().obj (), text_ref.properties_id ());
+        compressors.text_with_properties.add (text, shape->array_trans ().disp ());
+      } else {
+        auto text_ref = *shape->basic_ptr (db::Shape::text_ptr_array_type::tag ());
+        compressors.text.add (text_ref.object ().obj (), shape->array_trans ().disp ());
+      }
+
+      break;
+
+    case db::Shape::UserObject:
+      //  ignore.
+      break;
+
+    default:
+      tl_assert (false);
     }
 
-  }
+    ++shape;
 
-  path_compressor.flush (this);
-  simple_polygon_compressor.flush (this);
-  polygon_compressor.flush (this);
-  edge_compressor.flush (this);
-  edge_pair_compressor.flush (this);
-  box_compressor.flush (this);
-  point_compressor.flush (this);
-  text_compressor.flush (this);
-
-  path_with_properties_compressor.flush (this);
-  simple_polygon_with_properties_compressor.flush (this);
-  polygon_with_properties_compressor.flush (this);
-  edge_with_properties_compressor.flush (this);
-  edge_pair_with_properties_compressor.flush (this);
-  box_with_properties_compressor.flush (this);
-  point_with_properties_compressor.flush (this);
-  text_with_properties_compressor.flush (this);
+  }
 }
 
 template <class Array>
@@ -123,6 +123,21 @@ public:
    */
   void compress_shapes (const db::Shapes &shapes, unsigned int level, bool recompress);
 
+  /**
+   *  @brief Compresses a shape container into tiles
+   *
+   *  This method is similar to "compress_shapes", but distributes the shapes over a
+   *  grid of square tiles with the given size. A shape is assigned to the tile which
+   *  contains the center of its bounding box. Shape arrays which are not exploded are
+   *  assigned as a whole.
+   *
+   *  "tiles" receives one Compressed object per non-empty tile. The key is the
+   *  column and row index of the tile, so the tile covers the area from
+   *  "key * tile_size" (inclusive) to "(key + 1) * tile_size" (exclusive) in both
+   *  dimensions. Arrays are only formed within one tile.
+   */
+  static void compress_shapes_tiled (const db::Shapes &shapes, unsigned int level, bool recompress, db::Coord tile_size, std::map<std::pair<db::Coord, db::Coord>, Compressed> &tiles);
+
   /**
    *  @brief Compresses instances
    * 
@@ -267,6 +282,8 @@ private:
     }
   }
 
+  struct ShapeCompressors;
+
   size_t m_next_id;
   std::map<RegularArray, uint64_t> m_array_to_rep_id;
   std::map<std::vector<db::Vector>, uint64_t> m_irregular_to_rep_id;
@@ -275,6 +292,7 @@ private:
   db::Vector create_repetition (const db::Shape &array, RegularArray &regular, std::vector<db::Vector> &irregular_array);
   template <class Obj>
   void write_shape(const db::Shape &shape, RegularArray &regular, std::vector<db::Vector> &irregular_array);
+  void compress_shape (db::ShapeIterator &shape, unsigned int level, bool recompress, ShapeCompressors &compressors);
 };
 
 template <> inline Compressed::compressed_container<db::Point> &Compressed::get_container () { return m_points; }
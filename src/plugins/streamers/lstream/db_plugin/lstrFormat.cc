@@ -26,7 +26,7 @@ namespace lstr
 {
 
 WriterOptions::WriterOptions ()
-  : compression_level (2), recompress (false), permissive (false)
+  : compression_level (2), recompress (false), permissive (false), tile_size (0.0)
 {
   //  .. nothing yet ..
 }
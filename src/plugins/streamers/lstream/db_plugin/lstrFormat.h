@@ -26,6 +26,7 @@
 #include "dbPluginCommon.h"
 #include "dbLoadLayoutOptions.h"
 #include "dbSaveLayoutOptions.h"
+#include "dbBox.h"
 
 namespace lstr
 {
@@ -49,6 +50,17 @@ public:
    */
   std::string bbox_meta_info_key;
 
+  /**
+   *  @brief If not empty, only the shapes inside this region of interest are read (in micrometer units)
+   *
+   *  The region is given in the coordinates of the top cells. The shapes are read
+   *  in chunks as written by the writer (see WriterOptions::tile_size), so shapes
+   *  outside the region may be read as well. The cell hierarchy and the instances
+   *  are always read completely. This option requires a memory-mapped, uncompressed
+   *  file. Otherwise, the whole file is read.
+   */
+  db::DBox region;
+
   /**
    *  @brief Implementation of FormatSpecificReaderOptions
    */
@@ -108,6 +120,17 @@ public:
    */
   bool permissive;
 
+  /**
+   *  @brief Tile size for the spatial index (in micrometer units)
+   *
+   *  If this value is larger than zero, the shapes of a layer are split into
+   *  tiles of this size if they extend over more than one tile. Each tile is
+   *  written as a separate layer entry. Readers can use these entries as a
+   *  coarse spatial index to read a region of interest only.
+   *  A value of 0 (the default) disables the tiling.
+   */
+  double tile_size;
+
   /** 
    *  @brief Implementation of FormatSpecificWriterOptions
    */
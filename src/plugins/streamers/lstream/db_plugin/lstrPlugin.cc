@@ -118,7 +118,8 @@ class LStreamFormatDeclaration
     return new db::WriterOptionsXMLElement<lstr::WriterOptions> ("lstream",
       tl::make_member (&lstr::WriterOptions::compression_level, "compression-level") +
       tl::make_member (&lstr::WriterOptions::recompress, "recompress") +
-      tl::make_member (&lstr::WriterOptions::permissive, "permissive")
+      tl::make_member (&lstr::WriterOptions::permissive, "permissive") +
+      tl::make_member (&lstr::WriterOptions::tile_size, "tile-size")
     );
   }
 };
@@ -38,6 +38,7 @@
 #include "metaDataView.capnp.h"
 
 #include <capnp/serialize-packed.h>
+#include <kj/debug.h>
 
 namespace lstr
 {
@@ -348,13 +349,227 @@ make_regular_array (stream::repetition::Repetition::Reader repetition, db::regul
   array = db::regular_array<db::Coord> (a, b, na, nb);
 }
 
+/**
+ *  @brief Computes the bounding box of a stream::geometry::Contour
+ */
+static db::Box
+contour_box (stream::geometry::Contour::Reader reader)
+{
+  db::Point pt = make_point (reader.getP1 ());
+  db::Box box (pt, pt);
+
+  auto deltas = reader.getDeltas ();
+  for (auto d = deltas.begin (); d != deltas.end (); ++d) {
+    pt += make_vector (*d);
+    box += pt;
+  }
+
+  return box;
+}
+
+/**
+ *  @brief Computes the bounding box of an object array from the box of the basic object and the repetition
+ */
+static db::Box
+repetition_box (const db::Box &box, stream::repetition::Repetition::Reader repetition)
+{
+  if (box.empty ()) {
+    return box;
+  }
+
+  switch (repetition.getTypes ().which ()) {
+  case stream::repetition::Repetition::Types::ENUMERATED:
+    {
+      std::vector<db::Vector> vectors;
+      make_vectors (repetition, vectors);
+
+      db::Box array_box;
+      for (auto v = vectors.begin (); v != vectors.end (); ++v) {
+        array_box += box.moved (*v);
+      }
+      return array_box;
+    }
+
+  case stream::repetition::Repetition::Types::REGULAR:
+  case stream::repetition::Repetition::Types::REGULAR_ORTHO:
+    {
+      db::Vector a, b;
+      unsigned long na = 0, nb = 0;
+      get_regular_array (repetition, a, b, na, nb);
+
+      db::Coord fa = db::Coord (std::max ((unsigned long) 1, na) - 1);
+      db::Coord fb = db::Coord (std::max ((unsigned long) 1, nb) - 1);
+      db::Vector da (a.x () * fa, a.y () * fa);
+      db::Vector db (b.x () * fb, b.y () * fb);
+
+      db::Box array_box = box;
+      array_box += box.moved (da);
+      array_box += box.moved (db);
+      array_box += box.moved (da + db);
+      return array_box;
+    }
+
+  case stream::repetition::Repetition::Types::SINGLE:
+    return box;
+
+  default:
+    return db::Box ();
+  }
+}
+
+// ---------------------------------------------------------------
+//  MemoryBlockInputStream implementation
+
+MemoryBlockInputStream::MemoryBlockInputStream (lstr::InputStream &is, const char *data, size_t size)
+  : mp_is (&is), mp_data (data), m_size (size), m_pos (is.position ())
+{
+  //  .. nothing yet ..
+}
+
+kj::ArrayPtr<const kj::byte>
+MemoryBlockInputStream::tryGetReadBuffer ()
+{
+  return kj::arrayPtr ((const kj::byte *) mp_data + m_pos, m_size - m_pos);
+}
+
+size_t
+MemoryBlockInputStream::tryRead (void *buffer, size_t /*min_bytes*/, size_t max_bytes)
+{
+  size_t n = std::min (max_bytes, m_size - m_pos);
+  memcpy (buffer, mp_data + m_pos, n);
+  m_pos += n;
+  mp_is->advance (n);
+  return n;
+}
+
+void
+MemoryBlockInputStream::skip (size_t bytes)
+{
+  KJ_REQUIRE (bytes <= m_size - m_pos, "Premature end of stream") {
+    bytes = m_size - m_pos;
+    break;
+  }
+  m_pos += bytes;
+  mp_is->advance (bytes);
+}
+
+// ---------------------------------------------------------------
+//  LayoutViewLoader implementation
+
+/**
+ *  @brief Loads the shapes of LStream layout views on demand
+ *
+ *  This object is installed in the layout when the reader runs in lazy loading mode.
+ *  It keeps the file mapped into memory and holds the tables required to decode the
+ *  shapes. The shapes are decoded by a temporary reader which borrows these tables.
+ */
+class LayoutViewLoader
+  : public db::CellContentLoader
+{
+public:
+  LayoutViewLoader (Reader &reader, tl::InputStream *stream)
+    : mp_stream (stream)
+  {
+    m_layer_id_map.swap (reader.m_layer_id_map);
+    m_properties_id_map.swap (reader.m_properties_id_map);
+    m_text_strings_by_id.swap (reader.m_text_strings_by_id);
+    m_pending_views.swap (reader.m_pending_views);
+
+    //  keep the strings alive while we need them
+    for (auto t = m_text_strings_by_id.begin (); t != m_text_strings_by_id.end (); ++t) {
+      const_cast<db::StringRef *> (t->second)->add_ref ();
+    }
+  }
+
+  ~LayoutViewLoader ()
+  {
+    for (auto t = m_text_strings_by_id.begin (); t != m_text_strings_by_id.end (); ++t) {
+      const_cast<db::StringRef *> (t->second)->remove_ref ();
+    }
+  }
+
+  const std::map<db::cell_index_type, Reader::PendingLayoutView> &pending_views () const
+  {
+    return m_pending_views;
+  }
+
+  virtual void load_cell_content (db::Layout &layout, db::cell_index_type ci, shapes_map &shapes)
+  {
+    auto v = m_pending_views.find (ci);
+    if (v == m_pending_views.end ()) {
+      return;
+    }
+
+    Reader reader (*mp_stream);
+    reader.mp_layout = &layout;
+    reader.mp_staged_shapes = &shapes;
+
+    if (is_transient ()) {
+      //  in transient mode, the shapes are built in per-cell repositories, so they can be released
+      //  along with the shapes
+      CellRepositories &r = m_cell_repositories [ci];
+      r.shape_repository.reset (new db::GenericRepository ());
+      r.array_repository.reset (new db::ArrayRepository ());
+      reader.mp_scratch_shape_repository = r.shape_repository.get ();
+      reader.mp_scratch_array_repository = r.array_repository.get ();
+    }
+
+    //  lend the tables to the reader
+    reader.m_layer_id_map.swap (m_layer_id_map);
+    reader.m_properties_id_map.swap (m_properties_id_map);
+    reader.m_text_strings_by_id.swap (m_text_strings_by_id);
+
+    try {
+      reader.read_staged_layout_view (ci, v->second);
+    } catch (...) {
+      reader.m_layer_id_map.swap (m_layer_id_map);
+      reader.m_properties_id_map.swap (m_properties_id_map);
+      reader.m_text_strings_by_id.swap (m_text_strings_by_id);
+      throw;
+    }
+
+    reader.m_layer_id_map.swap (m_layer_id_map);
+    reader.m_properties_id_map.swap (m_properties_id_map);
+    reader.m_text_strings_by_id.swap (m_text_strings_by_id);
+  }
+
+  virtual void cell_bboxes (db::cell_index_type ci, box_map &bboxes) const
+  {
+    auto v = m_pending_views.find (ci);
+    if (v != m_pending_views.end ()) {
+      bboxes = v->second.bboxes;
+    }
+  }
+
+  virtual void release_cell_content (db::cell_index_type ci)
+  {
+    m_cell_repositories.erase (ci);
+  }
+
+private:
+  struct CellRepositories
+  {
+    std::unique_ptr<db::GenericRepository> shape_repository;
+    std::unique_ptr<db::ArrayRepository> array_repository;
+  };
+
+  std::unique_ptr<tl::InputStream> mp_stream;
+  std::map<uint64_t, unsigned int> m_layer_id_map;
+  std::map<uint64_t, db::properties_id_type> m_properties_id_map;
+  std::map<uint64_t, const db::StringRef *> m_text_strings_by_id;
+  std::map<db::cell_index_type, Reader::PendingLayoutView> m_pending_views;
+  std::map<db::cell_index_type, CellRepositories> m_cell_repositories;
+};
+
 // ---------------------------------------------------------------
 //  LStreamReader implementation
 
 Reader::Reader (tl::InputStream &s)
   : m_stream (&s), m_source (s.source ()),
     m_progress (tl::to_string (tr ("Reading LStream file"))),
-    m_library_index (0), mp_cell (0), mp_layout (0), m_layout_view_id (0)
+    m_library_index (0), mp_cell (0), mp_layout (0), m_layout_view_id (0),
+    m_lazy (false), mp_staged_shapes (0),
+    mp_scratch_shape_repository (0), mp_scratch_array_repository (0)
 {
   m_progress.set_format (tl::to_string (tr ("%.0f MB")));
   m_progress.set_unit (1024 * 1024);
@@ -372,6 +587,7 @@ Reader::init (const db::LoadLayoutOptions &options)
 
   lstr::ReaderOptions lstr_options = options.get_options<lstr::ReaderOptions> ();
   m_bbox_meta_data_key = lstr_options.bbox_meta_info_key;
+  m_region = lstr_options.region;
 }
 
 /**
@@ -449,8 +665,122 @@ Reader::do_read_internal (db::Layout &layout)
     error (tl::to_string (tr ("LStream format not recognized (missing magic bytes)")));
   }
   
-  kj::BufferedInputStreamWrapper kj_stream (m_stream);
+  size_t block_size = 0;
+  const char *block = m_stream.memory_block (block_size);
+
+  //  Lazy loading requires a memory-mapped file which the loader can map again. It is
+  //  not supported when reading into a layout which is not empty.
+  //  A region of interest is implemented by lazy loading too: the chunks to read are
+  //  selected once the cell hierarchy is known.
+  bool with_region = ! m_region.empty ();
+  std::unique_ptr<tl::InputStream> lazy_stream;
+  if ((lazy_loading () || with_region) && block && layout.begin () == layout.end () && ! layout.cell_content_loader ()) {
+    lazy_stream.reset (new tl::InputStream (m_stream.absolute_file_path ()));
+    size_t lazy_block_size = 0;
+    if (! lazy_stream->base ()->memory_block (lazy_block_size) || lazy_block_size != block_size) {
+      lazy_stream.reset (0);
+    }
+  }
+
+  m_lazy = (lazy_stream.get () != 0);
+  m_pending_views.clear ();
+
+  if (block && block_size >= m_stream.position ()) {
+    //  read directly from memory (e.g. memory-mapped files)
+    lstr::MemoryBlockInputStream kj_stream (m_stream, block, block_size);
+    read_messages (kj_stream);
+  } else {
+    kj::BufferedInputStreamWrapper kj_stream (m_stream);
+    read_messages (kj_stream);
+  }
+
+  if (m_lazy) {
+
+    if (with_region) {
+      apply_region ();
+    }
+
+    LayoutViewLoader *loader = new LayoutViewLoader (*this, lazy_stream.release ());
+    loader->set_source_path (m_stream.absolute_file_path ());
+    layout.set_cell_content_loader (loader);
+
+    for (auto v = loader->pending_views ().begin (); v != loader->pending_views ().end (); ++v) {
+      layout.cell (v->first).set_content_pending ();
+    }
 
+    if (! lazy_loading ()) {
+      //  lazy loading was only used to implement the region of interest
+      layout.load_pending_cells ();
+      layout.set_cell_content_loader (0);
+    }
+
+  }
+}
+
+/**
+ *  @brief Restricts the pending layout views to the region of interest
+ *
+ *  The region is propagated from the top cells down the hierarchy. Each cell
+ *  receives the bounding box of the region parts in its own coordinate system.
+ *  Only the chunks (layer entries) touching this box are read later and the
+ *  bounding boxes delivered by the loader are computed from these chunks only.
+ */
+void
+Reader::apply_region ()
+{
+  mp_layout->force_update ();
+
+  std::map<db::cell_index_type, db::Box> regions;
+
+  db::Box top_region = db::CplxTrans (mp_layout->dbu ()).inverted () * m_region;
+  for (auto c = mp_layout->begin_top_down (); c != mp_layout->end_top_cells (); ++c) {
+    regions [*c] = top_region;
+  }
+
+  for (auto c = mp_layout->begin_top_down (); c != mp_layout->end_top_down (); ++c) {
+
+    auto r = regions.find (*c);
+    if (r == regions.end () || r->second.empty ()) {
+      continue;
+    }
+
+    db::Box region = r->second;
+
+    for (auto i = mp_layout->cell (*c).begin (); ! i.at_end (); ++i) {
+      db::Box &child_region = regions [i->cell_index ()];
+      for (auto a = i->cell_inst ().begin (); ! a.at_end (); ++a) {
+        child_region += i->complex_trans (*a).inverted () * region;
+      }
+    }
+
+  }
+
+  for (auto v = m_pending_views.begin (); v != m_pending_views.end (); ) {
+
+    auto r = regions.find (v->first);
+    db::Box region = (r != regions.end () ? r->second : db::Box ());
+
+    v->second.region = region;
+    v->second.bboxes.clear ();
+    for (auto c = v->second.chunks.begin (); c != v->second.chunks.end (); ++c) {
+      if (c->second.touches (region)) {
+        v->second.bboxes [c->first] += c->second;
+      }
+    }
+
+    //  nothing to read in this cell
+    if (v->second.bboxes.empty ()) {
+      m_pending_views.erase (v++);
+    } else {
+      ++v;
+    }
+
+  }
+}
+
+void
+Reader::read_messages (kj::BufferedInputStream &kj_stream)
+{
   //  Reads the global header
   read_header (kj_stream);
 
@@ -944,7 +1274,7 @@ Reader::make_object (stream::geometry::SimplePolygon::Reader reader)
   db::SimplePolygon polygon;
   polygon.assign_hull (contour.begin (), contour.end (), false, false);
 
-  return db::SimplePolygonRef (polygon, mp_layout->shape_repository ());
+  return db::SimplePolygonRef (polygon, shape_repository ());
 }
 
 /**
@@ -969,7 +1299,7 @@ Reader::make_object (stream::geometry::Polygon::Reader reader)
     polygon.insert_hole (contour.begin (), contour.end (), false, false);
   }
 
-  return db::PolygonRef (polygon, mp_layout->shape_repository ());
+  return db::PolygonRef (polygon, shape_repository ());
 }
 
 /**
@@ -980,6 +1310,15 @@ Reader::make_object (stream::geometry::Polygon::Reader reader)
  */
 db::PathRef
 Reader::make_object (stream::geometry::Path::Reader reader)
+{
+  return db::PathRef (make_path (reader), shape_repository ());
+}
+
+/**
+ *  @brief Makes a db::Path from a stream::geometry::Path
+ */
+db::Path
+Reader::make_path (stream::geometry::Path::Reader reader)
 {
   std::vector<db::Point> contour;
   make_contour (contour, reader.getSpine ());
@@ -1000,7 +1339,7 @@ Reader::make_object (stream::geometry::Path::Reader reader)
     end_ext = cast_to_coord (reader.getEndExtension ());
   }
 
-  return db::PathRef (db::Path (contour.begin (), contour.end (), 2 * hw, bgn_ext, end_ext, round), mp_layout->shape_repository ());
+  return db::Path (contour.begin (), contour.end (), 2 * hw, bgn_ext, end_ext, round);
 }
 
 /**
@@ -1045,6 +1384,87 @@ Reader::make_object (stream::geometry::Label::Reader reader)
   return db::Text (string, db::Trans (orientation, pos), size, db::Font::DefaultFont, halign, valign);
 }
 
+/**
+ *  @brief "object_box" overloads: computes the bounding box of a stream::geometry::Box
+ *
+ *  The "object_box" methods deliver the bounding box of the object "make_object" would
+ *  create, but without creating the object.
+ */
+db::Box
+Reader::object_box (stream::geometry::Box::Reader reader)
+{
+  return make_object (reader);
+}
+
+/**
+ *  @brief "object_box" overloads: computes the bounding box of a stream::geometry::Edge
+ */
+db::Box
+Reader::object_box (stream::geometry::Edge::Reader reader)
+{
+  return make_object (reader).bbox ();
+}
+
+/**
+ *  @brief "object_box" overloads: computes the bounding box of a stream::geometry::EdgePair
+ */
+db::Box
+Reader::object_box (stream::geometry::EdgePair::Reader reader)
+{
+  return make_object (reader).bbox ();
+}
+
+/**
+ *  @brief "object_box" overloads: computes the bounding box of a stream::geometry::SimplePolygon
+ */
+db::Box
+Reader::object_box (stream::geometry::SimplePolygon::Reader reader)
+{
+  return contour_box (reader.getHull ());
+}
+
+/**
+ *  @brief "object_box" overloads: computes the bounding box of a stream::geometry::Polygon
+ *
+ *  Holes are inside the hull, hence they do not contribute.
+ */
+db::Box
+Reader::object_box (stream::geometry::Polygon::Reader reader)
+{
+  return contour_box (reader.getHull ());
+}
+
+/**
+ *  @brief "object_box" overloads: computes the bounding box of a stream::geometry::Path
+ */
+db::Box
+Reader::object_box (stream::geometry::Path::Reader reader)
+{
+  return make_path (reader).box ();
+}
+
+/**
+ *  @brief "object_box" overloads: computes the bounding box of a stream::geometry::Point
+ */
+db::Box
+Reader::object_box (stream::geometry::Point::Reader reader)
+{
+  db::Point p = make_point (reader);
+  return db::Box (p, p);
+}
+
+/**
+ *  @brief "object_box" overloads: computes the bounding box of a stream::geometry::Label
+ *
+ *  Like for db::Text, the bounding box is the position.
+ */
+db::Box
+Reader::object_box (stream::geometry::Label::Reader reader)
+{
+  db::Point p = make_point (reader.getPosition ());
+  return db::Box (p, p);
+}
+
 /**
  *  @brief Creates a single cell reference from the given cell index, property Id and transformation
  * 
@@ -1196,9 +1616,9 @@ Reader::make_object_array_ref (unsigned int li, db::properties_id_type prop_id,
       make_iterated_array (repetition, array);
 
       if (prop_id == 0) {
-        mp_cell->shapes (li).insert (array_type (object, db::UnitTrans (), mp_layout->array_repository ().insert (array)));
+        target_shapes (li).insert (array_type (object, db::UnitTrans (), array_repository ().insert (array)));
       } else {
-        mp_cell->shapes (li).insert (db::object_with_properties<array_type> (array_type (object, db::UnitTrans (), mp_layout->array_repository ().insert (array)), prop_id));
+        target_shapes (li).insert (db::object_with_properties<array_type> (array_type (object, db::UnitTrans (), array_repository ().insert (array)), prop_id));
       }
     }
     break;
@@ -1210,18 +1630,18 @@ Reader::make_object_array_ref (unsigned int li, db::properties_id_type prop_id,
       unsigned long na = 0, nb = 0;
       get_regular_array (repetition, a, b, na, nb);
 
-      db::array<Object, db::UnitTrans> array (object, db::UnitTrans (), mp_layout->array_repository (), a, b, na, nb);
+      db::array<Object, db::UnitTrans> array (object, db::UnitTrans (), array_repository (), a, b, na, nb);
 
       if (prop_id == 0) {
-        mp_cell->shapes (li).insert (array);
+        target_shapes (li).insert (array);
       } else {
-        mp_cell->shapes (li).insert (db::object_with_properties<db::array<Object, db::UnitTrans> > (array, prop_id));
+        target_shapes (li).insert (db::object_with_properties<db::array<Object, db::UnitTrans> > (array, prop_id));
       }
     }
     break;
 
   case stream::repetition::Repetition::Types::SINGLE:
-    mp_cell->shapes (li).insert (object);
+    target_shapes (li).insert (object);
     break;
 
   default:
@@ -1273,9 +1693,9 @@ Reader::make_object_array_ptr (unsigned int li, db::properties_id_type prop_id,
       ObjectPtr ptr (object.ptr (), db::UnitTrans ());
 
       if (prop_id == 0) {
-        mp_cell->shapes (li).insert (array_type (ptr, object.trans (), mp_layout->array_repository ().insert (array)));
+        target_shapes (li).insert (array_type (ptr, object.trans (), array_repository ().insert (array)));
       } else {
-        mp_cell->shapes (li).insert (db::object_with_properties<array_type> (array_type (ptr, object.trans (), mp_layout->array_repository ().insert (array)), prop_id));
+        target_shapes (li).insert (db::object_with_properties<array_type> (array_type (ptr, object.trans (), array_repository ().insert (array)), prop_id));
       }
     }
     break;
@@ -1288,18 +1708,18 @@ Reader::make_object_array_ptr (unsigned int li, db::properties_id_type prop_id,
       get_regular_array (repetition, a, b, na, nb);
 
       ObjectPtr ptr (object.ptr (), db::UnitTrans ());
-      db::array<ObjectPtr, db::Disp> array (ptr, object.trans (), mp_layout->array_repository (), a, b, na, nb);
+      db::array<ObjectPtr, db::Disp> array (ptr, object.trans (), array_repository (), a, b, na, nb);
 
       if (prop_id == 0) {
-        mp_cell->shapes (li).insert (array);
+        target_shapes (li).insert (array);
       } else {
-        mp_cell->shapes (li).insert (db::object_with_properties<db::array<ObjectPtr, db::Disp> > (array, prop_id));
+        target_shapes (li).insert (db::object_with_properties<db::array<ObjectPtr, db::Disp> > (array, prop_id));
       }
     }
     break;
 
   case stream::repetition::Repetition::Types::SINGLE:
-    mp_cell->shapes (li).insert (object);
+    target_shapes (li).insert (object);
     break;
 
   default:
@@ -1337,9 +1757,9 @@ Reader::make_object_array_explode (unsigned int li, db::properties_id_type prop_
         moved_object.transform (db::Disp (*v));
 
         if (prop_id == 0) {
-          mp_cell->shapes (li).insert (moved_object);
+          target_shapes (li).insert (moved_object);
         } else {
-          mp_cell->shapes (li).insert (db::object_with_properties<Object> (moved_object, prop_id));
+          target_shapes (li).insert (db::object_with_properties<Object> (moved_object, prop_id));
         }
 
       }
@@ -1366,9 +1786,9 @@ Reader::make_object_array_explode (unsigned int li, db::properties_id_type prop_
           moved_object.transform (db::Disp (da + db));
 
           if (prop_id == 0) {
-            mp_cell->shapes (li).insert (moved_object);
+            target_shapes (li).insert (moved_object);
           } else {
-            mp_cell->shapes (li).insert (db::object_with_properties<Object> (moved_object, prop_id));
+            target_shapes (li).insert (db::object_with_properties<Object> (moved_object, prop_id));
           }
 
         }
@@ -1380,9 +1800,9 @@ Reader::make_object_array_explode (unsigned int li, db::properties_id_type prop_
 
   case stream::repetition::Repetition::Types::SINGLE:
     if (prop_id == 0) {
-      mp_cell->shapes (li).insert (object);
+      target_shapes (li).insert (object);
     } else {
-      mp_cell->shapes (li).insert (db::object_with_properties<Object> (object, prop_id));
+      target_shapes (li).insert (db::object_with_properties<Object> (object, prop_id));
     }
     break;
 
@@ -1546,19 +1966,19 @@ Reader::read_shapes (unsigned int li, typename stream::layoutView::ObjectContain
   auto arrays_with_properties = reader.getArraysWithProperties ();
 
   for (auto i = basic.begin (); i != basic.end (); ++i) {
-    mp_cell->shapes (li).insert (make_object (i->getBasic ()));
+    target_shapes (li).insert (make_object (i->getBasic ()));
   }
 
   for (auto i = with_properties.begin (); i != with_properties.end (); ++i) {
     auto prop_id = get_properties_id_by_id (i->getPropertySetId ());
-    mp_cell->shapes (li).insert (db::object_with_properties<Object> (make_object (i->getBasic ()), prop_id));
+    target_shapes (li).insert (db::object_with_properties<Object> (make_object (i->getBasic ()), prop_id));
   }
 
   for (auto i = arrays.begin (); i != arrays.end (); ++i) {
     auto object = make_object (i->getBasic ());
     auto rep = i->getRepetitionId ();
     if (rep == 0) {
-      mp_cell->shapes (li).insert (object);
+      target_shapes (li).insert (object);
     } else {
       --rep;
       tl_assert (rep < repetitions.size ());
@@ -1571,7 +1991,7 @@ Reader::read_shapes (unsigned int li, typename stream::layoutView::ObjectContain
     auto prop_id = get_properties_id_by_id (i->getPropertySetId ());
     auto rep = i->getBasic ().getRepetitionId ();
     if (rep == 0) {
-      mp_cell->shapes (li).insert (db::object_with_properties<Object> (object, prop_id));
+      target_shapes (li).insert (db::object_with_properties<Object> (object, prop_id));
     } else {
       --rep;
       tl_assert (rep < repetitions.size ());
@@ -1603,6 +2023,114 @@ Reader::read_layer (stream::layoutView::Layer::Reader reader)
   read_shapes<db::PathRef, stream::geometry::Path> (li, reader.getPaths (), repetitions);
 }
 
+/**
+ *  @brief Computes the bounding box of the shapes of a given kind without reading them
+ *
+ *  This method is the counterpart of "read_shapes" for lazy loading.
+ */
+template <class CPObject>
+db::Box
+Reader::shapes_box (typename stream::layoutView::ObjectContainerForType<CPObject>::Reader reader, capnp::List<stream::repetition::Repetition, capnp::Kind::STRUCT>::Reader repetitions)
+{
+  db::Box box;
+
+  auto basic = reader.getBasic ();
+  auto with_properties = reader.getWithProperties ();
+  auto arrays = reader.getArrays ();
+  auto arrays_with_properties = reader.getArraysWithProperties ();
+
+  for (auto i = basic.begin (); i != basic.end (); ++i) {
+    box += object_box (i->getBasic ());
+  }
+
+  for (auto i = with_properties.begin (); i != with_properties.end (); ++i) {
+    box += object_box (i->getBasic ());
+  }
+
+  for (auto i = arrays.begin (); i != arrays.end (); ++i) {
+    auto rep = i->getRepetitionId ();
+    if (rep == 0) {
+      box += object_box (i->getBasic ());
+    } else {
+      --rep;
+      tl_assert (rep < repetitions.size ());
+      box += repetition_box (object_box (i->getBasic ()), repetitions [rep]);
+    }
+  }
+
+  for (auto i = arrays_with_properties.begin (); i != arrays_with_properties.end (); ++i) {
+    auto rep = i->getBasic ().getRepetitionId ();
+    if (rep == 0) {
+      box += object_box (i->getBasic ().getBasic ());
+    } else {
+      --rep;
+      tl_assert (rep < repetitions.size ());
+      box += repetition_box (object_box (i->getBasic ().getBasic ()), repetitions [rep]);
+    }
+  }
+
+  return box;
+}
+
+/**
+ *  @brief Computes the bounding box of the shapes of the given stream::layoutView::Layer
+ *
+ *  This method is the counterpart of "read_layer" for lazy loading.
+ */
+db::Box
+Reader::layer_box (stream::layoutView::Layer::Reader reader)
+{
+  auto repetitions = reader.getRepetitions ();
+
+  db::Box box;
+  box += shapes_box<stream::geometry::Box> (reader.getBoxes (), repetitions);
+  box += shapes_box<stream::geometry::Edge> (reader.getEdges (), repetitions);
+  box += shapes_box<stream::geometry::EdgePair> (reader.getEdgePairs (), repetitions);
+  box += shapes_box<stream::geometry::SimplePolygon> (reader.getSimplePolygons (), repetitions);
+  box += shapes_box<stream::geometry::Polygon> (reader.getPolygons (), repetitions);
+  box += shapes_box<stream::geometry::Point> (reader.getPoints (), repetitions);
+  box += shapes_box<stream::geometry::Label> (reader.getLabels (), repetitions);
+  box += shapes_box<stream::geometry::Path> (reader.getPaths (), repetitions);
+  return box;
+}
+
+/**
+ *  @brief Gets the shapes container where to put the shapes for the given layer
+ *
+ *  This is the current cell's container unless the shapes are loaded on demand.
+ *  In that case, the shapes go into the staging containers.
+ */
+db::Shapes &
+Reader::target_shapes (unsigned int li)
+{
+  if (mp_staged_shapes) {
+    return db::CellContentLoader::shapes_for_layer (*mp_layout, *mp_staged_shapes, li);
+  } else {
+    return mp_cell->shapes (li);
+  }
+}
+
+/**
+ *  @brief Gets the repository for the shapes
+ *
+ *  This is the layout's repository unless the loader provides a separate one
+ *  for transient cell content.
+ */
+db::GenericRepository &
+Reader::shape_repository ()
+{
+  return mp_scratch_shape_repository ? *mp_scratch_shape_repository : mp_layout->shape_repository ();
+}
+
+/**
+ *  @brief Gets the repository for the shape arrays
+ */
+db::ArrayRepository &
+Reader::array_repository ()
+{
+  return mp_scratch_array_repository ? *mp_scratch_array_repository : mp_layout->array_repository ();
+}
+
 /**
  *  @brief Processes the layout view message
  * 
@@ -1621,6 +2149,7 @@ Reader::read_layout_view (db::cell_index_type cell_index, kj::BufferedInputStrea
   options.traversalLimitInWords = std::numeric_limits<uint64_t>::max ();
 
   yield_progress ();
+  size_t position = m_stream.position ();
   capnp::PackedMessageReader message (is, options);
   stream::layoutView::LayoutView::Reader layout_view = message.getRoot<stream::layoutView::LayoutView> ();
 
@@ -1642,11 +2171,84 @@ Reader::read_layout_view (db::cell_index_type cell_index, kj::BufferedInputStrea
   read_instances (layout_view);
 
   auto layers = layout_view.getLayers ();
-  for (auto l = layers.begin (); l != layers.end (); ++l) {
-    read_layer (*l);
+
+  if (m_lazy) {
+
+    //  Don't read the shapes now - just remember where to find them later.
+    //  The loader needs the bounding boxes per layer until the shapes are read.
+    if (layers.size () > 0) {
+      PendingLayoutView &pending = m_pending_views [cell_index];
+      pending.position = position;
+      for (auto l = layers.begin (); l != layers.end (); ++l) {
+        unsigned int li = get_layer_by_id (l->getLayerId ());
+        db::Box box = layer_box (*l);
+        pending.bboxes [li] += box;
+        pending.chunks.push_back (std::make_pair (li, box));
+      }
+    }
+
+  } else {
+
+    for (auto l = layers.begin (); l != layers.end (); ++l) {
+      read_layer (*l);
+    }
+
+  }
+
+  mp_cell = 0;
+}
+
+/**
+ *  @brief Reads the shapes of a layout view into the staging containers
+ *
+ *  This method is used by the loader in lazy loading mode. "view" tells where
+ *  to find the layout view message in the file and which chunks to read.
+ */
+void
+Reader::read_staged_layout_view (db::cell_index_type cell_index, const PendingLayoutView &view)
+{
+  m_cellname = mp_layout->cell_name (cell_index);
+  mp_cell = &mp_layout->cell (cell_index);
+
+  try {
+    read_staged_layout_view_internal (view);
+  } catch (lstr::CoordinateOverflowException &ex) {
+    //  this adds source information
+    error (ex.msg ());
+  } catch (kj::Exception &ex) {
+    //  this adds source information
+    error (ex.getDescription ().cStr ());
   }
 
   mp_cell = 0;
+  m_cellname.clear ();
+}
+
+//  read_staged_layout_view delegate, unprotected
+void
+Reader::read_staged_layout_view_internal (const PendingLayoutView &view)
+{
+  size_t block_size = 0;
+  const char *block = m_stream.memory_block (block_size);
+  tl_assert (block != 0 && view.position < block_size);
+
+  m_stream.seek (view.position);
+  lstr::MemoryBlockInputStream kj_stream (m_stream, block, block_size);
+
+  capnp::ReaderOptions options;
+  options.traversalLimitInWords = std::numeric_limits<uint64_t>::max ();
+
+  capnp::PackedMessageReader message (kj_stream, options);
+  stream::layoutView::LayoutView::Reader layout_view = message.getRoot<stream::layoutView::LayoutView> ();
+
+  auto layers = layout_view.getLayers ();
+  for (auto l = layers.begin (); l != layers.end (); ++l) {
+    //  skip the chunks outside the region of interest
+    size_t index = l - layers.begin ();
+    if (view.region == db::Box::world () || (index < view.chunks.size () && view.chunks [index].second.touches (view.region))) {
+      read_layer (*l);
+    }
+  }
 }
 
 /**
@@ -91,6 +91,26 @@ public:
     m_pos_before = m_pos = 0;
   }
 
+  /**
+   *  @brief Sets the position of the stream
+   *
+   *  This method only updates the position information. It is intended for use
+   *  with MemoryBlockInputStream which takes the data from the memory block
+   *  starting at the current position.
+   */
+  void seek (size_t pos)
+  {
+    m_pos_before = m_pos = pos;
+  }
+
+  /**
+   *  @brief Gets the absolute path of the basic stream
+   */
+  std::string absolute_file_path () const
+  {
+    return mp_is->absolute_file_path ();
+  }
+
   /**
    *  @brief Gets the position in the stream after the current chunk
    */
@@ -107,11 +127,57 @@ public:
     return m_pos_before;
   }
 
+  /**
+   *  @brief Gets the content of the basic stream as a memory block if available
+   *
+   *  This is the case for memory-mapped files. Returns 0 if no such block is available.
+   */
+  const char *memory_block (size_t &size) const
+  {
+    return mp_is->base () ? mp_is->base ()->memory_block (size) : 0;
+  }
+
+  /**
+   *  @brief Advances the position by the given number of bytes
+   *
+   *  This method is used by MemoryBlockInputStream to maintain the position information.
+   */
+  void advance (size_t n)
+  {
+    m_pos_before = m_pos;
+    m_pos += n;
+  }
+
 private:
   tl::InputStream *mp_is;
   size_t m_pos, m_pos_before;
 };
 
+/**
+ *  @brief A kj::BufferedInputStream delivering the data directly from a memory block
+ *
+ *  This stream is used instead of kj::BufferedInputStreamWrapper if the basic stream
+ *  provides its content as a memory block (e.g. memory-mapped files). In that
+ *  case, Cap'n'Proto can read the messages without copying the data into a buffer
+ *  first. The stream starts at the current position of the given InputStream
+ *  and keeps the position of that stream updated.
+ */
+class MemoryBlockInputStream
+  : public kj::BufferedInputStream
+{
+public:
+  MemoryBlockInputStream (lstr::InputStream &is, const char *data, size_t size);
+
+  virtual kj::ArrayPtr<const kj::byte> tryGetReadBuffer ();
+  virtual size_t tryRead (void *buffer, size_t min_bytes, size_t max_bytes);
+  virtual void skip (size_t bytes);
+
+private:
+  lstr::InputStream *mp_is;
+  const char *mp_data;
+  size_t m_size, m_pos;
+};
+
 /**
  *  @brief Generic base class of LStream reader exceptions
  */
@@ -128,6 +194,8 @@ public:
   { }
 };
 
+class LayoutViewLoader;
+
 /**
  *  @brief The LStream format stream reader
  */
@@ -188,9 +256,27 @@ protected:
   const std::string &cellname () const { return m_cellname; }
 
 private:
+  friend class LayoutViewLoader;
+
+  /**
+   *  @brief Describes a layout view whose shapes are loaded on demand
+   */
+  struct PendingLayoutView
+  {
+    PendingLayoutView () : position (0), region (db::Box::world ()) { }
+
+    size_t position;
+    db::CellContentLoader::box_map bboxes;
+    //  the layer index and bounding box per layer entry (chunk) of the layout view
+    std::vector<std::pair<unsigned int, db::Box> > chunks;
+    //  only the chunks touching this box are read
+    db::Box region;
+  };
+
   lstr::InputStream m_stream;
   std::string m_source;
   std::string m_bbox_meta_data_key;
+  db::DBox m_region;
   tl::AbsoluteProgress m_progress;
   size_t m_library_index;
   std::string m_cellname;
@@ -205,10 +291,16 @@ private:
   uint64_t m_layout_view_id;
   uint64_t m_meta_data_view_id;
   std::vector<std::pair<db::cell_index_type, std::string> > m_cells;
+  bool m_lazy;
+  std::map<db::cell_index_type, PendingLayoutView> m_pending_views;
+  db::CellContentLoader::shapes_map *mp_staged_shapes;
+  db::GenericRepository *mp_scratch_shape_repository;
+  db::ArrayRepository *mp_scratch_array_repository;
 
   void yield_progress ();
   std::string position ();
   void do_read_internal (db::Layout &layout);
+  void read_messages (kj::BufferedInputStream &is);
   void read_header (kj::BufferedInputStream &is);
   void read_library (kj::BufferedInputStream &is);
   void skip_library (kj::BufferedInputStream &is);
@@ -220,6 +312,15 @@ private:
   void read_shapes (unsigned int li, typename stream::layoutView::ObjectContainerForType<CPObject>::Reader reader, capnp::List<stream::repetition::Repetition, capnp::Kind::STRUCT>::Reader repetitions);
   void read_layer (stream::layoutView::Layer::Reader reader);
   void read_layout_view (db::cell_index_type cell_index, kj::BufferedInputStream &is);
+  void read_staged_layout_view (db::cell_index_type cell_index, const PendingLayoutView &view);
+  void read_staged_layout_view_internal (const PendingLayoutView &view);
+  void apply_region ();
+  db::Shapes &target_shapes (unsigned int li);
+  db::GenericRepository &shape_repository ();
+  db::ArrayRepository &array_repository ();
+  template <class CPObject>
+  db::Box shapes_box (typename stream::layoutView::ObjectContainerForType<CPObject>::Reader reader, capnp::List<stream::repetition::Repetition, capnp::Kind::STRUCT>::Reader repetitions);
+  db::Box layer_box (stream::layoutView::Layer::Reader reader);
   void read_meta_data_view (db::cell_index_type cell_index, kj::BufferedInputStream &is);
   void read_layers (stream::library::ViewSpec::Reader view_specs);
   tl::Variant make_variant (stream::variant::Variant::Value::Reader variant);
@@ -243,6 +344,15 @@ private:
   db::PolygonRef make_object (stream::geometry::Polygon::Reader reader);
   db::PathRef make_object (stream::geometry::Path::Reader reader);
   db::Text make_object (stream::geometry::Label::Reader reader);
+  db::Path make_path (stream::geometry::Path::Reader reader);
+  db::Box object_box (stream::geometry::Box::Reader reader);
+  db::Box object_box (stream::geometry::Edge::Reader reader);
+  db::Box object_box (stream::geometry::EdgePair::Reader reader);
+  db::Box object_box (stream::geometry::SimplePolygon::Reader reader);
+  db::Box object_box (stream::geometry::Polygon::Reader reader);
+  db::Box object_box (stream::geometry::Path::Reader reader);
+  db::Box object_box (stream::geometry::Point::Reader reader);
+  db::Box object_box (stream::geometry::Label::Reader reader);
   void make_object_array (unsigned int li, db::properties_id_type prop_id, const db::PolygonRef &object, stream::repetition::Repetition::Reader repetition);
   void make_object_array (unsigned int li, db::properties_id_type prop_id, const db::SimplePolygonRef &object, stream::repetition::Repetition::Reader repetition);
   void make_object_array (unsigned int li, db::properties_id_type prop_id, const db::PathRef &object, stream::repetition::Repetition::Reader repetition);
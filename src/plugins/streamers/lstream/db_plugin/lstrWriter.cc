@@ -39,6 +39,8 @@
 #include <capnp/message.h>
 #include <kj/io.h>
 
+#include <list>
+
 //  Enable to replicate the messages into separate files for dumping
 //  and inspection with "capnp decode".
 //  Env var: $KLAYOUT_LSTREAM_REPLICATE_MESSAGES
@@ -78,6 +80,7 @@ Writer::Writer ()
   m_recompress = true;
   m_compression_level = 2;
   m_permissive = true;
+  m_tile_size = 0;
 }
 
 void 
@@ -90,6 +93,7 @@ Writer::write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayou
   m_permissive = lstr_options.permissive;
   m_compression_level = lstr_options.compression_level;
   m_recompress = lstr_options.recompress;
+  m_tile_size = lstr_options.tile_size > 0.0 ? db::coord_traits<db::Coord>::rounded (lstr_options.tile_size / layout.dbu ()) : 0;
 
   double dbu = (options.dbu () == 0.0) ? layout.dbu () : options.dbu ();
   double sf = options.scale_factor () * (layout.dbu () / dbu);
@@ -970,15 +974,40 @@ Writer::write_layout_view (db::cell_index_type ci, kj::BufferedOutputStream &os)
     }
   }
 
-  layout_view.initLayers (layers_for_cell.size ());
+  //  compresses the shapes per layer - if a tile size is given, large layers are split into
+  //  tiles which are written as separate layer entries. This forms a coarse spatial index
+  //  which allows readers to skip the parts outside a region of interest.
+  std::list<std::map<std::pair<db::Coord, db::Coord>, Compressed> > compressed_layers;
+  std::vector<std::pair<size_t, Compressed *> > chunks;
 
   for (auto l = layers_for_cell.begin (); l != layers_for_cell.end (); ++l) {
 
-    auto layer = layout_view.getLayers () [l - layers_for_cell.begin ()];
-    layer.setLayerId (l->second);
+    const db::Shapes &shapes = cell.shapes (l->first);
 
-    Compressed compressed;
-    compressed.compress_shapes (cell.shapes (l->first), m_compression_level, m_recompress); 
+    compressed_layers.push_back (std::map<std::pair<db::Coord, db::Coord>, Compressed> ());
+    std::map<std::pair<db::Coord, db::Coord>, Compressed> &tiles = compressed_layers.back ();
+
+    db::Box box = shapes.bbox ();
+    if (m_tile_size > 0 && (box.width () > db::Box::distance_type (m_tile_size) || box.height () > db::Box::distance_type (m_tile_size))) {
+      Compressed::compress_shapes_tiled (shapes, m_compression_level, m_recompress, m_tile_size, tiles);
+    } else {
+      tiles [std::make_pair (0, 0)].compress_shapes (shapes, m_compression_level, m_recompress);
+    }
+
+    for (auto t = tiles.begin (); t != tiles.end (); ++t) {
+      chunks.push_back (std::make_pair (l->second, &t->second));
+    }
+
+  }
+
+  layout_view.initLayers (chunks.size ());
+
+  for (auto c = chunks.begin (); c != chunks.end (); ++c) {
+
+    auto layer = layout_view.getLayers () [c - chunks.begin ()];
+    layer.setLayerId (c->first);
+
+    Compressed &compressed = *c->second;
 
     layer.initRepetitions (compressed.num_arrays ());
     for (auto r = compressed.begin_regular_arrays (); r != compressed.end_regular_arrays (); ++r) {
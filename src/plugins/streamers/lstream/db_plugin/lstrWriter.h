@@ -76,6 +76,7 @@ private:
   bool m_recompress;
   int m_compression_level;
   bool m_permissive;
+  db::Coord m_tile_size;
   db::Layout *mp_layout;
   std::string m_cellname;
   int m_layout_view_id;
@@ -21,6 +21,7 @@
 */
 
 #include "lstrReader.h"
+#include "lstrFormat.h"
 #include "dbLayoutDiff.h"
 #include "dbWriter.h"
 #include "dbTestSupport.h"
@@ -51,6 +52,64 @@ static void run_test (tl::TestBase *_this, const std::string &base, const char *
   db::compare_layouts (_this, layout, fn_au, db::WriteOAS);
 }
 
+static void run_lazy_test (tl::TestBase *_this, const std::string &base, const char *file, const char *file_au)
+{
+  std::string fn (base);
+  fn += "/lstream/";
+  fn += file;
+
+  db::Layout ref_layout;
+
+  {
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (ref_layout);
+  }
+
+  db::LoadLayoutOptions options;
+  options.get_options<db::CommonReaderOptions> ().lazy_loading = true;
+
+  db::Manager m (false);
+  db::Layout layout (&m);
+
+  {
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (layout, options);
+  }
+
+  //  bounding boxes are available before the shapes are loaded
+  layout.update ();
+  ref_layout.update ();
+
+  EXPECT_EQ (layout.cells (), ref_layout.cells ());
+  EXPECT_EQ (layout.layers (), ref_layout.layers ());
+
+  size_t pending = 0;
+  for (auto c = layout.begin (); c != layout.end (); ++c) {
+    if (c->is_content_pending ()) {
+      ++pending;
+    }
+    const db::Cell &ref_cell = ref_layout.cell (c->cell_index ());
+    EXPECT_EQ (c->bbox ().to_string (), ref_cell.bbox ().to_string ());
+    for (unsigned int l = 0; l < ref_layout.layers (); ++l) {
+      EXPECT_EQ (c->bbox (l).to_string (), ref_cell.bbox (l).to_string ());
+    }
+  }
+
+  EXPECT_NE (pending, size_t (0));
+
+  std::string fn_au (base);
+  fn_au += "/lstream/";
+  fn_au += file_au;
+
+  db::compare_layouts (_this, layout, fn_au, db::WriteOAS);
+
+  for (auto c = layout.begin (); c != layout.end (); ++c) {
+    EXPECT_EQ (c->is_content_pending (), false);
+  }
+}
+
 TEST(basic)
 {
   run_test (_this, tl::testdata (), "basic.lstr", "basic_au.oas");
@@ -151,3 +210,119 @@ TEST(reload_layer_props)
   EXPECT_EQ (layout.get_properties (l1).to_string (), "ONE (1/0)");
   EXPECT_EQ (layout.get_properties (l2).to_string (), "B (2/0)");
 }
+
+TEST(lazy_boxes)
+{
+  run_lazy_test (_this, tl::testdata (), "boxes.lstr", "boxes_au.oas");
+}
+
+TEST(lazy_cells_with_instances)
+{
+  run_lazy_test (_this, tl::testdata (), "cells_with_instances.lstr", "cells_with_instances_au.oas");
+}
+
+TEST(lazy_edges)
+{
+  run_lazy_test (_this, tl::testdata (), "edges.lstr", "edges_au.oas");
+}
+
+TEST(lazy_paths)
+{
+  run_lazy_test (_this, tl::testdata (), "paths.lstr", "paths_au.oas");
+}
+
+TEST(lazy_polygons)
+{
+  run_lazy_test (_this, tl::testdata (), "polygons.lstr", "polygons_au.oas");
+}
+
+TEST(lazy_properties)
+{
+  run_lazy_test (_this, tl::testdata (), "properties.lstr", "properties_au.oas");
+}
+
+TEST(lazy_texts)
+{
+  run_lazy_test (_this, tl::testdata (), "texts.lstr", "texts_au.oas");
+}
+
+static size_t count_shapes (const db::Shapes &shapes)
+{
+  size_t n = 0;
+  for (db::ShapeIterator s = shapes.begin (db::ShapeIterator::All); ! s.at_end (); ++s) {
+    ++n;
+  }
+  return n;
+}
+
+TEST(region_of_interest)
+{
+  db::Layout layout_org;
+
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+  db::Cell &a = layout_org.cell (layout_org.add_cell ("A"));
+
+  for (int i = 0; i < 100; ++i) {
+    a.shapes (l1).insert (db::Box (i * 1000, 0, i * 1000 + 500, 500));
+    top.shapes (l1).insert (db::Box (i * 1000, 20000, i * 1000 + 500, 20500));
+  }
+
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans ()));
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (0, 10000))));
+
+  std::string tmp_file = _this->tmp_file ("tmp_roi.lstr");
+
+  {
+    tl::OutputStream stream (tmp_file);
+    db::SaveLayoutOptions options;
+    options.set_format ("LStream");
+    options.get_options<lstr::WriterOptions> ().tile_size = 10.0;
+    db::Writer writer (options);
+    writer.write (layout_org, stream);
+  }
+
+  //  a full read delivers everything
+  {
+    db::Layout layout;
+    tl::InputStream stream (tmp_file);
+    db::Reader reader (stream);
+    reader.read (layout);
+    EXPECT_EQ (db::compare_layouts (layout_org, layout, db::layout_diff::f_verbose, 0), true);
+  }
+
+  for (int lazy = 0; lazy < 2; ++lazy) {
+
+    db::Layout layout;
+
+    db::LoadLayoutOptions options;
+    options.get_options<lstr::ReaderOptions> ().region = db::DBox (0, 0, 5, 25);
+    options.get_options<db::CommonReaderOptions> ().lazy_loading = (lazy != 0);
+
+    {
+      tl::InputStream stream (tmp_file);
+      db::Reader reader (stream);
+      reader.read (layout, options);
+    }
+
+    EXPECT_EQ (layout.cell_content_loader () != 0, lazy != 0);
+
+    std::pair<bool, db::cell_index_type> ctop = layout.cell_by_name ("TOP");
+    std::pair<bool, db::cell_index_type> ca = layout.cell_by_name ("A");
+    tl_assert (ctop.first && ca.first);
+
+    unsigned int lr = 0;
+    for (auto l = layout.begin_layers (); l != layout.end_layers (); ++l) {
+      if ((*l).second->log_equal (db::LayerProperties (1, 0))) {
+        lr = (*l).first;
+      }
+    }
+
+    //  only the first tile of each row is read
+    EXPECT_EQ (layout.cell (ca.second).bbox ().to_string (), "(0,0;9500,500)");
+    EXPECT_EQ (layout.cell (ctop.second).bbox ().to_string (), "(0,0;9500,20500)");
+    EXPECT_EQ (count_shapes (layout.cell (ca.second).shapes (lr)), size_t (10));
+    EXPECT_EQ (count_shapes (layout.cell (ctop.second).shapes (lr)), size_t (10));
+
+  }
+}
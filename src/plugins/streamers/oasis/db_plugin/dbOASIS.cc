@@ -477,7 +477,9 @@ public:
       tl::make_member (&db::OASISWriterOptions::strict_mode, "strict-mode") +
       tl::make_member (&db::OASISWriterOptions::write_std_properties, "write-std-properties") +
       tl::make_member (&db::OASISWriterOptions::subst_char, "subst-char") +
-      tl::make_member (&db::OASISWriterOptions::permissive, "permissive")
+      tl::make_member (&db::OASISWriterOptions::permissive, "permissive") +
+      tl::make_member (&db::OASISWriterOptions::threads, "threads") +
+      tl::make_member (&db::OASISWriterOptions::tables_at_end, "tables-at-end")
     );
   }
 };
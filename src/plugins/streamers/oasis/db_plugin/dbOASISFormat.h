@@ -43,7 +43,7 @@ public:
    *  @brief The constructor
    */
   OASISReaderOptions ()
-    : read_all_properties (false), expect_strict_mode (-1)
+    : read_all_properties (false), expect_strict_mode (-1), threads (0)
   {
     //  .. nothing yet ..
   }
@@ -70,6 +70,17 @@ public:
    */
   int expect_strict_mode;
 
+  /**
+   *  @brief The number of threads to use for inflating CBLOCKs
+   *
+   *  If this value is larger than zero, CBLOCKs are decompressed in the
+   *  given number of background threads. The reader looks ahead for
+   *  subsequent CBLOCKs so decompression runs in parallel to the decoding
+   *  of the records. The result is identical to the single-threaded mode.
+   *  A value of 0 (the default) disables background decompression.
+   */
+  int threads;
+
   /**
    *  @brief Implementation of FormatSpecificReaderOptions
    */
@@ -102,7 +113,7 @@ public:
    */
   OASISWriterOptions ()
     : compression_level (2), write_cblocks (true), strict_mode (true), recompress (false), permissive (false),
-      write_std_properties (1), subst_char ("*"), tables_at_end (false)
+      write_std_properties (1), subst_char ("*"), tables_at_end (false), threads (0)
   {
     //  .. nothing yet ..
   }
@@ -168,10 +179,24 @@ public:
   std::string subst_char;
 
   /**
-   *  @brief Hidden option, for testing mainly: write tables at end to force forward references
+   *  @brief Write the name tables at the end of the file
+   *
+   *  This will produce forward references. In exchange, the writer does not need
+   *  to scan the shapes of all cells before writing them. This is useful for
+   *  streaming conversions where the shapes are loaded on demand.
    */
   bool tables_at_end;
 
+  /**
+   *  @brief The number of threads to use for writing cells
+   *
+   *  If this value is larger than zero, the cell bodies are serialized and
+   *  CBLOCK-compressed in the given number of threads. The cells are
+   *  written to the file in the same order as in single-threaded mode and the
+   *  output is identical. A value of 0 (the default) disables threaded writing.
+   */
+  int threads;
+
   /** 
    *  @brief Implementation of FormatSpecificWriterOptions
    */
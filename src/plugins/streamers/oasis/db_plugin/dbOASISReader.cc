@@ -32,10 +32,457 @@
 #include "tlException.h"
 #include "tlString.h"
 #include "tlClassRegistry.h"
+#include "tlThreadedWorkers.h"
+#include "tlDeflate.h"
 
 namespace db
 {
 
+// ---------------------------------------------------------------
+//  OASISCBlockPrefetcher definition and implementation
+
+/**
+ *  @brief Holds a CBLOCK that is inflated in the background
+ */
+struct OASISInflatedCBlock
+{
+  OASISInflatedCBlock (size_t _uncompressed_size)
+    : uncompressed_size (_uncompressed_size), finished (false)
+  { }
+
+  size_t uncompressed_size;
+  std::vector<char> raw;
+  std::vector<char> data;
+  std::string error;
+  bool finished;
+};
+
+/**
+ *  @brief The task for inflating one CBLOCK
+ */
+class OASISCBlockInflateTask
+  : public tl::Task
+{
+public:
+  OASISCBlockInflateTask (OASISInflatedCBlock *block)
+    : mp_block (block)
+  { }
+
+  OASISInflatedCBlock *block () const
+  {
+    return mp_block;
+  }
+
+private:
+  OASISInflatedCBlock *mp_block;
+};
+
+/**
+ *  @brief The worker inflating CBLOCKs
+ */
+class OASISCBlockInflateWorker
+  : public tl::Worker
+{
+public:
+  OASISCBlockInflateWorker (OASISCBlockPrefetcher *prefetcher)
+    : tl::Worker (), mp_prefetcher (prefetcher)
+  { }
+
+  virtual void perform_task (tl::Task *task);
+
+private:
+  OASISCBlockPrefetcher *mp_prefetcher;
+};
+
+/**
+ *  @brief A job that inflates CBLOCKs ahead of the reader
+ *
+ *  The prefetcher looks ahead in the stream for CBLOCK records. It can
+ *  skip PAD, XYABSOLUTE, XYRELATIVE and CELL records which are commonly
+ *  found between CBLOCKs. The compressed data of the CBLOCKs found is
+ *  sent to the workers for decompression. When the reader arrives at
+ *  the CBLOCK, it picks the decompressed data from the prefetcher.
+ *  The blocks are identified by the stream position of the compressed data.
+ */
+class OASISCBlockPrefetcher
+  : public tl::JobBase
+{
+public:
+  OASISCBlockPrefetcher (int nworkers)
+    : tl::JobBase (nworkers), m_scan_end (0)
+  {
+    m_max_pending = std::max (size_t (2), size_t (nworkers) * 4);
+  }
+
+  ~OASISCBlockPrefetcher ()
+  {
+    //  stop the workers before the blocks are deleted
+    terminate ();
+
+    for (auto b = m_blocks.begin (); b != m_blocks.end (); ++b) {
+      delete b->second;
+    }
+    m_blocks.clear ();
+  }
+
+  /**
+   *  @brief Returns true, if the block with the given position is already scheduled
+   */
+  bool has_block (size_t pos) const
+  {
+    return m_blocks.find (pos) != m_blocks.end ();
+  }
+
+  /**
+   *  @brief Schedules the given compressed data for being inflated
+   */
+  void submit (size_t pos, size_t uncompressed_size, const char *raw, size_t n)
+  {
+    OASISInflatedCBlock *block = new OASISInflatedCBlock (uncompressed_size);
+    block->raw.assign (raw, raw + n);
+    m_blocks.insert (std::make_pair (pos, block));
+
+    schedule (new OASISCBlockInflateTask (block));
+    if (! is_running ()) {
+      start ();
+    }
+  }
+
+  /**
+   *  @brief Scans the stream for further CBLOCKs and submits them for inflating
+   *
+   *  This method will leave the stream at the current position.
+   */
+  void scan (tl::InputStream &stream);
+
+  /**
+   *  @brief Waits for the block with the given position and takes the inflated data
+   *
+   *  Returns false if an error occurred. In that case, "error" receives the error message.
+   */
+  bool fetch (size_t pos, std::vector<char> &data, std::string &error)
+  {
+    auto b = m_blocks.find (pos);
+    tl_assert (b != m_blocks.end ());
+
+    OASISInflatedCBlock *block = b->second;
+    m_blocks.erase (b);
+
+    m_lock.lock ();
+    while (! block->finished) {
+      m_finished_condition.wait (&m_lock);
+    }
+    m_lock.unlock ();
+
+    data.swap (block->data);
+    error = block->error;
+    delete block;
+
+    return error.empty ();
+  }
+
+  /**
+   *  @brief Called by the workers to indicate that a block is finished
+   */
+  void finish (OASISInflatedCBlock *block)
+  {
+    m_lock.lock ();
+    block->finished = true;
+    m_finished_condition.wakeAll ();
+    m_lock.unlock ();
+  }
+
+protected:
+  virtual tl::Worker *create_worker ()
+  {
+    return new OASISCBlockInflateWorker (this);
+  }
+
+private:
+  std::map<size_t, OASISInflatedCBlock *> m_blocks;
+  size_t m_scan_end;
+  size_t m_max_pending;
+  tl::Mutex m_lock;
+  tl::WaitCondition m_finished_condition;
+};
+
+/**
+ *  @brief Decodes an OASIS unsigned integer from memory
+ *
+ *  Returns false if the buffer does not hold the full number.
+ */
+static bool
+peek_uint (const unsigned char *&p, const unsigned char *pe, uint64_t &v)
+{
+  v = 0;
+  unsigned int sh = 0;
+  while (p < pe) {
+    unsigned char c = *p++;
+    if (sh < 64) {
+      v |= uint64_t (c & 0x7f) << sh;
+    }
+    sh += 7;
+    if ((c & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+OASISCBlockPrefetcher::scan (tl::InputStream &stream)
+{
+  //  The look-ahead window starts with this size and is grown up to the maximum size.
+  //  Peeking into streams which are not random-access (e.g. compressed files, pipes or HTTP
+  //  streams) makes the stream buffer grow to the window size, so the window is kept small
+  //  for those.
+  const size_t initial_window = 1024 * 1024;
+  const size_t max_window = stream.is_random_access () ? 64 * 1024 * 1024 : 4 * 1024 * 1024;
+
+  if (m_blocks.size () >= m_max_pending) {
+    return;
+  }
+
+  size_t pos = stream.pos ();
+
+  //  continue where the previous scan stopped if possible
+  size_t start = m_scan_end > pos ? m_scan_end - pos : 0;
+  size_t window = start + initial_window;
+
+  while (m_blocks.size () < m_max_pending) {
+
+    //  peek into the stream
+    size_t n = window;
+    const char *b = stream.get (n);
+    if (! b) {
+      n = stream.blen ();
+      b = n > 0 ? stream.get (n) : 0;
+      if (! b) {
+        return;
+      }
+    }
+
+    const unsigned char *p0 = (const unsigned char *) b;
+    const unsigned char *pe = p0 + n;
+    const unsigned char *p = p0 + start;
+
+    bool incomplete = false;
+
+    while (p < pe && m_blocks.size () < m_max_pending) {
+
+      const unsigned char *pr = p;
+      unsigned char r = *p++;
+      uint64_t v = 0;
+
+      if (r == 0 /*PAD*/ || r == 15 /*XYABSOLUTE*/ || r == 16 /*XYRELATIVE*/) {
+
+        //  no payload
+
+      } else if (r == 13 /*CELL*/) {
+
+        if (! peek_uint (p, pe, v)) {
+          incomplete = true;
+        }
+
+      } else if (r == 14 /*CELL*/) {
+
+        if (! peek_uint (p, pe, v) || v > uint64_t (pe - p)) {
+          incomplete = true;
+        } else {
+          p += v;
+        }
+
+      } else if (r == 34 /*CBLOCK*/) {
+
+        uint64_t type = 0, uncomp = 0, comp = 0;
+        if (! peek_uint (p, pe, type) || ! peek_uint (p, pe, uncomp) || ! peek_uint (p, pe, comp) || comp > uint64_t (pe - p)) {
+          incomplete = true;
+        } else if (type != 0) {
+          //  leave the error to the reader
+          pe = pr;
+          break;
+        } else {
+          size_t data_pos = pos + (p - p0);
+          if (! has_block (data_pos)) {
+            submit (data_pos, size_t (uncomp), (const char *) p, size_t (comp));
+          }
+          p += comp;
+        }
+
+      } else {
+
+        //  can't skip other records: stop here
+        pe = pr;
+        break;
+
+      }
+
+      if (incomplete) {
+        p = pr;
+        break;
+      }
+
+      start = p - p0;
+      m_scan_end = pos + start;
+
+    }
+
+    stream.unget (n);
+
+    //  try again with a larger window if the last record was not complete
+    if (! incomplete || n < window || window >= max_window) {
+      break;
+    }
+
+    window *= 2;
+
+  }
+}
+
+void
+OASISCBlockInflateWorker::perform_task (tl::Task *task)
+{
+  OASISCBlockInflateTask *inflate_task = dynamic_cast<OASISCBlockInflateTask *> (task);
+  if (! inflate_task) {
+    return;
+  }
+
+  OASISInflatedCBlock *block = inflate_task->block ();
+
+  try {
+
+    tl::InputMemoryStream raw_stream (block->raw.empty () ? 0 : block->raw.data (), block->raw.size ());
+    tl::InputStream stream (raw_stream);
+    tl::InflateFilter inflate (stream);
+
+    //  NOTE: the uncompressed size is taken as a hint only
+    block->data.reserve (std::min (block->uncompressed_size, block->raw.size () * 32 + 1024));
+
+    while (! inflate.at_end ()) {
+      block->data.push_back (*inflate.get (1));
+    }
+
+  } catch (tl::Exception &ex) {
+    block->error = ex.msg ();
+  } catch (std::exception &ex) {
+    block->error = ex.what ();
+  } catch (...) {
+    block->error = tl::to_string (tr ("Unspecific error while decompressing CBLOCK"));
+  }
+
+  std::vector<char> ().swap (block->raw);
+
+  mp_prefetcher->finish (block);
+}
+
+// ---------------------------------------------------------------
+//  OASISCellContentLoader definition and implementation
+
+/**
+ *  @brief Loads the shapes of OASIS cells on demand
+ *
+ *  This object is installed in the layout when the reader runs in lazy loading mode.
+ *  It keeps the file mapped into memory and holds the name tables required to decode
+ *  the shapes. The shapes are decoded by a temporary reader which borrows these tables.
+ */
+class OASISCellContentLoader
+  : public db::CellContentLoader
+{
+public:
+  OASISCellContentLoader (OASISReader &reader, tl::InputStream *stream)
+    : mp_stream (stream),
+      m_read_texts (reader.m_read_texts),
+      m_read_properties (reader.m_read_properties),
+      m_read_all_properties (reader.m_read_all_properties),
+      m_layer_cache (reader.layer_cache ())
+  {
+    m_textstrings.swap (reader.m_textstrings);
+    m_propstrings.swap (reader.m_propstrings);
+    m_propnames.swap (reader.m_propnames);
+    m_pending_cells.swap (reader.m_pending_cells);
+  }
+
+  const std::map<db::cell_index_type, OASISReader::PendingCell> &pending_cells () const
+  {
+    return m_pending_cells;
+  }
+
+  virtual void load_cell_content (db::Layout &layout, db::cell_index_type ci, shapes_map &shapes)
+  {
+    auto c = m_pending_cells.find (ci);
+    if (c == m_pending_cells.end ()) {
+      return;
+    }
+
+    OASISReader reader (*mp_stream);
+    reader.m_read_texts = m_read_texts;
+    reader.m_read_properties = m_read_properties;
+    reader.m_read_all_properties = m_read_all_properties;
+    reader.mp_staged_shapes = &shapes;
+
+    if (is_transient ()) {
+      //  in transient mode, the shapes are built in per-cell repositories, so they can be released
+      //  along with the shapes
+      CellRepositories &r = m_cell_repositories [ci];
+      r.shape_repository.reset (new db::GenericRepository ());
+      r.array_repository.reset (new db::ArrayRepository ());
+      reader.mp_scratch_shape_repository = r.shape_repository.get ();
+      reader.mp_scratch_array_repository = r.array_repository.get ();
+    }
+
+    //  lend the tables to the reader
+    swap_tables (reader);
+
+    try {
+      reader.read_staged_cell (ci, layout, c->second.position);
+    } catch (...) {
+      swap_tables (reader);
+      throw;
+    }
+
+    swap_tables (reader);
+  }
+
+  virtual void cell_bboxes (db::cell_index_type ci, box_map &bboxes) const
+  {
+    auto c = m_pending_cells.find (ci);
+    if (c != m_pending_cells.end ()) {
+      bboxes = c->second.bboxes;
+    }
+  }
+
+  virtual void release_cell_content (db::cell_index_type ci)
+  {
+    m_cell_repositories.erase (ci);
+  }
+
+private:
+  struct CellRepositories
+  {
+    std::unique_ptr<db::GenericRepository> shape_repository;
+    std::unique_ptr<db::ArrayRepository> array_repository;
+  };
+
+  std::unique_ptr<tl::InputStream> mp_stream;
+  bool m_read_texts;
+  bool m_read_properties;
+  bool m_read_all_properties;
+  std::map<db::LDPair, std::pair <bool, unsigned int> > m_layer_cache;
+  std::map <uint64_t, std::string> m_textstrings;
+  std::map <uint64_t, std::string> m_propstrings;
+  std::map <uint64_t, std::string> m_propnames;
+  std::map<db::cell_index_type, OASISReader::PendingCell> m_pending_cells;
+  std::map<db::cell_index_type, CellRepositories> m_cell_repositories;
+
+  void swap_tables (OASISReader &reader)
+  {
+    reader.layer_cache ().swap (m_layer_cache);
+    reader.m_textstrings.swap (m_textstrings);
+    reader.m_propstrings.swap (m_propstrings);
+    reader.m_propnames.swap (m_propnames);
+  }
+};
+
 // ---------------------------------------------------------------
 //  OASISReader
 
@@ -72,8 +519,14 @@ OASISReader::OASISReader (tl::InputStream &s)
     m_read_texts (true),
     m_read_properties (true),
     m_read_all_properties (false),
+    m_threads (0),
     m_s_gds_property_name_id (0),
-    m_klayout_context_property_name_id (0)
+    m_klayout_context_property_name_id (0),
+    m_lazy (false),
+    m_loading_content (false),
+    mp_staged_shapes (0),
+    mp_scratch_shape_repository (0),
+    mp_scratch_array_repository (0)
 {
   m_progress.set_format (tl::to_string (tr ("%.0f MB")));
   m_progress.set_unit (1024 * 1024);
@@ -108,6 +561,7 @@ OASISReader::init (const db::LoadLayoutOptions &options)
   db::OASISReaderOptions oasis_options = options.get_options<db::OASISReaderOptions> ();
   m_read_all_properties = oasis_options.read_all_properties;
   m_expect_strict_mode = oasis_options.expect_strict_mode;
+  m_threads = oasis_options.threads;
 }
 
 inline int64_t
@@ -529,6 +983,52 @@ OASISReader::mark_start_table ()
   m_table_start = m_stream.pos ();
 }
 
+void
+OASISReader::read_cblock ()
+{
+  //  CBLOCKs larger than this are always inflated by the reader itself
+  const uint64_t max_prefetch_size = 64 * 1024 * 1024;
+
+  uint32_t type = get_uint32 ();
+  if (type != 0) {
+    error (tl::sprintf (tl::to_string (tr ("Invalid CBLOCK compression type %d")), type));
+  }
+
+  uint64_t uncomp_bytes = 0;
+  uint64_t comp_bytes = 0;
+  get (uncomp_bytes);
+  get (comp_bytes);
+
+  size_t pos = m_stream.pos ();
+
+  if (! mp_cblock_prefetcher.get () || (comp_bytes > max_prefetch_size && ! mp_cblock_prefetcher->has_block (pos))) {
+    //  put the stream into deflating mode
+    m_stream.inflate ();
+    return;
+  }
+
+  //  consume the compressed data - the prefetcher will deliver the inflated data
+  const char *raw = m_stream.get (comp_bytes);
+  if (! raw) {
+    error (tl::to_string (tr ("Unexpected end-of-file")));
+  }
+
+  if (! mp_cblock_prefetcher->has_block (pos)) {
+    mp_cblock_prefetcher->submit (pos, uncomp_bytes, raw, comp_bytes);
+  }
+
+  //  look for more CBLOCKs while the current one is being inflated
+  mp_cblock_prefetcher->scan (m_stream);
+
+  std::vector<char> data;
+  std::string error_msg;
+  if (! mp_cblock_prefetcher->fetch (pos, data, error_msg)) {
+    error (error_msg);
+  }
+
+  m_stream.put_inflated (data);
+}
+
 void
 OASISReader::read_offset_table ()
 {
@@ -594,8 +1094,25 @@ OASISReader::do_read (db::Layout &layout)
 
   //  prepare
   m_s_gds_property_name_id = db::property_names_id (s_gds_property_propname);
+
+  mp_cblock_prefetcher.reset (m_threads > 0 ? new OASISCBlockPrefetcher (m_threads) : 0);
   m_klayout_context_property_name_id = db::property_names_id (klayout_context_propname);
 
+  //  Lazy loading requires a memory-mapped file which the loader can map again. It is
+  //  not supported when reading into a layout which is not empty.
+  std::unique_ptr<tl::InputStream> lazy_stream;
+  if (lazy_loading () && m_stream.is_random_access () && layout.begin () == layout.end () && ! layout.cell_content_loader ()) {
+    lazy_stream.reset (new tl::InputStream (m_stream.absolute_file_path ()));
+    size_t block_size = 0, lazy_block_size = 0;
+    m_stream.base ()->memory_block (block_size);
+    if (! lazy_stream->is_random_access () || ! lazy_stream->base ()->memory_block (lazy_block_size) || lazy_block_size != block_size) {
+      lazy_stream.reset (0);
+    }
+  }
+
+  m_lazy = (lazy_stream.get () != 0);
+  m_pending_cells.clear ();
+
   //  read magic bytes
   mb = (char *) m_stream.get (sizeof (magic_bytes) - 1);
   if (! mb) {
@@ -996,21 +1513,16 @@ OASISReader::do_read (db::Layout &layout)
       reset_modal_variables ();
       mark_start_table ();
 
-      do_read_cell (cell_index, layout);
-
-    } else if (r == 34 /*CBLOCK*/) {
-
-      uint32_t type = get_uint32 ();
-      if (type != 0) {
-        error (tl::sprintf (tl::to_string (tr ("Invalid CBLOCK compression type %d")), type));
+      //  NOTE: cells starting inside a CBLOCK can't be positioned to and are read immediately
+      if (m_lazy && ! m_stream.is_inflating ()) {
+        scan_cell (cell_index, layout);
+      } else {
+        do_read_cell (cell_index, layout);
       }
 
-      uint64_t dummy = 0;
-      get (dummy);  // uncomp-byte-count - not needed
-      get (dummy);  // comp-byte-count - not needed
+    } else if (r == 34 /*CBLOCK*/) {
 
-      //  put the stream into deflating mode
-      m_stream.inflate ();
+      read_cblock ();
 
     } else {
       error (tl::sprintf (tl::to_string (tr ("Invalid record type on global level %d")), int (r)));
@@ -1036,6 +1548,9 @@ OASISReader::do_read (db::Layout &layout)
     error (tl::to_string (tr ("Format error (too many bytes after END record)")));
   }
 
+  //  no more CBLOCKs to expect
+  mp_cblock_prefetcher.reset (0);
+
   for (std::map <uint64_t, const db::StringRef *>::const_iterator fw = m_text_forward_references.begin (); fw != m_text_forward_references.end (); ++fw) {
     auto ts = m_textstrings.find (fw->first);
     if (ts == m_textstrings.end ()) {
@@ -1045,6 +1560,13 @@ OASISReader::do_read (db::Layout &layout)
     }
   }
 
+  if (m_lazy) {
+    for (std::map <uint64_t, const db::StringRef *>::const_iterator fw = m_text_forward_references.begin (); fw != m_text_forward_references.end (); ++fw) {
+      const_cast<db::StringRef *> (fw->second)->remove_ref ();
+    }
+    m_text_forward_references.clear ();
+  }
+
   //  all forward references to property names must be resolved
   for (std::map <uint64_t, db::property_names_id_type>::const_iterator fw = m_propname_forward_references.begin (); fw != m_propname_forward_references.end (); ++fw) {
     if (fw->second == 0) {
@@ -1175,6 +1697,25 @@ OASISReader::do_read (db::Layout &layout)
 
   }
 
+  //  install the loader for the cells whose shapes are delivered on demand
+  if (m_lazy) {
+
+    m_lazy = false;
+
+    if (! m_pending_cells.empty ()) {
+
+      OASISCellContentLoader *loader = new OASISCellContentLoader (*this, lazy_stream.release ());
+      loader->set_source_path (m_stream.absolute_file_path ());
+      layout.set_cell_content_loader (loader);
+
+      for (auto c = loader->pending_cells ().begin (); c != loader->pending_cells ().end (); ++c) {
+        layout.cell (c->first).set_content_pending ();
+      }
+
+    }
+
+  }
+
   //  Restore layout meta info
   if (! context_strings.empty ()) {
     LayoutOrCellContextInfo info = make_context_info (context_strings);
@@ -1266,6 +1807,11 @@ OASISReader::forward_properties (properties_id_type id) const
 void
 OASISReader::register_forward_property_for_shape (const db::Shape &shape)
 {
+  //  staged shapes are discarded after scanning a lazy cell - they are loaded again later
+  if (mp_staged_shapes) {
+    return;
+  }
+
   m_forward_properties_for_shapes [shape.prop_id ()].insert (shape.shapes ());
 }
 
@@ -1480,17 +2026,7 @@ OASISReader::read_element_properties (bool ignore_special)
 
     } else if (m == 34 /*CBLOCK*/) {
 
-      uint32_t type = get_uint32 ();
-      if (type != 0) {
-        error (tl::sprintf (tl::to_string (tr ("Invalid CBLOCK compression type %d")), type));
-      }
-
-      uint64_t dummy = 0;
-      get (dummy);  // uncomp-byte-count - not needed
-      get (dummy);  // comp-byte-count - not needed
-
-      //  put the stream into deflating mode
-      m_stream.inflate ();
+      read_cblock ();
 
     } else if (m == 28 /*PROPERTY*/) {
 
@@ -1882,7 +2418,8 @@ OASISReader::do_read_placement (unsigned char r,
       uint64_t id;
       get (id);
 
-      mm_placement_cell = cell_for_instance (layout, id);
+      //  NOTE: when loading the shapes of a cell, the instances are present already
+      mm_placement_cell = m_loading_content ? 0 : cell_for_instance (layout, id);
 
     } else {
 
@@ -1890,7 +2427,7 @@ OASISReader::do_read_placement (unsigned char r,
       std::string name;
       get_str (name);
 
-      mm_placement_cell = cell_for_instance (layout, name);
+      mm_placement_cell = m_loading_content ? 0 : cell_for_instance (layout, name);
 
     }
 
@@ -1957,6 +2494,15 @@ OASISReader::do_read_placement (unsigned char r,
 
   db::Vector pos (mm_placement_x.get (), mm_placement_y.get ());
 
+  if (m_loading_content) {
+    //  instances are not loaded on demand - just read over repetition and properties
+    if (m & 0x8) {
+      read_repetition ();
+    }
+    read_element_properties (false);
+    return;
+  }
+
   const std::vector<db::Vector> *points = 0;
 
   if ((m & 0x8) && read_repetition ()) {
@@ -2094,6 +2640,11 @@ OASISReader::do_read_text (bool xy_absolute,
           const db::StringRef *string_ref = db::StringRepository::instance ()->create_string_ref ();
           m_text_forward_references.insert (std::make_pair (id, string_ref));
 
+          //  in lazy mode, the texts referring to this string may be gone before the string is resolved
+          if (m_lazy) {
+            const_cast<db::StringRef *> (string_ref)->add_ref ();
+          }
+
         } else {
 
           mm_text_string = tid->second;
@@ -2162,8 +2713,6 @@ OASISReader::do_read_text (bool xy_absolute,
         text = db::Text (mm_text_string.get (), db::Trans ());
       }
 
-      db::Cell &cell = layout.cell (cell_index);
-
       const std::vector<db::Vector> *points = 0;
 
       //  If the repetition is a regular one, convert the repetition into
@@ -2172,20 +2721,20 @@ OASISReader::do_read_text (bool xy_absolute,
       size_t na, nb;
       if (! layout.is_editable () && mm_repetition.get ().is_regular (a, b, na, nb)) {
 
-        db::TextPtr text_ptr (text, layout.shape_repository ());
+        db::TextPtr text_ptr (text, shape_repository (layout));
 
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::Shape::text_ptr_array_type> (db::Shape::text_ptr_array_type (text_ptr, db::Disp (pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::Shape::text_ptr_array_type> (db::Shape::text_ptr_array_type (text_ptr, db::Disp (pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::Shape::text_ptr_array_type (text_ptr, db::Disp (pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb));
+          target_shapes (layout, cell_index, ll.second).insert (db::Shape::text_ptr_array_type (text_ptr, db::Disp (pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb));
         }
 
       } else if (! layout.is_editable () && (points = mm_repetition.get ().is_iterated ()) != 0) {
 
-        db::TextPtr text_ptr (text, layout.shape_repository ());
+        db::TextPtr text_ptr (text, shape_repository (layout));
 
         //  Create an iterated text array
         db::Shape::text_ptr_array_type::iterated_array_type array;
@@ -2195,26 +2744,26 @@ OASISReader::do_read_text (bool xy_absolute,
         array.sort ();
 
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::Shape::text_ptr_array_type> (db::Shape::text_ptr_array_type (text_ptr, db::Disp (pos), layout.array_repository ().insert (array)), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::Shape::text_ptr_array_type> (db::Shape::text_ptr_array_type (text_ptr, db::Disp (pos), array_repository (layout).insert (array)), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::Shape::text_ptr_array_type (text_ptr, db::Disp (pos), layout.array_repository ().insert (array)));
+          target_shapes (layout, cell_index, ll.second).insert (db::Shape::text_ptr_array_type (text_ptr, db::Disp (pos), array_repository (layout).insert (array)));
         }
 
       } else {
 
         RepetitionIterator p = mm_repetition.get ().begin ();
-        db::TextRef text_ref (text, layout.shape_repository ());
+        db::TextRef text_ref (text, shape_repository (layout));
         while (! p.at_end ()) {
           if (pp.first) {
-            auto shape = cell.shapes (ll.second).insert (db::TextRefWithProperties (text_ref.transformed (db::Disp (pos + *p)), pp.second));
+            auto shape = target_shapes (layout, cell_index, ll.second).insert (db::TextRefWithProperties (text_ref.transformed (db::Disp (pos + *p)), pp.second));
             if (is_forward_properties_id (pp.second)) {
               register_forward_property_for_shape (shape);
             }
           } else {
-            cell.shapes (ll.second).insert (text_ref.transformed (db::Disp (pos + *p)));
+            target_shapes (layout, cell_index, ll.second).insert (text_ref.transformed (db::Disp (pos + *p)));
           }
           ++p;
         }
@@ -2237,12 +2786,12 @@ OASISReader::do_read_text (bool xy_absolute,
       }
 
       if (pp.first) {
-        auto shape = layout.cell (cell_index).shapes (ll.second).insert (db::TextRefWithProperties (db::TextRef (text, layout.shape_repository ()), pp.second));
+        auto shape = target_shapes (layout, cell_index, ll.second).insert (db::TextRefWithProperties (db::TextRef (text, shape_repository (layout)), pp.second));
         if (is_forward_properties_id (pp.second)) {
           register_forward_property_for_shape (shape);
         }
       } else {
-        layout.cell (cell_index).shapes (ll.second).insert (db::TextRef (text, layout.shape_repository ()));
+        target_shapes (layout, cell_index, ll.second).insert (db::TextRef (text, shape_repository (layout)));
       }
 
     }
@@ -2307,8 +2856,6 @@ OASISReader::do_read_rectangle (bool xy_absolute,
 
     if (ll.first) {
 
-      db::Cell &cell = layout.cell (cell_index);
-
       const std::vector<db::Vector> *points = 0;
 
       //  If the repetition is a regular one, convert the repetition into
@@ -2319,12 +2866,12 @@ OASISReader::do_read_rectangle (bool xy_absolute,
 
         //  Create a box array
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::Shape::box_array_type> (db::Shape::box_array_type (box, db::UnitTrans (), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::Shape::box_array_type> (db::Shape::box_array_type (box, db::UnitTrans (), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::Shape::box_array_type (box, db::UnitTrans (), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb));
+          target_shapes (layout, cell_index, ll.second).insert (db::Shape::box_array_type (box, db::UnitTrans (), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb));
         }
 
       } else if (! layout.is_editable () && (points = mm_repetition.get ().is_iterated ()) != 0) {
@@ -2337,12 +2884,12 @@ OASISReader::do_read_rectangle (bool xy_absolute,
         array.sort ();
 
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::Shape::box_array_type> (db::Shape::box_array_type (box, db::UnitTrans (), layout.array_repository ().insert (array)), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::Shape::box_array_type> (db::Shape::box_array_type (box, db::UnitTrans (), array_repository (layout).insert (array)), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::Shape::box_array_type (box, db::UnitTrans (), layout.array_repository ().insert (array)));
+          target_shapes (layout, cell_index, ll.second).insert (db::Shape::box_array_type (box, db::UnitTrans (), array_repository (layout).insert (array)));
         }
 
       } else {
@@ -2351,12 +2898,12 @@ OASISReader::do_read_rectangle (bool xy_absolute,
         RepetitionIterator p = mm_repetition.get ().begin ();
         while (! p.at_end ()) {
           if (pp.first) {
-            auto shape = cell.shapes (ll.second).insert (db::BoxWithProperties (box.moved (*p), pp.second));
+            auto shape = target_shapes (layout, cell_index, ll.second).insert (db::BoxWithProperties (box.moved (*p), pp.second));
             if (is_forward_properties_id (pp.second)) {
               register_forward_property_for_shape (shape);
             }
           } else {
-            cell.shapes (ll.second).insert (box.moved (*p));
+            target_shapes (layout, cell_index, ll.second).insert (box.moved (*p));
           }
           ++p;
         }
@@ -2371,14 +2918,13 @@ OASISReader::do_read_rectangle (bool xy_absolute,
 
     if (ll.first) {
 
-      db::Cell &cell = layout.cell (cell_index);
       if (pp.first) {
-        auto shape = cell.shapes (ll.second).insert (db::BoxWithProperties (box, pp.second));
+        auto shape = target_shapes (layout, cell_index, ll.second).insert (db::BoxWithProperties (box, pp.second));
         if (is_forward_properties_id (pp.second)) {
           register_forward_property_for_shape (shape);
         }
       } else {
-        cell.shapes (ll.second).insert (box);
+        target_shapes (layout, cell_index, ll.second).insert (box);
       }
 
     }
@@ -2433,8 +2979,6 @@ OASISReader::do_read_polygon (bool xy_absolute, db::cell_index_type cell_index,
 
     if (ll.first) {
 
-      db::Cell &cell = layout.cell (cell_index);
-
       if (mm_polygon_point_list.get ().size () < 3) {
         warn (tl::to_string (tr ("POLYGON with less than 3 points ignored")));
       } else {
@@ -2454,22 +2998,22 @@ OASISReader::do_read_polygon (bool xy_absolute, db::cell_index_type cell_index,
           //  creating a SimplePolygonPtr is most efficient with a normalized polygon because no displacement is provided
           db::Vector d (poly.box ().lower_left () - db::Point ());
           poly.move (-d);
-          db::SimplePolygonPtr poly_ptr (poly, layout.shape_repository ());
+          db::SimplePolygonPtr poly_ptr (poly, shape_repository (layout));
 
           if (pp.first) {
-            auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::array<db::SimplePolygonPtr, db::Disp> > (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
+            auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::array<db::SimplePolygonPtr, db::Disp> > (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
             if (is_forward_properties_id (pp.second)) {
               register_forward_property_for_shape (shape);
             }
           } else {
-            cell.shapes (ll.second).insert (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb));
+            target_shapes (layout, cell_index, ll.second).insert (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb));
           }
 
         } else if (! layout.is_editable () && (points = mm_repetition.get ().is_iterated ()) != 0) {
 
           db::Vector d (poly.box ().lower_left () - db::Point ());
           poly.move (-d);
-          db::SimplePolygonPtr poly_ptr (poly, layout.shape_repository ());
+          db::SimplePolygonPtr poly_ptr (poly, shape_repository (layout));
 
           //  Create an iterated simple polygon array
           db::Shape::simple_polygon_ptr_array_type::iterated_array_type array;
@@ -2479,27 +3023,27 @@ OASISReader::do_read_polygon (bool xy_absolute, db::cell_index_type cell_index,
           array.sort ();
 
           if (pp.first) {
-            auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::Shape::simple_polygon_ptr_array_type> (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), layout.array_repository ().insert (array)), pp.second));
+            auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::Shape::simple_polygon_ptr_array_type> (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), array_repository (layout).insert (array)), pp.second));
             if (is_forward_properties_id (pp.second)) {
               register_forward_property_for_shape (shape);
             }
           } else {
-            cell.shapes (ll.second).insert (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), layout.array_repository ().insert (array)));
+            target_shapes (layout, cell_index, ll.second).insert (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), array_repository (layout).insert (array)));
           }
 
         } else {
 
-          db::SimplePolygonRef poly_ref (poly, layout.shape_repository ());
+          db::SimplePolygonRef poly_ref (poly, shape_repository (layout));
 
           RepetitionIterator p = mm_repetition.get ().begin ();
           while (! p.at_end ()) {
             if (pp.first) {
-              auto shape = cell.shapes (ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos + *p)), pp.second));
+              auto shape = target_shapes (layout, cell_index, ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos + *p)), pp.second));
               if (is_forward_properties_id (pp.second)) {
                 register_forward_property_for_shape (shape);
               }
             } else {
-              cell.shapes (ll.second).insert (poly_ref.transformed (db::Disp (pos + *p)));
+              target_shapes (layout, cell_index, ll.second).insert (poly_ref.transformed (db::Disp (pos + *p)));
             }
             ++p;
           }
@@ -2523,15 +3067,15 @@ OASISReader::do_read_polygon (bool xy_absolute, db::cell_index_type cell_index,
         //  convert the OASIS record into the polygon.
         db::SimplePolygon poly;
         poly.assign_hull (mm_polygon_point_list.get ().begin (), mm_polygon_point_list.get ().end (), false /*no compression*/);
-        db::SimplePolygonRef poly_ref (poly, layout.shape_repository ());
+        db::SimplePolygonRef poly_ref (poly, shape_repository (layout));
 
         if (pp.first) {
-          auto shape = layout.cell (cell_index).shapes (ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos)), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos)), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          layout.cell (cell_index).shapes (ll.second).insert (poly_ref.transformed (db::Disp (pos)));
+          target_shapes (layout, cell_index, ll.second).insert (poly_ref.transformed (db::Disp (pos)));
         }
 
       }
@@ -2622,8 +3166,6 @@ OASISReader::do_read_path (bool xy_absolute, db::cell_index_type cell_index, db:
         path.extensions (mm_path_start_extension.get (), mm_path_end_extension.get ());
         path.assign (mm_path_point_list.get ().begin (), mm_path_point_list.get ().end ());
 
-        db::Cell &cell = layout.cell (cell_index);
-
         const std::vector<db::Vector> *points = 0;
 
         //  If the repetition is a regular one, convert the repetition into
@@ -2635,22 +3177,22 @@ OASISReader::do_read_path (bool xy_absolute, db::cell_index_type cell_index, db:
           //  creating a PathPtr is most efficient with a normalized path because no displacement is provided
           db::Vector d (*path.begin ());
           path.move (-d);
-          db::PathPtr path_ptr (path, layout.shape_repository ());
+          db::PathPtr path_ptr (path, shape_repository (layout));
 
           if (pp.first) {
-            auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::array<db::PathPtr, db::Disp> > (db::array<db::PathPtr, db::Disp> (path_ptr, db::Disp (d + pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
+            auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::array<db::PathPtr, db::Disp> > (db::array<db::PathPtr, db::Disp> (path_ptr, db::Disp (d + pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
             if (is_forward_properties_id (pp.second)) {
               register_forward_property_for_shape (shape);
             }
           } else {
-            cell.shapes (ll.second).insert (db::array<db::PathPtr, db::Disp> (path_ptr, db::Disp (d + pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb));
+            target_shapes (layout, cell_index, ll.second).insert (db::array<db::PathPtr, db::Disp> (path_ptr, db::Disp (d + pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb));
           }
 
         } else if (! layout.is_editable () && (points = mm_repetition.get ().is_iterated ()) != 0) {
 
           db::Vector d (*path.begin () - db::Point ());
           path.move (-d);
-          db::PathPtr path_ptr (path, layout.shape_repository ());
+          db::PathPtr path_ptr (path, shape_repository (layout));
 
           //  Create an iterated simple polygon array
           db::Shape::path_ptr_array_type::iterated_array_type array;
@@ -2660,27 +3202,27 @@ OASISReader::do_read_path (bool xy_absolute, db::cell_index_type cell_index, db:
           array.sort ();
 
           if (pp.first) {
-            auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::Shape::path_ptr_array_type> (db::Shape::path_ptr_array_type (path_ptr, db::Disp (d + pos), layout.array_repository ().insert (array)), pp.second));
+            auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::Shape::path_ptr_array_type> (db::Shape::path_ptr_array_type (path_ptr, db::Disp (d + pos), array_repository (layout).insert (array)), pp.second));
             if (is_forward_properties_id (pp.second)) {
               register_forward_property_for_shape (shape);
             }
           } else {
-            cell.shapes (ll.second).insert (db::Shape::path_ptr_array_type (path_ptr, db::Disp (d + pos), layout.array_repository ().insert (array)));
+            target_shapes (layout, cell_index, ll.second).insert (db::Shape::path_ptr_array_type (path_ptr, db::Disp (d + pos), array_repository (layout).insert (array)));
           }
 
         } else {
 
-          db::PathRef path_ref (path, layout.shape_repository ());
+          db::PathRef path_ref (path, shape_repository (layout));
 
           RepetitionIterator p = mm_repetition.get ().begin ();
           while (! p.at_end ()) {
             if (pp.first) {
-              auto shape = cell.shapes (ll.second).insert (db::PathRefWithProperties (path_ref.transformed (db::Disp (pos + *p)), pp.second));
+              auto shape = target_shapes (layout, cell_index, ll.second).insert (db::PathRefWithProperties (path_ref.transformed (db::Disp (pos + *p)), pp.second));
               if (is_forward_properties_id (pp.second)) {
                 register_forward_property_for_shape (shape);
               }
             } else {
-              cell.shapes (ll.second).insert (path_ref.transformed (db::Disp (pos + *p)));
+              target_shapes (layout, cell_index, ll.second).insert (path_ref.transformed (db::Disp (pos + *p)));
             }
             ++p;
           }
@@ -2706,15 +3248,15 @@ OASISReader::do_read_path (bool xy_absolute, db::cell_index_type cell_index, db:
         path.width (2 * mm_path_halfwidth.get ());
         path.extensions (mm_path_start_extension.get (), mm_path_end_extension.get ());
         path.assign (mm_path_point_list.get ().begin (), mm_path_point_list.get ().end ());
-        db::PathRef path_ref (path, layout.shape_repository ());
+        db::PathRef path_ref (path, shape_repository (layout));
 
         if (pp.first) {
-          auto shape = layout.cell (cell_index).shapes (ll.second).insert (db::PathRefWithProperties (path_ref.transformed (db::Disp (pos)), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::PathRefWithProperties (path_ref.transformed (db::Disp (pos)), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          layout.cell (cell_index).shapes (ll.second).insert (path_ref.transformed (db::Disp (pos)));
+          target_shapes (layout, cell_index, ll.second).insert (path_ref.transformed (db::Disp (pos)));
         }
 
       }
@@ -2803,8 +3345,6 @@ OASISReader::do_read_trapezoid (unsigned char r, bool xy_absolute,db::cell_index
       db::SimplePolygon poly;
       poly.assign_hull (pts, pts + 4, false /*no compression*/);
 
-      db::Cell &cell = layout.cell (cell_index);
-
       const std::vector<db::Vector> *points = 0;
 
       //  If the repetition is a regular one, convert the repetition into
@@ -2816,22 +3356,22 @@ OASISReader::do_read_trapezoid (unsigned char r, bool xy_absolute,db::cell_index
         //  creating a SimplePolygonPtr is most efficient with a normalized polygon because no displacement is provided
         db::Vector d (poly.box ().lower_left ());
         poly.move (-d);
-        db::SimplePolygonPtr poly_ptr (poly, layout.shape_repository ());
+        db::SimplePolygonPtr poly_ptr (poly, shape_repository (layout));
 
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::array<db::SimplePolygonPtr, db::Disp> > (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::array<db::SimplePolygonPtr, db::Disp> > (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb));
+          target_shapes (layout, cell_index, ll.second).insert (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb));
         }
 
       } else if (! layout.is_editable () && (points = mm_repetition.get ().is_iterated ()) != 0) {
 
         db::Vector d (poly.box ().lower_left () - db::Point ());
         poly.move (-d);
-        db::SimplePolygonPtr poly_ptr (poly, layout.shape_repository ());
+        db::SimplePolygonPtr poly_ptr (poly, shape_repository (layout));
 
         //  Create an iterated simple polygon array
         db::Shape::simple_polygon_ptr_array_type::iterated_array_type array;
@@ -2841,27 +3381,27 @@ OASISReader::do_read_trapezoid (unsigned char r, bool xy_absolute,db::cell_index
         array.sort ();
 
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::Shape::simple_polygon_ptr_array_type> (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), layout.array_repository ().insert (array)), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::Shape::simple_polygon_ptr_array_type> (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), array_repository (layout).insert (array)), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), layout.array_repository ().insert (array)));
+          target_shapes (layout, cell_index, ll.second).insert (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), array_repository (layout).insert (array)));
         }
 
       } else {
 
-        db::SimplePolygonRef poly_ref (poly, layout.shape_repository ());
+        db::SimplePolygonRef poly_ref (poly, shape_repository (layout));
 
         RepetitionIterator p = mm_repetition.get ().begin ();
         while (! p.at_end ()) {
           if (pp.first) {
-            auto shape = cell.shapes (ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos + *p)), pp.second));
+            auto shape = target_shapes (layout, cell_index, ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos + *p)), pp.second));
             if (is_forward_properties_id (pp.second)) {
               register_forward_property_for_shape (shape);
             }
           } else {
-            cell.shapes (ll.second).insert (poly_ref.transformed (db::Disp (pos + *p)));
+            target_shapes (layout, cell_index, ll.second).insert (poly_ref.transformed (db::Disp (pos + *p)));
           }
           ++p;
         }
@@ -2879,15 +3419,15 @@ OASISReader::do_read_trapezoid (unsigned char r, bool xy_absolute,db::cell_index
       //  convert the OASIS record into the polygon.
       db::SimplePolygon poly;
       poly.assign_hull (pts, pts + 4, false /*no compression*/);
-      db::SimplePolygonRef poly_ref (poly, layout.shape_repository ());
+      db::SimplePolygonRef poly_ref (poly, shape_repository (layout));
 
       if (pp.first) {
-        auto shape = layout.cell (cell_index).shapes (ll.second).insert (SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos)), pp.second));
+        auto shape = target_shapes (layout, cell_index, ll.second).insert (SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos)), pp.second));
         if (is_forward_properties_id (pp.second)) {
           register_forward_property_for_shape (shape);
         }
       } else {
-        layout.cell (cell_index).shapes (ll.second).insert (poly_ref.transformed (db::Disp (pos)));
+        target_shapes (layout, cell_index, ll.second).insert (poly_ref.transformed (db::Disp (pos)));
       }
 
     }
@@ -3175,8 +3715,6 @@ OASISReader::do_read_ctrapezoid (bool xy_absolute,db::cell_index_type cell_index
       db::SimplePolygon poly;
       poly.assign_hull (pts, pts + npts, false /*no compression*/);
 
-      db::Cell &cell = layout.cell (cell_index);
-
       const std::vector<db::Vector> *points = 0;
 
       //  If the repetition is a regular one, convert the repetition into
@@ -3187,22 +3725,22 @@ OASISReader::do_read_ctrapezoid (bool xy_absolute,db::cell_index_type cell_index
 
         db::Vector d (poly.box ().lower_left () - db::Point ());
         poly.move (-d);
-        db::SimplePolygonPtr poly_ptr (poly, layout.shape_repository ());
+        db::SimplePolygonPtr poly_ptr (poly, shape_repository (layout));
 
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::array<db::SimplePolygonPtr, db::Disp> > (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::array<db::SimplePolygonPtr, db::Disp> > (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb));
+          target_shapes (layout, cell_index, ll.second).insert (db::array<db::SimplePolygonPtr, db::Disp> (poly_ptr, db::Disp (d + pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb));
         }
 
       } else if (! layout.is_editable () && (points = mm_repetition.get ().is_iterated ()) != 0) {
 
         db::Vector d (poly.box ().lower_left () - db::Point ());
         poly.move (-d);
-        db::SimplePolygonPtr poly_ptr (poly, layout.shape_repository ());
+        db::SimplePolygonPtr poly_ptr (poly, shape_repository (layout));
 
         //  Create an iterated simple polygon array
         db::Shape::simple_polygon_ptr_array_type::iterated_array_type array;
@@ -3212,27 +3750,27 @@ OASISReader::do_read_ctrapezoid (bool xy_absolute,db::cell_index_type cell_index
         array.sort ();
 
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::Shape::simple_polygon_ptr_array_type> (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), layout.array_repository ().insert (array)), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::Shape::simple_polygon_ptr_array_type> (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), array_repository (layout).insert (array)), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), layout.array_repository ().insert (array)));
+          target_shapes (layout, cell_index, ll.second).insert (db::Shape::simple_polygon_ptr_array_type (poly_ptr, db::Disp (d + pos), array_repository (layout).insert (array)));
         }
 
       } else {
 
-        db::SimplePolygonRef poly_ref (poly, layout.shape_repository ());
+        db::SimplePolygonRef poly_ref (poly, shape_repository (layout));
 
         RepetitionIterator p = mm_repetition.get ().begin ();
         while (! p.at_end ()) {
           if (pp.first) {
-            auto shape = cell.shapes (ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos + *p)), pp.second));
+            auto shape = target_shapes (layout, cell_index, ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos + *p)), pp.second));
             if (is_forward_properties_id (pp.second)) {
               register_forward_property_for_shape (shape);
             }
           } else {
-            cell.shapes (ll.second).insert (poly_ref.transformed (db::Disp (pos + *p)));
+            target_shapes (layout, cell_index, ll.second).insert (poly_ref.transformed (db::Disp (pos + *p)));
           }
           ++p;
         }
@@ -3250,15 +3788,15 @@ OASISReader::do_read_ctrapezoid (bool xy_absolute,db::cell_index_type cell_index
       //  convert the OASIS record into the polygon.
       db::SimplePolygon poly;
       poly.assign_hull (pts, pts + npts, false /*no compression*/);
-      db::SimplePolygonRef poly_ref (poly, layout.shape_repository ());
+      db::SimplePolygonRef poly_ref (poly, shape_repository (layout));
 
       if (pp.first) {
-        auto shape = layout.cell (cell_index).shapes (ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos)), pp.second));
+        auto shape = target_shapes (layout, cell_index, ll.second).insert (db::SimplePolygonRefWithProperties (poly_ref.transformed (db::Disp (pos)), pp.second));
         if (is_forward_properties_id (pp.second)) {
           register_forward_property_for_shape (shape);
         }
       } else {
-        layout.cell (cell_index).shapes (ll.second).insert (poly_ref.transformed (db::Disp (pos)));
+        target_shapes (layout, cell_index, ll.second).insert (poly_ref.transformed (db::Disp (pos)));
       }
 
     }
@@ -3326,8 +3864,6 @@ OASISReader::do_read_circle (bool xy_absolute, db::cell_index_type cell_index, d
       db::Point p0 (0, 0);
       path.assign (&p0, &p0 + 1);
 
-      db::Cell &cell = layout.cell (cell_index);
-
       const std::vector<db::Vector> *points = 0;
 
       //  If the repetition is a regular one, convert the repetition into
@@ -3337,20 +3873,20 @@ OASISReader::do_read_circle (bool xy_absolute, db::cell_index_type cell_index, d
       if (! layout.is_editable () && mm_repetition.get ().is_regular (a, b, na, nb)) {
 
         //  creating a PathPtr is most efficient with a normalized path because no displacement is provided
-        db::PathPtr path_ptr (path, layout.shape_repository ());
+        db::PathPtr path_ptr (path, shape_repository (layout));
 
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::array<db::PathPtr, db::Disp> > (db::array<db::PathPtr, db::Disp> (path_ptr, db::Disp (pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::array<db::PathPtr, db::Disp> > (db::array<db::PathPtr, db::Disp> (path_ptr, db::Disp (pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::array<db::PathPtr, db::Disp> (path_ptr, db::Disp (pos), layout.array_repository (), a, b, (uint64_t) na, (uint64_t) nb));
+          target_shapes (layout, cell_index, ll.second).insert (db::array<db::PathPtr, db::Disp> (path_ptr, db::Disp (pos), array_repository (layout), a, b, (uint64_t) na, (uint64_t) nb));
         }
 
       } else if (! layout.is_editable () && (points = mm_repetition.get ().is_iterated ()) != 0) {
 
-        db::PathPtr path_ptr (path, layout.shape_repository ());
+        db::PathPtr path_ptr (path, shape_repository (layout));
 
         //  Create an iterated simple polygon array
         db::Shape::path_ptr_array_type::iterated_array_type array;
@@ -3360,27 +3896,27 @@ OASISReader::do_read_circle (bool xy_absolute, db::cell_index_type cell_index, d
         array.sort ();
 
         if (pp.first) {
-          auto shape = cell.shapes (ll.second).insert (db::object_with_properties<db::Shape::path_ptr_array_type> (db::Shape::path_ptr_array_type (path_ptr, db::Disp (pos), layout.array_repository ().insert (array)), pp.second));
+          auto shape = target_shapes (layout, cell_index, ll.second).insert (db::object_with_properties<db::Shape::path_ptr_array_type> (db::Shape::path_ptr_array_type (path_ptr, db::Disp (pos), array_repository (layout).insert (array)), pp.second));
           if (is_forward_properties_id (pp.second)) {
             register_forward_property_for_shape (shape);
           }
         } else {
-          cell.shapes (ll.second).insert (db::Shape::path_ptr_array_type (path_ptr, db::Disp (pos), layout.array_repository ().insert (array)));
+          target_shapes (layout, cell_index, ll.second).insert (db::Shape::path_ptr_array_type (path_ptr, db::Disp (pos), array_repository (layout).insert (array)));
         }
 
       } else {
 
-        db::PathRef path_ref (path, layout.shape_repository ());
+        db::PathRef path_ref (path, shape_repository (layout));
 
         RepetitionIterator p = mm_repetition.get ().begin ();
         while (! p.at_end ()) {
           if (pp.first) {
-            auto shape = cell.shapes (ll.second).insert (db::PathRefWithProperties (path_ref.transformed (db::Disp (pos + *p)), pp.second));
+            auto shape = target_shapes (layout, cell_index, ll.second).insert (db::PathRefWithProperties (path_ref.transformed (db::Disp (pos + *p)), pp.second));
             if (is_forward_properties_id (pp.second)) {
               register_forward_property_for_shape (shape);
             }
           } else {
-            cell.shapes (ll.second).insert (path_ref.transformed (db::Disp (pos + *p)));
+            target_shapes (layout, cell_index, ll.second).insert (path_ref.transformed (db::Disp (pos + *p)));
           }
           ++p;
         }
@@ -3402,15 +3938,15 @@ OASISReader::do_read_circle (bool xy_absolute, db::cell_index_type cell_index, d
       path.round (true);
       db::Point p0 (0, 0);
       path.assign (&p0, &p0 + 1);
-      db::PathRef path_ref (path, layout.shape_repository ());
+      db::PathRef path_ref (path, shape_repository (layout));
 
       if (pp.first) {
-        auto shape = layout.cell (cell_index).shapes (ll.second).insert (db::PathRefWithProperties (path_ref.transformed (db::Disp (pos)), pp.second));
+        auto shape = target_shapes (layout, cell_index, ll.second).insert (db::PathRefWithProperties (path_ref.transformed (db::Disp (pos)), pp.second));
         if (is_forward_properties_id (pp.second)) {
           register_forward_property_for_shape (shape);
         }
       } else {
-        layout.cell (cell_index).shapes (ll.second).insert (path_ref.transformed (db::Disp (pos)));
+        target_shapes (layout, cell_index, ll.second).insert (path_ref.transformed (db::Disp (pos)));
       }
 
     }
@@ -3585,17 +4121,7 @@ OASISReader::do_read_cell (db::cell_index_type cell_index, db::Layout &layout)
 
     } else if (r == 34 /*CBLOCK*/) {
 
-      uint32_t type = get_uint32 ();
-      if (type != 0) {
-        error (tl::sprintf (tl::to_string (tr ("Invalid CBLOCK compression type %d")), type));
-      }
-
-      uint64_t dummy = 0;
-      get (dummy);  // uncomp-byte-count - not needed
-      get (dummy);  // comp-byte-count - not needed
-
-      //  put the stream into deflating mode
-      m_stream.inflate ();
+      read_cblock ();
 
     } else {
       //  put the byte back into the stream
@@ -3605,6 +4131,14 @@ OASISReader::do_read_cell (db::cell_index_type cell_index, db::Layout &layout)
 
   }
 
+  //  when loading the shapes of a cell, cell properties and instances are present already
+  if (m_loading_content) {
+    m_instances.clear ();
+    m_instances_with_props.clear ();
+    m_cellname = "";
+    return;
+  }
+
   if (! cell_properties.empty ()) {
 
     if (has_forward_refs (cell_properties)) {
@@ -3654,5 +4188,90 @@ OASISReader::do_read_cell (db::cell_index_type cell_index, db::Layout &layout)
   m_cellname = "";
 }
 
+
+void
+OASISReader::scan_cell (db::cell_index_type cell_index, db::Layout &layout)
+{
+  size_t position = m_stream.pos ();
+
+  //  The shapes are read into temporary containers using scratch repositories for
+  //  computing the bounding boxes. They are discarded afterwards and loaded again by
+  //  OASISCellContentLoader when they are needed.
+  db::GenericRepository shape_repository;
+  db::ArrayRepository array_repository;
+  db::CellContentLoader::box_map bboxes;
+
+  {
+    db::CellContentLoader::shapes_map shapes;
+
+    mp_staged_shapes = &shapes;
+    mp_scratch_shape_repository = &shape_repository;
+    mp_scratch_array_repository = &array_repository;
+
+    try {
+      do_read_cell (cell_index, layout);
+    } catch (...) {
+      mp_staged_shapes = 0;
+      mp_scratch_shape_repository = 0;
+      mp_scratch_array_repository = 0;
+      throw;
+    }
+
+    mp_staged_shapes = 0;
+    mp_scratch_shape_repository = 0;
+    mp_scratch_array_repository = 0;
+
+    for (auto s = shapes.begin (); s != shapes.end (); ++s) {
+      if (! s->second.empty ()) {
+        bboxes [s->first] = s->second.bbox ();
+      }
+    }
+  }
+
+  //  cells without shapes don't need to be loaded
+  if (! bboxes.empty ()) {
+    PendingCell &pending = m_pending_cells [cell_index];
+    pending.position = position;
+    pending.bboxes.swap (bboxes);
+  }
+}
+
+void
+OASISReader::read_staged_cell (db::cell_index_type cell_index, db::Layout &layout, size_t position)
+{
+  m_s_gds_property_name_id = db::property_names_id (s_gds_property_propname);
+  m_klayout_context_property_name_id = db::property_names_id (klayout_context_propname);
+
+  m_loading_content = true;
+  m_cellname = layout.cell_name (cell_index);
+
+  m_stream.seek (position);
+
+  reset_modal_variables ();
+  do_read_cell (cell_index, layout);
+}
+
+db::Shapes &
+OASISReader::target_shapes (db::Layout &layout, db::cell_index_type cell_index, unsigned int layer)
+{
+  if (mp_staged_shapes) {
+    return db::CellContentLoader::shapes_for_layer (layout, *mp_staged_shapes, layer);
+  } else {
+    return layout.cell (cell_index).shapes (layer);
+  }
+}
+
+db::GenericRepository &
+OASISReader::shape_repository (db::Layout &layout)
+{
+  return mp_scratch_shape_repository ? *mp_scratch_shape_repository : layout.shape_repository ();
+}
+
+db::ArrayRepository &
+OASISReader::array_repository (db::Layout &layout)
+{
+  return mp_scratch_array_repository ? *mp_scratch_array_repository : layout.array_repository ();
+}
+
 }
 
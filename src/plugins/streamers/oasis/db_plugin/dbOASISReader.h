@@ -43,10 +43,14 @@
 
 #include <map>
 #include <set>
+#include <memory>
 
 namespace db
 {
 
+class OASISCBlockPrefetcher;
+class OASISCellContentLoader;
+
 /**
  *  @brief Generic base class of OASIS reader exceptions
  */
@@ -107,8 +111,21 @@ protected:
   virtual void do_read (db::Layout &layout);
 
 private:
+  friend class OASISCellContentLoader;
+
   typedef db::coord_traits<db::Coord>::distance_type distance_type;
 
+  /**
+   *  @brief Describes a cell whose shapes are loaded on demand
+   */
+  struct PendingCell
+  {
+    PendingCell () : position (0) { }
+
+    size_t position;
+    db::CellContentLoader::box_map bboxes;
+  };
+
   enum TableMode
   {
     NotInTable,
@@ -177,6 +194,8 @@ private:
   bool m_read_texts;
   bool m_read_properties;
   bool m_read_all_properties;
+  int m_threads;
+  std::unique_ptr<OASISCBlockPrefetcher> mp_cblock_prefetcher;
 
   std::map <uint64_t, db::property_names_id_type> m_propname_forward_references;
   std::map <uint64_t, std::string> m_propvalue_forward_references;
@@ -187,6 +206,13 @@ private:
   db::property_names_id_type m_s_gds_property_name_id;
   db::property_names_id_type m_klayout_context_property_name_id;
 
+  bool m_lazy;
+  bool m_loading_content;
+  std::map<db::cell_index_type, PendingCell> m_pending_cells;
+  db::CellContentLoader::shapes_map *mp_staged_shapes;
+  db::GenericRepository *mp_scratch_shape_repository;
+  db::ArrayRepository *mp_scratch_array_repository;
+
   void do_read_cell (db::cell_index_type cell_index, db::Layout &layout);
 
   void do_read_placement (unsigned char r,
@@ -203,8 +229,16 @@ private:
   void do_read_ctrapezoid (bool xy_absolute,db::cell_index_type cell_index, db::Layout &layout);
   void do_read_circle (bool xy_absolute,db::cell_index_type cell_index, db::Layout &layout);
 
+  void scan_cell (db::cell_index_type cell_index, db::Layout &layout);
+  void read_staged_cell (db::cell_index_type cell_index, db::Layout &layout, size_t position);
+  db::Shapes &target_shapes (db::Layout &layout, db::cell_index_type cell_index, unsigned int layer);
+  db::GenericRepository &shape_repository (db::Layout &layout);
+  db::ArrayRepository &array_repository (db::Layout &layout);
+
   void reset_modal_variables ();
 
+  void read_cblock ();
+
   void mark_start_table ();
 
   void read_offset_table ();
@@ -27,6 +27,7 @@
 #include "tlDeflate.h"
 #include "tlMath.h"
 #include "tlUniqueName.h"
+#include "tlThreadedWorkers.h"
 
 #include <math.h>
 
@@ -659,6 +660,232 @@ Compressor<Obj>::flush (db::OASISWriter *writer)
   }
 }
 
+// ---------------------------------------------------------------------------------
+//  OASISCellWriterJob definition and implementation
+
+/**
+ *  @brief Holds the serialized form of one cell
+ */
+struct OASISWrittenCell
+{
+  OASISWrittenCell ()
+    : tables_modified (false), finished (false)
+  { }
+
+  std::vector<char> data;
+  std::string error;
+  bool tables_modified;
+  bool finished;
+};
+
+/**
+ *  @brief The task for writing one cell
+ */
+class OASISCellWriterTask
+  : public tl::Task
+{
+public:
+  OASISCellWriterTask (db::cell_index_type cell_index, OASISWrittenCell *cell)
+    : m_cell_index (cell_index), mp_cell (cell)
+  { }
+
+  db::cell_index_type cell_index () const
+  {
+    return m_cell_index;
+  }
+
+  OASISWrittenCell *cell () const
+  {
+    return mp_cell;
+  }
+
+private:
+  db::cell_index_type m_cell_index;
+  OASISWrittenCell *mp_cell;
+};
+
+class OASISCellWriterJob;
+
+/**
+ *  @brief The worker writing cells into memory
+ *
+ *  Each worker owns a writer which is initialized from the master writer. The cell
+ *  bodies are written into a memory buffer by this writer.
+ */
+class OASISCellWriterWorker
+  : public tl::Worker
+{
+public:
+  OASISCellWriterWorker (OASISCellWriterJob *job)
+    : tl::Worker (), mp_job (job)
+  { }
+
+  virtual void perform_task (tl::Task *task);
+
+private:
+  OASISCellWriterJob *mp_job;
+  std::unique_ptr<OASISWriter> mp_writer;
+};
+
+/**
+ *  @brief A job that serializes cells in multiple threads
+ *
+ *  The cells are written into memory buffers including CBLOCK compression. The
+ *  master writer picks the buffers in the original cell order and copies them
+ *  to the output stream. As the cell bodies only depend on the name tables which
+ *  are complete when the cells are written, the output is identical to the
+ *  single-threaded case.
+ */
+class OASISCellWriterJob
+  : public tl::JobBase
+{
+public:
+  OASISCellWriterJob (int nworkers, const OASISWriter *master, const std::set <db::cell_index_type> &cell_set, const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers)
+    : tl::JobBase (nworkers), mp_master (master), mp_cell_set (&cell_set), mp_layers (&layers)
+  {
+    //  .. nothing yet ..
+  }
+
+  ~OASISCellWriterJob ()
+  {
+    //  stop the workers before the cells are deleted
+    terminate ();
+
+    for (auto c = m_cells.begin (); c != m_cells.end (); ++c) {
+      delete c->second;
+    }
+    m_cells.clear ();
+  }
+
+  const OASISWriter &master () const
+  {
+    return *mp_master;
+  }
+
+  const std::set <db::cell_index_type> &cell_set () const
+  {
+    return *mp_cell_set;
+  }
+
+  const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers () const
+  {
+    return *mp_layers;
+  }
+
+  /**
+   *  @brief Schedules the given cell for being written
+   */
+  void submit (db::cell_index_type cell_index)
+  {
+    OASISWrittenCell *cell = new OASISWrittenCell ();
+    m_cells.insert (std::make_pair (cell_index, cell));
+
+    schedule (new OASISCellWriterTask (cell_index, cell));
+    if (! is_running ()) {
+      start ();
+    }
+  }
+
+  /**
+   *  @brief Waits for the given cell and takes the result
+   *
+   *  The caller is responsible for deleting the object returned.
+   */
+  OASISWrittenCell *fetch (db::cell_index_type cell_index)
+  {
+    auto c = m_cells.find (cell_index);
+    tl_assert (c != m_cells.end ());
+
+    OASISWrittenCell *cell = c->second;
+    m_cells.erase (c);
+
+    m_lock.lock ();
+    while (! cell->finished) {
+      m_finished_condition.wait (&m_lock);
+    }
+    m_lock.unlock ();
+
+    return cell;
+  }
+
+  /**
+   *  @brief Called by the workers to indicate that a cell is finished
+   */
+  void finish (OASISWrittenCell *cell)
+  {
+    m_lock.lock ();
+    cell->finished = true;
+    m_finished_condition.wakeAll ();
+    m_lock.unlock ();
+  }
+
+protected:
+  virtual tl::Worker *create_worker ()
+  {
+    return new OASISCellWriterWorker (this);
+  }
+
+private:
+  const OASISWriter *mp_master;
+  const std::set <db::cell_index_type> *mp_cell_set;
+  const std::vector <std::pair <unsigned int, db::LayerProperties> > *mp_layers;
+  std::map<db::cell_index_type, OASISWrittenCell *> m_cells;
+  tl::Mutex m_lock;
+  tl::WaitCondition m_finished_condition;
+};
+
+void
+OASISCellWriterWorker::perform_task (tl::Task *task)
+{
+  OASISCellWriterTask *cell_task = dynamic_cast<OASISCellWriterTask *> (task);
+  if (! cell_task) {
+    return;
+  }
+
+  OASISWrittenCell *cell = cell_task->cell ();
+
+  try {
+
+    tl::OutputMemoryStream buffer;
+    tl::OutputStream stream (buffer);
+
+    //  NOTE: the writer is created inside the worker thread, so its progress object
+    //  does not register with the main thread's progress reporter
+    if (! mp_writer.get ()) {
+      mp_writer.reset (new OASISWriter ());
+      mp_writer->init_cell_writer (mp_job->master ());
+    }
+
+    mp_writer->mp_stream = &stream;
+    mp_writer->write_cell (cell_task->cell_index (), mp_job->cell_set (), mp_job->layers ());
+    mp_writer->mp_stream = 0;
+
+    stream.flush ();
+
+    if (buffer.size () > 0) {
+      cell->data.assign (buffer.data (), buffer.data () + buffer.size ());
+    }
+
+    //  if the name tables of this writer are no longer in sync with the master, the
+    //  result is not valid
+    cell->tables_modified = mp_writer->tables_modified (mp_job->master ());
+
+  } catch (tl::Exception &ex) {
+    cell->error = ex.msg ();
+  } catch (std::exception &ex) {
+    cell->error = ex.what ();
+  } catch (...) {
+    cell->error = tl::to_string (tr ("Unspecific error while writing cell"));
+  }
+
+  //  start with a fresh writer if the state of the current one is no longer valid
+  if (cell->tables_modified || ! cell->error.empty ()) {
+    mp_writer.reset (0);
+  }
+
+  mp_job->finish (cell);
+}
+
 // ---------------------------------------------------------------------------------
 //  OASISWriter implementation
 
@@ -1649,104 +1876,33 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
   //  write cells
 
-  for (std::vector<db::cell_index_type>::const_iterator cell = cells.begin (); cell != cells.end (); ++cell) {
-
-    m_progress.set (mp_stream->pos ());
-
-    //  cell body 
-    const db::Cell &cref (layout.cell (*cell));
-    mp_cell = &cref;
-
-    //  skip cell body if the cell is not to be written
-    if (cref.is_real_ghost_cell ()) {
-      continue;
-    }
-
-    //  cell header
-
-    cell_positions.insert (std::make_pair (*cell, mp_stream->pos ()));
-
-    write_record_id (13);  // CELL
-    write ((uint64_t) *cell);
-
-    reset_modal_variables ();
+  if (m_options.threads > 0 && ! m_options.tables_at_end) {
 
-    if (m_options.write_cblocks) {
-      begin_cblock ();
-    }
-
-    //  context information as property named KLAYOUT_CONTEXT
-    if (options.write_context_info () && layout.has_context_info (*cell)) {
-
-      context_prop_strings.clear ();
-
-      if (layout.get_context_info (*cell, context_prop_strings)) {
+    //  NOTE: with the tables written at the end, the ID's of the table entries are assigned
+    //  in the order the cells are written. Hence we can only use threads if the tables are
+    //  written before the cells.
+    write_cells_threaded (cells, cell_set, layers, cell_positions);
 
-        write_record_id (28);
-        write_byte (char (0xf6));
-        uint64_t pnid = 0;
-        std::map <std::string, uint64_t>::const_iterator pni = m_propnames.find (klayout_context_name);
-        if (pni == m_propnames.end ()) {
-          pnid = m_propname_id++;
-          m_propnames.insert (std::make_pair (klayout_context_name, pnid));
-        } else {
-          pnid = pni->second;
-        }
-        write (pnid);
-
-        write ((uint64_t) context_prop_strings.size ());
+  } else {
 
-        for (std::vector <std::string>::const_iterator c = context_prop_strings.begin (); c != context_prop_strings.end (); ++c) {
-          write_byte (14); // b-string by reference number
-          uint64_t psid = 0;
-          std::map <std::string, uint64_t>::const_iterator psi = m_propstrings.find (*c);
-          if (psi == m_propstrings.end ()) {
-            psid = m_propstring_id++;
-            m_propstrings.insert (std::make_pair (*c, psid)).second;
-          } else {
-            psid = psi->second;
-          }
-          write (psid);
-        }
+    for (std::vector<db::cell_index_type>::const_iterator cell = cells.begin (); cell != cells.end (); ++cell) {
 
-        mm_last_property_name = klayout_context_name;
-        mm_last_property_is_sprop = false;
-        mm_last_value_list.reset ();
+      m_progress.set (mp_stream->pos ());
 
+      //  skip cell body if the cell is not to be written
+      if (layout.cell (*cell).is_real_ghost_cell ()) {
+        continue;
       }
 
-    }
-
-    if (cref.prop_id () != 0) {
-      write_props (cref.prop_id ());
-    }
-
-    bool skip_body = options.write_context_info () && cref.can_skip_replica ();
-    if (! skip_body) {
+      cell_positions.insert (std::make_pair (*cell, mp_stream->pos ()));
 
-      //  instances
-      if (cref.cell_instances () > 0) {
-        write_insts (cell_set);
-      }
+      write_cell (*cell, cell_set, layers);
 
-      //  shapes
-      for (std::vector <std::pair <unsigned int, db::LayerProperties> >::const_iterator l = layers.begin (); l != layers.end (); ++l) {
-        const db::Shapes &shapes = cref.shapes (l->first);
-        if (! shapes.empty ()) {
-          write_shapes (l->second, shapes);
-          m_progress.set (mp_stream->pos ());
-        }
-      }
+      //  drop the shapes again if they have been loaded on demand in transient mode
+      layout.cell (*cell).release_content ();
 
     }
 
-    //  end CBLOCK if required
-    if (m_options.write_cblocks) {
-      end_cblock ();
-    }
-
-    //  end of cell
-
   }
 
   //  write the tables if at end
@@ -1825,6 +1981,207 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
   m_progress.set (mp_stream->pos ());
 }
 
+void
+OASISWriter::write_cell (db::cell_index_type cell_index, const std::set <db::cell_index_type> &cell_set, const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers)
+{
+  const db::Cell &cref (mp_layout->cell (cell_index));
+  mp_cell = &cref;
+
+  //  cell header
+
+  write_record_id (13);  // CELL
+  write ((uint64_t) cell_index);
+
+  reset_modal_variables ();
+
+  if (m_options.write_cblocks) {
+    begin_cblock ();
+  }
+
+  //  context information as property named KLAYOUT_CONTEXT
+  if (m_write_context_info && mp_layout->has_context_info (cell_index)) {
+
+    std::vector <std::string> context_prop_strings;
+
+    if (mp_layout->get_context_info (cell_index, context_prop_strings)) {
+
+      write_record_id (28);
+      write_byte (char (0xf6));
+      uint64_t pnid = 0;
+      std::map <std::string, uint64_t>::const_iterator pni = m_propnames.find (klayout_context_name);
+      if (pni == m_propnames.end ()) {
+        pnid = m_propname_id++;
+        m_propnames.insert (std::make_pair (klayout_context_name, pnid));
+      } else {
+        pnid = pni->second;
+      }
+      write (pnid);
+
+      write ((uint64_t) context_prop_strings.size ());
+
+      for (std::vector <std::string>::const_iterator c = context_prop_strings.begin (); c != context_prop_strings.end (); ++c) {
+        write_byte (14); // b-string by reference number
+        uint64_t psid = 0;
+        std::map <std::string, uint64_t>::const_iterator psi = m_propstrings.find (*c);
+        if (psi == m_propstrings.end ()) {
+          psid = m_propstring_id++;
+          m_propstrings.insert (std::make_pair (*c, psid)).second;
+        } else {
+          psid = psi->second;
+        }
+        write (psid);
+      }
+
+      mm_last_property_name = klayout_context_name;
+      mm_last_property_is_sprop = false;
+      mm_last_value_list.reset ();
+
+    }
+
+  }
+
+  if (cref.prop_id () != 0) {
+    write_props (cref.prop_id ());
+  }
+
+  bool skip_body = m_write_context_info && cref.can_skip_replica ();
+  if (! skip_body) {
+
+    //  instances
+    if (cref.cell_instances () > 0) {
+      write_insts (cell_set);
+    }
+
+    //  shapes
+    for (std::vector <std::pair <unsigned int, db::LayerProperties> >::const_iterator l = layers.begin (); l != layers.end (); ++l) {
+      const db::Shapes &shapes = cref.shapes (l->first);
+      if (! shapes.empty ()) {
+        write_shapes (l->second, shapes);
+        m_progress.set (mp_stream->pos ());
+      }
+    }
+
+  }
+
+  //  end CBLOCK if required
+  if (m_options.write_cblocks) {
+    end_cblock ();
+  }
+
+  //  end of cell
+}
+
+void
+OASISWriter::init_cell_writer (const OASISWriter &master)
+{
+  m_sf = master.m_sf;
+  mp_layout = master.mp_layout;
+  mp_cell = 0;
+  m_layer = m_datatype = 0;
+  m_write_context_info = master.m_write_context_info;
+  m_in_cblock = false;
+  m_cblock_buffer.clear ();
+  m_options = master.m_options;
+
+  m_propname_id = master.m_propname_id;
+  m_propstring_id = master.m_propstring_id;
+  m_textstring_id = master.m_textstring_id;
+  m_proptables_written = master.m_proptables_written;
+
+  m_textstrings = master.m_textstrings;
+  m_propnames = master.m_propnames;
+  m_propstrings = master.m_propstrings;
+  m_cell_nstrings = master.m_cell_nstrings;
+}
+
+bool
+OASISWriter::tables_modified (const OASISWriter &master) const
+{
+  //  new table entries always come with new ID's
+  return m_propname_id != master.m_propname_id ||
+         m_propstring_id != master.m_propstring_id ||
+         m_textstring_id != master.m_textstring_id;
+}
+
+void
+OASISWriter::write_cells_threaded (const std::vector <db::cell_index_type> &cells, const std::set <db::cell_index_type> &cell_set, const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers, std::map<db::cell_index_type, size_t> &cell_positions)
+{
+  std::vector <db::cell_index_type> cells_to_write;
+  cells_to_write.reserve (cells.size ());
+  for (auto c = cells.begin (); c != cells.end (); ++c) {
+    //  skip cell body if the cell is not to be written
+    if (! mp_layout->cell (*c).is_real_ghost_cell ()) {
+      cells_to_write.push_back (*c);
+    }
+  }
+
+  //  shapes loaded on demand are loaded before the workers access the cells
+  mp_layout->load_pending_cells ();
+
+  //  limits the number of cells kept in memory
+  const size_t max_pending = size_t (m_options.threads) * 4;
+
+  OASISCellWriterJob job (m_options.threads, this, cell_set, layers);
+
+  size_t next = 0;
+  bool threaded = true;
+
+  for (size_t i = 0; i < cells_to_write.size (); ++i) {
+
+    db::cell_index_type ci = cells_to_write [i];
+
+    if (threaded) {
+      while (next < cells_to_write.size () && next < i + max_pending) {
+        job.submit (cells_to_write [next++]);
+      }
+    }
+
+    m_progress.set (mp_stream->pos ());
+
+    cell_positions.insert (std::make_pair (ci, mp_stream->pos ()));
+
+    if (i < next) {
+
+      std::unique_ptr<OASISWrittenCell> cell (job.fetch (ci));
+
+      if (! cell->error.empty ()) {
+        throw tl::Exception (cell->error);
+      }
+
+      if (! cell->tables_modified) {
+
+        if (! cell->data.empty ()) {
+          write_bytes (cell->data.data (), cell->data.size ());
+        }
+
+        //  drop the shapes again if they have been loaded on demand in transient mode
+        mp_layout->cell (ci).release_content ();
+
+        continue;
+
+      }
+
+      if (threaded) {
+
+        //  The cell required new table entries, so the following cells need to see them.
+        //  Continue single-threaded from here. The cells already submitted are completed
+        //  before the tables of this writer change. Their results stay valid unless they
+        //  required new table entries too, as the existing table entries do not change.
+        job.wait ();
+        threaded = false;
+
+      }
+
+    }
+
+    write_cell (ci, cell_set, layers);
+
+    //  drop the shapes again if they have been loaded on demand in transient mode
+    mp_layout->cell (ci).release_content ();
+
+  }
+}
+
 void 
 OASISWriter::write (const Repetition &rep)
 {
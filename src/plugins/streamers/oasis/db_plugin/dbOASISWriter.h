@@ -47,6 +47,7 @@ namespace db
 class Layout;
 class SaveLayoutOptions;
 class OASISWriter;
+class OASISCellWriterWorker;
 
 /**
  *  @brief A displacement list compactor
@@ -197,6 +198,8 @@ public:
   void write (const db::Polygon &polygon, db::properties_id_type prop_id, const db::Repetition &rep);
 
 private:
+  friend class OASISCellWriterWorker;
+
   tl::OutputStream *mp_stream;
   double m_sf;
   const db::Layout *mp_layout;
@@ -304,6 +307,11 @@ private:
   void emit_propstring_def (db::properties_id_type prop_id);
   void write_insts (const std::set <db::cell_index_type> &cell_set);
 
+  void write_cell (db::cell_index_type cell_index, const std::set <db::cell_index_type> &cell_set, const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers);
+  void write_cells_threaded (const std::vector <db::cell_index_type> &cells, const std::set <db::cell_index_type> &cell_set, const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers, std::map<db::cell_index_type, size_t> &cell_positions);
+  void init_cell_writer (const OASISWriter &master);
+  bool tables_modified (const OASISWriter &master) const;
+
   void write_shapes (const db::LayerProperties &lprops, const db::Shapes &shapes);
 
   void write_props (db::properties_id_type prop_id);
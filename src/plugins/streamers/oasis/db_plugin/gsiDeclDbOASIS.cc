@@ -53,6 +53,16 @@ static int get_oasis_expect_strict_mode (const db::LoadLayoutOptions *options)
   return options->get_options<db::OASISReaderOptions> ().expect_strict_mode;
 }
 
+static void set_oasis_threads (db::LoadLayoutOptions *options, int n)
+{
+  options->get_options<db::OASISReaderOptions> ().threads = n;
+}
+
+static int get_oasis_threads (const db::LoadLayoutOptions *options)
+{
+  return options->get_options<db::OASISReaderOptions> ().threads;
+}
+
 //  extend lay::LoadLayoutOptions with the OASIS options
 static
 gsi::ClassExt<db::LoadLayoutOptions> oasis_reader_options (
@@ -71,6 +81,20 @@ gsi::ClassExt<db::LoadLayoutOptions> oasis_reader_options (
   gsi::method_ext ("oasis_expect_strict_mode?", &get_oasis_expect_strict_mode,
     //  this method is mainly provided as access point for the generic interface
     "@hide"
+  ) +
+  gsi::method_ext ("oasis_threads=", &set_oasis_threads, gsi::arg ("n"),
+    "@brief Specifies the number of threads to use for decompressing CBLOCKs\n"
+    "If this value is larger than zero, the OASIS reader will decompress CBLOCKs in the given number "
+    "of background threads while reading the file. With a value of 0 (the default), CBLOCKs are decompressed "
+    "in the main thread. The resulting layout does not depend on this setting.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
+  gsi::method_ext ("oasis_threads", &get_oasis_threads,
+    "@brief Gets the number of threads to use for decompressing CBLOCKs\n"
+    "See \\oasis_threads= for details about this property.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
   ),
   ""
 );
@@ -178,6 +202,26 @@ static std::string get_oasis_subst_char (const db::SaveLayoutOptions *options)
   return options->get_options<db::OASISWriterOptions> ().subst_char;
 }
 
+static void set_oasis_writer_threads (db::SaveLayoutOptions *options, int n)
+{
+  options->get_options<db::OASISWriterOptions> ().threads = n;
+}
+
+static int get_oasis_writer_threads (const db::SaveLayoutOptions *options)
+{
+  return options->get_options<db::OASISWriterOptions> ().threads;
+}
+
+static void set_oasis_tables_at_end (db::SaveLayoutOptions *options, bool f)
+{
+  options->get_options<db::OASISWriterOptions> ().tables_at_end = f;
+}
+
+static bool get_oasis_tables_at_end (const db::SaveLayoutOptions *options)
+{
+  return options->get_options<db::OASISWriterOptions> ().tables_at_end;
+}
+
 //  extend lay::SaveLayoutOptions with the OASIS options
 static
 gsi::ClassExt<db::SaveLayoutOptions> oasis_writer_options (
@@ -288,6 +332,37 @@ gsi::ClassExt<db::SaveLayoutOptions> oasis_writer_options (
   gsi::method_ext ("oasis_compression_level", &get_oasis_compression,
     "@brief Get the OASIS compression level\n"
     "See \\oasis_compression_level= method for a description of the OASIS compression level."
+  ) +
+  gsi::method_ext ("oasis_threads=", &set_oasis_writer_threads, gsi::arg ("n"),
+    "@brief Specifies the number of threads to use for writing cells\n"
+    "If this value is larger than zero, the OASIS writer will prepare the cell bodies - including shape array "
+    "formation and CBLOCK compression - in the given number of threads. The cells are written in the same order "
+    "as without threads and the file produced is identical. With a value of 0 (the default), all cells are "
+    "written in the main thread.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
+  gsi::method_ext ("oasis_threads", &get_oasis_writer_threads,
+    "@brief Gets the number of threads to use for writing cells\n"
+    "See \\oasis_threads= for details about this property.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
+  gsi::method_ext ("oasis_tables_at_end=", &set_oasis_tables_at_end, gsi::arg ("flag"),
+    "@brief Specifies whether to write the name tables at the end of the file\n"
+    "By default, the name tables are written at the beginning of the file. To do so, the writer has to "
+    "collect the names from all cells before writing them. If this flag is set, the tables are written at the end "
+    "and the names are collected while the cells are written. This avoids scanning all cells in advance, "
+    "which is beneficial when the shapes are loaded on demand. Writing the tables at the end disables "
+    "multi-threaded writing of cells (see \\oasis_threads=).\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
+  ) +
+  gsi::method_ext ("oasis_tables_at_end?", &get_oasis_tables_at_end,
+    "@brief Gets a value indicating whether to write the name tables at the end of the file\n"
+    "See \\oasis_tables_at_end= for details about this property.\n"
+    "\n"
+    "This attribute has been added in version 0.30.10."
   ),
   ""
 );
@@ -743,3 +743,312 @@ TEST(CBlockLargePropertyString)
 
   }
 }
+
+TEST(ThreadedCBlockInflate)
+{
+  db::Layout layout_org (false);
+
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout_org.insert_layer (db::LayerProperties (2, 0));
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+
+  //  many small cells plus one big cell that spans multiple CBLOCKs
+  for (int c = 0; c < 100; ++c) {
+    db::Cell &cell = layout_org.cell (layout_org.add_cell (("C" + tl::to_string (c)).c_str ()));
+    for (int i = 0; i < 100; ++i) {
+      cell.shapes (l1).insert (db::Box (i * 17 + c, i * 3, i * 17 + c + 10 + i, i * 3 + 5));
+    }
+    cell.shapes (l2).insert (db::Text (("T" + tl::to_string (c)).c_str (), db::Trans (db::Vector (c, -c))));
+    top.insert (db::CellInstArray (db::CellInst (cell.cell_index ()), db::Trans (db::Vector (c * 1000, 0))));
+  }
+
+  for (int i = 0; i < 200000; ++i) {
+    top.shapes (l1).insert (db::Box ((i * 7919) % 100003, (i * 104729) % 99991, (i * 7919) % 100003 + 1 + i % 13, (i * 104729) % 99991 + 1 + i % 7));
+  }
+
+  for (int mode = 0; mode < 3; ++mode) {
+
+    std::string tmp_file = tl::TestBase::tmp_file ("tmp_OASISReaderThreaded.oas");
+
+    {
+      tl::OutputStream out (tmp_file);
+      db::SaveLayoutOptions options;
+      db::OASISWriterOptions &oasis_options = options.get_options<db::OASISWriterOptions> ();
+      oasis_options.write_cblocks = true;
+      oasis_options.strict_mode = (mode != 1);
+      oasis_options.tables_at_end = (mode == 2);
+      db::OASISWriter writer;
+      writer.write (layout_org, out, options);
+    }
+
+    for (int threads = 1; threads <= 4; threads += 3) {
+
+      db::Layout layout_read;
+
+      {
+        db::LoadLayoutOptions options;
+        options.get_options<db::OASISReaderOptions> ().threads = threads;
+        tl::InputStream in (tmp_file);
+        db::OASISReader reader (in);
+        reader.read (layout_read, options);
+      }
+
+      EXPECT_EQ (db::compare_layouts (layout_org, layout_read, db::layout_diff::f_verbose, 0), true);
+
+    }
+
+  }
+}
+
+static size_t
+run_lazy_test (tl::TestBase *_this, const std::string &fn)
+{
+  db::Layout ref_layout;
+
+  {
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (ref_layout);
+  }
+
+  db::LoadLayoutOptions options;
+  options.get_options<db::CommonReaderOptions> ().lazy_loading = true;
+
+  db::Manager m (false);
+  db::Layout layout (&m);
+
+  {
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.set_warnings_as_errors (true);
+    reader.read (layout, options);
+  }
+
+  //  bounding boxes are available before the shapes are loaded
+  layout.update ();
+  ref_layout.update ();
+
+  EXPECT_EQ (layout.cells (), ref_layout.cells ());
+  EXPECT_EQ (layout.layers (), ref_layout.layers ());
+
+  size_t pending = 0;
+  for (auto c = layout.begin (); c != layout.end (); ++c) {
+    if (c->is_content_pending ()) {
+      ++pending;
+    }
+    const db::Cell &ref_cell = ref_layout.cell (c->cell_index ());
+    EXPECT_EQ (c->bbox ().to_string (), ref_cell.bbox ().to_string ());
+    for (unsigned int l = 0; l < ref_layout.layers (); ++l) {
+      EXPECT_EQ (c->bbox (l).to_string (), ref_cell.bbox (l).to_string ());
+    }
+  }
+
+  EXPECT_EQ (db::compare_layouts (ref_layout, layout, db::layout_diff::f_verbose, 0), true);
+
+  for (auto c = layout.begin (); c != layout.end (); ++c) {
+    EXPECT_EQ (c->is_content_pending (), false);
+  }
+
+  return pending;
+}
+
+TEST(LazyLoading)
+{
+  const char *tests[] = {
+    "1.1", "1.2", "1.3", "1.4", "1.5", "10.1", "11.1", "11.2", "11.3", "11.4", "11.5", "11.6", "11.7",
+    "12.1", "13.1", "13.2", "13.3", "13.4", "14.1", "2.1", "2.2", "2.4", "2.6", "2.7", "3.1", "3.10",
+    "3.12", "3.2", "3.5", "3.9", "4.1", "4.2", "5.1", "5.2", "5.3", "6.1", "7.1", "8.1", "8.2", "8.3",
+    "8.4", "8.5", "8.6", "8.7", "8.8", "9.1", "9.2"
+  };
+
+  size_t pending = 0;
+
+  for (size_t i = 0; i < sizeof (tests) / sizeof (tests [0]); ++i) {
+    std::string fn (tl::testdata ());
+    fn += "/oasis/t";
+    fn += tests [i];
+    fn += ".oas";
+    pending += run_lazy_test (_this, fn);
+  }
+
+  EXPECT_NE (pending, size_t (0));
+}
+
+TEST(LazyLoadingWithCBlocks)
+{
+  db::Layout layout_org (false);
+
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout_org.insert_layer (db::LayerProperties (2, 0));
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+
+  db::PropertiesSet ps;
+  ps.insert (tl::Variant ("name"), tl::Variant ("value"));
+  db::properties_id_type pid = db::properties_id (ps);
+
+  for (int c = 0; c < 20; ++c) {
+    db::Cell &cell = layout_org.cell (layout_org.add_cell (("C" + tl::to_string (c)).c_str ()));
+    for (int i = 0; i < 100; ++i) {
+      cell.shapes (l1).insert (db::Box (i * 17 + c, i * 3, i * 17 + c + 10 + i, i * 3 + 5));
+    }
+    cell.shapes (l1).insert (db::BoxWithProperties (db::Box (0, 0, c + 1, c + 2), pid));
+    cell.shapes (l2).insert (db::Text (("T" + tl::to_string (c)).c_str (), db::Trans (db::Vector (c, -c))));
+    top.insert (db::CellInstArray (db::CellInst (cell.cell_index ()), db::Trans (db::Vector (c * 1000, 0)), db::Vector (0, 500), db::Vector (700, 0), 3, 2));
+  }
+
+  for (int mode = 0; mode < 3; ++mode) {
+
+    std::string tmp_file = tl::TestBase::tmp_file ("tmp_OASISReaderLazy.oas");
+
+    {
+      tl::OutputStream out (tmp_file);
+      db::SaveLayoutOptions options;
+      db::OASISWriterOptions &oasis_options = options.get_options<db::OASISWriterOptions> ();
+      oasis_options.write_cblocks = (mode != 1);
+      oasis_options.strict_mode = (mode != 1);
+      oasis_options.tables_at_end = (mode == 2);
+      db::OASISWriter writer;
+      writer.write (layout_org, out, options);
+    }
+
+    EXPECT_EQ (run_lazy_test (_this, tmp_file), size_t (20));
+
+  }
+}
+
+TEST(StreamingConversion)
+{
+  db::Layout layout_org (false);
+
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout_org.insert_layer (db::LayerProperties (2, 0));
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+
+  for (int c = 0; c < 10; ++c) {
+    db::Cell &cell = layout_org.cell (layout_org.add_cell (("C" + tl::to_string (c)).c_str ()));
+    for (int i = 0; i < 100; ++i) {
+      cell.shapes (l1).insert (db::Polygon (db::Box (i * 17 + c, i * 3, i * 17 + c + 10 + i, i * 3 + 5)));
+    }
+    cell.shapes (l2).insert (db::Text (("T" + tl::to_string (c)).c_str (), db::Trans (db::Vector (c, -c))));
+    top.insert (db::CellInstArray (db::CellInst (cell.cell_index ()), db::Trans (db::Vector (c * 1000, 0))));
+  }
+
+  std::string tmp_in = tl::TestBase::tmp_file ("tmp_OASISStreamingIn.oas");
+  std::string tmp_out = tl::TestBase::tmp_file ("tmp_OASISStreamingOut.oas");
+
+  {
+    tl::OutputStream out (tmp_in);
+    db::SaveLayoutOptions options;
+    db::OASISWriter writer;
+    writer.write (layout_org, out, options);
+  }
+
+  db::Layout layout;
+
+  {
+    db::LoadLayoutOptions options;
+    options.get_options<db::CommonReaderOptions> ().lazy_loading = true;
+    tl::InputStream stream (tmp_in);
+    db::Reader reader (stream);
+    reader.read (layout, options);
+  }
+
+  tl_assert (layout.cell_content_loader () != 0);
+  layout.cell_content_loader ()->set_transient (true);
+
+  {
+    tl::OutputStream out (tmp_out);
+    db::SaveLayoutOptions options;
+    options.get_options<db::OASISWriterOptions> ().tables_at_end = true;
+    db::OASISWriter writer;
+    writer.write (layout, out, options);
+  }
+
+  //  the shapes have been released after writing
+  size_t pending = 0;
+  for (auto c = layout.begin (); c != layout.end (); ++c) {
+    if (c->is_content_pending ()) {
+      ++pending;
+    }
+  }
+  EXPECT_EQ (pending, size_t (10));
+
+  db::Layout layout_out;
+
+  {
+    tl::InputStream stream (tmp_out);
+    db::Reader reader (stream);
+    reader.read (layout_out);
+  }
+
+  EXPECT_EQ (db::compare_layouts (layout_org, layout_out, db::layout_diff::f_verbose, 0), true);
+
+  //  released cells are loaded again when needed
+  EXPECT_EQ (db::compare_layouts (layout_org, layout, db::layout_diff::f_verbose, 0), true);
+}
+
+TEST(SaveToLazySource)
+{
+  db::Layout layout_org (false);
+
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+
+  for (int c = 0; c < 10; ++c) {
+    db::Cell &cell = layout_org.cell (layout_org.add_cell (("C" + tl::to_string (c)).c_str ()));
+    for (int i = 0; i < 100; ++i) {
+      cell.shapes (l1).insert (db::Polygon (db::Box (i * 17 + c, i * 3, i * 17 + c + 10 + i, i * 3 + 5)));
+    }
+    top.insert (db::CellInstArray (db::CellInst (cell.cell_index ()), db::Trans (db::Vector (c * 1000, 0))));
+  }
+
+  std::string tmp = tl::TestBase::tmp_file ("tmp_OASISSaveToLazySource.oas");
+
+  {
+    tl::OutputStream out (tmp);
+    db::SaveLayoutOptions options;
+    db::OASISWriter writer;
+    writer.write (layout_org, out, options);
+  }
+
+  db::Layout layout;
+
+  {
+    db::LoadLayoutOptions options;
+    options.get_options<db::CommonReaderOptions> ().lazy_loading = true;
+    tl::InputStream stream (tmp);
+    db::Reader reader (stream);
+    reader.read (layout, options);
+  }
+
+  tl_assert (layout.cell_content_loader () != 0);
+  layout.cell_content_loader ()->set_transient (true);
+
+  //  load and release some cells in transient mode
+  EXPECT_EQ (db::compare_layouts (layout_org, layout, db::layout_diff::f_verbose, 0), true);
+  for (auto c = layout.begin (); c != layout.end (); ++c) {
+    c->release_content ();
+  }
+
+  //  saving to the source file needs to release the file first
+  layout.release_source_file (tmp);
+  EXPECT_EQ (layout.cell_content_loader () == 0, true);
+
+  {
+    tl::OutputStream out (tmp);
+    db::SaveLayoutOptions options;
+    db::OASISWriter writer;
+    writer.write (layout, out, options);
+  }
+
+  db::Layout layout_out;
+
+  {
+    tl::InputStream stream (tmp);
+    db::Reader reader (stream);
+    reader.read (layout_out);
+  }
+
+  EXPECT_EQ (db::compare_layouts (layout_org, layout_out, db::layout_diff::f_verbose, 0), true);
+  EXPECT_EQ (db::compare_layouts (layout_org, layout, db::layout_diff::f_verbose, 0), true);
+}
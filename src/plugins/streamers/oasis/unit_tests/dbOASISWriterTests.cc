@@ -2100,3 +2100,108 @@ TEST(140)
     db::compare_layouts (_this, gg, tl::testdata () + "/oasis/dbOASISWriter40_au.gds", db::NoNormalization);
   }
 }
+
+static std::string
+write_with_threads (tl::TestBase *_this, db::Layout &layout, int threads, bool strict, bool cblocks, int compr)
+{
+  std::string tmp_file = _this->tmp_file (tl::sprintf ("tmp_OASISWriter150_%d.oas", threads));
+
+  {
+    tl::OutputStream out (tmp_file);
+    db::OASISWriterOptions oasis_options;
+    oasis_options.strict_mode = strict;
+    oasis_options.write_cblocks = cblocks;
+    oasis_options.compression_level = compr;
+    oasis_options.write_std_properties = 2;
+    oasis_options.threads = threads;
+    db::SaveLayoutOptions options;
+    options.set_format ("OASIS");
+    options.set_options (oasis_options);
+    db::Writer writer (options);
+    writer.write (layout, out);
+  }
+
+  tl::InputStream in (tmp_file);
+  return in.read_all ();
+}
+
+static void
+run_test150 (tl::TestBase *_this, const char *file)
+{
+  db::Layout layout;
+
+  {
+    tl::InputStream stream (tl::testdata () + "/oasis/" + file);
+    db::Reader reader (stream);
+    reader.read (layout);
+  }
+
+  for (int mode = 0; mode < 8; ++mode) {
+
+    bool strict = (mode & 1) != 0;
+    bool cblocks = (mode & 2) != 0;
+    int compr = (mode & 4) != 0 ? 10 : 0;
+
+    std::string data_single = write_with_threads (_this, layout, 0, strict, cblocks, compr);
+    std::string data_threaded = write_with_threads (_this, layout, 4, strict, cblocks, compr);
+
+    CHECKPOINT ();
+    EXPECT_EQ (data_single.size (), data_threaded.size ());
+    EXPECT_EQ (data_single == data_threaded, true);
+
+  }
+}
+
+//  Threaded writing produces the same output as single-threaded writing
+TEST(150)
+{
+  run_test150 (_this, "t10.1.oas");
+  run_test150 (_this, "t11.1.oas");
+  run_test150 (_this, "t12.1.oas");
+  run_test150 (_this, "t13.1.oas");
+  run_test150 (_this, "t14.1.oas");
+  run_test150 (_this, "pcell_test.gds");
+}
+
+TEST(151)
+{
+  db::Layout layout;
+  unsigned int l1 = layout.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout.insert_layer (db::LayerProperties (2, 0, "L2"));
+
+  db::PropertiesSet ps;
+  ps.insert (tl::Variant ("name"), tl::Variant ("value"));
+  db::properties_id_type pid = db::properties_id (ps);
+
+  db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+
+  for (int i = 0; i < 50; ++i) {
+
+    db::Cell &c = layout.cell (layout.add_cell (tl::sprintf ("C%d", i).c_str ()));
+
+    for (int j = 0; j < 2000; ++j) {
+      c.shapes (l1).insert (db::Box (j * 100, i * 10, j * 100 + 50 + (j % 7), i * 10 + 5));
+      if (j % 13 == 0) {
+        c.shapes (l2).insert (db::PolygonWithProperties (db::Polygon (db::Box (0, 0, j, j + i)), pid));
+      }
+    }
+    c.shapes (l2).insert (db::Text (tl::sprintf ("T%d", i % 5), db::Trans (db::Vector (i, -i))));
+
+    top.insert (db::CellInstArray (db::CellInst (c.cell_index ()), db::Trans (db::Vector (0, i * 1000))));
+
+  }
+
+  for (int mode = 0; mode < 8; ++mode) {
+
+    bool strict = (mode & 1) != 0;
+    bool cblocks = (mode & 2) != 0;
+    int compr = (mode & 4) != 0 ? 10 : 0;
+
+    std::string data_single = write_with_threads (_this, layout, 0, strict, cblocks, compr);
+    std::string data_threaded = write_with_threads (_this, layout, 3, strict, cblocks, compr);
+
+    EXPECT_EQ (data_single.size (), data_threaded.size ());
+    EXPECT_EQ (data_single == data_threaded, true);
+
+  }
+}
@@ -24,6 +24,7 @@
 #include "tlDeflate.h"
 #include "tlException.h"
 #include "tlAssert.h"
+#include "tlThreadedWorkers.h"
 
 #include <algorithm>
 #include <cstring>
@@ -39,10 +40,14 @@ namespace tl
 /**
  *  @brief The decoder for Huffmann codes
  *
- *  The decoder keeps a Huffmann code tree and decodes a value from a bit stream
- *  using this tree. 
- *  As specified by RFC1951, the code tree is constructed from a list of code lengths
+ *  The decoder keeps a Huffmann code table and decodes a value from a bit stream
+ *  using this table. 
+ *  As specified by RFC1951, the code table is constructed from a list of code lengths
  *  vs. value alone.
+ *
+ *  The table is indexed by the next "max_bits" bits of the bit stream (in stream
+ *  order) and delivers the symbol and the code length. Hence a symbol is decoded
+ *  with a single lookup instead of walking the code tree bit by bit.
  */
 class HuffmannDecoder
 {
@@ -50,12 +55,12 @@ public:
   /**
    *  @brief Constructor
    *  
-   *  Creates an empty code tree.
+   *  Creates an empty code table.
    */
   HuffmannDecoder ()
   {
-    mp_codes = 0;
-    mp_bitmasks = 0;
+    mp_table = 0;
+    m_capacity_bits = 0;
     m_max_bits = 0;
     m_num_codes = 0;
   }
@@ -65,26 +70,20 @@ public:
    */
   ~HuffmannDecoder ()
   {
-    if (mp_codes) {
-      delete [] mp_codes;
-    }
-    mp_codes = 0;
-    if (mp_bitmasks) {
-      delete [] mp_bitmasks;
+    if (mp_table) {
+      delete [] mp_table;
     }
-    mp_bitmasks = 0;
+    mp_table = 0;
   }
 
   /**
-   *  @brief Initialize the code tree with the fixed Huffmann code table for literals/lengths
+   *  @brief Initialize the code table with the fixed Huffmann code table for literals/lengths
    *
    *  This table is used by compression mode 1.
    *  It is specified in RFC1951.
    */
   void fill_fixed_table_length ()
   {
-    reserve (9);
-
     unsigned short lengths [288];
     for (unsigned int i = 0; i < 144; ++i) {
       lengths[i] = 8;
@@ -103,15 +102,13 @@ public:
   }
 
   /**
-   *  @brief Initialize the code tree with the fixed Huffmann code table for distances
+   *  @brief Initialize the code table with the fixed Huffmann code table for distances
    *
    *  This table is used by compression mode 1.
    *  It is specified in RFC1951.
    */
   void fill_fixed_table_dist ()
   {
-    reserve (5);
-
     unsigned short lengths [32];
     for (unsigned int i = 0; i < 32; ++i) {
       lengths[i] = 5;
@@ -120,9 +117,9 @@ public:
   }
 
   /**
-   *  @brief Initialize the code tree from a list of lengths
+   *  @brief Initialize the code table from a list of lengths
    *
-   *  This method initializes the code tree from a list of lengths, given 
+   *  This method initializes the code table from a list of lengths, given 
    *  by the sequence [begin_lengths, end_lengths). The codes are assumed to 
    *  range from 0 to distance(begin_lengths, end_lengths).
    *  See RFC1951 for a description about the procedure.
@@ -132,7 +129,6 @@ public:
   {
     const unsigned int MAX_BITS = 16;
     unsigned short bl_count[MAX_BITS + 1];
-    unsigned short bitmasks[MAX_BITS + 1];
     unsigned short next_code[MAX_BITS + 1];
     unsigned int max_bits = 0;
 
@@ -156,21 +152,34 @@ public:
       next_code[bits] = code;
     }
 
-    for (unsigned int bits = 0; bits <= max_bits; bits++) {
-      bitmasks [bits] = ((1 << bits) - 1) << (max_bits - bits);
-    }
-
     reserve (max_bits);
 
+    //  entries with length 0 indicate invalid codes
+    std::memset (mp_table, 0, sizeof (mp_table [0]) * m_num_codes);
+
     unsigned short symbol = 0;
     for (Iter l = begin_lengths; l != end_lengths; ++l, ++symbol) {
-      if (*l > 0) {
-        unsigned int code = next_code [*l]++;
-        code <<= (max_bits - *l);
-        tl_assert (code < (unsigned int) (1 << max_bits));
-        mp_codes [code] = symbol;
-        mp_bitmasks [code] = bitmasks [*l];
+
+      unsigned int n = *l;
+      if (n > 0) {
+
+        unsigned int code = next_code [n]++;
+        tl_assert (code < (unsigned int) (1 << n));
+
+        //  Huffmann codes are stored most significant bit first, so the table index is bit-reversed
+        unsigned int index = 0;
+        for (unsigned int i = 0; i < n; ++i) {
+          index = (index << 1) | ((code >> i) & 1);
+        }
+
+        //  all entries sharing the code as prefix deliver the symbol
+        unsigned short entry = (unsigned short) ((symbol << 4) | n);
+        for ( ; index < m_num_codes; index += (1 << n)) {
+          mp_table [index] = entry;
+        }
+
       } 
+
     }
   }
 
@@ -178,42 +187,48 @@ public:
    *  @brief Decode the next value from a bit stream
    *
    *  This method takes the next value from the bit stream decoding the bits with
-   *  the code tree currently loaded.
+   *  the code table currently loaded.
    */
   unsigned short decode (BitStream &s) const
   {
-    tl_assert (mp_codes != 0);
-
-    unsigned int m = m_num_codes / 2;
-    
-    unsigned int c = 0;
-    do {
-      if (s.get_bit ()) {
-        c |= m;
+    tl_assert (mp_table != 0);
+
+    unsigned int mask = m_num_codes - 1;
+
+    while (true) {
+
+      //  NOTE: bits not read yet are zero. As the codes are prefix-free, the entry is
+      //  valid already if its code length is covered by the bits available.
+      unsigned short entry = mp_table [s.peek_bits () & mask];
+      unsigned int n = entry & 0xf;
+      if (n > 0 && n <= s.available_bits ()) {
+        s.skip_bits (n);
+        return entry >> 4;
       }
-      m >>= 1;
-    } while ((mp_bitmasks [c] & m) != 0);
 
-    return mp_codes [c];
+      if (s.available_bits () >= m_max_bits) {
+        throw tl::Exception (tl::to_string (tr ("Invalid Huffmann code (DEFLATE implementation)")));
+      }
+
+      s.fetch ();
+
+    }
   }
 
 private:
-  unsigned short *mp_codes, *mp_bitmasks;
-  unsigned int m_num_codes, m_max_bits;
+  unsigned short *mp_table;
+  unsigned int m_num_codes, m_max_bits, m_capacity_bits;
 
   void reserve (unsigned int max_bits)
   {
+    m_max_bits = max_bits;
     m_num_codes = 1 << max_bits;
-    if (max_bits > m_max_bits) {
-      m_max_bits = max_bits;
-      if (mp_codes) {
-        delete [] mp_codes;
-      }
-      mp_codes = new unsigned short [m_num_codes];
-      if (mp_bitmasks) {
-        delete [] mp_bitmasks;
+    if (! mp_table || max_bits > m_capacity_bits) {
+      m_capacity_bits = max_bits;
+      if (mp_table) {
+        delete [] mp_table;
       }
-      mp_bitmasks = new unsigned short [m_num_codes];
+      mp_table = new unsigned short [m_num_codes];
     }
   }
 };
@@ -323,8 +338,9 @@ InflateFilter::at_end ()
 void 
 InflateFilter::put_byte (char b) 
 {
+  //  NOTE: m_blen is a power of two
   m_buffer [m_b_insert] = b;
-  m_b_insert = (m_b_insert + 1) % m_blen;
+  m_b_insert = (m_b_insert + 1) & (m_blen - 1);
   //  buffer overrun
   tl_assert (m_b_insert != m_b_read);
 }
@@ -333,7 +349,7 @@ void
 InflateFilter::put_byte_dist (unsigned int d) 
 {
   tl_assert (d < m_blen);
-  put_byte (m_buffer [(m_b_insert + m_blen - d) % m_blen]);
+  put_byte (m_buffer [(m_b_insert + m_blen - d) & (m_blen - 1)]);
 }
 
 bool 
@@ -594,5 +610,346 @@ DeflateFilter::flush ()
   m_finished = true;
 }
 
+
+// ------------------------------------------------------------------------
+//  ThreadedGZipFilter implementation
+
+/**
+ *  @brief Holds one block of data to compress
+ */
+struct ThreadedGZipBlock
+{
+  ThreadedGZipBlock ()
+    : last (false), crc (0), finished (false)
+  { }
+
+  std::string input;
+  std::string dictionary;
+  std::string output;
+  bool last;
+  unsigned long crc;
+  std::string error;
+  bool finished;
+};
+
+/**
+ *  @brief Compresses one block into raw DEFLATE data
+ *
+ *  Non-final blocks are terminated by a sync flush, so they end on a byte boundary
+ *  and can be concatenated with the next block.
+ */
+static void
+throw_zlib_error (z_stream &zs, int err, bool initialized)
+{
+  std::string msg = zs.msg ? std::string (zs.msg) : tl::to_string (err);
+  if (initialized) {
+    deflateEnd (&zs);
+  }
+  throw tl::Exception (tl::to_string (tr ("Compression error (zlib): %s")), msg);
+}
+
+static void
+compress_gzip_block (ThreadedGZipBlock *block)
+{
+  block->crc = crc32 (crc32 (0L, Z_NULL, 0), (const Bytef *) block->input.c_str (), (uInt) block->input.size ());
+
+  z_stream zs;
+  zs.zalloc = (alloc_func)0;
+  zs.zfree = (free_func)0;
+  zs.opaque = (voidpf)0;
+  zs.msg = 0;
+
+  int err = deflateInit2 (&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15 /* == raw deflate data*/, 8 /* == default memory level */, Z_DEFAULT_STRATEGY);
+  if (err != Z_OK) {
+    throw_zlib_error (zs, err, false);
+  }
+
+  if (! block->dictionary.empty ()) {
+    err = deflateSetDictionary (&zs, (const Bytef *) block->dictionary.c_str (), (uInt) block->dictionary.size ());
+    if (err != Z_OK) {
+      throw_zlib_error (zs, err, true);
+    }
+  }
+
+  //  NOTE: the sync flush adds a few bytes to the worst case size
+  block->output.resize (deflateBound (&zs, (uLong) block->input.size ()) + 16);
+
+  zs.next_in = (Bytef *) block->input.c_str ();
+  zs.avail_in = (uInt) block->input.size ();
+  zs.next_out = (Bytef *) &block->output [0];
+  zs.avail_out = (uInt) block->output.size ();
+
+  err = deflate (&zs, block->last ? Z_FINISH : Z_SYNC_FLUSH);
+  if (err != (block->last ? Z_STREAM_END : Z_OK)) {
+    throw_zlib_error (zs, err, true);
+  }
+  if (zs.avail_in != 0 || zs.avail_out == 0) {
+    deflateEnd (&zs);
+    throw tl::Exception (tl::to_string (tr ("Compression error (zlib): output buffer exhausted")));
+  }
+
+  block->output.resize (block->output.size () - zs.avail_out);
+
+  deflateEnd (&zs);
+}
+
+/**
+ *  @brief The task for compressing one block
+ */
+class ThreadedGZipTask
+  : public tl::Task
+{
+public:
+  ThreadedGZipTask (ThreadedGZipBlock *block)
+    : mp_block (block)
+  { }
+
+  ThreadedGZipBlock *block () const
+  {
+    return mp_block;
+  }
+
+private:
+  ThreadedGZipBlock *mp_block;
+};
+
+/**
+ *  @brief The worker compressing blocks
+ */
+class ThreadedGZipWorker
+  : public tl::Worker
+{
+public:
+  ThreadedGZipWorker (ThreadedGZipJob *job)
+    : tl::Worker (), mp_job (job)
+  { }
+
+  virtual void perform_task (tl::Task *task);
+
+private:
+  ThreadedGZipJob *mp_job;
+};
+
+/**
+ *  @brief The job compressing the blocks
+ */
+class ThreadedGZipJob
+  : public tl::JobBase
+{
+public:
+  ThreadedGZipJob (int nworkers)
+    : tl::JobBase (nworkers)
+  {
+    //  .. nothing yet ..
+  }
+
+  ~ThreadedGZipJob ()
+  {
+    //  stop the workers before the blocks are deleted
+    terminate ();
+  }
+
+  /**
+   *  @brief Schedules the given block for being compressed
+   */
+  void submit (ThreadedGZipBlock *block)
+  {
+    schedule (new ThreadedGZipTask (block));
+    if (! is_running ()) {
+      start ();
+    }
+  }
+
+  /**
+   *  @brief Waits until the given block is compressed
+   */
+  void wait_for (ThreadedGZipBlock *block)
+  {
+    m_lock.lock ();
+    while (! block->finished) {
+      m_finished_condition.wait (&m_lock);
+    }
+    m_lock.unlock ();
+  }
+
+  /**
+   *  @brief Called by the workers to indicate that a block is finished
+   */
+  void finish (ThreadedGZipBlock *block)
+  {
+    m_lock.lock ();
+    block->finished = true;
+    m_finished_condition.wakeAll ();
+    m_lock.unlock ();
+  }
+
+protected:
+  virtual tl::Worker *create_worker ()
+  {
+    return new ThreadedGZipWorker (this);
+  }
+
+private:
+  tl::Mutex m_lock;
+  tl::WaitCondition m_finished_condition;
+};
+
+void
+ThreadedGZipWorker::perform_task (tl::Task *task)
+{
+  ThreadedGZipTask *gz_task = dynamic_cast<ThreadedGZipTask *> (task);
+  if (! gz_task) {
+    return;
+  }
+
+  ThreadedGZipBlock *block = gz_task->block ();
+
+  try {
+    compress_gzip_block (block);
+  } catch (tl::Exception &ex) {
+    block->error = ex.msg ();
+  } catch (std::exception &ex) {
+    block->error = ex.what ();
+  } catch (...) {
+    block->error = tl::to_string (tr ("Unspecific error while compressing data"));
+  }
+
+  mp_job->finish (block);
+}
+
+ThreadedGZipFilter::ThreadedGZipFilter (tl::OutputStreamBase &output, int threads, size_t block_size)
+  : mp_output (&output), mp_job (0), m_block_size (std::max (block_size, size_t (65536))),
+    m_max_pending (size_t (std::max (threads, 1)) * 4), m_finished (false), m_uc (0), m_cc (0)
+{
+  m_crc = crc32 (0L, Z_NULL, 0);
+
+  if (threads > 0) {
+    mp_job = new ThreadedGZipJob (threads);
+  }
+
+  //  gzip header: magic, deflate, no flags, no time stamp, no extra flags, OS = Unix
+  static const char header [] = { char (0x1f), char (0x8b), 8, 0, 0, 0, 0, 0, 0, 3 };
+  write (header, sizeof (header));
+}
+
+ThreadedGZipFilter::~ThreadedGZipFilter ()
+{
+  delete mp_job;
+  mp_job = 0;
+
+  for (std::list<ThreadedGZipBlock *>::const_iterator b = m_pending.begin (); b != m_pending.end (); ++b) {
+    delete *b;
+  }
+  m_pending.clear ();
+}
+
+void
+ThreadedGZipFilter::put (const char *b, size_t n)
+{
+  tl_assert (! m_finished);
+
+  m_uc += n;
+
+  while (n > 0) {
+
+    size_t nn = std::min (n, m_block_size - m_block.size ());
+    m_block.append (b, nn);
+    b += nn;
+    n -= nn;
+
+    if (m_block.size () == m_block_size) {
+      submit (false);
+    }
+
+  }
+}
+
+void
+ThreadedGZipFilter::flush ()
+{
+  tl_assert (! m_finished);
+
+  submit (true);
+  while (! m_pending.empty ()) {
+    write_next ();
+  }
+
+  //  gzip trailer: CRC32 and uncompressed size (modulo 2^32), LSB first
+  char trailer [8];
+  for (unsigned int i = 0; i < 4; ++i) {
+    trailer [i] = char ((m_crc >> (i * 8)) & 0xff);
+    trailer [i + 4] = char ((m_uc >> (i * 8)) & 0xff);
+  }
+  write (trailer, sizeof (trailer));
+
+  m_finished = true;
+}
+
+void
+ThreadedGZipFilter::submit (bool last)
+{
+  ThreadedGZipBlock *block = new ThreadedGZipBlock ();
+  block->last = last;
+
+  //  the last 32k of the previous block serve as dictionary
+  if (! m_pending.empty ()) {
+    const std::string &prev = m_pending.back ()->input;
+    size_t nd = std::min (prev.size (), size_t (32768));
+    block->dictionary.assign (prev, prev.size () - nd, nd);
+  } else {
+    block->dictionary.swap (m_dictionary);
+  }
+
+  block->input.swap (m_block);
+  m_block.reserve (m_block_size);
+
+  m_pending.push_back (block);
+
+  if (mp_job) {
+    mp_job->submit (block);
+  } else {
+    compress_gzip_block (block);
+    block->finished = true;
+  }
+
+  while (m_pending.size () > m_max_pending) {
+    write_next ();
+  }
+}
+
+void
+ThreadedGZipFilter::write_next ()
+{
+  ThreadedGZipBlock *block = m_pending.front ();
+  m_pending.pop_front ();
+
+  if (mp_job) {
+    mp_job->wait_for (block);
+  }
+
+  if (! block->error.empty ()) {
+    std::string error = block->error;
+    delete block;
+    throw tl::Exception (error);
+  }
+
+  if (m_pending.empty ()) {
+    //  keep the dictionary for the next block
+    size_t nd = std::min (block->input.size (), size_t (32768));
+    m_dictionary.assign (block->input, block->input.size () - nd, nd);
+  }
+
+  m_crc = crc32_combine (m_crc, block->crc, (z_off_t) block->input.size ());
+  write (block->output.c_str (), block->output.size ());
+
+  delete block;
+}
+
+void
+ThreadedGZipFilter::write (const char *b, size_t n)
+{
+  m_cc += n;
+  mp_output->write (b, n);
+}
 }
 
@@ -29,6 +29,9 @@
 #include "tlStream.h"
 #include "tlException.h"
 
+#include <list>
+#include <string>
+
 //  forware definition of the zlib stream structure - we can omit the zlib header here
 struct z_stream_s;
 
@@ -43,6 +46,11 @@ class HuffmannDecoder;
  *  This filter reads bytes from a tl::Stream and delivers bits, taken from
  *  these bytes. The bits are delivered in the order specified by the DEFLATE
  *  format specification (least significant bit first).
+ *
+ *  The bits are collected in a small bit buffer which allows looking at 
+ *  multiple bits at once (see "peek_bits"). Bytes are taken from the input
+ *  only if required, so the bit stream never reads past the end of the 
+ *  DEFLATE data.
  */
 class TL_PUBLIC BitStream
 {
@@ -54,7 +62,7 @@ public:
    */
   BitStream (tl::InputStream &input)
     : mp_input (&input),
-      m_mask (0), m_byte (0)
+      m_bits (0), m_nbits (0)
   {
     // ...
   }
@@ -62,17 +70,20 @@ public:
   /**
    *  @brief Get a byte
    *
-   *  This method simply passes the byte.
+   *  This method skips the bits up to the next byte boundary and
+   *  delivers the next byte.
    *  The method expects the next byte to be available.
    */
   unsigned char get_byte ()
   {
-    m_mask = 0;
-    const char *c = mp_input->get (1, true /*bypass_deflate*/);
-    if (c == 0) {
-      throw tl::Exception (tl::to_string (tr ("Unexpected end of file (DEFLATE implementation)")));
+    skip_to_byte ();
+    if (m_nbits > 0) {
+      unsigned char c = (unsigned char) m_bits;
+      skip_bits (8);
+      return c;
+    } else {
+      return fetch_byte ();
     }
-    return *c;
   }
 
   /**
@@ -83,12 +94,11 @@ public:
    */
   bool get_bit ()
   {
-    if (m_mask == 0) {
-      m_byte = get_byte ();
-      m_mask = 0x01;
+    if (m_nbits == 0) {
+      fetch ();
     } 
-    bool b = ((m_byte & m_mask) != 0);
-    m_mask <<= 1;
+    bool b = ((m_bits & 1) != 0);
+    skip_bits (1);
     return b;
   }
 
@@ -98,16 +108,15 @@ public:
    *  This method gets the next n bits and delivers them as a single unsigned int,
    *  packing the first bit into the least signification bit. This is the specification
    *  for reading multiple bit values except Huffmann codes.
+   *  n must not be larger than 16.
    */
   unsigned int get_bits (unsigned int n)
   {
-    //  KLUDGE: take directly from the byte for performance.
-    unsigned int r = 0;
-    unsigned int m = 1;
-    while (n-- > 0) {
-      r |= get_bit () ? m : 0;
-      m <<= 1;
+    while (m_nbits < n) {
+      fetch ();
     }
+    unsigned int r = m_bits & ((1u << n) - 1);
+    skip_bits (n);
     return r;
   }
 
@@ -116,13 +125,61 @@ public:
    */
   void skip_to_byte ()
   {
-    m_mask = 0;
+    skip_bits (m_nbits % 8);
+  }
+
+  /**
+   *  @brief Gets the bits available in the bit buffer without consuming them
+   *
+   *  The next bit is the least significant one. Only the lower "available_bits" bits
+   *  are valid, the remaining ones are zero.
+   */
+  unsigned int peek_bits () const
+  {
+    return m_bits;
+  }
+
+  /**
+   *  @brief Gets the number of bits available in the bit buffer
+   */
+  unsigned int available_bits () const
+  {
+    return m_nbits;
+  }
+
+  /**
+   *  @brief Consumes the given number of bits from the bit buffer
+   *
+   *  n must not be larger than the number of bits available.
+   */
+  void skip_bits (unsigned int n)
+  {
+    m_bits >>= n;
+    m_nbits -= n;
+  }
+
+  /**
+   *  @brief Fetches the next byte from the input into the bit buffer
+   */
+  void fetch ()
+  {
+    m_bits |= (unsigned int) fetch_byte () << m_nbits;
+    m_nbits += 8;
   }
 
 private:
   tl::InputStream *mp_input;
-  unsigned char m_mask;
-  unsigned char m_byte;
+  unsigned int m_bits;
+  unsigned int m_nbits;
+
+  unsigned char fetch_byte ()
+  {
+    const char *c = mp_input->get (1, true /*bypass_deflate*/);
+    if (c == 0) {
+      throw tl::Exception (tl::to_string (tr ("Unexpected end of file (DEFLATE implementation)")));
+    }
+    return (unsigned char) *c;
+  }
 };
 
 
@@ -186,6 +243,84 @@ private:
   size_t m_uc, m_cc;
 };
 
+class ThreadedGZipJob;
+struct ThreadedGZipBlock;
+
+/**
+ *  @brief A multi-threaded gzip compressor
+ *
+ *  This filter produces a gzip stream on the given output delegate. The data is cut
+ *  into blocks which are compressed in parallel by a number of worker threads.
+ *  Each block is compressed with the last 32k bytes of the previous block as 
+ *  dictionary, hence the compression ratio is very close to the single-threaded one.
+ *  The blocks are terminated with a sync flush and concatenated, so the result is a
+ *  standard gzip stream.
+ */
+class TL_PUBLIC ThreadedGZipFilter
+{
+public:
+  /**
+   *  @brief Constructor: creates a filter in front of the output delegate
+   *
+   *  @param output The output delegate to write the gzip stream to
+   *  @param threads The number of threads to use (0 for compressing in the calling thread)
+   *  @param block_size The size of the uncompressed blocks
+   */
+  ThreadedGZipFilter (tl::OutputStreamBase &output, int threads, size_t block_size = 128 * 1024);
+
+  /**
+   *  @brief Destructor
+   *
+   *  Like for DeflateFilter, this method will not flush the stream. flush() has to 
+   *  be called explicitly.
+   */
+  ~ThreadedGZipFilter ();
+
+  /**
+   *  @brief Outputs a series of bytes into the compressed stream
+   */
+  void put (const char *b, size_t n);
+
+  /**
+   *  @brief Compresses the remaining bytes and writes the gzip trailer
+   *
+   *  Note: this method must be called always before the filter is destroyed. 
+   *  No more bytes can be put after the stream has been flushed.
+   */
+  void flush ();
+
+  /**
+   *  @brief Get the uncompressed count collected so far
+   */
+  size_t uncompressed () const
+  {
+    return m_uc;
+  }
+
+  /**
+   *  @brief Get the compressed count written so far
+   */
+  size_t compressed () const
+  {
+    return m_cc;
+  }
+
+private:
+  tl::OutputStreamBase *mp_output;
+  ThreadedGZipJob *mp_job;
+  std::list<ThreadedGZipBlock *> m_pending;
+  std::string m_block, m_dictionary;
+  size_t m_block_size;
+  size_t m_max_pending;
+  unsigned long m_crc;
+  bool m_finished;
+  size_t m_uc, m_cc;
+
+  void submit (bool last);
+  void write_next ();
+  void write (const char *b, size_t n);
+};
+
 /**
  *  @brief The DEFLATE decompression (inflating) filter
  *
@@ -501,6 +501,11 @@ public:
     return new LessExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -551,6 +556,11 @@ public:
     return new LessOrEqualExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -601,6 +611,11 @@ public:
     return new GreaterExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -651,6 +666,11 @@ public:
     return new GreaterOrEqualExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -701,6 +721,11 @@ public:
     return new EqualExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -751,6 +776,11 @@ public:
     return new NotEqualExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -948,6 +978,11 @@ public:
     return new LogAndExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     m_c[0]->execute (v);
@@ -990,6 +1025,11 @@ public:
     return new LogOrExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     m_c[0]->execute (v);
@@ -1032,6 +1072,11 @@ public:
     return new IfExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     m_c[0]->execute (v);
@@ -1069,6 +1114,11 @@ public:
     return new ShiftLeftExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1125,6 +1175,11 @@ public:
     return new ShiftRightExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1181,6 +1236,11 @@ public:
     return new PlusExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1243,6 +1303,11 @@ public:
     return new MinusExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1303,6 +1368,11 @@ public:
     return new StarExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1393,6 +1463,11 @@ public:
     return new SlashExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1477,6 +1552,11 @@ public:
     return new PercentExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1549,6 +1629,11 @@ public:
     return new AmpersandExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1605,6 +1690,11 @@ public:
     return new PipeExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1661,6 +1751,11 @@ public:
     return new AcuteExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     EvalTarget b;
@@ -1798,6 +1893,11 @@ public:
     return new UnaryMinusExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     m_c[0]->execute (v);
@@ -1855,6 +1955,11 @@ public:
     return new UnaryTildeExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     m_c[0]->execute (v);
@@ -1910,6 +2015,11 @@ public:
     return new UnaryNotExpressionNode (*this, expr);
   }
 
+  bool is_pure () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     m_c[0]->execute (v);
@@ -1947,6 +2057,12 @@ public:
     return new ConstantExpressionNode (*this, expr);
   }
 
+  bool is_constant () const
+  {
+    //  user objects may be modified, so they are not considered constants
+    return ! m_value.is_user ();
+  }
+
   void execute (EvalTarget &v) const 
   {
     v.set (m_value);
@@ -2287,6 +2403,46 @@ private:
   tl::Variant *mp_var;
 };
 
+// ----------------------------------------------------------------------------
+//  Constant folding
+
+void
+ExpressionNode::fold_constants ()
+{
+  for (std::vector <ExpressionNode *>::iterator c = m_c.begin (); c != m_c.end (); ++c) {
+    (*c)->fold_constants ();
+    ExpressionNode *f = (*c)->folded ();
+    if (f) {
+      f->set_name ((*c)->name ());
+      delete *c;
+      *c = f;
+    }
+  }
+}
+
+ExpressionNode *
+ExpressionNode::folded () const
+{
+  if (! is_pure ()) {
+    return 0;
+  }
+
+  for (std::vector <ExpressionNode *>::const_iterator c = m_c.begin (); c != m_c.end (); ++c) {
+    if (! (*c)->is_constant ()) {
+      return 0;
+    }
+  }
+
+  try {
+    EvalTarget v;
+    execute (v);
+    return new ConstantExpressionNode (m_context, v.make_result ());
+  } catch (tl::Exception &) {
+    //  errors are reported when the expression is executed
+    return 0;
+  }
+}
+
 // ----------------------------------------------------------------------------
 //  Implementation of functions
 
@@ -3161,6 +3317,18 @@ Expression::execute (EvalTarget &v) const
   } 
 }
 
+void
+Expression::optimize ()
+{
+  if (m_root.get ()) {
+    m_root->fold_constants ();
+    ExpressionNode *f = m_root->folded ();
+    if (f) {
+      m_root.reset (f);
+    }
+  }
+}
+
 // ----------------------------------------------------------------------------
 //  Implementation of Eval
 
@@ -3192,6 +3360,14 @@ Eval::set_var (const std::string &name, const tl::Variant &var)
   m_local_vars.insert (std::make_pair (name, tl::Variant ())).first->second = var;
 }
 
+void
+Eval::reset_vars ()
+{
+  for (std::map<std::string, tl::Variant>::iterator v = m_local_vars.begin (); v != m_local_vars.end (); ++v) {
+    v->second.reset ();
+  }
+}
+
 tl::Variant *
 Eval::var (const std::string &name)
 {
@@ -216,6 +216,37 @@ public:
    */
   virtual ExpressionNode *clone (const tl::Expression *expr) const = 0;
 
+  /**
+   *  @brief Returns true, if the node delivers a constant value
+   */
+  virtual bool is_constant () const
+  {
+    return false;
+  }
+
+  /**
+   *  @brief Returns true, if the node's value only depends on the values of the child nodes
+   *
+   *  Such nodes do not have side effects and can be replaced by a constant if all child
+   *  nodes are constants.
+   */
+  virtual bool is_pure () const
+  {
+    return false;
+  }
+
+  /**
+   *  @brief Replaces the child nodes by constants where possible
+   */
+  void fold_constants ();
+
+  /**
+   *  @brief Creates a constant node from this node if it can be folded into a constant
+   *
+   *  Returns 0 if the node cannot be folded.
+   */
+  ExpressionNode *folded () const;
+
 protected:
   std::vector <ExpressionNode *> m_c;
   ExpressionParserContext m_context;
@@ -328,6 +359,15 @@ public:
    */
   void execute (EvalTarget &v) const;
 
+  /**
+   *  @brief Optimizes the expression for repeated execution
+   *
+   *  This method replaces sub-expressions which are made from constants only
+   *  by their values. Expressions which are executed many times - e.g. once per
+   *  tile in the tiling processor - benefit from this step.
+   */
+  void optimize ();
+
   /**
    *  @brief Gets the text of the expression
    */
@@ -467,6 +507,15 @@ public:
    */
   void set_var (const std::string &name, const tl::Variant &var);
 
+  /**
+   *  @brief Resets the values of all local variables to nil
+   *
+   *  The variables stay defined, so expressions parsed in this context remain valid.
+   *  This method is useful to prepare the context for another execution of the same
+   *  expression.
+   */
+  void reset_vars ();
+
   /**
    *  @brief Gets the function for the given name
    *  Returns 0 if there is no such function.
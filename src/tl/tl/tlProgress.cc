@@ -50,7 +50,9 @@ void
 ProgressAdaptor::register_object (Progress *progress)
 {
   bool cancelled = ! mp_objects.empty () && mp_objects.first ()->break_scheduled ();
-  mp_objects.push_back (progress); // this keeps the outmost one visible. push_front would make the latest one visible.
+  //  NOTE: the adaptor does not own the progress objects - they are only linked. Otherwise they
+  //  would be deleted when the adaptor goes away (e.g. when a worker thread ends) while still alive.
+  mp_objects.push_back (*progress); // this keeps the outmost one visible. push_front would make the latest one visible.
   if (cancelled) {
     progress->signal_break ();
   }
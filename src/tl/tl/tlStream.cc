@@ -28,10 +28,13 @@
 #include <stdio.h>
 #include <errno.h>
 #include <zlib.h>
+#include <limits>
 #ifdef _WIN32 
 #  include <io.h>
+#  include <windows.h>
 #else
 #  include <unistd.h>
+#  include <sys/mman.h>
 #endif
 
 #include "tlStream.h"
@@ -47,6 +50,7 @@
 #include "tlUri.h"
 #include "tlHttpStream.h"
 #include "tlGlobPattern.h"
+#include "tlEnv.h"
 
 #if defined(HAVE_QT)
 #  include <QByteArray>
@@ -297,8 +301,22 @@ public:
 
 }
 
+static InputStreamBase *open_local_file (const std::string &path)
+{
+  if (InputMappedFile::is_mappable (path)) {
+    try {
+      return new InputMappedFile (path);
+    } catch (tl::Exception &) {
+      //  mapping may fail on some file systems or for lack of address space:
+      //  fall back to regular reading below
+    }
+  }
+
+  return new InputZLibFile (path);
+}
+
 InputStream::InputStream (InputStreamBase &delegate)
-  : m_pos (0), mp_bptr (0), mp_delegate (&delegate), m_owns_delegate (false), mp_inflate (0), m_inflate_always (false), m_stop_after_inflate (false)
+  : m_pos (0), mp_bptr (0), mp_delegate (&delegate), m_owns_delegate (false), mp_inflate (0), m_inflate_always (false), m_stop_after_inflate (false), m_inflated_pos (0), mp_block (0), m_block_size (0)
 { 
   m_bcap = 4096; // initial buffer capacity
   m_blen = 0;
@@ -306,10 +324,12 @@ InputStream::InputStream (InputStreamBase &delegate)
 
   m_explicit_suffix = false;
   m_suffix = tl::extension (delegate.filename ());
+
+  init_memory_block ();
 }
 
 InputStream::InputStream (InputStreamBase *delegate)
-  : m_pos (0), mp_bptr (0), mp_delegate (delegate), m_owns_delegate (true), mp_inflate (0), m_inflate_always (false), m_stop_after_inflate (false)
+  : m_pos (0), mp_bptr (0), mp_delegate (delegate), m_owns_delegate (true), mp_inflate (0), m_inflate_always (false), m_stop_after_inflate (false), m_inflated_pos (0), mp_block (0), m_block_size (0)
 {
   m_bcap = 4096; // initial buffer capacity
   m_blen = 0;
@@ -319,10 +339,12 @@ InputStream::InputStream (InputStreamBase *delegate)
   if (delegate) {
     m_suffix = tl::extension (delegate->filename ());
   }
+
+  init_memory_block ();
 }
 
 InputStream::InputStream (const std::string &abstract_path_in, bool allow_explicit_suffix)
-  : m_pos (0), mp_bptr (0), mp_delegate (0), m_owns_delegate (false), mp_inflate (0), m_inflate_always (false), m_stop_after_inflate (false)
+  : m_pos (0), mp_bptr (0), mp_delegate (0), m_owns_delegate (false), mp_inflate (0), m_inflate_always (false), m_stop_after_inflate (false), m_inflated_pos (0), mp_block (0), m_block_size (0)
 { 
   m_bcap = 4096; // initial buffer capacity
   m_blen = 0;
@@ -412,11 +434,11 @@ InputStream::InputStream (const std::string &abstract_path_in, bool allow_explic
       throw tl::Exception (tl::to_string (tr ("HTTP support not enabled - HTTP/HTTPS paths are not available")));
 #endif
     } else if (uri.scheme () == "file") {
-      mp_delegate = new InputZLibFile (uri.path ());
+      mp_delegate = open_local_file (uri.path ());
     } else if (! uri.scheme ().empty ()) {
       throw tl::Exception (tl::to_string (tr ("URI scheme not supported: ")) + uri.scheme ());
     } else {
-      mp_delegate = new InputZLibFile (abstract_path);
+      mp_delegate = open_local_file (abstract_path);
     }
 
   }
@@ -431,11 +453,34 @@ InputStream::InputStream (const std::string &abstract_path_in, bool allow_explic
     m_suffix = tl::extension (mp_delegate->filename ());
   }
 
+  init_memory_block ();
+
   if (needs_inflate) {
     inflate_always ();
   }
 }
 
+void
+InputStream::init_memory_block ()
+{
+  mp_block = 0;
+  m_block_size = 0;
+
+  if (! mp_delegate || m_blen > 0) {
+    return;
+  }
+
+  size_t size = 0;
+  const char *block = mp_delegate->memory_block (size);
+  if (block && size > 0) {
+    //  deliver the data directly from the delegate's memory block
+    mp_block = block;
+    m_block_size = size;
+    mp_bptr = mp_block;
+    m_blen = m_block_size;
+  }
+}
+
 InputStream::~InputStream ()
 {
   if (mp_delegate && m_owns_delegate) {
@@ -593,7 +638,27 @@ InputStream::get (size_t n, bool bypass_inflate)
     }
   }
 
-  if (m_blen < n) {
+  //  deliver data from a block inflated already
+  if (! m_inflated.empty () && ! bypass_inflate) {
+    if (m_inflated_pos < m_inflated.size ()) {
+
+      if (m_inflated_pos + n > m_inflated.size ()) {
+        //  records must not extend beyond the compressed block
+        return 0;
+      }
+
+      const char *r = m_inflated.data () + m_inflated_pos;
+      m_inflated_pos += n;
+      return r;
+
+    } else {
+      m_inflated.clear ();
+      m_inflated_pos = 0;
+    }
+  }
+
+  //  NOTE: with a memory block, all data is available already
+  if (m_blen < n && ! mp_block) {
 
     //  to keep move activity low, allocate twice as much as required
     if (m_bcap < n * 2) {
@@ -642,8 +707,11 @@ InputStream::unget (size_t n)
     //  TODO: this will not work if mp_inflate just got destroyed
     //  (no unget into previous compressed block)
     mp_inflate->unget (n);
+  } else if (! m_inflated.empty ()) {
+    tl_assert (m_inflated_pos >= n);
+    m_inflated_pos -= n;
   } else {
-    tl_assert (mp_buffer + n <= mp_bptr);
+    tl_assert ((mp_block ? mp_block : mp_buffer) + n <= mp_bptr);
     mp_bptr -= n;
     m_blen += n;
     m_pos -= n;
@@ -655,7 +723,7 @@ InputStream::read_all (size_t max_count)
 {
   std::string str;
 
-  if (mp_inflate) {
+  if (mp_inflate || ! m_inflated.empty ()) {
 
     //  Inflate is special - it does not have a guaranteed byte delivery, so we have to go the
     //  hard way and pick the file byte by byte
@@ -692,7 +760,7 @@ InputStream::read_all ()
 {
   std::string str;
 
-  if (mp_inflate) {
+  if (mp_inflate || ! m_inflated.empty ()) {
 
     //  Inflate is special - it does not have a guaranteed byte delivery, so we have to go the
     //  hard way and pick the file byte by byte
@@ -724,6 +792,14 @@ InputStream::read_all ()
 
 void InputStream::copy_to (tl::OutputStream &os)
 {
+  if (mp_block) {
+    os.put (mp_bptr, m_blen);
+    mp_bptr += m_blen;
+    m_pos += m_blen;
+    m_blen = 0;
+    return;
+  }
+
   const size_t chunk = 65536;
   char b [chunk];
   size_t read;
@@ -740,6 +816,15 @@ InputStream::inflate (bool stop_after)
   m_stop_after_inflate = stop_after;
 }
 
+void
+InputStream::put_inflated (std::vector<char> &data)
+{
+  tl_assert (mp_inflate == 0);
+  m_inflated.clear ();
+  m_inflated.swap (data);
+  m_inflated_pos = 0;
+}
+
 void
 InputStream::inflate_always ()
 {
@@ -747,9 +832,60 @@ InputStream::inflate_always ()
   reset ();
 }
 
+bool
+InputStream::is_random_access () const
+{
+  return mp_block != 0 && ! m_inflate_always;
+}
+
+void
+InputStream::seek (size_t pos)
+{
+  if (mp_inflate) {
+    delete mp_inflate;
+    mp_inflate = 0;
+  }
+
+  m_inflated.clear ();
+  m_inflated_pos = 0;
+
+  if (mp_block && ! m_inflate_always) {
+
+    if (pos > m_block_size) {
+      throw tl::Exception (tl::to_string (tr ("Stream position %ld is beyond the end of the stream: %s")), long (pos), source ());
+    }
+
+    mp_bptr = mp_block + pos;
+    m_blen = m_block_size - pos;
+    m_pos = pos;
+
+  } else {
+
+    if (pos < m_pos) {
+      reset ();
+    }
+
+    const size_t chunk = 65536;
+    while (m_pos < pos) {
+      if (! get (std::min (chunk, pos - m_pos), true)) {
+        throw tl::Exception (tl::to_string (tr ("Stream position %ld is beyond the end of the stream: %s")), long (pos), source ());
+      }
+    }
+
+  }
+}
+
 void
 InputStream::close ()
 {
+  if (mp_block) {
+    //  the memory block becomes invalid when the delegate is closed
+    mp_block = 0;
+    m_block_size = 0;
+    mp_bptr = mp_buffer;
+    m_blen = 0;
+  }
+
   if (mp_delegate) {
     mp_delegate->close ();
   }
@@ -764,9 +900,20 @@ InputStream::reset ()
     mp_inflate = 0;
   } 
 
-  //  optimize for a reset in the first m_bcap bytes
-  //  -> this reduces the reset calls on mp_delegate which may not support this
-  if (m_pos < m_bcap) {
+  m_inflated.clear ();
+  m_inflated_pos = 0;
+
+  if (mp_block) {
+
+    //  memory blocks are rewound without involving the delegate
+    mp_bptr = mp_block;
+    m_blen = m_block_size;
+    m_pos = 0;
+
+  } else if (m_pos < m_bcap) {
+
+    //  optimize for a reset in the first m_bcap bytes
+    //  -> this reduces the reset calls on mp_delegate which may not support this
 
     m_blen += m_pos;
     mp_bptr = mp_buffer;
@@ -1076,6 +1223,198 @@ InputZLibFile::filename () const
   return tl::filename (m_source);
 }
 
+// ---------------------------------------------------------------
+//  InputMappedFile implementation
+
+InputMappedFile::InputMappedFile (const std::string &path)
+  : mp_data (0), m_size (0), m_pos (0)
+#if defined(_WIN32)
+    , mp_file_handle (0), mp_mapping_handle (0)
+#endif
+{
+  m_source = path;
+  std::string source = tl::absolute_file_path (path);
+
+#if defined(_WIN32)
+
+  HANDLE fh = CreateFileW (tl::to_wstring (source).c_str (), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (fh == INVALID_HANDLE_VALUE) {
+    throw FileOpenErrorException (source, int (GetLastError ()));
+  }
+  mp_file_handle = (void *) fh;
+
+  LARGE_INTEGER fs;
+  if (! GetFileSizeEx (fh, &fs)) {
+    int err = int (GetLastError ());
+    close ();
+    throw FileOpenErrorException (source, err);
+  }
+  m_size = size_t (fs.QuadPart);
+
+  if (m_size > 0) {
+
+    HANDLE mh = CreateFileMappingW (fh, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mh == NULL) {
+      int err = int (GetLastError ());
+      close ();
+      throw FileOpenErrorException (source, err);
+    }
+    mp_mapping_handle = (void *) mh;
+
+    mp_data = (const char *) MapViewOfFile (mh, FILE_MAP_READ, 0, 0, 0);
+    if (! mp_data) {
+      int err = int (GetLastError ());
+      close ();
+      throw FileOpenErrorException (source, err);
+    }
+
+  }
+
+#else
+
+  int fd = open (tl::string_to_system (source).c_str (), O_RDONLY);
+  if (fd < 0) {
+    throw FileOpenErrorException (source, errno);
+  }
+
+  struct stat st;
+  if (fstat (fd, &st) != 0) {
+    int err = errno;
+    ::close (fd);
+    throw FileOpenErrorException (source, err);
+  }
+  m_size = size_t (st.st_size);
+
+  if (m_size > 0) {
+
+    void *data = mmap (0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      int err = errno;
+      ::close (fd);
+      m_size = 0;
+      throw FileOpenErrorException (source, err);
+    }
+
+#if defined(MADV_SEQUENTIAL)
+    madvise (data, m_size, MADV_SEQUENTIAL);
+#endif
+
+    mp_data = (const char *) data;
+
+  }
+
+  //  the mapping stays valid after the file descriptor has been closed
+  ::close (fd);
+
+#endif
+}
+
+InputMappedFile::~InputMappedFile ()
+{
+  close ();
+}
+
+void
+InputMappedFile::close ()
+{
+#if defined(_WIN32)
+  if (mp_data) {
+    UnmapViewOfFile ((LPCVOID) mp_data);
+  }
+  if (mp_mapping_handle) {
+    CloseHandle ((HANDLE) mp_mapping_handle);
+    mp_mapping_handle = 0;
+  }
+  if (mp_file_handle) {
+    CloseHandle ((HANDLE) mp_file_handle);
+    mp_file_handle = 0;
+  }
+#else
+  if (mp_data) {
+    munmap ((void *) mp_data, m_size);
+  }
+#endif
+
+  mp_data = 0;
+  m_size = 0;
+  m_pos = 0;
+}
+
+size_t
+InputMappedFile::read (char *b, size_t n)
+{
+  n = std::min (n, m_size - m_pos);
+  if (n > 0) {
+    memcpy (b, mp_data + m_pos, n);
+    m_pos += n;
+  }
+  return n;
+}
+
+void
+InputMappedFile::reset ()
+{
+  m_pos = 0;
+}
+
+std::string
+InputMappedFile::absolute_path () const
+{
+  return tl::absolute_file_path (m_source);
+}
+
+std::string
+InputMappedFile::filename () const
+{
+  return tl::filename (m_source);
+}
+
+bool
+InputMappedFile::is_mappable (const std::string &path)
+{
+  static int no_mmap = -1;
+  if (no_mmap < 0) {
+    no_mmap = tl::app_flag ("no-mmap") ? 1 : 0;
+  }
+  if (no_mmap) {
+    return false;
+  }
+
+  std::string source = tl::absolute_file_path (path);
+
+  //  only regular, non-empty files are mapped
+#if defined(_WIN32)
+  struct _stat64 st;
+  if (_wstat64 (tl::to_wstring (source).c_str (), &st) != 0 || (st.st_mode & _S_IFREG) == 0 || st.st_size == 0) {
+    return false;
+  }
+#else
+  struct stat st;
+  if (stat (tl::string_to_system (source).c_str (), &st) != 0 || ! S_ISREG (st.st_mode) || st.st_size == 0) {
+    return false;
+  }
+  if (sizeof (size_t) < sizeof (st.st_size) && st.st_size > (off_t) std::numeric_limits<size_t>::max ()) {
+    return false;
+  }
+#endif
+
+  //  gzip-compressed files are handled by InputZLibFile
+  unsigned char magic [2] = { 0, 0 };
+  FILE *f = 0;
+#if defined(_WIN32)
+  f = _wfopen (tl::to_wstring (source).c_str (), L"rb");
+#else
+  f = fopen (tl::string_to_system (source).c_str (), "rb");
+#endif
+  if (! f) {
+    return false;
+  }
+  size_t nread = fread (magic, 1, sizeof (magic), f);
+  fclose (f);
+
+  return ! (nread == 2 && magic [0] == 0x1f && magic [1] == 0x8b);
+}
+
 // ---------------------------------------------------------------
 //  OutputStream implementation
 
@@ -1110,16 +1449,18 @@ OutputStream::output_mode_from_filename (const std::string &abstract_path, Outpu
 }
 
 static
-OutputStreamBase *create_file_stream (const std::string &path, OutputStream::OutputStreamMode om, int keep_backups)
+OutputStreamBase *create_file_stream (const std::string &path, OutputStream::OutputStreamMode om, int keep_backups, int compression_threads)
 {
-  if (om == OutputStream::OM_Zlib) {
+  if (om == OutputStream::OM_Zlib && compression_threads > 0) {
+    return new OutputThreadedZLibFile (path, keep_backups, compression_threads);
+  } else if (om == OutputStream::OM_Zlib) {
     return new OutputZLibFile (path, keep_backups);
   } else {
     return new OutputFile (path, keep_backups);
   }
 }
 
-OutputStream::OutputStream (const std::string &abstract_path, OutputStreamMode om, bool as_text, int keep_backups)
+OutputStream::OutputStream (const std::string &abstract_path, OutputStreamMode om, bool as_text, int keep_backups, int compression_threads)
   : m_pos (0), mp_delegate (0), m_owns_delegate (false), m_as_text (as_text), m_path (abstract_path)
 {
   //  Determine output mode
@@ -1131,9 +1472,9 @@ OutputStream::OutputStream (const std::string &abstract_path, OutputStreamMode o
   } else if (ex.test ("pipe:")) {
     mp_delegate = new OutputPipe (ex.get ());
   } else if (ex.test ("file:")) {
-    mp_delegate = create_file_stream (ex.get (), om, keep_backups);
+    mp_delegate = create_file_stream (ex.get (), om, keep_backups, compression_threads);
   } else {
-    mp_delegate = create_file_stream (abstract_path, om, keep_backups);
+    mp_delegate = create_file_stream (abstract_path, om, keep_backups, compression_threads);
   }
 
   m_owns_delegate = true;
@@ -1510,6 +1851,66 @@ OutputZLibFile::write_file (const char *b, size_t n)
   }
 }
 
+// ---------------------------------------------------------------
+//  OutputThreadedZLibFile implementation
+
+/**
+ *  @brief Delivers the compressed data to the file
+ */
+class OutputThreadedZLibFile::RawOutput
+  : public OutputStreamBase
+{
+public:
+  RawOutput (OutputThreadedZLibFile *file)
+    : mp_file (file)
+  { }
+
+  virtual void write (const char *b, size_t n)
+  {
+    mp_file->write_raw (b, n);
+  }
+
+private:
+  OutputThreadedZLibFile *mp_file;
+};
+
+OutputThreadedZLibFile::OutputThreadedZLibFile (const std::string &p, int keep_backups, int threads)
+  : OutputFile (p, keep_backups), mp_raw (0), mp_filter (0)
+{
+  mp_raw = new RawOutput (this);
+  mp_filter = new ThreadedGZipFilter (*mp_raw, threads);
+}
+
+OutputThreadedZLibFile::~OutputThreadedZLibFile ()
+{
+  try {
+    mp_filter->flush ();
+  } catch (tl::Exception &ex) {
+    //  no exceptions from the destructor - like gzclose, we don't report errors here
+    tl::warn << ex.msg ();
+    reject ();
+  } catch (...) {
+    reject ();
+  }
+
+  delete mp_filter;
+  mp_filter = 0;
+  delete mp_raw;
+  mp_raw = 0;
+}
+
+void 
+OutputThreadedZLibFile::write_file (const char *b, size_t n)
+{
+  mp_filter->put (b, n);
+}
+
+void 
+OutputThreadedZLibFile::write_raw (const char *b, size_t n)
+{
+  OutputFile::write_file (b, n);
+}
+
 #if defined(_WIN32)
 
 // ---------------------------------------------------------------
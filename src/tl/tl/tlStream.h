@@ -30,6 +30,7 @@
 #include "tlString.h"
 
 #include <string>
+#include <vector>
 #include <sstream>
 #include <cstdio>
 #include <cstring>
@@ -40,6 +41,7 @@ namespace tl
 
 class InflateFilter;
 class DeflateFilter;
+class ThreadedGZipFilter;
 class OutputStream;
 
 // ---------------------------------------------------------------------------------
@@ -101,6 +103,18 @@ public:
    *  @brief Gets the filename part of the source
    */
   virtual std::string filename () const = 0;
+
+  /**
+   *  @brief Gets the whole content as a single memory block if available
+   *
+   *  Delegates which can provide their content as a contiguous memory block
+   *  (e.g. memory-mapped files) can reimplement this method and return a pointer
+   *  to the block. "size" receives the size of the block. InputStream will then
+   *  deliver the data directly from this block instead of copying it into its buffer.
+   *  The block must stay valid as long as the delegate is alive.
+   *  The default implementation returns 0 which indicates that no such block is available.
+   */
+  virtual const char *memory_block (size_t & /*size*/) const { return 0; }
 };
 
 // ---------------------------------------------------------------------------------
@@ -293,6 +307,77 @@ private:
   int m_fd;
 };
 
+/**
+ *  @brief A memory-mapped input file delegate
+ *
+ *  Implements the reader for ordinary files by mapping the file into memory.
+ *  The content is provided as a memory block, so InputStream can deliver
+ *  the data without copying it.
+ */
+class TL_PUBLIC InputMappedFile
+  : public InputStreamBase
+{
+public:
+  /**
+   *  @brief Open and map a file with the given path
+   *
+   *  Will throw a FileOpenErrorException if the file cannot be opened
+   *  or mapped.
+   *
+   *  @param path The (relative) path of the file to open
+   */
+  InputMappedFile (const std::string &path);
+
+  /**
+   *  @brief Unmap and close the file
+   */
+  virtual ~InputMappedFile ();
+
+  virtual size_t read (char *b, size_t n);
+
+  virtual void reset ();
+
+  virtual void close ();
+
+  virtual std::string source () const
+  {
+    return m_source;
+  }
+
+  virtual std::string absolute_path () const;
+
+  virtual std::string filename () const;
+
+  virtual const char *memory_block (size_t &size) const
+  {
+    size = m_size;
+    return mp_data;
+  }
+
+  /**
+   *  @brief Returns a value indicating whether the given file can be mapped
+   *
+   *  This method returns true for regular, non-empty files which are not
+   *  gzip-compressed. Memory mapping can be disabled by setting the
+   *  environment variable "KLAYOUT_NO_MMAP" to 1.
+   */
+  static bool is_mappable (const std::string &path);
+
+private:
+  //  no copying
+  InputMappedFile (const InputMappedFile &d);
+  InputMappedFile &operator= (const InputMappedFile &d);
+
+  std::string m_source;
+  const char *mp_data;
+  size_t m_size;
+  size_t m_pos;
+#if defined(_WIN32)
+  void *mp_file_handle;
+  void *mp_mapping_handle;
+#endif
+};
+
 /**
  *  @brief A simple pipe input delegate
  *
@@ -475,6 +560,19 @@ public:
    */
   void inflate (bool stop_after = false);
 
+  /**
+   *  @brief Supplies the uncompressed content of a DEFLATE-compressed block
+   *
+   *  This method is an alternative to "inflate" for the case that the compressed
+   *  block has already been read and uncompressed elsewhere (e.g. in a worker thread).
+   *  The compressed data must have been consumed from the stream already.
+   *  Subsequent get() calls will deliver the given data until it is exhausted.
+   *  After that, the stream continues delivering the raw data.
+   *  The stream must not be in inflate state yet. The data is taken over
+   *  by the stream and "data" is empty after this call.
+   */
+  void put_inflated (std::vector<char> &data);
+
   /**
    *  @brief Enables "inflate" right from the beginning
    *
@@ -484,6 +582,31 @@ public:
    */
   void inflate_always ();
 
+  /**
+   *  @brief Gets a value indicating whether the stream currently delivers inflated data
+   */
+  bool is_inflating () const
+  {
+    return mp_inflate != 0 || ! m_inflated.empty ();
+  }
+
+  /**
+   *  @brief Gets a value indicating whether the stream can be positioned cheaply
+   *
+   *  This is the case if the data is delivered from a memory block (e.g. a memory-mapped
+   *  file) and the stream is not inflated as a whole.
+   */
+  bool is_random_access () const;
+
+  /**
+   *  @brief Positions the stream at the given raw file position
+   *
+   *  This method terminates inflate mode. Positioning is cheap on random-access
+   *  streams (see "is_random_access"). On other streams, the stream is read over
+   *  and needs to be reset when positioning backwards.
+   */
+  void seek (size_t pos);
+
   /**
    *  @brief Obtain the current file position
    */
@@ -613,7 +736,7 @@ private:
   char *mp_buffer;
   size_t m_bcap;
   size_t m_blen;
-  char *mp_bptr;
+  const char *mp_bptr;
   InputStreamBase *mp_delegate;
   bool m_owns_delegate;
 
@@ -624,6 +747,14 @@ private:
   InflateFilter *mp_inflate;
   bool m_inflate_always;
   bool m_stop_after_inflate;
+  std::vector<char> m_inflated;
+  size_t m_inflated_pos;
+
+  //  memory block support
+  const char *mp_block;
+  size_t m_block_size;
+
+  void init_memory_block ();
 
   //  No copying currently
   InputStream (const InputStream &);
@@ -1189,6 +1320,72 @@ private:
   int m_fd;
 };
 
+/**
+ *  @brief A multi-threaded zlib output file delegate
+ *
+ *  Implements the writer for a gzip-compressed file where the compression is
+ *  done in multiple threads (see ThreadedGZipFilter).
+ */
+class TL_PUBLIC OutputThreadedZLibFile
+  : public OutputFile
+{
+public:
+  /**
+   *  @brief Open a file with the given path
+   *
+   *  @param path The (relative) path of the file to write
+   *  @param keep_backups The number of backups to keep (0: none, -1: infinite)
+   *  @param threads The number of compression threads
+   */
+  OutputThreadedZLibFile (const std::string &path, int keep_backups, int threads);
+
+  /**
+   *  @brief Close the file
+   *
+   *  The destructor will compress the remaining data and close the file.
+   */
+  virtual ~OutputThreadedZLibFile ();
+
+  /**
+   *  @brief Seek is not supported for compressed files
+   */
+  virtual bool supports_seek ()
+  {
+    return false;
+  }
+
+protected:
+  /**
+   *  @brief Write to a file
+   *
+   *  Implements the basic write method.
+   */
+  virtual void write_file (const char *b, size_t n);
+
+  /**
+   *  @brief The seek operation isn't implemented for zlib files
+   */
+  virtual void seek_file (size_t /*s*/) { }
+
+  /**
+   *  @brief Returns a value indicating whether this steam is compressing
+   */
+  virtual bool is_compressing () const { return true; }
+
+private:
+  //  No copying
+  OutputThreadedZLibFile (const OutputThreadedZLibFile &);
+  OutputThreadedZLibFile &operator= (const OutputThreadedZLibFile &);
+
+  class RawOutput;
+  friend class RawOutput;
+
+  RawOutput *mp_raw;
+  ThreadedGZipFilter *mp_filter;
+
+  void write_raw (const char *b, size_t n);
+};
+
 /**
  *  @brief A simple pipe output delegate
  *
@@ -1296,8 +1493,10 @@ public:
    *
    *  This will automatically create a delegate object and delete it later.
    *  If "as_text" is true, the output will be formatted with the system's line separator.
+   *  If "compression_threads" is larger than zero, zlib-compressed files (OM_Zlib mode)
+   *  are compressed in that many threads. The default is single-threaded compression.
    */
-  OutputStream (const std::string &abstract_path, OutputStreamMode om = OM_Auto, bool as_text = false, int keep_backups = 0);
+  OutputStream (const std::string &abstract_path, OutputStreamMode om = OM_Auto, bool as_text = false, int keep_backups = 0, int compression_threads = 0);
 
   /**
    *  @brief Destructor
@@ -25,6 +25,8 @@
 #include "tlLog.h"
 #include "tlProgress.h"
 #include "tlAssert.h"
+#include "tlTimer.h"
+#include "tlString.h"
 
 #include <memory>
 #include <stdio.h>
@@ -58,6 +60,40 @@ public:
 struct WorkerTerminatedException { };
 struct TaskTerminatedException { };
 
+// -----------------------------------------------------------------------------
+//  The per-worker task queue
+
+/**
+ *  @brief A per-worker task queue
+ *
+ *  Each worker takes tasks from the front of its own queue. Idle workers steal
+ *  tasks from the front of other workers' queues too, so the oldest tasks are
+ *  started first. An additional queue shared by all workers holds the tasks with
+ *  a priority other than 0. The statistics members are only modified by the
+ *  owning worker.
+ */
+struct WorkerQueue
+{
+  WorkerQueue ()
+    : tasks_performed (0), steals (0), idle_time (0.0)
+  { }
+
+  void reset_statistics ()
+  {
+    tasks_performed = 0;
+    steals = 0;
+    idle_time = 0.0;
+    idle_since = tl::Clock::current ();
+  }
+
+  tl::Mutex lock;
+  TaskList tasks;
+  size_t tasks_performed;
+  size_t steals;
+  double idle_time;
+  tl::Clock idle_since;
+};
+
 // -----------------------------------------------------------------------------
 //  tl::Boss implementation
 
@@ -134,15 +170,27 @@ TaskList::fetch ()
 void 
 TaskList::put (Task *task)
 {
-  task->mp_next = 0;
-  task->mp_last = mp_last;
+  //  skip tasks with a lower priority - usually, all tasks have the same priority,
+  //  so this loop will not be entered.
+  Task *after = mp_last;
+  while (after && after->m_priority < task->m_priority) {
+    after = after->mp_last;
+  }
 
-  mp_last = task;
-  if (task->mp_last) {
-    task->mp_last->mp_next = task;
+  task->mp_last = after;
+  if (after) {
+    task->mp_next = after->mp_next;
+    after->mp_next = task;
   } else {
+    task->mp_next = mp_first;
     mp_first = task;
   }
+
+  if (task->mp_next) {
+    task->mp_next->mp_last = task;
+  } else {
+    mp_last = task;
+  }
 }
 
 void 
@@ -173,12 +221,14 @@ TaskList::size () const
 //  tl::JobBase implementation
 
 JobBase::JobBase (int nworkers)
-  : m_nworkers (nworkers), m_idle_workers (0), m_stopping (false), m_running (false)
+  : m_pending (0), m_shared_pending (0), m_next_queue (0), m_nworkers (nworkers), m_idle_workers (0), m_stopping (false), m_running (false)
 {
   if (nworkers > 0) {
     mp_per_worker_task_lists = new TaskList[nworkers];
+    mp_worker_queues = new WorkerQueue[nworkers + 1];
   } else {
     mp_per_worker_task_lists = 0;
+    mp_worker_queues = 0;
   }
 }
 
@@ -194,6 +244,11 @@ JobBase::~JobBase ()
     delete[] mp_per_worker_task_lists;
     mp_per_worker_task_lists = 0;
   }
+
+  if (mp_worker_queues) {
+    delete[] mp_worker_queues;
+    mp_worker_queues = 0;
+  }
 }
 
 void
@@ -242,10 +297,20 @@ JobBase::set_num_workers (int nworkers)
     delete[] mp_per_worker_task_lists;
   }
 
+  if (mp_worker_queues) {
+    delete[] mp_worker_queues;
+  }
+
+  m_pending = 0;
+  m_shared_pending = 0;
+  m_next_queue = 0;
+
   if (nworkers > 0) {
     mp_per_worker_task_lists = new TaskList[nworkers];
+    mp_worker_queues = new WorkerQueue[nworkers + 1];
   } else {
     mp_per_worker_task_lists = 0;
+    mp_worker_queues = 0;
   }
 }
 
@@ -265,6 +330,14 @@ JobBase::start ()
   //  the empty queue detection works properly.
   for (int i = 0; i < m_nworkers; ++i) {
     mp_per_worker_task_lists[i].put_front (new StartTask ());
+    mp_worker_queues[i].reset_statistics ();
+  }
+
+  //  Distribute the tasks scheduled so far over the worker queues
+  if (m_nworkers > 0) {
+    while (! m_task_list.is_empty ()) {
+      put_task (m_task_list.fetch ());
+    }
   }
 
   m_task_available_condition.wakeAll ();
@@ -382,6 +455,7 @@ JobBase::stop ()
   while (! m_task_list.is_empty ()) {
     delete m_task_list.fetch ();
   }
+  clear_worker_queues ();
 
   if (! mp_workers.empty ()) {
 
@@ -466,11 +540,13 @@ JobBase::schedule (Task *task)
 
   } else {
 
-    //  Add the task to the task queue
-    m_task_list.put (task);
-
-    if (m_running) {
+    if (m_running && m_nworkers > 0) {
+      //  Add the task to one of the worker queues
+      put_task (task);
       m_task_available_condition.wakeAll ();
+    } else {
+      //  Add the task to the task queue - the tasks are distributed on start
+      m_task_list.put (task);
     }
 
   }
@@ -478,15 +554,138 @@ JobBase::schedule (Task *task)
   m_lock.unlock ();
 }
 
+void
+JobBase::put_task (Task *task)
+{
+  //  NOTE: this method is called with m_lock locked
+  //  Tasks with non-default priority go to the shared queue (the last one) which
+  //  keeps them in global priority order
+  bool shared = task->priority () != 0;
+  WorkerQueue &q = shared ? mp_worker_queues [m_nworkers] : mp_worker_queues [m_next_queue++ % (unsigned int) m_nworkers];
+
+  q.lock.lock ();
+  q.tasks.put (task);
+  if (shared) {
+    ++m_shared_pending;
+  }
+  ++m_pending;
+  q.lock.unlock ();
+}
+
+void
+JobBase::clear_worker_queues ()
+{
+  //  NOTE: this method is called with m_lock locked
+  for (int i = 0; i <= m_nworkers; ++i) {
+    WorkerQueue &q = mp_worker_queues [i];
+    q.lock.lock ();
+    while (! q.tasks.is_empty ()) {
+      delete q.tasks.fetch ();
+      --m_pending;
+    }
+    q.lock.unlock ();
+  }
+  m_shared_pending = 0;
+}
+
+Task *
+JobBase::take_task (int worker)
+{
+  if (m_pending <= 0) {
+    return 0;
+  }
+
+  Task *task = 0;
+
+  //  tasks with a priority above the default one come first
+  //  (the shared queue is only looked at if it holds tasks, so plain jobs never contend for its lock)
+  WorkerQueue &shared = mp_worker_queues [m_nworkers];
+  if (m_shared_pending > 0) {
+    shared.lock.lock ();
+    if (! shared.tasks.is_empty () && shared.tasks.peek ()->priority () > 0) {
+      task = shared.tasks.fetch ();
+      --m_shared_pending;
+      --m_pending;
+    }
+    shared.lock.unlock ();
+  }
+
+  //  take from the front of our own queue
+  WorkerQueue &own = mp_worker_queues [worker];
+  if (! task) {
+    own.lock.lock ();
+    if (! own.tasks.is_empty ()) {
+      task = own.tasks.fetch ();
+      --m_pending;
+    }
+    own.lock.unlock ();
+  }
+
+  //  steal the oldest task from the other workers' queues
+  for (int i = 1; i < m_nworkers && ! task; ++i) {
+    WorkerQueue &other = mp_worker_queues [(worker + i) % m_nworkers];
+    other.lock.lock ();
+    if (! other.tasks.is_empty ()) {
+      task = other.tasks.fetch ();
+      --m_pending;
+      ++own.steals;
+    }
+    other.lock.unlock ();
+  }
+
+  //  tasks with a priority below the default one come last
+  if (! task && m_shared_pending > 0) {
+    shared.lock.lock ();
+    if (! shared.tasks.is_empty ()) {
+      task = shared.tasks.fetch ();
+      --m_shared_pending;
+      --m_pending;
+    }
+    shared.lock.unlock ();
+  }
+
+  if (task) {
+    ++own.tasks_performed;
+  }
+
+  return task;
+}
+
+void
+JobBase::log_statistics ()
+{
+  //  NOTE: this method is called with m_lock locked and all workers being idle
+  if (tl::verbosity () < 40) {
+    return;
+  }
+
+  tl::Clock now = tl::Clock::current ();
+
+  tl::log << tl::to_string (tr ("Job statistics for ")) << m_nworkers << tl::to_string (tr (" workers:"));
+  for (int i = 0; i < m_nworkers; ++i) {
+    const WorkerQueue &q = mp_worker_queues [i];
+    tl::log << "  #" << i << ": " << q.tasks_performed << tl::to_string (tr (" tasks, ")) << q.steals << tl::to_string (tr (" stolen, idle ")) << tl::sprintf ("%.3f", q.idle_time + (now - q.idle_since).seconds ()) << "s";
+  }
+}
+
 Task *
 JobBase::get_task (int worker)
 {
   while (true) {
 
+    //  fast path: take a task from the worker queues without global lock
+    Task *task = take_task (worker);
+    if (task) {
+      return task;
+    }
+
     m_lock.lock ();
 
-    //  wait for new relevant entries in the task queue
-    while (m_task_list.is_empty () && mp_per_worker_task_lists [worker].is_empty ()) {
+    //  wait for new relevant entries in the task queues
+    if (mp_per_worker_task_lists [worker].is_empty () && m_pending <= 0) {
+
+      WorkerQueue &own = mp_worker_queues [worker];
+      own.idle_since = tl::Clock::current ();
 
       //  if the queue is empty, mark this worker as idle.
       ++m_idle_workers;
@@ -494,6 +693,7 @@ JobBase::get_task (int worker)
       //  signal empty queue if all workers are waiting
       if (m_idle_workers == m_nworkers) {
         if (! m_stopping) {
+          log_statistics ();
           finished ();
         }
         m_running = false;
@@ -501,7 +701,7 @@ JobBase::get_task (int worker)
       }
 
       //  wait until we receive a task
-      while (m_task_list.is_empty () && mp_per_worker_task_lists [worker].is_empty ()) {
+      while (mp_per_worker_task_lists [worker].is_empty () && m_pending <= 0) {
         mp_workers [worker]->set_idle (true);
         m_task_available_condition.wait (&m_lock);
         mp_workers [worker]->set_idle (false);
@@ -509,13 +709,12 @@ JobBase::get_task (int worker)
 
       --m_idle_workers;
 
+      own.idle_time += (tl::Clock::current () - own.idle_since).seconds ();
+
     } 
 
-    Task *task = 0;
     if (! mp_per_worker_task_lists [worker].is_empty ()) {
       task = mp_per_worker_task_lists [worker].fetch ();
-    } else if (! m_task_list.is_empty ()) {
-      task = m_task_list.fetch ();
     }
 
     m_lock.unlock ();
@@ -527,8 +726,6 @@ JobBase::get_task (int worker)
     } else if (dynamic_cast <StartTask *> (task) != 0) {
       delete task;
       //  dummy task for synchronization - wait for new tasks to arrive.
-    } else if (task) {
-      return task;
     }
 
   }
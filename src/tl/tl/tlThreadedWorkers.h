@@ -30,6 +30,7 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <atomic>
 
 namespace tl
 {
@@ -58,6 +59,7 @@ namespace tl
 class Boss;
 class Worker;
 class Task;
+struct WorkerQueue;
 
 /**
  *  @brief A task list
@@ -93,6 +95,9 @@ public:
 
   /**
    *  @brief Put (append) a task to the task list
+   *
+   *  The task is inserted behind the last task with the same or a higher priority.
+   *  Hence tasks with the same priority are maintained in the order they are put.
    */
   void put (Task *task);
 
@@ -162,9 +167,13 @@ public:
    *  This does not trigger the actual operation yet. It should be done separately before
    *  \start is called. However, it is possible to schedule jobs while the job is running and
    *  even from within other tasks.
-   *  It is guaranteed that the order of processing of the tasks is maintained. However, 
-   *  it is not guaranteed that previous tasks have been processed already because they
-   *  might be send to a different thread.
+   *  Tasks with a higher priority (see Task::set_priority) are started before
+   *  tasks with a lower priority. Tasks with the default priority 0 are distributed over
+   *  per-worker queues. Each worker takes the tasks from its queue in the order they have
+   *  been scheduled and idle workers take the oldest tasks from other workers' queues.
+   *  Hence with more than one worker, the tasks are started roughly, but not strictly in the
+   *  order they have been scheduled. In any case, it is not guaranteed that previous tasks
+   *  have been processed already because they might be send to a different thread.
    */
   void schedule (Task *task);
 
@@ -173,7 +182,8 @@ public:
    */
   size_t tasks () const
   {
-    return m_task_list.size ();
+    int pending = m_pending;
+    return m_task_list.size () + size_t (pending > 0 ? pending : 0);
   }
 
   /**
@@ -282,6 +292,10 @@ private:
 
   TaskList m_task_list;
   TaskList *mp_per_worker_task_lists;
+  WorkerQueue *mp_worker_queues;
+  std::atomic<int> m_pending;
+  std::atomic<int> m_shared_pending;
+  unsigned int m_next_queue;
 
   int m_nworkers;
   int m_idle_workers;
@@ -298,6 +312,10 @@ private:
   std::vector<std::string> m_error_messages;
 
   Task *get_task (int for_worker);
+  Task *take_task (int for_worker);
+  void put_task (Task *task);
+  void clear_worker_queues ();
+  void log_statistics ();
   void log_error (const std::string &s);
   void cleanup ();
 };
@@ -428,7 +446,7 @@ public:
    *  @brief Default ctor
    */
   Task () 
-    : mp_next (0), mp_last (0)
+    : mp_next (0), mp_last (0), m_priority (0)
   { }
 
   /**
@@ -437,10 +455,33 @@ public:
   virtual ~Task ()
   { }
 
+  /**
+   *  @brief Sets the priority of the task
+   *
+   *  Tasks with a higher priority are taken before tasks with a lower priority.
+   *  Tasks with the same priority are taken in the order they have been scheduled,
+   *  but see JobBase::schedule for the limitations of that order for tasks with
+   *  priority 0. The default priority is 0. The priority needs to be set before the
+   *  task is scheduled.
+   */
+  void set_priority (int p)
+  {
+    m_priority = p;
+  }
+
+  /**
+   *  @brief Gets the priority of the task
+   */
+  int priority () const
+  {
+    return m_priority;
+  }
+
 private:
   friend class TaskList;
 
   Task *mp_next, *mp_last;
+  int m_priority;
 };
 
 /**
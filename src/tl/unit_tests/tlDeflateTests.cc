@@ -24,6 +24,7 @@
 #include "tlStream.h"
 #include "tlDeflate.h"
 #include "tlUnitTest.h"
+#include "tlTimer.h"
 
 #include "zlib.h"
 
@@ -119,3 +120,182 @@ TEST(3)
   delete[] hello;
 }
 
+static std::string gunzip (const std::string &gz)
+{
+  z_stream zs;
+  zs.zalloc = (alloc_func)0;
+  zs.zfree = (free_func)0;
+  zs.opaque = (voidpf)0;
+  zs.next_in = (Bytef *) gz.c_str ();
+  zs.avail_in = (uInt) gz.size ();
+
+  int err = inflateInit2 (&zs, 16 + 15 /* == gzip format */);
+  tl_assert (err == Z_OK);
+
+  std::string out;
+  char buffer [65536];
+  do {
+    zs.next_out = (Bytef *) buffer;
+    zs.avail_out = sizeof (buffer);
+    err = inflate (&zs, Z_NO_FLUSH);
+    out.append (buffer, sizeof (buffer) - zs.avail_out);
+  } while (err == Z_OK);
+
+  inflateEnd (&zs);
+
+  //  returns an empty string on errors (i.e. CRC mismatch)
+  return err == Z_STREAM_END ? out : std::string ();
+}
+
+//  Threaded gzip compressor
+TEST(4)
+{
+  size_t n_hello = 1024*1024 + 17;
+  std::string hello;
+  hello.reserve (n_hello);
+  size_t r = 1;
+  for (size_t i = 0; i < n_hello; ++i) {
+    r *= 12361;
+    r ^= (r >> 8); 
+    hello += "abc" [r % 3];
+  }
+
+  for (int threads = 0; threads < 4; ++threads) {
+
+    tl::OutputMemoryStream oms;
+
+    tl::ThreadedGZipFilter fg (oms, threads, 65536);
+    //  put in irregular chunks
+    for (size_t i = 0; i < hello.size (); ) {
+      size_t n = std::min (hello.size () - i, size_t (1000 + i % 50000));
+      fg.put (hello.c_str () + i, n);
+      i += n;
+    }
+    fg.flush ();
+
+    std::string gz (oms.data (), oms.size ());
+    EXPECT_EQ (gz.size () < 300000 && gz.size () > 200000, true);
+    EXPECT_EQ (gz.size (), fg.compressed ());
+    EXPECT_EQ (n_hello, fg.uncompressed ());
+    EXPECT_EQ (gunzip (gz) == hello, true);
+
+  }
+
+  //  empty stream
+  tl::OutputMemoryStream oms;
+  tl::ThreadedGZipFilter fg (oms, 2);
+  fg.flush ();
+  EXPECT_EQ (gunzip (std::string (oms.data (), oms.size ())), "");
+}
+
+//  Threaded gzip files
+TEST(5)
+{
+  std::string data;
+  for (int i = 0; i < 100000; ++i) {
+    data += "Line " + tl::to_string (i) + "\n";
+  }
+
+  std::string fn = tmp_file ("threaded.txt.gz");
+
+  {
+    tl::OutputStream os (fn, tl::OutputStream::OM_Auto, false, 0, 3);
+    EXPECT_EQ (os.is_compressing (), true);
+    os.put (data.c_str (), data.size ());
+  }
+
+  tl::InputStream is (fn);
+  EXPECT_EQ (is.read_all (), data);
+}
+
+static std::string make_benchmark_data (size_t n)
+{
+  //  produces a moderately compressible text resembling a layout dump
+  std::string data;
+  data.reserve (n + 64);
+
+  const char *words[] = { "BOUNDARY", "LAYER", "DATATYPE", "XY", "ENDEL", "PATH", "WIDTH", "SREF", "SNAME", "TEXT" };
+
+  unsigned int r = 1;
+  while (data.size () < n) {
+    r = r * 1103515245 + 12345;
+    data += words [(r >> 16) % (sizeof (words) / sizeof (words [0]))];
+    data += " ";
+    r = r * 1103515245 + 12345;
+    data += tl::to_string ((r >> 8) % 100000);
+    data += (r & 0x100) ? "\n" : " ";
+  }
+
+  data.resize (n);
+  return data;
+}
+
+static double mb_per_sec (size_t n, const tl::Timer &timer)
+{
+  return double (n) / (1024.0 * 1024.0) / std::max (1e-6, timer.sec_wall ());
+}
+
+//  Throughput benchmark
+TEST(10)
+{
+  test_is_long_runner ();
+
+  std::string data = make_benchmark_data (16 * 1024 * 1024);
+
+  tl::OutputMemoryStream oms;
+
+  {
+    tl::Timer timer;
+    timer.start ();
+
+    tl::OutputStream os (oms);
+    tl::DeflateFilter fg (os);
+    fg.put (data.c_str (), data.size ());
+    fg.flush ();
+
+    timer.stop ();
+    tl::info << "Deflate: " << tl::sprintf ("%.1f", mb_per_sec (data.size (), timer)) << " MB/s";
+  }
+
+  {
+    tl::Timer timer;
+    timer.start ();
+
+    tl::InputMemoryStream ims (oms.data (), oms.size ());
+    tl::InputStream is (ims);
+
+    std::string out;
+    out.reserve (data.size ());
+
+    tl::InflateFilter f (is);
+    while (! f.at_end ()) {
+      size_t n = std::min (size_t (4096), data.size () - out.size ());
+      const char *b = f.get (n);
+      EXPECT_EQ (b != 0, true);
+      out.append (b, n);
+      if (out.size () == data.size ()) {
+        break;
+      }
+    }
+
+    timer.stop ();
+    tl::info << "Inflate: " << tl::sprintf ("%.1f", mb_per_sec (data.size (), timer)) << " MB/s";
+
+    EXPECT_EQ (out == data, true);
+  }
+
+  for (int threads = 0; threads <= 4; threads += 4) {
+
+    tl::Timer timer;
+    timer.start ();
+
+    tl::OutputMemoryStream gz;
+    tl::ThreadedGZipFilter fg (gz, threads);
+    fg.put (data.c_str (), data.size ());
+    fg.flush ();
+
+    timer.stop ();
+    tl::info << "GZip (" << threads << " threads): " << tl::sprintf ("%.1f", mb_per_sec (data.size (), timer)) << " MB/s, ratio " << tl::sprintf ("%.3f", double (gz.size ()) / double (data.size ()));
+
+  }
+}
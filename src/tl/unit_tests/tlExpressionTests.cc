@@ -25,6 +25,7 @@
 #include "tlVariantUserClasses.h"
 #include "tlUnitTest.h"
 #include "tlEnv.h"
+#include "tlTimer.h"
 
 #define _USE_MATH_DEFINES // for MSVC
 #include <math.h>
@@ -1217,3 +1218,111 @@ TEST(20)
   EXPECT_EQ (v.to_string (), std::string ("0.3"));
 }
 
+
+// constant folding
+TEST(21)
+{
+  tl::Eval e;
+  e.set_var ("x", tl::Variant (3));
+
+  const char *exprs[] = {
+    "1+2*3",
+    "(1-4)*2%4",
+    "x*(2+3)-x",
+    "x>(1+1) ? 'a'+'b' : 'c'",
+    "-(2*x)+~1+!true",
+    "(1<<4)|(255&7)^3",
+    "x==3 && 1+1==2",
+    "[1+1, x, 'a'+'b']"
+  };
+
+  for (size_t i = 0; i < sizeof (exprs) / sizeof (exprs [0]); ++i) {
+    tl::Expression ex = e.parse (exprs [i]);
+    std::string ref = ex.execute ().to_parsable_string ();
+    ex.optimize ();
+    EXPECT_EQ (ex.execute ().to_parsable_string (), ref);
+    //  repeated execution
+    EXPECT_EQ (ex.execute ().to_parsable_string (), ref);
+  }
+
+  //  variables are not folded
+  tl::Expression ex = e.parse ("x*(2+3)");
+  ex.optimize ();
+  EXPECT_EQ (ex.execute ().to_string (), "15");
+  e.set_var ("x", tl::Variant (4));
+  EXPECT_EQ (ex.execute ().to_string (), "20");
+
+  //  errors are reported on execution
+  ex = e.parse ("x+1/0");
+  ex.optimize ();
+  try {
+    ex.execute ();
+    EXPECT_EQ (true, false);
+  } catch (tl::Exception &err) {
+    EXPECT_EQ (err.msg ().find ("Division by zero") != std::string::npos, true);
+  }
+}
+
+// reset_vars
+TEST(22)
+{
+  tl::Eval e;
+  e.set_var ("x", tl::Variant (3));
+
+  tl::Expression ex = e.parse ("var y = x + 1; y * 2");
+  EXPECT_EQ (ex.execute ().to_string (), "8");
+  EXPECT_EQ (e.var ("y")->to_string (), "4");
+
+  e.reset_vars ();
+  EXPECT_EQ (e.var ("x")->is_nil (), true);
+  EXPECT_EQ (e.var ("y")->is_nil (), true);
+
+  //  the expression is still valid
+  e.set_var ("x", tl::Variant (5));
+  EXPECT_EQ (ex.execute ().to_string (), "12");
+}
+
+//  benchmark: parsing per execution vs. compiled and optimized expressions
+TEST(23)
+{
+  test_is_long_runner ();
+
+  tl::Eval e;
+  e.set_var ("x", tl::Variant (1.5));
+
+  const char *expr = "var y = x * (2.0 * 3.14159 / 360.0) + (1 << 4) * 0.5; y > 10 ? y - (2 + 3) * 1.5 : y + 100 / (4 * 5)";
+  const int n = 200000;
+
+  double s1 = 0.0;
+  {
+    tl::SelfTimer timer ("parse and execute");
+    for (int i = 0; i < n; ++i) {
+      e.set_var ("x", tl::Variant (double (i % 100)));
+      s1 += e.parse (expr).execute ().to_double ();
+    }
+  }
+
+  double s2 = 0.0;
+  {
+    tl::SelfTimer timer ("execute parsed expression");
+    tl::Expression ex = e.parse (expr);
+    for (int i = 0; i < n; ++i) {
+      e.set_var ("x", tl::Variant (double (i % 100)));
+      s2 += ex.execute ().to_double ();
+    }
+  }
+
+  double s3 = 0.0;
+  {
+    tl::SelfTimer timer ("execute optimized expression");
+    tl::Expression ex = e.parse (expr);
+    ex.optimize ();
+    for (int i = 0; i < n; ++i) {
+      e.set_var ("x", tl::Variant (double (i % 100)));
+      s3 += ex.execute ().to_double ();
+    }
+  }
+
+  EXPECT_EQ (tl::to_string (s1), tl::to_string (s2));
+  EXPECT_EQ (tl::to_string (s1), tl::to_string (s3));
+}
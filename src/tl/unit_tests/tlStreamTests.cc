@@ -624,3 +624,132 @@ TEST(MatchFormat)
   EXPECT_EQ (tl::match_filename_to_format ("abc.TEXT", "Text files (*.txt *.TXT)"), false);
   EXPECT_EQ (tl::match_filename_to_format ("abc.TEXT", "Text files (*)"), true);
 }
+
+TEST(PutInflated)
+{
+  const char *raw = "ABCDEFGH";
+  tl::InputMemoryStream ms (raw, strlen (raw));
+  tl::InputStream is (ms);
+
+  EXPECT_EQ (std::string (is.get (2), 2), "AB");
+
+  std::vector<char> data;
+  data.push_back ('x');
+  data.push_back ('y');
+  data.push_back ('z');
+  is.put_inflated (data);
+  EXPECT_EQ (data.empty (), true);
+
+  EXPECT_EQ (std::string (is.get (2), 2), "xy");
+  is.unget (2);
+  EXPECT_EQ (std::string (is.get (1), 1), "x");
+  //  does not deliver beyond the inflated block
+  EXPECT_EQ (is.get (3) == 0, true);
+  EXPECT_EQ (std::string (is.get (2), 2), "yz");
+  EXPECT_EQ (is.pos (), size_t (2));
+
+  //  continues with the raw data
+  EXPECT_EQ (std::string (is.get (3), 3), "CDE");
+  EXPECT_EQ (is.read_all (), "FGH");
+}
+
+TEST(MappedFile)
+{
+  std::string fn = tmp_file ("mapped.txt");
+  {
+    tl::OutputStream os (fn, tl::OutputStream::OM_Plain);
+    os << "Hello, world!\nSecond line\n";
+  }
+
+  EXPECT_EQ (tl::InputMappedFile::is_mappable (fn), true);
+
+  {
+    tl::InputMappedFile mf (fn);
+    size_t size = 0;
+    EXPECT_EQ (mf.memory_block (size) != 0, true);
+    EXPECT_EQ (size, size_t (26));
+    EXPECT_EQ (mf.filename (), "mapped.txt");
+
+    char b[5];
+    EXPECT_EQ (mf.read (b, sizeof (b)), size_t (5));
+    EXPECT_EQ (std::string (b, sizeof (b)), "Hello");
+    mf.reset ();
+    EXPECT_EQ (mf.read (b, sizeof (b)), size_t (5));
+    EXPECT_EQ (std::string (b, sizeof (b)), "Hello");
+  }
+
+  {
+    tl::InputStream is (fn);
+    EXPECT_EQ (dynamic_cast<tl::InputMappedFile *> (is.base ()) != 0, true);
+    EXPECT_EQ (std::string (is.get (7), 7), "Hello, ");
+    is.unget (2);
+    EXPECT_EQ (std::string (is.get (2), 2), ", ");
+    EXPECT_EQ (is.pos (), size_t (7));
+    EXPECT_EQ (is.get (100) == 0, true);
+    EXPECT_EQ (is.read_all (), "world!\nSecond line\n");
+    EXPECT_EQ (is.get (1) == 0, true);
+    is.reset ();
+    EXPECT_EQ (is.read_all (5), "Hello");
+  }
+
+  {
+    tl::InputStream is (fn);
+    tl::TextInputStream text (is);
+    EXPECT_EQ (text.get_line (), "Hello, world!");
+    EXPECT_EQ (text.get_line (), "Second line");
+    EXPECT_EQ (text.at_end (), true);
+  }
+
+  //  gzip files are not mapped
+  std::string fn_gz = tmp_file ("mapped.txt.gz");
+  {
+    tl::OutputStream os (fn_gz, tl::OutputStream::OM_Zlib);
+    os << "Hello, world!\n";
+  }
+
+  EXPECT_EQ (tl::InputMappedFile::is_mappable (fn_gz), false);
+
+  {
+    tl::InputStream is (fn_gz);
+    EXPECT_EQ (dynamic_cast<tl::InputMappedFile *> (is.base ()) == 0, true);
+    EXPECT_EQ (is.read_all (), "Hello, world!\n");
+  }
+}
+
+TEST(Seek)
+{
+  std::string fn = tmp_file ("seek.txt");
+  {
+    tl::OutputStream os (fn, tl::OutputStream::OM_Plain);
+    os << "0123456789ABCDEF";
+  }
+
+  {
+    tl::InputStream is (fn);
+    EXPECT_EQ (is.is_random_access (), true);
+    EXPECT_EQ (is.is_inflating (), false);
+
+    is.seek (10);
+    EXPECT_EQ (is.pos (), size_t (10));
+    EXPECT_EQ (std::string (is.get (3), 3), "ABC");
+    is.seek (2);
+    EXPECT_EQ (std::string (is.get (2), 2), "23");
+    EXPECT_EQ (is.read_all (), "456789ABCDEF");
+  }
+
+  {
+    const char *raw = "ABCDEFGH";
+    tl::InputMemoryStream ms (raw, strlen (raw));
+    tl::InputStream is (ms);
+
+    std::vector<char> data;
+    data.push_back ('x');
+    is.put_inflated (data);
+    EXPECT_EQ (is.is_inflating (), true);
+
+    //  positioning terminates the inflated block
+    is.seek (5);
+    EXPECT_EQ (is.is_inflating (), false);
+    EXPECT_EQ (is.read_all (), "FGH");
+  }
+}
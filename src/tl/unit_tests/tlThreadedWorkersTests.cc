@@ -630,3 +630,123 @@ TEST(29)
   }
 }
 
+
+class PriorityTask : public tl::Task
+{
+public:
+  PriorityTask (int id, int priority, int sleep_us = 0) : m_id (id), m_sleep_us (sleep_us) { set_priority (priority); }
+  int m_id, m_sleep_us;
+};
+
+static tl::Mutex s_order_lock;
+static std::vector<int> s_order;
+static int s_performed[4];
+
+class PriorityWorker : public tl::Worker
+{
+public:
+  PriorityWorker () : tl::Worker () { }
+
+protected:
+  void perform_task (tl::Task *task)
+  {
+    PriorityTask *ptask = dynamic_cast<PriorityTask *> (task);
+    if (ptask->m_sleep_us > 0) {
+      tl::usleep (ptask->m_sleep_us);
+    }
+    s_order_lock.lock ();
+    s_order.push_back (ptask->m_id);
+    ++s_performed[worker_index () >= 0 ? worker_index () : 0];
+    s_order_lock.unlock ();
+  }
+};
+
+class PriorityJob : public tl::Job<PriorityWorker>
+{
+public:
+  PriorityJob (int w) : tl::Job<PriorityWorker> (w) { }
+};
+
+static std::string order2string ()
+{
+  std::string s;
+  for (std::vector<int>::const_iterator i = s_order.begin (); i != s_order.end (); ++i) {
+    if (! s.empty ()) {
+      s += ",";
+    }
+    s += tl::to_string (*i);
+  }
+  return s;
+}
+
+//  task priorities
+TEST(30)
+{
+  for (int nw = 0; nw < 2; ++nw) {
+
+    PriorityJob job (nw);
+
+    s_order.clear ();
+
+    for (int i = 0; i < 10; ++i) {
+      job.schedule (new PriorityTask (i, i % 3));
+    }
+
+    EXPECT_EQ (job.tasks (), size_t (10));
+
+    job.start ();
+    job.wait ();
+    EXPECT_EQ (job.is_running (), false);
+
+    EXPECT_EQ (order2string (), "2,5,8,1,4,7,0,3,6,9");
+
+  }
+}
+
+//  work stealing
+TEST(31)
+{
+  PriorityJob job (4);
+
+  s_order.clear ();
+  for (int i = 0; i < 4; ++i) {
+    s_performed[i] = 0;
+  }
+
+  //  tasks are distributed round-robin, so worker #0 receives all the slow tasks
+  for (int i = 0; i < 400; ++i) {
+    job.schedule (new PriorityTask (i, 0, (i % 4) == 0 ? 10000 : 0));
+  }
+
+  job.start ();
+  job.wait ();
+  EXPECT_EQ (job.is_running (), false);
+
+  EXPECT_EQ (s_order.size (), size_t (400));
+  EXPECT_EQ (s_performed[0] + s_performed[1] + s_performed[2] + s_performed[3], 400);
+
+  //  the other workers have stolen tasks from worker #0
+  EXPECT_EQ (s_performed[0] < 100, true);
+}
+
+//  task priorities with multiple workers
+TEST(32)
+{
+  PriorityJob job (4);
+
+  s_order.clear ();
+
+  job.schedule (new PriorityTask (1000, -1, 5000));
+  for (int i = 0; i < 40; ++i) {
+    job.schedule (new PriorityTask (i, 0, 1000));
+  }
+  job.schedule (new PriorityTask (2000, 1));
+
+  job.start ();
+  job.wait ();
+  EXPECT_EQ (job.is_running (), false);
+
+  EXPECT_EQ (s_order.size (), size_t (42));
+  EXPECT_EQ (s_order.front (), 2000);
+  EXPECT_EQ (s_order.back (), 1000);
+}